@@ -381,6 +381,51 @@ if (WAMR_BUILD_PERF_PROFILING EQUAL 1)
   add_definitions (-DWASM_ENABLE_PERF_PROFILING=1)
   message ("     Performance profiling enabled")
 endif ()
+if (WAMR_BUILD_SAMPLING_PROFILER EQUAL 1)
+  if (NOT WAMR_BUILD_FAST_INTERP EQUAL 1)
+    message ("     Sampling profiler only samples the fast interpreter")
+  endif ()
+  add_definitions (-DWASM_ENABLE_SAMPLING_PROFILER=1)
+  message ("     Sampling profiler enabled")
+endif ()
+if (WAMR_BUILD_STREAM_LOADER EQUAL 1)
+  if (NOT WAMR_BUILD_INTERP EQUAL 1 OR NOT WAMR_BUILD_FAST_INTERP EQUAL 1)
+    message (FATAL_ERROR "Chunked loader requires the fast interpreter")
+  endif ()
+  add_definitions (-DWASM_ENABLE_STREAM_LOADER=1)
+  message ("     Chunked loader enabled")
+endif ()
+if (WAMR_BUILD_LAZY_FAST_INTERP EQUAL 1)
+  if (NOT WAMR_BUILD_INTERP EQUAL 1 OR NOT WAMR_BUILD_FAST_INTERP EQUAL 1)
+    message (FATAL_ERROR "Lazy preparation requires the fast interpreter")
+  endif ()
+  if (WAMR_BUILD_GC EQUAL 1)
+    message (FATAL_ERROR "Lazy preparation doesn't support GC")
+  endif ()
+  add_definitions (-DWASM_ENABLE_LAZY_FAST_INTERP=1)
+  message ("     Lazy preparation of fast interpreter functions enabled")
+endif ()
+if (WAMR_BUILD_FAST_INTERP_BCE EQUAL 1)
+  if (NOT WAMR_BUILD_INTERP EQUAL 1 OR NOT WAMR_BUILD_FAST_INTERP EQUAL 1)
+    message (FATAL_ERROR "Bounds check elimination requires the fast interpreter")
+  endif ()
+  add_definitions (-DWASM_ENABLE_FAST_INTERP_BCE=1)
+  message ("     Bounds check elimination of fast interpreter enabled")
+endif ()
+if (WAMR_BUILD_RUNTIME_METRICS EQUAL 1)
+  add_definitions (-DWASM_ENABLE_RUNTIME_METRICS=1)
+  message ("     Runtime metrics enabled")
+endif ()
+if (WAMR_BUILD_MEMORY_IMAGE EQUAL 1)
+  if (NOT WAMR_BUILD_PLATFORM STREQUAL "linux")
+    message (WARNING "Copy-on-write memory image is only supported on linux")
+  elseif (WAMR_BUILD_ALLOC_WITH_USAGE EQUAL 1)
+    message (WARNING "Copy-on-write memory image doesn't support WAMR_BUILD_ALLOC_WITH_USAGE")
+  else ()
+    add_definitions (-DWASM_ENABLE_MEMORY_IMAGE=1)
+    message ("     Copy-on-write memory image enabled")
+  endif ()
+endif ()
 if (DEFINED WAMR_APP_THREAD_STACK_SIZE_MAX)
   add_definitions (-DAPP_THREAD_STACK_SIZE_MAX=${WAMR_APP_THREAD_STACK_SIZE_MAX})
 endif ()
@@ -409,6 +454,23 @@ if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_PERF_PROFILING EQUAL 1)
 else ()
   message ("     GC performance profiling disabled")
 endif ()
+if (WAMR_BUILD_GC_INCREMENTAL EQUAL 1)
+  if (NOT WAMR_BUILD_GC EQUAL 1)
+    message (FATAL_ERROR "Incremental GC requires WAMR_BUILD_GC=1")
+  endif ()
+  add_definitions (-DWASM_ENABLE_GC_INCREMENTAL=1)
+  message ("     GC incremental marking enabled")
+endif ()
+if (WAMR_BUILD_GC_GENERATIONAL EQUAL 1)
+  if (NOT WAMR_BUILD_GC EQUAL 1)
+    message (FATAL_ERROR "Generational GC requires WAMR_BUILD_GC=1")
+  endif ()
+  if (WAMR_BUILD_GC_INCREMENTAL EQUAL 1)
+    message (FATAL_ERROR "Generational GC can't be enabled with incremental GC")
+  endif ()
+  add_definitions (-DWASM_ENABLE_GC_GENERATIONAL=1)
+  message ("     GC generational nursery enabled")
+endif ()
 if (WAMR_BUILD_STRINGREF EQUAL 1)
   if (NOT DEFINED WAMR_STRINGREF_IMPL_SOURCE)
     message ("       Using WAMR builtin implementation for stringref")
@@ -489,10 +551,15 @@ if (WAMR_BUILD_WASI_NN EQUAL 1)
   # Variant backends
   if (NOT WAMR_BUILD_WASI_NN_TFLITE EQUAL 1 AND
       NOT WAMR_BUILD_WASI_NN_OPENVINO EQUAL 1 AND
-      NOT WAMR_BUILD_WASI_NN_LLAMACPP EQUAL 1)
+      NOT WAMR_BUILD_WASI_NN_LLAMACPP EQUAL 1 AND
+      NOT WAMR_BUILD_WASI_NN_CPU EQUAL 1)
     message (FATAL_ERROR "   Need to select a backend for WASI-NN")
   endif ()
 
+  if (WAMR_BUILD_WASI_NN_CPU EQUAL 1)
+    message ("     WASI-NN: built-in cpu backend enabled")
+    add_definitions (-DWASM_ENABLE_WASI_NN_CPU=1)
+  endif ()
   if (WAMR_BUILD_WASI_NN_TFLITE EQUAL 1)
     message ("     WASI-NN: backend tflite enabled")
     add_definitions (-DWASM_ENABLE_WASI_NN_TFLITE)
@@ -0,0 +1,78 @@
+# Copyright (C) 2021 Intel Corporation and others.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Map the CONFIG_WAMR_* options of the Kconfig to WAMR's build options,
+# shared by the ESP-IDF component and the host builds which must match
+# the firmware, e.g. tests/benchmarks/embedded-runner
+
+if (CONFIG_WAMR_ENABLE_INTERP)
+  set (WAMR_BUILD_INTERP 1)
+endif ()
+
+if (CONFIG_WAMR_INTERP_FAST)
+  set (WAMR_BUILD_FAST_INTERP 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_AOT)
+  set (WAMR_BUILD_AOT 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_LIBC_BUILTIN)
+  set (WAMR_BUILD_LIBC_BUILTIN 1)
+endif ()
+
+if (CONFIG_WAMR_INTERP_LOADER_MINI)
+  set (WAMR_BUILD_MINI_LOADER 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_MULTI_MODULE)
+    set (WAMR_BUILD_MULTI_MODULE 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_SHARED_MEMORY)
+    set (WAMR_BUILD_SHARED_MEMORY 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_MEMORY_PROFILING)
+    set (WAMR_BUILD_MEMORY_PROFILING 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_PERF_PROFILING)
+    set (WAMR_BUILD_PERF_PROFILING 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_STATIC_PGO)
+    set (WAMR_BUILD_STATIC_PGO 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_SAMPLING_PROFILER)
+    set (WAMR_BUILD_SAMPLING_PROFILER 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_STREAM_LOADER)
+    set (WAMR_BUILD_STREAM_LOADER 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_LAZY_FAST_INTERP)
+    set (WAMR_BUILD_LAZY_FAST_INTERP 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_FAST_INTERP_BCE)
+    set (WAMR_BUILD_FAST_INTERP_BCE 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_RUNTIME_METRICS)
+    set (WAMR_BUILD_RUNTIME_METRICS 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_REF_TYPES)
+    set (WAMR_BUILD_REF_TYPES 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_LIBC_WASI)
+    set (WAMR_BUILD_LIBC_WASI 1)
+endif ()
+
+if (CONFIG_WAMR_ENABLE_LIB_PTHREAD)
+    set (WAMR_BUILD_LIB_PTHREAD 1)
+endif ()
@@ -129,10 +129,74 @@
 #define WASM_ENABLE_FAST_JIT_DUMP 0
 #endif
 
+/* Evict the least called functions when the Fast JIT code cache is
+   full */
+#ifndef WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION
+#define WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION 0
+#endif
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0 && WASM_ENABLE_JIT != 0
+/* The jitted code may be called by LLVM JIT in Multi-tier JIT */
+#undef WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION
+#define WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION 0
+#endif
+
+/* Run constant folding, copy propagation, CSE and DCE on the Fast JIT IR
+   before lowering it, experimental */
+#ifndef WASM_ENABLE_FAST_JIT_OPT_PASSES
+#define WASM_ENABLE_FAST_JIT_OPT_PASSES 0
+#endif
+
+/* Keep the hot local variables of a Fast JIT function in hard registers
+   across basic blocks, experimental */
+#ifndef WASM_ENABLE_FAST_JIT_GLOBAL_REGALLOC
+#define WASM_ENABLE_FAST_JIT_GLOBAL_REGALLOC 0
+#endif
+
+/* Also move the jitted code to merge the free space when the Fast JIT
+   code cache is reclaimed, experimental */
+#ifndef WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION
+#define WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION 0
+#endif
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0 \
+    && WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION == 0
+#undef WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION
+#define WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION 0
+#endif
+
 #ifndef FAST_JIT_DEFAULT_CODE_CACHE_SIZE
 #define FAST_JIT_DEFAULT_CODE_CACHE_SIZE 10 * 1024 * 1024
 #endif
 
+/* Interpret the Fast JIT functions until they are called frequently
+   enough, and then compile them in background threads */
+#ifndef WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE
+#define WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE 0
+#endif
+
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0 \
+    && (WASM_ENABLE_LAZY_JIT == 0 || WASM_ENABLE_JIT != 0)
+/* It requires lazy compilation, and Multi-tier JIT already compiles
+   the functions in background threads */
+#undef WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE
+#define WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE 0
+#endif
+
+#ifndef WASM_FAST_JIT_COMPILE_THREAD_NUM
+/* The number of threads compiling Fast JIT functions in background */
+#define WASM_FAST_JIT_COMPILE_THREAD_NUM 2
+#endif
+
+#if WASM_FAST_JIT_COMPILE_THREAD_NUM < 1
+#error "WASM_FAST_JIT_COMPILE_THREAD_NUM must be greater than 0"
+#endif
+
+#ifndef FAST_JIT_DEFAULT_COMPILE_THRESHOLD
+/* The number of calls to a function before it is compiled in background */
+#define FAST_JIT_DEFAULT_COMPILE_THRESHOLD 10
+#endif
+
 #ifndef WASM_ENABLE_WAMR_COMPILER
 #define WASM_ENABLE_WAMR_COMPILER 0
 #endif
@@ -157,6 +221,11 @@
 #define WASM_ENABLE_WASI_NN_GPU 0
 #endif
 
+/* Built-in, dependency-free CPU backend of wasi-nn */
+#ifndef WASM_ENABLE_WASI_NN_CPU
+#define WASM_ENABLE_WASI_NN_CPU 0
+#endif
+
 #ifndef WASM_ENABLE_WASI_NN_EXTERNAL_DELEGATE
 #define WASM_ENABLE_WASI_NN_EXTERNAL_DELEGATE 0
 #endif
@@ -338,6 +407,74 @@
 #define WASM_ENABLE_PERF_PROFILING 0
 #endif
 
+/* Sampling profiler of the fast interpreter */
+#ifndef WASM_ENABLE_SAMPLING_PROFILER
+#define WASM_ENABLE_SAMPLING_PROFILER 0
+#endif
+
+/* Max number of frames recorded in one sample, the outer frames
+   of a deeper call stack are dropped */
+#ifndef WASM_SAMPLING_PROFILER_MAX_DEPTH
+#define WASM_SAMPLING_PROFILER_MAX_DEPTH 16
+#endif
+
+/* Number of samples kept by the sampling profiler, must be a power
+   of two, the oldest samples are overwritten once it is full */
+#ifndef WASM_SAMPLING_PROFILER_RING_SIZE
+#define WASM_SAMPLING_PROFILER_RING_SIZE 256
+#endif
+
+/* Max number of exec_envs sampled at the same time */
+#ifndef WASM_SAMPLING_PROFILER_MAX_EXEC_ENVS
+#define WASM_SAMPLING_PROFILER_MAX_EXEC_ENVS 8
+#endif
+
+/* Native stack size of the sampler thread */
+#ifndef WASM_SAMPLING_PROFILER_THREAD_STACK_SIZE
+#define WASM_SAMPLING_PROFILER_THREAD_STACK_SIZE APP_THREAD_STACK_SIZE_MIN
+#endif
+
+/* Chunked loader, which buffers the wasm bytecode pushed in chunks
+   section by section and loads it when all of it is pushed */
+#ifndef WASM_ENABLE_STREAM_LOADER
+#define WASM_ENABLE_STREAM_LOADER 0
+#endif
+
+/* Prepare the fast interpreter's code of a function on its first call
+   instead of when loading the module */
+#ifndef WASM_ENABLE_LAZY_FAST_INTERP
+#define WASM_ENABLE_LAZY_FAST_INTERP 0
+#endif
+
+/* Emit the fast interpreter's loads and stores without bounds checks when
+   the loader proves the checks redundant */
+#ifndef WASM_ENABLE_FAST_INTERP_BCE
+#define WASM_ENABLE_FAST_INTERP_BCE 0
+#endif
+
+/* Runtime metrics registry */
+#ifndef WASM_ENABLE_RUNTIME_METRICS
+#define WASM_ENABLE_RUNTIME_METRICS 0
+#endif
+
+/* Max number of distinct native functions whose calls are counted
+   separately by each thread */
+#ifndef WASM_RUNTIME_METRICS_NATIVE_SYMBOLS
+#define WASM_RUNTIME_METRICS_NATIVE_SYMBOLS 32
+#endif
+
+/* Materialize the initial linear memory of a module once into a memfd
+   and map it copy-on-write into each instance, Linux only */
+#ifndef WASM_ENABLE_MEMORY_IMAGE
+#define WASM_ENABLE_MEMORY_IMAGE 0
+#endif
+
+/* Min size of the data segments for a module to get a memory image,
+   smaller ones are cheaper to copy than to map */
+#ifndef WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+#define WASM_MEMORY_IMAGE_MIN_DATA_SIZE (16 * 1024)
+#endif
+
 /* Dump call stack */
 #ifndef WASM_ENABLE_DUMP_CALL_STACK
 #define WASM_ENABLE_DUMP_CALL_STACK 0
@@ -413,6 +550,10 @@
 #else
 #define DEFAULT_WASM_STACK_SIZE (12 * 1024)
 #endif
+/* Min wasm stack size of an AOT module instance sized from the stack
+   usage recorded by wamrc, leaving room for the frames pushed outside
+   of the recorded call graph, e.g. by the host calls into wasm */
+#define WASM_STACK_SIZE_MIN (2 * 1024)
 /* Min auxiliary stack size of each wasm thread */
 #define WASM_THREAD_AUX_STACK_SIZE_MIN (256)
 
@@ -573,6 +714,16 @@
 #define WASM_ENABLE_GC 0
 #endif
 
+/* Incremental marking and lazy sweeping of the GC heaps */
+#ifndef WASM_ENABLE_GC_INCREMENTAL
+#define WASM_ENABLE_GC_INCREMENTAL 0
+#endif
+
+/* Bump-pointer nursery and minor collections of the GC heaps */
+#ifndef WASM_ENABLE_GC_GENERATIONAL
+#define WASM_ENABLE_GC_GENERATIONAL 0
+#endif
+
 #ifndef WASM_CONST_EXPR_STACK_SIZE
 #if WASM_ENABLE_GC != 0
 #define WASM_CONST_EXPR_STACK_SIZE 8
@@ -23,6 +23,10 @@
 #include "aot_perf_map.h"
 #endif
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+#include "../common/wasm_memory.h"
+#endif
+
 #define YMM_PLT_PREFIX "__ymm@"
 #define XMM_PLT_PREFIX "__xmm@"
 #define REAL_PLT_PREFIX "__real@"
@@ -600,7 +604,8 @@ load_target_info_section(const uint8 *buf, const uint8 *buf_end,
         return false;
     }
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_GC_INCREMENTAL != 0 \
+    || WASM_ENABLE_GC_GENERATIONAL != 0
     module->feature_flags = target_info.feature_flags;
 #endif
 
@@ -839,6 +844,40 @@ fail:
 #endif /* WASM_ENABLE_CUSTOM_NAME_SECTION != 0 */
 }
 
+static bool
+load_stack_usage_section(const uint8 *buf, const uint8 *buf_end,
+                         AOTModule *module, char *error_buf,
+                         uint32 error_buf_size)
+{
+    const uint8 *p = buf, *p_end = buf_end;
+    uint32 func_count;
+
+    read_uint32(p, p_end, module->stack_usage_flags);
+    read_uint32(p, p_end, module->max_call_depth);
+    read_uint32(p, p_end, module->max_native_stack_size);
+    read_uint32(p, p_end, module->max_wasm_stack_size);
+    read_uint32(p, p_end, func_count);
+    if (func_count != module->func_count) {
+        set_error_buf(error_buf, error_buf_size,
+                      "invalid function count in stack usage section");
+        goto fail;
+    }
+
+    /* the native stack sizes and the wasm frame sizes of each function
+       follow, which are for tools and not loaded */
+    CHECK_BUF(p, p_end, (uint32)sizeof(uint32) * 2 * func_count);
+
+    module->has_stack_usage = true;
+    LOG_VERBOSE("Load stack usage section, depth: %" PRIu32
+                ", native: %" PRIu32 ", wasm: %" PRIu32,
+                module->max_call_depth, module->max_native_stack_size,
+                module->max_wasm_stack_size);
+    return true;
+
+fail:
+    return false;
+}
+
 #if WASM_ENABLE_STRINGREF != 0
 static bool
 load_string_literal_section(const uint8 *buf, const uint8 *buf_end,
@@ -925,6 +964,11 @@ load_custom_section(const uint8 *buf, const uint8 *buf_end, AOTModule *module,
                 goto fail;
             break;
 #endif
+        case AOT_CUSTOM_SECTION_STACK_USAGE:
+            if (!load_stack_usage_section(buf, buf_end, module, error_buf,
+                                          error_buf_size))
+                goto fail;
+            break;
 #if WASM_ENABLE_LOAD_CUSTOM_SECTION != 0
         case AOT_CUSTOM_SECTION_RAW:
         {
@@ -3881,6 +3925,90 @@ has_module_memory64(AOTModule *module)
 }
 #endif
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* Get the offset of an active data segment if it is a constant */
+static bool
+get_mem_init_data_const_offset(const AOTMemInitData *data_seg,
+                               uint64 *p_offset)
+{
+    if (data_seg->offset.init_expr_type == INIT_EXPR_TYPE_I32_CONST) {
+        *p_offset = data_seg->offset.u.u32;
+        return true;
+    }
+#if WASM_ENABLE_MEMORY64 != 0
+    if (data_seg->offset.init_expr_type == INIT_EXPR_TYPE_I64_CONST) {
+        *p_offset = (uint64)data_seg->offset.u.i64;
+        return true;
+    }
+#endif
+    /* The value of a global may be imported and differ between instances */
+    return false;
+}
+
+/**
+ * Write the active data segments into the memory image of the module,
+ * which is mapped into its instances instead of copying the segments.
+ * Without the image the instances copy the segments as usual.
+ */
+static void
+create_memory_image(AOTModule *module)
+{
+    AOTMemInitData *data_seg;
+    uint64 base_offset, memory_size, data_end = 0, data_size = 0;
+    uint32 i;
+
+    if (module->import_memory_count > 0 || module->memory_count == 0)
+        return;
+
+    memory_size = (uint64)module->memories[0].num_bytes_per_page
+                  * module->memories[0].init_page_count;
+
+    for (i = 0; i < module->mem_init_data_count; i++) {
+        data_seg = module->mem_init_data_list[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (!get_mem_init_data_const_offset(data_seg, &base_offset))
+            return;
+        /* Leave the segment that doesn't fit to the instantiation,
+           which reports it */
+        if (base_offset > memory_size
+            || data_seg->byte_count > memory_size - base_offset)
+            return;
+        if (base_offset + data_seg->byte_count > data_end)
+            data_end = base_offset + data_seg->byte_count;
+        data_size += data_seg->byte_count;
+    }
+
+    if (data_size < WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+        || !wasm_memory_image_create(&module->memory_image, data_end))
+        return;
+
+    /* Write the segments in order, the later ones overwrite the
+       overlapped bytes of the earlier ones like the instantiation */
+    for (i = 0; i < module->mem_init_data_count; i++) {
+        data_seg = module->mem_init_data_list[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        get_mem_init_data_const_offset(data_seg, &base_offset);
+        if (!wasm_memory_image_write(&module->memory_image, base_offset,
+                                     data_seg->bytes, data_seg->byte_count))
+            goto fail;
+    }
+
+    if (!wasm_memory_image_seal(&module->memory_image))
+        goto fail;
+
+    LOG_VERBOSE("Create memory image of %" PRIu64 " bytes", data_end);
+    return;
+fail:
+    wasm_memory_image_destroy(&module->memory_image);
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
+
 static bool
 load_from_sections(AOTModule *module, AOTSection *sections,
                    bool is_load_from_file_buf, bool no_resolve, char *error_buf,
@@ -4067,6 +4195,10 @@ load_from_sections(AOTModule *module, AOTSection *sections,
         }
     }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    create_memory_image(module);
+#endif
+
     /* Flush data cache before executing AOT code,
      * otherwise unpredictable behavior can occur. */
     os_dcache_flush();
@@ -4418,6 +4550,10 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, const LoadArgs *args,
 void
 aot_unload(AOTModule *module)
 {
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    wasm_memory_image_destroy(&module->memory_image);
+#endif
+
     if (module->import_memories)
         destroy_import_memories(module->import_memories);
 
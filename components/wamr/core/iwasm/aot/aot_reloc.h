@@ -150,6 +150,7 @@ typedef struct {
     REG_SYM(wasm_externref_obj_to_internal_obj), \
     REG_SYM(wasm_internal_obj_to_externref_obj), \
     REG_SYM(wasm_obj_is_type_of),          \
+    REG_SYM(wasm_obj_write_barrier),       \
     REG_SYM(wasm_struct_obj_new),
 #else
 #define REG_GC_SYM()
@@ -188,6 +189,7 @@ typedef struct {
     REG_SYM(aot_enlarge_memory),          \
     REG_SYM(aot_set_exception),           \
     REG_SYM(aot_check_app_addr_and_convert),\
+    REG_SYM(aot_update_last_used_shared_heap),\
     REG_SYM(wasm_runtime_quick_invoke_c_api_native),\
     { "memset", (void*)aot_memset },      \
     { "memmove", (void*)aot_memmove },    \
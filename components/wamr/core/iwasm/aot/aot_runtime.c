@@ -57,10 +57,13 @@ bh_static_assert(sizeof(AOTMemoryInstance) == 120);
 bh_static_assert(offsetof(AOTTableInstance, elems) == 24);
 
 bh_static_assert(offsetof(AOTModuleInstanceExtra, stack_sizes) == 0);
-bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap_base_addr_adj)
-                 == 8);
+bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap_cur_range) == 8);
 bh_static_assert(offsetof(AOTModuleInstanceExtra, shared_heap_start_off) == 16);
 
+bh_static_assert(offsetof(WASMSharedHeapRange, start_off) == 0);
+bh_static_assert(offsetof(WASMSharedHeapRange, end_off) == 8);
+bh_static_assert(offsetof(WASMSharedHeapRange, base_addr_adj) == 16);
+
 bh_static_assert(sizeof(CApiFuncImport) == sizeof(uintptr_t) * 3);
 
 bh_static_assert(sizeof(wasm_val_t) == 16);
@@ -1029,6 +1032,17 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     memory_inst->memory_data = p;
     memory_inst->memory_data_end = p + memory_data_size;
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* Map the initial content of the memory instead of copying the data
+       segments later, unless the app heap is inserted before their end */
+    if (memory_idx == 0 && !parent
+        && (heap_size == 0 || heap_offset >= module->memory_image.data_end)
+        && wasm_memory_image_map(&module->memory_image, p, memory_data_size)) {
+        ((AOTModuleInstanceExtra *)module_inst->e)->common.memory_image_mapped =
+            true;
+    }
+#endif
+
     /* Initialize heap info */
     memory_inst->heap_data = p + heap_offset;
     memory_inst->heap_data_end = p + heap_offset + heap_size;
@@ -1239,6 +1253,13 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
             return false;
         }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+        if (((AOTModuleInstanceExtra *)module_inst->e)
+                ->common.memory_image_mapped)
+            /* The segment is mapped with the memory image */
+            continue;
+#endif
+
         if (memory_inst->memory_data) {
             bh_memcpy_s((uint8 *)memory_inst->memory_data + base_offset,
                         (uint32)(memory_inst->memory_data_size - base_offset),
@@ -1851,6 +1872,21 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
             mem_allocator_create(extra->common.gc_heap_pool, gc_heap_size);
         if (!extra->common.gc_heap_handle)
             goto fail;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+        /* The AOT code doesn't call the write barrier, the gc heap must
+           be collected in one pause */
+        if (!(module->feature_flags & WASM_FEATURE_GC_WRITE_BARRIER))
+            mem_allocator_set_gc_incremental(extra->common.gc_heap_handle,
+                                             false);
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+        /* The AOT code doesn't call the write barrier, the old objects
+           referring to young objects can't be remembered */
+        if (!(module->feature_flags & WASM_FEATURE_GC_WRITE_BARRIER))
+            mem_allocator_set_gc_generational(extra->common.gc_heap_handle,
+                                              false);
+#endif
     }
 #endif
 
@@ -1963,9 +1999,16 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     }
 #endif
 
-    /* Initialize the thread related data */
-    if (stack_size == 0)
-        stack_size = DEFAULT_WASM_STACK_SIZE;
+    /* Initialize the thread related data, use the stack size needed by
+       the call graph if wamrc recorded it, or the default size if the
+       call graph is unbounded or its size wasn't recorded */
+    if (stack_size == 0) {
+        if (!aot_get_module_stack_usage(module, NULL, &stack_size)
+            || stack_size == 0)
+            stack_size = DEFAULT_WASM_STACK_SIZE;
+        else if (stack_size < WASM_STACK_SIZE_MIN)
+            stack_size = WASM_STACK_SIZE_MIN;
+    }
 
     module_inst->default_wasm_stack_size = stack_size;
 
@@ -1975,20 +2018,23 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     /*
      * The AOT code checks whether the n bytes to access are in shared heap
      * by checking whether the beginning address meets:
-     *   addr >= start_off && addr <= end_off - n-bytes + 1
-     * where n is 1/2/4/8/16 and `end_off - n-bytes + 1` is constant, e.g.,
-     *   UINT32_MAX, UINT32_MAX-1, UINT32_MAX-3 for n = 1, 2 or 4 in 32-bit
-     * target. To simplify the check, when shared heap is disabled, we set
-     * the start off to UINT64_MAX in 64-bit target and UINT32_MAX in 32-bit
-     * target, so in the checking, the above formula will be false, we don't
-     * need to check whether the shared heap is enabled or not in the AOT
-     * code.
+     *   addr > start_off
+     * where start_off is the lowest offset of the shared heap chain, and
+     * then checks them against the range of the segment of the chain
+     * accessed last, or looks up the chain if they are out of it. To
+     * simplify the check, when shared heap is disabled, we set the start
+     * off to UINT64_MAX in 64-bit target and UINT32_MAX in 32-bit target,
+     * so in the checking, the above formula will be false, we don't need
+     * to check whether the shared heap is enabled or not in the AOT code.
      */
 #if UINTPTR_MAX == UINT64_MAX
     extra->shared_heap_start_off.u64 = UINT64_MAX;
 #else
     extra->shared_heap_start_off.u32[0] = UINT32_MAX;
 #endif
+#if WASM_ENABLE_SHARED_HEAP != 0
+    extra->shared_heap_cur_range = wasm_runtime_get_empty_shared_heap_range();
+#endif
 
 #if WASM_ENABLE_PERF_PROFILING != 0
     total_size = sizeof(AOTFuncPerfProfInfo)
@@ -2196,6 +2242,11 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
 {
     AOTModuleInstanceExtra *extra = (AOTModuleInstanceExtra *)module_inst->e;
     WASMModuleInstanceExtraCommon *common = &extra->common;
+
+    /* the checked out exec_envs must have been returned */
+    wasm_exec_env_pool_destroy(common->exec_env_pool);
+    common->exec_env_pool = NULL;
+
     if (module_inst->exec_env_singleton) {
         /* wasm_exec_env_destroy will call
            wasm_cluster_wait_for_all_except_self to wait for other
@@ -2205,6 +2256,12 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
         wasm_exec_env_destroy((WASMExecEnv *)module_inst->exec_env_singleton);
     }
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    /* Release the shared heap so that it can be chained again */
+    wasm_runtime_detach_shared_heap_internal(
+        (WASMModuleInstanceCommon *)module_inst);
+#endif
+
 #if WASM_ENABLE_PERF_PROFILING != 0
     if (module_inst->func_perf_profilings)
         wasm_runtime_free(module_inst->func_perf_profilings);
@@ -3360,6 +3417,21 @@ aot_check_app_addr_and_convert(AOTModuleInstance *module_inst, bool is_str,
     return ret;
 }
 
+WASMSharedHeapRange *
+aot_update_last_used_shared_heap(AOTModuleInstance *module_inst,
+                                 uint64 app_offset, uint64 bytes)
+{
+#if WASM_ENABLE_SHARED_HEAP != 0
+    return wasm_runtime_update_last_used_shared_heap(
+        (WASMModuleInstanceCommon *)module_inst, app_offset, bytes);
+#else
+    (void)module_inst;
+    (void)app_offset;
+    (void)bytes;
+    return NULL;
+#endif
+}
+
 void *
 aot_memmove(void *dest, const void *src, size_t n)
 {
@@ -3495,6 +3567,28 @@ aot_get_aux_stack(WASMExecEnv *exec_env, uint64 *start_offset, uint32 *size)
 }
 #endif
 
+bool
+aot_get_module_stack_usage(const AOTModule *module, uint32 *native_stack_size,
+                           uint32 *wasm_stack_size)
+{
+    if (!module->has_stack_usage
+        || (module->stack_usage_flags & AOT_STACK_USAGE_FLAG_UNBOUNDED))
+        return false;
+
+    if (native_stack_size) {
+        if ((module->stack_usage_flags & AOT_STACK_USAGE_FLAG_NATIVE)
+            && module->max_native_stack_size
+                   <= UINT32_MAX - WASM_STACK_GUARD_SIZE)
+            *native_stack_size =
+                module->max_native_stack_size + WASM_STACK_GUARD_SIZE;
+        else
+            *native_stack_size = 0;
+    }
+    if (wasm_stack_size)
+        *wasm_stack_size = module->max_wasm_stack_size;
+    return true;
+}
+
 #if (WASM_ENABLE_MEMORY_PROFILING != 0) || (WASM_ENABLE_MEMORY_TRACING != 0)
 static void
 const_string_node_size_cb(void *key, void *value, void *p_const_string_size)
@@ -4874,6 +4968,160 @@ aot_dump_pgo_prof_data_to_buf(AOTModuleInstance *module_inst, char *buf,
 
     return total_size;
 }
+
+/* The compact dump of the PGO counters only holds a header and the
+   counters of all functions encoded as unsigned LEB128, most of them
+   being small. The function records, names and value profiles of the
+   raw profile are left out, the layout hash identifies the instrumented
+   AOT file so that the counters can be added up on the host into a raw
+   profile dumped once from the same file. */
+#define PGO_COUNTERS_MAGIC 0x43475057 /* "WPGC" */
+#define PGO_COUNTERS_VERSION 1
+
+typedef struct PGOCountersHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 num_prof_data;
+    uint32 num_prof_counters;
+    /* FNV-1a hash of func_md5, func_hash and num_counters of all
+       functions in little endian */
+    uint64 layout_hash;
+} PGOCountersHeader;
+
+static uint64
+pgo_layout_hash(uint64 hash, uint64 value, uint32 size)
+{
+    uint32 i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= (uint8)(value >> (i * 8));
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+static uint32
+get_pgo_counters_size(AOTModuleInstance *module_inst,
+                      PGOCountersHeader *header)
+{
+    AOTModule *module = (AOTModule *)module_inst->module;
+    LLVMProfileData *prof_data;
+    uint64 *counters, counter, hash = 0xCBF29CE484222325ULL;
+    uint64 total_size = sizeof(PGOCountersHeader);
+    uint32 num_prof_data = 0, num_prof_counters = 0, num_counters = 0;
+    uint32 i, j, n;
+
+    for (i = 0; i < module->data_section_count; i++) {
+        if (!strncmp(module->data_sections[i].name, "__llvm_prf_data", 15)) {
+            prof_data = (LLVMProfileData *)module->data_sections[i].data;
+            num_prof_data++;
+            num_prof_counters += prof_data->num_counters;
+            hash = pgo_layout_hash(hash, prof_data->func_md5, 8);
+            hash = pgo_layout_hash(hash, prof_data->func_hash, 8);
+            hash = pgo_layout_hash(hash, prof_data->num_counters, 4);
+        }
+        else if (!strncmp(module->data_sections[i].name, "__llvm_prf_cnts",
+                          15)) {
+            counters = (uint64 *)module->data_sections[i].data;
+            n = module->data_sections[i].size / sizeof(uint64);
+            for (j = 0; j < n; j++) {
+                for (counter = counters[j]; counter >= 0x80; counter >>= 7)
+                    total_size++;
+                total_size++;
+            }
+            num_counters += n;
+        }
+    }
+
+    if (num_prof_data == 0 || num_counters != num_prof_counters
+        || total_size > UINT32_MAX)
+        return 0;
+
+    if (header) {
+        header->magic = PGO_COUNTERS_MAGIC;
+        header->version = PGO_COUNTERS_VERSION;
+        header->num_prof_data = num_prof_data;
+        header->num_prof_counters = num_prof_counters;
+        header->layout_hash = hash;
+    }
+    return (uint32)total_size;
+}
+
+uint32
+aot_get_pgo_counters_size(AOTModuleInstance *module_inst)
+{
+    return get_pgo_counters_size(module_inst, NULL);
+}
+
+uint32
+aot_dump_pgo_counters_to_buf(AOTModuleInstance *module_inst, char *buf,
+                             uint32 len)
+{
+    AOTModule *module = (AOTModule *)module_inst->module;
+    PGOCountersHeader header;
+    uint8 *p = (uint8 *)buf;
+    uint64 *counters, counter;
+    uint32 total_size, i, j, n;
+
+    total_size = get_pgo_counters_size(module_inst, &header);
+    if (total_size == 0 || len < total_size)
+        return 0;
+
+    if (!is_little_endian()) {
+        aot_exchange_uint32((uint8 *)&header.magic);
+        aot_exchange_uint32((uint8 *)&header.version);
+        aot_exchange_uint32((uint8 *)&header.num_prof_data);
+        aot_exchange_uint32((uint8 *)&header.num_prof_counters);
+        aot_exchange_uint64((uint8 *)&header.layout_hash);
+    }
+    bh_memcpy_s(p, sizeof(PGOCountersHeader), &header,
+                sizeof(PGOCountersHeader));
+    p += sizeof(PGOCountersHeader);
+
+    for (i = 0; i < module->data_section_count; i++) {
+        if (!strncmp(module->data_sections[i].name, "__llvm_prf_cnts", 15)) {
+            counters = (uint64 *)module->data_sections[i].data;
+            n = module->data_sections[i].size / sizeof(uint64);
+            for (j = 0; j < n; j++) {
+                for (counter = counters[j]; counter >= 0x80; counter >>= 7)
+                    *p++ = (uint8)(counter | 0x80);
+                *p++ = (uint8)counter;
+            }
+        }
+    }
+
+    bh_assert((uint32)(p - (uint8 *)buf) == total_size);
+    return total_size;
+}
+
+void
+aot_reset_pgo_counters(AOTModuleInstance *module_inst)
+{
+    AOTModule *module = (AOTModule *)module_inst->module;
+    LLVMProfileData *prof_data;
+    ValueProfNode **values, *value_node;
+    uint32 i, j, num_value_sites;
+
+    for (i = 0; i < module->data_section_count; i++) {
+        if (!strncmp(module->data_sections[i].name, "__llvm_prf_cnts", 15)) {
+            memset(module->data_sections[i].data, 0,
+                   module->data_sections[i].size);
+        }
+        else if (!strncmp(module->data_sections[i].name, "__llvm_prf_data",
+                          15)) {
+            prof_data = (LLVMProfileData *)module->data_sections[i].data;
+            if (!(values = prof_data->values))
+                continue;
+            num_value_sites = (uint32)prof_data->num_value_sites[0]
+                              + prof_data->num_value_sites[1];
+            for (j = 0; j < num_value_sites; j++) {
+                for (value_node = values[j]; value_node;
+                     value_node = value_node->next)
+                    value_node->count = 0;
+            }
+        }
+    }
+}
 #endif /* end of WASM_ENABLE_STATIC_PGO != 0 */
 
 #if WASM_ENABLE_GC != 0
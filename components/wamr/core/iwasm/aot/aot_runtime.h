@@ -35,6 +35,9 @@ extern "C" {
  * and not at the beginning of each function call */
 #define WASM_FEATURE_FRAME_PER_FUNCTION (1 << 12)
 #define WASM_FEATURE_FRAME_NO_FUNC_IDX (1 << 13)
+/* The write barrier of the incremental or generational GC is called
+ * before overwriting the object reference fields of structs and arrays */
+#define WASM_FEATURE_GC_WRITE_BARRIER (1 << 14)
 
 typedef enum AOTSectionType {
     AOT_SECTION_TYPE_TARGET_INFO = 0,
@@ -57,8 +60,15 @@ typedef enum AOTCustomSectionType {
     AOT_CUSTOM_SECTION_ACCESS_CONTROL = 2,
     AOT_CUSTOM_SECTION_NAME = 3,
     AOT_CUSTOM_SECTION_STRING_LITERAL = 4,
+    AOT_CUSTOM_SECTION_STACK_USAGE = 5,
 } AOTCustomSectionType;
 
+/* The native stack sizes are known, i.e. the module is compiled with
+   the native stack bounds checks or the stack estimation */
+#define AOT_STACK_USAGE_FLAG_NATIVE 1
+/* The call graph has recursion or calls which can't be resolved */
+#define AOT_STACK_USAGE_FLAG_UNBOUNDED 2
+
 typedef struct AOTObjectDataSection {
     char *name;
     uint8 *data;
@@ -118,12 +128,9 @@ typedef struct ExportFuncMap {
 
 typedef struct AOTModuleInstanceExtra {
     DefPointer(const uint32 *, stack_sizes);
-    /*
-     * Adjusted shared heap based addr to simple the calculation
-     * in the aot code. The value is:
-     *   shared_heap->base_addr - shared_heap->start_off
-     */
-    DefPointer(uint8 *, shared_heap_base_addr_adj);
+    /* Range of the shared heap segment accessed last */
+    DefPointer(WASMSharedHeapRange *, shared_heap_cur_range);
+    /* Lowest offset of the attached shared heap chain */
     MemBound shared_heap_start_off;
 
     WASMModuleInstanceExtraCommon common;
@@ -178,6 +185,9 @@ typedef struct AOTModule {
     /* init data */
     uint32 mem_init_data_count;
     AOTMemInitData **mem_init_data_list;
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    WASMMemoryImage memory_image;
+#endif
 
     /* native symbol */
     void **native_symbol_list;
@@ -357,9 +367,18 @@ typedef struct AOTModule {
     uint8 *merged_data_text_sections;
     uint32 merged_data_text_sections_size;
 
-#if WASM_ENABLE_AOT_STACK_FRAME != 0
+#if WASM_ENABLE_AOT_STACK_FRAME != 0 || WASM_ENABLE_GC_INCREMENTAL != 0 \
+    || WASM_ENABLE_GC_GENERATIONAL != 0
     uint32 feature_flags;
 #endif
+
+    /* Stack usage of the call graph computed by wamrc, see
+       AOT_CUSTOM_SECTION_STACK_USAGE */
+    bool has_stack_usage;
+    uint32 stack_usage_flags;
+    uint32 max_call_depth;
+    uint32 max_native_stack_size;
+    uint32 max_wasm_stack_size;
 } AOTModule;
 
 #define AOTMemoryInstance WASMMemoryInstance
@@ -702,6 +721,15 @@ aot_check_app_addr_and_convert(AOTModuleInstance *module_inst, bool is_str,
                                uint64 app_buf_addr, uint64 app_buf_size,
                                void **p_native_addr);
 
+/**
+ * Look up the shared heap chain attached to the module instance for the
+ * segment which contains the app address range, cache its range for the
+ * aot code and return it, or NULL if not found
+ */
+WASMSharedHeapRange *
+aot_update_last_used_shared_heap(AOTModuleInstance *module_inst,
+                                 uint64 app_offset, uint64 bytes);
+
 uint32
 aot_get_plt_table_size(void);
 
@@ -734,6 +762,21 @@ bool
 aot_get_aux_stack(WASMExecEnv *exec_env, uint64 *start_offset, uint32 *size);
 #endif
 
+/**
+ * Get the stack sizes needed to call the functions of the module, from
+ * the stack usage section emitted by `wamrc --emit-stack-usage`
+ *
+ * @param module the AOT module
+ * @param native_stack_size return the native stack size, including
+ *        WASM_STACK_GUARD_SIZE, or 0 if it is unknown
+ * @param wasm_stack_size return the wasm operand stack size
+ *
+ * @return true if the call graph is bounded, false otherwise
+ */
+bool
+aot_get_module_stack_usage(const AOTModule *module, uint32 *native_stack_size,
+                           uint32 *wasm_stack_size);
+
 void
 aot_get_module_mem_consumption(const AOTModule *module,
                                WASMModuleMemConsumption *mem_conspn);
@@ -826,6 +869,16 @@ uint32
 aot_dump_pgo_prof_data_to_buf(AOTModuleInstance *module_inst, char *buf,
                               uint32 len);
 
+uint32
+aot_get_pgo_counters_size(AOTModuleInstance *module_inst);
+
+uint32
+aot_dump_pgo_counters_to_buf(AOTModuleInstance *module_inst, char *buf,
+                             uint32 len);
+
+void
+aot_reset_pgo_counters(AOTModuleInstance *module_inst);
+
 void
 aot_exchange_uint16(uint8 *p_data);
 
@@ -11,6 +11,9 @@
 #if WASM_ENABLE_AOT != 0
 #include "../aot/aot_runtime.h"
 #endif
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+#include "../wasm_runtime_metrics.h"
+#endif
 
 static bool
 wasm_ref_type_normalize(wasm_ref_type_t *ref_type)
@@ -896,6 +899,9 @@ wasm_runtime_get_cur_local_obj_ref(WASMExecEnv *exec_env)
 void
 wasm_runtime_gc_prepare(WASMExecEnv *exec_env)
 {
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_record_gc_begin();
+#endif
 #if 0
     /* TODO: implement wasm_runtime_gc_prepare for multi-thread */
     exec_env->is_gc_reclaiming = false;
@@ -913,6 +919,9 @@ wasm_runtime_gc_finalize(WASMExecEnv *exec_env)
     wasm_thread_resume_all();
     exec_env->doing_gc_reclaim = 0;
 #endif
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_record_gc_end();
+#endif
 }
 
 bool
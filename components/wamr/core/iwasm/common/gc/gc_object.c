@@ -123,6 +123,13 @@ wasm_struct_obj_set_field(WASMStructObjectRef struct_obj, uint32 field_idx,
     field_data = (uint8 *)struct_obj + field->field_offset;
     field_size = field->field_size;
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+    if (wasm_is_type_reftype(field->field_type))
+        wasm_obj_write_barrier((WASMObjectRef)struct_obj,
+                               GET_REF_FROM_ADDR((uint32 *)field_data),
+                               value->gc_obj);
+#endif
+
     if (field_size == 4) {
         *(int32 *)field_data = value->i32;
     }
@@ -272,6 +279,60 @@ wasm_array_obj_new(WASMExecEnv *exec_env, WASMRttTypeRef rtt_type,
                                        init_value);
 }
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+static bool
+wasm_array_obj_is_ref_array(const WASMArrayObjectRef array_obj)
+{
+    WASMRttTypeRef rtt_type =
+        (WASMRttTypeRef)wasm_object_header((WASMObjectRef)array_obj);
+    WASMArrayType *array_type = (WASMArrayType *)rtt_type->defined_type;
+
+    return wasm_is_type_reftype(array_type->elem_type);
+}
+
+/* Call the write barrier for the elements to be overwritten, the new
+   values are read from @src_data, or they are all @value if it is NULL */
+static void
+wasm_array_obj_write_barrier(const WASMArrayObjectRef array_obj,
+                             uint32 elem_idx, uint32 len,
+                             const uint8 *src_data, WASMObjectRef value)
+{
+    uint8 *elem_data;
+    uint32 i;
+
+    if (!wasm_array_obj_is_ref_array(array_obj))
+        return;
+
+    elem_data = wasm_array_obj_elem_addr(array_obj, elem_idx);
+    for (i = 0; i < len; i++) {
+        if (src_data) {
+            value = GET_REF_FROM_ADDR((uint32 *)src_data);
+            src_data += sizeof(WASMObjectRef);
+        }
+        wasm_obj_write_barrier((WASMObjectRef)array_obj,
+                               GET_REF_FROM_ADDR((uint32 *)elem_data), value);
+        elem_data += sizeof(WASMObjectRef);
+    }
+}
+#endif
+
+void
+wasm_obj_write_barrier(WASMObjectRef obj, WASMObjectRef old_value,
+                       WASMObjectRef new_value)
+{
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (wasm_obj_is_created_from_heap(old_value))
+        mem_allocator_write_barrier(old_value);
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    if (wasm_obj_is_created_from_heap(new_value))
+        mem_allocator_generational_write_barrier(obj, new_value);
+#endif
+    (void)obj;
+    (void)old_value;
+    (void)new_value;
+}
+
 void
 wasm_array_obj_set_elem(WASMArrayObjectRef array_obj, uint32 elem_idx,
                         const WASMValue *value)
@@ -279,6 +340,10 @@ wasm_array_obj_set_elem(WASMArrayObjectRef array_obj, uint32 elem_idx,
     uint8 *elem_data = wasm_array_obj_elem_addr(array_obj, elem_idx);
     uint32 elem_size = 1 << wasm_array_obj_elem_size_log(array_obj);
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+    wasm_array_obj_write_barrier(array_obj, elem_idx, 1, NULL, value->gc_obj);
+#endif
+
     switch (elem_size) {
         case 1:
             *(int8 *)elem_data = (int8)value->i32;
@@ -333,6 +398,11 @@ wasm_array_obj_fill(const WASMArrayObjectRef array_obj, uint32 elem_idx,
         return;
     }
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+    wasm_array_obj_write_barrier(array_obj, elem_idx, len, NULL,
+                                 value->gc_obj);
+#endif
+
     for (i = 0; i < len; i++) {
         switch (elem_size) {
             case 2:
@@ -357,6 +427,10 @@ wasm_array_obj_copy(WASMArrayObjectRef dst_obj, uint32 dst_idx,
     uint8 *src_data = wasm_array_obj_elem_addr(src_obj, src_idx);
     uint32 elem_size = 1 << wasm_array_obj_elem_size_log(dst_obj);
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+    wasm_array_obj_write_barrier(dst_obj, dst_idx, len, src_data, NULL);
+#endif
+
     bh_memmove_s(dst_data, elem_size * len, src_data, elem_size * len);
 }
 
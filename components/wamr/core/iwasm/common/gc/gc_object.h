@@ -328,6 +328,19 @@ wasm_obj_is_type_of(WASMObjectRef obj, int32 heap_type);
 bool
 wasm_obj_equal(WASMObjectRef obj1, WASMObjectRef obj2);
 
+/**
+ * The write barrier of the incremental and the generational GC, it must
+ * be called before an object reference field of a struct or an array is
+ * overwritten. It does nothing if neither of them is enabled.
+ *
+ * @param obj the struct or array object whose field is written
+ * @param old_value the old value of the field
+ * @param new_value the new value of the field
+ */
+void
+wasm_obj_write_barrier(WASMObjectRef obj, WASMObjectRef old_value,
+                       WASMObjectRef new_value);
+
 bool
 wasm_object_get_ref_list(WASMObjectRef obj, bool *p_is_compact_mode,
                          uint32 *p_ref_num, uint16 **p_ref_list,
@@ -22,6 +22,9 @@
 
 #if WASM_ENABLE_WASM_CACHE != 0
 #include <openssl/sha.h>
+#if !defined(BH_PLATFORM_WINDOWS)
+#include <sys/stat.h>
+#endif
 #endif
 #if WASM_ENABLE_THREAD_MGR != 0
 #include "thread_manager.h"
@@ -36,6 +39,21 @@
  * - wasm_instance_t can not be shared in threads
  */
 
+#if WASM_ENABLE_WASM_CACHE != 0
+/* Bytes of the head and of the tail of a binary covered by its quick hash */
+#define MODULE_CACHE_QUICK_HASH_SIZE 256
+#define MODULE_CACHE_INIT_SIZE 64
+
+/**
+ * The key of the module cache, a binary is only digested with SHA-256 when
+ * a loaded module has the same key
+ */
+typedef struct WASMModuleCacheKey {
+    uint64 size;
+    uint32 quick_hash;
+} WASMModuleCacheKey;
+#endif
+
 #define ASSERT_NOT_IMPLEMENTED() bh_assert(!"not implemented")
 #define UNREACHABLE() bh_assert(!"unreachable")
 
@@ -48,6 +66,9 @@ typedef struct wasm_module_ex_t {
     uint32 ref_count;
 #if WASM_ENABLE_WASM_CACHE != 0
     char hash[SHA256_DIGEST_LENGTH];
+    WASMModuleCacheKey cache_key;
+    /* the next module with the same cache key */
+    struct wasm_module_ex_t *next_cached;
 #endif
 } wasm_module_ex_t;
 
@@ -347,6 +368,112 @@ wasm_config_set_segue_flags(wasm_config_t *config, uint32 segue_flags)
     return config;
 }
 
+wasm_config_t *
+wasm_config_set_module_cache_dir(wasm_config_t *config, const char *dir)
+{
+    if (!config)
+        return NULL;
+
+    config->module_cache_dir = dir;
+    return config;
+}
+
+#if WASM_ENABLE_WASM_CACHE != 0
+static uint32
+module_cache_key_hash(const void *key)
+{
+    const WASMModuleCacheKey *cache_key = key;
+    return cache_key->quick_hash ^ (uint32)cache_key->size
+           ^ (uint32)(cache_key->size >> 32);
+}
+
+static bool
+module_cache_key_equal(void *key1, void *key2)
+{
+    const WASMModuleCacheKey *cache_key1 = key1, *cache_key2 = key2;
+    return cache_key1->size == cache_key2->size
+           && cache_key1->quick_hash == cache_key2->quick_hash;
+}
+
+/* The persisted AOT images are run as native code, only trust the files
+   which can't be written by group or others */
+static bool
+is_module_cache_file_mode_trusted(const char *path, int fd, bool is_dir)
+{
+#if !defined(BH_PLATFORM_WINDOWS)
+    struct stat st;
+
+    if ((path ? stat(path, &st) : fstat(fd, &st)) != 0)
+        return false;
+    if (is_dir ? !S_ISDIR(st.st_mode) : !S_ISREG(st.st_mode))
+        return false;
+    return (st.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#else
+    (void)path;
+    (void)fd;
+    (void)is_dir;
+    return true;
+#endif
+}
+
+static bool
+is_module_cache_dir_trusted(const char *dir)
+{
+    return is_module_cache_file_mode_trusted(dir, -1, true);
+}
+
+static bool
+module_cache_init(wasm_engine_t *engine, const wasm_config_t *config)
+{
+    size_t len;
+
+    /* the modules are chained, the chain heads own the keys */
+    if (!(engine->module_cache = bh_hash_map_create(
+              MODULE_CACHE_INIT_SIZE, false, module_cache_key_hash,
+              module_cache_key_equal, NULL, NULL)))
+        return false;
+
+    if (os_mutex_init(&engine->module_cache_lock) != BHT_OK) {
+        bh_hash_map_destroy(engine->module_cache);
+        engine->module_cache = NULL;
+        return false;
+    }
+
+    if (config->module_cache_dir && config->module_cache_dir[0]) {
+        len = strlen(config->module_cache_dir) + 1;
+        if (!is_module_cache_dir_trusted(config->module_cache_dir)) {
+            LOG_WARNING("disable the persistent module cache, %s is not "
+                        "a directory or is writable by group or others",
+                        config->module_cache_dir);
+        }
+        else if (len > UINT32_MAX
+                 || !(engine->module_cache_dir = malloc_internal(len))) {
+            LOG_WARNING("disable the persistent module cache");
+        }
+        else {
+            bh_memcpy_s(engine->module_cache_dir, (uint32)len,
+                        config->module_cache_dir, (uint32)len);
+        }
+    }
+    return true;
+}
+
+static void
+module_cache_destroy(wasm_engine_t *engine)
+{
+    if (!engine->module_cache)
+        return;
+
+    bh_hash_map_destroy(engine->module_cache);
+    engine->module_cache = NULL;
+    os_mutex_destroy(&engine->module_cache_lock);
+    if (engine->module_cache_dir) {
+        wasm_runtime_free(engine->module_cache_dir);
+        engine->module_cache_dir = NULL;
+    }
+}
+#endif /* WASM_ENABLE_WASM_CACHE != 0 */
+
 static void
 wasm_engine_delete_internal(wasm_engine_t *engine)
 {
@@ -364,6 +491,10 @@ wasm_engine_delete_internal(wasm_engine_t *engine)
 
         bh_vector_destroy(&engine->modules);
 
+#if WASM_ENABLE_WASM_CACHE != 0
+        module_cache_destroy(engine);
+#endif
+
 #ifndef os_thread_local_attribute
         bh_vector_destroy(&engine->stores_by_tid);
 #endif
@@ -423,6 +554,11 @@ wasm_engine_new_internal(wasm_config_t *config)
         goto failed;
 #endif
 
+#if WASM_ENABLE_WASM_CACHE != 0
+    if (!module_cache_init(engine, config))
+        goto failed;
+#endif
+
     engine->ref_count = 1;
 
     WASM_C_DUMP_PROC_MEM();
@@ -2193,22 +2329,55 @@ module_to_module_ext(wasm_module_t *module)
 #endif
 
 #if WASM_ENABLE_WASM_CACHE != 0
-static wasm_module_ex_t *
-check_loaded_module(Vector *modules, char *binary_hash)
+/* FNV-1a */
+static uint32
+quick_hash_update(uint32 hash, const uint8 *p, const uint8 *p_end)
 {
-    unsigned i;
-    wasm_module_ex_t *module = NULL;
+    while (p < p_end) {
+        hash ^= *p++;
+        hash *= 16777619;
+    }
+    return hash;
+}
 
-    for (i = 0; i < modules->num_elems; i++) {
-        bh_vector_get(modules, i, &module);
-        if (!module) {
-            LOG_ERROR("Unexpected failure at %d\n", __LINE__);
-            return NULL;
-        }
+static void
+get_module_cache_key(const wasm_byte_vec_t *binary, WASMModuleCacheKey *key)
+{
+    const uint8 *data = (const uint8 *)binary->data;
+    uint64 size = binary->size;
+    uint32 hash = 2166136261;
 
-        if (!module->ref_count)
-            /* deleted */
-            continue;
+    if (size <= MODULE_CACHE_QUICK_HASH_SIZE * 2) {
+        hash = quick_hash_update(hash, data, data + size);
+    }
+    else {
+        hash = quick_hash_update(hash, data,
+                                 data + MODULE_CACHE_QUICK_HASH_SIZE);
+        hash = quick_hash_update(hash,
+                                 data + size - MODULE_CACHE_QUICK_HASH_SIZE,
+                                 data + size);
+    }
+
+    key->size = size;
+    key->quick_hash = hash;
+}
+
+/* Should be called with module_cache_lock locked */
+static wasm_module_ex_t *
+check_loaded_module(const WASMModuleCacheKey *key,
+                    const wasm_byte_vec_t *binary, char *binary_hash,
+                    bool *p_is_hash_ready)
+{
+    wasm_module_ex_t *module;
+
+    module = bh_hash_map_find(singleton_engine->module_cache, (void *)key);
+    for (; module; module = module->next_cached) {
+        /* only digest the binary if its key matches a loaded module */
+        if (!*p_is_hash_ready) {
+            SHA256((void *)binary->data, binary->num_elems,
+                   (uint8_t *)binary_hash);
+            *p_is_hash_ready = true;
+        }
 
         if (memcmp(module->hash, binary_hash, SHA256_DIGEST_LENGTH) == 0)
             return module;
@@ -2217,12 +2386,16 @@ check_loaded_module(Vector *modules, char *binary_hash)
 }
 
 static wasm_module_ex_t *
-try_reuse_loaded_module(wasm_store_t *store, char *binary_hash)
+try_reuse_loaded_module(wasm_store_t *store, const WASMModuleCacheKey *key,
+                        const wasm_byte_vec_t *binary, char *binary_hash,
+                        bool *p_is_hash_ready)
 {
     wasm_module_ex_t *cached = NULL;
     wasm_module_ex_t *ret = NULL;
 
-    cached = check_loaded_module(&singleton_engine->modules, binary_hash);
+    os_mutex_lock(&singleton_engine->module_cache_lock);
+
+    cached = check_loaded_module(key, binary, binary_hash, p_is_hash_ready);
     if (!cached)
         goto quit;
 
@@ -2239,8 +2412,265 @@ try_reuse_loaded_module(wasm_store_t *store, char *binary_hash)
 unlock:
     os_mutex_unlock(&cached->lock);
 quit:
+    os_mutex_unlock(&singleton_engine->module_cache_lock);
     return ret;
 }
+
+/* Append the module to the chain of its key */
+static bool
+module_cache_insert(wasm_module_ex_t *module_ex)
+{
+    HashMap *module_cache = singleton_engine->module_cache;
+    wasm_module_ex_t *module;
+    bool ret = true;
+
+    os_mutex_lock(&singleton_engine->module_cache_lock);
+
+    module = bh_hash_map_find(module_cache, &module_ex->cache_key);
+    if (!module) {
+        ret = bh_hash_map_insert(module_cache, &module_ex->cache_key,
+                                 module_ex);
+    }
+    else {
+        while (module->next_cached)
+            module = module->next_cached;
+        module->next_cached = module_ex;
+    }
+
+    os_mutex_unlock(&singleton_engine->module_cache_lock);
+    return ret;
+}
+
+/* Should be called with module_cache_lock locked */
+static void
+module_cache_remove(wasm_module_ex_t *module_ex)
+{
+    HashMap *module_cache = singleton_engine->module_cache;
+    wasm_module_ex_t *module, *next = module_ex->next_cached;
+
+    module = bh_hash_map_find(module_cache, &module_ex->cache_key);
+    if (module == module_ex) {
+        /* the chain head owns the key, re-insert the chain with the key of
+           the next module */
+        bh_hash_map_remove(module_cache, &module_ex->cache_key, NULL, NULL);
+        if (next && !bh_hash_map_insert(module_cache, &next->cache_key, next))
+            LOG_WARNING("drop modules from the module cache");
+    }
+    else {
+        while (module && module->next_cached != module_ex)
+            module = module->next_cached;
+        if (module)
+            module->next_cached = next;
+    }
+
+    module_ex->next_cached = NULL;
+}
+
+#if WASM_ENABLE_AOT != 0
+static char *
+get_persisted_module_path(const char *binary_hash, const char *suffix)
+{
+    const char *dir = singleton_engine->module_cache_dir;
+    uint64 size = strlen(dir) + SHA256_DIGEST_LENGTH * 2 + strlen(suffix) + 2;
+    char *path, *p;
+    uint32 i;
+
+    if (!(path = malloc_internal(size)))
+        return NULL;
+
+    p = path + snprintf(path, (size_t)size, "%s/", dir);
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++, p += 2)
+        snprintf(p, 3, "%02x", (uint8)binary_hash[i]);
+    snprintf(p, strlen(suffix) + 1, "%s", suffix);
+    return path;
+}
+
+static wasm_byte_vec_t *
+read_persisted_module(const char *path)
+{
+    wasm_byte_vec_t *image = NULL;
+    FILE *file;
+    long size;
+
+    if (!(file = fopen(path, "rb")))
+        return NULL;
+
+    if (!is_module_cache_file_mode_trusted(NULL, fileno(file), false)) {
+        LOG_WARNING("ignore the persisted module %s, it is writable by "
+                    "group or others",
+                    path);
+        goto close;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) <= 0
+        || (uint64)size > UINT32_MAX || fseek(file, 0, SEEK_SET) != 0)
+        goto close;
+
+    if (!(image = malloc_internal(sizeof(wasm_byte_vec_t))))
+        goto close;
+
+    wasm_byte_vec_new_uninitialized(image, (size_t)size);
+    if (!image->data
+        || fread(image->data, 1, (size_t)size, file) != (size_t)size) {
+        DEINIT_VEC(image, wasm_byte_vec_delete);
+    }
+
+close:
+    fclose(file);
+    return image;
+}
+
+/* Check the image against the SHA-256 digest persisted along with it */
+static bool
+check_persisted_module_digest(const char *binary_hash,
+                              const wasm_byte_vec_t *image)
+{
+    uint8 image_hash[SHA256_DIGEST_LENGTH];
+    wasm_byte_vec_t *digest;
+    char *path;
+    bool ret = false;
+
+    if (!(path = get_persisted_module_path(binary_hash, ".aot.sha256")))
+        return false;
+
+    if ((digest = read_persisted_module(path))) {
+        SHA256((void *)image->data, image->size, image_hash);
+        ret = digest->size == SHA256_DIGEST_LENGTH
+              && memcmp(digest->data, image_hash, SHA256_DIGEST_LENGTH) == 0;
+        DEINIT_VEC(digest, wasm_byte_vec_delete);
+    }
+
+    if (!ret)
+        LOG_WARNING("ignore the persisted module, its digest %s is "
+                    "missing or doesn't match",
+                    path);
+    wasm_runtime_free(path);
+    return ret;
+}
+
+/**
+ * Load the AOT image persisted for the binary, the image is kept by the
+ * module as its cloned binary. Returns false if there is no usable image,
+ * then the binary is loaded as usual.
+ */
+static bool
+load_persisted_module(wasm_module_ex_t *module_ex, const char *binary_hash,
+                      const LoadArgs *args)
+{
+    wasm_byte_vec_t *image = NULL;
+    LoadArgs image_args = *args;
+    char error_buf[128] = { 0 };
+    char *path;
+
+    if (!(path = get_persisted_module_path(binary_hash, ".aot")))
+        return false;
+
+    image = read_persisted_module(path);
+    if (!image)
+        goto quit;
+
+    if (!check_persisted_module_digest(binary_hash, image))
+        goto free_image;
+
+    if (get_package_type((uint8 *)image->data, (uint32)image->size)
+        != Wasm_Module_AoT)
+        goto free_image;
+
+    image_args.wasm_binary_freeable = false;
+    module_ex->module_comm_rt = wasm_runtime_load_ex(
+        (uint8 *)image->data, (uint32)image->size, &image_args, error_buf,
+        (uint32)sizeof(error_buf));
+    if (!module_ex->module_comm_rt) {
+        LOG_VERBOSE("ignore the persisted module %s: %s", path, error_buf);
+        goto free_image;
+    }
+
+    if (module_ex->is_binary_cloned)
+        DEINIT_VEC(module_ex->binary, wasm_byte_vec_delete);
+    module_ex->binary = image;
+    module_ex->is_binary_cloned = true;
+    wasm_runtime_free(path);
+    return true;
+
+free_image:
+    DEINIT_VEC(image, wasm_byte_vec_delete);
+quit:
+    wasm_runtime_free(path);
+    return false;
+}
+#endif /* end of WASM_ENABLE_AOT != 0 */
+
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT == 0
+static uint8 *
+emit_aot_file_buf(wasm_module_ex_t *module_ex, uint32 *p_aot_file_size);
+
+/* Write a file of the module cache to a temporary file first, so that a
+   partial file is never read */
+static bool
+write_persisted_file(const char *binary_hash, const char *suffix,
+                     const char *tmp_suffix, const uint8 *buf, uint32 size)
+{
+    char *path = NULL, *tmp_path = NULL;
+    FILE *file;
+    bool ret = false;
+
+    if (!(path = get_persisted_module_path(binary_hash, suffix))
+        || !(tmp_path = get_persisted_module_path(binary_hash, tmp_suffix)))
+        goto quit;
+
+    if (!(file = fopen(tmp_path, "wb")))
+        goto quit;
+
+#if !defined(BH_PLATFORM_WINDOWS)
+    /* don't let the umask make the file writable by group or others */
+    if (fchmod(fileno(file), S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) != 0) {
+        fclose(file);
+        remove(tmp_path);
+        goto quit;
+    }
+#endif
+
+    ret = fwrite(buf, 1, size, file) == size;
+    ret = (fclose(file) == 0) && ret;
+    if (!ret || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        ret = false;
+    }
+
+quit:
+    if (tmp_path)
+        wasm_runtime_free(tmp_path);
+    if (path)
+        wasm_runtime_free(path);
+    return ret;
+}
+
+/**
+ * Persist the AOT image of a module compiled by the JIT along with the
+ * SHA-256 digest of the image, which is checked before the image is loaded.
+ */
+static void
+persist_module(wasm_module_ex_t *module_ex, const char *binary_hash)
+{
+    uint8 image_hash[SHA256_DIGEST_LENGTH];
+    uint8 *aot_file_buf;
+    uint32 aot_file_size = 0;
+
+    if (!(aot_file_buf = emit_aot_file_buf(module_ex, &aot_file_size)))
+        return;
+
+    SHA256(aot_file_buf, aot_file_size, image_hash);
+    if (!write_persisted_file(binary_hash, ".aot", ".aot.tmp", aot_file_buf,
+                              aot_file_size)
+        || !write_persisted_file(binary_hash, ".aot.sha256",
+                                 ".aot.sha256.tmp", image_hash,
+                                 SHA256_DIGEST_LENGTH))
+        LOG_WARNING("failed to persist the module to %s",
+                    singleton_engine->module_cache_dir);
+
+    wasm_runtime_free(aot_file_buf);
+}
+#endif /* end of WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT == 0 */
 #endif /* WASM_ENABLE_WASM_CACHE != 0 */
 
 wasm_module_t *
@@ -2248,8 +2678,11 @@ wasm_module_new_ex(wasm_store_t *store, wasm_byte_vec_t *binary, LoadArgs *args)
 {
     char error_buf[128] = { 0 };
     wasm_module_ex_t *module_ex = NULL;
+    PackageType pkg_type;
 #if WASM_ENABLE_WASM_CACHE != 0
     char binary_hash[SHA256_DIGEST_LENGTH] = { 0 };
+    WASMModuleCacheKey cache_key;
+    bool is_hash_ready = false;
 #endif
 
     bh_assert(singleton_engine);
@@ -2260,10 +2693,9 @@ wasm_module_new_ex(wasm_store_t *store, wasm_byte_vec_t *binary, LoadArgs *args)
     /* whether the combination of compilation flags are compatable with the
      * package type */
     {
-        PackageType pkg_type;
+        bool result = false;
         pkg_type =
             get_package_type((uint8 *)binary->data, (uint32)binary->size);
-        bool result = false;
 #if WASM_ENABLE_INTERP != 0
         result = (pkg_type == Wasm_Module_Bytecode);
 #endif
@@ -2280,10 +2712,16 @@ wasm_module_new_ex(wasm_store_t *store, wasm_byte_vec_t *binary, LoadArgs *args)
 
 #if WASM_ENABLE_WASM_CACHE != 0
     /* if cached */
-    SHA256((void *)binary->data, binary->num_elems, (uint8_t *)binary_hash);
-    module_ex = try_reuse_loaded_module(store, binary_hash);
+    get_module_cache_key(binary, &cache_key);
+    module_ex = try_reuse_loaded_module(store, &cache_key, binary,
+                                        binary_hash, &is_hash_ready);
     if (module_ex)
         return module_ext_to_module(module_ex);
+
+    /* the loaders may modify the binary, digest it before loading */
+    if (!is_hash_ready)
+        SHA256((void *)binary->data, binary->num_elems,
+               (uint8_t *)binary_hash);
 #endif
 
     WASM_C_DUMP_PROC_MEM();
@@ -2307,12 +2745,27 @@ wasm_module_new_ex(wasm_store_t *store, wasm_byte_vec_t *binary, LoadArgs *args)
     }
 
     args->wasm_binary_freeable = !args->clone_wasm_binary;
-    module_ex->module_comm_rt = wasm_runtime_load_ex(
-        (uint8 *)module_ex->binary->data, (uint32)module_ex->binary->size, args,
-        error_buf, (uint32)sizeof(error_buf));
-    if (!(module_ex->module_comm_rt)) {
-        LOG_ERROR("%s", error_buf);
-        goto free_vec;
+    module_ex->module_comm_rt = NULL;
+#if WASM_ENABLE_WASM_CACHE != 0 && WASM_ENABLE_AOT != 0
+    if (pkg_type == Wasm_Module_Bytecode && singleton_engine->module_cache_dir)
+        load_persisted_module(module_ex, binary_hash, args);
+#endif
+
+    if (!module_ex->module_comm_rt) {
+        module_ex->module_comm_rt = wasm_runtime_load_ex(
+            (uint8 *)module_ex->binary->data, (uint32)module_ex->binary->size,
+            args, error_buf, (uint32)sizeof(error_buf));
+        if (!(module_ex->module_comm_rt)) {
+            LOG_ERROR("%s", error_buf);
+            goto free_vec;
+        }
+
+#if WASM_ENABLE_WASM_CACHE != 0 && WASM_ENABLE_JIT != 0 \
+    && WASM_ENABLE_LAZY_JIT == 0
+        if (pkg_type == Wasm_Module_Bytecode
+            && singleton_engine->module_cache_dir)
+            persist_module(module_ex, binary_hash);
+#endif
     }
 
     /* append it to a watching list in store */
@@ -2325,13 +2778,17 @@ wasm_module_new_ex(wasm_store_t *store, wasm_byte_vec_t *binary, LoadArgs *args)
     if (!bh_vector_append(&singleton_engine->modules, &module_ex))
         goto destroy_lock;
 
+    module_ex->ref_count = 1;
+
 #if WASM_ENABLE_WASM_CACHE != 0
     bh_memcpy_s(module_ex->hash, sizeof(module_ex->hash), binary_hash,
                 sizeof(binary_hash));
+    module_ex->cache_key = cache_key;
+    module_ex->next_cached = NULL;
+    if (!module_cache_insert(module_ex))
+        LOG_WARNING("failed to add the module to the module cache");
 #endif
 
-    module_ex->ref_count = 1;
-
     WASM_C_DUMP_PROC_MEM();
 
     return module_ext_to_module(module_ex);
@@ -2344,10 +2801,10 @@ remove_last:
 unload:
     wasm_runtime_unload(module_ex->module_comm_rt);
 free_vec:
-    if (args->clone_wasm_binary)
+    if (module_ex->is_binary_cloned)
         wasm_byte_vec_delete(module_ex->binary);
 free_binary:
-    if (args->clone_wasm_binary)
+    if (module_ex->is_binary_cloned)
         wasm_runtime_free(module_ex->binary);
 free_module:
     wasm_runtime_free(module_ex);
@@ -2412,15 +2869,27 @@ wasm_module_delete_internal(wasm_module_t *module)
 
     module_ex = module_to_module_ext(module);
 
+#if WASM_ENABLE_WASM_CACHE != 0
+    /* same lock order as the lookup of the module cache */
+    os_mutex_lock(&singleton_engine->module_cache_lock);
+#endif
     os_mutex_lock(&module_ex->lock);
 
     /* N -> N-1 -> 0 -> UINT32_MAX */
     module_ex->ref_count--;
     if (module_ex->ref_count > 0) {
         os_mutex_unlock(&module_ex->lock);
+#if WASM_ENABLE_WASM_CACHE != 0
+        os_mutex_unlock(&singleton_engine->module_cache_lock);
+#endif
         return;
     }
 
+#if WASM_ENABLE_WASM_CACHE != 0
+    module_cache_remove(module_ex);
+    os_mutex_unlock(&singleton_engine->module_cache_lock);
+#endif
+
     if (module_ex->is_binary_cloned)
         DEINIT_VEC(module_ex->binary, wasm_byte_vec_delete);
 
@@ -2879,12 +3348,24 @@ wasm_module_deserialize(wasm_store_t *module, const wasm_byte_vec_t *binary)
 extern uint8 *
 aot_emit_aot_file_buf(AOTCompContext *comp_ctx, AOTCompData *comp_data,
                       uint32 *p_aot_file_size);
+
+static uint8 *
+emit_aot_file_buf(wasm_module_ex_t *module_ex, uint32 *p_aot_file_size)
+{
+    AOTCompContext *comp_ctx;
+    AOTCompData *comp_data;
+
+    comp_ctx = ((WASMModule *)(module_ex->module_comm_rt))->comp_ctx;
+    comp_data = ((WASMModule *)(module_ex->module_comm_rt))->comp_data;
+    bh_assert(comp_ctx != NULL && comp_data != NULL);
+
+    return aot_emit_aot_file_buf(comp_ctx, comp_data, p_aot_file_size);
+}
+
 void
 wasm_module_serialize(wasm_module_t *module, own wasm_byte_vec_t *out)
 {
     wasm_module_ex_t *module_ex;
-    AOTCompContext *comp_ctx;
-    AOTCompData *comp_data;
     uint8 *aot_file_buf = NULL;
     uint32 aot_file_size = 0;
 
@@ -2895,11 +3376,15 @@ wasm_module_serialize(wasm_module_t *module, own wasm_byte_vec_t *out)
         return;
 
     module_ex = module_to_module_ext(module);
-    comp_ctx = ((WASMModule *)(module_ex->module_comm_rt))->comp_ctx;
-    comp_data = ((WASMModule *)(module_ex->module_comm_rt))->comp_data;
-    bh_assert(comp_ctx != NULL && comp_data != NULL);
+    if (wasm_runtime_get_module_package_type(module_ex->module_comm_rt)
+        == Wasm_Module_AoT) {
+        /* e.g. loaded from the module cache, the binary is the image */
+        if (module_ex->is_binary_cloned)
+            wasm_byte_vec_copy(out, module_ex->binary);
+        return;
+    }
 
-    aot_file_buf = aot_emit_aot_file_buf(comp_ctx, comp_data, &aot_file_size);
+    aot_file_buf = emit_aot_file_buf(module_ex, &aot_file_size);
     if (!aot_file_buf)
         return;
 
@@ -3015,6 +3500,59 @@ wasm_module_is_underlying_binary_freeable(const wasm_module_t *module)
     return wasm_runtime_is_underlying_binary_freeable(*module);
 }
 
+static uint32
+valkind_cell_num(wasm_valkind_t kind)
+{
+    switch (kind) {
+        case WASM_I32:
+        case WASM_F32:
+            return 1;
+        case WASM_I64:
+        case WASM_F64:
+            return 2;
+        case WASM_V128:
+            return 4;
+        default:
+            return sizeof(uintptr_t) / sizeof(uint32);
+    }
+}
+
+static wasm_func_layout_t *
+wasm_func_layout_new(const wasm_functype_t *type)
+{
+    const wasm_valtype_vec_t *params = type->params, *results = type->results;
+    wasm_func_layout_t *layout;
+    uint32 param_cell_num = 0, result_cell_num = 0, argv_cell_num, i;
+    uint64 size, kinds_size;
+
+    for (i = 0; i < params->num_elems; i++)
+        param_cell_num += valkind_cell_num(params->data[i]->kind);
+    for (i = 0; i < results->num_elems; i++)
+        result_cell_num += valkind_cell_num(results->data[i]->kind);
+
+    kinds_size = (uint64)params->num_elems + results->num_elems;
+    size = align_uint64(offsetof(wasm_func_layout_t, kinds) + kinds_size, 8);
+    argv_cell_num =
+        param_cell_num > result_cell_num ? param_cell_num : result_cell_num;
+    /* the argv of a big function is allocated with its layout */
+    if (argv_cell_num > WASM_FUNC_ARGV_BUF_SIZE)
+        size += sizeof(uint32) * (uint64)argv_cell_num;
+
+    if (!(layout = malloc_internal(size)))
+        return NULL;
+
+    layout->param_cell_num = param_cell_num;
+    layout->result_cell_num = result_cell_num;
+    for (i = 0; i < params->num_elems; i++)
+        layout->kinds[i] = params->data[i]->kind;
+    for (i = 0; i < results->num_elems; i++)
+        layout->kinds[params->num_elems + i] = results->data[i]->kind;
+    if (argv_cell_num > WASM_FUNC_ARGV_BUF_SIZE)
+        layout->argv = (uint32 *)((uint8 *)layout + size
+                                  - sizeof(uint32) * argv_cell_num);
+    return layout;
+}
+
 static wasm_func_t *
 wasm_func_new_basic(wasm_store_t *store, const wasm_functype_t *type,
                     wasm_func_callback_t func_callback)
@@ -3170,6 +3708,10 @@ wasm_func_new_internal(wasm_store_t *store, uint16 func_idx_rt,
     func->param_count = (uint16)func->type->params->num_elems;
     func->result_count = (uint16)func->type->results->num_elems;
 
+    if (!(func->layout = wasm_func_layout_new(func->type))) {
+        goto failed;
+    }
+
     /* will add name information when processing "exports" */
     func->store = store;
     func->module_name = NULL;
@@ -3210,6 +3752,11 @@ wasm_func_delete(wasm_func_t *func)
         func->type = NULL;
     }
 
+    if (func->layout) {
+        wasm_runtime_free(func->layout);
+        func->layout = NULL;
+    }
+
     if (func->with_env) {
         if (func->u.cb_env.finalizer) {
             func->u.cb_env.finalizer(func->u.cb_env.env);
@@ -3243,6 +3790,10 @@ wasm_func_copy(const wasm_func_t *func)
     cloned->func_idx_rt = func->func_idx_rt;
     cloned->inst_comm_rt = func->inst_comm_rt;
 
+    if (func->layout && !(cloned->layout = wasm_func_layout_new(func->type))) {
+        goto failed;
+    }
+
     RETURN_OBJ(cloned, wasm_func_delete)
 }
 
@@ -3256,20 +3807,16 @@ wasm_func_type(const wasm_func_t *func)
 }
 
 static bool
-params_to_argv(const wasm_val_vec_t *params,
-               const wasm_valtype_vec_t *param_defs, uint32 *argv,
-               uint32 *ptr_argc)
+params_to_argv(const wasm_func_layout_t *layout, uint32 param_count,
+               const wasm_val_t *params, uint32 *argv)
 {
-    uint32 *argv_org = argv;
-    const wasm_val_t *param, *param_end;
-
-    bh_assert(params && params->num_elems && params->size && params->data);
+    const wasm_valkind_t *kind = layout->kinds;
+    const wasm_val_t *param = params, *param_end = params + param_count;
 
-    param = params->data;
-    param_end = param + param_defs->num_elems;
+    bh_assert(!param_count || params);
 
-    for (; param < param_end; param++) {
-        switch (param->kind) {
+    for (; param < param_end; param++, kind++) {
+        switch (*kind) {
             case WASM_I32:
             case WASM_F32:
                 *(int32 *)argv = param->of.i32;
@@ -3280,9 +3827,6 @@ params_to_argv(const wasm_val_vec_t *params,
                 *(int64 *)argv = param->of.i64;
                 argv += 2;
                 break;
-            case WASM_V128:
-                bh_assert(0);
-                break;
 #if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
             case WASM_EXTERNREF:
                 *(uintptr_t *)argv = (uintptr_t)param->of.ref;
@@ -3290,30 +3834,25 @@ params_to_argv(const wasm_val_vec_t *params,
                 break;
 #endif
             default:
-                LOG_WARNING("unexpected parameter val type %d", param->kind);
+                LOG_WARNING("unexpected parameter val type %d", *kind);
                 return false;
         }
     }
 
-    *ptr_argc = (uint32)(argv - argv_org);
     return true;
 }
 
 static bool
-argv_to_results(const uint32 *argv, const wasm_valtype_vec_t *result_defs,
-                wasm_val_vec_t *results)
+argv_to_results(const wasm_func_layout_t *layout, uint32 param_count,
+                uint32 result_count, const uint32 *argv, wasm_val_t *results)
 {
-    wasm_valtype_t **result_def, **result_def_end;
-    wasm_val_t *result;
+    const wasm_valkind_t *kind = layout->kinds + param_count;
+    wasm_val_t *result = results, *result_end = results + result_count;
 
-    bh_assert(results && results->size && results->data);
+    bh_assert(!result_count || results);
 
-    result_def = result_defs->data;
-    result_def_end = result_def + result_defs->num_elems;
-    result = results->data;
-
-    for (; result_def < result_def_end; result_def++, result++) {
-        result->kind = result_def[0]->kind;
+    for (; result < result_end; result++, kind++) {
+        result->kind = *kind;
         switch (result->kind) {
             case WASM_I32:
             case WASM_F32:
@@ -3325,9 +3864,6 @@ argv_to_results(const uint32 *argv, const wasm_valtype_vec_t *result_defs,
                 result->of.i64 = *(int64 *)argv;
                 argv += 2;
                 break;
-            case WASM_V128:
-                bh_assert(0);
-                break;
 #if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
             case WASM_EXTERNREF:
             case WASM_FUNCREF:
@@ -3345,33 +3881,23 @@ argv_to_results(const uint32 *argv, const wasm_valtype_vec_t *result_defs,
     return true;
 }
 
-wasm_trap_t *
-wasm_func_call(const wasm_func_t *func, const wasm_val_vec_t *params,
-               wasm_val_vec_t *results)
+static wasm_trap_t *
+wasm_func_new_unlinked_trap(const wasm_func_t *func)
 {
-    /* parameters count as if all are uint32 */
-    /* a int64 or float64 parameter means 2 */
-    uint32 argc = 0;
-    /* a parameter list and a return value list */
-    uint32 argv_buf[32] = { 0 }, *argv = argv_buf;
-    WASMFunctionInstanceCommon *func_comm_rt = NULL;
-    WASMExecEnv *exec_env = NULL;
-    size_t param_count, result_count, alloc_count;
-    Vector *cluster_frames = NULL;
-
-    bh_assert(func && func->type);
+    wasm_name_t message = { 0 };
+    wasm_trap_t *trap;
 
-    if (!func->inst_comm_rt) {
-        wasm_name_t message = { 0 };
-        wasm_trap_t *trap;
+    wasm_name_new_from_string_nt(&message, "failed to call unlinked function");
+    trap = wasm_trap_new(func->store, &message);
+    wasm_byte_vec_delete(&message);
 
-        wasm_name_new_from_string_nt(&message,
-                                     "failed to call unlinked function");
-        trap = wasm_trap_new(func->store, &message);
-        wasm_byte_vec_delete(&message);
+    return trap;
+}
 
-        return trap;
-    }
+static WASMFunctionInstanceCommon *
+wasm_func_get_func_comm_rt(const wasm_func_t *func)
+{
+    WASMFunctionInstanceCommon *func_comm_rt = NULL;
 
     if (func->inst_comm_rt->module_type == Wasm_Module_Bytecode) {
 #if WASM_ENABLE_INTERP != 0
@@ -3390,30 +3916,13 @@ wasm_func_call(const wasm_func_t *func, const wasm_val_vec_t *params,
 #endif
     }
 
-    /*
-     * a wrong combination of module filetype and compilation flags
-     * also leads to below branch
-     */
-    if (!func_comm_rt) {
-        goto failed;
-    }
-
-    param_count = wasm_func_param_arity(func);
-    result_count = wasm_func_result_arity(func);
-
-    alloc_count = (param_count > result_count) ? param_count : result_count;
-    if (alloc_count > (size_t)sizeof(argv_buf) / sizeof(uint64)) {
-        if (!(argv = malloc_internal(sizeof(uint64) * alloc_count))) {
-            goto failed;
-        }
-    }
+    return func_comm_rt;
+}
 
-    /* copy parameters */
-    if (param_count
-        && !params_to_argv(params, wasm_functype_params(func->type), argv,
-                           &argc)) {
-        goto failed;
-    }
+static WASMExecEnv *
+wasm_func_get_exec_env(const wasm_func_t *func)
+{
+    WASMExecEnv *exec_env = NULL;
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     exec_env = wasm_runtime_get_exec_env_tls();
@@ -3426,37 +3935,55 @@ wasm_func_call(const wasm_func_t *func, const wasm_val_vec_t *params,
     if (!exec_env) {
         exec_env = wasm_runtime_get_exec_env_singleton(func->inst_comm_rt);
     }
-    if (!exec_env) {
-        goto failed;
+    return exec_env;
+}
+
+/* Call the function once, params and results are arrays of its arity */
+static bool
+wasm_func_call_internal(const wasm_func_t *func,
+                        WASMFunctionInstanceCommon *func_comm_rt,
+                        WASMExecEnv *exec_env, const wasm_val_t *params,
+                        wasm_val_t *results)
+{
+    const wasm_func_layout_t *layout = func->layout;
+    /* a parameter list and a return value list */
+    uint32 argv_buf[WASM_FUNC_ARGV_BUF_SIZE], *argv;
+
+    /* the argv of a big function is allocated with its layout, it can be
+       reused by a nested call of the function, since the params are copied
+       before the call and the results are written after it returns */
+    argv = layout->argv ? layout->argv : argv_buf;
+
+    /* copy parameters */
+    if (func->param_count
+        && !params_to_argv(layout, func->param_count, params, argv)) {
+        return false;
     }
 
-    wasm_runtime_set_exception(func->inst_comm_rt, NULL);
-    if (!wasm_runtime_call_wasm(exec_env, func_comm_rt, argc, argv)) {
+    if (!wasm_runtime_call_wasm(exec_env, func_comm_rt,
+                                layout->param_cell_num, argv)) {
         if (wasm_runtime_get_exception(func->inst_comm_rt)) {
             LOG_DEBUG("%s", wasm_runtime_get_exception(func->inst_comm_rt));
-            goto failed;
+            return false;
         }
     }
 
     /* copy results */
-    if (result_count) {
-        if (!argv_to_results(argv, wasm_functype_results(func->type),
-                             results)) {
-            wasm_runtime_set_exception(func->inst_comm_rt,
-                                       "argv_to_results failed");
-            goto failed;
-        }
-        results->num_elems = result_count;
-        results->size = result_count;
+    if (func->result_count
+        && !argv_to_results(layout, func->param_count, func->result_count,
+                            argv, results)) {
+        wasm_runtime_set_exception(func->inst_comm_rt,
+                                   "argv_to_results failed");
+        return false;
     }
 
-    if (argv != argv_buf)
-        wasm_runtime_free(argv);
-    return NULL;
+    return true;
+}
 
-failed:
-    if (argv != argv_buf)
-        wasm_runtime_free(argv);
+static wasm_trap_t *
+wasm_func_new_call_trap(const wasm_func_t *func, WASMExecEnv *exec_env)
+{
+    Vector *cluster_frames = NULL;
 
 #if WASM_ENABLE_DUMP_CALL_STACK != 0 && WASM_ENABLE_THREAD_MGR != 0
     WASMCluster *cluster = wasm_exec_env_get_cluster(exec_env);
@@ -3474,6 +4001,105 @@ failed:
     return trap;
 }
 
+wasm_trap_t *
+wasm_func_call(const wasm_func_t *func, const wasm_val_vec_t *params,
+               wasm_val_vec_t *results)
+{
+    WASMFunctionInstanceCommon *func_comm_rt = NULL;
+    WASMExecEnv *exec_env = NULL;
+
+    bh_assert(func && func->type);
+
+    if (!func->inst_comm_rt) {
+        return wasm_func_new_unlinked_trap(func);
+    }
+
+    /*
+     * a wrong combination of module filetype and compilation flags
+     * also leads to below branch
+     */
+    if (!(func_comm_rt = wasm_func_get_func_comm_rt(func))) {
+        goto failed;
+    }
+
+    if (!(exec_env = wasm_func_get_exec_env(func))) {
+        goto failed;
+    }
+
+    bh_assert(!func->param_count
+              || (params && params->num_elems >= func->param_count));
+    bh_assert(!func->result_count
+              || (results && results->size >= func->result_count));
+
+    wasm_runtime_set_exception(func->inst_comm_rt, NULL);
+    if (!wasm_func_call_internal(func, func_comm_rt, exec_env,
+                                 params ? params->data : NULL,
+                                 results ? results->data : NULL)) {
+        goto failed;
+    }
+
+    if (func->result_count) {
+        results->num_elems = func->result_count;
+        results->size = func->result_count;
+    }
+    return NULL;
+
+failed:
+    return wasm_func_new_call_trap(func, exec_env);
+}
+
+wasm_trap_t *
+wasm_func_call_batch(const wasm_func_t *func, const wasm_val_t args[],
+                     wasm_val_t results[], size_t count, size_t *completed)
+{
+    WASMFunctionInstanceCommon *func_comm_rt = NULL;
+    WASMExecEnv *exec_env = NULL;
+    size_t i = 0;
+
+    bh_assert(func && func->type);
+
+    if (completed) {
+        *completed = 0;
+    }
+
+    if (!func->inst_comm_rt) {
+        return wasm_func_new_unlinked_trap(func);
+    }
+
+    if (!(func_comm_rt = wasm_func_get_func_comm_rt(func))) {
+        goto failed;
+    }
+
+    if (!(exec_env = wasm_func_get_exec_env(func))) {
+        goto failed;
+    }
+
+    if ((func->param_count && !args) || (func->result_count && !results)) {
+        goto failed;
+    }
+
+    wasm_runtime_set_exception(func->inst_comm_rt, NULL);
+    for (i = 0; i < count; i++) {
+        if (!wasm_func_call_internal(
+                func, func_comm_rt, exec_env,
+                args ? args + i * func->param_count : NULL,
+                results ? results + i * func->result_count : NULL)) {
+            goto failed;
+        }
+    }
+
+    if (completed) {
+        *completed = count;
+    }
+    return NULL;
+
+failed:
+    if (completed) {
+        *completed = i;
+    }
+    return wasm_func_new_call_trap(func, exec_env);
+}
+
 size_t
 wasm_func_param_arity(const wasm_func_t *func)
 {
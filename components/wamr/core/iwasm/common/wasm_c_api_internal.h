@@ -8,6 +8,9 @@
 
 #include "../include/wasm_c_api.h"
 #include "wasm_runtime_common.h"
+#if WASM_ENABLE_WASM_CACHE != 0
+#include "bh_hashmap.h"
+#endif
 
 #ifndef own
 #define own
@@ -30,6 +33,14 @@ struct wasm_engine_t {
     Vector modules;
     /* list of stores which are classified according to tids */
     Vector stores_by_tid;
+#if WASM_ENABLE_WASM_CACHE != 0
+    /* index of the loaded modules, keyed by the size and a quick hash of
+       their binaries, the modules with the same key are chained */
+    HashMap *module_cache;
+    korp_mutex module_cache_lock;
+    /* where the AOT images of the modules are persisted, may be NULL */
+    char *module_cache_dir;
+#endif
 };
 
 struct wasm_store_t {
@@ -122,6 +133,26 @@ struct wasm_foreign_t {
     WASMModuleInstanceCommon *inst_comm_rt;
 };
 
+/* Cells of the argv buffer on the stack of wasm_func_call */
+#define WASM_FUNC_ARGV_BUF_SIZE 32
+
+/**
+ * The layout of the params and the results of a function in argv, it is
+ * computed once when the function is created, so that calling the function
+ * doesn't walk its type or allocate memory
+ */
+typedef struct wasm_func_layout_t {
+    /* cells of the params in argv */
+    uint32 param_cell_num;
+    /* cells of the results in argv */
+    uint32 result_cell_num;
+    /* argv of the functions whose params or results don't fit in the
+       buffer on the stack, NULL otherwise */
+    uint32 *argv;
+    /* kinds of the params followed by the kinds of the results */
+    wasm_valkind_t kinds[1];
+} wasm_func_layout_t;
+
 struct wasm_func_t {
     wasm_store_t *store;
     wasm_name_t *module_name;
@@ -132,6 +163,8 @@ struct wasm_func_t {
     wasm_functype_t *type;
     uint16 param_count;
     uint16 result_count;
+    /* only created for the functions of the runtime instances */
+    wasm_func_layout_t *layout;
 
     bool with_env;
     union {
@@ -5,6 +5,7 @@
 
 #include "wasm_exec_env.h"
 #include "wasm_runtime_common.h"
+#include "bh_atomic.h"
 #if WASM_ENABLE_GC != 0
 #include "mem_alloc.h"
 #endif
@@ -14,6 +15,9 @@
 #if WASM_ENABLE_AOT != 0
 #include "../aot/aot_runtime.h"
 #endif
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+#include "wasm_sampling_profiler.h"
+#endif
 
 #if WASM_ENABLE_AOT != 0
 #include "aot_runtime.h"
@@ -113,6 +117,9 @@ fail1:
 void
 wasm_exec_env_destroy_internal(WASMExecEnv *exec_env)
 {
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+    wasm_sampling_profiler_detach_exec_env(exec_env);
+#endif
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     os_munmap(exec_env->exce_check_guard_page, os_getpagesize());
 #endif
@@ -309,6 +316,252 @@ wasm_exec_env_set_thread_arg(WASMExecEnv *exec_env, void *thread_arg)
 }
 #endif
 
+/* States of the slots of an exec_env pool */
+#define EXEC_ENV_SLOT_EMPTY 0
+#define EXEC_ENV_SLOT_IDLE 1
+#define EXEC_ENV_SLOT_BUSY 2
+
+typedef struct WASMExecEnvPoolSlot {
+    bh_atomic_32_t state;
+    /* the thread which returned the idle exec_env */
+    korp_tid owner;
+    WASMExecEnv *exec_env;
+} WASMExecEnvPoolSlot;
+
+struct WASMExecEnvPool {
+    struct WASMModuleInstanceCommon *module_inst;
+    uint32 stack_size;
+    uint32 slot_count;
+    /* check out the exec_env returned by the current thread first */
+    bool bind_thread;
+    /* the exec_envs checked out, and the peak since the last trim */
+    bh_atomic_32_t in_use;
+    bh_atomic_32_t in_use_peak;
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+    korp_mutex lock;
+#endif
+    WASMExecEnvPoolSlot slots[1];
+};
+
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+#define EXEC_ENV_POOL_LOCK(pool) os_mutex_lock(&(pool)->lock)
+#define EXEC_ENV_POOL_UNLOCK(pool) os_mutex_unlock(&(pool)->lock)
+#else
+#define EXEC_ENV_POOL_LOCK(pool) (void)0
+#define EXEC_ENV_POOL_UNLOCK(pool) (void)0
+#endif
+
+WASMExecEnvPool *
+wasm_exec_env_pool_create(struct WASMModuleInstanceCommon *module_inst,
+                          uint32 max_idle, uint32 stack_size,
+                          bool bind_thread)
+{
+    WASMExecEnvPool *pool;
+    uint64 total_size;
+
+    if (max_idle == 0)
+        return NULL;
+
+    total_size = offsetof(WASMExecEnvPool, slots)
+                 + sizeof(WASMExecEnvPoolSlot) * (uint64)max_idle;
+    if (total_size >= UINT32_MAX
+        || !(pool = wasm_runtime_malloc((uint32)total_size)))
+        return NULL;
+
+    memset(pool, 0, (uint32)total_size);
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+    if (os_mutex_init(&pool->lock) != 0) {
+        wasm_runtime_free(pool);
+        return NULL;
+    }
+#endif
+
+    pool->module_inst = module_inst;
+    pool->stack_size = stack_size;
+    pool->slot_count = max_idle;
+    pool->bind_thread = bind_thread;
+    return pool;
+}
+
+/* Take the idle exec_env of the slot, NULL if it has none */
+static WASMExecEnv *
+exec_env_pool_take(WASMExecEnvPoolSlot *slot)
+{
+    uint32 state = EXEC_ENV_SLOT_IDLE;
+    WASMExecEnv *exec_env;
+
+    if (!BH_ATOMIC_32_COMPARE_EXCHANGE(slot->state, state,
+                                       EXEC_ENV_SLOT_BUSY))
+        return NULL;
+
+    exec_env = slot->exec_env;
+    slot->exec_env = NULL;
+    BH_ATOMIC_32_STORE(slot->state, EXEC_ENV_SLOT_EMPTY);
+    return exec_env;
+}
+
+/* Put an idle exec_env into the slot, fail if the slot isn't empty */
+static bool
+exec_env_pool_put(WASMExecEnvPoolSlot *slot, WASMExecEnv *exec_env)
+{
+    uint32 state = EXEC_ENV_SLOT_EMPTY;
+
+    if (!BH_ATOMIC_32_COMPARE_EXCHANGE(slot->state, state,
+                                       EXEC_ENV_SLOT_BUSY))
+        return false;
+
+    slot->exec_env = exec_env;
+    slot->owner = os_self_thread();
+    BH_ATOMIC_32_STORE(slot->state, EXEC_ENV_SLOT_IDLE);
+    return true;
+}
+
+void
+wasm_exec_env_pool_destroy(WASMExecEnvPool *pool)
+{
+    WASMExecEnv *exec_env;
+    uint32 i;
+
+    if (!pool)
+        return;
+
+    /* the checked out exec_envs must have been returned */
+    bh_assert(BH_ATOMIC_32_LOAD(pool->in_use) == 0);
+
+    for (i = 0; i < pool->slot_count; i++) {
+        if ((exec_env = exec_env_pool_take(&pool->slots[i])))
+            wasm_exec_env_destroy(exec_env);
+    }
+
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+    os_mutex_destroy(&pool->lock);
+#endif
+    wasm_runtime_free(pool);
+}
+
+WASMExecEnv *
+wasm_exec_env_pool_checkout(WASMExecEnvPool *pool)
+{
+    WASMExecEnv *exec_env = NULL;
+    WASMExecEnvPoolSlot *slot;
+    korp_tid self;
+    uint32 i, state, in_use, peak;
+
+    EXEC_ENV_POOL_LOCK(pool);
+
+    if (pool->bind_thread) {
+        self = os_self_thread();
+        for (i = 0; i < pool->slot_count && !exec_env; i++) {
+            slot = &pool->slots[i];
+            state = EXEC_ENV_SLOT_IDLE;
+            /* lock the slot to read its owner, and unlock it if the
+               exec_env was returned by another thread */
+            if (!BH_ATOMIC_32_COMPARE_EXCHANGE(slot->state, state,
+                                               EXEC_ENV_SLOT_BUSY))
+                continue;
+            if (slot->owner != self) {
+                BH_ATOMIC_32_STORE(slot->state, EXEC_ENV_SLOT_IDLE);
+                continue;
+            }
+            exec_env = slot->exec_env;
+            slot->exec_env = NULL;
+            BH_ATOMIC_32_STORE(slot->state, EXEC_ENV_SLOT_EMPTY);
+        }
+    }
+
+    for (i = 0; i < pool->slot_count && !exec_env; i++)
+        exec_env = exec_env_pool_take(&pool->slots[i]);
+
+    in_use = BH_ATOMIC_32_FETCH_ADD(pool->in_use, 1) + 1;
+    peak = BH_ATOMIC_32_LOAD(pool->in_use_peak);
+    while (in_use > peak
+           && !BH_ATOMIC_32_COMPARE_EXCHANGE(pool->in_use_peak, peak, in_use))
+        ;
+
+    EXEC_ENV_POOL_UNLOCK(pool);
+
+    if (!exec_env
+        && !(exec_env =
+                 wasm_exec_env_create(pool->module_inst, pool->stack_size))) {
+        EXEC_ENV_POOL_LOCK(pool);
+        BH_ATOMIC_32_FETCH_SUB(pool->in_use, 1);
+        EXEC_ENV_POOL_UNLOCK(pool);
+        return NULL;
+    }
+
+    /* the exec_env may have been used by another thread, reset its thread
+       handle and native stack boundary, which are checked before they are
+       set again in the call when the hw bound check is enabled */
+    wasm_exec_env_set_thread_info(exec_env);
+    return exec_env;
+}
+
+void
+wasm_exec_env_pool_return(WASMExecEnvPool *pool, WASMExecEnv *exec_env)
+{
+    bool pooled = false;
+    uint32 i;
+
+    /* no wasm function is running with the exec_env */
+    bh_assert(exec_env->wasm_stack.top == exec_env->wasm_stack.bottom);
+
+    EXEC_ENV_POOL_LOCK(pool);
+
+    for (i = 0; i < pool->slot_count && !pooled; i++)
+        pooled = exec_env_pool_put(&pool->slots[i], exec_env);
+
+    BH_ATOMIC_32_FETCH_SUB(pool->in_use, 1);
+
+    EXEC_ENV_POOL_UNLOCK(pool);
+
+    /* the pool is full */
+    if (!pooled)
+        wasm_exec_env_destroy(exec_env);
+}
+
+uint32
+wasm_exec_env_pool_trim(WASMExecEnvPool *pool)
+{
+    WASMExecEnv *exec_envs_to_free[32], *exec_env;
+    uint32 in_use, peak, keep, kept = 0, freed = 0, count = 0, i;
+
+    EXEC_ENV_POOL_LOCK(pool);
+
+    /* keep the idle exec_envs which served the peak since the last trim,
+       and start a new period */
+    in_use = BH_ATOMIC_32_LOAD(pool->in_use);
+    peak = BH_ATOMIC_32_LOAD(pool->in_use_peak);
+    keep = peak > in_use ? peak - in_use : 0;
+    BH_ATOMIC_32_STORE(pool->in_use_peak, in_use);
+
+    for (i = 0; i < pool->slot_count; i++) {
+        if (BH_ATOMIC_32_LOAD(pool->slots[i].state) != EXEC_ENV_SLOT_IDLE)
+            continue;
+        if (kept < keep) {
+            kept++;
+            continue;
+        }
+        if ((exec_env = exec_env_pool_take(&pool->slots[i]))) {
+            exec_envs_to_free[count++] = exec_env;
+            if (count == sizeof(exec_envs_to_free) / sizeof(WASMExecEnv *)) {
+                /* destroy them outside of the lock */
+                EXEC_ENV_POOL_UNLOCK(pool);
+                while (count > 0)
+                    wasm_exec_env_destroy(exec_envs_to_free[--count]);
+                freed += sizeof(exec_envs_to_free) / sizeof(WASMExecEnv *);
+                EXEC_ENV_POOL_LOCK(pool);
+            }
+        }
+    }
+
+    EXEC_ENV_POOL_UNLOCK(pool);
+
+    freed += count;
+    while (count > 0)
+        wasm_exec_env_destroy(exec_envs_to_free[--count]);
+    return freed;
+}
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 void
 wasm_exec_env_push_jmpbuf(WASMExecEnv *exec_env, WASMJmpBuf *jmpbuf)
@@ -308,6 +308,29 @@ void
 wasm_exec_env_set_thread_arg(WASMExecEnv *exec_env, void *thread_arg);
 #endif
 
+/**
+ * A pool of idle exec_envs of a module instance, the exec_envs are checked
+ * out and returned by any thread without locks
+ */
+typedef struct WASMExecEnvPool WASMExecEnvPool;
+
+WASMExecEnvPool *
+wasm_exec_env_pool_create(struct WASMModuleInstanceCommon *module_inst,
+                          uint32 max_idle, uint32 stack_size,
+                          bool bind_thread);
+
+void
+wasm_exec_env_pool_destroy(WASMExecEnvPool *pool);
+
+WASMExecEnv *
+wasm_exec_env_pool_checkout(WASMExecEnvPool *pool);
+
+void
+wasm_exec_env_pool_return(WASMExecEnvPool *pool, WASMExecEnv *exec_env);
+
+uint32
+wasm_exec_env_pool_trim(WASMExecEnvPool *pool);
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
 void
 wasm_exec_env_push_jmpbuf(WASMExecEnv *exec_env, WASMJmpBuf *jmpbuf);
@@ -17,6 +17,10 @@
 #include "../libraries/thread-mgr/thread_manager.h"
 #endif
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+#include "wasm_runtime_metrics.h"
+#endif
+
 typedef enum Memory_Mode {
     MEMORY_MODE_UNKNOWN = 0,
     MEMORY_MODE_POOL,
@@ -148,6 +152,33 @@ static void
 wasm_munmap_linear_memory(void *mapped_mem, uint64 commit_size,
                           uint64 map_size);
 
+/*
+ * Header of the blocks allocated from a shared heap. Small blocks are
+ * carved from slabs allocated from the segment allocator and, once freed,
+ * are kept in the lock-free lists of their segment. Large blocks are
+ * allocated from and freed to the segment allocator.
+ */
+typedef struct SharedHeapBlockHead {
+    /* Changed from used to free with a compare-and-swap, so that only
+       one of the threads freeing a block concurrently succeeds */
+    bh_atomic_32_t magic;
+    /* Offset in the segment of the next block of a small list */
+    uint32 next;
+} SharedHeapBlockHead;
+
+/* Magic of the allocated blocks, or-ed with the size class */
+#define SHARED_HEAP_BLOCK_USED 0x53480000
+/* Magic of the small blocks in a free list, or-ed with the size class */
+#define SHARED_HEAP_BLOCK_FREE 0x53460000
+#define SHARED_HEAP_BLOCK_LARGE (SHARED_HEAP_BLOCK_USED | 0xFF)
+
+#define SHARED_HEAP_SMALL_BLOCK_MIN 16
+#define SHARED_HEAP_SMALL_BLOCK_MAX \
+    (SHARED_HEAP_SMALL_BLOCK_MIN << (SHARED_HEAP_SMALL_CLASS_NUM - 1))
+/* Size of the slab allocated to refill a small list, which holds
+   4 blocks at least */
+#define SHARED_HEAP_SLAB_SIZE 1024
+
 static void *
 runtime_malloc(uint64 size)
 {
@@ -162,55 +193,161 @@ runtime_malloc(uint64 size)
     return mem;
 }
 
-WASMSharedHeap *
-wasm_runtime_create_shared_heap(SharedHeapInitArgs *init_args)
+/* The range of no segment, which is cached by the module instances
+   without shared heap */
+static WASMSharedHeapRange empty_shared_heap_range = {
+    .start_off = { .u64 = UINT64_MAX },
+};
+
+static WASMSharedHeapSegment *
+create_shared_heap_segment(uint8 *base_addr, uint64 size, uint64 offset)
 {
-    uint64 heap_struct_size = sizeof(WASMSharedHeap), map_size;
-    uint32 size = init_args->size;
-    WASMSharedHeap *heap;
+    uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
+    WASMSharedHeapSegment *segment;
 
-    if (size == 0) {
-        goto fail1;
+    if (!(segment = runtime_malloc(sizeof(WASMSharedHeapSegment)))) {
+        return NULL;
     }
 
-    if (!(heap = runtime_malloc(heap_struct_size))) {
-        goto fail1;
+    if (!(segment->heap_handle = runtime_malloc(heap_struct_size))) {
+        wasm_runtime_free(segment);
+        return NULL;
     }
 
-    if (!(heap->heap_handle =
-              runtime_malloc(mem_allocator_get_heap_struct_size()))) {
-        goto fail2;
+    if (!mem_allocator_create_with_struct_and_pool(
+            segment->heap_handle, heap_struct_size, base_addr, (uint32)size)) {
+        LOG_WARNING("init share heap failed");
+        wasm_runtime_free(segment->heap_handle);
+        wasm_runtime_free(segment);
+        return NULL;
     }
 
-    size = align_uint(size, os_getpagesize());
-    heap->size = size;
-    heap->start_off_mem64 = UINT64_MAX - heap->size + 1;
-    heap->start_off_mem32 = UINT32_MAX - heap->size + 1;
-
-    if (size > APP_HEAP_SIZE_MAX || size < APP_HEAP_SIZE_MIN) {
-        LOG_WARNING("Invalid size of shared heap");
-        goto fail3;
-    }
+    segment->base_addr = base_addr;
+    segment->size = size;
+    segment->offset = offset;
+    return segment;
+}
 
+static uint64
+get_shared_heap_map_size(WASMSharedHeap *heap)
+{
 #ifndef OS_ENABLE_HW_BOUND_CHECK
-    map_size = size;
+    /* The platform may not reserve address space lazily, e.g. os_mmap
+       allocates from the heap on ESP-IDF, so only the first segment is
+       mapped and the others are allocated when the heap grows */
+    return heap->segment_size;
 #else
     /* Totally 8G is mapped, the opcode load/store address range is 0 to 8G:
      *   ea = i + memarg.offset
      * both i and memarg.offset are u32 in range 0 to 4G
      * so the range of ea is 0 to 8G
      */
-    map_size = 8 * (uint64)BH_GB;
+    (void)heap;
+    return 8 * (uint64)BH_GB;
+#endif
+}
+
+static void
+set_shared_heap_range(WASMSharedHeapRange *range,
+                      WASMSharedHeapSegment *segment, uint64 start_off)
+{
+    uint64 end_off = start_off + segment->size - 1;
+
+#if UINTPTR_MAX == UINT64_MAX
+    range->start_off.u64 = start_off;
+    range->end_off.u64 = end_off;
+#else
+    range->start_off.u32[0] = (uint32)start_off;
+    range->end_off.u32[0] = (uint32)end_off;
 #endif
+    range->base_addr_adj = segment->base_addr - start_off;
+}
+
+/* Set the ranges of a segment from the place of its heap, which is only
+   done before the segment is visible or while the heap isn't attached */
+static void
+set_shared_heap_segment_ranges(WASMSharedHeap *heap,
+                               WASMSharedHeapSegment *segment)
+{
+    set_shared_heap_range(&segment->range_mem32, segment,
+                          heap->start_off_mem32 + segment->offset);
+    set_shared_heap_range(&segment->range_mem64, segment,
+                          heap->start_off_mem64 + segment->offset);
+}
+
+/* Place the heaps of a chain from the top of the address space downwards */
+static void
+layout_shared_heap_chain(WASMSharedHeap *head)
+{
+    WASMSharedHeap *heap;
+    WASMSharedHeapSegment *segment;
+    uint64 end_off_mem64 = UINT64_MAX, end_off_mem32 = UINT32_MAX;
+
+    for (heap = head; heap; heap = heap->chain_next) {
+        heap->start_off_mem64 = end_off_mem64 - heap->size + 1;
+        heap->start_off_mem32 = end_off_mem32 - heap->size + 1;
+        end_off_mem64 = heap->start_off_mem64 - 1;
+        end_off_mem32 = heap->start_off_mem32 - 1;
+        for (segment = heap->segments; segment; segment = segment->next) {
+            set_shared_heap_segment_ranges(heap, segment);
+        }
+    }
+}
 
+WASMSharedHeapRange *
+wasm_runtime_get_empty_shared_heap_range(void)
+{
+    return &empty_shared_heap_range;
+}
+
+WASMSharedHeap *
+wasm_runtime_create_shared_heap(SharedHeapInitArgs *init_args)
+{
+    uint64 heap_struct_size = sizeof(WASMSharedHeap), map_size;
+    uint64 size, max_size;
+    uint32 page_size = os_getpagesize();
+    WASMSharedHeap *heap;
+
+    if (init_args->size == 0) {
+        goto fail1;
+    }
+
+    size = align_as_and_cast(init_args->size, page_size);
+    max_size = align_as_and_cast(init_args->max_size, page_size);
+    if (max_size < size) {
+        max_size = size;
+    }
+
+    /* Leave the page 0 of the address space to the linear memory */
+    if (size > APP_HEAP_SIZE_MAX || size < APP_HEAP_SIZE_MIN
+        || max_size > (uint64)UINT32_MAX - page_size + 1) {
+        LOG_WARNING("Invalid size of shared heap");
+        goto fail1;
+    }
+
+    if (!(heap = runtime_malloc(heap_struct_size))) {
+        goto fail1;
+    }
+
+    heap->size = max_size;
+    heap->segment_size = size;
+    BH_ATOMIC_64_STORE(heap->committed_size, size);
+
+    if (os_mutex_init(&heap->lock) != 0) {
+        goto fail2;
+    }
+
+    /* Map the range and only commit the first segment */
+    map_size = get_shared_heap_map_size(heap);
     if (!(heap->base_addr = wasm_mmap_linear_memory(map_size, size))) {
         goto fail3;
     }
-    if (!mem_allocator_create_with_struct_and_pool(
-            heap->heap_handle, heap_struct_size, heap->base_addr, size)) {
-        LOG_WARNING("init share heap failed");
+
+    if (!(heap->segments =
+              create_shared_heap_segment(heap->base_addr, size, 0))) {
         goto fail4;
     }
+    layout_shared_heap_chain(heap);
 
     os_mutex_lock(&shared_heap_list_lock);
     if (shared_heap_list == NULL) {
@@ -226,84 +363,236 @@ wasm_runtime_create_shared_heap(SharedHeapInitArgs *init_args)
 fail4:
     wasm_munmap_linear_memory(heap->base_addr, size, map_size);
 fail3:
-    wasm_runtime_free(heap->heap_handle);
+    os_mutex_destroy(&heap->lock);
 fail2:
     wasm_runtime_free(heap);
 fail1:
     return NULL;
 }
 
-bool
-wasm_runtime_attach_shared_heap_internal(WASMModuleInstanceCommon *module_inst,
-                                         WASMSharedHeap *shared_heap)
+WASMSharedHeap *
+wasm_runtime_chain_shared_heaps(WASMSharedHeap *head, WASMSharedHeap *body)
 {
-    WASMMemoryInstance *memory =
-        wasm_get_default_memory((WASMModuleInstance *)module_inst);
-    uint64 linear_mem_size;
+    WASMSharedHeap *heap, *ret = NULL;
+    uint64 total_size = head ? head->size : 0;
 
-    if (!memory)
-        return false;
+    if (!head || !body || head == body) {
+        LOG_WARNING("Invalid shared heaps to chain");
+        return NULL;
+    }
+
+    os_mutex_lock(&shared_heap_list_lock);
 
-    linear_mem_size = memory->memory_data_size;
+    if (head->chained || head->chain_next || body->chained) {
+        LOG_WARNING("The shared heap is already in a chain");
+        goto unlock;
+    }
+    if (head->attached_count > 0 || body->attached_count > 0) {
+        LOG_WARNING("The shared heap is attached to a module instance");
+        goto unlock;
+    }
 
-    /* check if linear memory and shared heap are overlapped */
-    if ((memory->is_memory64 && linear_mem_size > shared_heap->start_off_mem64)
-        || (!memory->is_memory64
-            && linear_mem_size > shared_heap->start_off_mem32)) {
-        LOG_WARNING("Linear memory address is overlapped with shared heap");
-        return false;
+    for (heap = body; heap; heap = heap->chain_next) {
+        total_size += heap->size;
+    }
+    /* Leave the page 0 of the address space to the linear memory */
+    if (total_size > (uint64)UINT32_MAX - os_getpagesize() + 1) {
+        LOG_WARNING("The shared heaps to chain are too large");
+        goto unlock;
     }
 
-#if WASM_ENABLE_INTERP != 0
+    head->chain_next = body;
+    body->chained = true;
+    layout_shared_heap_chain(head);
+    ret = head;
+
+unlock:
+    os_mutex_unlock(&shared_heap_list_lock);
+    return ret;
+}
+
+WASMSharedHeap *
+wasm_runtime_unchain_shared_heaps(WASMSharedHeap *head, bool entire_chain)
+{
+    WASMSharedHeap *heap, *next, *ret = NULL;
+
+    if (!head) {
+        return NULL;
+    }
+
+    os_mutex_lock(&shared_heap_list_lock);
+
+    if (head->chained || !head->chain_next) {
+        LOG_WARNING("The shared heap isn't the head of a chain");
+        goto unlock;
+    }
+    if (head->attached_count > 0) {
+        LOG_WARNING("The shared heap is attached to a module instance");
+        goto unlock;
+    }
+
+    if (entire_chain) {
+        for (heap = head; heap; heap = next) {
+            next = heap->chain_next;
+            heap->chain_next = NULL;
+            heap->chained = false;
+            layout_shared_heap_chain(heap);
+        }
+    }
+    else {
+        ret = head->chain_next;
+        head->chain_next = NULL;
+        ret->chained = false;
+        layout_shared_heap_chain(head);
+        layout_shared_heap_chain(ret);
+    }
+
+unlock:
+    os_mutex_unlock(&shared_heap_list_lock);
+    return ret;
+}
+
+static inline uint64
+get_shared_heap_start_off(WASMSharedHeap *heap, bool is_memory64)
+{
+    return is_memory64 ? heap->start_off_mem64 : heap->start_off_mem32;
+}
+
+uint64
+wasm_runtime_get_shared_heap_chain_start_off(WASMSharedHeap *head,
+                                             bool is_memory64)
+{
+    WASMSharedHeap *heap = head;
+
+    while (heap->chain_next) {
+        heap = heap->chain_next;
+    }
+    return get_shared_heap_start_off(heap, is_memory64);
+}
+
+/* Get the fields of the module instance which the jit/aot code checks
+   for the shared heap */
+static void
+get_shared_heap_cache(WASMModuleInstanceCommon *module_inst,
+                      MemBound **p_chain_start_off,
+                      WASMSharedHeapRange ***p_cur_range)
+{
+    *p_chain_start_off = NULL;
+    *p_cur_range = NULL;
+
+#if WASM_ENABLE_INTERP != 0 && WASM_ENABLE_JIT != 0
     if (module_inst->module_type == Wasm_Module_Bytecode) {
         WASMModuleInstanceExtra *e =
             (WASMModuleInstanceExtra *)((WASMModuleInstance *)module_inst)->e;
-        if (e->shared_heap) {
-            LOG_WARNING("A shared heap is already attached");
-            return false;
-        }
-        e->shared_heap = shared_heap;
-#if WASM_ENABLE_JIT != 0
+        *p_chain_start_off = &e->shared_heap_start_off;
+        *p_cur_range = &e->shared_heap_cur_range;
+    }
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        AOTModuleInstanceExtra *e =
+            (AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)->e;
+        *p_chain_start_off = &e->shared_heap_start_off;
+        *p_cur_range = &e->shared_heap_cur_range;
+    }
+#endif
+}
+
+/* Set the range of the segment accessed last, which the module instance
+   refers to, it is a single pointer store so that the threads running
+   the instance never see the fields of two ranges mixed */
+static void
+set_shared_heap_cur_range(WASMModuleInstanceCommon *module_inst,
+                          WASMSharedHeapRange *range)
+{
+    MemBound *p_chain_start_off;
+    WASMSharedHeapRange **p_cur_range;
+
+    get_shared_heap_cache(module_inst, &p_chain_start_off, &p_cur_range);
+    if (p_cur_range) {
+        *(WASMSharedHeapRange *volatile *)p_cur_range = range;
+    }
+}
+
+/* Set the lowest offset of the attached chain, UINTPTR_MAX if no shared
+   heap is attached, and reset the range of the segment accessed last */
+static void
+set_shared_heap_chain_start_off(WASMModuleInstanceCommon *module_inst,
+                                uint64 chain_start_off)
+{
+    MemBound *p_chain_start_off;
+    WASMSharedHeapRange **p_cur_range;
+
+    get_shared_heap_cache(module_inst, &p_chain_start_off, &p_cur_range);
+    if (!p_chain_start_off) {
+        return;
+    }
+
 #if UINTPTR_MAX == UINT64_MAX
-        if (memory->is_memory64)
-            e->shared_heap_start_off.u64 = shared_heap->start_off_mem64;
-        else
-            e->shared_heap_start_off.u64 = shared_heap->start_off_mem32;
-        e->shared_heap_base_addr_adj =
-            shared_heap->base_addr - e->shared_heap_start_off.u64;
+    p_chain_start_off->u64 = chain_start_off;
 #else
-        e->shared_heap_start_off.u32[0] = (uint32)shared_heap->start_off_mem32;
-        e->shared_heap_base_addr_adj =
-            shared_heap->base_addr - e->shared_heap_start_off.u32[0];
+    p_chain_start_off->u32[0] = (uint32)chain_start_off;
 #endif
-#endif /* end of WASM_ENABLE_JIT != 0 */
+    *p_cur_range = &empty_shared_heap_range;
+}
+
+bool
+wasm_runtime_attach_shared_heap_internal(WASMModuleInstanceCommon *module_inst,
+                                         WASMSharedHeap *shared_heap)
+{
+    WASMMemoryInstance *memory =
+        wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    WASMSharedHeap **p_shared_heap = NULL;
+    uint64 chain_start_off;
+    bool ret = false;
+
+    if (!memory)
+        return false;
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        p_shared_heap = &((WASMModuleInstance *)module_inst)->e->shared_heap;
     }
-#endif /* end of WASM_ENABLE_INTERP != 0 */
+#endif
 #if WASM_ENABLE_AOT != 0
     if (module_inst->module_type == Wasm_Module_AoT) {
         AOTModuleInstanceExtra *e =
             (AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)->e;
-        if (e->shared_heap) {
-            LOG_WARNING("A shared heap is already attached");
-            return false;
-        }
-        e->shared_heap = shared_heap;
-#if UINTPTR_MAX == UINT64_MAX
-        if (memory->is_memory64)
-            e->shared_heap_start_off.u64 = shared_heap->start_off_mem64;
-        else
-            e->shared_heap_start_off.u64 = shared_heap->start_off_mem32;
-        e->shared_heap_base_addr_adj =
-            shared_heap->base_addr - e->shared_heap_start_off.u64;
-#else
-        e->shared_heap_start_off.u32[0] = (uint32)shared_heap->start_off_mem32;
-        e->shared_heap_base_addr_adj =
-            shared_heap->base_addr - e->shared_heap_start_off.u32[0];
+        p_shared_heap = &e->shared_heap;
+    }
 #endif
+    if (!p_shared_heap) {
+        return false;
     }
-#endif /* end of WASM_ENABLE_AOT != 0 */
 
-    return true;
+    os_mutex_lock(&shared_heap_list_lock);
+
+    if (*p_shared_heap) {
+        LOG_WARNING("A shared heap is already attached");
+        goto unlock;
+    }
+    if (shared_heap->chained) {
+        LOG_WARNING("Only the head of a shared heap chain can be attached");
+        goto unlock;
+    }
+
+    chain_start_off = wasm_runtime_get_shared_heap_chain_start_off(
+        shared_heap, memory->is_memory64);
+
+    /* check if linear memory and shared heap are overlapped */
+    if (memory->memory_data_size > chain_start_off) {
+        LOG_WARNING("Linear memory address is overlapped with shared heap");
+        goto unlock;
+    }
+
+    *p_shared_heap = shared_heap;
+    shared_heap->attached_count++;
+    set_shared_heap_chain_start_off(module_inst, chain_start_off);
+    ret = true;
+
+unlock:
+    os_mutex_unlock(&shared_heap_list_lock);
+    return ret;
 }
 
 bool
@@ -320,34 +609,32 @@ wasm_runtime_attach_shared_heap(WASMModuleInstanceCommon *module_inst,
 void
 wasm_runtime_detach_shared_heap_internal(WASMModuleInstanceCommon *module_inst)
 {
+    WASMSharedHeap **p_shared_heap = NULL;
+
 #if WASM_ENABLE_INTERP != 0
     if (module_inst->module_type == Wasm_Module_Bytecode) {
-        WASMModuleInstanceExtra *e =
-            (WASMModuleInstanceExtra *)((WASMModuleInstance *)module_inst)->e;
-        e->shared_heap = NULL;
-#if WASM_ENABLE_JIT != 0
-#if UINTPTR_MAX == UINT64_MAX
-        e->shared_heap_start_off.u64 = UINT64_MAX;
-#else
-        e->shared_heap_start_off.u32[0] = UINT32_MAX;
-#endif
-        e->shared_heap_base_addr_adj = NULL;
-#endif
+        p_shared_heap = &((WASMModuleInstance *)module_inst)->e->shared_heap;
     }
-#endif /* end of WASM_ENABLE_INTERP != 0 */
+#endif
 #if WASM_ENABLE_AOT != 0
     if (module_inst->module_type == Wasm_Module_AoT) {
         AOTModuleInstanceExtra *e =
             (AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)->e;
-        e->shared_heap = NULL;
-#if UINTPTR_MAX == UINT64_MAX
-        e->shared_heap_start_off.u64 = UINT64_MAX;
-#else
-        e->shared_heap_start_off.u32[0] = UINT32_MAX;
+        p_shared_heap = &e->shared_heap;
+    }
 #endif
-        e->shared_heap_base_addr_adj = NULL;
+    if (!p_shared_heap) {
+        return;
     }
-#endif /* end of WASM_ENABLE_AOT != 0 */
+
+    os_mutex_lock(&shared_heap_list_lock);
+    if (*p_shared_heap) {
+        bh_assert((*p_shared_heap)->attached_count > 0);
+        (*p_shared_heap)->attached_count--;
+        *p_shared_heap = NULL;
+    }
+    set_shared_heap_chain_start_off(module_inst, UINTPTR_MAX);
+    os_mutex_unlock(&shared_heap_list_lock);
 }
 
 void
@@ -385,66 +672,440 @@ wasm_runtime_get_shared_heap(WASMModuleInstanceCommon *module_inst_comm)
     return get_shared_heap(module_inst_comm);
 }
 
-static bool
-is_app_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
-                           bool is_memory64, uint64 app_offset, uint32 bytes)
+static inline WASMSharedHeapRange *
+get_shared_heap_segment_range(WASMSharedHeapSegment *segment,
+                              bool is_memory64)
 {
-    WASMSharedHeap *heap = get_shared_heap(module_inst);
+    return is_memory64 ? &segment->range_mem64 : &segment->range_mem32;
+}
 
-    if (!heap) {
-        return false;
-    }
+/*
+ * Find the segment of the heaps of the chain attached to the module
+ * instance which contains [app_offset, app_offset + bytes - 1], and return
+ * its heap and its offset range in [*p_start_off, *p_end_off]
+ */
+static WASMSharedHeapSegment *
+find_shared_heap_segment_by_app_addr(WASMModuleInstanceCommon *module_inst,
+                                     bool is_memory64, uint64 app_offset,
+                                     uint64 bytes, WASMSharedHeap **p_heap,
+                                     uint64 *p_start_off, uint64 *p_end_off)
+{
+    WASMSharedHeap *heap = get_shared_heap(module_inst);
+    WASMSharedHeapSegment *segment;
+    uint64 heap_start_off, start_off, end_off;
 
     if (bytes == 0) {
         bytes = 1;
     }
 
-    if (!is_memory64) {
-        if (app_offset >= heap->start_off_mem32
-            && app_offset <= UINT32_MAX - bytes + 1) {
-            return true;
+    for (; heap; heap = heap->chain_next) {
+        heap_start_off = get_shared_heap_start_off(heap, is_memory64);
+        if (app_offset < heap_start_off
+            || app_offset - heap_start_off >= heap->size) {
+            continue;
+        }
+        /* The heaps don't overlap, the range can only be in this one */
+        for (segment = heap->segments; segment; segment = segment->next) {
+            start_off = heap_start_off + segment->offset;
+            end_off = start_off + segment->size - 1;
+            if (app_offset >= start_off && app_offset <= end_off
+                && bytes - 1 <= end_off - app_offset) {
+                if (p_heap)
+                    *p_heap = heap;
+                if (p_start_off)
+                    *p_start_off = start_off;
+                if (p_end_off)
+                    *p_end_off = end_off;
+                return segment;
+            }
         }
+        break;
     }
-    else {
-        if (app_offset >= heap->start_off_mem64
-            && app_offset <= UINT64_MAX - bytes + 1) {
-            return true;
+
+    return NULL;
+}
+
+/* Get the segment of heap which contains [addr, addr + bytes - 1] */
+static WASMSharedHeapSegment *
+get_shared_heap_segment(WASMSharedHeap *heap, uint8 *addr, uint64 bytes)
+{
+    WASMSharedHeapSegment *segment;
+    uintptr_t base_addr, addr_int = (uintptr_t)addr, end_addr;
+
+    end_addr = addr_int + bytes;
+    /* Check for overflow */
+    if (end_addr <= addr_int) {
+        return NULL;
+    }
+
+    for (segment = heap->segments; segment; segment = segment->next) {
+        base_addr = (uintptr_t)segment->base_addr;
+        if (addr_int >= base_addr && end_addr <= base_addr + segment->size) {
+            return segment;
         }
     }
 
-    return false;
+    return NULL;
 }
 
-static bool
-is_native_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
-                              uint8 *addr, uint32 bytes)
+static WASMSharedHeapSegment *
+find_shared_heap_segment_by_native_addr(WASMModuleInstanceCommon *module_inst,
+                                        uint8 *addr, uint64 bytes,
+                                        WASMSharedHeap **p_heap)
 {
     WASMSharedHeap *heap = get_shared_heap(module_inst);
-    uintptr_t base_addr;
-    uintptr_t addr_int;
-    uintptr_t end_addr;
+    WASMSharedHeapSegment *segment;
 
-    if (!heap) {
-        return false;
+    for (; heap; heap = heap->chain_next) {
+        if ((segment = get_shared_heap_segment(heap, addr, bytes))) {
+            if (p_heap)
+                *p_heap = heap;
+            return segment;
+        }
     }
 
-    base_addr = (uintptr_t)heap->base_addr;
-    addr_int = (uintptr_t)addr;
-    if (addr_int < base_addr) {
+    return NULL;
+}
+
+static bool
+is_app_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
+                           bool is_memory64, uint64 app_offset, uint64 bytes)
+{
+    return find_shared_heap_segment_by_app_addr(module_inst, is_memory64,
+                                                app_offset, bytes, NULL, NULL,
+                                                NULL)
+               ? true
+               : false;
+}
+
+bool
+wasm_runtime_is_native_addr_in_shared_heap(
+    WASMModuleInstanceCommon *module_inst, uint8 *addr, uint64 bytes)
+{
+    return find_shared_heap_segment_by_native_addr(module_inst, addr, bytes,
+                                                   NULL)
+               ? true
+               : false;
+}
+
+bool
+wasm_runtime_shared_heap_lookup(WASMModuleInstanceCommon *module_inst,
+                                bool is_memory64, uint64 app_offset,
+                                uint64 bytes, uint64 *p_start_off,
+                                uint64 *p_end_off, uint8 **p_base_addr)
+{
+    WASMSharedHeapSegment *segment = find_shared_heap_segment_by_app_addr(
+        module_inst, is_memory64, app_offset, bytes, NULL, p_start_off,
+        p_end_off);
+
+    if (!segment) {
         return false;
     }
 
-    end_addr = addr_int + bytes;
-    /* Check for overflow */
-    if (end_addr <= addr_int) {
-        return false;
+    *p_base_addr = segment->base_addr;
+    return true;
+}
+
+WASMSharedHeapRange *
+wasm_runtime_update_last_used_shared_heap(WASMModuleInstanceCommon *module_inst,
+                                          uint64 app_offset, uint64 bytes)
+{
+    WASMMemoryInstance *memory =
+        wasm_get_default_memory((WASMModuleInstance *)module_inst);
+    WASMSharedHeapSegment *segment;
+    WASMSharedHeapRange *range;
+
+    if (!memory
+        || !(segment = find_shared_heap_segment_by_app_addr(
+                 module_inst, memory->is_memory64, app_offset, bytes, NULL,
+                 NULL, NULL))) {
+        return NULL;
     }
 
-    if (end_addr > base_addr + heap->size) {
-        return false;
+    range = get_shared_heap_segment_range(segment, memory->is_memory64);
+    set_shared_heap_cur_range(module_inst, range);
+    return range;
+}
+
+/* Get the size class of an allocation, SHARED_HEAP_SMALL_CLASS_NUM if it
+   is a large one */
+static uint32
+get_small_class(uint64 size)
+{
+    uint64 block_size = size + sizeof(SharedHeapBlockHead);
+    uint32 cls = 0;
+
+    if (block_size > SHARED_HEAP_SMALL_BLOCK_MAX) {
+        return SHARED_HEAP_SMALL_CLASS_NUM;
+    }
+    while ((uint64)(SHARED_HEAP_SMALL_BLOCK_MIN << cls) < block_size) {
+        cls++;
     }
+    return cls;
+}
 
-    return true;
+static inline bool
+is_small_block_offset_valid(WASMSharedHeapSegment *segment, uint32 offset,
+                            uint32 cls)
+{
+    return (offset & (sizeof(uint64) - 1)) == 0
+           && (uint64)offset + (SHARED_HEAP_SMALL_BLOCK_MIN << cls)
+                  <= segment->size;
+}
+
+/*
+ * The small lists are Treiber stacks, the tag in the high 32 bits of the
+ * list head is increased on every update so that a stale head can't be
+ * swapped in. The blocks are never returned to the segment allocator and
+ * the segments are never unmapped, so reading the next field of a block
+ * popped by another thread is safe. If 64-bit atomics are emulated, the
+ * lists are protected by the heap lock instead.
+ */
+static SharedHeapBlockHead *
+small_list_pop(WASMSharedHeap *heap, WASMSharedHeapSegment *segment,
+               uint32 cls)
+{
+    SharedHeapBlockHead *block = NULL;
+    uint64 old_head, new_head;
+    uint32 offset;
+
+#if BH_ATOMIC_64_IS_ATOMIC == 0
+    os_mutex_lock(&heap->lock);
+#else
+    (void)heap;
+#endif
+
+    old_head = BH_ATOMIC_64_LOAD(segment->small_lists[cls]);
+    for (;;) {
+        if (!(offset = (uint32)old_head)) {
+            block = NULL;
+            break;
+        }
+        new_head = ((old_head >> 32) + 1) << 32;
+        if (!is_small_block_offset_valid(segment, offset, cls)) {
+            /* The list was overwritten by the wasm app, drop it */
+            LOG_WARNING("The shared heap free list is corrupted");
+            block = NULL;
+            if (BH_ATOMIC_64_COMPARE_EXCHANGE(segment->small_lists[cls],
+                                              old_head, new_head))
+                break;
+            continue;
+        }
+        block = (SharedHeapBlockHead *)(segment->base_addr + offset);
+        new_head |= *(volatile uint32 *)&block->next;
+        if (BH_ATOMIC_64_COMPARE_EXCHANGE(segment->small_lists[cls], old_head,
+                                          new_head))
+            break;
+    }
+
+#if BH_ATOMIC_64_IS_ATOMIC == 0
+    os_mutex_unlock(&heap->lock);
+#endif
+
+    if (block) {
+        block->magic = SHARED_HEAP_BLOCK_USED | cls;
+    }
+    return block;
+}
+
+/* Push the blocks linked from first to last to a small list */
+static void
+small_list_push(WASMSharedHeap *heap, WASMSharedHeapSegment *segment,
+                uint32 cls, SharedHeapBlockHead *first,
+                SharedHeapBlockHead *last)
+{
+    uint32 offset = (uint32)((uint8 *)first - segment->base_addr);
+    uint64 old_head, new_head;
+
+#if BH_ATOMIC_64_IS_ATOMIC == 0
+    os_mutex_lock(&heap->lock);
+#else
+    (void)heap;
+#endif
+
+    old_head = BH_ATOMIC_64_LOAD(segment->small_lists[cls]);
+    do {
+        last->next = (uint32)old_head;
+        new_head = (old_head >> 32) + 1;
+        new_head = (new_head << 32) | offset;
+    } while (!BH_ATOMIC_64_COMPARE_EXCHANGE(segment->small_lists[cls],
+                                            old_head, new_head));
+
+#if BH_ATOMIC_64_IS_ATOMIC == 0
+    os_mutex_unlock(&heap->lock);
+#endif
+}
+
+/* Allocate a block from the segment allocator, a small one is carved
+   from a new slab whose other blocks refill the small list */
+static SharedHeapBlockHead *
+segment_alloc(WASMSharedHeap *heap, WASMSharedHeapSegment *segment, uint32 cls,
+              uint64 size)
+{
+    SharedHeapBlockHead *block, *cur = NULL;
+    uint32 block_size, count, i;
+
+    if (cls == SHARED_HEAP_SMALL_CLASS_NUM) {
+        if ((block = mem_allocator_malloc(
+                 segment->heap_handle,
+                 (uint32)(size + sizeof(SharedHeapBlockHead))))) {
+            block->magic = SHARED_HEAP_BLOCK_LARGE;
+        }
+        return block;
+    }
+
+    block_size = SHARED_HEAP_SMALL_BLOCK_MIN << cls;
+    count = SHARED_HEAP_SLAB_SIZE / block_size;
+    if (count < 4) {
+        count = 4;
+    }
+
+    if (!(block = mem_allocator_malloc(segment->heap_handle,
+                                       block_size * count))) {
+        /* No room for a slab, allocate a single block */
+        count = 1;
+        if (!(block =
+                  mem_allocator_malloc(segment->heap_handle, block_size))) {
+            return NULL;
+        }
+    }
+
+    for (i = 1; i < count; i++) {
+        cur = (SharedHeapBlockHead *)((uint8 *)block + block_size * i);
+        cur->magic = SHARED_HEAP_BLOCK_FREE | cls;
+        cur->next = (uint32)((uint8 *)cur + block_size - segment->base_addr);
+    }
+    if (count > 1) {
+        small_list_push(heap, segment, cls,
+                        (SharedHeapBlockHead *)((uint8 *)block + block_size),
+                        cur);
+    }
+
+    block->magic = SHARED_HEAP_BLOCK_USED | cls;
+    return block;
+}
+
+/*
+ * Commit a new segment after the last one, which can hold a block of
+ * block_size bytes, and return it. If another thread has grown the heap
+ * since its committed size was committed_size_old, return the segment it
+ * added instead.
+ */
+static WASMSharedHeapSegment *
+grow_shared_heap(WASMSharedHeap *heap, uint64 committed_size_old,
+                 uint64 block_size)
+{
+    WASMSharedHeapSegment *segment = NULL, *last;
+    uint32 page_size = os_getpagesize();
+    uint64 committed_size, segment_size, min_size;
+    uint8 *segment_addr;
+
+    os_mutex_lock(&heap->lock);
+
+    for (last = heap->segments; last->next; last = last->next)
+        ;
+
+    committed_size = BH_ATOMIC_64_LOAD(heap->committed_size);
+    if (committed_size != committed_size_old) {
+        segment = last;
+        goto unlock;
+    }
+
+    /* Leave a page for the allocator's own headers */
+    min_size = align_as_and_cast(block_size + page_size, page_size);
+    segment_size = heap->segment_size;
+    if (segment_size < min_size) {
+        segment_size = min_size;
+    }
+    if (segment_size > APP_HEAP_SIZE_MAX) {
+        segment_size = APP_HEAP_SIZE_MAX;
+    }
+    if (segment_size > heap->size - committed_size) {
+        segment_size = heap->size - committed_size;
+    }
+    if (segment_size < min_size) {
+        goto unlock;
+    }
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+    /* Commit the segment in the reserved range */
+    segment_addr = heap->base_addr + committed_size;
+#ifdef BH_PLATFORM_WINDOWS
+    if (!os_mem_commit(segment_addr, segment_size,
+                       MMAP_PROT_READ | MMAP_PROT_WRITE)) {
+        goto unlock;
+    }
+#endif
+    if (os_mprotect(segment_addr, segment_size,
+                    MMAP_PROT_READ | MMAP_PROT_WRITE)
+        != 0) {
+        goto unlock;
+    }
+#else
+    if (!(segment_addr =
+              wasm_mmap_linear_memory(segment_size, segment_size))) {
+        goto unlock;
+    }
+#endif
+
+    if (!(segment = create_shared_heap_segment(segment_addr, segment_size,
+                                               committed_size))) {
+#ifndef OS_ENABLE_HW_BOUND_CHECK
+        wasm_munmap_linear_memory(segment_addr, segment_size, segment_size);
+#endif
+        goto unlock;
+    }
+    set_shared_heap_segment_ranges(heap, segment);
+
+    /* Make the segment visible to the lock-free readers after it is
+       initialized */
+    os_atomic_thread_fence(os_memory_order_release);
+    last->next = segment;
+    BH_ATOMIC_64_STORE(heap->committed_size, committed_size + segment_size);
+
+unlock:
+    os_mutex_unlock(&heap->lock);
+    return segment;
+}
+
+/*
+ * Allocate a block from a heap of the chain, pass 0 only pops the small
+ * lists, pass 1 allocates from the segment allocators and pass 2 grows
+ * the heap
+ */
+static SharedHeapBlockHead *
+shared_heap_alloc(WASMSharedHeap *heap, uint32 cls, uint64 size, uint32 pass)
+{
+    WASMSharedHeapSegment *segment;
+    SharedHeapBlockHead *block = NULL;
+    uint64 committed_size, block_size;
+    uint32 i;
+
+    if (pass < 2) {
+        for (segment = heap->segments; segment; segment = segment->next) {
+            if (pass == 0 && cls < SHARED_HEAP_SMALL_CLASS_NUM)
+                block = small_list_pop(heap, segment, cls);
+            else if (pass == 1)
+                block = segment_alloc(heap, segment, cls, size);
+            if (block)
+                return block;
+        }
+        return NULL;
+    }
+
+    block_size = cls < SHARED_HEAP_SMALL_CLASS_NUM
+                     ? (uint64)SHARED_HEAP_SMALL_BLOCK_MIN << cls
+                     : size + sizeof(SharedHeapBlockHead);
+    /* Retry a few times if the other threads consume the new segments */
+    for (i = 0; i < 4; i++) {
+        committed_size = BH_ATOMIC_64_LOAD(heap->committed_size);
+        if (committed_size >= heap->size
+            || !(segment = grow_shared_heap(heap, committed_size, block_size)))
+            break;
+        if ((block = segment_alloc(heap, segment, cls, size)))
+            break;
+    }
+    return block;
 }
 
 uint64
@@ -453,26 +1114,132 @@ wasm_runtime_shared_heap_malloc(WASMModuleInstanceCommon *module_inst,
 {
     WASMMemoryInstance *memory =
         wasm_get_default_memory((WASMModuleInstance *)module_inst);
-    WASMSharedHeap *shared_heap = get_shared_heap(module_inst);
-    void *native_addr = NULL;
+    WASMSharedHeap *shared_heap = get_shared_heap(module_inst), *heap = NULL;
+    WASMSharedHeapSegment *segment = NULL;
+    SharedHeapBlockHead *block = NULL;
+    uint8 *native_addr;
+    uint32 cls, pass;
 
-    if (!memory || !shared_heap)
+    if (!memory || !shared_heap || size > APP_HEAP_SIZE_MAX)
         return 0;
 
-    native_addr = mem_allocator_malloc(shared_heap->heap_handle, size);
-    if (!native_addr)
+    cls = get_small_class(size);
+
+    /* Try the freed blocks, the free space and then the growth of the
+       heaps, each one in the chain order */
+    for (pass = 0; pass < 3 && !block; pass++) {
+        for (heap = shared_heap; heap && !block; heap = heap->chain_next) {
+            block = shared_heap_alloc(heap, cls, size, pass);
+        }
+    }
+    if (!block)
         return 0;
 
+    /* heap has been moved to the next one of the chain */
+    for (heap = shared_heap; heap; heap = heap->chain_next) {
+        if ((segment = get_shared_heap_segment(heap, (uint8 *)block, 1)))
+            break;
+    }
+    bh_assert(segment);
+
+    native_addr = (uint8 *)(block + 1);
     if (p_native_addr) {
         *p_native_addr = native_addr;
     }
 
-    if (memory->is_memory64)
-        return shared_heap->start_off_mem64
-               + ((uint8 *)native_addr - shared_heap->base_addr);
-    else
-        return shared_heap->start_off_mem32
-               + ((uint8 *)native_addr - shared_heap->base_addr);
+    return get_shared_heap_start_off(heap, memory->is_memory64)
+           + segment->offset + (native_addr - segment->base_addr);
+}
+
+/* Get the segment and the header of the block allocated from heap whose
+   memory starts at addr, return false if addr isn't such a block */
+static bool
+get_shared_heap_block(WASMSharedHeap *heap, uint8 *addr,
+                      WASMSharedHeapSegment **p_segment,
+                      SharedHeapBlockHead **p_block, uint32 *p_magic)
+{
+    WASMSharedHeapSegment *segment;
+    SharedHeapBlockHead *block;
+    uint32 magic, cls;
+
+    for (segment = heap->segments; segment; segment = segment->next) {
+        if (addr >= segment->base_addr + sizeof(SharedHeapBlockHead)
+            && addr < segment->base_addr + segment->size)
+            break;
+    }
+    if (!segment || ((uintptr_t)addr & (sizeof(uint64) - 1))) {
+        return false;
+    }
+
+    block = (SharedHeapBlockHead *)addr - 1;
+    magic = BH_ATOMIC_32_LOAD(block->magic);
+    cls = magic & 0xFF;
+    if (magic != SHARED_HEAP_BLOCK_LARGE
+        && (magic != (SHARED_HEAP_BLOCK_USED | cls)
+            || cls >= SHARED_HEAP_SMALL_CLASS_NUM)) {
+        return false;
+    }
+
+    *p_segment = segment;
+    *p_block = block;
+    *p_magic = magic;
+    return true;
+}
+
+bool
+wasm_runtime_shared_heap_is_allocated(WASMSharedHeap *heap, uint8 *addr)
+{
+    WASMSharedHeapSegment *segment;
+    SharedHeapBlockHead *block;
+    uint32 magic;
+
+    return get_shared_heap_block(heap, addr, &segment, &block, &magic);
+}
+
+bool
+wasm_runtime_shared_heap_contains(WASMSharedHeap *heap, uint8 *addr,
+                                  uint64 bytes)
+{
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    return get_shared_heap_segment(heap, addr, bytes) ? true : false;
+}
+
+bool
+wasm_runtime_shared_heap_free_native(WASMSharedHeap *heap, uint8 *addr)
+{
+    WASMSharedHeapSegment *segment;
+    SharedHeapBlockHead *block;
+    uint32 magic, cls;
+    bool freed;
+
+    if (!get_shared_heap_block(heap, addr, &segment, &block, &magic)) {
+        return false;
+    }
+
+    /* Claim the block, a concurrent free of it fails here */
+    cls = magic & 0xFF;
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+    os_mutex_lock(&heap->lock);
+#endif
+    freed = BH_ATOMIC_32_COMPARE_EXCHANGE(
+        block->magic, magic,
+        magic == SHARED_HEAP_BLOCK_LARGE ? 0 : SHARED_HEAP_BLOCK_FREE | cls);
+#if BH_ATOMIC_32_IS_ATOMIC == 0
+    os_mutex_unlock(&heap->lock);
+#endif
+    if (!freed) {
+        return false;
+    }
+
+    if (magic == SHARED_HEAP_BLOCK_LARGE) {
+        mem_allocator_free(segment->heap_handle, block);
+    }
+    else {
+        small_list_push(heap, segment, cls, block, block);
+    }
+    return true;
 }
 
 void
@@ -480,29 +1247,25 @@ wasm_runtime_shared_heap_free(WASMModuleInstanceCommon *module_inst, uint64 ptr)
 {
     WASMMemoryInstance *memory =
         wasm_get_default_memory((WASMModuleInstance *)module_inst);
-    WASMSharedHeap *shared_heap = get_shared_heap(module_inst);
-    uint8 *addr = NULL;
+    WASMSharedHeap *heap;
+    WASMSharedHeapSegment *segment;
+    uint64 start_off;
 
-    if (!memory || !shared_heap) {
+    if (!memory || !get_shared_heap(module_inst)) {
         return;
     }
 
-    if (memory->is_memory64) {
-        if (ptr < shared_heap->start_off_mem64) { /* ptr can not > UINT64_MAX */
-            LOG_WARNING("The address to free isn't in shared heap");
-            return;
-        }
-        addr = shared_heap->base_addr + (ptr - shared_heap->start_off_mem64);
-    }
-    else {
-        if (ptr < shared_heap->start_off_mem32 || ptr > UINT32_MAX) {
-            LOG_WARNING("The address to free isn't in shared heap");
-            return;
-        }
-        addr = shared_heap->base_addr + (ptr - shared_heap->start_off_mem32);
+    if (!(segment = find_shared_heap_segment_by_app_addr(
+              module_inst, memory->is_memory64, ptr, 1, &heap, &start_off,
+              NULL))) {
+        LOG_WARNING("The address to free isn't in shared heap");
+        return;
     }
 
-    mem_allocator_free(shared_heap->heap_handle, addr);
+    if (!wasm_runtime_shared_heap_free_native(
+            heap, segment->base_addr + (ptr - start_off))) {
+        LOG_WARNING("The address to free isn't allocated from shared heap");
+    }
 }
 #endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
 
@@ -518,6 +1281,23 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
     }
 #endif
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (!mem_allocator_gc_incremental_init()) {
+#if WASM_ENABLE_SHARED_HEAP != 0
+        os_mutex_destroy(&shared_heap_list_lock);
+#endif
+        return false;
+    }
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    if (!mem_allocator_gc_generational_init()) {
+#if WASM_ENABLE_SHARED_HEAP != 0
+        os_mutex_destroy(&shared_heap_list_lock);
+#endif
+        return false;
+    }
+#endif
+
     if (mem_alloc_type == Alloc_With_Pool) {
         ret = wasm_memory_init_with_pool(alloc_option->pool.heap_buf,
                                          alloc_option->pool.heap_size);
@@ -539,11 +1319,17 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
         ret = false;
     }
 
-#if WASM_ENABLE_SHARED_HEAP != 0
     if (!ret) {
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+        mem_allocator_gc_incremental_destroy();
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+        mem_allocator_gc_generational_destroy();
+#endif
+#if WASM_ENABLE_SHARED_HEAP != 0
         os_mutex_destroy(&shared_heap_list_lock);
-    }
 #endif
+    }
 
     return ret;
 }
@@ -554,7 +1340,7 @@ destroy_shared_heaps()
 {
     WASMSharedHeap *heap;
     WASMSharedHeap *cur;
-    uint64 map_size;
+    WASMSharedHeapSegment *segment, *next;
 
     os_mutex_lock(&shared_heap_list_lock);
     heap = shared_heap_list;
@@ -564,14 +1350,23 @@ destroy_shared_heaps()
     while (heap) {
         cur = heap;
         heap = heap->next;
-        mem_allocator_destroy(cur->heap_handle);
-        wasm_runtime_free(cur->heap_handle);
+        for (segment = cur->segments; segment; segment = next) {
+            next = segment->next;
+            mem_allocator_destroy(segment->heap_handle);
 #ifndef OS_ENABLE_HW_BOUND_CHECK
-        map_size = cur->size;
-#else
-        map_size = 8 * (uint64)BH_GB;
+            /* Each segment is mapped separately */
+            wasm_munmap_linear_memory(segment->base_addr, segment->size,
+                                      segment->size);
+#endif
+            wasm_runtime_free(segment->heap_handle);
+            wasm_runtime_free(segment);
+        }
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+        wasm_munmap_linear_memory(cur->base_addr,
+                                  BH_ATOMIC_64_LOAD(cur->committed_size),
+                                  get_shared_heap_map_size(cur));
 #endif
-        wasm_munmap_linear_memory(cur->base_addr, cur->size, map_size);
+        os_mutex_destroy(&cur->lock);
         wasm_runtime_free(cur);
     }
     os_mutex_destroy(&shared_heap_list_lock);
@@ -597,6 +1392,13 @@ wasm_runtime_memory_destroy(void)
 #endif
     }
     memory_mode = MEMORY_MODE_UNKNOWN;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    mem_allocator_gc_incremental_destroy();
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    mem_allocator_gc_generational_destroy();
+#endif
 }
 
 unsigned
@@ -798,6 +1600,10 @@ wasm_runtime_validate_app_str_addr(WASMModuleInstanceCommon *module_inst_comm,
     WASMMemoryInstance *memory_inst;
     uint64 app_end_offset, max_linear_memory_size = MAX_LINEAR_MEMORY_SIZE;
     char *str, *str_end;
+#if WASM_ENABLE_SHARED_HEAP != 0
+    WASMSharedHeapSegment *segment;
+    uint64 shared_heap_start;
+#endif
 
     bh_assert(module_inst_comm->module_type == Wasm_Module_Bytecode
               || module_inst_comm->module_type == Wasm_Module_AoT);
@@ -812,14 +1618,11 @@ wasm_runtime_validate_app_str_addr(WASMModuleInstanceCommon *module_inst_comm,
     }
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-    if (is_app_addr_in_shared_heap(module_inst_comm, memory_inst->is_memory64,
-                                   app_str_offset, 1)) {
-        WASMSharedHeap *shared_heap = get_shared_heap(module_inst_comm);
-        str = (char *)shared_heap->base_addr
-              + (memory_inst->is_memory64
-                     ? (app_str_offset - shared_heap->start_off_mem64)
-                     : (app_str_offset - shared_heap->start_off_mem32));
-        str_end = (char *)shared_heap->base_addr + shared_heap->size;
+    if ((segment = find_shared_heap_segment_by_app_addr(
+             module_inst_comm, memory_inst->is_memory64, app_str_offset, 1,
+             NULL, &shared_heap_start, NULL))) {
+        str = (char *)segment->base_addr + (app_str_offset - shared_heap_start);
+        str_end = (char *)segment->base_addr + segment->size;
     }
     else
 #endif
@@ -884,7 +1687,8 @@ wasm_runtime_validate_native_addr(WASMModuleInstanceCommon *module_inst_comm,
     }
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-    if (is_native_addr_in_shared_heap(module_inst_comm, native_ptr, size)) {
+    if (find_shared_heap_segment_by_native_addr(module_inst_comm, native_ptr,
+                                                size, NULL)) {
         return true;
     }
 #endif
@@ -924,19 +1728,15 @@ wasm_runtime_addr_app_to_native(WASMModuleInstanceCommon *module_inst_comm,
     }
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-    if (is_app_addr_in_shared_heap(module_inst_comm, memory_inst->is_memory64,
-                                   app_offset, 1)) {
-        WASMSharedHeap *shared_heap = get_shared_heap(module_inst_comm);
-        uint64 shared_heap_start = 0;
+    {
+        WASMSharedHeapSegment *segment;
+        uint64 shared_heap_start;
 
-        if (memory_inst && !memory_inst->is_memory64) {
-            shared_heap_start = shared_heap->start_off_mem32;
+        if ((segment = find_shared_heap_segment_by_app_addr(
+                 module_inst_comm, memory_inst->is_memory64, app_offset, 1,
+                 NULL, &shared_heap_start, NULL))) {
+            return segment->base_addr + app_offset - shared_heap_start;
         }
-        else if (memory_inst && memory_inst->is_memory64) {
-            shared_heap_start = shared_heap->start_off_mem64;
-        }
-
-        return shared_heap->base_addr + app_offset - shared_heap_start;
     }
 #endif
 
@@ -985,18 +1785,16 @@ wasm_runtime_addr_native_to_app(WASMModuleInstanceCommon *module_inst_comm,
     }
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-    if (is_native_addr_in_shared_heap(module_inst_comm, addr, 1)) {
-        WASMSharedHeap *shared_heap = get_shared_heap(module_inst_comm);
-        uint64 shared_heap_start = 0;
-
-        if (memory_inst && !memory_inst->is_memory64) {
-            shared_heap_start = shared_heap->start_off_mem32;
-        }
-        else if (memory_inst && memory_inst->is_memory64) {
-            shared_heap_start = shared_heap->start_off_mem64;
+    {
+        WASMSharedHeap *shared_heap;
+        WASMSharedHeapSegment *segment;
+
+        if ((segment = find_shared_heap_segment_by_native_addr(
+                 module_inst_comm, addr, 1, &shared_heap))) {
+            return get_shared_heap_start_off(shared_heap,
+                                             memory_inst->is_memory64)
+                   + segment->offset + (addr - segment->base_addr);
         }
-
-        return shared_heap_start + (addr - shared_heap->base_addr);
     }
 #endif
 
@@ -1098,7 +1896,8 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
     uint8 *native_addr;
     bool bounds_checks;
 #if WASM_ENABLE_SHARED_HEAP != 0
-    WASMSharedHeap *shared_heap;
+    WASMSharedHeapSegment *segment;
+    uint64 shared_heap_start;
     bool is_in_shared_heap = false;
 #endif
 
@@ -1110,14 +1909,10 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
     }
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-    if (is_app_addr_in_shared_heap((WASMModuleInstanceCommon *)module_inst,
-                                   memory_inst->is_memory64, app_buf_addr,
-                                   app_buf_size)) {
-        shared_heap = get_shared_heap((WASMModuleInstanceCommon *)module_inst);
-        native_addr = shared_heap->base_addr
-                      + (memory_inst->is_memory64
-                             ? (app_buf_addr - shared_heap->start_off_mem64)
-                             : (app_buf_addr - shared_heap->start_off_mem32));
+    if ((segment = find_shared_heap_segment_by_app_addr(
+             (WASMModuleInstanceCommon *)module_inst, memory_inst->is_memory64,
+             app_buf_addr, app_buf_size, NULL, &shared_heap_start, NULL))) {
+        native_addr = segment->base_addr + (app_buf_addr - shared_heap_start);
         is_in_shared_heap = true;
     }
     else
@@ -1142,7 +1937,7 @@ wasm_check_app_addr_and_convert(WASMModuleInstance *module_inst, bool is_str,
 
         /* The whole string must be in the linear memory */
         str = (const char *)native_addr;
-        str_end = (const char *)shared_heap->base_addr + shared_heap->size;
+        str_end = (const char *)segment->base_addr + segment->size;
         while (str < str_end && *str != '\0')
             str++;
         if (str == str_end) {
@@ -1344,19 +2139,12 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
 
 #if WASM_ENABLE_SHARED_HEAP != 0
     shared_heap = get_shared_heap(module);
-    if (shared_heap) {
-        if (memory->is_memory64
-            && total_size_new > shared_heap->start_off_mem64) {
-            LOG_WARNING("Linear memory address is overlapped with shared heap");
-            ret = false;
-            goto return_func;
-        }
-        else if (!memory->is_memory64
-                 && total_size_new > shared_heap->start_off_mem32) {
-            LOG_WARNING("Linear memory address is overlapped with shared heap");
-            ret = false;
-            goto return_func;
-        }
+    if (shared_heap
+        && total_size_new > wasm_runtime_get_shared_heap_chain_start_off(
+               shared_heap, memory->is_memory64)) {
+        LOG_WARNING("Linear memory address is overlapped with shared heap");
+        ret = false;
+        goto return_func;
     }
 #endif
 
@@ -1461,6 +2249,11 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
     wasm_runtime_set_mem_bound_check_bytes(memory, total_size_new);
 
 return_func:
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_record_memory_grow(
+        ret, ret ? num_bytes_per_page * (uint64)inc_page_count : 0);
+#endif
+
     if (!ret && module && enlarge_memory_error_cb) {
         WASMExecEnv *exec_env = NULL;
 
@@ -1753,3 +2546,85 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
 
     return BHT_OK;
 }
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+bool
+wasm_memory_image_create(WASMMemoryImage *image, uint64 data_end)
+{
+    uint64 page_size = os_getpagesize();
+    uint64 size = align_as_and_cast(data_end, page_size);
+    os_file_handle file;
+
+    bh_assert(image->size == 0);
+
+    if (data_end == 0 || size > UINTPTR_MAX)
+        return false;
+
+    /* The file reads as zero until written */
+    if (os_mem_file_create("wasm-memory-image", size, &file) != 0) {
+        LOG_VERBOSE("create memory image failed");
+        return false;
+    }
+
+    image->file = file;
+    image->size = size;
+    image->data_end = data_end;
+    return true;
+}
+
+bool
+wasm_memory_image_write(WASMMemoryImage *image, uint64 offset,
+                        const uint8 *data, uint32 length)
+{
+    bh_assert(image->size > 0);
+    bh_assert(offset + length <= image->data_end);
+
+    if (os_mem_file_write(image->file, offset, data, length) != 0) {
+        LOG_WARNING("write memory image failed");
+        return false;
+    }
+    return true;
+}
+
+bool
+wasm_memory_image_seal(WASMMemoryImage *image)
+{
+    bh_assert(image->size > 0);
+
+    /* Nothing can change the content or the size of the image after
+       it is mapped, the instances only see their private copies */
+    if (os_mem_file_seal(image->file) != 0) {
+        LOG_WARNING("seal memory image failed");
+        return false;
+    }
+    return true;
+}
+
+void
+wasm_memory_image_destroy(WASMMemoryImage *image)
+{
+    if (image->size > 0) {
+        os_mem_file_close(image->file);
+        image->file = os_get_invalid_handle();
+        image->size = 0;
+        image->data_end = 0;
+    }
+}
+
+bool
+wasm_memory_image_map(const WASMMemoryImage *image, uint8 *memory_data,
+                      uint64 memory_data_size)
+{
+    if (image->size == 0 || !memory_data || image->size > memory_data_size)
+        return false;
+
+    /* The linear memory is page aligned, replace its first pages with
+       a private mapping of the image, the pages are copied on write */
+    if (os_mem_file_map_private(image->file, memory_data, (size_t)image->size)
+        != 0) {
+        LOG_WARNING("map memory image failed");
+        return false;
+    }
+    return true;
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
@@ -45,6 +45,12 @@ SET_LINEAR_MEMORY_SIZE(WASMMemoryInstance *memory, uint64 size)
 WASMSharedHeap *
 wasm_runtime_create_shared_heap(SharedHeapInitArgs *init_args);
 
+WASMSharedHeap *
+wasm_runtime_chain_shared_heaps(WASMSharedHeap *head, WASMSharedHeap *body);
+
+WASMSharedHeap *
+wasm_runtime_unchain_shared_heaps(WASMSharedHeap *head, bool entire_chain);
+
 bool
 wasm_runtime_attach_shared_heap(WASMModuleInstanceCommon *module_inst,
                                 WASMSharedHeap *shared_heap);
@@ -61,6 +67,34 @@ wasm_runtime_detach_shared_heap_internal(WASMModuleInstanceCommon *module_inst);
 WASMSharedHeap *
 wasm_runtime_get_shared_heap(WASMModuleInstanceCommon *module_inst_comm);
 
+/* Get the lowest offset of the shared heap chain headed by head */
+uint64
+wasm_runtime_get_shared_heap_chain_start_off(WASMSharedHeap *head,
+                                             bool is_memory64);
+
+/* Get the range which the module instances without shared heap refer
+   to, no address is in it */
+WASMSharedHeapRange *
+wasm_runtime_get_empty_shared_heap_range(void);
+
+bool
+wasm_runtime_is_native_addr_in_shared_heap(
+    WASMModuleInstanceCommon *module_inst, uint8 *addr, uint64 bytes);
+
+/* Find the segment of the attached chain which contains the app address
+   range, and return its offset range and base address */
+bool
+wasm_runtime_shared_heap_lookup(WASMModuleInstanceCommon *module_inst,
+                                bool is_memory64, uint64 app_offset,
+                                uint64 bytes, uint64 *p_start_off,
+                                uint64 *p_end_off, uint8 **p_base_addr);
+
+/* Same as above, but cache the range of the segment found in the module
+   instance for the jit/aot code and return it, or NULL if not found */
+WASMSharedHeapRange *
+wasm_runtime_update_last_used_shared_heap(WASMModuleInstanceCommon *module_inst,
+                                          uint64 app_offset, uint64 bytes);
+
 uint64
 wasm_runtime_shared_heap_malloc(WASMModuleInstanceCommon *module_inst,
                                 uint64 size, void **p_native_addr);
@@ -68,6 +102,20 @@ wasm_runtime_shared_heap_malloc(WASMModuleInstanceCommon *module_inst,
 void
 wasm_runtime_shared_heap_free(WASMModuleInstanceCommon *module_inst,
                               uint64 ptr);
+
+/* Check whether [addr, addr + bytes - 1] is in a segment of heap */
+bool
+wasm_runtime_shared_heap_contains(WASMSharedHeap *heap, uint8 *addr,
+                                  uint64 bytes);
+
+/* Check whether addr is the start of a block allocated from heap */
+bool
+wasm_runtime_shared_heap_is_allocated(WASMSharedHeap *heap, uint8 *addr);
+
+/* Free a block allocated from heap by its native address, return false
+   if addr isn't such a block */
+bool
+wasm_runtime_shared_heap_free_native(WASMSharedHeap *heap, uint8 *addr);
 #endif
 
 bool
@@ -97,6 +145,34 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
                             uint64 init_page_count, uint64 max_page_count,
                             uint64 *memory_data_size);
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/**
+ * Create an empty memory image of data_end bytes, the content is
+ * written with wasm_memory_image_write() and then sealed with
+ * wasm_memory_image_seal() before the image is mapped.
+ */
+bool
+wasm_memory_image_create(WASMMemoryImage *image, uint64 data_end);
+
+bool
+wasm_memory_image_write(WASMMemoryImage *image, uint64 offset,
+                        const uint8 *data, uint32 length);
+
+bool
+wasm_memory_image_seal(WASMMemoryImage *image);
+
+void
+wasm_memory_image_destroy(WASMMemoryImage *image);
+
+/**
+ * Map the memory image copy-on-write at the beginning of a linear
+ * memory, replacing its first image->size bytes.
+ */
+bool
+wasm_memory_image_map(const WASMMemoryImage *image, uint8 *memory_data,
+                      uint64 memory_data_size);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,12 @@ get_spectest_export_apis(NativeSymbol **p_libc_builtin_apis);
 #endif
 
 #if WASM_ENABLE_SHARED_HEAP != 0
+bool
+lib_shared_heap_init();
+
+void
+lib_shared_heap_destroy();
+
 uint32
 get_lib_shared_heap_export_apis(NativeSymbol **p_shared_heap_apis);
 #endif
@@ -485,7 +491,8 @@ wasm_native_init()
     || WASM_ENABLE_LIB_RATS != 0 || WASM_ENABLE_WASI_NN != 0             \
     || WASM_ENABLE_APP_FRAMEWORK != 0 || WASM_ENABLE_LIBC_WASI != 0      \
     || WASM_ENABLE_LIB_PTHREAD != 0 || WASM_ENABLE_LIB_WASI_THREADS != 0 \
-    || WASM_ENABLE_WASI_NN != 0 || WASM_ENABLE_WASI_EPHEMERAL_NN != 0
+    || WASM_ENABLE_WASI_NN != 0 || WASM_ENABLE_WASI_EPHEMERAL_NN != 0    \
+    || WASM_ENABLE_SHARED_HEAP != 0
     NativeSymbol *native_symbols;
     uint32 n_native_symbols;
 #endif
@@ -518,6 +525,9 @@ wasm_native_init()
 #endif
 
 #if WASM_ENABLE_SHARED_HEAP != 0
+    if (!lib_shared_heap_init())
+        goto fail;
+
     n_native_symbols = get_lib_shared_heap_export_apis(&native_symbols);
     if (n_native_symbols > 0
         && !wasm_native_register_natives("env", native_symbols,
@@ -602,7 +612,8 @@ wasm_native_init()
     || WASM_ENABLE_LIB_RATS != 0 || WASM_ENABLE_WASI_NN != 0             \
     || WASM_ENABLE_APP_FRAMEWORK != 0 || WASM_ENABLE_LIBC_WASI != 0      \
     || WASM_ENABLE_LIB_PTHREAD != 0 || WASM_ENABLE_LIB_WASI_THREADS != 0 \
-    || WASM_ENABLE_WASI_NN != 0 || WASM_ENABLE_WASI_EPHEMERAL_NN != 0
+    || WASM_ENABLE_WASI_NN != 0 || WASM_ENABLE_WASI_EPHEMERAL_NN != 0    \
+    || WASM_ENABLE_SHARED_HEAP != 0
         goto fail;
 #else
         return false;
@@ -616,7 +627,8 @@ wasm_native_init()
     || WASM_ENABLE_LIB_RATS != 0 || WASM_ENABLE_WASI_NN != 0             \
     || WASM_ENABLE_APP_FRAMEWORK != 0 || WASM_ENABLE_LIBC_WASI != 0      \
     || WASM_ENABLE_LIB_PTHREAD != 0 || WASM_ENABLE_LIB_WASI_THREADS != 0 \
-    || WASM_ENABLE_WASI_NN != 0 || WASM_ENABLE_WASI_EPHEMERAL_NN != 0
+    || WASM_ENABLE_WASI_NN != 0 || WASM_ENABLE_WASI_EPHEMERAL_NN != 0    \
+    || WASM_ENABLE_SHARED_HEAP != 0
 fail:
     wasm_native_destroy();
     return false;
@@ -639,6 +651,10 @@ wasm_native_destroy()
     lib_pthread_destroy();
 #endif
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    lib_shared_heap_destroy();
+#endif
+
 #if WASM_ENABLE_LIB_WASI_THREADS != 0
     lib_wasi_threads_destroy();
 #endif
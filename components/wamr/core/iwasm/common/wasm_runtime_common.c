@@ -31,8 +31,15 @@
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "wasm_shared_memory.h"
 #endif
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+#include "wasm_sampling_profiler.h"
+#endif
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+#include "wasm_runtime_metrics.h"
+#endif
 #if WASM_ENABLE_FAST_JIT != 0
 #include "../fast-jit/jit_compiler.h"
+#include "../fast-jit/jit_codecache.h"
 #endif
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
 #include "../compilation/aot_llvm.h"
@@ -206,9 +213,9 @@ is_sig_addr_in_guard_pages(void *sig_addr, WASMModuleInstance *module_inst)
     }
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-    shared_heap =
-        wasm_runtime_get_shared_heap((WASMModuleInstanceCommon *)module_inst);
-    if (shared_heap) {
+    for (shared_heap = wasm_runtime_get_shared_heap(
+             (WASMModuleInstanceCommon *)module_inst);
+         shared_heap; shared_heap = shared_heap->chain_next) {
         mapped_mem_start_addr = shared_heap->base_addr;
         mapped_mem_end_addr = shared_heap->base_addr + 8 * (uint64)BH_GB;
         if (mapped_mem_start_addr <= (uint8 *)sig_addr
@@ -525,8 +532,29 @@ wasm_runtime_env_init(void)
     os_end_blocking_op();
 #endif
 
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+    if (!wasm_sampling_profiler_init()) {
+        goto fail12;
+    }
+#endif
+
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    if (!wasm_runtime_metrics_init()) {
+        goto fail13;
+    }
+#endif
+
     return true;
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+fail13:
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+    wasm_sampling_profiler_destroy();
+#endif
+#endif
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+fail12:
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0 && defined(OS_ENABLE_WAKEUP_BLOCKING_OP)
 fail11:
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
@@ -641,6 +669,14 @@ wasm_runtime_init()
 static void
 wasm_runtime_destroy_internal(void)
 {
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+    wasm_sampling_profiler_destroy();
+#endif
+
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_destroy();
+#endif
+
 #if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
     wasm_externref_map_destroy();
 #endif
@@ -754,6 +790,8 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
 
 #if WASM_ENABLE_FAST_JIT != 0
     jit_options.code_cache_size = init_args->fast_jit_code_cache_size;
+    jit_options.disabled_opt_passes = init_args->fast_jit_disabled_opt_passes;
+    jit_options.compile_threshold = init_args->fast_jit_compile_threshold;
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -864,6 +902,17 @@ wasm_runtime_is_running_mode_supported(RunningMode running_mode)
     return false;
 }
 
+bool
+wasm_runtime_get_fast_jit_code_cache_info(fast_jit_code_cache_info_t *info)
+{
+#if WASM_ENABLE_FAST_JIT != 0
+    if (info)
+        return jit_code_cache_get_info(info);
+#endif
+    (void)info;
+    return false;
+}
+
 bool
 wasm_runtime_set_default_running_mode(RunningMode running_mode)
 {
@@ -1431,9 +1480,32 @@ register_module_with_null_name(WASMModuleCommon *module_common, char *error_buf,
 #endif
 }
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+static WASMModuleCommon *
+runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
+                char *error_buf, uint32 error_buf_size);
+
+WASMModuleCommon *
+wasm_runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
+                     char *error_buf, uint32 error_buf_size)
+{
+    uint64 start_us = os_time_get_boot_us();
+    WASMModuleCommon *module_common =
+        runtime_load_ex(buf, size, args, error_buf, error_buf_size);
+
+    wasm_runtime_metrics_record_load(module_common != NULL,
+                                     os_time_get_boot_us() - start_us);
+    return module_common;
+}
+
+static WASMModuleCommon *
+runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
+                char *error_buf, uint32 error_buf_size)
+#else
 WASMModuleCommon *
 wasm_runtime_load_ex(uint8 *buf, uint32 size, const LoadArgs *args,
                      char *error_buf, uint32 error_buf_size)
+#endif
 {
     WASMModuleCommon *module_common = NULL;
     uint32 package_type;
@@ -1567,6 +1639,46 @@ wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
 #endif
 }
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+WASMModuleCommon *
+wasm_runtime_load_from_streamed_sections(WASMSection *section_list,
+                                         const LoadArgs *args,
+                                         char *error_buf, uint32 error_buf_size)
+{
+    WASMModuleCommon *module_common;
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    uint64 start_us = os_time_get_boot_us();
+#endif
+
+    module_common = (WASMModuleCommon *)wasm_load_from_streamed_sections(
+        section_list, args, error_buf, error_buf_size);
+    if (!module_common) {
+        LOG_DEBUG("WASM module load failed from streamed sections");
+    }
+    else {
+        ((WASMModule *)module_common)->is_binary_freeable = true;
+        /* The sections are freed after loading */
+        if (!wasm_runtime_is_underlying_binary_freeable(module_common)) {
+            wasm_unload((WASMModule *)module_common);
+            set_error_buf(error_buf, error_buf_size,
+                          "WASM module load failed: module refers to the "
+                          "streamed sections");
+            module_common = NULL;
+        }
+        else {
+            module_common = register_module_with_null_name(
+                module_common, error_buf, error_buf_size);
+        }
+    }
+
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_record_load(module_common != NULL,
+                                     os_time_get_boot_us() - start_us);
+#endif
+    return module_common;
+}
+#endif /* end of WASM_ENABLE_STREAM_LOADER != 0 */
+
 void
 wasm_runtime_unload(WASMModuleCommon *module)
 {
@@ -1617,12 +1729,48 @@ wasm_runtime_get_max_mem(uint32 max_memory_pages, uint32 module_init_page_count,
     return max_memory_pages;
 }
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+static WASMModuleInstanceCommon *
+runtime_instantiate_internal(WASMModuleCommon *module,
+                             WASMModuleInstanceCommon *parent,
+                             WASMExecEnv *exec_env_main, uint32 stack_size,
+                             uint32 heap_size, uint32 max_memory_pages,
+                             char *error_buf, uint32 error_buf_size);
+
+WASMModuleInstanceCommon *
+wasm_runtime_instantiate_internal(WASMModuleCommon *module,
+                                  WASMModuleInstanceCommon *parent,
+                                  WASMExecEnv *exec_env_main, uint32 stack_size,
+                                  uint32 heap_size, uint32 max_memory_pages,
+                                  char *error_buf, uint32 error_buf_size)
+{
+    uint64 start_us = os_time_get_boot_us();
+    WASMModuleInstanceCommon *module_inst = runtime_instantiate_internal(
+        module, parent, exec_env_main, stack_size, heap_size, max_memory_pages,
+        error_buf, error_buf_size);
+
+    /* sub instances are counted as a part of their parent */
+    if (!parent) {
+        wasm_runtime_metrics_record_instantiate(
+            module_inst != NULL, os_time_get_boot_us() - start_us);
+    }
+    return module_inst;
+}
+
+static WASMModuleInstanceCommon *
+runtime_instantiate_internal(WASMModuleCommon *module,
+                             WASMModuleInstanceCommon *parent,
+                             WASMExecEnv *exec_env_main, uint32 stack_size,
+                             uint32 heap_size, uint32 max_memory_pages,
+                             char *error_buf, uint32 error_buf_size)
+#else
 WASMModuleInstanceCommon *
 wasm_runtime_instantiate_internal(WASMModuleCommon *module,
                                   WASMModuleInstanceCommon *parent,
                                   WASMExecEnv *exec_env_main, uint32 stack_size,
                                   uint32 heap_size, uint32 max_memory_pages,
                                   char *error_buf, uint32 error_buf_size)
+#endif
 {
 #if WASM_ENABLE_INTERP != 0
     if (module->module_type == Wasm_Module_Bytecode)
@@ -1641,6 +1789,22 @@ wasm_runtime_instantiate_internal(WASMModuleCommon *module,
     return NULL;
 }
 
+bool
+wasm_runtime_get_module_stack_usage(WASMModuleCommon *const module,
+                                    uint32 *native_stack_size,
+                                    uint32 *wasm_stack_size)
+{
+#if WASM_ENABLE_AOT != 0
+    if (module && module->module_type == Wasm_Module_AoT)
+        return aot_get_module_stack_usage((AOTModule *)module,
+                                          native_stack_size, wasm_stack_size);
+#endif
+    (void)module;
+    (void)native_stack_size;
+    (void)wasm_stack_size;
+    return false;
+}
+
 WASMModuleInstanceCommon *
 wasm_runtime_instantiate(WASMModuleCommon *module, uint32 stack_size,
                          uint32 heap_size, char *error_buf,
@@ -1740,6 +1904,94 @@ wasm_runtime_destroy_exec_env(WASMExecEnv *exec_env)
     wasm_exec_env_destroy(exec_env);
 }
 
+static WASMModuleInstanceExtraCommon *
+get_module_inst_extra_common(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return &((WASMModuleInstance *)module_inst)->e->common;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return &((AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)
+                     ->e)
+                    ->common;
+#endif
+    bh_assert(0);
+    return NULL;
+}
+
+bool
+wasm_runtime_create_exec_env_pool(WASMModuleInstanceCommon *module_inst,
+                                  uint32 max_idle, uint32 stack_size,
+                                  bool bind_thread)
+{
+    WASMModuleInstanceExtraCommon *common =
+        get_module_inst_extra_common(module_inst);
+
+    if (!common) {
+        LOG_ERROR("Create exec_env pool failed: invalid module instance");
+        return false;
+    }
+
+    if (common->exec_env_pool) {
+        LOG_WARNING("exec_env pool already created");
+        return false;
+    }
+
+    if (stack_size == 0)
+        stack_size =
+            ((WASMModuleInstance *)module_inst)->default_wasm_stack_size;
+
+    return (common->exec_env_pool = wasm_exec_env_pool_create(
+                module_inst, max_idle, stack_size, bind_thread))
+           != NULL;
+}
+
+WASMExecEnv *
+wasm_runtime_checkout_exec_env(WASMModuleInstanceCommon *module_inst)
+{
+    WASMModuleInstanceExtraCommon *common =
+        get_module_inst_extra_common(module_inst);
+
+    if (!common)
+        return NULL;
+
+    if (!common->exec_env_pool)
+        return wasm_exec_env_create(
+            module_inst,
+            ((WASMModuleInstance *)module_inst)->default_wasm_stack_size);
+
+    return wasm_exec_env_pool_checkout(common->exec_env_pool);
+}
+
+void
+wasm_runtime_return_exec_env(WASMExecEnv *exec_env)
+{
+    WASMModuleInstanceExtraCommon *common;
+
+    if (!exec_env)
+        return;
+
+    common = get_module_inst_extra_common(exec_env->module_inst);
+    if (!common || !common->exec_env_pool)
+        wasm_exec_env_destroy(exec_env);
+    else
+        wasm_exec_env_pool_return(common->exec_env_pool, exec_env);
+}
+
+uint32
+wasm_runtime_trim_exec_env_pool(WASMModuleInstanceCommon *module_inst)
+{
+    WASMModuleInstanceExtraCommon *common =
+        get_module_inst_extra_common(module_inst);
+
+    if (!common || !common->exec_env_pool)
+        return 0;
+
+    return wasm_exec_env_pool_trim(common->exec_env_pool);
+}
+
 bool
 wasm_runtime_init_thread_env(void)
 {
@@ -1767,6 +2019,10 @@ wasm_runtime_init_thread_env(void)
 void
 wasm_runtime_destroy_thread_env(void)
 {
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_thread_exit();
+#endif
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     runtime_signal_destroy();
 #endif
@@ -2976,9 +3232,20 @@ wasm_set_exception_local(WASMModuleInstance *module_inst, const char *exception)
     exception_unlock(module_inst);
 }
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+static void
+record_exception_metrics(const char *exception);
+#endif
+
 void
 wasm_set_exception(WASMModuleInstance *module_inst, const char *exception)
 {
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    if (exception && exception[0] != '\0') {
+        record_exception_metrics(exception);
+    }
+#endif
+
 #if WASM_ENABLE_THREAD_MGR != 0
     WASMExecEnv *exec_env =
         wasm_clusters_search_exec_env((WASMModuleInstanceCommon *)module_inst);
@@ -3034,6 +3301,66 @@ static const char *exception_msgs[] = {
 };
 /* clang-format on */
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+static void
+record_exception_metrics(const char *exception)
+{
+    wasm_metrics_exception_kind_t kind = WASM_METRICS_EXCE_OTHER;
+    uint32 id;
+
+    for (id = 0; id < EXCE_NUM; id++) {
+        if (!strcmp(exception, exception_msgs[id]))
+            break;
+    }
+
+    switch (id) {
+        case EXCE_UNREACHABLE:
+            kind = WASM_METRICS_EXCE_UNREACHABLE;
+            break;
+        case EXCE_OUT_OF_MEMORY:
+            kind = WASM_METRICS_EXCE_OUT_OF_MEMORY;
+            break;
+        case EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS:
+            kind = WASM_METRICS_EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS;
+            break;
+        case EXCE_INTEGER_OVERFLOW:
+            kind = WASM_METRICS_EXCE_INTEGER_OVERFLOW;
+            break;
+        case EXCE_INTEGER_DIVIDE_BY_ZERO:
+            kind = WASM_METRICS_EXCE_INTEGER_DIVIDE_BY_ZERO;
+            break;
+        case EXCE_INVALID_CONVERSION_TO_INTEGER:
+            kind = WASM_METRICS_EXCE_INVALID_CONVERSION_TO_INTEGER;
+            break;
+        case EXCE_INVALID_FUNCTION_TYPE_INDEX:
+        case EXCE_INVALID_FUNCTION_INDEX:
+        case EXCE_UNDEFINED_ELEMENT:
+        case EXCE_UNINITIALIZED_ELEMENT:
+            kind = WASM_METRICS_EXCE_INDIRECT_CALL;
+            break;
+        case EXCE_NATIVE_STACK_OVERFLOW:
+        case EXCE_AUX_STACK_OVERFLOW:
+        case EXCE_OPERAND_STACK_OVERFLOW:
+            kind = WASM_METRICS_EXCE_STACK_OVERFLOW;
+            break;
+        case EXCE_OUT_OF_BOUNDS_TABLE_ACCESS:
+            kind = WASM_METRICS_EXCE_OUT_OF_BOUNDS_TABLE_ACCESS;
+            break;
+        case EXCE_NULL_FUNC_OBJ:
+        case EXCE_NULL_STRUCT_OBJ:
+        case EXCE_NULL_ARRAY_OBJ:
+        case EXCE_NULL_I31_OBJ:
+        case EXCE_NULL_REFERENCE:
+            kind = WASM_METRICS_EXCE_NULL_REFERENCE;
+            break;
+        default:
+            break;
+    }
+
+    wasm_runtime_metrics_record_exception(kind);
+}
+#endif /* end of WASM_ENABLE_RUNTIME_METRICS != 0 */
+
 void
 wasm_set_exception_with_id(WASMModuleInstance *module_inst, uint32 id)
 {
@@ -6666,7 +6993,7 @@ wasm_externref_retain(uint32 externref_idx)
 }
 #endif /* end of WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0 */
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
 uint32
 wasm_runtime_dump_line_buf_impl(const char *line_buf, bool dump_or_print,
                                 char **buf, uint32 *len)
@@ -6690,7 +7017,10 @@ wasm_runtime_dump_line_buf_impl(const char *line_buf, bool dump_or_print,
         return (uint32)strlen(line_buf);
     }
 }
+#endif /* end of WASM_ENABLE_DUMP_CALL_STACK != 0 \
+          || WASM_ENABLE_SAMPLING_PROFILER != 0 */
 
+#if WASM_ENABLE_DUMP_CALL_STACK != 0
 void
 wasm_runtime_dump_call_stack(WASMExecEnv *exec_env)
 {
@@ -6775,6 +7105,42 @@ wasm_runtime_dump_pgo_prof_data_to_buf(WASMModuleInstanceCommon *module_inst,
 #endif
     return 0;
 }
+
+uint32
+wasm_runtime_get_pgo_counters_size(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        AOTModuleInstance *aot_inst = (AOTModuleInstance *)module_inst;
+        return aot_get_pgo_counters_size(aot_inst);
+    }
+#endif
+    return 0;
+}
+
+uint32
+wasm_runtime_dump_pgo_counters_to_buf(WASMModuleInstanceCommon *module_inst,
+                                      char *buf, uint32 len)
+{
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        AOTModuleInstance *aot_inst = (AOTModuleInstance *)module_inst;
+        return aot_dump_pgo_counters_to_buf(aot_inst, buf, len);
+    }
+#endif
+    return 0;
+}
+
+void
+wasm_runtime_reset_pgo_counters(WASMModuleInstanceCommon *module_inst)
+{
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        AOTModuleInstance *aot_inst = (AOTModuleInstance *)module_inst;
+        aot_reset_pgo_counters(aot_inst);
+    }
+#endif
+}
 #endif /* end of WASM_ENABLE_STATIC_PGO != 0 */
 
 bool
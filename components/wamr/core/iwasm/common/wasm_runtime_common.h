@@ -560,6 +560,16 @@ WASM_RUNTIME_API_EXTERN WASMModuleCommon *
 wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
                                 char *error_buf, uint32 error_buf_size);
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+/* Load the module from the sections received by the chunked loader,
+   the sections can be freed after it returns */
+WASMModuleCommon *
+wasm_runtime_load_from_streamed_sections(WASMSection *section_list,
+                                         const LoadArgs *args,
+                                         char *error_buf,
+                                         uint32 error_buf_size);
+#endif
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_unload(WASMModuleCommon *module);
@@ -582,6 +592,12 @@ void
 wasm_runtime_deinstantiate_internal(WASMModuleInstanceCommon *module_inst,
                                     bool is_sub_inst);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_module_stack_usage(WASMModuleCommon *const module,
+                                    uint32 *native_stack_size,
+                                    uint32 *wasm_stack_size);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
 wasm_runtime_instantiate(WASMModuleCommon *module, uint32 default_stack_size,
@@ -652,6 +668,24 @@ wasm_runtime_create_exec_env(WASMModuleInstanceCommon *module_inst,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_destroy_exec_env(WASMExecEnv *exec_env);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_create_exec_env_pool(WASMModuleInstanceCommon *module_inst,
+                                  uint32 max_idle, uint32 stack_size,
+                                  bool bind_thread);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMExecEnv *
+wasm_runtime_checkout_exec_env(WASMModuleInstanceCommon *module_inst);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_return_exec_env(WASMExecEnv *exec_env);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint32
+wasm_runtime_trim_exec_env_pool(WASMModuleInstanceCommon *module_inst);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
 wasm_runtime_get_module_inst(WASMExecEnv *exec_env);
@@ -1027,7 +1061,7 @@ void
 wasm_externref_cleanup(WASMModuleInstanceCommon *module_inst);
 #endif /* end of WASM_ENABLE_REF_TYPES */
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
 /**
  * @brief Internal implementation for dumping or printing callstack line
  *
@@ -1047,7 +1081,8 @@ wasm_externref_cleanup(WASMModuleInstanceCommon *module_inst);
 uint32
 wasm_runtime_dump_line_buf_impl(const char *line_buf, bool dump_or_print,
                                 char **buf, uint32 *len);
-#endif /* end of WASM_ENABLE_DUMP_CALL_STACK != 0 */
+#endif /* end of WASM_ENABLE_DUMP_CALL_STACK != 0 \
+          || WASM_ENABLE_SAMPLING_PROFILER != 0 */
 
 /* Get module of the current exec_env */
 WASMModuleCommon *
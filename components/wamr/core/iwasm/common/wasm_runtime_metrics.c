@@ -0,0 +1,548 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_runtime_metrics.h"
+#include "wasm_runtime_common.h"
+#include "wasm_memory.h"
+#include "bh_platform.h"
+
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+
+#define METRICS_CACHE_LINE_SIZE 64
+
+typedef struct WASMNativeCallEntry {
+    void *func_ptr;
+    wasm_native_call_metric_t metric;
+} WASMNativeCallEntry;
+
+/**
+ * Metrics recorded by one thread. A block is only written by its own
+ * thread and starts on its own cache line, so that recording needs no
+ * lock and doesn't cause false sharing. The readers copy it under a
+ * sequence lock so that they never see a torn counter. When its thread
+ * exits, the block is kept with its counters and reused by a later
+ * thread.
+ */
+typedef struct WASMMetricsBlock {
+    struct WASMMetricsBlock *next;
+    /* the address returned by wasm_runtime_malloc */
+    void *alloc_addr;
+    /* whether a thread records into the block, protected by
+       metrics_lock */
+    bool in_use;
+    /* odd while the owner thread updates the block */
+    bh_atomic_32_t seq;
+    /* start time of the GC running in this thread */
+    uint64 gc_start_us;
+    wasm_runtime_metrics_t metrics;
+    /* open addressing hash table keyed by the function pointer, the
+       calls to the functions which don't fit are only counted in
+       metrics.native_call_count */
+    WASMNativeCallEntry native_calls[WASM_RUNTIME_METRICS_NATIVE_SYMBOLS];
+} WASMMetricsBlock;
+
+static korp_mutex metrics_lock;
+static bool metrics_inited = false;
+static WASMMetricsBlock *metrics_blocks = NULL;
+/* Increased each time the metrics are initialized, so the blocks
+   cached by the threads in a previous runtime lifetime are dropped */
+static uint32 metrics_generation = 0;
+
+#ifdef os_thread_local_attribute
+static os_thread_local_attribute WASMMetricsBlock *thread_block = NULL;
+static os_thread_local_attribute uint32 thread_block_generation = 0;
+
+#define METRICS_LOCK() (void)0
+#define METRICS_UNLOCK() (void)0
+
+static inline void
+block_write_begin(WASMMetricsBlock *block)
+{
+    BH_ATOMIC_32_STORE(block->seq, BH_ATOMIC_32_LOAD(block->seq) + 1);
+    os_atomic_thread_fence(os_memory_order_release);
+}
+
+static inline void
+block_write_end(WASMMetricsBlock *block)
+{
+    os_atomic_thread_fence(os_memory_order_release);
+    BH_ATOMIC_32_STORE(block->seq, BH_ATOMIC_32_LOAD(block->seq) + 1);
+}
+
+/* Copy a block written by another thread, retry until the copy isn't
+   torn by an update, called with metrics_lock */
+static void
+block_read(WASMMetricsBlock *block, wasm_runtime_metrics_t *metrics,
+           WASMNativeCallEntry *native_calls)
+{
+    uint32 seq;
+
+    for (;;) {
+        /* The owner thread updates the block for a few instructions */
+        if ((seq = BH_ATOMIC_32_LOAD(block->seq)) & 1) {
+            continue;
+        }
+        os_atomic_thread_fence(os_memory_order_acquire);
+        if (metrics) {
+            bh_memcpy_s(metrics, sizeof(wasm_runtime_metrics_t),
+                        &block->metrics, sizeof(wasm_runtime_metrics_t));
+        }
+        if (native_calls) {
+            bh_memcpy_s(native_calls, sizeof(block->native_calls),
+                        block->native_calls, sizeof(block->native_calls));
+        }
+        os_atomic_thread_fence(os_memory_order_acquire);
+        if (BH_ATOMIC_32_LOAD(block->seq) == seq) {
+            break;
+        }
+    }
+}
+#else
+/* Without thread local storage, all threads share one block which is
+   protected by metrics_lock, as are the readers */
+#define METRICS_LOCK() os_mutex_lock(&metrics_lock)
+#define METRICS_UNLOCK() os_mutex_unlock(&metrics_lock)
+
+#define block_write_begin(block) (void)0
+#define block_write_end(block) (void)0
+
+static void
+block_read(WASMMetricsBlock *block, wasm_runtime_metrics_t *metrics,
+           WASMNativeCallEntry *native_calls)
+{
+    if (metrics) {
+        bh_memcpy_s(metrics, sizeof(wasm_runtime_metrics_t), &block->metrics,
+                    sizeof(wasm_runtime_metrics_t));
+    }
+    if (native_calls) {
+        bh_memcpy_s(native_calls, sizeof(block->native_calls),
+                    block->native_calls, sizeof(block->native_calls));
+    }
+}
+#endif
+
+bool
+wasm_runtime_metrics_init(void)
+{
+    if (os_mutex_init(&metrics_lock) != 0) {
+        return false;
+    }
+
+    metrics_blocks = NULL;
+    metrics_generation++;
+    metrics_inited = true;
+    return true;
+}
+
+void
+wasm_runtime_metrics_destroy(void)
+{
+    WASMMetricsBlock *block = metrics_blocks, *next;
+
+    metrics_inited = false;
+    while (block) {
+        next = block->next;
+        wasm_runtime_free(block->alloc_addr);
+        block = next;
+    }
+    metrics_blocks = NULL;
+
+    os_mutex_destroy(&metrics_lock);
+}
+
+static WASMMetricsBlock *
+create_block(void)
+{
+    uint32 block_size = align_uint(sizeof(WASMMetricsBlock),
+                                   METRICS_CACHE_LINE_SIZE),
+           total_size = block_size + METRICS_CACHE_LINE_SIZE;
+    WASMMetricsBlock *block;
+    void *alloc_addr;
+
+    if (!(alloc_addr = wasm_runtime_malloc(total_size))) {
+        return NULL;
+    }
+
+    block = (WASMMetricsBlock *)(((uintptr_t)alloc_addr
+                                  + METRICS_CACHE_LINE_SIZE - 1)
+                                 & ~(uintptr_t)(METRICS_CACHE_LINE_SIZE - 1));
+    memset(block, 0, block_size);
+    block->alloc_addr = alloc_addr;
+    return block;
+}
+
+static WASMMetricsBlock *
+get_thread_block(void)
+{
+    WASMMetricsBlock *block;
+
+    if (!metrics_inited) {
+        return NULL;
+    }
+
+#ifdef os_thread_local_attribute
+    if (thread_block && thread_block_generation == metrics_generation) {
+        return thread_block;
+    }
+
+    /* Reuse the block of a thread which exited, or add one */
+    os_mutex_lock(&metrics_lock);
+    for (block = metrics_blocks; block; block = block->next) {
+        if (!block->in_use)
+            break;
+    }
+    if (!block && (block = create_block())) {
+        block->next = metrics_blocks;
+        metrics_blocks = block;
+    }
+    if (block) {
+        block->in_use = true;
+    }
+    os_mutex_unlock(&metrics_lock);
+
+    if (!block) {
+        return NULL;
+    }
+
+    thread_block = block;
+    thread_block_generation = metrics_generation;
+#else
+    /* metrics_lock is held by the caller */
+    if (!(block = metrics_blocks) && (block = create_block())) {
+        block->in_use = true;
+        metrics_blocks = block;
+    }
+#endif
+    return block;
+}
+
+void
+wasm_runtime_metrics_thread_exit(void)
+{
+#ifdef os_thread_local_attribute
+    if (!metrics_inited || !thread_block
+        || thread_block_generation != metrics_generation) {
+        return;
+    }
+
+    /* Keep the counters, they are still summed up */
+    os_mutex_lock(&metrics_lock);
+    thread_block->in_use = false;
+    os_mutex_unlock(&metrics_lock);
+    thread_block = NULL;
+#endif
+}
+
+static void
+histogram_record(wasm_metrics_histogram_t *hist, uint64 time_us)
+{
+    uint64 value = time_us;
+    uint32 bucket = 0;
+
+    while (value && bucket < WASM_METRICS_HISTOGRAM_BUCKETS - 1) {
+        value >>= 1;
+        bucket++;
+    }
+
+    hist->count++;
+    hist->total_us += time_us;
+    if (time_us > hist->max_us) {
+        hist->max_us = time_us;
+    }
+    hist->buckets[bucket]++;
+}
+
+void
+wasm_runtime_metrics_record_load(bool success, uint64 time_us)
+{
+    WASMMetricsBlock *block;
+
+    METRICS_LOCK();
+    if ((block = get_thread_block())) {
+        block_write_begin(block);
+        if (success) {
+            block->metrics.module_load_count++;
+            histogram_record(&block->metrics.module_load_time, time_us);
+        }
+        else {
+            block->metrics.module_load_failures++;
+        }
+        block_write_end(block);
+    }
+    METRICS_UNLOCK();
+}
+
+void
+wasm_runtime_metrics_record_instantiate(bool success, uint64 time_us)
+{
+    WASMMetricsBlock *block;
+
+    METRICS_LOCK();
+    if ((block = get_thread_block())) {
+        block_write_begin(block);
+        if (success) {
+            block->metrics.instantiation_count++;
+            histogram_record(&block->metrics.instantiation_time, time_us);
+        }
+        else {
+            block->metrics.instantiation_failures++;
+        }
+        block_write_end(block);
+    }
+    METRICS_UNLOCK();
+}
+
+void
+wasm_runtime_metrics_record_memory_grow(bool success, uint64 inc_bytes)
+{
+    WASMMetricsBlock *block;
+
+    METRICS_LOCK();
+    if ((block = get_thread_block())) {
+        block_write_begin(block);
+        if (success) {
+            block->metrics.memory_grow_count++;
+            block->metrics.memory_grow_bytes += inc_bytes;
+        }
+        else {
+            block->metrics.memory_grow_failures++;
+        }
+        block_write_end(block);
+    }
+    METRICS_UNLOCK();
+}
+
+void
+wasm_runtime_metrics_record_exception(wasm_metrics_exception_kind_t kind)
+{
+    WASMMetricsBlock *block;
+
+    if ((uint32)kind >= WASM_METRICS_EXCE_KIND_NUM) {
+        kind = WASM_METRICS_EXCE_OTHER;
+    }
+
+    METRICS_LOCK();
+    if ((block = get_thread_block())) {
+        block_write_begin(block);
+        block->metrics.exceptions[kind]++;
+        block_write_end(block);
+    }
+    METRICS_UNLOCK();
+}
+
+void
+wasm_runtime_metrics_record_native_call(const char *module_name,
+                                        const char *field_name,
+                                        void *func_ptr)
+{
+    WASMMetricsBlock *block;
+    WASMNativeCallEntry *entry;
+    uint32 hash, i;
+
+    METRICS_LOCK();
+    if ((block = get_thread_block())) {
+        block_write_begin(block);
+        block->metrics.native_call_count++;
+
+        hash = (uint32)((uintptr_t)func_ptr >> 2) * 2654435761U;
+        for (i = 0; i < WASM_RUNTIME_METRICS_NATIVE_SYMBOLS; i++) {
+            entry = block->native_calls
+                    + (hash + i) % WASM_RUNTIME_METRICS_NATIVE_SYMBOLS;
+            if (entry->func_ptr == func_ptr) {
+                entry->metric.call_count++;
+                break;
+            }
+            if (!entry->func_ptr) {
+                entry->func_ptr = func_ptr;
+                snprintf(entry->metric.symbol, sizeof(entry->metric.symbol),
+                         "%s.%s", module_name, field_name);
+                entry->metric.call_count = 1;
+                break;
+            }
+        }
+        block_write_end(block);
+    }
+    METRICS_UNLOCK();
+}
+
+void
+wasm_runtime_metrics_record_gc_begin(void)
+{
+    WASMMetricsBlock *block;
+
+    METRICS_LOCK();
+    if ((block = get_thread_block())) {
+        block->gc_start_us = os_time_get_boot_us();
+    }
+    METRICS_UNLOCK();
+}
+
+void
+wasm_runtime_metrics_record_gc_end(void)
+{
+    WASMMetricsBlock *block;
+
+    METRICS_LOCK();
+    if ((block = get_thread_block()) && block->gc_start_us) {
+        block_write_begin(block);
+        histogram_record(&block->metrics.gc_pause_time,
+                         os_time_get_boot_us() - block->gc_start_us);
+        block_write_end(block);
+        block->gc_start_us = 0;
+    }
+    METRICS_UNLOCK();
+}
+
+static void
+histogram_add(wasm_metrics_histogram_t *dst,
+              const wasm_metrics_histogram_t *src)
+{
+    uint32 i;
+
+    dst->count += src->count;
+    dst->total_us += src->total_us;
+    if (src->max_us > dst->max_us) {
+        dst->max_us = src->max_us;
+    }
+    for (i = 0; i < WASM_METRICS_HISTOGRAM_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+}
+
+static void
+metrics_add(wasm_runtime_metrics_t *dst, const wasm_runtime_metrics_t *src)
+{
+    uint32 i;
+
+    dst->module_load_count += src->module_load_count;
+    dst->module_load_failures += src->module_load_failures;
+    histogram_add(&dst->module_load_time, &src->module_load_time);
+    dst->instantiation_count += src->instantiation_count;
+    dst->instantiation_failures += src->instantiation_failures;
+    histogram_add(&dst->instantiation_time, &src->instantiation_time);
+    dst->memory_grow_count += src->memory_grow_count;
+    dst->memory_grow_failures += src->memory_grow_failures;
+    dst->memory_grow_bytes += src->memory_grow_bytes;
+    for (i = 0; i < WASM_METRICS_EXCE_KIND_NUM; i++) {
+        dst->exceptions[i] += src->exceptions[i];
+    }
+    dst->native_call_count += src->native_call_count;
+    histogram_add(&dst->gc_pause_time, &src->gc_pause_time);
+}
+
+bool
+wasm_runtime_get_metrics(wasm_runtime_metrics_t *metrics)
+{
+    WASMMetricsBlock *block;
+    wasm_runtime_metrics_t block_metrics;
+    mem_alloc_info_t alloc_info;
+
+    if (!metrics) {
+        return false;
+    }
+
+    memset(metrics, 0, sizeof(wasm_runtime_metrics_t));
+    if (!metrics_inited) {
+        return false;
+    }
+
+    os_mutex_lock(&metrics_lock);
+    for (block = metrics_blocks; block; block = block->next) {
+        block_read(block, &block_metrics, NULL);
+        metrics_add(metrics, &block_metrics);
+        if (block->in_use)
+            metrics->thread_count++;
+    }
+    os_mutex_unlock(&metrics_lock);
+
+    if (wasm_runtime_get_mem_alloc_info(&alloc_info)) {
+        metrics->heap_highmark_size = alloc_info.highmark_size;
+    }
+    return true;
+}
+
+uint32
+wasm_runtime_get_native_call_metrics(wasm_native_call_metric_t *buf,
+                                     uint32 buf_count)
+{
+    WASMMetricsBlock *block;
+    WASMNativeCallEntry *entries = NULL, *block_entries, *entry;
+    uint64 total_size;
+    uint32 block_count = 0, entry_count = 0, i, j;
+
+    if (!metrics_inited) {
+        return 0;
+    }
+
+    os_mutex_lock(&metrics_lock);
+
+    for (block = metrics_blocks; block; block = block->next) {
+        block_count++;
+    }
+
+    /* The merged entries are followed by the copy of a block */
+    total_size = sizeof(WASMNativeCallEntry)
+                 * (uint64)WASM_RUNTIME_METRICS_NATIVE_SYMBOLS
+                 * (block_count + 1);
+    if (total_size == 0 || total_size > UINT32_MAX
+        || !(entries = wasm_runtime_malloc((uint32)total_size))) {
+        os_mutex_unlock(&metrics_lock);
+        return 0;
+    }
+
+    /* merge the entries of the same function recorded by different
+       threads */
+    block_entries =
+        entries + WASM_RUNTIME_METRICS_NATIVE_SYMBOLS * block_count;
+    for (block = metrics_blocks; block; block = block->next) {
+        block_read(block, NULL, block_entries);
+        for (i = 0; i < WASM_RUNTIME_METRICS_NATIVE_SYMBOLS; i++) {
+            entry = block_entries + i;
+            if (!entry->func_ptr) {
+                continue;
+            }
+            for (j = 0; j < entry_count; j++) {
+                if (entries[j].func_ptr == entry->func_ptr) {
+                    entries[j].metric.call_count += entry->metric.call_count;
+                    break;
+                }
+            }
+            if (j == entry_count) {
+                bh_memcpy_s(entries + entry_count, sizeof(WASMNativeCallEntry),
+                            entry, sizeof(WASMNativeCallEntry));
+                entry_count++;
+            }
+        }
+    }
+
+    os_mutex_unlock(&metrics_lock);
+
+    for (i = 0; buf && i < entry_count && i < buf_count; i++) {
+        bh_memcpy_s(buf + i, sizeof(wasm_native_call_metric_t),
+                    &entries[i].metric, sizeof(wasm_native_call_metric_t));
+    }
+
+    wasm_runtime_free(entries);
+    return entry_count;
+}
+
+void
+wasm_runtime_reset_metrics(void)
+{
+    WASMMetricsBlock *block;
+
+    if (!metrics_inited) {
+        return;
+    }
+
+    os_mutex_lock(&metrics_lock);
+    for (block = metrics_blocks; block; block = block->next) {
+        memset(&block->metrics, 0, sizeof(wasm_runtime_metrics_t));
+        memset(block->native_calls, 0, sizeof(block->native_calls));
+    }
+    os_mutex_unlock(&metrics_lock);
+}
+
+#endif /* end of WASM_ENABLE_RUNTIME_METRICS != 0 */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_RUNTIME_METRICS_H
+#define _WASM_RUNTIME_METRICS_H
+
+#include "bh_common.h"
+#include "wasm_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+
+bool
+wasm_runtime_metrics_init(void);
+
+void
+wasm_runtime_metrics_destroy(void);
+
+void
+wasm_runtime_metrics_record_load(bool success, uint64 time_us);
+
+void
+wasm_runtime_metrics_record_instantiate(bool success, uint64 time_us);
+
+void
+wasm_runtime_metrics_record_memory_grow(bool success, uint64 inc_bytes);
+
+void
+wasm_runtime_metrics_record_exception(wasm_metrics_exception_kind_t kind);
+
+void
+wasm_runtime_metrics_record_native_call(const char *module_name,
+                                        const char *field_name,
+                                        void *func_ptr);
+
+/* Called when a GC starts and finishes in the current thread */
+void
+wasm_runtime_metrics_record_gc_begin(void);
+
+void
+wasm_runtime_metrics_record_gc_end(void);
+
+/* Called before the current thread exits, so that its counters are
+   kept and recorded into by a later thread */
+void
+wasm_runtime_metrics_thread_exit(void);
+
+#endif /* end of WASM_ENABLE_RUNTIME_METRICS != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_RUNTIME_METRICS_H */
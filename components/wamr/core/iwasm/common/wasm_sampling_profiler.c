@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_sampling_profiler.h"
+#include "wasm_runtime_common.h"
+#include "bh_platform.h"
+#if WASM_ENABLE_INTERP != 0
+#include "../interpreter/wasm_runtime.h"
+#include "../interpreter/wasm_interp.h"
+#endif
+
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+
+#if WASM_SUSPEND_FLAGS_IS_ATOMIC == 0
+#error "Sampling profiler requires atomic suspend flags"
+#endif
+
+#define SAMPLE_RING_MASK (WASM_SAMPLING_PROFILER_RING_SIZE - 1)
+
+#if (WASM_SAMPLING_PROFILER_RING_SIZE & SAMPLE_RING_MASK) != 0
+#error "WASM_SAMPLING_PROFILER_RING_SIZE must be a power of two"
+#endif
+
+/* Recorded for the frames which don't belong to the module instance
+   of the sampled exec_env, e.g. functions of sub modules */
+#define SAMPLE_FUNC_IDX_UNKNOWN UINT32_MAX
+/* Set in the recorded index of import functions */
+#define SAMPLE_FUNC_IDX_IMPORT_FLAG 0x80000000
+
+typedef struct WASMStackSample {
+    /* Sequence number of the sample plus one, 0 means that the slot
+       is being written by an interpreter thread */
+    bh_atomic_32_t seq;
+    /* Number of valid entries in func_idxs */
+    uint16 depth;
+    /* Whether the call stack is deeper than
+       WASM_SAMPLING_PROFILER_MAX_DEPTH */
+    uint16 truncated;
+    /* Function indexes of the call stack, leaf function first. Defined
+       functions are indexed without the import functions, the same as
+       the "aot_func#N" symbols */
+    uint32 func_idxs[WASM_SAMPLING_PROFILER_MAX_DEPTH];
+} WASMStackSample;
+
+typedef struct WASMStackSampleCount {
+    WASMStackSample sample;
+    uint32 count;
+} WASMStackSampleCount;
+
+typedef struct WASMSamplingProfiler {
+    /* Protects all fields except head, wrapped and samples[i] */
+    korp_mutex lock;
+    korp_tid sampler_tid;
+    bool running;
+    uint32 interval_us;
+    WASMExecEnv *exec_envs[WASM_SAMPLING_PROFILER_MAX_EXEC_ENVS];
+    uint32 exec_env_count;
+    /* Lock-free ring buffer written by the interpreter threads, older
+       samples are overwritten once it is full */
+    WASMStackSample *samples;
+    /* Number of samples ever reserved since the profiler started */
+    bh_atomic_32_t head;
+    /* Set once head has wrapped around, the ring is then full even if
+       head is smaller than the ring size */
+    bh_atomic_32_t wrapped;
+} WASMSamplingProfiler;
+
+static WASMSamplingProfiler profiler;
+
+bool
+wasm_sampling_profiler_init(void)
+{
+    memset(&profiler, 0, sizeof(WASMSamplingProfiler));
+    if (os_mutex_init(&profiler.lock) != 0) {
+        return false;
+    }
+    return true;
+}
+
+void
+wasm_sampling_profiler_destroy(void)
+{
+    wasm_runtime_sampling_profiler_stop();
+
+    if (profiler.samples) {
+        wasm_runtime_free(profiler.samples);
+        profiler.samples = NULL;
+    }
+    os_mutex_destroy(&profiler.lock);
+}
+
+void
+wasm_sampling_profiler_take_sample(WASMExecEnv *exec_env)
+{
+#if WASM_ENABLE_INTERP != 0
+    WASMModuleInstance *module_inst =
+        (WASMModuleInstance *)wasm_exec_env_get_module_inst(exec_env);
+    WASMFunctionInstance *functions, *function;
+    WASMInterpFrame *frame;
+    WASMStackSample *sample;
+    uint32 idx, depth = 0, func_idx, function_count, import_function_count;
+
+    WASM_SUSPEND_FLAGS_FETCH_AND(exec_env->suspend_flags,
+                                 ~WASM_SUSPEND_FLAG_SAMPLE);
+
+    if (!profiler.samples
+        || module_inst->module_type != Wasm_Module_Bytecode) {
+        return;
+    }
+
+    functions = module_inst->e->functions;
+    function_count = module_inst->e->function_count;
+    import_function_count = module_inst->module->import_function_count;
+
+    idx = BH_ATOMIC_32_FETCH_ADD(profiler.head, 1);
+    if (idx == UINT32_MAX)
+        BH_ATOMIC_32_STORE(profiler.wrapped, 1);
+    sample = profiler.samples + (idx & SAMPLE_RING_MASK);
+    BH_ATOMIC_32_STORE(sample->seq, 0);
+
+    sample->truncated = 0;
+    for (frame = wasm_exec_env_get_cur_frame(exec_env); frame;
+         frame = frame->prev_frame) {
+        if (!(function = frame->function)) {
+            /* dummy frame created for the native caller */
+            continue;
+        }
+        if (depth == WASM_SAMPLING_PROFILER_MAX_DEPTH) {
+            sample->truncated = 1;
+            break;
+        }
+
+        if (function >= functions && function < functions + function_count) {
+            func_idx = (uint32)(function - functions);
+            if (function->is_import_func)
+                func_idx |= SAMPLE_FUNC_IDX_IMPORT_FLAG;
+            else
+                func_idx -= import_function_count;
+        }
+        else {
+            func_idx = SAMPLE_FUNC_IDX_UNKNOWN;
+        }
+        sample->func_idxs[depth++] = func_idx;
+    }
+    sample->depth = (uint16)depth;
+
+    BH_ATOMIC_32_STORE(sample->seq, idx + 1);
+#else
+    WASM_SUSPEND_FLAGS_FETCH_AND(exec_env->suspend_flags,
+                                 ~WASM_SUSPEND_FLAG_SAMPLE);
+#endif
+}
+
+static void *
+sampler_routine(void *arg)
+{
+    uint32 i, interval_us;
+
+    (void)arg;
+
+    os_mutex_lock(&profiler.lock);
+    while (profiler.running) {
+        interval_us = profiler.interval_us;
+        os_mutex_unlock(&profiler.lock);
+
+        os_usleep(interval_us);
+
+        os_mutex_lock(&profiler.lock);
+        if (!profiler.running)
+            break;
+
+        for (i = 0; i < profiler.exec_env_count; i++) {
+            WASM_SUSPEND_FLAGS_FETCH_OR(profiler.exec_envs[i]->suspend_flags,
+                                        WASM_SUSPEND_FLAG_SAMPLE);
+        }
+    }
+    os_mutex_unlock(&profiler.lock);
+
+    return NULL;
+}
+
+bool
+wasm_runtime_sampling_profiler_start(uint32 interval_us)
+{
+    uint64 total_size =
+        sizeof(WASMStackSample) * (uint64)WASM_SAMPLING_PROFILER_RING_SIZE;
+    uint32 i;
+
+    if (interval_us == 0) {
+        LOG_ERROR("Sampling profiler: invalid sampling interval");
+        return false;
+    }
+
+    os_mutex_lock(&profiler.lock);
+
+    if (profiler.running) {
+        os_mutex_unlock(&profiler.lock);
+        LOG_ERROR("Sampling profiler: already started");
+        return false;
+    }
+
+    /* The ring buffer is kept until the runtime is destroyed since
+       the interpreter threads may still be writing a sample */
+    if (!profiler.samples
+        && !(profiler.samples = wasm_runtime_malloc((uint32)total_size))) {
+        os_mutex_unlock(&profiler.lock);
+        LOG_ERROR("Sampling profiler: allocate memory failed");
+        return false;
+    }
+
+    for (i = 0; i < WASM_SAMPLING_PROFILER_RING_SIZE; i++) {
+        BH_ATOMIC_32_STORE(profiler.samples[i].seq, 0);
+    }
+    BH_ATOMIC_32_STORE(profiler.head, 0);
+    BH_ATOMIC_32_STORE(profiler.wrapped, 0);
+
+    profiler.interval_us = interval_us;
+    profiler.running = true;
+
+    if (os_thread_create(&profiler.sampler_tid, sampler_routine, NULL,
+                         WASM_SAMPLING_PROFILER_THREAD_STACK_SIZE)
+        != 0) {
+        profiler.running = false;
+        os_mutex_unlock(&profiler.lock);
+        LOG_ERROR("Sampling profiler: create sampler thread failed");
+        return false;
+    }
+
+    os_mutex_unlock(&profiler.lock);
+    return true;
+}
+
+void
+wasm_runtime_sampling_profiler_stop(void)
+{
+    korp_tid sampler_tid;
+
+    os_mutex_lock(&profiler.lock);
+    if (!profiler.running) {
+        os_mutex_unlock(&profiler.lock);
+        return;
+    }
+    profiler.running = false;
+    sampler_tid = profiler.sampler_tid;
+    os_mutex_unlock(&profiler.lock);
+
+    os_thread_join(sampler_tid, NULL);
+}
+
+bool
+wasm_runtime_sampling_profiler_attach(WASMExecEnv *exec_env)
+{
+    uint32 i;
+
+    os_mutex_lock(&profiler.lock);
+
+    for (i = 0; i < profiler.exec_env_count; i++) {
+        if (profiler.exec_envs[i] == exec_env) {
+            os_mutex_unlock(&profiler.lock);
+            return true;
+        }
+    }
+
+    if (profiler.exec_env_count == WASM_SAMPLING_PROFILER_MAX_EXEC_ENVS) {
+        os_mutex_unlock(&profiler.lock);
+        LOG_ERROR("Sampling profiler: too many exec_envs attached");
+        return false;
+    }
+
+    profiler.exec_envs[profiler.exec_env_count++] = exec_env;
+    os_mutex_unlock(&profiler.lock);
+    return true;
+}
+
+void
+wasm_runtime_sampling_profiler_detach(WASMExecEnv *exec_env)
+{
+    uint32 i;
+
+    os_mutex_lock(&profiler.lock);
+    for (i = 0; i < profiler.exec_env_count; i++) {
+        if (profiler.exec_envs[i] == exec_env) {
+            profiler.exec_envs[i] =
+                profiler.exec_envs[--profiler.exec_env_count];
+            break;
+        }
+    }
+    os_mutex_unlock(&profiler.lock);
+
+    WASM_SUSPEND_FLAGS_FETCH_AND(exec_env->suspend_flags,
+                                 ~WASM_SUSPEND_FLAG_SAMPLE);
+}
+
+void
+wasm_sampling_profiler_detach_exec_env(WASMExecEnv *exec_env)
+{
+    wasm_runtime_sampling_profiler_detach(exec_env);
+}
+
+/* Copy the samples still available in the ring buffer and merge the
+   identical call stacks, return the number of distinct call stacks */
+static uint32
+collect_stack_samples(WASMStackSampleCount *counts)
+{
+    WASMStackSample *slot, sample;
+    uint32 head, total, idx, seq, n, i, count_num = 0;
+
+    head = BH_ATOMIC_32_LOAD(profiler.head);
+    /* head is a 32-bit counter, once it wraps the whole ring is valid */
+    total = BH_ATOMIC_32_LOAD(profiler.wrapped)
+                ? WASM_SAMPLING_PROFILER_RING_SIZE
+                : head;
+    if (total > WASM_SAMPLING_PROFILER_RING_SIZE)
+        total = WASM_SAMPLING_PROFILER_RING_SIZE;
+
+    for (n = 0; n < total; n++) {
+        /* unsigned wraparound keeps idx valid when head < total */
+        idx = head - total + n;
+        slot = profiler.samples + (idx & SAMPLE_RING_MASK);
+        if ((seq = BH_ATOMIC_32_LOAD(slot->seq)) != idx + 1)
+            continue;
+
+        bh_memcpy_s(&sample, sizeof(WASMStackSample), slot,
+                    sizeof(WASMStackSample));
+        /* skip the sample if it was overwritten while copying */
+        if (BH_ATOMIC_32_LOAD(slot->seq) != seq || sample.depth == 0)
+            continue;
+
+        for (i = 0; i < count_num; i++) {
+            if (counts[i].sample.depth == sample.depth
+                && counts[i].sample.truncated == sample.truncated
+                && !memcmp(counts[i].sample.func_idxs, sample.func_idxs,
+                           sizeof(uint32) * sample.depth)) {
+                counts[i].count++;
+                break;
+            }
+        }
+        if (i == count_num) {
+            bh_memcpy_s(&counts[count_num].sample, sizeof(WASMStackSample),
+                        &sample, sizeof(WASMStackSample));
+            counts[count_num++].count = 1;
+        }
+    }
+
+    return count_num;
+}
+
+static uint32
+format_stack_sample(const WASMStackSampleCount *count, char *line_buf,
+                    uint32 line_buf_size)
+{
+    const WASMStackSample *sample = &count->sample;
+    uint32 offset = 0, func_idx, i;
+    int n;
+
+    if (sample->truncated) {
+        n = snprintf(line_buf, line_buf_size, "[truncated];");
+        offset = (uint32)n;
+    }
+
+    /* folded stacks are ordered from the root to the leaf */
+    for (i = sample->depth; i > 0 && offset < line_buf_size; i--) {
+        func_idx = sample->func_idxs[i - 1];
+        if (func_idx == SAMPLE_FUNC_IDX_UNKNOWN)
+            n = snprintf(line_buf + offset, line_buf_size - offset, "%s%s",
+                         "[unknown]", i > 1 ? ";" : "");
+        else if (func_idx & SAMPLE_FUNC_IDX_IMPORT_FLAG)
+            n = snprintf(line_buf + offset, line_buf_size - offset,
+                         "import_func#%" PRIu32 "%s",
+                         func_idx & ~SAMPLE_FUNC_IDX_IMPORT_FLAG,
+                         i > 1 ? ";" : "");
+        else
+            n = snprintf(line_buf + offset, line_buf_size - offset,
+                         "aot_func#%" PRIu32 "%s", func_idx, i > 1 ? ";" : "");
+        offset += (uint32)n;
+    }
+
+    if (offset < line_buf_size) {
+        n = snprintf(line_buf + offset, line_buf_size - offset,
+                     " %" PRIu32 "\n", count->count);
+        offset += (uint32)n;
+    }
+
+    if (offset >= line_buf_size) {
+        /* drop the line rather than emitting a broken stack */
+        line_buf[0] = '\0';
+        return 0;
+    }
+    return offset;
+}
+
+static uint32
+dump_folded_stacks(bool print, char *buf, uint32 len)
+{
+    WASMStackSampleCount *counts;
+    uint64 total_size = sizeof(WASMStackSampleCount)
+                        * (uint64)WASM_SAMPLING_PROFILER_RING_SIZE;
+    uint32 count_num, total_len = 0, i;
+    /* reserve 512 bytes for line buffer, the lines longer than that
+     * are dropped */
+    char line_buf[512];
+
+    if (!profiler.samples
+        || !(counts = wasm_runtime_malloc((uint32)total_size))) {
+        return 0;
+    }
+
+    count_num = collect_stack_samples(counts);
+
+    for (i = 0; i < count_num; i++) {
+        if (format_stack_sample(counts + i, line_buf, sizeof(line_buf)) == 0)
+            continue;
+
+        total_len +=
+            wasm_runtime_dump_line_buf_impl(line_buf, print, &buf, &len);
+        if ((!print) && buf && (len == 0)) {
+            break;
+        }
+    }
+
+    wasm_runtime_free(counts);
+    return total_len + 1;
+}
+
+void
+wasm_runtime_sampling_profiler_dump(void)
+{
+    os_mutex_lock(&profiler.lock);
+    dump_folded_stacks(true, NULL, 0);
+    os_mutex_unlock(&profiler.lock);
+}
+
+uint32
+wasm_runtime_sampling_profiler_get_buf_size(void)
+{
+    uint32 size;
+
+    os_mutex_lock(&profiler.lock);
+    size = dump_folded_stacks(false, NULL, 0);
+    os_mutex_unlock(&profiler.lock);
+    return size;
+}
+
+uint32
+wasm_runtime_sampling_profiler_dump_to_buf(char *buf, uint32 len)
+{
+    uint32 size;
+
+    if (!buf || len == 0) {
+        return 0;
+    }
+
+    os_mutex_lock(&profiler.lock);
+    size = dump_folded_stacks(false, buf, len);
+    os_mutex_unlock(&profiler.lock);
+
+    if (size > len) {
+        size = len;
+    }
+    buf[size - 1] = '\0';
+    return size;
+}
+
+#endif /* end of WASM_ENABLE_SAMPLING_PROFILER != 0 */
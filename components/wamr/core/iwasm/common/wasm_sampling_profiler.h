@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_SAMPLING_PROFILER_H
+#define _WASM_SAMPLING_PROFILER_H
+
+#include "bh_common.h"
+#include "wasm_exec_env.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+
+bool
+wasm_sampling_profiler_init(void);
+
+void
+wasm_sampling_profiler_destroy(void);
+
+/**
+ * Record the wasm call stack of exec_env into the sample ring buffer,
+ * called by the interpreter in the thread which runs exec_env once it
+ * sees WASM_SUSPEND_FLAG_SAMPLE set by the sampler thread.
+ */
+void
+wasm_sampling_profiler_take_sample(WASMExecEnv *exec_env);
+
+/**
+ * Stop sampling exec_env, called when the exec_env is destroyed
+ */
+void
+wasm_sampling_profiler_detach_exec_env(WASMExecEnv *exec_env);
+
+#endif /* end of WASM_ENABLE_SAMPLING_PROFILER != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_SAMPLING_PROFILER_H */
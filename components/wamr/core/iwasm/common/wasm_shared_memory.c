@@ -5,6 +5,9 @@
 
 #include "bh_log.h"
 #include "wasm_shared_memory.h"
+#if WASM_ENABLE_SHARED_HEAP != 0
+#include "wasm_memory.h"
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0
 #include "../libraries/thread-mgr/thread_manager.h"
 #endif
@@ -246,31 +249,6 @@ map_try_release_wait_info(HashMap *wait_hash_map, AtomicWaitInfo *wait_info,
     destroy_wait_info(wait_info);
 }
 
-#if WASM_ENABLE_SHARED_HEAP != 0
-static bool
-is_native_addr_in_shared_heap(WASMModuleInstanceCommon *module_inst,
-                              uint8 *addr, uint32 bytes)
-{
-    WASMSharedHeap *shared_heap = NULL;
-
-#if WASM_ENABLE_INTERP != 0
-    if (module_inst->module_type == Wasm_Module_Bytecode) {
-        shared_heap = ((WASMModuleInstance *)module_inst)->e->shared_heap;
-    }
-#endif
-#if WASM_ENABLE_AOT != 0
-    if (module_inst->module_type == Wasm_Module_AoT) {
-        AOTModuleInstanceExtra *e =
-            (AOTModuleInstanceExtra *)((AOTModuleInstance *)module_inst)->e;
-        shared_heap = e->shared_heap;
-    }
-#endif
-
-    return shared_heap && addr >= shared_heap->base_addr
-           && addr + bytes <= shared_heap->base_addr + shared_heap->size;
-}
-#endif
-
 uint32
 wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
                          uint64 expect, int64 timeout, bool wait64)
@@ -302,8 +280,8 @@ wasm_runtime_atomic_wait(WASMModuleInstanceCommon *module, void *address,
     if (
 #if WASM_ENABLE_SHARED_HEAP != 0
         /* not in shared heap */
-        !is_native_addr_in_shared_heap((WASMModuleInstanceCommon *)module_inst,
-                                       address, wait64 ? 8 : 4)
+        !wasm_runtime_is_native_addr_in_shared_heap(
+            (WASMModuleInstanceCommon *)module_inst, address, wait64 ? 8 : 4)
         &&
 #endif
         /* and not in linear memory */
@@ -435,7 +413,7 @@ wasm_runtime_atomic_notify(WASMModuleInstanceCommon *module, void *address,
     out_of_bounds =
 #if WASM_ENABLE_SHARED_HEAP != 0
         /* not in shared heap */
-        !is_native_addr_in_shared_heap(module, address, 4) &&
+        !wasm_runtime_is_native_addr_in_shared_heap(module, address, 4) &&
 #endif
         /* and not in linear memory */
         ((uint8 *)address < module_inst->memories[0]->memory_data
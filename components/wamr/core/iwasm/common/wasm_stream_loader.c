@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_runtime_common.h"
+#include "bh_platform.h"
+#if WASM_ENABLE_INTERP != 0
+#include "../interpreter/wasm.h"
+#endif
+
+#if WASM_ENABLE_STREAM_LOADER != 0
+
+typedef enum StreamLoadStage {
+    STREAM_LOAD_HEADER = 0,
+    STREAM_LOAD_SECTION_ID,
+    STREAM_LOAD_SECTION_SIZE,
+    STREAM_LOAD_SECTION_BODY,
+    STREAM_LOAD_FAILED,
+} StreamLoadStage;
+
+/**
+ * The chunked loader splits the pushed bytes into sections and keeps
+ * each section in its own buffer, so that there is no buffer holding the
+ * whole wasm file. The magic header, the section ids, the section order
+ * and the section sizes are checked as soon as the bytes arrive, while the
+ * section contents are only decoded when the loading is finished.
+ */
+struct WASMStreamLoader {
+    LoadArgs args;
+    StreamLoadStage stage;
+    uint8 header[8];
+    uint32 header_size;
+
+    uint8 section_type;
+    uint8 last_section_index;
+    uint32 section_size;
+    uint32 section_size_shift;
+    uint32 section_received;
+    /* the section being received, NULL if it is skipped */
+    WASMSection *section;
+
+    WASMSection *section_list;
+    WASMSection *section_list_end;
+};
+
+/* clang-format off */
+static uint8 section_ids[] = {
+    SECTION_TYPE_USER,
+    SECTION_TYPE_TYPE,
+    SECTION_TYPE_IMPORT,
+    SECTION_TYPE_FUNC,
+    SECTION_TYPE_TABLE,
+    SECTION_TYPE_MEMORY,
+#if WASM_ENABLE_TAGS != 0
+    SECTION_TYPE_TAG,
+#endif
+#if WASM_ENABLE_STRINGREF != 0
+    SECTION_TYPE_STRINGREF,
+#endif
+    SECTION_TYPE_GLOBAL,
+    SECTION_TYPE_EXPORT,
+    SECTION_TYPE_START,
+    SECTION_TYPE_ELEM,
+#if WASM_ENABLE_BULK_MEMORY != 0
+    SECTION_TYPE_DATACOUNT,
+#endif
+    SECTION_TYPE_CODE,
+    SECTION_TYPE_DATA
+};
+/* clang-format on */
+
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL) {
+        snprintf(error_buf, error_buf_size, "WASM module load failed: %s",
+                 string);
+    }
+}
+
+static uint8
+get_section_index(uint8 section_type)
+{
+    uint8 i;
+
+    for (i = 0; i < sizeof(section_ids) / sizeof(uint8); i++) {
+        if (section_type == section_ids[i])
+            return i;
+    }
+
+    return (uint8)-1;
+}
+
+static void
+destroy_sections(WASMSection *section_list)
+{
+    WASMSection *section = section_list, *next;
+
+    while (section) {
+        next = section->next;
+        wasm_runtime_free(section);
+        section = next;
+    }
+}
+
+wasm_stream_loader_t
+wasm_runtime_stream_load_create(const LoadArgs *args, char *error_buf,
+                                uint32 error_buf_size)
+{
+    wasm_stream_loader_t loader;
+
+    if (!args) {
+        set_error_buf(error_buf, error_buf_size, "null load arguments");
+        return NULL;
+    }
+
+    if (!(loader = wasm_runtime_malloc(sizeof(struct WASMStreamLoader)))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+
+    memset(loader, 0, sizeof(struct WASMStreamLoader));
+    bh_memcpy_s(&loader->args, sizeof(LoadArgs), args, sizeof(LoadArgs));
+    loader->stage = STREAM_LOAD_HEADER;
+    loader->last_section_index = (uint8)-1;
+    return loader;
+}
+
+void
+wasm_runtime_stream_load_destroy(wasm_stream_loader_t loader)
+{
+    if (!loader)
+        return;
+
+    if (loader->section)
+        wasm_runtime_free(loader->section);
+    destroy_sections(loader->section_list);
+    wasm_runtime_free(loader);
+}
+
+static bool
+check_header(wasm_stream_loader_t loader, char *error_buf,
+             uint32 error_buf_size)
+{
+    static const uint8 wasm_magic[4] = { 0x00, 'a', 's', 'm' };
+    static const uint8 aot_magic[4] = { 0x00, 'a', 'o', 't' };
+    uint32 version = loader->header[4] | (loader->header[5] << 8)
+                     | (loader->header[6] << 16)
+                     | ((uint32)loader->header[7] << 24);
+
+    if (!memcmp(loader->header, aot_magic, 4)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "AOT file can't be loaded from a stream");
+        return false;
+    }
+    if (memcmp(loader->header, wasm_magic, 4)) {
+        set_error_buf(error_buf, error_buf_size, "magic header not detected");
+        return false;
+    }
+    if (version != WASM_CURRENT_VERSION) {
+        set_error_buf(error_buf, error_buf_size, "unknown binary version");
+        return false;
+    }
+    return true;
+}
+
+static bool
+begin_section(wasm_stream_loader_t loader, char *error_buf,
+              uint32 error_buf_size)
+{
+    uint64 total_size;
+    bool keep_section = true;
+
+    if (loader->section_type == SECTION_TYPE_USER) {
+        /* Only the name section is kept, the loaded custom sections would
+           refer to the section buffers which are freed after loading */
+#if WASM_ENABLE_CUSTOM_NAME_SECTION == 0 || WASM_ENABLE_LOAD_CUSTOM_SECTION != 0
+        keep_section = false;
+#endif
+    }
+
+    loader->section = NULL;
+    loader->section_received = 0;
+
+    if (keep_section) {
+        total_size = sizeof(WASMSection) + (uint64)loader->section_size;
+        if (total_size > UINT32_MAX
+            || !(loader->section = wasm_runtime_malloc((uint32)total_size))) {
+            set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+            return false;
+        }
+        memset(loader->section, 0, sizeof(WASMSection));
+        loader->section->section_type = loader->section_type;
+        loader->section->section_body = (uint8 *)(loader->section + 1);
+        loader->section->section_body_size = loader->section_size;
+    }
+    return true;
+}
+
+static bool
+is_name_section(const WASMSection *section)
+{
+    const uint8 *p = section->section_body;
+    uint32 size = section->section_body_size;
+
+    /* a custom section starts with its name, the length of "name" is
+       encoded in one byte */
+    return size >= 5 && p[0] == 4 && !memcmp(p + 1, "name", 4);
+}
+
+static void
+end_section(wasm_stream_loader_t loader)
+{
+    WASMSection *section = loader->section;
+
+    loader->section = NULL;
+    if (!section)
+        return;
+
+    if (section->section_type == SECTION_TYPE_USER
+        && !is_name_section(section)) {
+        wasm_runtime_free(section);
+        return;
+    }
+
+    if (!loader->section_list_end)
+        loader->section_list = loader->section_list_end = section;
+    else {
+        loader->section_list_end->next = section;
+        loader->section_list_end = section;
+    }
+}
+
+bool
+wasm_runtime_stream_load_feed(wasm_stream_loader_t loader, const uint8 *buf,
+                              uint32 size, char *error_buf,
+                              uint32 error_buf_size)
+{
+    const uint8 *p = buf, *p_end = buf + size;
+    uint8 byte, section_index;
+    uint32 n;
+
+    if (!loader || (!buf && size > 0)) {
+        set_error_buf(error_buf, error_buf_size, "invalid stream loader");
+        return false;
+    }
+
+    while (p < p_end) {
+        switch (loader->stage) {
+            case STREAM_LOAD_HEADER:
+                n = (uint32)sizeof(loader->header) - loader->header_size;
+                if (n > (uint32)(p_end - p))
+                    n = (uint32)(p_end - p);
+                bh_memcpy_s(loader->header + loader->header_size, n, p, n);
+                loader->header_size += n;
+                p += n;
+                if (loader->header_size == sizeof(loader->header)) {
+                    if (!check_header(loader, error_buf, error_buf_size))
+                        goto fail;
+                    loader->stage = STREAM_LOAD_SECTION_ID;
+                }
+                break;
+
+            case STREAM_LOAD_SECTION_ID:
+                loader->section_type = *p++;
+                section_index = get_section_index(loader->section_type);
+                if (section_index == (uint8)-1) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "invalid section id");
+                    goto fail;
+                }
+                if (loader->section_type != SECTION_TYPE_USER) {
+                    /* Custom sections may be inserted at any place,
+                       while other sections must occur at most once
+                       and in prescribed order. */
+                    if (loader->last_section_index != (uint8)-1
+                        && section_index <= loader->last_section_index) {
+                        set_error_buf(error_buf, error_buf_size,
+                                      "unexpected content after last "
+                                      "section or junk after last section");
+                        goto fail;
+                    }
+                    loader->last_section_index = section_index;
+                }
+                loader->section_size = 0;
+                loader->section_size_shift = 0;
+                loader->stage = STREAM_LOAD_SECTION_SIZE;
+                break;
+
+            case STREAM_LOAD_SECTION_SIZE:
+                byte = *p++;
+                if (loader->section_size_shift == 28 && (byte & 0xF0)) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "integer representation too long");
+                    goto fail;
+                }
+                loader->section_size |= (uint32)(byte & 0x7F)
+                                        << loader->section_size_shift;
+                loader->section_size_shift += 7;
+                if (byte & 0x80)
+                    break;
+
+                if (!begin_section(loader, error_buf, error_buf_size))
+                    goto fail;
+                if (loader->section_size > 0) {
+                    loader->stage = STREAM_LOAD_SECTION_BODY;
+                }
+                else {
+                    end_section(loader);
+                    loader->stage = STREAM_LOAD_SECTION_ID;
+                }
+                break;
+
+            case STREAM_LOAD_SECTION_BODY:
+                n = loader->section_size - loader->section_received;
+                if (n > (uint32)(p_end - p))
+                    n = (uint32)(p_end - p);
+                if (loader->section)
+                    bh_memcpy_s(loader->section->section_body
+                                    + loader->section_received,
+                                n, p, n);
+                loader->section_received += n;
+                p += n;
+                if (loader->section_received == loader->section_size) {
+                    end_section(loader);
+                    loader->stage = STREAM_LOAD_SECTION_ID;
+                }
+                break;
+
+            default:
+                set_error_buf(error_buf, error_buf_size,
+                              "stream loader already failed");
+                return false;
+        }
+    }
+
+    return true;
+fail:
+    loader->stage = STREAM_LOAD_FAILED;
+    return false;
+}
+
+wasm_module_t
+wasm_runtime_stream_load_finish(wasm_stream_loader_t loader, char *error_buf,
+                                uint32 error_buf_size)
+{
+    WASMModuleCommon *module = NULL;
+
+    if (!loader) {
+        set_error_buf(error_buf, error_buf_size, "invalid stream loader");
+        return NULL;
+    }
+
+    if (loader->stage == STREAM_LOAD_FAILED) {
+        set_error_buf(error_buf, error_buf_size,
+                      "stream loader already failed");
+    }
+    else if (loader->stage != STREAM_LOAD_SECTION_ID) {
+        set_error_buf(error_buf, error_buf_size, "unexpected end");
+    }
+    else {
+        module = wasm_runtime_load_from_streamed_sections(
+            loader->section_list, &loader->args, error_buf, error_buf_size);
+    }
+
+    wasm_runtime_stream_load_destroy(loader);
+    return module;
+}
+
+#endif /* end of WASM_ENABLE_STREAM_LOADER != 0 */
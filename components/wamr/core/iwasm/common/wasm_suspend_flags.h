@@ -22,6 +22,8 @@ extern "C" {
 #define WASM_SUSPEND_FLAG_EXIT 0x8
 /* The thread might be blocking */
 #define WASM_SUSPEND_FLAG_BLOCKING 0x10
+/* Need to record a sample of the call stack */
+#define WASM_SUSPEND_FLAG_SAMPLE 0x20
 
 typedef union WASMSuspendFlags {
     bh_atomic_32_t flags;
@@ -35,7 +37,8 @@ typedef union WASMSuspendFlags {
 #define WASM_SUSPEND_FLAGS_FETCH_AND(s_flags, val) \
     BH_ATOMIC_32_FETCH_AND(s_flags.flags, val)
 
-#define WASM_SUSPEND_FLAG_INHERIT_MASK (~WASM_SUSPEND_FLAG_BLOCKING)
+#define WASM_SUSPEND_FLAG_INHERIT_MASK \
+    (~(WASM_SUSPEND_FLAG_BLOCKING | WASM_SUSPEND_FLAG_SAMPLE))
 
 #if WASM_SUSPEND_FLAGS_IS_ATOMIC != 0
 #define WASM_SUSPEND_FLAGS_LOCK(lock) (void)0
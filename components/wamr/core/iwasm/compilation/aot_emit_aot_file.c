@@ -5,6 +5,7 @@
 
 #include "aot_emit_aot_file.h"
 #include "../aot/aot_runtime.h"
+#include "aot_stack_frame.h"
 
 #define PUT_U64_TO_ADDR(addr, value)        \
     do {                                    \
@@ -69,6 +70,20 @@ typedef struct AOTObjectData {
     void *literal;
     uint32 literal_size;
 
+    /* read-only data sections only referenced PC-relatively by the text
+       in indirect mode, which are appended to the text section with their
+       relocations applied at compile time, so that the text can be
+       executed in place without being patched by the loader */
+    AOTObjectDataSection *text_rodata_sections;
+    uint32 *text_rodata_offsets;
+    uint32 text_rodata_section_count;
+    uint32 text_rodata_size;
+    /* relocation->symbol_index is the index of the appended section */
+    AOTRelocation *text_rodata_relocations;
+    uint32 text_rodata_relocation_count;
+    /* zeros emitted as literal to align the text in the AOT file */
+    uint32 text_padding;
+
     AOTObjectDataSection *data_sections;
     uint32 data_sections_count;
 
@@ -82,6 +97,17 @@ typedef struct AOTObjectData {
     const char *stack_sizes_section_name;
     uint32 stack_sizes_offset;
     uint32 *stack_sizes;
+    /* max stack size of the precheck functions */
+    uint32 precheck_stack_size;
+
+    /* stack usage of each function and of the call graph, which is
+       emitted to AOT_CUSTOM_SECTION_STACK_USAGE */
+    uint32 stack_usage_flags;
+    uint32 max_call_depth;
+    uint32 max_native_stack_size;
+    uint32 max_wasm_stack_size;
+    uint32 *native_stack_sizes;
+    uint32 *wasm_frame_sizes;
 } AOTObjectData;
 
 #if 0
@@ -795,15 +821,49 @@ get_init_data_section_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
     return size;
 }
 
+/* Alignment of the read-only data appended to the text section, and of
+   the text itself in the AOT file when there is some */
+#define AOT_TEXT_RODATA_ALIGN 64
+
 static uint32
-get_text_section_size(AOTObjectData *obj_data)
+get_text_code_size(AOTObjectData *obj_data)
 {
-    return sizeof(uint32) + align_uint(obj_data->literal_size, 4)
-           + align_uint(obj_data->text_size, 4)
+    return align_uint(obj_data->text_size, 4)
            + align_uint(obj_data->text_unlikely_size, 4)
            + align_uint(obj_data->text_hot_size, 4);
 }
 
+/* offset of the appended read-only data from the start of the text */
+static uint32
+get_text_rodata_offset(AOTObjectData *obj_data)
+{
+    return align_uint(get_text_code_size(obj_data), AOT_TEXT_RODATA_ALIGN);
+}
+
+/* offset is the offset of the text section body in the AOT file */
+static uint32
+get_text_padding(AOTObjectData *obj_data, uint32 offset)
+{
+    /* skip literal size */
+    offset += (uint32)sizeof(uint32);
+    if (obj_data->text_rodata_size == 0)
+        return 0;
+    return align_uint(offset, AOT_TEXT_RODATA_ALIGN) - offset;
+}
+
+static uint32
+get_text_section_size(AOTObjectData *obj_data)
+{
+    uint32 size = get_text_code_size(obj_data);
+
+    if (obj_data->text_rodata_size > 0)
+        size = get_text_rodata_offset(obj_data)
+               + align_uint(obj_data->text_rodata_size, 4);
+
+    return sizeof(uint32) + align_uint(obj_data->literal_size, 4)
+           + obj_data->text_padding + size;
+}
+
 static uint32
 get_func_section_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
                       AOTObjectData *obj_data)
@@ -1190,6 +1250,9 @@ get_string_literal_section_size(AOTCompContext *comp_ctx,
 static uint32
 get_custom_sections_size(AOTCompContext *comp_ctx, AOTCompData *comp_data);
 
+static uint32
+get_stack_usage_section_size(AOTObjectData *obj_data);
+
 uint32
 aot_get_aot_file_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
                       AOTObjectData *obj_data)
@@ -1219,6 +1282,7 @@ aot_get_aot_file_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
     size = align_uint(size, 4);
     /* section id + section size */
     size += (uint32)sizeof(uint32) * 2;
+    obj_data->text_padding = get_text_padding(obj_data, size);
     size += get_text_section_size(obj_data);
 
     /* function section */
@@ -1265,6 +1329,13 @@ aot_get_aot_file_size(AOTCompContext *comp_ctx, AOTCompData *comp_data,
     }
 #endif
 
+    if (get_stack_usage_section_size(obj_data) > 0) {
+        size = align_uint(size, 4);
+        /* section id + section size + sub section id */
+        size += (uint32)sizeof(uint32) * 3;
+        size += get_stack_usage_section_size(obj_data);
+    }
+
     return size;
 }
 
@@ -1640,6 +1711,17 @@ get_string_literal_section_size(AOTCompContext *comp_ctx,
 }
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
 
+static uint32
+get_stack_usage_section_size(AOTObjectData *obj_data)
+{
+    if (!obj_data->native_stack_sizes)
+        return 0;
+
+    /* flags + max call depth + max native stack size + max wasm stack
+       size + function count + stack sizes of each function */
+    return (uint32)sizeof(uint32) * (5 + obj_data->func_count * 2);
+}
+
 static uint32
 get_custom_sections_size(AOTCompContext *comp_ctx, AOTCompData *comp_data)
 {
@@ -2428,7 +2510,7 @@ static bool
 aot_emit_text_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
                       AOTCompData *comp_data, AOTObjectData *obj_data)
 {
-    uint32 section_size = get_text_section_size(obj_data);
+    uint32 section_size;
     uint32 offset = *p_offset;
     uint8 placeholder = 0;
     AOTRelocationGroup *relocation_group;
@@ -2438,15 +2520,21 @@ aot_emit_text_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
 
     *p_offset = offset = align_uint(offset, 4);
 
+    obj_data->text_padding =
+        get_text_padding(obj_data, offset + (uint32)sizeof(uint32) * 2);
+    section_size = get_text_section_size(obj_data);
+
     EMIT_U32(AOT_SECTION_TYPE_TEXT);
     EMIT_U32(section_size);
-    EMIT_U32(obj_data->literal_size);
+    EMIT_U32(obj_data->literal_size + obj_data->text_padding);
 
     if (obj_data->literal_size > 0) {
         EMIT_BUF(obj_data->literal, obj_data->literal_size);
         while (offset & 3)
             EMIT_BUF(&placeholder, 1);
     }
+    for (i = 0; i < obj_data->text_padding; i++)
+        EMIT_BUF(&placeholder, 1);
 
     text = buf + offset;
 
@@ -2466,6 +2554,43 @@ aot_emit_text_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
             EMIT_BUF(&placeholder, 1);
     }
 
+    if (obj_data->text_rodata_size > 0) {
+        uint32 rodata_offset = get_text_rodata_offset(obj_data);
+
+        for (i = 0; i < obj_data->text_rodata_section_count; i++) {
+            AOTObjectDataSection *data_section =
+                obj_data->text_rodata_sections + i;
+
+            while (buf + offset
+                   < text + rodata_offset + obj_data->text_rodata_offsets[i])
+                EMIT_BUF(&placeholder, 1);
+            EMIT_BUF(data_section->data, data_section->size);
+        }
+        while (offset & 3)
+            EMIT_BUF(&placeholder, 1);
+
+        /* apply the R_X86_64_PC32/PLT32 relocations: S + A - P */
+        relocation = obj_data->text_rodata_relocations;
+        for (i = 0; i < obj_data->text_rodata_relocation_count;
+             i++, relocation++) {
+            int64 value =
+                (int64)rodata_offset
+                + obj_data->text_rodata_offsets[relocation->symbol_index]
+                + relocation->relocation_addend
+                - (int64)relocation->relocation_offset;
+
+            if (relocation->relocation_offset + sizeof(int32)
+                    > get_text_code_size(obj_data)
+                || value < INT32_MIN || value > INT32_MAX) {
+                aot_set_last_error("invalid relocation to read-only data.");
+                return false;
+            }
+            for (j = 0; j < sizeof(int32); j++)
+                text[relocation->relocation_offset + j] =
+                    (uint8)((uint64)value >> (j * 8));
+        }
+    }
+
     if (offset - *p_offset != section_size + sizeof(uint32) * 2) {
         aot_set_last_error("emit text section failed.");
         return false;
@@ -2896,6 +3021,40 @@ aot_emit_string_literal_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
 }
 #endif /* end of WASM_ENABLE_STRINGREF != 0 */
 
+static bool
+aot_emit_stack_usage_section(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
+                             AOTObjectData *obj_data)
+{
+    uint32 offset = *p_offset, i;
+
+    if (get_stack_usage_section_size(obj_data) == 0)
+        return true;
+
+    offset = align_uint(offset, 4);
+
+    EMIT_U32(AOT_SECTION_TYPE_CUSTOM);
+    /* sub section id + stack usage section size */
+    EMIT_U32(sizeof(uint32) * 1 + get_stack_usage_section_size(obj_data));
+    EMIT_U32(AOT_CUSTOM_SECTION_STACK_USAGE);
+
+    EMIT_U32(obj_data->stack_usage_flags);
+    EMIT_U32(obj_data->max_call_depth);
+    EMIT_U32(obj_data->max_native_stack_size);
+    EMIT_U32(obj_data->max_wasm_stack_size);
+    EMIT_U32(obj_data->func_count);
+
+    for (i = 0; i < obj_data->func_count; i++)
+        EMIT_U32(obj_data->native_stack_sizes[i]);
+
+    for (i = 0; i < obj_data->func_count; i++)
+        EMIT_U32(obj_data->wasm_frame_sizes[i]);
+
+    *p_offset = offset;
+
+    LOG_DEBUG("emit stack usage section");
+    return true;
+}
+
 static bool
 aot_emit_custom_sections(uint8 *buf, uint8 *buf_end, uint32 *p_offset,
                          AOTCompData *comp_data, AOTCompContext *comp_ctx)
@@ -3371,7 +3530,8 @@ aot_resolve_object_data_sections(AOTObjectData *obj_data)
 
 static bool
 read_stack_usage_file(const AOTCompContext *comp_ctx, const char *filename,
-                      uint32 *sizes, uint32 count)
+                      uint32 *sizes, uint32 count,
+                      uint32 *p_precheck_stack_size)
 {
     FILE *fp = NULL;
     if (filename == NULL) {
@@ -3505,6 +3665,7 @@ read_stack_usage_file(const AOTCompContext *comp_ctx, const char *filename,
                     "WASM_STACK_GUARD_SIZE.",
                     precheck_stack_size_max);
     }
+    *p_precheck_stack_size = precheck_stack_size_max;
     return true;
 fail:
     if (fp != NULL)
@@ -3590,7 +3751,8 @@ aot_resolve_stack_sizes(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
                 stack_sizes[i] = (uint32)-1;
             }
             if (!read_stack_usage_file(comp_ctx, comp_ctx->stack_usage_file,
-                                       stack_sizes, obj_data->func_count)) {
+                                       stack_sizes, obj_data->func_count,
+                                       &obj_data->precheck_stack_size)) {
                 goto fail;
             }
             for (i = 0; i < obj_data->func_count; i++) {
@@ -3666,6 +3828,324 @@ fail:
     return false;
 }
 
+static uint32
+get_wasm_frame_size(const AOTCompContext *comp_ctx, uint32 cell_num)
+{
+    uint32 frame_header_size =
+        comp_ctx->pointer_size
+        * (uint32)(offsetof(AOTFrame, lp) / sizeof(uintptr_t));
+
+    /* Refer to aot_alloc_tiny_frame and aot_alloc_standard_frame */
+    if (comp_ctx->aux_stack_frame_type == AOT_STACK_FRAME_TYPE_TINY)
+        return (uint32)sizeof(AOTTinyFrame);
+    else if (!comp_ctx->enable_gc)
+        return frame_header_size + cell_num * 4;
+    else
+        return frame_header_size + align_uint(cell_num * 5, 4);
+}
+
+static uint32
+add_stack_size(uint32 size1, uint32 size2)
+{
+    return size1 > UINT32_MAX - size2 ? UINT32_MAX : size1 + size2;
+}
+
+typedef struct StackUsageNode {
+    /* max call depth and stack sizes of the call paths from the node */
+    uint32 depth;
+    uint32 native_stack_size;
+    uint32 wasm_stack_size;
+} StackUsageNode;
+
+typedef struct StackUsageFrame {
+    uint32 node;
+    /* the position to look for the next callee */
+    uint32 pos;
+    /* max of the callees visited */
+    StackUsageNode max;
+} StackUsageFrame;
+
+enum {
+    STACK_USAGE_NODE_UNVISITED = 0,
+    STACK_USAGE_NODE_VISITING,
+    STACK_USAGE_NODE_VISITED,
+};
+
+static void
+merge_stack_usage(StackUsageNode *max, const StackUsageNode *node)
+{
+    if (max->depth < node->depth)
+        max->depth = node->depth;
+    if (max->native_stack_size < node->native_stack_size)
+        max->native_stack_size = node->native_stack_size;
+    if (max->wasm_stack_size < node->wasm_stack_size)
+        max->wasm_stack_size = node->wasm_stack_size;
+}
+
+/**
+ * Get the next callee of a node of the call graph. The nodes are the
+ * functions, imported ones first, followed by the function types. A type
+ * node stands for the call_indirect and call_ref opcodes of the type, and
+ * calls all the functions of the type.
+ */
+static bool
+get_next_callee(const AOTCompContext *comp_ctx,
+                const uint32 *func_type_indexes, StackUsageFrame *frame,
+                uint32 *p_callee, bool *p_unknown)
+{
+    const AOTCompData *comp_data = comp_ctx->comp_data;
+    uint32 total_func_count =
+        comp_data->import_func_count + comp_data->func_count;
+
+    if (frame->node < comp_data->import_func_count)
+        return false;
+
+    if (frame->node < total_func_count) {
+        const AOTFuncContext *func_ctx =
+            comp_ctx->func_ctxes[frame->node - comp_data->import_func_count];
+
+        while (frame->pos < func_ctx->callee_count) {
+            const AOTCallee *callee = func_ctx->callees + frame->pos++;
+
+            if (!callee->is_indirect) {
+                *p_callee = callee->index;
+                return true;
+            }
+            if (comp_ctx->enable_gc) {
+                /* the function called may be of any subtype */
+                *p_unknown = true;
+                continue;
+            }
+            /* the type index was converted to the smallest equivalent one */
+            *p_callee = total_func_count + callee->index;
+            return true;
+        }
+        return false;
+    }
+
+    while (frame->pos < total_func_count) {
+        uint32 func_idx = frame->pos++;
+
+        if (func_type_indexes[func_idx] != UINT32_MAX
+            && total_func_count + func_type_indexes[func_idx] == frame->node) {
+            *p_callee = func_idx;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Compute the stack usage of each function, and the max call depth and
+ * stack sizes of the call graph with a depth-first traversal. The call
+ * graph is bounded if it has no cycles, i.e. no recursion.
+ */
+static bool
+aot_resolve_stack_usage(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+{
+    const AOTCompData *comp_data = comp_ctx->comp_data;
+    uint32 import_func_count = comp_data->import_func_count;
+    uint32 total_func_count = import_func_count + comp_data->func_count;
+    uint32 node_count = total_func_count + comp_data->type_count;
+    uint32 *func_type_indexes = NULL;
+    StackUsageNode *nodes = NULL, max_usage = { 0 };
+    StackUsageFrame *frames = NULL;
+    uint8 *states = NULL;
+    bool musttail = aot_target_precheck_can_use_musttail(comp_ctx);
+    bool recursive = false, unknown = false, table_shared, ret = false;
+    uint32 i, frame_count;
+    uint64 size;
+
+    size = sizeof(uint32) * (uint64)obj_data->func_count;
+    if (size >= UINT32_MAX
+        || !(obj_data->native_stack_sizes = wasm_runtime_malloc((uint32)size))
+        || !(obj_data->wasm_frame_sizes = wasm_runtime_malloc((uint32)size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    for (i = 0; i < obj_data->func_count; i++) {
+        AOTFunc *func = comp_data->funcs[i];
+        uint32 native_stack_size = 0;
+
+        /* the native stack usage is known only if the stack bounds
+           checks or the stack estimation is enabled */
+        if (obj_data->stack_sizes) {
+            native_stack_size = obj_data->stack_sizes[i];
+            /* the frame of the precheck function is kept during the call
+               unless it tail-calls the function */
+            if (!musttail)
+                native_stack_size = add_stack_size(
+                    native_stack_size, obj_data->precheck_stack_size);
+        }
+        obj_data->native_stack_sizes[i] = native_stack_size;
+        obj_data->wasm_frame_sizes[i] = get_wasm_frame_size(
+            comp_ctx, func->param_cell_num + func->local_cell_num
+                          + func->max_stack_cell_num);
+    }
+
+    size = sizeof(StackUsageFrame) * (uint64)node_count;
+    if (node_count == 0 || size >= UINT32_MAX
+        || !(func_type_indexes = wasm_runtime_malloc(
+                 (uint32)sizeof(uint32) * node_count))
+        || !(nodes = wasm_runtime_malloc((uint32)sizeof(StackUsageNode)
+                                         * node_count))
+        || !(frames = wasm_runtime_malloc((uint32)size))
+        || !(states = wasm_runtime_malloc(node_count))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+    memset(nodes, 0, sizeof(StackUsageNode) * node_count);
+    memset(states, STACK_USAGE_NODE_UNVISITED, node_count);
+
+    /* only the functions which can be put into a table are called
+       indirectly, they are marked with their type indexes */
+    for (i = 0; i < total_func_count; i++)
+        func_type_indexes[i] = UINT32_MAX;
+
+    for (i = 0; i < comp_data->table_init_data_count; i++) {
+        AOTTableInitData *init_data = comp_data->table_init_data_list[i];
+        uint32 j;
+
+        for (j = 0; j < init_data->value_count; j++) {
+            InitializerExpression *init_expr = init_data->init_values + j;
+
+            if (init_expr->init_expr_type == INIT_EXPR_TYPE_FUNCREF_CONST
+                && init_expr->u.ref_index < total_func_count)
+                func_type_indexes[init_expr->u.ref_index] = 0;
+        }
+    }
+
+    /* the host can put the exported functions into an exported or
+       imported table */
+    table_shared = comp_data->import_table_count > 0;
+    for (i = 0; i < comp_data->wasm_module->export_count; i++) {
+        if (comp_data->wasm_module->exports[i].kind == EXPORT_KIND_TABLE)
+            table_shared = true;
+    }
+    if (table_shared) {
+        for (i = 0; i < comp_data->wasm_module->export_count; i++) {
+            WASMExport *export = comp_data->wasm_module->exports + i;
+
+            if (export->kind == EXPORT_KIND_FUNC
+                && export->index < total_func_count)
+                func_type_indexes[export->index] = 0;
+        }
+    }
+
+    for (i = 0; i < total_func_count; i++) {
+        uint32 type_idx;
+
+        if (func_type_indexes[i] == UINT32_MAX)
+            continue;
+
+        type_idx =
+            i < import_func_count
+                ? comp_data->import_funcs[i].func_type_index
+                : comp_data->funcs[i - import_func_count]->func_type_index;
+        if (!comp_ctx->enable_gc)
+            type_idx = wasm_get_smallest_type_idx(
+                (WASMTypePtr *)comp_data->types, comp_data->type_count,
+                type_idx);
+        func_type_indexes[i] = type_idx;
+    }
+
+    /* an imported function is a leaf, whose native stack usage is
+       covered by the stack guard */
+    for (i = 0; i < import_func_count; i++) {
+        /* Refer to aot_alloc_standard_frame */
+        AOTFuncType *func_type = comp_data->import_funcs[i].func_type;
+        uint32 cell_num =
+            func_type->param_cell_num > 2 ? func_type->param_cell_num : 2;
+
+        nodes[i].depth = 1;
+        nodes[i].wasm_stack_size = get_wasm_frame_size(comp_ctx, cell_num);
+        states[i] = STACK_USAGE_NODE_VISITED;
+    }
+
+    for (i = import_func_count; i < total_func_count; i++) {
+        if (states[i] == STACK_USAGE_NODE_UNVISITED) {
+            memset(frames, 0, sizeof(StackUsageFrame));
+            frames[0].node = i;
+            frame_count = 1;
+            states[i] = STACK_USAGE_NODE_VISITING;
+        }
+        else {
+            frame_count = 0;
+        }
+
+        while (frame_count > 0) {
+            StackUsageFrame *frame = frames + frame_count - 1;
+            StackUsageNode *node;
+            uint32 callee;
+
+            if (get_next_callee(comp_ctx, func_type_indexes, frame, &callee,
+                                &unknown)) {
+                if (states[callee] == STACK_USAGE_NODE_VISITING) {
+                    recursive = true;
+                }
+                else if (states[callee] == STACK_USAGE_NODE_UNVISITED) {
+                    memset(frames + frame_count, 0, sizeof(StackUsageFrame));
+                    frames[frame_count++].node = callee;
+                    states[callee] = STACK_USAGE_NODE_VISITING;
+                }
+                else {
+                    merge_stack_usage(&frame->max, nodes + callee);
+                }
+                continue;
+            }
+
+            /* all the callees were visited, add the node itself */
+            node = nodes + frame->node;
+            *node = frame->max;
+            if (frame->node < total_func_count) {
+                uint32 func_idx = frame->node - import_func_count;
+
+                node->depth = add_stack_size(node->depth, 1);
+                node->native_stack_size =
+                    add_stack_size(node->native_stack_size,
+                                   obj_data->native_stack_sizes[func_idx]);
+                node->wasm_stack_size =
+                    add_stack_size(node->wasm_stack_size,
+                                   obj_data->wasm_frame_sizes[func_idx]);
+            }
+            states[frame->node] = STACK_USAGE_NODE_VISITED;
+
+            if (--frame_count > 0)
+                merge_stack_usage(&frames[frame_count - 1].max, node);
+        }
+
+        merge_stack_usage(&max_usage, nodes + i);
+    }
+
+    obj_data->stack_usage_flags = 0;
+    if (obj_data->stack_sizes)
+        obj_data->stack_usage_flags |= AOT_STACK_USAGE_FLAG_NATIVE;
+    if (recursive || unknown)
+        obj_data->stack_usage_flags |= AOT_STACK_USAGE_FLAG_UNBOUNDED;
+    obj_data->max_call_depth = max_usage.depth;
+    obj_data->max_native_stack_size = max_usage.native_stack_size;
+    obj_data->max_wasm_stack_size = max_usage.wasm_stack_size;
+
+    LOG_VERBOSE("stack usage: %s, depth %" PRIu32 ", native %" PRIu32
+                ", wasm %" PRIu32,
+                recursive ? "recursive" : (unknown ? "unknown" : "bounded"),
+                max_usage.depth, max_usage.native_stack_size,
+                max_usage.wasm_stack_size);
+    ret = true;
+
+fail:
+    if (func_type_indexes)
+        wasm_runtime_free(func_type_indexes);
+    if (nodes)
+        wasm_runtime_free(nodes);
+    if (frames)
+        wasm_runtime_free(frames);
+    if (states)
+        wasm_runtime_free(states);
+    return ret;
+}
+
 static bool
 aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
 {
@@ -3681,6 +4161,9 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
              || comp_ctx->enable_stack_estimation)
             && !aot_resolve_stack_sizes(comp_ctx, obj_data))
             return false;
+        if (comp_ctx->emit_stack_usage
+            && !aot_resolve_stack_usage(comp_ctx, obj_data))
+            return false;
         total_size = (uint32)sizeof(AOTObjectFunc) * obj_data->func_count;
         if (!(obj_data->funcs = wasm_runtime_malloc(total_size))) {
             aot_set_last_error("allocate memory for functions failed.");
@@ -4186,19 +4669,6 @@ aot_resolve_object_relocation_groups(AOTObjectData *obj_data)
                 relocation_group->section_name = ".rel.ltext";
             }
 
-            /*
-             * Relocations in read-only sections are problematic,
-             * especially for XIP on platforms which don't have
-             * copy-on-write mappings.
-             */
-            if (obj_data->comp_ctx->is_indirect_mode
-                && is_readonly_section(relocation_group->section_name)) {
-                LOG_WARNING("%" PRIu32
-                            " text relocations in %s section for indirect mode",
-                            relocation_group->relocation_count,
-                            relocation_group->section_name);
-            }
-
             relocation_group++;
         }
         LLVMMoveToNextSection(sec_itr);
@@ -4208,6 +4678,192 @@ aot_resolve_object_relocation_groups(AOTObjectData *obj_data)
     return true;
 }
 
+/* The relocation types of x86-64 which are PC-relative */
+#define R_X86_64_PC32 2
+#define R_X86_64_PLT32 4
+
+static bool
+is_text_relocation_group(const AOTRelocationGroup *group)
+{
+    return !strcmp(group->section_name, ".rela.text")
+           || !strcmp(group->section_name, ".rela.ltext");
+}
+
+/* Whether a read-only data section can be appended to the text section:
+   it has no relocations itself and is only referenced PC-relatively by
+   the text, so that the distance between them is fixed */
+static bool
+can_append_rodata_to_text(AOTObjectData *obj_data, const char *name)
+{
+    AOTRelocationGroup *group = obj_data->relocation_groups;
+    AOTRelocation *relocation;
+    uint32 i, j;
+
+    if (!str_starts_with(name, ".rodata"))
+        return false;
+
+    for (i = 0; i < obj_data->relocation_group_count; i++, group++) {
+        if (str_starts_with(group->section_name, ".rela")
+            && !strcmp(group->section_name + strlen(".rela"), name))
+            return false;
+
+        relocation = group->relocations;
+        for (j = 0; j < group->relocation_count; j++, relocation++) {
+            if (strcmp(relocation->symbol_name, name))
+                continue;
+            if (!is_text_relocation_group(group)
+                || (relocation->relocation_type != R_X86_64_PC32
+                    && relocation->relocation_type != R_X86_64_PLT32))
+                return false;
+        }
+    }
+    return true;
+}
+
+static int32
+get_text_rodata_section_index(AOTObjectData *obj_data, const char *name)
+{
+    uint32 i;
+
+    for (i = 0; i < obj_data->text_rodata_section_count; i++) {
+        if (!strcmp(obj_data->text_rodata_sections[i].name, name))
+            return (int32)i;
+    }
+    return -1;
+}
+
+/* In indirect (XIP) mode, append the read-only data referenced by the
+   text to the text section and resolve the relocations to it, instead of
+   leaving them to the loader, which would have to patch the text. Only
+   done for x86-64 ELF, whose constant pool references are PC-relative. */
+static bool
+aot_resolve_text_rodata(AOTObjectData *obj_data)
+{
+    AOTObjectDataSection *data_section;
+    AOTRelocationGroup *group;
+    AOTRelocation *relocation;
+    uint32 i, j, count, rodata_size = 0, relocation_count = 0;
+    uint64 size;
+    int32 index;
+
+#if WASM_ENABLE_DEBUG_AOT != 0
+    /* the whole object file is emitted as text */
+    return true;
+#endif
+
+    if (!obj_data->comp_ctx->is_indirect_mode
+        || strcmp(obj_data->comp_ctx->target_arch, "x86_64")
+        || is_32bit_binary(obj_data) || !is_little_endian_binary(obj_data)
+        || obj_data->target_info.bin_type == AOT_COFF64_BIN_TYPE
+        || obj_data->literal_size > 0 || obj_data->data_sections_count == 0)
+        return true;
+
+    size = sizeof(AOTObjectDataSection) * (uint64)obj_data->data_sections_count;
+    if (!(obj_data->text_rodata_sections = wasm_runtime_malloc((uint32)size))
+        || !(obj_data->text_rodata_offsets = wasm_runtime_malloc(
+                 sizeof(uint32) * obj_data->data_sections_count))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    /* move the sections which can be appended out of the data sections */
+    data_section = obj_data->data_sections;
+    for (i = 0, count = 0; i < obj_data->data_sections_count; i++) {
+        if (can_append_rodata_to_text(obj_data, data_section[i].name)) {
+            j = obj_data->text_rodata_section_count++;
+            obj_data->text_rodata_sections[j] = data_section[i];
+            obj_data->text_rodata_offsets[j] =
+                align_uint(rodata_size, AOT_TEXT_RODATA_ALIGN);
+            rodata_size =
+                obj_data->text_rodata_offsets[j] + data_section[i].size;
+        }
+        else {
+            data_section[count++] = data_section[i];
+        }
+    }
+    obj_data->data_sections_count = count;
+    obj_data->text_rodata_size = rodata_size;
+
+    if (obj_data->text_rodata_section_count == 0)
+        return true;
+
+    group = obj_data->relocation_groups;
+    for (i = 0; i < obj_data->relocation_group_count; i++, group++) {
+        relocation = group->relocations;
+        for (j = 0; j < group->relocation_count; j++, relocation++) {
+            if (get_text_rodata_section_index(obj_data, relocation->symbol_name)
+                >= 0)
+                relocation_count++;
+        }
+    }
+
+    if (relocation_count > 0
+        && !(obj_data->text_rodata_relocations = wasm_runtime_malloc(
+                 (uint32)sizeof(AOTRelocation) * relocation_count))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    /* move the relocations to the appended sections out of their groups,
+       and remove the groups left empty */
+    group = obj_data->relocation_groups;
+    for (i = 0, count = 0; i < obj_data->relocation_group_count; i++) {
+        AOTRelocation *relocations = group[i].relocations;
+        uint32 n = 0;
+
+        for (j = 0; j < group[i].relocation_count; j++) {
+            index = get_text_rodata_section_index(obj_data,
+                                                  relocations[j].symbol_name);
+            if (index >= 0) {
+                relocation = obj_data->text_rodata_relocations
+                             + obj_data->text_rodata_relocation_count++;
+                *relocation = relocations[j];
+                relocation->symbol_index = (uint32)index;
+            }
+            else {
+                relocations[n++] = relocations[j];
+            }
+        }
+        group[i].relocation_count = n;
+
+        if (n > 0) {
+            group[count++] = group[i];
+        }
+        else {
+            wasm_runtime_free(relocations);
+            if (group[i].is_section_name_allocated)
+                wasm_runtime_free(group[i].section_name);
+        }
+    }
+    obj_data->relocation_group_count = count;
+
+    LOG_VERBOSE("%" PRIu32 " read-only data sections and %" PRIu32
+                " relocations to them are resolved into the text section",
+                obj_data->text_rodata_section_count,
+                obj_data->text_rodata_relocation_count);
+    return true;
+}
+
+/* Relocations in read-only sections are problematic, especially for XIP
+   on platforms which don't have copy-on-write mappings */
+static void
+warn_text_relocations(AOTObjectData *obj_data)
+{
+    AOTRelocationGroup *group = obj_data->relocation_groups;
+    uint32 i;
+
+    if (!obj_data->comp_ctx->is_indirect_mode)
+        return;
+
+    for (i = 0; i < obj_data->relocation_group_count; i++, group++) {
+        if (is_readonly_section(group->section_name)) {
+            LOG_WARNING("%" PRIu32
+                        " text relocations in %s section for indirect mode",
+                        group->relocation_count, group->section_name);
+        }
+    }
+}
+
 static void
 destroy_relocation_groups(AOTRelocationGroup *relocation_groups,
                           uint32 relocation_group_count)
@@ -4271,8 +4927,18 @@ aot_obj_data_destroy(AOTObjectData *obj_data)
                                   obj_data->relocation_group_count);
     if (obj_data->symbol_list.len)
         destroy_relocation_symbol_list(&obj_data->symbol_list);
+    if (obj_data->text_rodata_sections)
+        wasm_runtime_free(obj_data->text_rodata_sections);
+    if (obj_data->text_rodata_offsets)
+        wasm_runtime_free(obj_data->text_rodata_offsets);
+    if (obj_data->text_rodata_relocations)
+        wasm_runtime_free(obj_data->text_rodata_relocations);
     if (obj_data->stack_sizes)
         wasm_runtime_free(obj_data->stack_sizes);
+    if (obj_data->native_stack_sizes)
+        wasm_runtime_free(obj_data->native_stack_sizes);
+    if (obj_data->wasm_frame_sizes)
+        wasm_runtime_free(obj_data->wasm_frame_sizes);
     wasm_runtime_free(obj_data);
 }
 
@@ -4421,6 +5087,9 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     if (comp_ctx->enable_gc) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_GARBAGE_COLLECTION;
     }
+    if (comp_ctx->enable_gc_write_barrier) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_GC_WRITE_BARRIER;
+    }
     if (comp_ctx->aux_stack_frame_type == AOT_STACK_FRAME_TYPE_TINY) {
         obj_data->target_info.feature_flags |= WASM_FEATURE_TINY_STACK_FRAME;
     }
@@ -4438,9 +5107,12 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
         || !aot_resolve_text(obj_data) || !aot_resolve_literal(obj_data)
         || !aot_resolve_object_data_sections(obj_data)
         || !aot_resolve_functions(comp_ctx, obj_data)
-        || !aot_resolve_object_relocation_groups(obj_data))
+        || !aot_resolve_object_relocation_groups(obj_data)
+        || !aot_resolve_text_rodata(obj_data))
         goto fail;
 
+    warn_text_relocations(obj_data);
+
     return obj_data;
 
 fail:
@@ -4514,7 +5186,7 @@ aot_emit_aot_file_buf_ex(AOTCompContext *comp_ctx, AOTCompData *comp_data,
         || !aot_emit_string_literal_section(buf, buf_end, &offset, comp_data,
                                             comp_ctx)
 #endif
-    )
+        || !aot_emit_stack_usage_section(buf, buf_end, &offset, obj_data))
         return false;
 
 #if 0
@@ -1436,6 +1436,8 @@ aot_compile_op_call(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     }
     aot_estimate_and_record_stack_usage_for_function_call(comp_ctx, func_ctx,
                                                           func_type);
+    if (!aot_record_callee(comp_ctx, func_ctx, func_idx, false))
+        return false;
 
     /* Commit stack operands, sp and ip */
     if (comp_ctx->aot_frame) {
@@ -2138,6 +2140,8 @@ aot_compile_op_call_indirect(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     func_type = (AOTFuncType *)comp_ctx->comp_data->types[type_idx];
     aot_estimate_and_record_stack_usage_for_function_call(comp_ctx, func_ctx,
                                                           func_type);
+    if (!aot_record_callee(comp_ctx, func_ctx, type_idx, true))
+        return false;
     /* Commit stack operands, sp and ip */
     if (comp_ctx->aot_frame) {
         if (comp_ctx->enable_gc && !aot_gen_commit_values(comp_ctx->aot_frame))
@@ -2866,6 +2870,8 @@ aot_compile_op_call_ref(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     func_type = (AOTFuncType *)comp_ctx->comp_data->types[type_idx];
     aot_estimate_and_record_stack_usage_for_function_call(comp_ctx, func_ctx,
                                                           func_type);
+    if (!aot_record_callee(comp_ctx, func_ctx, type_idx, true))
+        return false;
     func_param_count = func_type->param_count;
     func_result_count = func_type->result_count;
     param_cell_num = func_type->param_cell_num;
@@ -347,10 +347,54 @@ get_struct_field_data_types(const AOTCompContext *comp_ctx, uint8 field_type,
     *p_trunc_or_extend = trunc_or_extend;
 }
 
+/* Load the reference which is going to be overwritten and pass it to
+   wasm_obj_write_barrier() with the new one, so that the incremental GC
+   keeps the old one alive and the generational GC remembers the object */
 static bool
-aot_struct_obj_set_field(AOTCompContext *comp_ctx, LLVMValueRef struct_obj,
-                         LLVMValueRef field_offset, LLVMValueRef field_value,
-                         uint8 field_type)
+aot_call_gc_write_barrier(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                          LLVMValueRef obj, LLVMValueRef ref_ptr,
+                          LLVMValueRef new_ref)
+{
+    LLVMValueRef param_values[3], func, value, old_ref;
+    LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
+
+    if (!(old_ref = LLVMBuildLoad2(comp_ctx->builder, GC_REF_TYPE, ref_ptr,
+                                   "old_ref"))) {
+        aot_set_last_error("llvm build load failed.");
+        goto fail;
+    }
+
+    if (!is_target_x86(comp_ctx)) {
+        LLVMSetAlignment(old_ref, 4);
+    }
+
+    param_types[0] = GC_REF_TYPE;
+    param_types[1] = GC_REF_TYPE;
+    param_types[2] = GC_REF_TYPE;
+    ret_type = VOID_TYPE;
+
+    GET_AOT_FUNCTION(wasm_obj_write_barrier, 3);
+
+    /* Call function wasm_obj_write_barrier() */
+    param_values[0] = obj;
+    param_values[1] = old_ref;
+    param_values[2] = new_ref;
+    if (!LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values, 3,
+                        "")) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+static bool
+aot_struct_obj_set_field(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                         LLVMValueRef struct_obj, LLVMValueRef field_offset,
+                         LLVMValueRef field_value, uint8 field_type,
+                         bool write_barrier)
 {
     bool trunc = false;
     LLVMValueRef field_data_ptr, res;
@@ -391,6 +435,12 @@ aot_struct_obj_set_field(AOTCompContext *comp_ctx, LLVMValueRef struct_obj,
         goto fail;
     }
 
+    if (write_barrier && comp_ctx->enable_gc_write_barrier
+        && wasm_is_type_reftype(field_type)
+        && !aot_call_gc_write_barrier(comp_ctx, func_ctx, struct_obj,
+                                      field_data_ptr, field_value))
+        goto fail;
+
     if (!(res =
               LLVMBuildStore(comp_ctx->builder, field_value, field_data_ptr))) {
         aot_set_last_error("llvm build store failed.");
@@ -516,9 +566,9 @@ struct_new_canon_init_fields(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             bh_assert(0);
         }
 
-        if (!aot_struct_obj_set_field(comp_ctx, struct_obj,
+        if (!aot_struct_obj_set_field(comp_ctx, func_ctx, struct_obj,
                                       I32_CONST(field_offset), field_value,
-                                      field_type))
+                                      field_type, false))
             goto fail;
     }
 
@@ -703,8 +753,9 @@ aot_compile_op_struct_set(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                             check_struct_obj_succ))
         goto fail;
 
-    if (!aot_struct_obj_set_field(comp_ctx, struct_obj, I32_CONST(field_offset),
-                                  field_value, field_type))
+    if (!aot_struct_obj_set_field(comp_ctx, func_ctx, struct_obj,
+                                  I32_CONST(field_offset), field_value,
+                                  field_type, true))
         goto fail;
 
     return true;
@@ -838,7 +889,8 @@ fail:
 static bool
 aot_array_obj_set_elem(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                        LLVMValueRef array_obj, LLVMValueRef elem_idx,
-                       LLVMValueRef array_elem, uint8 array_elem_type)
+                       LLVMValueRef array_elem, uint8 array_elem_type,
+                       bool write_barrier)
 {
     bool trunc = false;
     LLVMValueRef elem_data_ptr, res;
@@ -903,6 +955,12 @@ aot_array_obj_set_elem(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
+    if (write_barrier && comp_ctx->enable_gc_write_barrier
+        && wasm_is_type_reftype(array_elem_type)
+        && !aot_call_gc_write_barrier(comp_ctx, func_ctx, array_obj,
+                                      elem_data_ptr, array_elem))
+        goto fail;
+
     if (!(res = LLVMBuildStore(comp_ctx->builder, array_elem, elem_data_ptr))) {
         aot_set_last_error("llvm build store failed.");
         goto fail;
@@ -1222,7 +1280,7 @@ aot_compile_op_array_new(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             }
 
             if (!aot_array_obj_set_elem(comp_ctx, func_ctx, array_obj, elem_idx,
-                                        array_elem, array_elem_type))
+                                        array_elem, array_elem_type, false))
                 goto fail;
         }
     }
@@ -1441,7 +1499,7 @@ aot_compile_op_array_set(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     SET_BUILDER_POS(check_boundary_succ);
     if (!aot_array_obj_set_elem(comp_ctx, func_ctx, array_obj, elem_idx,
-                                array_elem, array_elem_type)) {
+                                array_elem, array_elem_type, true)) {
         aot_set_last_error("llvm build alloca failed.");
         goto fail;
     }
@@ -1576,7 +1634,7 @@ aot_compile_op_array_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     SET_BUILDER_POS(fill_loop_body);
 
     if (!aot_array_obj_set_elem(comp_ctx, func_ctx, array_obj, loop_counter_val,
-                                fill_value, array_elem_type))
+                                fill_value, array_elem_type, true))
         goto fail;
 
     if (!(loop_counter_val = LLVMBuildAdd(comp_ctx->builder, loop_counter_val,
@@ -111,6 +111,177 @@ ffs(int n)
 static LLVMValueRef
 get_memory_curr_page_count(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx);
 
+/*
+ * Check whether [offset, offset + bytes_minus_one] is inside the range of
+ * the shared heap segment accessed last, and if not, call the runtime to
+ * look it up in the shared heap chain, which also updates the range cached
+ * in the module instance. Branch to block_in_shared_heap if the range is
+ * found, and to block_not_found otherwise. Both offset and bytes_minus_one
+ * are of the pointer size of the target. The range is read through a
+ * single pointer so that the fields of two ranges are never mixed when
+ * another thread switches the cached segment, and *p_range is set to the
+ * range found, which is a phi at the beginning of block_in_shared_heap.
+ */
+static bool
+build_shared_heap_lookup(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                         LLVMValueRef offset, LLVMValueRef bytes_minus_one,
+                         LLVMBasicBlockRef block_in_shared_heap,
+                         LLVMBasicBlockRef block_not_found,
+                         LLVMValueRef *p_range)
+{
+    LLVMBasicBlockRef block_curr = LLVMGetInsertBlock(comp_ctx->builder);
+    LLVMBasicBlockRef block_lookup;
+    LLVMTypeRef offset_type = (comp_ctx->pointer_size == sizeof(uint64))
+                                  ? I64_TYPE
+                                  : I32_TYPE;
+    LLVMValueRef range, range_phi, field_offset, field_p;
+    LLVMValueRef cur_start_off, cur_end_off, max_bytes, cmp1, cmp2, cmp3, cmp;
+    LLVMValueRef bytes, one, param_values[3], ret_value, func, value;
+    LLVMTypeRef param_types[3], ret_type, func_type, func_ptr_type;
+
+    if (!(range = LLVMBuildLoad2(comp_ctx->builder, INT8_PTR_TYPE,
+                                 func_ctx->shared_heap_cur_range_p,
+                                 "cur_range"))) {
+        aot_set_last_error("llvm build load failed.");
+        goto fail;
+    }
+
+    /* Load range->start_off and range->end_off */
+    if (!(field_p = LLVMBuildBitCast(comp_ctx->builder, range,
+                                     LLVMPointerType(offset_type, 0),
+                                     "cur_start_off_p"))
+        || !(cur_start_off = LLVMBuildLoad2(comp_ctx->builder, offset_type,
+                                            field_p, "cur_start_off"))) {
+        aot_set_last_error("llvm build load failed.");
+        goto fail;
+    }
+    field_offset = I32_CONST(offsetof(WASMSharedHeapRange, end_off));
+    CHECK_LLVM_CONST(field_offset);
+    if (!(field_p = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, range,
+                                          &field_offset, 1, "cur_end_off_p"))
+        || !(field_p = LLVMBuildBitCast(comp_ctx->builder, field_p,
+                                        LLVMPointerType(offset_type, 0),
+                                        "cur_end_off_p"))
+        || !(cur_end_off = LLVMBuildLoad2(comp_ctx->builder, offset_type,
+                                          field_p, "cur_end_off"))) {
+        aot_set_last_error("llvm build load failed.");
+        goto fail;
+    }
+
+    /* cur_start_off <= offset <= cur_end_off and
+       bytes - 1 <= cur_end_off - offset */
+    BUILD_ICMP(LLVMIntUGE, offset, cur_start_off, cmp1, "cmp_cur_start");
+    BUILD_ICMP(LLVMIntULE, offset, cur_end_off, cmp2, "cmp_cur_end");
+    BUILD_OP(Sub, cur_end_off, offset, max_bytes, "max_bytes");
+    BUILD_ICMP(LLVMIntULE, bytes_minus_one, max_bytes, cmp3, "cmp_bytes");
+    BUILD_OP(And, cmp1, cmp2, cmp, "cmp_cur_range");
+    BUILD_OP(And, cmp, cmp3, cmp, "is_in_cur_shared_heap");
+
+    ADD_BASIC_BLOCK(block_lookup, "shared_heap_lookup");
+    LLVMMoveBasicBlockAfter(block_lookup, block_curr);
+
+    if (!LLVMBuildCondBr(comp_ctx->builder, cmp, block_in_shared_heap,
+                         block_lookup)) {
+        aot_set_last_error("llvm build cond br failed.");
+        goto fail;
+    }
+
+    SET_BUILD_POS(block_lookup);
+
+    if (comp_ctx->pointer_size == sizeof(uint64)) {
+        one = I64_CONST(1);
+    }
+    else {
+        one = I32_ONE;
+    }
+    CHECK_LLVM_CONST(one);
+    /* bytes is 0 for a zero-length access, which the runtime checks
+       as a one-byte access */
+    BUILD_OP(Add, bytes_minus_one, one, bytes, "bytes");
+
+    if (comp_ctx->pointer_size == sizeof(uint32)) {
+        if (!(offset = LLVMBuildZExt(comp_ctx->builder, offset, I64_TYPE,
+                                     "offset_i64"))
+            || !(bytes = LLVMBuildZExt(comp_ctx->builder, bytes, I64_TYPE,
+                                       "bytes_i64"))) {
+            aot_set_last_error("llvm build zero extend failed.");
+            goto fail;
+        }
+    }
+
+    param_types[0] = INT8_PTR_TYPE;
+    param_types[1] = I64_TYPE;
+    param_types[2] = I64_TYPE;
+    ret_type = INT8_PTR_TYPE;
+
+    if (comp_ctx->is_jit_mode)
+        GET_AOT_FUNCTION(llvm_jit_update_last_used_shared_heap, 3);
+    else
+        GET_AOT_FUNCTION(aot_update_last_used_shared_heap, 3);
+
+    /* Call function aot_update_last_used_shared_heap(), which returns
+       the range found, or NULL */
+    param_values[0] = func_ctx->aot_inst;
+    param_values[1] = offset;
+    param_values[2] = bytes;
+    if (!(ret_value = LLVMBuildCall2(comp_ctx->builder, func_type, func,
+                                     param_values, 3, "call"))) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    if (!(cmp = LLVMBuildIsNotNull(comp_ctx->builder, ret_value,
+                                   "is_in_shared_heap_chain"))) {
+        aot_set_last_error("llvm build is not null failed.");
+        goto fail;
+    }
+    block_lookup = LLVMGetInsertBlock(comp_ctx->builder);
+    if (!LLVMBuildCondBr(comp_ctx->builder, cmp, block_in_shared_heap,
+                         block_not_found)) {
+        aot_set_last_error("llvm build cond br failed.");
+        goto fail;
+    }
+
+    /* The range checked, or the one returned by the runtime */
+    LLVMPositionBuilderAtEnd(comp_ctx->builder, block_in_shared_heap);
+    if (!(range_phi =
+              LLVMBuildPhi(comp_ctx->builder, INT8_PTR_TYPE, "range_phi"))) {
+        aot_set_last_error("llvm build phi failed.");
+        goto fail;
+    }
+    LLVMAddIncoming(range_phi, &range, &block_curr, 1);
+    LLVMAddIncoming(range_phi, &ret_value, &block_lookup, 1);
+    *p_range = range_phi;
+    return true;
+fail:
+    return false;
+}
+
+/* Load range->base_addr_adj, the range is found by the lookup above */
+static LLVMValueRef
+build_shared_heap_base_addr_adj(AOTCompContext *comp_ctx, LLVMValueRef range)
+{
+    LLVMValueRef field_offset, field_p, base_addr_adj;
+
+    field_offset = I32_CONST(offsetof(WASMSharedHeapRange, base_addr_adj));
+    CHECK_LLVM_CONST(field_offset);
+    if (!(field_p = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE, range,
+                                          &field_offset, 1,
+                                          "shared_heap_base_addr_adj_p"))
+        || !(field_p = LLVMBuildBitCast(comp_ctx->builder, field_p,
+                                        LLVMPointerType(INT8_PTR_TYPE, 0),
+                                        "shared_heap_base_addr_adj_p"))
+        || !(base_addr_adj =
+                 LLVMBuildLoad2(comp_ctx->builder, INT8_PTR_TYPE, field_p,
+                                "shared_heap_base_addr_adj"))) {
+        aot_set_last_error("llvm build load failed");
+        return NULL;
+    }
+    return base_addr_adj;
+fail:
+    return NULL;
+}
+
 LLVMValueRef
 aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                           mem_offset_t offset, uint32 bytes, bool enable_segue,
@@ -293,7 +464,9 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     if (comp_ctx->enable_shared_heap /* TODO: && mem_idx == 0 */) {
         LLVMBasicBlockRef app_addr_in_shared_heap, app_addr_in_linear_mem;
-        LLVMValueRef is_in_shared_heap, shared_heap_check_bound = NULL;
+        LLVMBasicBlockRef check_shared_heap;
+        LLVMValueRef is_in_shared_heap, bytes_minus_one;
+        LLVMValueRef shared_heap_range, shared_heap_base_addr_adj;
 
         /* Add basic blocks */
         ADD_BASIC_BLOCK(app_addr_in_shared_heap, "app_addr_in_shared_heap");
@@ -332,52 +505,48 @@ aot_check_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
             SET_BUILD_POS(check_integer_overflow_end);
         }
 
-        shared_heap_check_bound =
-            is_memory64 ? I64_CONST(UINT64_MAX - bytes + 1)
-                        : (comp_ctx->pointer_size == sizeof(uint64)
-                               ? I64_CONST(UINT32_MAX - bytes + 1)
-                               : I32_CONST(UINT32_MAX - bytes + 1));
-        CHECK_LLVM_CONST(shared_heap_check_bound);
-
-        /* Check whether the bytes to access are in shared heap */
-        if (!comp_ctx->enable_bound_check) {
-            /* Use IntUGT but not IntUGE to compare, since (1) in the ems
-               memory allocator, the hmu node includes hmu header and hmu
-               memory, only the latter is returned to the caller as the
-               allocated memory, the hmu header isn't returned so the
-               first byte of the shared heap won't be accesed, (2) using
-               IntUGT gets better performance than IntUGE in some cases */
-            BUILD_ICMP(LLVMIntUGT, offset1, func_ctx->shared_heap_start_off,
-                       is_in_shared_heap, "is_in_shared_heap");
-            /* We don't check the shared heap's upper boundary if boundary
-               check isn't enabled, the runtime may also use the guard pages
-               of shared heap to check the boundary if hardware boundary
-               check feature is enabled. */
-        }
-        else {
-            /* Use IntUGT but not IntUGE to compare, same as above */
-            BUILD_ICMP(LLVMIntUGT, offset1, func_ctx->shared_heap_start_off,
-                       cmp1, "cmp1");
-            /* Check the shared heap's upper boundary if boundary check is
-               enabled */
-            BUILD_ICMP(LLVMIntULE, offset1, shared_heap_check_bound, cmp2,
-                       "cmp2");
-            BUILD_OP(And, cmp1, cmp2, is_in_shared_heap, "is_in_shared_heap");
-        }
+        /* Check whether the bytes to access may be in the shared heap
+           chain. Use IntUGT but not IntUGE to compare, since (1) in the
+           shared heap allocator, each block includes a block header, only
+           the memory after it is returned to the caller, so the first
+           byte of the shared heap chain won't be accessed, (2) using
+           IntUGT gets better performance than IntUGE in some cases */
+        BUILD_ICMP(LLVMIntUGT, offset1, func_ctx->shared_heap_start_off,
+                   is_in_shared_heap, "is_in_shared_heap");
+
+        ADD_BASIC_BLOCK(check_shared_heap, "check_shared_heap");
+        LLVMMoveBasicBlockAfter(check_shared_heap, block_curr);
 
         if (!LLVMBuildCondBr(comp_ctx->builder, is_in_shared_heap,
-                             app_addr_in_shared_heap, app_addr_in_linear_mem)) {
+                             check_shared_heap, app_addr_in_linear_mem)) {
             aot_set_last_error("llvm build cond br failed");
             goto fail;
         }
 
-        LLVMPositionBuilderAtEnd(comp_ctx->builder, app_addr_in_shared_heap);
+        /* Check the range of the shared heap segment accessed last, and
+           look up the whole chain if it misses. The range is always
+           checked, since the segments of a chain are not adjacent and the
+           uncommitted part of a heap is not accessible. */
+        SET_BUILD_POS(check_shared_heap);
+        bytes_minus_one = (comp_ctx->pointer_size == sizeof(uint64))
+                              ? I64_CONST((uint64)bytes - 1)
+                              : I32_CONST(bytes - 1);
+        CHECK_LLVM_CONST(bytes_minus_one);
+        if (!build_shared_heap_lookup(comp_ctx, func_ctx, offset1,
+                                      bytes_minus_one, app_addr_in_shared_heap,
+                                      app_addr_in_linear_mem,
+                                      &shared_heap_range)) {
+            goto fail;
+        }
 
         /* Get native address inside shared heap */
-        if (!(maddr =
-                  LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
-                                        func_ctx->shared_heap_base_addr_adj,
-                                        &offset1, 1, "maddr_shared_heap"))) {
+        if (!(shared_heap_base_addr_adj = build_shared_heap_base_addr_adj(
+                  comp_ctx, shared_heap_range))) {
+            goto fail;
+        }
+        if (!(maddr = LLVMBuildInBoundsGEP2(
+                  comp_ctx->builder, INT8_TYPE, shared_heap_base_addr_adj,
+                  &offset1, 1, "maddr_shared_heap"))) {
             aot_set_last_error("llvm build inbounds gep failed");
             goto fail;
         }
@@ -1249,8 +1418,10 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     if (comp_ctx->enable_shared_heap /* TODO: && mem_idx == 0 */) {
         LLVMBasicBlockRef app_addr_in_shared_heap, app_addr_in_linear_mem;
-        LLVMValueRef shared_heap_start_off, shared_heap_check_bound;
-        LLVMValueRef max_offset, cmp1, cmp2, is_in_shared_heap;
+        LLVMBasicBlockRef check_shared_heap;
+        LLVMValueRef shared_heap_start_off, shared_heap_base_addr_adj;
+        LLVMValueRef bytes_minus_one, offset_p, is_in_shared_heap;
+        LLVMValueRef shared_heap_range;
 
         /* Add basic blocks */
         ADD_BASIC_BLOCK(app_addr_in_shared_heap, "app_addr_in_shared_heap");
@@ -1271,6 +1442,7 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
         LLVMPositionBuilderAtEnd(comp_ctx->builder, block_curr);
 
+        /* offset and max_addr have been extended to i64 */
         shared_heap_start_off = func_ctx->shared_heap_start_off;
         if (comp_ctx->pointer_size == sizeof(uint32)) {
             if (!(shared_heap_start_off =
@@ -1280,38 +1452,56 @@ check_bulk_memory_overflow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                 goto fail;
             }
         }
-        shared_heap_check_bound =
-            is_memory64 ? I64_CONST(UINT64_MAX) : I64_CONST(UINT32_MAX);
-        CHECK_LLVM_CONST(shared_heap_check_bound);
 
-        /* Check whether the bytes to access are in shared heap */
-        if (!comp_ctx->enable_bound_check) {
-            /* Use IntUGT but not IntUGE to compare, same as the check
-               in aot_check_memory_overflow */
-            BUILD_ICMP(LLVMIntUGT, offset, func_ctx->shared_heap_start_off,
-                       is_in_shared_heap, "is_in_shared_heap");
-        }
-        else {
-            BUILD_ICMP(LLVMIntUGT, offset, func_ctx->shared_heap_start_off,
-                       cmp1, "cmp1");
-            BUILD_OP(Add, max_addr, I64_NEG_ONE, max_offset, "max_offset");
-            BUILD_ICMP(LLVMIntULE, max_offset, shared_heap_check_bound, cmp2,
-                       "cmp2");
-            BUILD_OP(And, cmp1, cmp2, is_in_shared_heap, "is_in_shared_heap");
-        }
+        /* Use IntUGT but not IntUGE to compare, same as the check
+           in aot_check_memory_overflow */
+        BUILD_ICMP(LLVMIntUGT, offset, shared_heap_start_off,
+                   is_in_shared_heap, "is_in_shared_heap");
+
+        ADD_BASIC_BLOCK(check_shared_heap, "check_shared_heap");
+        LLVMMoveBasicBlockAfter(check_shared_heap, block_curr);
 
         if (!LLVMBuildCondBr(comp_ctx->builder, is_in_shared_heap,
-                             app_addr_in_shared_heap, app_addr_in_linear_mem)) {
+                             check_shared_heap, app_addr_in_linear_mem)) {
             aot_set_last_error("llvm build cond br failed");
             goto fail;
         }
 
-        LLVMPositionBuilderAtEnd(comp_ctx->builder, app_addr_in_shared_heap);
+        SET_BUILD_POS(check_shared_heap);
+        /* bytes_minus_one wraps for a zero-length access, which then
+           always misses the cache and is checked by the runtime */
+        BUILD_OP(Sub, max_addr, offset, bytes_minus_one, "len");
+        BUILD_OP(Add, bytes_minus_one, I64_NEG_ONE, bytes_minus_one,
+                 "bytes_minus_one");
+        offset_p = offset;
+        if (comp_ctx->pointer_size == sizeof(uint32)) {
+            /* The offset is smaller than 4G since it is larger than the
+               chain start, and the length of a 32-bit memory fits in
+               32 bits */
+            if (!(offset_p = LLVMBuildTrunc(comp_ctx->builder, offset,
+                                            I32_TYPE, "offset_u32"))
+                || !(bytes_minus_one =
+                         LLVMBuildTrunc(comp_ctx->builder, bytes_minus_one,
+                                        I32_TYPE, "bytes_minus_one_u32"))) {
+                aot_set_last_error("llvm build trunc failed");
+                goto fail;
+            }
+        }
+        if (!build_shared_heap_lookup(comp_ctx, func_ctx, offset_p,
+                                      bytes_minus_one, app_addr_in_shared_heap,
+                                      app_addr_in_linear_mem,
+                                      &shared_heap_range)) {
+            goto fail;
+        }
 
         /* Get native address inside shared heap */
-        if (!(maddr = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
-                                            func_ctx->shared_heap_base_addr_adj,
-                                            &offset, 1, "maddr_shared_heap"))) {
+        if (!(shared_heap_base_addr_adj = build_shared_heap_base_addr_adj(
+                  comp_ctx, shared_heap_range))) {
+            goto fail;
+        }
+        if (!(maddr = LLVMBuildInBoundsGEP2(
+                  comp_ctx->builder, INT8_TYPE, shared_heap_base_addr_adj,
+                  &offset, 1, "maddr_shared_heap"))) {
             aot_set_last_error("llvm build inbounds gep failed");
             goto fail;
         }
@@ -275,6 +275,50 @@ aot_estimate_stack_usage_for_function_call(const AOTCompContext *comp_ctx,
     return size;
 }
 
+bool
+aot_record_callee(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                  uint32 index, bool is_indirect)
+{
+    AOTCallee *callee;
+
+    if (!comp_ctx->emit_stack_usage) {
+        return true;
+    }
+
+    /* skip the same callee as the last one, e.g. calls in a loop body */
+    if (func_ctx->callee_count > 0) {
+        callee = func_ctx->callees + func_ctx->callee_count - 1;
+        if (callee->index == index && callee->is_indirect == is_indirect) {
+            return true;
+        }
+    }
+
+    if (func_ctx->callee_count == func_ctx->callee_capacity) {
+        uint32 capacity = func_ctx->callee_capacity
+                              ? func_ctx->callee_capacity * 2
+                              : 8;
+        uint64 size = sizeof(AOTCallee) * (uint64)capacity;
+
+        if (size >= UINT32_MAX
+            || !(callee = wasm_runtime_malloc((uint32)size))) {
+            aot_set_last_error("allocate memory failed.");
+            return false;
+        }
+        if (func_ctx->callees) {
+            bh_memcpy_s(callee, (uint32)size, func_ctx->callees,
+                        (uint32)sizeof(AOTCallee) * func_ctx->callee_count);
+            wasm_runtime_free(func_ctx->callees);
+        }
+        func_ctx->callees = callee;
+        func_ctx->callee_capacity = capacity;
+    }
+
+    callee = func_ctx->callees + func_ctx->callee_count++;
+    callee->index = index;
+    callee->is_indirect = is_indirect;
+    return true;
+}
+
 /*
  * a "precheck" function performs a few things before calling wrapped_func.
  *
@@ -1518,73 +1562,72 @@ create_memory_info(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
     return true;
 }
 
-static bool
-create_shared_heap_info(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
-{
-    LLVMValueRef offset, base_addr_p, start_off_p, cmp;
-    uint32 offset_u32;
-
-    /* Load aot_inst->e->shared_heap_base_addr_adj */
-    offset_u32 = get_module_inst_extra_offset(comp_ctx);
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_SHARED_HEAP != 0
-    if (comp_ctx->is_jit_mode)
-        offset_u32 +=
-            offsetof(WASMModuleInstanceExtra, shared_heap_base_addr_adj);
-    else
+#define SHARED_HEAP_FIELD_OFFSET(field)                                \
+    (comp_ctx->is_jit_mode ? offsetof(WASMModuleInstanceExtra, field) \
+                           : offsetof(AOTModuleInstanceExtra, field))
+#else
+#define SHARED_HEAP_FIELD_OFFSET(field) offsetof(AOTModuleInstanceExtra, field)
 #endif
-        offset_u32 +=
-            offsetof(AOTModuleInstanceExtra, shared_heap_base_addr_adj);
-    offset = I32_CONST(offset_u32);
+
+static LLVMValueRef
+get_shared_heap_field_ptr(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                          uint32 field_offset, LLVMTypeRef field_type,
+                          const char *name)
+{
+    LLVMValueRef offset, field_p;
+
+    offset = I32_CONST(get_module_inst_extra_offset(comp_ctx) + field_offset);
     CHECK_LLVM_CONST(offset);
 
-    if (!(base_addr_p = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
-                                              func_ctx->aot_inst, &offset, 1,
-                                              "shared_heap_base_addr_adj_p"))) {
+    if (!(field_p = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
+                                          func_ctx->aot_inst, &offset, 1,
+                                          name))) {
         aot_set_last_error("llvm build inbounds gep failed");
-        return false;
+        return NULL;
     }
-    if (!(func_ctx->shared_heap_base_addr_adj =
-              LLVMBuildLoad2(comp_ctx->builder, INT8_PTR_TYPE, base_addr_p,
-                             "shared_heap_base_addr_adj"))) {
-        aot_set_last_error("llvm build load failed");
+    if (!(field_p = LLVMBuildBitCast(comp_ctx->builder, field_p,
+                                     LLVMPointerType(field_type, 0), name))) {
+        aot_set_last_error("llvm build bit cast failed");
+        return NULL;
+    }
+    return field_p;
+fail:
+    return NULL;
+}
+
+static bool
+create_shared_heap_info(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
+{
+    LLVMTypeRef offset_type = (comp_ctx->pointer_size == sizeof(uint64))
+                                  ? I64_TYPE
+                                  : I32_TYPE;
+    LLVMValueRef start_off_p;
+
+    /* Get the pointer to aot_inst->e->shared_heap_cur_range, which is
+       loaded when a shared heap is accessed as the runtime may change it */
+    if (!(func_ctx->shared_heap_cur_range_p = get_shared_heap_field_ptr(
+              comp_ctx, func_ctx,
+              SHARED_HEAP_FIELD_OFFSET(shared_heap_cur_range), INT8_PTR_TYPE,
+              "shared_heap_cur_range_p"))) {
         return false;
     }
 
     /* Load aot_inst->e->shared_heap_start_off */
-    offset_u32 = get_module_inst_extra_offset(comp_ctx);
-#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_SHARED_HEAP != 0
-    if (comp_ctx->is_jit_mode)
-        offset_u32 += offsetof(WASMModuleInstanceExtra, shared_heap_start_off);
-    else
-#endif
-        offset_u32 += offsetof(AOTModuleInstanceExtra, shared_heap_start_off);
-    offset = I32_CONST(offset_u32);
-    CHECK_LLVM_CONST(offset);
-
-    if (!(start_off_p = LLVMBuildInBoundsGEP2(comp_ctx->builder, INT8_TYPE,
-                                              func_ctx->aot_inst, &offset, 1,
-                                              "shared_heap_start_off_p"))) {
-        aot_set_last_error("llvm build inbounds gep failed");
+    if (!(start_off_p = get_shared_heap_field_ptr(
+              comp_ctx, func_ctx,
+              SHARED_HEAP_FIELD_OFFSET(shared_heap_start_off), offset_type,
+              "shared_heap_start_off_p"))) {
         return false;
     }
-    if (!(func_ctx->shared_heap_start_off = LLVMBuildLoad2(
-              comp_ctx->builder,
-              comp_ctx->pointer_size == sizeof(uint64) ? I64_TYPE : I32_TYPE,
-              start_off_p, "shared_heap_start_off"))) {
+    if (!(func_ctx->shared_heap_start_off =
+              LLVMBuildLoad2(comp_ctx->builder, offset_type, start_off_p,
+                             "shared_heap_start_off"))) {
         aot_set_last_error("llvm build load failed");
         return false;
     }
 
-    if (!(cmp = LLVMBuildIsNotNull(comp_ctx->builder,
-                                   func_ctx->shared_heap_base_addr_adj,
-                                   "has_shared_heap"))) {
-        aot_set_last_error("llvm build is not null failed");
-        return false;
-    }
-
     return true;
-fail:
-    return false;
 }
 
 static bool
@@ -1905,6 +1948,8 @@ aot_destroy_func_contexts(AOTCompContext *comp_ctx, AOTFuncContext **func_ctxes,
                 wasm_runtime_free(func_ctxes[i]->mem_info);
             aot_block_stack_destroy(comp_ctx, &func_ctxes[i]->block_stack);
             aot_checked_addr_list_destroy(func_ctxes[i]);
+            if (func_ctxes[i]->callees)
+                wasm_runtime_free(func_ctxes[i]->callees);
             wasm_runtime_free(func_ctxes[i]);
         }
     wasm_runtime_free(func_ctxes);
@@ -2682,6 +2727,9 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_stack_estimation)
         comp_ctx->enable_stack_estimation = true;
 
+    if (option->emit_stack_usage)
+        comp_ctx->emit_stack_usage = true;
+
     if (option->quick_invoke_c_api_import)
         comp_ctx->quick_invoke_c_api_import = true;
 
@@ -2694,6 +2742,9 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_gc)
         comp_ctx->enable_gc = true;
 
+    if (option->enable_gc_write_barrier)
+        comp_ctx->enable_gc_write_barrier = true;
+
     if (option->enable_shared_heap)
         comp_ctx->enable_shared_heap = true;
 
@@ -224,6 +224,13 @@ typedef struct AOTMemInfo {
     LLVMValueRef mem_bound_check_16bytes;
 } AOTMemInfo;
 
+typedef struct AOTCallee {
+    /* The function index of a direct call, or the type index of an
+       indirect call */
+    uint32 index;
+    bool is_indirect;
+} AOTCallee;
+
 typedef struct AOTFuncContext {
     AOTFunc *aot_func;
     LLVMValueRef func;
@@ -254,7 +261,11 @@ typedef struct AOTFuncContext {
     bool mem_space_unchanged;
     AOTCheckedAddrList checked_addr_list;
 
-    LLVMValueRef shared_heap_base_addr_adj;
+    /* Pointer to the pointer to the range of the shared heap segment
+       accessed last, which is updated by the runtime when another segment
+       of the chain is accessed */
+    LLVMValueRef shared_heap_cur_range_p;
+    /* Lowest offset of the shared heap chain */
     LLVMValueRef shared_heap_start_off;
 
     LLVMBasicBlockRef got_exception_block;
@@ -269,6 +280,11 @@ typedef struct AOTFuncContext {
 
     unsigned int stack_consumption_for_func_call;
 
+    /* The functions called, to compute the stack usage of the call graph */
+    AOTCallee *callees;
+    uint32 callee_count;
+    uint32 callee_capacity;
+
     LLVMValueRef locals[1];
 } AOTFuncContext;
 
@@ -418,6 +434,9 @@ typedef struct AOTCompContext {
     /* Native stack usage estimation */
     bool enable_stack_estimation;
 
+    /* Emit the stack usage of the call graph to the AOT file */
+    bool emit_stack_usage;
+
     /* 128-bit SIMD */
     bool enable_simd;
 
@@ -482,6 +501,9 @@ typedef struct AOTCompContext {
     /* Enable GC */
     bool enable_gc;
 
+    /* Call the write barrier of the incremental GC */
+    bool enable_gc_write_barrier;
+
     bool enable_shared_heap;
 
     uint32 opt_level;
@@ -653,6 +675,10 @@ unsigned int
 aot_estimate_stack_usage_for_function_call(const AOTCompContext *comp_ctx,
                                            const AOTFuncType *callee_func_type);
 
+bool
+aot_record_callee(const AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
+                  uint32 index, bool is_indirect);
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
@@ -6215,6 +6215,49 @@ patch_jmp_info_list(JitCompContext *cc, bh_list *jmp_info_list)
     }
 }
 
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+/**
+ * Record the offsets of the absolute addresses patched into the jitted
+ * code, which point to the jitted code itself and must be adjusted when
+ * the code cache moves the code
+ *
+ * @param cc compiler context containing the allocated code cache info
+ * @param jmp_info_list the jmp info list
+ *
+ * @return true if success, false if failed
+ */
+static bool
+record_jitted_relocs(JitCompContext *cc, bh_list *jmp_info_list)
+{
+    JmpInfo *jmp_info;
+    uint32 *relocs, reloc_num = 0;
+
+    jmp_info = (JmpInfo *)bh_list_first_elem(jmp_info_list);
+    while (jmp_info) {
+        if (jmp_info->type != JMP_DST_LABEL_REL)
+            reloc_num++;
+        jmp_info = (JmpInfo *)bh_list_elem_next(jmp_info);
+    }
+
+    if (reloc_num == 0)
+        return true;
+
+    if (!(relocs = (uint32 *)jit_malloc(sizeof(uint32) * reloc_num)))
+        return false;
+
+    reloc_num = 0;
+    jmp_info = (JmpInfo *)bh_list_first_elem(jmp_info_list);
+    while (jmp_info) {
+        if (jmp_info->type != JMP_DST_LABEL_REL)
+            relocs[reloc_num++] = jmp_info->offset;
+        jmp_info = (JmpInfo *)bh_list_elem_next(jmp_info);
+    }
+
+    jit_code_cache_set_relocs(cc->jitted_addr_begin, relocs, reloc_num);
+    return true;
+}
+#endif
+
 /* Free the jmp info list */
 static void
 free_jmp_info_list(bh_list *jmp_info_list)
@@ -8355,6 +8398,12 @@ jit_codegen_gen_native(JitCompContext *cc)
     }
 
     patch_jmp_info_list(cc, jmp_info_list);
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    if (!record_jitted_relocs(cc, jmp_info_list)) {
+        jit_set_last_error(cc, "allocate memory failed");
+        goto fail;
+    }
+#endif
     return_value = true;
 
 fail:
@@ -214,6 +214,132 @@ create_first_res_reg(JitCompContext *cc, const WASMType *func_type)
     return 0;
 }
 
+/* Call the jitted code of a bytecode function, store the first result
+   into the current frame and jump to func_return. With background
+   compilation, the function is called in the interpreter if it hasn't
+   been compiled yet. */
+static bool
+emit_callbc(JitCompContext *cc, JitReg jitted_code, JitReg func_idx,
+            const WASMType *func_type, JitBasicBlock *func_return)
+{
+    JitReg res = 0;
+    uint32 n;
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    JitBasicBlock *block_jitted, *block_interp;
+    JitReg ret, interp_func_idx = func_idx, arg_regs[3];
+
+    if (!(block_interp = jit_cc_new_basic_block(cc, 0))) {
+        goto fail;
+    }
+
+    /* The function hasn't been compiled if its jitted code is the code
+       block to compile it */
+    GEN_INSN(CMP, cc->cmp_reg, jitted_code,
+             NEW_CONST(PTR, (uintptr_t)
+                                jit_globals->compile_fast_jit_and_then_call));
+    GEN_INSN(BEQ, cc->cmp_reg, jit_basic_block_label(block_interp), 0);
+
+    block_jitted = cc->cur_basic_block;
+
+    /* block_interp */
+    cc->cur_basic_block = block_interp;
+
+    if (!jit_reg_is_const(func_idx)) {
+        /* Reload func_idx of call_indirect from exec_env->jit_cache, as
+           virtual registers don't live across basic blocks */
+        interp_func_idx = jit_cc_new_reg_I32(cc);
+        GEN_INSN(LDI32, interp_func_idx, cc->exec_env_reg,
+                 NEW_CONST(I32, offsetof(WASMExecEnv, jit_cache) + 4));
+    }
+
+    /* Call fast_jit_call_interp */
+    ret = jit_cc_new_reg_I32(cc);
+    arg_regs[0] = cc->exec_env_reg;
+    arg_regs[1] = interp_func_idx;
+    arg_regs[2] = cc->fp_reg;
+    if (!jit_emit_callnative(cc, fast_jit_call_interp, ret, arg_regs, 3)) {
+        goto fail;
+    }
+
+    /* Convert the return value from bool to uint32 */
+    GEN_INSN(AND, ret, ret, NEW_CONST(I32, 0xFF));
+
+    /* Check whether there is exception thrown */
+    GEN_INSN(CMP, cc->cmp_reg, ret, NEW_CONST(I32, 0));
+    if (!jit_emit_exception(cc, EXCE_ALREADY_THROWN, JIT_OP_BEQ, cc->cmp_reg,
+                            NULL)) {
+        goto fail;
+    }
+
+    /* The interpreter has pushed the results into the current frame */
+    GEN_INSN(JMP, jit_basic_block_label(func_return));
+
+    cc->cur_basic_block = block_jitted;
+#endif
+
+    if (func_type->result_count > 0) {
+        switch (func_type->types[func_type->param_count]) {
+            case VALUE_TYPE_I32:
+#if WASM_ENABLE_REF_TYPES != 0
+            case VALUE_TYPE_EXTERNREF:
+            case VALUE_TYPE_FUNCREF:
+#endif
+                res = jit_cc_new_reg_I32(cc);
+                break;
+            case VALUE_TYPE_I64:
+                res = jit_cc_new_reg_I64(cc);
+                break;
+            case VALUE_TYPE_F32:
+                res = jit_cc_new_reg_F32(cc);
+                break;
+            case VALUE_TYPE_F64:
+                res = jit_cc_new_reg_F64(cc);
+                break;
+            default:
+                bh_assert(0);
+                goto fail;
+        }
+    }
+    GEN_INSN(CALLBC, res, 0, jitted_code, func_idx);
+    /* Store res into current frame, so that post_return in
+        block func_return can get the value */
+    n = cc->jit_frame->sp - cc->jit_frame->lp;
+    if (func_type->result_count > 0) {
+        switch (func_type->types[func_type->param_count]) {
+            case VALUE_TYPE_I32:
+#if WASM_ENABLE_REF_TYPES != 0
+            case VALUE_TYPE_EXTERNREF:
+            case VALUE_TYPE_FUNCREF:
+#endif
+                GEN_INSN(STI32, res, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                break;
+            case VALUE_TYPE_I64:
+                GEN_INSN(STI64, res, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                break;
+            case VALUE_TYPE_F32:
+                GEN_INSN(STF32, res, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                break;
+            case VALUE_TYPE_F64:
+                GEN_INSN(STF64, res, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                break;
+            default:
+                bh_assert(0);
+                goto fail;
+        }
+    }
+    /* commit and clear jit frame, then jump to block func_ret */
+    gen_commit_values(cc->jit_frame, cc->jit_frame->lp, cc->jit_frame->sp);
+    clear_values(cc->jit_frame);
+    GEN_INSN(JMP, jit_basic_block_label(func_return));
+    return true;
+fail:
+    return false;
+}
 bool
 jit_compile_op_call(JitCompContext *cc, uint32 func_idx, bool tail_call)
 {
@@ -225,6 +351,9 @@ jit_compile_op_call(JitCompContext *cc, uint32 func_idx, bool tail_call)
     JitReg fast_jit_func_ptrs, jitted_code = 0;
     JitReg native_func, *argvs = NULL, *argvs1 = NULL, func_params[5];
     JitReg native_addr_ptr, module_inst_reg, ret, res;
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    JitBasicBlock *func_return;
+#endif
     uint32 jitted_func_idx, i;
     uint64 total_size;
     const char *signature = NULL;
@@ -427,6 +556,7 @@ jit_compile_op_call(JitCompContext *cc, uint32 func_idx, bool tail_call)
             goto fail;
         }
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE == 0
         res = create_first_res_reg(cc, func_type);
 
         GEN_INSN(CALLBC, res, 0, jitted_code, NEW_CONST(I32, func_idx));
@@ -434,6 +564,28 @@ jit_compile_op_call(JitCompContext *cc, uint32 func_idx, bool tail_call)
         if (!post_return(cc, func_type, res, true)) {
             goto fail;
         }
+#else
+        if (!(func_return = jit_cc_new_basic_block(cc, 0))) {
+            goto fail;
+        }
+
+        /* Commit register values to locals and stacks, as the function
+           may be called in the interpreter in another basic block */
+        gen_commit_values(jit_frame, jit_frame->lp, jit_frame->sp);
+        /* Clear frame values */
+        clear_values(jit_frame);
+
+        if (!emit_callbc(cc, jitted_code, NEW_CONST(I32, func_idx), func_type,
+                         func_return)) {
+            goto fail;
+        }
+
+        /* translate block func_return */
+        cc->cur_basic_block = func_return;
+        if (!post_return(cc, func_type, 0, true)) {
+            goto fail;
+        }
+#endif
     }
 
 #if WASM_ENABLE_THREAD_MGR != 0
@@ -710,65 +862,9 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
         GEN_INSN(LDPTR, jitted_code, fast_jit_func_ptrs, jitted_code_offset);
     }
 
-    res = 0;
-    if (func_type->result_count > 0) {
-        switch (func_type->types[func_type->param_count]) {
-            case VALUE_TYPE_I32:
-#if WASM_ENABLE_REF_TYPES != 0
-            case VALUE_TYPE_EXTERNREF:
-            case VALUE_TYPE_FUNCREF:
-#endif
-                res = jit_cc_new_reg_I32(cc);
-                break;
-            case VALUE_TYPE_I64:
-                res = jit_cc_new_reg_I64(cc);
-                break;
-            case VALUE_TYPE_F32:
-                res = jit_cc_new_reg_F32(cc);
-                break;
-            case VALUE_TYPE_F64:
-                res = jit_cc_new_reg_F64(cc);
-                break;
-            default:
-                bh_assert(0);
-                goto fail;
-        }
-    }
-    GEN_INSN(CALLBC, res, 0, jitted_code, func_idx);
-    /* Store res into current frame, so that post_return in
-        block func_return can get the value */
-    n = cc->jit_frame->sp - cc->jit_frame->lp;
-    if (func_type->result_count > 0) {
-        switch (func_type->types[func_type->param_count]) {
-            case VALUE_TYPE_I32:
-#if WASM_ENABLE_REF_TYPES != 0
-            case VALUE_TYPE_EXTERNREF:
-            case VALUE_TYPE_FUNCREF:
-#endif
-                GEN_INSN(STI32, res, cc->fp_reg,
-                         NEW_CONST(I32, offset_of_local(n)));
-                break;
-            case VALUE_TYPE_I64:
-                GEN_INSN(STI64, res, cc->fp_reg,
-                         NEW_CONST(I32, offset_of_local(n)));
-                break;
-            case VALUE_TYPE_F32:
-                GEN_INSN(STF32, res, cc->fp_reg,
-                         NEW_CONST(I32, offset_of_local(n)));
-                break;
-            case VALUE_TYPE_F64:
-                GEN_INSN(STF64, res, cc->fp_reg,
-                         NEW_CONST(I32, offset_of_local(n)));
-                break;
-            default:
-                bh_assert(0);
-                goto fail;
-        }
+    if (!emit_callbc(cc, jitted_code, func_idx, func_type, func_return)) {
+        goto fail;
     }
-    /* commit and clear jit frame, then jump to block func_ret */
-    gen_commit_values(jit_frame, jit_frame->lp, jit_frame->sp);
-    clear_values(jit_frame);
-    GEN_INSN(JMP, jit_basic_block_label(func_return));
 
     /* translate block func_return */
     cc->cur_basic_block = func_return;
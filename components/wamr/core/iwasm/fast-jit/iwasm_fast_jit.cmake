@@ -7,6 +7,21 @@ add_definitions(-DWASM_ENABLE_FAST_JIT=1)
 if (WAMR_BUILD_FAST_JIT_DUMP EQUAL 1)
     add_definitions(-DWASM_ENABLE_FAST_JIT_DUMP=1)
 endif ()
+if (WAMR_BUILD_FAST_JIT_CODE_CACHE_EVICTION EQUAL 1)
+    add_definitions(-DWASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION=1)
+endif ()
+if (WAMR_BUILD_FAST_JIT_CODE_CACHE_COMPACTION EQUAL 1)
+    add_definitions(-DWASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION=1)
+endif ()
+if (WAMR_BUILD_FAST_JIT_OPT_PASSES EQUAL 1)
+    add_definitions(-DWASM_ENABLE_FAST_JIT_OPT_PASSES=1)
+endif ()
+if (WAMR_BUILD_FAST_JIT_GLOBAL_REGALLOC EQUAL 1)
+    add_definitions(-DWASM_ENABLE_FAST_JIT_GLOBAL_REGALLOC=1)
+endif ()
+if (WAMR_BUILD_FAST_JIT_BACKGROUND_COMPILE EQUAL 1)
+    add_definitions(-DWASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE=1)
+endif ()
 
 include_directories (${IWASM_FAST_JIT_DIR})
 enable_language(CXX)
@@ -4,12 +4,177 @@
  */
 
 #include "jit_codecache.h"
-#include "mem_alloc.h"
 #include "jit_compiler.h"
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+#include "../interpreter/wasm_interp.h"
+#include "../common/wasm_exec_env.h"
+#endif
+
+/* The code blocks are aligned to 16 bytes like native functions */
+#define CODE_BLOCK_ALIGN 16
+
+/* The block is free */
+#define CODE_BLOCK_FREE 1
+/* The jitted code of the block is being executed by some frame */
+#define CODE_BLOCK_ACTIVE 2
+
+/**
+ * Header of a block of the code cache. The blocks are laid out one
+ * after another from the beginning of the code cache, and the code
+ * follows the header.
+ */
+typedef struct JitCodeBlock {
+    /* Size of the block including the header */
+    uint32 size;
+    /* Size of the previous block, 0 for the first block */
+    uint32 prev_size;
+    /* Combination of CODE_BLOCK_XXX */
+    uint32 flags;
+    /* Index of the function (excluding the imported ones) whose jitted
+       code is held by the block */
+    uint32 func_idx;
+    /* Module of the function, NULL if the block holds other code like
+       the glue code, or if the code isn't registered yet */
+    WASMModule *module;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    /* Offsets of the absolute addresses in the code that point to the
+       code itself, they are adjusted when the block is moved */
+    uint32 *relocs;
+    uint32 reloc_num;
+#endif
+} JitCodeBlock;
 
-static void *code_cache_pool = NULL;
+#define CODE_BLOCK_HEADER_SIZE \
+    align_uint((uint32)sizeof(JitCodeBlock), CODE_BLOCK_ALIGN)
+
+static uint8 *code_cache_pool = NULL;
 static uint32 code_cache_pool_size = 0;
-static mem_allocator_t code_cache_pool_allocator = NULL;
+/* End of the last block, the space after it is free */
+static uint32 code_cache_top = 0;
+/* The last block, NULL if there is no block */
+static JitCodeBlock *code_cache_last = NULL;
+static korp_mutex code_cache_lock;
+
+static uint32 alloc_failures = 0;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+static uint32 evicted_function_count = 0;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+static uint32 compaction_count = 0;
+static uint64 moved_size = 0;
+#endif
+/* Entries of the threads which are executing jitted code */
+static JitCodeCacheEntry *code_cache_entries = NULL;
+#endif
+
+static inline uint8 *
+code_of_block(JitCodeBlock *block)
+{
+    return (uint8 *)block + CODE_BLOCK_HEADER_SIZE;
+}
+
+static inline JitCodeBlock *
+block_of_code(void *code)
+{
+    return (JitCodeBlock *)((uint8 *)code - CODE_BLOCK_HEADER_SIZE);
+}
+
+static inline JitCodeBlock *
+next_block(JitCodeBlock *block)
+{
+    return (JitCodeBlock *)((uint8 *)block + block->size);
+}
+
+static inline bool
+is_last_block(JitCodeBlock *block)
+{
+    return (uint8 *)block + block->size == code_cache_pool + code_cache_top;
+}
+
+static void
+init_block(JitCodeBlock *block, uint32 size, uint32 prev_size, uint32 flags)
+{
+    memset(block, 0, sizeof(JitCodeBlock));
+    block->size = size;
+    block->prev_size = prev_size;
+    block->flags = flags;
+}
+
+/**
+ * Allocate a block from the first free block that is large enough, or
+ * from the free space after the last block.
+ */
+static JitCodeBlock *
+alloc_block(uint32 size)
+{
+    JitCodeBlock *block = (JitCodeBlock *)code_cache_pool, *rest;
+    uint8 *end = code_cache_pool + code_cache_top;
+
+    while ((uint8 *)block < end) {
+        if ((block->flags & CODE_BLOCK_FREE) && block->size >= size) {
+            if (block->size - size
+                >= CODE_BLOCK_HEADER_SIZE + CODE_BLOCK_ALIGN) {
+                /* Split the remaining space into a new free block */
+                rest = (JitCodeBlock *)((uint8 *)block + size);
+                init_block(rest, block->size - size, size, CODE_BLOCK_FREE);
+                /* A free block is never the last block */
+                next_block(rest)->prev_size = rest->size;
+                block->size = size;
+            }
+            init_block(block, block->size, block->prev_size, 0);
+            return block;
+        }
+        block = next_block(block);
+    }
+
+    if (code_cache_pool_size - code_cache_top < size)
+        return NULL;
+
+    block = (JitCodeBlock *)end;
+    init_block(block, size, code_cache_last ? code_cache_last->size : 0, 0);
+    code_cache_top += size;
+    code_cache_last = block;
+    return block;
+}
+
+static void
+free_block(JitCodeBlock *block)
+{
+    JitCodeBlock *next, *prev;
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    if (block->relocs)
+        jit_free(block->relocs);
+#endif
+    init_block(block, block->size, block->prev_size, CODE_BLOCK_FREE);
+
+    /* Merge with the next block if it is free */
+    if (!is_last_block(block)) {
+        next = next_block(block);
+        if (next->flags & CODE_BLOCK_FREE)
+            block->size += next->size;
+    }
+
+    /* Merge with the previous block if it is free */
+    if (block->prev_size > 0) {
+        prev = (JitCodeBlock *)((uint8 *)block - block->prev_size);
+        if (prev->flags & CODE_BLOCK_FREE) {
+            prev->size += block->size;
+            block = prev;
+        }
+    }
+
+    if (!is_last_block(block)) {
+        next_block(block)->prev_size = block->size;
+    }
+    else {
+        /* Return the last block to the free space after it */
+        code_cache_top = (uint32)((uint8 *)block - code_cache_pool);
+        code_cache_last =
+            block->prev_size > 0
+                ? (JitCodeBlock *)((uint8 *)block - block->prev_size)
+                : NULL;
+    }
+}
 
 bool
 jit_code_cache_init(uint32 code_cache_size)
@@ -17,40 +182,454 @@ jit_code_cache_init(uint32 code_cache_size)
     int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
     int map_flags = MMAP_MAP_NONE;
 
+    code_cache_size = code_cache_size & ~(CODE_BLOCK_ALIGN - 1);
+
     if (!(code_cache_pool = os_mmap(NULL, code_cache_size, map_prot, map_flags,
                                     os_get_invalid_handle()))) {
         return false;
     }
 
-    if (!(code_cache_pool_allocator =
-              mem_allocator_create(code_cache_pool, code_cache_size))) {
+    if (os_mutex_init(&code_cache_lock) != 0) {
         os_munmap(code_cache_pool, code_cache_size);
         code_cache_pool = NULL;
         return false;
     }
 
     code_cache_pool_size = code_cache_size;
+    code_cache_top = 0;
+    code_cache_last = NULL;
+    alloc_failures = 0;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    evicted_function_count = 0;
+    code_cache_entries = NULL;
+#endif
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    compaction_count = 0;
+    moved_size = 0;
+#endif
     return true;
 }
 
 void
 jit_code_cache_destroy()
 {
-    mem_allocator_destroy(code_cache_pool_allocator);
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    JitCodeBlock *block = (JitCodeBlock *)code_cache_pool;
+
+    while ((uint8 *)block < code_cache_pool + code_cache_top) {
+        if (block->relocs)
+            jit_free(block->relocs);
+        block = next_block(block);
+    }
+#endif
+
+    os_mutex_destroy(&code_cache_lock);
     os_munmap(code_cache_pool, code_cache_pool_size);
 }
 
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+void
+jit_code_cache_enter(JitCodeCacheEntry *entry, WASMExecEnv *exec_env)
+{
+    entry->exec_env = exec_env;
+    entry->tid = os_self_thread();
+
+    os_mutex_lock(&code_cache_lock);
+    entry->next = code_cache_entries;
+    code_cache_entries = entry;
+    os_mutex_unlock(&code_cache_lock);
+}
+
+void
+jit_code_cache_leave(JitCodeCacheEntry *entry)
+{
+    JitCodeCacheEntry **p_entry;
+
+    os_mutex_lock(&code_cache_lock);
+    for (p_entry = &code_cache_entries; *p_entry;
+         p_entry = &(*p_entry)->next) {
+        if (*p_entry == entry) {
+            *p_entry = entry->next;
+            break;
+        }
+    }
+    os_mutex_unlock(&code_cache_lock);
+}
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+void
+jit_code_cache_set_relocs(void *code, uint32 *relocs, uint32 reloc_num)
+{
+    JitCodeBlock *block = block_of_code(code);
+
+    os_mutex_lock(&code_cache_lock);
+    bh_assert(!block->relocs);
+    block->relocs = relocs;
+    block->reloc_num = reloc_num;
+    os_mutex_unlock(&code_cache_lock);
+}
+#endif
+
+/**
+ * Check whether the jitted code may be moved or evicted, which is only
+ * safe if no other thread is executing jitted code, as the frames of
+ * other threads can't be inspected while they are running.
+ */
+static bool
+can_reclaim_code_cache()
+{
+    JitCodeCacheEntry *entry;
+    korp_tid self = os_self_thread();
+
+    for (entry = code_cache_entries; entry; entry = entry->next) {
+        if (entry->tid != self)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Mark the blocks of the functions whose frames are on the stacks of
+ * the current thread, they can be neither moved nor evicted.
+ */
+static void
+mark_active_blocks()
+{
+    JitCodeCacheEntry *entry;
+    WASMInterpFrame *frame;
+    WASMFunctionInstance *function;
+    void *code;
+
+    for (entry = code_cache_entries; entry; entry = entry->next) {
+        frame = (WASMInterpFrame *)entry->exec_env->cur_frame;
+        for (; frame; frame = frame->prev_frame) {
+            function = frame->function;
+            if (function && !function->is_import_func
+                && (code = function->u.func->fast_jit_jitted_code))
+                block_of_code(code)->flags |= CODE_BLOCK_ACTIVE;
+        }
+    }
+}
+
+static void
+unmark_active_blocks()
+{
+    JitCodeBlock *block = (JitCodeBlock *)code_cache_pool;
+
+    while ((uint8 *)block < code_cache_pool + code_cache_top) {
+        block->flags &= ~CODE_BLOCK_ACTIVE;
+        block = next_block(block);
+    }
+}
+
+static inline bool
+is_movable_block(JitCodeBlock *block)
+{
+    return block->module && !(block->flags & CODE_BLOCK_ACTIVE);
+}
+
+#if WASM_ENABLE_LAZY_JIT != 0
+static uint32
+get_free_size()
+{
+    JitCodeBlock *block = (JitCodeBlock *)code_cache_pool;
+    uint32 free_size = code_cache_pool_size - code_cache_top;
+
+    while ((uint8 *)block < code_cache_pool + code_cache_top) {
+        if (block->flags & CODE_BLOCK_FREE)
+            free_size += block->size;
+        block = next_block(block);
+    }
+    return free_size;
+}
+
+static int
+compare_call_count(const void *a, const void *b)
+{
+    const JitCodeBlock *block1 = *(const JitCodeBlock **)a;
+    const JitCodeBlock *block2 = *(const JitCodeBlock **)b;
+    uint32 count1 =
+        block1->module->functions[block1->func_idx]->fast_jit_call_count;
+    uint32 count2 =
+        block2->module->functions[block2->func_idx]->fast_jit_call_count;
+
+    return count1 < count2 ? -1 : (count1 > count2 ? 1 : 0);
+}
+
+/**
+ * Evict the jitted code of a function, the function pointer is reset
+ * to the code block that compiles the function again when it is called.
+ */
+static void
+evict_function(JitCodeBlock *block)
+{
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    WASMModule *module = block->module;
+    WASMFunction *func = module->functions[block->func_idx];
+
+    module->fast_jit_func_ptrs[block->func_idx] =
+        jit_globals->compile_fast_jit_and_then_call;
+    func->fast_jit_jitted_code = NULL;
+    func->fast_jit_call_count = 0;
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    /* Interpret the function until it becomes hot again */
+    func->fast_jit_interp_call_count = 0;
+    func->fast_jit_compile_queued = false;
+#endif
+    free_block(block);
+    evicted_function_count++;
+}
+
+/**
+ * Evict the least called functions until the given size is freed.
+ */
+static void
+evict_cold_functions(uint32 size)
+{
+    JitCodeBlock *block = (JitCodeBlock *)code_cache_pool, **blocks;
+    uint32 block_num = 0, freed_size = 0, block_size, i;
+
+    while ((uint8 *)block < code_cache_pool + code_cache_top) {
+        if (is_movable_block(block))
+            block_num++;
+        block = next_block(block);
+    }
+
+    if (block_num == 0
+        || !(blocks = jit_malloc(sizeof(JitCodeBlock *) * block_num)))
+        return;
+
+    block = (JitCodeBlock *)code_cache_pool;
+    for (i = 0; i < block_num; block = next_block(block)) {
+        if (is_movable_block(block))
+            blocks[i++] = block;
+    }
+
+    qsort(blocks, block_num, sizeof(JitCodeBlock *), compare_call_count);
+
+    for (i = 0; i < block_num && freed_size < size; i++) {
+        block_size = blocks[i]->size;
+        evict_function(blocks[i]);
+        freed_size += block_size;
+    }
+
+    jit_free(blocks);
+}
+
+/**
+ * Halve the call counts, so that the functions which were called often
+ * but aren't called any more become cold.
+ */
+static void
+age_call_counts()
+{
+    JitCodeBlock *block = (JitCodeBlock *)code_cache_pool;
+
+    while ((uint8 *)block < code_cache_pool + code_cache_top) {
+        if (block->module)
+            block->module->functions[block->func_idx]->fast_jit_call_count >>=
+                1;
+        block = next_block(block);
+    }
+}
+#endif /* end of WASM_ENABLE_LAZY_JIT != 0 */
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+/**
+ * Move the block to a lower address and adjust the references to its
+ * code.
+ */
+static void
+move_block(JitCodeBlock *block, uint8 *dst)
+{
+    WASMModule *module = block->module;
+    intptr_t delta = (intptr_t)(dst - (uint8 *)block);
+    uintptr_t addr;
+    uint8 *code;
+    uint32 i;
+
+    memmove(dst, block, block->size);
+    block = (JitCodeBlock *)dst;
+    code = code_of_block(block);
+
+    for (i = 0; i < block->reloc_num; i++) {
+        bh_memcpy_s(&addr, sizeof(uintptr_t), code + block->relocs[i],
+                    sizeof(uintptr_t));
+        addr += delta;
+        bh_memcpy_s(code + block->relocs[i], sizeof(uintptr_t), &addr,
+                    sizeof(uintptr_t));
+    }
+
+    module->functions[block->func_idx]->fast_jit_jitted_code = code;
+    module->fast_jit_func_ptrs[block->func_idx] = code;
+    moved_size += block->size;
+}
+
+/**
+ * Slide the blocks which can be moved towards the beginning of the code
+ * cache, so that the free blocks between them are merged into the free
+ * space after the last block.
+ */
+static void
+compact_code_cache()
+{
+    uint8 *src = code_cache_pool, *dst = code_cache_pool;
+    uint8 *end = code_cache_pool + code_cache_top;
+    JitCodeBlock *block, *prev = NULL;
+    uint32 size;
+
+    while (src < end) {
+        block = (JitCodeBlock *)src;
+        size = block->size;
+
+        if (block->flags & CODE_BLOCK_FREE) {
+            src += size;
+            continue;
+        }
+
+        if (dst < src) {
+            if (is_movable_block(block)) {
+                move_block(block, dst);
+            }
+            else {
+                /* The block can't be moved, keep a free block before it */
+                init_block((JitCodeBlock *)dst, (uint32)(src - dst),
+                           prev ? prev->size : 0, CODE_BLOCK_FREE);
+                prev = (JitCodeBlock *)dst;
+                dst = src;
+            }
+        }
+
+        block = (JitCodeBlock *)dst;
+        block->prev_size = prev ? prev->size : 0;
+        prev = block;
+        dst += size;
+        src += size;
+    }
+
+    code_cache_top = (uint32)(dst - code_cache_pool);
+    code_cache_last = prev;
+    compaction_count++;
+}
+#endif /* end of WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0 */
+
+/**
+ * Make room for a block of the given size when the code cache is full:
+ * evict the least called functions if there isn't enough free space,
+ * and then compact the code cache if the compaction is enabled.
+ */
+static void
+reclaim_code_cache(uint32 size)
+{
+#if WASM_ENABLE_LAZY_JIT != 0
+    uint32 free_size;
+#endif
+
+    if (!can_reclaim_code_cache())
+        return;
+
+    mark_active_blocks();
+
+    /* Evicted functions are compiled again when they are called, which
+       requires lazy compilation, otherwise only the free blocks left by
+       the unloaded modules are reclaimed */
+#if WASM_ENABLE_LAZY_JIT != 0
+    free_size = get_free_size();
+    if (free_size < size) {
+        /* Evict more than needed, so that the code cache isn't reclaimed
+           again for each of the following compilations */
+        evict_cold_functions(size - free_size + code_cache_pool_size / 16);
+    }
+    age_call_counts();
+#endif
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    compact_code_cache();
+#endif
+    unmark_active_blocks();
+}
+#endif /* end of WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0 */
+
 void *
 jit_code_cache_alloc(uint32 size)
 {
-    return mem_allocator_malloc(code_cache_pool_allocator, size);
+    JitCodeBlock *block;
+    uint32 block_size;
+
+    if (size > code_cache_pool_size)
+        return NULL;
+
+    block_size = align_uint(size + CODE_BLOCK_HEADER_SIZE, CODE_BLOCK_ALIGN);
+
+    os_mutex_lock(&code_cache_lock);
+
+    block = alloc_block(block_size);
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    if (!block) {
+        reclaim_code_cache(block_size);
+        block = alloc_block(block_size);
+    }
+#endif
+    if (!block)
+        alloc_failures++;
+
+    os_mutex_unlock(&code_cache_lock);
+
+    return block ? code_of_block(block) : NULL;
 }
 
 void
 jit_code_cache_free(void *ptr)
 {
-    if (ptr)
-        mem_allocator_free(code_cache_pool_allocator, ptr);
+    if (ptr) {
+        os_mutex_lock(&code_cache_lock);
+        free_block(block_of_code(ptr));
+        os_mutex_unlock(&code_cache_lock);
+    }
+}
+
+bool
+jit_code_cache_get_info(fast_jit_code_cache_info_t *info)
+{
+    JitCodeBlock *block;
+    uint32 largest_free_size;
+
+    memset(info, 0, sizeof(fast_jit_code_cache_info_t));
+
+    os_mutex_lock(&code_cache_lock);
+
+    info->total_size = code_cache_pool_size;
+    info->free_size = largest_free_size = code_cache_pool_size - code_cache_top;
+
+    block = (JitCodeBlock *)code_cache_pool;
+    while ((uint8 *)block < code_cache_pool + code_cache_top) {
+        if (block->flags & CODE_BLOCK_FREE) {
+            info->free_size += block->size;
+            if (block->size > largest_free_size)
+                largest_free_size = block->size;
+        }
+        else if (block->module) {
+            info->function_count++;
+        }
+        block = next_block(block);
+    }
+
+    info->used_size = info->total_size - info->free_size;
+    /* The header of the block is excluded */
+    info->largest_free_size = largest_free_size > CODE_BLOCK_HEADER_SIZE
+                                  ? largest_free_size - CODE_BLOCK_HEADER_SIZE
+                                  : 0;
+    info->alloc_failures = alloc_failures;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    info->evicted_function_count = evicted_function_count;
+#endif
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+    info->compaction_count = compaction_count;
+    info->moved_size = moved_size;
+#endif
+
+    os_mutex_unlock(&code_cache_lock);
+    return true;
 }
 
 bool
@@ -60,12 +639,24 @@ jit_pass_register_jitted_code(JitCompContext *cc)
     WASMModule *module = cc->cur_wasm_module;
     WASMFunction *func = cc->cur_wasm_func;
     uint32 jit_func_idx = cc->cur_wasm_func_idx - module->import_function_count;
+    JitCodeBlock *block = block_of_code(cc->jitted_addr_begin);
+
+    /* Lock the code cache so that the code isn't moved or evicted while
+       it is being registered */
+    os_mutex_lock(&code_cache_lock);
+
+    block->module = module;
+    block->func_idx = jit_func_idx;
 
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     os_mutex_lock(&module->instance_list_lock);
 #endif
 
+    /* The code is complete in the code cache, storing its address with a
+       single pointer write publishes it atomically to the threads which
+       are calling the function, either from jitted code or from the
+       interpreter */
     module->fast_jit_func_ptrs[jit_func_idx] = func->fast_jit_jitted_code =
         cc->jitted_addr_begin;
 
@@ -82,5 +673,7 @@ jit_pass_register_jitted_code(JitCompContext *cc)
 #else
     (void)instance;
 #endif
+
+    os_mutex_unlock(&code_cache_lock);
     return true;
 }
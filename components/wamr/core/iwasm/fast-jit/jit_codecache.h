@@ -7,11 +7,27 @@
 #define _JIT_CODE_CACHE_H_
 
 #include "bh_platform.h"
+#include "wasm_export.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+struct WASMExecEnv;
+
+/**
+ * Entry of a thread into the jitted code, the jitted code of the
+ * functions which have frames in the exec_env is neither moved nor
+ * evicted while the thread executes it.
+ */
+typedef struct JitCodeCacheEntry {
+    struct JitCodeCacheEntry *next;
+    struct WASMExecEnv *exec_env;
+    korp_tid tid;
+} JitCodeCacheEntry;
+#endif
+
 bool
 jit_code_cache_init(uint32 code_cache_size);
 
@@ -24,6 +40,34 @@ jit_code_cache_alloc(uint32 size);
 void
 jit_code_cache_free(void *ptr);
 
+bool
+jit_code_cache_get_info(fast_jit_code_cache_info_t *info);
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+/**
+ * Register the entry before the thread starts to execute the jitted
+ * code, the code cache is only compacted or evicted when no other
+ * thread is executing the jitted code.
+ */
+void
+jit_code_cache_enter(JitCodeCacheEntry *entry, struct WASMExecEnv *exec_env);
+
+/**
+ * Unregister the entry after the thread returns from the jitted code.
+ */
+void
+jit_code_cache_leave(JitCodeCacheEntry *entry);
+#endif
+
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_COMPACTION != 0
+/**
+ * Set the offsets of the absolute addresses in the code which point to
+ * the code itself, the code cache takes the ownership of the offsets.
+ */
+void
+jit_code_cache_set_relocs(void *code, uint32 *relocs, uint32 reloc_num);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
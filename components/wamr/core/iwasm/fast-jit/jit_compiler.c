@@ -23,6 +23,10 @@ static JitCompilerPass compiler_passes[] = {
     REG_PASS(dump),
     REG_PASS(update_cfg),
     REG_PASS(frontend),
+    REG_PASS(const_fold),
+    REG_PASS(copy_prop),
+    REG_PASS(cse),
+    REG_PASS(dce),
     REG_PASS(lower_cg),
     REG_PASS(regalloc),
     REG_PASS(codegen),
@@ -35,11 +39,19 @@ static JitCompilerPass compiler_passes[] = {
 
 #if WASM_ENABLE_FAST_JIT_DUMP == 0
 static const uint8 compiler_passes_without_dump[] = {
-    3, 4, 5, 6, 7, 0
+#if WASM_ENABLE_FAST_JIT_OPT_PASSES != 0
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 0
+#else
+    3, 8, 9, 10, 11, 0
+#endif
 };
 #else
 static const uint8 compiler_passes_with_dump[] = {
-    3, 2, 1, 4, 1, 5, 1, 6, 1, 7, 0
+#if WASM_ENABLE_FAST_JIT_OPT_PASSES != 0
+    3, 2, 1, 4, 5, 6, 7, 1, 8, 1, 9, 1, 10, 1, 11, 0
+#else
+    3, 2, 1, 8, 1, 9, 1, 10, 1, 11, 0
+#endif
 };
 #endif
 
@@ -57,6 +69,28 @@ static JitGlobals jit_globals = {
 };
 /* clang-format on */
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+/* A function queued to be compiled in background */
+typedef struct JitCompileRequest {
+    struct JitCompileRequest *next;
+    WASMModule *module;
+    uint32 func_idx;
+} JitCompileRequest;
+
+static korp_mutex compile_queue_lock;
+/* Signaled when a request is queued or the threads are stopping */
+static korp_cond compile_queue_cond;
+/* Signaled when a thread finishes compiling a function */
+static korp_cond compile_done_cond;
+static JitCompileRequest *compile_queue_head, *compile_queue_tail;
+static korp_tid compile_threads[WASM_FAST_JIT_COMPILE_THREAD_NUM];
+static uint32 compile_thread_num;
+/* The module whose function each thread is compiling */
+static WASMModule *compiling_modules[WASM_FAST_JIT_COMPILE_THREAD_NUM];
+static bool compile_threads_stopping;
+static uint32 compile_threshold;
+#endif
+
 static bool
 apply_compiler_passes(JitCompContext *cc)
 {
@@ -77,6 +111,163 @@ apply_compiler_passes(JitCompContext *cc)
     return true;
 }
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+static void *
+compile_thread_callback(void *arg)
+{
+    uint32 thread_idx = (uint32)(uintptr_t)arg;
+    JitCompileRequest *request;
+
+    os_mutex_lock(&compile_queue_lock);
+
+    while (!compile_threads_stopping) {
+        if (!(request = compile_queue_head)) {
+            os_cond_wait(&compile_queue_cond, &compile_queue_lock);
+            continue;
+        }
+
+        if (!(compile_queue_head = request->next))
+            compile_queue_tail = NULL;
+        /* Keep the module from being unloaded until it is compiled */
+        compiling_modules[thread_idx] = request->module;
+        os_mutex_unlock(&compile_queue_lock);
+
+        /* The function keeps being interpreted if it fails to compile */
+        jit_compiler_compile(request->module, request->func_idx);
+        jit_free(request);
+
+        os_mutex_lock(&compile_queue_lock);
+        compiling_modules[thread_idx] = NULL;
+        os_cond_broadcast(&compile_done_cond);
+    }
+
+    os_mutex_unlock(&compile_queue_lock);
+    return NULL;
+}
+
+static void
+stop_compile_threads()
+{
+    JitCompileRequest *request;
+    uint32 i;
+
+    os_mutex_lock(&compile_queue_lock);
+    compile_threads_stopping = true;
+    os_cond_broadcast(&compile_queue_cond);
+    os_mutex_unlock(&compile_queue_lock);
+
+    for (i = 0; i < compile_thread_num; i++)
+        os_thread_join(compile_threads[i], NULL);
+    compile_thread_num = 0;
+
+    while ((request = compile_queue_head)) {
+        compile_queue_head = request->next;
+        jit_free(request);
+    }
+    compile_queue_tail = NULL;
+
+    os_cond_destroy(&compile_done_cond);
+    os_cond_destroy(&compile_queue_cond);
+    os_mutex_destroy(&compile_queue_lock);
+}
+
+static bool
+start_compile_threads()
+{
+    if (os_mutex_init(&compile_queue_lock) != 0)
+        return false;
+
+    if (os_cond_init(&compile_queue_cond) != 0) {
+        os_mutex_destroy(&compile_queue_lock);
+        return false;
+    }
+
+    if (os_cond_init(&compile_done_cond) != 0) {
+        os_cond_destroy(&compile_queue_cond);
+        os_mutex_destroy(&compile_queue_lock);
+        return false;
+    }
+
+    compile_threads_stopping = false;
+
+    for (; compile_thread_num < WASM_FAST_JIT_COMPILE_THREAD_NUM;
+         compile_thread_num++) {
+        if (os_thread_create(&compile_threads[compile_thread_num],
+                             compile_thread_callback,
+                             (void *)(uintptr_t)compile_thread_num,
+                             APP_THREAD_STACK_SIZE_DEFAULT)
+            != 0) {
+            LOG_ERROR("JIT: create compile thread failed\n");
+            stop_compile_threads();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+jit_compiler_count_call(WASMModule *module, uint32 func_idx)
+{
+    WASMFunction *func =
+        module->functions[func_idx - module->import_function_count];
+    JitCompileRequest *request;
+
+    /* The count needn't be exact, so it isn't updated atomically */
+    if (func->fast_jit_compile_queued
+        || ++func->fast_jit_interp_call_count < compile_threshold)
+        return;
+
+    os_mutex_lock(&compile_queue_lock);
+
+    if (!func->fast_jit_compile_queued
+        && (request = jit_malloc(sizeof(JitCompileRequest)))) {
+        request->next = NULL;
+        request->module = module;
+        request->func_idx = func_idx;
+
+        if (compile_queue_tail)
+            compile_queue_tail->next = request;
+        else
+            compile_queue_head = request;
+        compile_queue_tail = request;
+
+        func->fast_jit_compile_queued = true;
+        os_cond_signal(&compile_queue_cond);
+    }
+
+    os_mutex_unlock(&compile_queue_lock);
+}
+
+void
+jit_compiler_cancel_compile(WASMModule *module)
+{
+    JitCompileRequest *request, **p_request = &compile_queue_head;
+    uint32 i;
+
+    os_mutex_lock(&compile_queue_lock);
+
+    compile_queue_tail = NULL;
+    while ((request = *p_request)) {
+        if (request->module == module) {
+            *p_request = request->next;
+            jit_free(request);
+        }
+        else {
+            compile_queue_tail = request;
+            p_request = &request->next;
+        }
+    }
+
+    for (i = 0; i < compile_thread_num; i++) {
+        while (compiling_modules[i] == module)
+            os_cond_wait(&compile_done_cond, &compile_queue_lock);
+    }
+
+    os_mutex_unlock(&compile_queue_lock);
+}
+#endif /* end of WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0 */
+
 bool
 jit_compiler_init(const JitCompOptions *options)
 {
@@ -87,14 +278,29 @@ jit_compiler_init(const JitCompOptions *options)
     LOG_VERBOSE("JIT: compiler init with code cache size: %u\n",
                 code_cache_size);
 
+    jit_globals.disabled_opt_passes = options->disabled_opt_passes;
+
     if (!jit_code_cache_init(code_cache_size))
         return false;
 
     if (!jit_codegen_init())
         goto fail1;
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    compile_threshold = options->compile_threshold > 0
+                            ? options->compile_threshold
+                            : FAST_JIT_DEFAULT_COMPILE_THRESHOLD;
+
+    if (!start_compile_threads())
+        goto fail2;
+#endif
+
     return true;
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+fail2:
+    jit_codegen_destroy();
+#endif
 fail1:
     jit_code_cache_destroy();
     return false;
@@ -103,6 +309,10 @@ fail1:
 void
 jit_compiler_destroy()
 {
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    stop_compile_threads();
+#endif
+
     jit_codegen_destroy();
 
     jit_code_cache_destroy();
@@ -21,6 +21,8 @@ typedef struct JitGlobals {
 #if WASM_ENABLE_LAZY_JIT != 0
     char *compile_fast_jit_and_then_call;
 #endif
+    /* Optimization passes disabled, combination of JIT_OPT_PASS_XXX */
+    uint32 disabled_opt_passes;
 } JitGlobals;
 
 /**
@@ -66,10 +68,21 @@ typedef struct JitInterpSwitchInfo {
     } out;
 } JitInterpSwitchInfo;
 
+/* Flags of the IR optimization passes */
+#define JIT_OPT_PASS_CONST_FOLD 0x1
+#define JIT_OPT_PASS_COPY_PROP 0x2
+#define JIT_OPT_PASS_CSE 0x4
+#define JIT_OPT_PASS_DCE 0x8
+#define JIT_OPT_PASS_GLOBAL_REGALLOC 0x10
+
 /* Jit compiler options */
 typedef struct JitCompOptions {
     uint32 code_cache_size;
     uint32 opt_level;
+    /* Optimization passes to disable, combination of JIT_OPT_PASS_XXX */
+    uint32 disabled_opt_passes;
+    /* Number of calls to a function before it is compiled in background */
+    uint32 compile_threshold;
 } JitCompOptions;
 
 bool
@@ -93,6 +106,23 @@ jit_compiler_compile_all(WASMModule *module);
 bool
 jit_compiler_is_compiled(const WASMModule *module, uint32 func_idx);
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+/**
+ * Count a call to a function which hasn't been compiled, the function is
+ * queued to be compiled by the background threads once it has been
+ * called compile threshold times.
+ */
+void
+jit_compiler_count_call(WASMModule *module, uint32 func_idx);
+
+/**
+ * Remove the functions of a module from the compile queue, and wait
+ * until the background threads finish compiling its functions.
+ */
+void
+jit_compiler_cancel_compile(WASMModule *module);
+#endif
+
 #if WASM_ENABLE_LAZY_JIT != 0 && WASM_ENABLE_JIT != 0
 bool
 jit_compiler_set_call_to_llvm_jit(WASMModule *module, uint32 func_idx);
@@ -131,6 +161,30 @@ jit_pass_update_cfg(JitCompContext *cc);
 bool
 jit_pass_frontend(JitCompContext *cc);
 
+/**
+ * Fold constant computations and simplify algebraic identities.
+ */
+bool
+jit_pass_const_fold(JitCompContext *cc);
+
+/**
+ * Replace uses of copied registers with their sources.
+ */
+bool
+jit_pass_copy_prop(JitCompContext *cc);
+
+/**
+ * Reuse the results of computations and loads done earlier in the block.
+ */
+bool
+jit_pass_cse(JitCompContext *cc);
+
+/**
+ * Remove computations whose results aren't used.
+ */
+bool
+jit_pass_dce(JitCompContext *cc);
+
 /**
  * Lower unsupported operations into supported ones.
  */
@@ -1090,12 +1090,16 @@ init_func_translation(JitCompContext *cc)
     uint32 frame_size, outs_size, local_size, count;
     uint32 i, local_off;
     uint64 total_size;
-#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0 \
+    || WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
     JitReg module_inst, func_inst;
     uint32 func_insts_offset;
 #if WASM_ENABLE_PERF_PROFILING != 0
     JitReg time_started;
 #endif
+#endif
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0 && WASM_ENABLE_LAZY_JIT != 0
+    JitReg call_count_addr, call_count;
 #endif
 
     if ((uint64)max_locals + (uint64)max_stacks >= UINT32_MAX
@@ -1162,7 +1166,8 @@ init_func_translation(JitCompContext *cc)
     frame_boundary = jit_cc_new_reg_ptr(cc);
     frame_sp = jit_cc_new_reg_ptr(cc);
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0 \
+    || WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
     module_inst = jit_cc_new_reg_ptr(cc);
     func_inst = jit_cc_new_reg_ptr(cc);
 #if WASM_ENABLE_PERF_PROFILING != 0
@@ -1207,7 +1212,10 @@ init_func_translation(JitCompContext *cc)
     /* frame->prev_frame = fp_reg */
     GEN_INSN(STPTR, cc->fp_reg, top,
              NEW_CONST(I32, offsetof(WASMInterpFrame, prev_frame)));
-#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0
+#if WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_PERF_PROFILING != 0 \
+    || WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    /* The code cache finds out the functions being executed from
+       frame->function */
     /* module_inst = exec_env->module_inst */
     GEN_INSN(LDPTR, module_inst, cc->exec_env_reg,
              NEW_CONST(I32, offsetof(WASMExecEnv, module_inst)));
@@ -1235,6 +1243,18 @@ init_func_translation(JitCompContext *cc)
     /* fp_reg = top */
     GEN_INSN(MOV, cc->fp_reg, top);
 
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0 && WASM_ENABLE_LAZY_JIT != 0
+    /* Count the calls, the least called functions are evicted when the
+       code cache is full */
+    call_count_addr = jit_cc_new_reg_ptr(cc);
+    call_count = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MOV, call_count_addr,
+             NEW_CONST(PTR, (uintptr_t)&cur_wasm_func->fast_jit_call_count));
+    GEN_INSN(LDI32, call_count, call_count_addr, NEW_CONST(I32, 0));
+    GEN_INSN(ADD, call_count, call_count, NEW_CONST(I32, 1));
+    GEN_INSN(STI32, call_count, call_count_addr, NEW_CONST(I32, 0));
+#endif
+
     /* Initialize local variables, set them to 0 */
     local_off = (uint32)offsetof(WASMInterpFrame, lp)
                 + cur_wasm_func->param_cell_num * 4;
@@ -271,7 +271,9 @@ jit_insn_opnd_regs(JitInsn *insn)
     switch (insn_opnd_kind[insn->opcode]) {
         case JIT_OPND_KIND_Reg:
             vec.num = insn_opnd_num[insn->opcode];
-            vec._base = jit_insn_opnd(insn, 0);
+            /* FENCE has no operand */
+            if (vec.num > 0)
+                vec._base = jit_insn_opnd(insn, 0);
             break;
 
         case JIT_OPND_KIND_VReg:
@@ -0,0 +1,962 @@
+/*
+ * Copyright (C) 2021 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "jit_compiler.h"
+#include "jit_ir.h"
+
+/*
+ * Machine independent optimizations of the IR generated by the frontend.
+ *
+ * The register allocator only allocates registers within one basic block
+ * (values are passed through the frame memory between blocks), so all the
+ * passes here work on one basic block at a time and never make a virtual
+ * register live across blocks.  The IR isn't in SSA form: the fixed virtual
+ * registers of the frontend (module_inst_reg, memory_regs, table_regs and
+ * so on) are re-defined after calls and at block boundaries, so a known
+ * value of a register is only trusted until the register or the registers
+ * it refers to are re-defined.  Hard registers are never propagated,
+ * merged or removed since they are also clobbered implicitly by calls.
+ */
+
+/* Information of a virtual register tracked by the block walk */
+typedef struct OptRegInfo {
+    /* Position of the last instruction defining the register */
+    uint32 def_pos;
+    /* The value known to be held by the register: a constant or another
+       virtual register, 0 if unknown */
+    JitReg value;
+    /* Position of the instruction making the value known */
+    uint32 value_pos;
+} OptRegInfo;
+
+/* Available expression recorded by CSE */
+typedef struct OptExpr {
+    JitInsn *insn;
+    /* Position of the instruction */
+    uint32 pos;
+    struct OptExpr *next;
+} OptExpr;
+
+typedef struct OptContext {
+    /* The compilation context */
+    JitCompContext *cc;
+    /* Information of the variable registers of each kind */
+    OptRegInfo *regs[JIT_REG_KIND_L32];
+    /* Position of the instruction being visited, starting from 1 */
+    uint32 pos;
+    /* Position of the first instruction of the current block */
+    uint32 block_pos;
+    /* Position of the last instruction that may write memory */
+    uint32 mem_write_pos;
+    /* Position of the last call */
+    uint32 call_pos;
+} OptContext;
+
+static bool
+opt_pass_disabled(uint32 pass_flag)
+{
+    return (jit_compiler_get_jit_globals()->disabled_opt_passes & pass_flag)
+           != 0;
+}
+
+static void
+opt_destroy(OptContext *ctx)
+{
+    unsigned kind;
+
+    for (kind = JIT_REG_KIND_VOID + 1; kind < JIT_REG_KIND_L32; kind++)
+        jit_free(ctx->regs[kind]);
+}
+
+static bool
+opt_init(OptContext *ctx, JitCompContext *cc)
+{
+    unsigned kind, num;
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->cc = cc;
+
+    for (kind = JIT_REG_KIND_VOID + 1; kind < JIT_REG_KIND_L32; kind++) {
+        if ((num = jit_cc_reg_num(cc, kind)) > 0
+            && !(ctx->regs[kind] = jit_calloc(sizeof(OptRegInfo) * num))) {
+            jit_set_last_error(cc, "allocate memory failed");
+            opt_destroy(ctx);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static OptRegInfo *
+opt_get_reg(OptContext *ctx, JitReg reg)
+{
+    bh_assert(jit_reg_is_variable(reg));
+    bh_assert(jit_reg_no(reg) < jit_cc_reg_num(ctx->cc, jit_reg_kind(reg)));
+    return &ctx->regs[jit_reg_kind(reg)][jit_reg_no(reg)];
+}
+
+/**
+ * Check whether the register is a virtual register that the passes
+ * may track, i.e. a variable register that isn't a hard register.
+ */
+static bool
+is_virtual_reg(JitCompContext *cc, JitReg reg)
+{
+    return jit_reg_is_variable(reg) && !jit_cc_is_hreg(cc, reg);
+}
+
+/**
+ * Check whether the register is a constant that can be folded, constants
+ * with relocation info depend on the runtime context.
+ */
+static bool
+is_foldable_const(JitCompContext *cc, JitReg reg)
+{
+    switch (jit_reg_kind(reg)) {
+        case JIT_REG_KIND_I32:
+            return jit_reg_is_const(reg)
+                   && jit_cc_get_const_I32_rel(cc, reg) == 0;
+        case JIT_REG_KIND_I64:
+            return jit_reg_is_const(reg);
+        default:
+            return false;
+    }
+}
+
+static bool
+is_conversion(uint16 opcode)
+{
+    return opcode >= JIT_OP_I8TOI32 && opcode <= JIT_OP_F64TOU32;
+}
+
+static bool
+is_load(uint16 opcode)
+{
+    return opcode >= JIT_OP_LDI8 && opcode <= JIT_OP_LDPTR;
+}
+
+static bool
+is_store(uint16 opcode)
+{
+    return opcode >= JIT_OP_STI8 && opcode <= JIT_OP_STV256;
+}
+
+/**
+ * Check whether the instruction only computes its result from its
+ * operands, without side effects and without trapping.
+ */
+static bool
+is_pure(uint16 opcode)
+{
+    switch (opcode) {
+        case JIT_OP_MOV:
+        case JIT_OP_NEG:
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+        case JIT_OP_ROTL:
+        case JIT_OP_ROTR:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_AND:
+        case JIT_OP_CLZ:
+        case JIT_OP_CTZ:
+        case JIT_OP_POPCNT:
+        case JIT_OP_I32CASTF32:
+        case JIT_OP_I64CASTF64:
+        case JIT_OP_F32CASTI32:
+        case JIT_OP_F64CASTI64:
+            return true;
+        default:
+            return is_conversion(opcode);
+    }
+}
+
+/**
+ * Check whether the operands of the instruction follow the def-use
+ * layout of jit_insn_opnd_first_use, so that its uses can be rewritten.
+ * The atomic instructions and calls are excluded, the formers define
+ * registers listed as uses and the latters clobber hard registers.
+ */
+static bool
+is_rewritable(uint16 opcode)
+{
+    return is_pure(opcode) || is_load(opcode) || is_store(opcode)
+           || opcode == JIT_OP_CMP
+           || (opcode >= JIT_OP_SELECTEQ && opcode <= JIT_OP_SELECTLEU);
+}
+
+static bool
+may_write_memory(uint16 opcode)
+{
+    return is_store(opcode) || opcode == JIT_OP_CALLNATIVE
+           || opcode == JIT_OP_CALLBC
+#if WASM_ENABLE_SHARED_MEMORY != 0
+           || (opcode >= JIT_OP_AT_CMPXCHGU8 && opcode <= JIT_OP_FENCE)
+#endif
+        ;
+}
+
+/**
+ * Start visiting a block.
+ */
+static void
+opt_begin_block(OptContext *ctx)
+{
+    ctx->block_pos = ctx->pos + 1;
+    ctx->mem_write_pos = ctx->call_pos = ctx->pos;
+}
+
+/**
+ * Get the value known to be held by a register at the current position.
+ *
+ * @return a constant or a virtual register, 0 if unknown
+ */
+static JitReg
+opt_get_value(OptContext *ctx, JitReg reg)
+{
+    OptRegInfo *info, *src_info;
+
+    if (!is_virtual_reg(ctx->cc, reg))
+        return 0;
+
+    info = opt_get_reg(ctx, reg);
+    if (!info->value || info->value_pos < ctx->block_pos
+        || info->def_pos != info->value_pos)
+        /* Unknown, known in another block or re-defined since then */
+        return 0;
+
+    if (jit_reg_is_variable(info->value)) {
+        src_info = opt_get_reg(ctx, info->value);
+        if (src_info->def_pos >= info->value_pos)
+            /* The source was re-defined since the copy */
+            return 0;
+    }
+
+    return info->value;
+}
+
+/**
+ * Record the definitions of the instruction at the current position, the
+ * registers of instructions that aren't rewritable are all treated as
+ * defined.
+ */
+static void
+opt_record_defs(OptContext *ctx, JitInsn *insn)
+{
+    JitRegVec regvec = jit_insn_opnd_regs(insn);
+    unsigned first_use = jit_insn_opnd_first_use(insn), i;
+    JitReg *regp;
+
+    if (!is_rewritable(insn->opcode))
+        first_use = regvec.num;
+
+    JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+    if (jit_reg_is_variable(*regp)) {
+        OptRegInfo *info = opt_get_reg(ctx, *regp);
+        info->def_pos = ctx->pos;
+        info->value = 0;
+    }
+
+    if (may_write_memory(insn->opcode))
+        ctx->mem_write_pos = ctx->pos;
+    if (insn->opcode == JIT_OP_CALLNATIVE || insn->opcode == JIT_OP_CALLBC)
+        ctx->call_pos = ctx->pos;
+}
+
+/**
+ * Record that the only register defined by the current instruction
+ * holds the given value.
+ */
+static void
+opt_record_value(OptContext *ctx, JitReg reg, JitReg value)
+{
+    OptRegInfo *info;
+
+    if (!is_virtual_reg(ctx->cc, reg) || reg == value
+        || (jit_reg_is_variable(value) && !is_virtual_reg(ctx->cc, value)))
+        return;
+
+    info = opt_get_reg(ctx, reg);
+    bh_assert(info->def_pos == ctx->pos);
+    info->value = value;
+    info->value_pos = ctx->pos;
+}
+
+/**
+ * Turn the instruction into MOV r0, value in place, the instruction
+ * always has enough room since it has at least two operands.
+ */
+static void
+rewrite_to_mov(JitInsn *insn, JitReg value)
+{
+    bh_assert(jit_insn_opnd_regs(insn).num >= 2);
+    insn->opcode = JIT_OP_MOV;
+    insn->flags_u8 = 0;
+    *jit_insn_opnd(insn, 1) = value;
+}
+
+/*
+ * Constant folding
+ */
+
+/**
+ * Check whether a constant can be used as the index-th operand of the
+ * instruction, the code generator only accepts constants for some
+ * operands.
+ */
+static bool
+can_use_const(JitInsn *insn, unsigned index)
+{
+    uint16 opcode = insn->opcode;
+
+    switch (opcode) {
+        case JIT_OP_MOV:
+        case JIT_OP_NEG:
+            return index == 1;
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_AND:
+        case JIT_OP_CMP:
+            return index == 1 || index == 2;
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+        case JIT_OP_ROTL:
+        case JIT_OP_ROTR:
+            /* The shift count in a variable must be in a fixed hard
+               register, so the value can only be a constant if the
+               count is */
+            return index == 2
+                   || (index == 1 && jit_reg_is_const(*jit_insn_opnd(insn, 2)));
+        default:
+            /* Conversions from integers */
+            return index == 1 && is_conversion(opcode)
+                   && opcode < JIT_OP_F32TOI32;
+    }
+}
+
+#define FOLD_BINARY(Type, UType, get_const, new_const, bits)            \
+    do {                                                                \
+        Type v1 = get_const(cc, r1), v2 = get_const(cc, r2);            \
+        UType u1 = (UType)v1, u2 = (UType)v2;                           \
+                                                                        \
+        switch (insn->opcode) {                                         \
+            case JIT_OP_ADD:                                            \
+                return new_const(cc, (Type)(u1 + u2));                  \
+            case JIT_OP_SUB:                                            \
+                return new_const(cc, (Type)(u1 - u2));                  \
+            case JIT_OP_MUL:                                            \
+                return new_const(cc, (Type)(u1 * u2));                  \
+            case JIT_OP_OR:                                             \
+                return new_const(cc, v1 | v2);                          \
+            case JIT_OP_XOR:                                            \
+                return new_const(cc, v1 ^ v2);                          \
+            case JIT_OP_AND:                                            \
+                return new_const(cc, v1 & v2);                          \
+            default:                                                    \
+                break;                                                  \
+        }                                                               \
+                                                                        \
+        /* Leave the out of range shift counts to the code generator */ \
+        if (u2 >= bits)                                                 \
+            return 0;                                                   \
+                                                                        \
+        switch (insn->opcode) {                                         \
+            case JIT_OP_SHL:                                            \
+                return new_const(cc, (Type)(u1 << u2));                 \
+            case JIT_OP_SHRS:                                           \
+                return new_const(cc, v1 >> u2);                         \
+            case JIT_OP_SHRU:                                           \
+                return new_const(cc, (Type)(u1 >> u2));                 \
+            case JIT_OP_ROTL:                                           \
+                return new_const(                                       \
+                    cc, (Type)(u2 ? (u1 << u2) | (u1 >> (bits - u2)) : u1)); \
+            case JIT_OP_ROTR:                                           \
+                return new_const(                                       \
+                    cc, (Type)(u2 ? (u1 >> u2) | (u1 << (bits - u2)) : u1)); \
+            default:                                                    \
+                return 0;                                               \
+        }                                                               \
+    } while (0)
+
+/**
+ * Compute the result of an instruction whose operands are all constants.
+ *
+ * @return the constant result, 0 if it isn't folded
+ */
+static JitReg
+fold_const(JitCompContext *cc, JitInsn *insn)
+{
+    JitReg r0 = *jit_insn_opnd(insn, 0), r1 = *jit_insn_opnd(insn, 1), r2;
+
+    if (!is_foldable_const(cc, r1))
+        return 0;
+
+    switch (insn->opcode) {
+        case JIT_OP_NEG:
+            if (jit_reg_kind(r0) == JIT_REG_KIND_I32)
+                return jit_cc_new_const_I32(
+                    cc, (int32)(0 - (uint32)jit_cc_get_const_I32(cc, r1)));
+            if (jit_reg_kind(r0) == JIT_REG_KIND_I64)
+                return jit_cc_new_const_I64(
+                    cc, (int64)(0 - (uint64)jit_cc_get_const_I64(cc, r1)));
+            return 0;
+        case JIT_OP_I32TOI64:
+            return jit_cc_new_const_I64(cc, jit_cc_get_const_I32(cc, r1));
+        case JIT_OP_U32TOI64:
+            return jit_cc_new_const_I64(
+                cc, (int64)(uint32)jit_cc_get_const_I32(cc, r1));
+        case JIT_OP_I64TOI32:
+            return jit_cc_new_const_I32(cc,
+                                        (int32)jit_cc_get_const_I64(cc, r1));
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+        case JIT_OP_ROTL:
+        case JIT_OP_ROTR:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_AND:
+            r2 = *jit_insn_opnd(insn, 2);
+            if (!is_foldable_const(cc, r2)
+                || jit_reg_kind(r1) != jit_reg_kind(r2))
+                return 0;
+            if (jit_reg_kind(r0) == JIT_REG_KIND_I32)
+                FOLD_BINARY(int32, uint32, jit_cc_get_const_I32,
+                            jit_cc_new_const_I32, 32);
+            else if (jit_reg_kind(r0) == JIT_REG_KIND_I64)
+                FOLD_BINARY(int64, uint64, jit_cc_get_const_I64,
+                            jit_cc_new_const_I64, 64);
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+#undef FOLD_BINARY
+
+static bool
+is_const_equal(JitCompContext *cc, JitReg reg, int64 val)
+{
+    if (!is_foldable_const(cc, reg))
+        return false;
+    if (jit_reg_kind(reg) == JIT_REG_KIND_I32)
+        return jit_cc_get_const_I32(cc, reg) == (int32)val;
+    return jit_cc_get_const_I64(cc, reg) == val;
+}
+
+/**
+ * Simplify an instruction with one constant operand by the algebraic
+ * identities, such as x + 0 = x, x * 1 = x and x & 0 = 0.
+ *
+ * @return the value of the result, 0 if it isn't simplified
+ */
+static JitReg
+simplify_identity(JitCompContext *cc, JitInsn *insn)
+{
+    JitReg r0, r1, r2;
+
+    switch (insn->opcode) {
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+        case JIT_OP_ROTL:
+        case JIT_OP_ROTR:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_AND:
+            break;
+        default:
+            return 0;
+    }
+
+    r0 = *jit_insn_opnd(insn, 0);
+    r1 = *jit_insn_opnd(insn, 1);
+    r2 = *jit_insn_opnd(insn, 2);
+    if ((jit_reg_kind(r0) != JIT_REG_KIND_I32
+         && jit_reg_kind(r0) != JIT_REG_KIND_I64)
+        || jit_reg_kind(r1) != jit_reg_kind(r0)
+        || jit_reg_kind(r2) != jit_reg_kind(r0))
+        return 0;
+
+    switch (insn->opcode) {
+        case JIT_OP_ADD:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+            if (is_const_equal(cc, r1, 0))
+                return r2;
+            /* fall through */
+        case JIT_OP_SUB:
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+        case JIT_OP_ROTL:
+        case JIT_OP_ROTR:
+            return is_const_equal(cc, r2, 0) ? r1 : 0;
+        case JIT_OP_MUL:
+            if (is_const_equal(cc, r1, 0) || is_const_equal(cc, r2, 1))
+                return r1;
+            if (is_const_equal(cc, r2, 0) || is_const_equal(cc, r1, 1))
+                return r2;
+            return 0;
+        case JIT_OP_AND:
+            if (is_const_equal(cc, r1, 0) || is_const_equal(cc, r2, -1))
+                return r1;
+            if (is_const_equal(cc, r2, 0) || is_const_equal(cc, r1, -1))
+                return r2;
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+bool
+jit_pass_const_fold(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn;
+    unsigned label_index, end_label_index;
+
+    if (opt_pass_disabled(JIT_OPT_PASS_CONST_FOLD))
+        return true;
+
+    if (!opt_init(&ctx, cc))
+        return false;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        opt_begin_block(&ctx);
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            unsigned first_use = jit_insn_opnd_first_use(insn), i;
+            JitReg *regp, value;
+
+            ctx.pos++;
+
+            /* Propagate the known constants into the operands, backward
+               since whether the first operand of shifts accepts constant
+               depends on the second one */
+            if (is_rewritable(insn->opcode))
+                for (i = jit_insn_opnd_regs(insn).num; i-- > first_use;) {
+                    regp = jit_insn_opnd(insn, i);
+                    value = opt_get_value(&ctx, *regp);
+                    if (value && jit_reg_is_const(value)
+                        && can_use_const(insn, i))
+                        *regp = value;
+                }
+
+            value = 0;
+            if (is_pure(insn->opcode) && insn->opcode != JIT_OP_MOV
+                && is_virtual_reg(cc, *jit_insn_opnd(insn, 0))) {
+                if (!(value = fold_const(cc, insn)))
+                    value = simplify_identity(cc, insn);
+                if (value)
+                    rewrite_to_mov(insn, value);
+            }
+
+            opt_record_defs(&ctx, insn);
+
+            if (insn->opcode == JIT_OP_MOV
+                && is_foldable_const(cc, *jit_insn_opnd(insn, 1)))
+                opt_record_value(&ctx, *jit_insn_opnd(insn, 0),
+                                 *jit_insn_opnd(insn, 1));
+        }
+    }
+
+    opt_destroy(&ctx);
+    return jit_get_last_error(cc) ? false : true;
+}
+
+/*
+ * Copy propagation
+ */
+
+/**
+ * Replace the uses of copied registers with their sources.
+ */
+static void
+propagate_copies(OptContext *ctx, JitInsn *insn)
+{
+    JitRegVec regvec = jit_insn_opnd_regs(insn);
+    unsigned first_use = jit_insn_opnd_first_use(insn), i;
+    JitReg *regp, value;
+
+    if (!is_rewritable(insn->opcode))
+        return;
+
+    JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+    {
+        value = opt_get_value(ctx, *regp);
+        if (value && jit_reg_is_variable(value))
+            *regp = value;
+    }
+}
+
+bool
+jit_pass_copy_prop(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn;
+    unsigned label_index, end_label_index;
+
+    if (opt_pass_disabled(JIT_OPT_PASS_COPY_PROP))
+        return true;
+
+    if (!opt_init(&ctx, cc))
+        return false;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        opt_begin_block(&ctx);
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            ctx.pos++;
+            propagate_copies(&ctx, insn);
+            opt_record_defs(&ctx, insn);
+
+            if (insn->opcode == JIT_OP_MOV
+                && jit_reg_is_variable(*jit_insn_opnd(insn, 1)))
+                opt_record_value(&ctx, *jit_insn_opnd(insn, 0),
+                                 *jit_insn_opnd(insn, 1));
+        }
+    }
+
+    opt_destroy(&ctx);
+    return true;
+}
+
+/*
+ * Common subexpression elimination
+ */
+
+/**
+ * Check whether the instruction is a conditional branch to an exception
+ * block, i.e. Bxx cmp_reg, label, VOID, which follows the CMP of the
+ * bound checks and the other runtime checks emitted by the frontend.
+ */
+static bool
+is_check_branch(JitCompContext *cc, JitInsn *insn)
+{
+    return insn->opcode >= JIT_OP_BEQ && insn->opcode <= JIT_OP_BLEU
+           && *jit_insn_opnd(insn, 0) == cc->cmp_reg
+           && *jit_insn_opnd(insn, 2) == 0;
+}
+
+/**
+ * Check whether the instructions following the branch of a check read
+ * the flags set by its CMP.
+ */
+static bool
+is_cmp_reg_used_after(JitCompContext *cc, JitBasicBlock *block,
+                      JitInsn *branch)
+{
+    JitInsn *insn;
+    JitRegVec regvec;
+    unsigned i;
+    JitReg *regp;
+
+    for (insn = branch->next; insn != jit_basic_block_end_insn(block);
+         insn = insn->next) {
+        if (insn->opcode == JIT_OP_CMP)
+            return false;
+
+        regvec = jit_insn_opnd_regs(insn);
+        JIT_REG_VEC_FOREACH(regvec, i, regp)
+        if (*regp == cc->cmp_reg)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Check whether the instruction computes a value that may be reused by
+ * the same instructions following it.  CMPs are only candidates as the
+ * first instruction of a check.
+ */
+static bool
+is_cse_candidate(JitCompContext *cc, JitInsn *insn)
+{
+    JitRegVec regvec;
+    unsigned i;
+    JitReg *regp, r0;
+
+    if (insn->opcode == JIT_OP_CMP) {
+        if (!is_check_branch(cc, insn->next))
+            return false;
+    }
+    else if (insn->opcode == JIT_OP_MOV
+             || !(is_pure(insn->opcode)
+                  || (is_load(insn->opcode) && !(insn->flags_u8 & 0x1)))
+             || !is_virtual_reg(cc, *jit_insn_opnd(insn, 0)))
+        return false;
+
+    /* Only the fixed hard registers (frame pointer and exec_env) keep
+       their values across the instructions */
+    r0 = *jit_insn_opnd(insn, 0);
+    regvec = jit_insn_opnd_regs(insn);
+    JIT_REG_VEC_FOREACH_USE(regvec, i, regp, 1)
+    {
+        if (!jit_reg_is_variable(*regp))
+            continue;
+        /* Like ADD r0, r0, r1, whose operand is changed by itself */
+        if (*regp == r0)
+            return false;
+        if (jit_cc_is_hreg(cc, *regp) && !jit_cc_is_hreg_fixed(cc, *regp))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Check whether the recorded instruction computes the same as the given
+ * one, for checks their branches must also be the same.
+ */
+static bool
+is_same_expr(JitInsn *recorded, JitInsn *insn)
+{
+    if (!jit_insn_equal(recorded, insn))
+        return false;
+
+    if (insn->opcode == JIT_OP_CMP)
+        return recorded->next->opcode == insn->next->opcode
+               && *jit_insn_opnd(recorded->next, 1)
+                      == *jit_insn_opnd(insn->next, 1);
+
+    return true;
+}
+
+/**
+ * Check whether the result of the recorded instruction is still
+ * available at the current position.
+ */
+static bool
+is_expr_available(OptContext *ctx, OptExpr *expr)
+{
+    JitRegVec regvec = jit_insn_opnd_regs(expr->insn);
+    unsigned i;
+    JitReg *regp;
+
+    if (is_load(expr->insn->opcode) && ctx->mem_write_pos > expr->pos)
+        return false;
+
+    /* Calls clobber the caller-saved registers, keeping the result alive
+       across them costs a spill and a reload, more than re-computing */
+    if (ctx->call_pos > expr->pos)
+        return false;
+
+    JIT_REG_VEC_FOREACH(regvec, i, regp)
+    {
+        /* The flags set by the CMP of a check are only used by its
+           branch, so they may be overwritten since then */
+        if (i == 0 && expr->insn->opcode == JIT_OP_CMP)
+            continue;
+        if (jit_reg_is_variable(*regp)
+            && opt_get_reg(ctx, *regp)->def_pos > expr->pos)
+            return false;
+    }
+
+    return true;
+}
+
+bool
+jit_pass_cse(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn, *next, *branch;
+    OptExpr **buckets = NULL, *exprs = NULL, *expr;
+    unsigned label_index, end_label_index;
+    uint32 insn_num, max_insn_num = 0, bucket_num = 1, slot;
+    bool ret = false;
+
+    if (opt_pass_disabled(JIT_OPT_PASS_CSE))
+        return true;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        insn_num = 0;
+        JIT_FOREACH_INSN(block, insn)
+        insn_num++;
+        if (insn_num > max_insn_num)
+            max_insn_num = insn_num;
+    }
+
+    if (max_insn_num == 0)
+        return true;
+
+    while (bucket_num < max_insn_num)
+        bucket_num <<= 1;
+
+    if (!opt_init(&ctx, cc))
+        return false;
+
+    if (!(buckets = jit_calloc(sizeof(OptExpr *) * bucket_num))
+        || !(exprs = jit_calloc(sizeof(OptExpr) * max_insn_num))) {
+        jit_set_last_error(cc, "allocate memory failed");
+        goto fail;
+    }
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        opt_begin_block(&ctx);
+        memset(buckets, 0, sizeof(OptExpr *) * bucket_num);
+        insn_num = 0;
+
+        for (insn = jit_basic_block_first_insn(block);
+             insn != jit_basic_block_end_insn(block); insn = next) {
+            JitReg value = 0;
+
+            next = insn->next;
+            ctx.pos++;
+            /* Use the values of the eliminated instructions */
+            propagate_copies(&ctx, insn);
+
+            if (is_cse_candidate(cc, insn)) {
+                slot = jit_insn_hash(insn) & (bucket_num - 1);
+                for (expr = buckets[slot]; expr; expr = expr->next)
+                    if (is_same_expr(expr->insn, insn)
+                        && is_expr_available(&ctx, expr))
+                        break;
+
+                if (expr && insn->opcode == JIT_OP_CMP) {
+                    /* The same check passed before, remove it unless
+                       its flags are also used by other instructions */
+                    if (!is_cmp_reg_used_after(cc, block, next)) {
+                        branch = next;
+                        next = branch->next;
+                        jit_insn_unlink(branch);
+                        jit_insn_delete(branch);
+                        jit_insn_unlink(insn);
+                        jit_insn_delete(insn);
+                        continue;
+                    }
+                }
+                else if (expr) {
+                    value = *jit_insn_opnd(expr->insn, 0);
+                    rewrite_to_mov(insn, value);
+                }
+                else {
+                    expr = &exprs[insn_num++];
+                    expr->insn = insn;
+                    expr->pos = ctx.pos;
+                    expr->next = buckets[slot];
+                    buckets[slot] = expr;
+                }
+            }
+
+            opt_record_defs(&ctx, insn);
+
+            if (value)
+                opt_record_value(&ctx, *jit_insn_opnd(insn, 0), value);
+        }
+    }
+
+    ret = true;
+
+fail:
+    jit_free(exprs);
+    jit_free(buckets);
+    opt_destroy(&ctx);
+    return ret;
+}
+
+/*
+ * Dead code elimination
+ */
+
+bool
+jit_pass_dce(JitCompContext *cc)
+{
+    uint32 *use_counts[JIT_REG_KIND_L32] = { 0 };
+    JitBasicBlock *block;
+    JitInsn *insn, *prev;
+    unsigned label_index, end_label_index, kind, num, i, first_use;
+    JitRegVec regvec;
+    JitReg *regp, r0;
+    bool ret = false;
+
+    if (opt_pass_disabled(JIT_OPT_PASS_DCE))
+        return true;
+
+    for (kind = JIT_REG_KIND_VOID + 1; kind < JIT_REG_KIND_L32; kind++) {
+        if ((num = jit_cc_reg_num(cc, kind)) > 0
+            && !(use_counts[kind] = jit_calloc(sizeof(uint32) * num))) {
+            jit_set_last_error(cc, "allocate memory failed");
+            goto fail;
+        }
+    }
+
+    /* Count the uses of each register in the whole function */
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        JIT_FOREACH_INSN(block, insn)
+        {
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            if (jit_reg_is_variable(*regp))
+                use_counts[jit_reg_kind(*regp)][jit_reg_no(*regp)]++;
+        }
+    }
+
+    /* Remove the pure instructions whose results aren't used, visiting
+       backward so that the operands of a removed instruction can be
+       removed in the same walk since virtual registers don't live across
+       blocks */
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        for (insn = jit_basic_block_last_insn(block);
+             insn != jit_basic_block_end_insn(block); insn = prev) {
+            prev = insn->prev;
+
+            if (!is_pure(insn->opcode))
+                continue;
+
+            r0 = *jit_insn_opnd(insn, 0);
+            if (!is_virtual_reg(cc, r0)
+                || use_counts[jit_reg_kind(r0)][jit_reg_no(r0)] > 0)
+                continue;
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            if (jit_reg_is_variable(*regp)) {
+                bh_assert(use_counts[jit_reg_kind(*regp)][jit_reg_no(*regp)]
+                          > 0);
+                use_counts[jit_reg_kind(*regp)][jit_reg_no(*regp)]--;
+            }
+
+            jit_insn_unlink(insn);
+            jit_insn_delete(insn);
+        }
+    }
+
+    ret = true;
+
+fail:
+    for (kind = JIT_REG_KIND_VOID + 1; kind < JIT_REG_KIND_L32; kind++)
+        jit_free(use_counts[kind]);
+    return ret;
+}
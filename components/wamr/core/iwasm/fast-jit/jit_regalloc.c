@@ -5,6 +5,7 @@
 
 #include "jit_utils.h"
 #include "jit_compiler.h"
+#include "jit_frontend.h"
 
 #if BH_DEBUG != 0
 #define VREG_DEF_SANITIZER
@@ -119,6 +120,74 @@ typedef struct SpillSlot {
     JitReg vreg;
 } SpillSlot;
 
+/**
+ * Maximum number of local variables considered for the global
+ * register allocation, live sets are kept in uint64 masks.
+ */
+#define GLOBAL_LOCAL_MAX 64
+
+/**
+ * Number of allocatable hard registers of each kind left to the local
+ * register allocation.
+ */
+#define GLOBAL_LOCAL_RESERVED_HREGS 3
+
+/**
+ * Information of a wasm local variable which may be kept in a hard
+ * register across basic blocks.  The local variable is still written
+ * through to its frame slot, which is used to reload the hard
+ * register after calls and evictions.
+ */
+typedef struct GlobalLocal {
+    /* Register kind of the local variable.  */
+    uint32 kind;
+
+    /* Index of the first frame cell of the local variable.  */
+    uint32 cell;
+
+    /* Offset of the frame slot in a constant register.  */
+    JitReg offset;
+
+    /* Number of loads weighted by the loop depth of their blocks.  */
+    uint64 weight;
+
+    /* The first and the last layout positions of the basic blocks in
+       which the local variable is live or accessed.  */
+    uint32 start, end;
+
+    /* Hard register numbers explicitly used by the basic blocks
+       within [start, end].  */
+    uint32 used_hregs;
+
+    /* The hard register allocated, 0 if it is kept in the frame.  */
+    JitReg hreg;
+} GlobalLocal;
+
+/**
+ * Information of a basic block for the global register allocation.
+ */
+typedef struct GlobalBlock {
+    /* Position of the basic block in the code layout.  */
+    uint32 pos;
+
+    /* Loop nesting depth of the basic block.  */
+    uint32 loop_depth;
+
+    /* Hard register numbers explicitly used by the basic block, one
+       mask for integer and one for floating point registers.  */
+    uint32 used_hregs[2];
+
+    /* Local variables accessed in the block.  */
+    uint64 accessed;
+
+    /* Local variables live at the beginning and the end of the block. */
+    uint64 live_in, live_out;
+
+    /* Index and number of the successors in the succs array, the
+       targets of the branches in the middle of the block come first.  */
+    uint32 succ_index, succ_num, mid_succ_num;
+} GlobalBlock;
+
 typedef struct RegallocContext {
     /* The compiler context.  */
     JitCompContext *cc;
@@ -139,6 +208,22 @@ typedef struct RegallocContext {
 
     /* The last define-released hard register.  */
     JitReg last_def_released_hreg;
+
+    /* Number of elements in the globals array.  */
+    uint32 global_num;
+
+    /* Local variables considered for the global register allocation.  */
+    GlobalLocal *globals;
+
+    /* Information of basic blocks indexed by label.  */
+    GlobalBlock *global_blocks;
+
+    /* Successor labels of all basic blocks.  */
+    uint32 *succs;
+
+    /* Frame offsets of the local variables held by hard registers in
+       the current basic block, 0 if the hard register holds none.  */
+    JitReg *global_homes[JIT_REG_KIND_L32];
 } RegallocContext;
 
 /**
@@ -305,9 +390,13 @@ rc_destroy(RegallocContext *rc)
 
         jit_free(rc->vregs[i]);
         jit_free(rc->hregs[i]);
+        jit_free(rc->global_homes[i]);
     }
 
     jit_free(rc->spill_slots);
+    jit_free(rc->globals);
+    jit_free(rc->global_blocks);
+    jit_free(rc->succs);
 }
 
 static bool
@@ -328,6 +417,9 @@ rc_init(RegallocContext *rc, JitCompContext *cc)
         if (hreg_num > 0
             && !(rc->hregs[i] = jit_calloc(sizeof(HardReg) * hreg_num)))
             goto fail;
+        if (hreg_num > 0
+            && !(rc->global_homes[i] = jit_calloc(sizeof(JitReg) * hreg_num)))
+            goto fail;
 
         /* Hard registers can only be allocated to themselves.  */
         for (j = 0; j < hreg_num; j++)
@@ -358,6 +450,25 @@ is_alloc_candidate(JitCompContext *cc, JitReg reg)
             && (!jit_cc_is_hreg(cc, reg) || !jit_cc_is_hreg_fixed(cc, reg)));
 }
 
+/**
+ * Get the frame slot of the local variable held by the hard register
+ * in the current basic block.
+ *
+ * @param rc the regalloc context
+ * @param reg the register
+ *
+ * @return the frame offset in a constant register if the register is
+ * a hard register holding a local variable, 0 otherwise
+ */
+static JitReg
+get_global_home(RegallocContext *rc, JitReg reg)
+{
+    if (rc->global_num == 0 || !jit_cc_is_hreg(rc->cc, reg))
+        return 0;
+
+    return rc->global_homes[jit_reg_kind(reg)][jit_reg_no(reg)];
+}
+
 #ifdef VREG_DEF_SANITIZER
 static void
 check_vreg_definition(RegallocContext *rc, JitInsn *insn)
@@ -387,6 +498,10 @@ check_vreg_definition(RegallocContext *rc, JitInsn *insn)
         if (reg_defined == *regp)
             continue;
 
+        /* hard registers holding local variables may be live-in */
+        if (get_global_home(rc, *regp))
+            continue;
+
         vr = rc_get_vr(rc, *regp);
         bh_assert(vr->distances);
     }
@@ -477,11 +592,16 @@ reload_vreg(RegallocContext *rc, JitReg vreg, JitInsn *cur_insn)
     {
         JitReg fp_reg = rc->cc->fp_reg, offset;
 
-        if (!vr->slot && !(vr->slot = rc_alloc_spill_slot(rc, vreg)))
-            /* Cannot allocte spill slot (due to OOM or frame size limit).  */
-            return NULL;
+        /* A hard register holding a local variable is reloaded from the
+           frame slot of the local variable.  */
+        if (!(offset = get_global_home(rc, vreg))) {
+            if (!vr->slot && !(vr->slot = rc_alloc_spill_slot(rc, vreg)))
+                /* Cannot allocte spill slot (due to OOM or frame size
+                   limit).  */
+                return NULL;
 
-        offset = offset_of_spill_slot(rc->cc, vr->slot);
+            offset = offset_of_spill_slot(rc->cc, vr->slot);
+        }
 
         switch (jit_reg_kind(vreg)) {
             case JIT_REG_KIND_I32:
@@ -577,6 +697,29 @@ spill_vreg(RegallocContext *rc, JitReg vreg, JitInsn *cur_insn)
     return insn;
 }
 
+/**
+ * Check whether the virtual register can be allocated to the hard
+ * register holding a local variable, which requires the hard register
+ * not to be used in the rest of the lifetime of the virtual register.
+ *
+ * @param rc the regalloc context
+ * @param vreg the virtual register
+ * @param hreg the hard register holding a local variable
+ *
+ * @return true if the hard register can be allocated
+ */
+static bool
+can_coalesce_global(RegallocContext *rc, JitReg vreg, JitReg hreg)
+{
+    UintStack *vreg_distances = (rc_get_vr(rc, vreg))->distances;
+    UintStack *hreg_distances = (rc_get_vr(rc, hreg))->distances;
+
+    /* The distances of the occurrences before the current instruction
+       are left in the stacks.  */
+    return !hreg_distances || !vreg_distances
+           || uint_stack_top(hreg_distances) <= (int)vreg_distances->elem[0];
+}
+
 /**
  * Allocate a hard register for the virtual register.  Necessary
  * reloade instruction will be inserted after the given instruction.
@@ -595,7 +738,7 @@ allocate_hreg(RegallocContext *rc, JitReg vreg, JitInsn *insn, int distance)
     const int kind = jit_reg_kind(vreg);
     const HardReg *hregs;
     unsigned hreg_num;
-    JitReg hreg, vreg_to_reload = 0;
+    JitReg hreg, vreg_to_reload = 0, free_hreg = 0;
     int min_distance = distance, vr_distance;
     VirtualReg *vr = rc_get_vr(rc, vreg);
     unsigned i;
@@ -622,23 +765,38 @@ allocate_hreg(RegallocContext *rc, JitReg vreg, JitInsn *insn, int distance)
     }
 
     /* Use the last define-released register if its kind is correct and
-       it's free so as to optimize for two-operand instructions.  */
+       it's free so as to optimize for two-operand instructions.  A hard
+       register holding a local variable is only used for the source of
+       the move to it, if it isn't used during the source's lifetime.  */
     if (jit_reg_kind(rc->last_def_released_hreg) == kind
-        && (rc_get_hr(rc, rc->last_def_released_hreg))->vreg == 0)
+        && (rc_get_hr(rc, rc->last_def_released_hreg))->vreg == 0
+        && (!get_global_home(rc, rc->last_def_released_hreg)
+            || (insn->opcode == JIT_OP_MOV
+                && *(jit_insn_opnd(insn, 0)) == rc->last_def_released_hreg
+                && can_coalesce_global(rc, vreg,
+                                       rc->last_def_released_hreg))))
         return rc->last_def_released_hreg;
 
-    /* No hint given, just try to pick any free register.  */
+    /* No hint given, just try to pick any free register, the ones
+       holding local variables in the block are the last choice.  */
     for (i = 0; i < hreg_num; i++) {
         hreg = jit_reg_new(kind, i);
 
         if (jit_cc_is_hreg_fixed(rc->cc, hreg))
             continue;
 
-        if (hregs[i].vreg == 0)
-            /* Found a free one, return it.  */
-            return hreg;
+        if (hregs[i].vreg == 0) {
+            if (!get_global_home(rc, hreg))
+                /* Found a free one, return it.  */
+                return hreg;
+            if (!free_hreg)
+                free_hreg = hreg;
+        }
     }
 
+    if (free_hreg)
+        return free_hreg;
+
     /* No free registers, need to spill and reload one.  */
     for (i = 0; i < hreg_num; i++) {
         if (jit_cc_is_hreg_fixed(rc->cc, jit_reg_new(kind, i)))
@@ -727,6 +885,1090 @@ clobber_live_regs(RegallocContext *rc, bool is_native, JitInsn *insn)
     return true;
 }
 
+/*
+ * Global register allocation of local variables
+ *
+ * The frontend keeps virtual registers local to basic blocks and
+ * loads the wasm local variables from their frame slots at the first
+ * use in each block, so loop-carried locals bounce through the frame
+ * on every iteration.  Before the local allocation, the live
+ * intervals of the local variables are computed over the code layout
+ * and a linear scan, weighted by the loop depth of the loads, keeps
+ * the hottest ones in hard registers across basic blocks: loads are
+ * turned into moves from the hard register and stores also update the
+ * hard register.  Stores to the frame slots are kept, so that the
+ * local allocation can simply reload the hard register from the frame
+ * slot after calls and when evicting it.
+ */
+
+/**
+ * Kinds of the accesses to the local variable area of the frame.
+ */
+enum {
+    /* Not an access to the local variable area.  */
+    LOCAL_ACCESS_NONE = 0,
+    /* Load of a whole local variable with its own kind.  */
+    LOCAL_ACCESS_LOAD,
+    /* Store of a whole local variable with its own kind.  */
+    LOCAL_ACCESS_STORE,
+    /* Other accesses overlapping the local variable area.  */
+    LOCAL_ACCESS_OTHER,
+    /* Access whose address is unknown.  */
+    LOCAL_ACCESS_UNKNOWN,
+};
+
+/**
+ * Information of a frame cell of the local variable area.
+ */
+typedef struct LocalCell {
+    /* Number of loads weighted by the loop depth of their blocks.  */
+    uint64 weight;
+
+    /* The first cell of the local variable the cell belongs to plus
+       one, 0 if the cell hasn't been accessed.  */
+    uint32 owner;
+
+    /* Register kind of the accesses starting from the cell.  */
+    uint8 kind;
+
+    /* Whether the cell is accessed in different ways.  */
+    bool conflict;
+} LocalCell;
+
+/**
+ * Get the layout position of a basic block, the code generator emits
+ * the entry block, the normal blocks and then the exit block.
+ *
+ * @param cc the compilation context
+ * @param label the label of the basic block
+ *
+ * @return the position of the basic block
+ */
+static uint32
+get_layout_pos(JitCompContext *cc, uint32 label)
+{
+    if (label == 0)
+        return 0;
+    if (label == 1)
+        return jit_cc_label_num(cc) - 1;
+    return label - 1;
+}
+
+/**
+ * Get the label of the basic block at a layout position.
+ *
+ * @param cc the compilation context
+ * @param pos the layout position
+ *
+ * @return the label of the basic block
+ */
+static uint32
+get_layout_label(JitCompContext *cc, uint32 pos)
+{
+    if (pos == 0)
+        return 0;
+    if (pos == jit_cc_label_num(cc) - 1)
+        return 1;
+    return pos + 1;
+}
+
+static bool
+is_cond_branch(JitInsn *insn)
+{
+    return insn->opcode >= JIT_OP_BEQ && insn->opcode <= JIT_OP_BLEU;
+}
+
+/**
+ * Get the successors of a basic block, including the targets of the
+ * branches in the middle of the block and the next block in the
+ * layout if the block falls through to it.
+ *
+ * @param cc the compilation context
+ * @param block the basic block
+ * @param label the label of the basic block
+ * @param succs the buffer to store the successor labels, or NULL
+ * @param p_mid_num return the number of the targets of the branches
+ * in the middle of the block
+ *
+ * @return the number of successors
+ */
+static uint32
+get_block_succs(JitCompContext *cc, JitBasicBlock *block, uint32 label,
+                uint32 *succs, uint32 *p_mid_num)
+{
+    JitInsn *insn, *last_insn = jit_basic_block_last_insn(block);
+    JitRegVec vec;
+    JitReg *regp;
+    uint32 num = 0, pos;
+    unsigned i;
+    bool fall_through = true;
+
+    JIT_FOREACH_INSN(block, insn)
+    {
+        if (!is_cond_branch(insn) || insn == last_insn)
+            continue;
+
+        for (i = 1; i <= 2; i++) {
+            JitReg target = *(jit_insn_opnd(insn, i));
+
+            if (target) {
+                if (succs)
+                    succs[num] = jit_reg_no(target);
+                num++;
+            }
+        }
+    }
+
+    *p_mid_num = num;
+
+    switch (last_insn->opcode) {
+        case JIT_OP_JMP:
+        case JIT_OP_LOOKUPSWITCH:
+            vec = jit_basic_block_succs(block);
+            JIT_REG_VEC_FOREACH(vec, i, regp)
+            if (*regp) {
+                if (succs)
+                    succs[num] = jit_reg_no(*regp);
+                num++;
+            }
+            fall_through = false;
+            break;
+        case JIT_OP_RETURNBC:
+        case JIT_OP_RETURN:
+            fall_through = false;
+            break;
+        default:
+            if (!is_cond_branch(last_insn))
+                break;
+            for (i = 1; i <= 2; i++)
+                if (*(jit_insn_opnd(last_insn, i))) {
+                    if (succs)
+                        succs[num] = jit_reg_no(*(jit_insn_opnd(last_insn, i)));
+                    num++;
+                }
+            fall_through = !*(jit_insn_opnd(last_insn, 2));
+            break;
+    }
+
+    pos = get_layout_pos(cc, label);
+    if (fall_through && pos + 1 < jit_cc_label_num(cc)) {
+        if (succs)
+            succs[num] = get_layout_label(cc, pos + 1);
+        num++;
+    }
+
+    return num;
+}
+
+/**
+ * Collect the positions, successors, loop depths and explicitly used
+ * hard registers of the basic blocks.
+ *
+ * @param rc the regalloc context
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+init_global_blocks(RegallocContext *rc)
+{
+    JitCompContext *cc = rc->cc;
+    const uint32 label_num = jit_cc_label_num(cc);
+    JitBasicBlock *block;
+    JitInsn *insn;
+    uint32 label, end_label, pos, succ_num = 0, i;
+    int32 *depth_diffs, depth = 0;
+
+    if (!(rc->global_blocks = jit_calloc(sizeof(GlobalBlock) * label_num)))
+        return false;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label, end_label, block)
+    {
+        rc->global_blocks[label].succ_index = succ_num;
+        rc->global_blocks[label].succ_num = get_block_succs(
+            cc, block, label, NULL, &rc->global_blocks[label].mid_succ_num);
+        succ_num += rc->global_blocks[label].succ_num;
+    }
+
+    if (succ_num > 0 && !(rc->succs = jit_malloc(sizeof(uint32) * succ_num)))
+        return false;
+
+    if (!(depth_diffs = jit_calloc(sizeof(int32) * (label_num + 1))))
+        return false;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label, end_label, block)
+    {
+        GlobalBlock *gb = &rc->global_blocks[label];
+
+        gb->pos = pos = get_layout_pos(cc, label);
+        get_block_succs(cc, block, label, rc->succs + gb->succ_index,
+                        &gb->mid_succ_num);
+
+        /* A branch to an earlier block closes a loop.  */
+        for (i = 0; i < gb->succ_num; i++) {
+            uint32 succ = rc->succs[gb->succ_index + i];
+            uint32 succ_pos = get_layout_pos(cc, succ);
+
+            if (succ_pos <= pos) {
+                depth_diffs[succ_pos]++;
+                depth_diffs[pos + 1]--;
+            }
+        }
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            JitRegVec regvec = jit_insn_opnd_regs(insn);
+            JitReg *regp;
+
+            JIT_REG_VEC_FOREACH(regvec, i, regp)
+            if (jit_reg_is_variable(*regp) && jit_cc_is_hreg(cc, *regp)) {
+                if (jit_reg_is_kind(I32, *regp)
+                    || jit_reg_is_kind(I64, *regp))
+                    gb->used_hregs[0] |= 1u << jit_reg_no(*regp);
+                else if (jit_reg_is_kind(F32, *regp)
+                         || jit_reg_is_kind(F64, *regp))
+                    gb->used_hregs[1] |= 1u << jit_reg_no(*regp);
+            }
+        }
+    }
+
+    for (pos = 0; pos < label_num; pos++) {
+        depth += depth_diffs[pos];
+        rc->global_blocks[get_layout_label(cc, pos)].loop_depth = depth;
+    }
+
+    jit_free(depth_diffs);
+    return true;
+}
+
+/**
+ * Classify an instruction accessing the local variable area of the
+ * frame.
+ *
+ * @param cc the compilation context
+ * @param insn the instruction
+ * @param p_cell return the first cell accessed
+ * @param p_cell_num return the number of cells accessed
+ * @param p_kind return the register kind of a load or store
+ *
+ * @return one of LOCAL_ACCESS_XXX
+ */
+static int
+classify_local_access(JitCompContext *cc, JitInsn *insn, uint32 *p_cell,
+                      uint32 *p_cell_num, uint32 *p_kind)
+{
+    const int64 locals_begin = offset_of_local(0);
+    const int64 locals_end = offset_of_local(cc->jit_frame->max_locals);
+    uint32 size, kind = JIT_REG_KIND_VOID;
+    bool is_load = false;
+    JitReg offset;
+    int64 begin, end;
+
+    switch (insn->opcode) {
+        case JIT_OP_LDI8:
+        case JIT_OP_LDU8:
+            is_load = true;
+            /* fall through */
+        case JIT_OP_STI8:
+            size = 1;
+            break;
+        case JIT_OP_LDI16:
+        case JIT_OP_LDU16:
+            is_load = true;
+            /* fall through */
+        case JIT_OP_STI16:
+            size = 2;
+            break;
+        case JIT_OP_LDU32:
+            is_load = true;
+            size = 4;
+            break;
+        case JIT_OP_LDI32:
+            is_load = true;
+            /* fall through */
+        case JIT_OP_STI32:
+            kind = JIT_REG_KIND_I32;
+            size = 4;
+            break;
+        case JIT_OP_LDU64:
+            is_load = true;
+            size = 8;
+            break;
+        case JIT_OP_LDI64:
+            is_load = true;
+            /* fall through */
+        case JIT_OP_STI64:
+            kind = JIT_REG_KIND_I64;
+            size = 8;
+            break;
+        case JIT_OP_LDF32:
+            is_load = true;
+            /* fall through */
+        case JIT_OP_STF32:
+            kind = JIT_REG_KIND_F32;
+            size = 4;
+            break;
+        case JIT_OP_LDF64:
+            is_load = true;
+            /* fall through */
+        case JIT_OP_STF64:
+            kind = JIT_REG_KIND_F64;
+            size = 8;
+            break;
+        case JIT_OP_LDPTR:
+        case JIT_OP_STPTR:
+            size = sizeof(void *);
+            break;
+        case JIT_OP_LDV64:
+        case JIT_OP_STV64:
+            size = 8;
+            break;
+        case JIT_OP_LDV128:
+        case JIT_OP_STV128:
+            size = 16;
+            break;
+        case JIT_OP_LDV256:
+        case JIT_OP_STV256:
+            size = 32;
+            break;
+        default:
+            return LOCAL_ACCESS_NONE;
+    }
+
+    if (*(jit_insn_opnd(insn, 1)) != cc->fp_reg)
+        return LOCAL_ACCESS_NONE;
+
+    offset = *(jit_insn_opnd(insn, 2));
+    if (!jit_reg_is_const(offset) || !jit_reg_is_kind(I32, offset))
+        return LOCAL_ACCESS_UNKNOWN;
+
+    begin = jit_cc_get_const_I32(cc, offset);
+    end = begin + size;
+    if (end <= locals_begin || begin >= locals_end)
+        return LOCAL_ACCESS_NONE;
+
+    if (begin < locals_begin)
+        begin = locals_begin;
+    if (end > locals_end)
+        end = locals_end;
+    *p_cell = (uint32)((begin - locals_begin) / 4);
+    *p_cell_num = (uint32)((end - locals_begin + 3) / 4) - *p_cell;
+    *p_kind = kind;
+
+    if (kind == JIT_REG_KIND_VOID
+        || jit_reg_kind(*(jit_insn_opnd(insn, 0))) != kind
+        || (begin - locals_begin) % 4 != 0 || end - begin != size)
+        return LOCAL_ACCESS_OTHER;
+
+    return is_load ? LOCAL_ACCESS_LOAD : LOCAL_ACCESS_STORE;
+}
+
+/**
+ * Record the accesses to the local variable area of the normal blocks
+ * in the cells.
+ *
+ * @param rc the regalloc context
+ * @param cells the cells of the local variable area
+ *
+ * @return false if the local variable area may be accessed in unknown
+ * ways, true otherwise
+ */
+static bool
+scan_local_accesses(RegallocContext *rc, LocalCell *cells)
+{
+    JitCompContext *cc = rc->cc;
+    const int64 locals_end = offset_of_local(cc->jit_frame->max_locals);
+    JitBasicBlock *block;
+    JitInsn *insn;
+    uint32 label, end_label, cell, cell_num, kind, i;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label, end_label, block)
+    {
+        const uint32 depth = rc->global_blocks[label].loop_depth;
+        const uint64 weight = (uint64)1 << (3 * (depth < 4 ? depth : 4));
+        bool fp_redefined = false;
+
+        /* Skip the entry block, which sets up the frame.  */
+        if (label == 0)
+            continue;
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            JitRegVec regvec = jit_insn_opnd_regs(insn);
+            unsigned first_use = jit_insn_opnd_first_use(insn), j;
+            JitReg *regp;
+            int access =
+                classify_local_access(cc, insn, &cell, &cell_num, &kind);
+
+            if (access == LOCAL_ACCESS_UNKNOWN
+                || (access != LOCAL_ACCESS_NONE && fp_redefined))
+                return false;
+
+            JIT_REG_VEC_FOREACH(regvec, j, regp)
+            {
+                if (*regp != cc->fp_reg)
+                    continue;
+
+                if (j < first_use)
+                    /* The frame of the caller after returning.  */
+                    fp_redefined = true;
+                else if (insn->opcode == JIT_OP_ADD) {
+                    /* Pointer into the frame, which must point to the
+                       operand stack.  */
+                    JitReg offset = *(jit_insn_opnd(insn, 2));
+
+                    if (j != 1 || !jit_reg_is_const(offset)
+                        || !jit_reg_is_kind(I32, offset)
+                        || jit_cc_get_const_I32(cc, offset) < locals_end)
+                        return false;
+                }
+                else if (insn->opcode == JIT_OP_MOV)
+                    return false;
+            }
+
+            if (access == LOCAL_ACCESS_NONE)
+                continue;
+
+            if (access == LOCAL_ACCESS_OTHER) {
+                for (i = cell; i < cell + cell_num; i++)
+                    cells[i].conflict = true;
+                continue;
+            }
+
+            for (i = cell; i < cell + cell_num; i++)
+                if (cells[i].owner && cells[i].owner != cell + 1)
+                    cells[i].conflict = true;
+
+            if (cells[cell].owner == cell + 1 && cells[cell].kind != kind)
+                cells[cell].conflict = true;
+
+            for (i = cell; i < cell + cell_num; i++)
+                if (!cells[i].owner)
+                    cells[i].owner = cell + 1;
+
+            if (cells[cell].owner == cell + 1) {
+                cells[cell].kind = kind;
+                if (access == LOCAL_ACCESS_LOAD)
+                    cells[cell].weight += weight;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get the index of the global local variable accessed by an
+ * instruction.
+ *
+ * @param rc the regalloc context
+ * @param insn the instruction
+ * @param cell_globals the global local indexes of the cells plus one
+ * @param p_is_load return whether the instruction is a load
+ *
+ * @return the index of the global local variable, -1 if the
+ * instruction doesn't access one
+ */
+static int32
+get_accessed_global(RegallocContext *rc, JitInsn *insn,
+                    const uint8 *cell_globals, bool *p_is_load)
+{
+    uint32 cell, cell_num, kind;
+    int access = classify_local_access(rc->cc, insn, &cell, &cell_num, &kind);
+
+    if ((access != LOCAL_ACCESS_LOAD && access != LOCAL_ACCESS_STORE)
+        || !cell_globals[cell])
+        return -1;
+
+    *p_is_load = access == LOCAL_ACCESS_LOAD;
+    return cell_globals[cell] - 1;
+}
+
+/**
+ * Select the local variables to be considered, at most
+ * GLOBAL_LOCAL_MAX ones with the highest weights.
+ *
+ * @param rc the regalloc context
+ * @param cells the cells of the local variable area
+ * @param cell_globals return the global local indexes of the cells
+ * plus one
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+select_global_locals(RegallocContext *rc, LocalCell *cells,
+                     uint8 *cell_globals)
+{
+    const uint32 max_locals = rc->cc->jit_frame->max_locals;
+    uint32 cell, i, j;
+
+    if (!(rc->globals = jit_calloc(sizeof(GlobalLocal) * GLOBAL_LOCAL_MAX)))
+        return false;
+
+    for (cell = 0; cell < max_locals; cell++) {
+        uint32 cell_num;
+        GlobalLocal *g;
+
+        if (cells[cell].owner != cell + 1 || cells[cell].weight == 0)
+            continue;
+
+        cell_num = cells[cell].kind == JIT_REG_KIND_I64
+                           || cells[cell].kind == JIT_REG_KIND_F64
+                       ? 2
+                       : 1;
+        for (i = cell; i < cell + cell_num; i++)
+            if (cells[i].conflict || cells[i].owner != cell + 1)
+                break;
+        if (i < cell + cell_num)
+            continue;
+
+        /* Keep the globals sorted by weight in descending order.  */
+        if (rc->global_num == GLOBAL_LOCAL_MAX) {
+            if (rc->globals[GLOBAL_LOCAL_MAX - 1].weight >= cells[cell].weight)
+                continue;
+            rc->global_num--;
+        }
+        for (i = rc->global_num;
+             i > 0 && rc->globals[i - 1].weight < cells[cell].weight; i--)
+            rc->globals[i] = rc->globals[i - 1];
+
+        g = &rc->globals[i];
+        memset(g, 0, sizeof(*g));
+        g->kind = cells[cell].kind;
+        g->cell = cell;
+        g->weight = cells[cell].weight;
+        rc->global_num++;
+    }
+
+    for (j = 0; j < rc->global_num; j++) {
+        rc->globals[j].offset =
+            jit_cc_new_const_I32(rc->cc, offset_of_local(rc->globals[j].cell));
+        cell_globals[rc->globals[j].cell] = (uint8)(j + 1);
+    }
+
+    return true;
+}
+
+/**
+ * Get the local variables live at the targets of a branch.
+ *
+ * @param rc the regalloc context
+ * @param insn the branch instruction
+ *
+ * @return the local variables live at the targets
+ */
+static uint64
+get_branch_live_in(RegallocContext *rc, JitInsn *insn)
+{
+    uint64 live = 0;
+    unsigned i;
+
+    for (i = 1; i <= 2; i++)
+        if (*(jit_insn_opnd(insn, i)))
+            live |= rc->global_blocks[jit_reg_no(*(jit_insn_opnd(insn, i)))]
+                        .live_in;
+
+    return live;
+}
+
+/**
+ * Compute the local variables live at the beginning of a normal block,
+ * the branches in the middle of the block are taken into account.
+ *
+ * @param rc the regalloc context
+ * @param block the basic block
+ * @param live_out the local variables live at the end of the block
+ * @param cell_globals the global local indexes of the cells plus one
+ *
+ * @return the local variables live at the beginning of the block
+ */
+static uint64
+compute_block_live_in(RegallocContext *rc, JitBasicBlock *block,
+                      uint64 live_out, const uint8 *cell_globals)
+{
+    JitInsn *insn, *last_insn = jit_basic_block_last_insn(block);
+    uint64 live = live_out;
+    bool is_load;
+    int32 idx;
+
+    JIT_FOREACH_INSN_REVERSE(block, insn)
+    {
+        if (is_cond_branch(insn) && insn != last_insn)
+            live |= get_branch_live_in(rc, insn);
+        else if ((idx = get_accessed_global(rc, insn, cell_globals, &is_load))
+                 >= 0) {
+            if (is_load)
+                live |= (uint64)1 << idx;
+            else
+                live &= ~((uint64)1 << idx);
+        }
+    }
+
+    return live;
+}
+
+/**
+ * Compute the liveness of the global local variables and their live
+ * intervals in the code layout.
+ *
+ * @param rc the regalloc context
+ * @param cell_globals the global local indexes of the cells plus one
+ */
+static void
+compute_global_liveness(RegallocContext *rc, const uint8 *cell_globals)
+{
+    JitCompContext *cc = rc->cc;
+    const uint32 label_num = jit_cc_label_num(cc);
+    JitBasicBlock *block;
+    JitInsn *insn;
+    uint32 label, end_label, pos, i;
+    bool is_load, changed;
+    int32 idx;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label, end_label, block)
+    {
+        if (label == 0)
+            continue;
+
+        JIT_FOREACH_INSN(block, insn)
+        if ((idx = get_accessed_global(rc, insn, cell_globals, &is_load)) >= 0)
+            rc->global_blocks[label].accessed |= (uint64)1 << idx;
+    }
+
+    do {
+        changed = false;
+
+        for (pos = label_num; pos > 0; pos--) {
+            const uint32 label = get_layout_label(cc, pos - 1);
+            GlobalBlock *gb = &rc->global_blocks[label];
+            uint64 live_out = 0, live_in = 0;
+
+            if (!(block = *(jit_annl_basic_block(
+                      cc, jit_reg_new(JIT_REG_KIND_L32, label)))))
+                continue;
+
+            for (i = gb->mid_succ_num; i < gb->succ_num; i++)
+                live_out |=
+                    rc->global_blocks[rc->succs[gb->succ_index + i]].live_in;
+
+            /* The local variables are loaded at the end of the entry
+               block.  */
+            if (label != 0)
+                live_in =
+                    compute_block_live_in(rc, block, live_out, cell_globals);
+
+            if (live_in != gb->live_in || live_out != gb->live_out) {
+                gb->live_in = live_in;
+                gb->live_out = live_out;
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    for (i = 0; i < rc->global_num; i++) {
+        GlobalLocal *g = &rc->globals[i];
+        const uint64 bit = (uint64)1 << i;
+
+        g->start = UINT32_MAX;
+        g->end = 0;
+
+        for (label = 0; label < label_num; label++) {
+            GlobalBlock *gb = &rc->global_blocks[label];
+
+            if ((gb->live_in | gb->live_out | gb->accessed) & bit) {
+                if (gb->pos < g->start)
+                    g->start = gb->pos;
+                if (gb->pos > g->end)
+                    g->end = gb->pos;
+            }
+        }
+
+        for (pos = g->start; pos <= g->end; pos++)
+            g->used_hregs |= rc->global_blocks[get_layout_label(cc, pos)]
+                                 .used_hregs[g->kind == JIT_REG_KIND_F32
+                                             || g->kind == JIT_REG_KIND_F64];
+    }
+}
+
+/**
+ * Allocate hard registers to the global local variables with a linear
+ * scan over their live intervals, the lowest weighted one gives its
+ * hard register up when running out of them.
+ *
+ * @param rc the regalloc context
+ */
+static void
+linear_scan_global_locals(RegallocContext *rc)
+{
+    JitCompContext *cc = rc->cc;
+    GlobalLocal *order[GLOBAL_LOCAL_MAX], *active[GLOBAL_LOCAL_MAX];
+    uint32 order_num = 0, active_num = 0, i, j, no;
+
+    /* Sort the local variables by the start of their intervals.  */
+    for (i = 0; i < rc->global_num; i++) {
+        GlobalLocal *g = &rc->globals[i];
+
+        if (g->start > g->end)
+            continue;
+        for (j = order_num; j > 0 && order[j - 1]->start > g->start; j--)
+            order[j] = order[j - 1];
+        order[j] = g;
+        order_num++;
+    }
+
+    for (i = 0; i < order_num; i++) {
+        GlobalLocal *g = order[i], *victim = NULL;
+        const bool is_fp =
+            g->kind == JIT_REG_KIND_F32 || g->kind == JIT_REG_KIND_F64;
+        const uint32 hreg_num = jit_cc_hreg_num(cc, g->kind);
+        uint32 allocatable = 0, kind_active = 0, busy = g->used_hregs;
+        JitReg hreg = 0;
+
+        /* Expire the intervals ended.  */
+        for (j = 0; j < active_num;)
+            if (active[j]->end < g->start)
+                active[j] = active[--active_num];
+            else
+                j++;
+
+        for (j = 0; j < active_num; j++) {
+            if ((active[j]->kind == JIT_REG_KIND_F32
+                 || active[j]->kind == JIT_REG_KIND_F64)
+                == is_fp)
+                busy |= 1u << jit_reg_no(active[j]->hreg);
+            if (active[j]->kind == g->kind)
+                kind_active++;
+        }
+
+        for (no = 0; no < hreg_num; no++)
+            if (!jit_cc_is_hreg_fixed(cc, jit_reg_new(g->kind, no)))
+                allocatable++;
+
+        if (kind_active + GLOBAL_LOCAL_RESERVED_HREGS < allocatable) {
+            /* Prefer the higher numbered ones, which are less often
+               used by the instructions explicitly.  */
+            for (no = hreg_num; no > 0; no--)
+                if (!jit_cc_is_hreg_fixed(cc, jit_reg_new(g->kind, no - 1))
+                    && !(busy & (1u << (no - 1)))) {
+                    hreg = jit_reg_new(g->kind, no - 1);
+                    break;
+                }
+        }
+
+        if (!hreg) {
+            /* Take the hard register of the lowest weighted one.  */
+            for (j = 0; j < active_num; j++)
+                if (active[j]->kind == g->kind
+                    && active[j]->weight < g->weight
+                    && !(g->used_hregs & (1u << jit_reg_no(active[j]->hreg)))
+                    && (!victim || active[j]->weight < victim->weight))
+                    victim = active[j];
+
+            if (!victim)
+                continue;
+
+            hreg = victim->hreg;
+            victim->hreg = 0;
+            for (j = 0; active[j] != victim; j++)
+                ;
+            active[j] = active[--active_num];
+        }
+
+        g->hreg = hreg;
+        active[active_num++] = g;
+    }
+}
+
+/**
+ * Replace the uses of the register loaded from a local variable with
+ * the hard register holding the local variable, until either of them
+ * is redefined.
+ *
+ * @param block the basic block
+ * @param load_insn the instruction loading the local variable
+ * @param hreg the hard register holding the local variable
+ *
+ * @return true if all the uses of the loaded register are replaced
+ */
+static bool
+propagate_global_local(JitBasicBlock *block, JitInsn *load_insn,
+                       JitReg hreg)
+{
+    JitReg reg = *(jit_insn_opnd(load_insn, 0));
+    JitInsn *insn;
+    bool replace = true;
+
+    for (insn = load_insn->next; insn != jit_basic_block_end_insn(block);
+         insn = insn->next) {
+        JitRegVec regvec = jit_insn_opnd_regs(insn);
+        unsigned first_use = jit_insn_opnd_first_use(insn), i;
+        JitReg *regp;
+
+        JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+        if (*regp == reg) {
+            if (!replace)
+                return false;
+            *regp = hreg;
+        }
+
+        JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+        {
+            if (*regp == reg)
+                return true;
+            if (*regp == hreg)
+                replace = false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Rewrite the accesses to the local variables allocated to hard
+ * registers.
+ *
+ * @param rc the regalloc context
+ * @param cell_globals the global local indexes of the cells plus one
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+rewrite_global_locals(RegallocContext *rc, const uint8 *cell_globals)
+{
+    JitCompContext *cc = rc->cc;
+    JitBasicBlock *block;
+    JitInsn *insn, *prev, *new_insn;
+    uint32 label, end_label, i;
+    uint64 allocated = 0;
+    bool is_load;
+    int32 idx;
+
+    for (i = 0; i < rc->global_num; i++)
+        if (rc->globals[i].hreg)
+            allocated |= (uint64)1 << i;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label, end_label, block)
+    {
+        uint64 live = rc->global_blocks[label].live_out & allocated;
+
+        if (label == 0)
+            continue;
+
+        for (insn = jit_basic_block_last_insn(block);
+             insn != jit_basic_block_end_insn(block); insn = prev) {
+            prev = insn->prev;
+
+            if (is_cond_branch(insn)
+                && insn != jit_basic_block_last_insn(block)) {
+                live |= get_branch_live_in(rc, insn) & allocated;
+                continue;
+            }
+
+            if ((idx = get_accessed_global(rc, insn, cell_globals, &is_load))
+                    < 0
+                || !(allocated & ((uint64)1 << idx)))
+                continue;
+
+            if (is_load) {
+                /* Use the hard register instead of the loaded register,
+                   or turn the load into MOV r0, hreg in place.  */
+                if (!jit_cc_is_hreg(cc, *(jit_insn_opnd(insn, 0)))
+                    && propagate_global_local(block, insn,
+                                              rc->globals[idx].hreg)) {
+                    jit_insn_unlink(insn);
+                    jit_insn_delete(insn);
+                }
+                else {
+                    insn->opcode = JIT_OP_MOV;
+                    insn->flags_u8 = 0;
+                    *(jit_insn_opnd(insn, 1)) = rc->globals[idx].hreg;
+                }
+                live |= (uint64)1 << idx;
+            }
+            else {
+                if (live & ((uint64)1 << idx)) {
+                    if (!(new_insn =
+                              jit_cc_new_insn(cc, MOV, rc->globals[idx].hreg,
+                                              *(jit_insn_opnd(insn, 0)))))
+                        return false;
+                    jit_insn_insert_after(insn, new_insn);
+                }
+                live &= ~((uint64)1 << idx);
+            }
+        }
+    }
+
+    /* Load the local variables live into the function body at the end
+       of the entry block.  */
+    insn = jit_basic_block_last_insn(jit_cc_entry_basic_block(cc));
+    for (i = 0; i < rc->global_num; i++) {
+        GlobalLocal *g = &rc->globals[i];
+        JitReg fp_reg = cc->fp_reg;
+
+        if (!g->hreg || !(rc->global_blocks[0].live_out & ((uint64)1 << i)))
+            continue;
+
+        switch (g->kind) {
+            case JIT_REG_KIND_I32:
+                new_insn =
+                    jit_cc_new_insn(cc, LDI32, g->hreg, fp_reg, g->offset);
+                break;
+            case JIT_REG_KIND_I64:
+                new_insn =
+                    jit_cc_new_insn(cc, LDI64, g->hreg, fp_reg, g->offset);
+                break;
+            case JIT_REG_KIND_F32:
+                new_insn =
+                    jit_cc_new_insn(cc, LDF32, g->hreg, fp_reg, g->offset);
+                break;
+            default:
+                new_insn =
+                    jit_cc_new_insn(cc, LDF64, g->hreg, fp_reg, g->offset);
+                break;
+        }
+
+        if (!new_insn)
+            return false;
+        jit_insn_insert_before(insn, new_insn);
+    }
+
+    return true;
+}
+
+/**
+ * Keep the hot local variables of the function in hard registers
+ * across basic blocks.
+ *
+ * @param rc the regalloc context
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+allocate_global_locals(RegallocContext *rc)
+{
+    JitCompContext *cc = rc->cc;
+    LocalCell *cells = NULL;
+    uint8 *cell_globals = NULL;
+    bool ret = false;
+    uint32 max_locals, i;
+
+    if (jit_compiler_get_jit_globals()->disabled_opt_passes
+        & JIT_OPT_PASS_GLOBAL_REGALLOC)
+        return true;
+
+    if (!cc->jit_frame || (max_locals = cc->jit_frame->max_locals) == 0)
+        return true;
+
+    /* The hard register masks are kept in uint32.  */
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++)
+        if (jit_cc_hreg_num(cc, i) > 32)
+            return true;
+
+    /* The local variables are loaded before the jump to the body.  */
+    if (jit_basic_block_last_insn(jit_cc_entry_basic_block(cc))->opcode
+        != JIT_OP_JMP)
+        return true;
+
+    if (!init_global_blocks(rc)
+        || !(cells = jit_calloc(sizeof(LocalCell) * max_locals))
+        || !(cell_globals = jit_calloc(max_locals)))
+        goto fail;
+
+    if (!scan_local_accesses(rc, cells)) {
+        ret = true;
+        goto fail;
+    }
+
+    if (!select_global_locals(rc, cells, cell_globals))
+        goto fail;
+
+    if (rc->global_num > 0) {
+        compute_global_liveness(rc, cell_globals);
+        linear_scan_global_locals(rc);
+        if (!rewrite_global_locals(rc, cell_globals))
+            goto fail;
+    }
+
+    ret = true;
+
+fail:
+    if (!ret)
+        jit_set_last_error(cc, "allocate memory failed");
+    jit_free(cells);
+    jit_free(cell_globals);
+    return ret;
+}
+
+/**
+ * Set up the hard registers holding the global local variables at the
+ * end of the basic block: those live at the end are bound to
+ * themselves, and all of them reload from the frame slots when
+ * evicted within the block.
+ *
+ * @param rc the regalloc context
+ * @param label the label of the basic block
+ */
+static void
+bind_global_locals(RegallocContext *rc, uint32 label)
+{
+    GlobalBlock *gb = &rc->global_blocks[label];
+    uint32 i;
+
+    /* Don't take the hint from the previous block.  */
+    rc->last_def_released_hreg = 0;
+
+    for (i = 0; i < rc->global_num; i++) {
+        GlobalLocal *g = &rc->globals[i];
+        HardReg *hr;
+
+        if (!g->hreg)
+            continue;
+
+        hr = rc_get_hr(rc, g->hreg);
+        if (hr->vreg) {
+            (rc_get_vr(rc, hr->vreg))->hreg = 0;
+            hr->vreg = 0;
+        }
+        rc->global_homes[g->kind][jit_reg_no(g->hreg)] = 0;
+    }
+
+    for (i = 0; i < rc->global_num; i++) {
+        GlobalLocal *g = &rc->globals[i];
+
+        if (!g->hreg || gb->pos < g->start || gb->pos > g->end)
+            continue;
+
+        rc->global_homes[g->kind][jit_reg_no(g->hreg)] = g->offset;
+        if (gb->live_out & ((uint64)1 << i)) {
+            (rc_get_hr(rc, g->hreg))->vreg = g->hreg;
+            (rc_get_vr(rc, g->hreg))->hreg = g->hreg;
+        }
+    }
+}
+
+/**
+ * Make the hard registers of the local variables live at the targets
+ * of a branch in the middle of a block hold them at the branch.
+ *
+ * @param rc the regalloc context
+ * @param insn the branch instruction
+ * @param distance the distance of the branch instruction
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+bind_branch_global_locals(RegallocContext *rc, JitInsn *insn, int distance)
+{
+    uint64 live = get_branch_live_in(rc, insn);
+    uint32 i;
+
+    for (i = 0; i < rc->global_num; i++)
+        if (rc->globals[i].hreg && (live & ((uint64)1 << i))
+            && !allocate_for_vreg(rc, rc->globals[i].hreg, insn, distance))
+            return false;
+
+    return true;
+}
+
 /**
  * Do local register allocation for the given basic block
  *
@@ -780,7 +2022,12 @@ allocate_for_basic_block(RegallocContext *rc, JitBasicBlock *basic_block,
             vr->hreg = vr->slot = 0;
         }
 
-        if (insn->opcode == JIT_OP_CALLBC) {
+        if (rc->global_num > 0 && is_cond_branch(insn)
+            && insn != jit_basic_block_last_insn(basic_block)) {
+            if (!bind_branch_global_locals(rc, insn, distance))
+                return false;
+        }
+        else if (insn->opcode == JIT_OP_CALLBC) {
             if (!clobber_live_regs(rc, false, insn))
                 return false;
 
@@ -828,18 +2075,27 @@ jit_pass_regalloc(JitCompContext *cc)
     /* NOTE: don't allocate new virtual registers during allocation
        because the rc->vregs array is fixed size.  */
 
-    /* TODO: allocate hard registers for global virtual registers here.
-       Currently, exec_env_reg is the only global virtual register.  */
+#if WASM_ENABLE_FAST_JIT_GLOBAL_REGALLOC != 0
+    /* Keep the hot local variables in hard registers across blocks.  */
+    if (!allocate_global_locals(&rc))
+        goto cleanup_and_return;
+#else
+    (void)allocate_global_locals;
+#endif
+
+    /* exec_env_reg is the only global virtual register.  */
     self_vr = rc_get_vr(&rc, cc->exec_env_reg);
 
     JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, basic_block)
     {
         int distance;
 
-        /* TODO: initialize hreg for live-out registers.  */
         self_vr->hreg = self_vr->global_hreg;
         (rc_get_hr(&rc, cc->exec_env_reg))->vreg = cc->exec_env_reg;
 
+        if (rc.global_num > 0)
+            bind_global_locals(&rc, label_index);
+
         /**
          * TODO: the allocation of a basic block keeps using vregs[]
          * and hregs[] from previous basic block
@@ -63,6 +63,7 @@ typedef struct AOTCompOption {
     bool enable_simd;
     bool enable_ref_types;
     bool enable_gc;
+    bool enable_gc_write_barrier;
     bool enable_aux_stack_check;
     AOTStackFrameType aux_stack_frame_type;
     AOTCallStackFeatures call_stack_features;
@@ -72,6 +73,7 @@ typedef struct AOTCompOption {
     bool disable_llvm_lto;
     bool enable_llvm_pgo;
     bool enable_stack_estimation;
+    bool emit_stack_usage;
     bool quick_invoke_c_api_import;
     bool enable_shared_heap;
     char *use_prof_file;
@@ -189,6 +189,7 @@ struct wasm_config_t {
     MemAllocOption mem_alloc_option;
     uint32_t segue_flags;
     bool enable_linux_perf;
+    const char *module_cache_dir;
     /*TODO: wasi args*/
 };
 
@@ -207,6 +208,7 @@ typedef struct InstantiationArgs {
  * - mem_alloc_type is Alloc_With_System_Allocator
  * - mem_alloc_option is all 0
  * - enable_linux_perf is false
+ * - module_cache_dir is NULL
  */
 WASM_API_EXTERN own wasm_config_t* wasm_config_new(void);
 
@@ -228,6 +230,21 @@ wasm_config_set_linux_perf_opt(wasm_config_t *, bool);
 WASM_API_EXTERN wasm_config_t*
 wasm_config_set_segue_flags(wasm_config_t *config, uint32_t segue_flags);
 
+/**
+ * Set the directory where the module cache persists the AOT images of the
+ * loaded modules, so that they can be reused after the engine restarts.
+ * The images are named after the SHA-256 digest of the wasm binaries. It is
+ * only used when the runtime is built with WAMR_BUILD_WASM_CACHE=1, and the
+ * images are only generated by the LLVM JIT with eager compilation.
+ * The string is copied when the engine is created.
+ * The images are run as native code, the directory must only be writable
+ * by the user running the engine: the cache is disabled if the directory
+ * is writable by group or others, and an image is only loaded if it matches
+ * the SHA-256 digest persisted along with it.
+ */
+WASM_API_EXTERN wasm_config_t*
+wasm_config_set_module_cache_dir(wasm_config_t *config, const char *dir);
+
 // Engine
 
 WASM_DECLARE_OWN(engine)
@@ -538,6 +555,8 @@ typedef struct LoadArgs {
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
     bool no_resolve;
+    /* This option is only used by the wasm loader (see wasm_export.h) */
+    bool defer_validation;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -592,6 +611,19 @@ WASM_API_EXTERN size_t wasm_func_result_arity(const wasm_func_t*);
 WASM_API_EXTERN own wasm_trap_t* wasm_func_call(
   const wasm_func_t*, const wasm_val_vec_t* args, wasm_val_vec_t* results);
 
+/**
+ * Call a function `count` times, the args of the i-th call are
+ * args[i * param_arity, (i + 1) * param_arity), and its results are stored
+ * into results[i * result_arity, (i + 1) * result_arity).
+ * The function and the execution environment are resolved once for all
+ * the calls. If a call traps, the calls after it are skipped and the trap
+ * is returned. The number of the calls which returned is stored into
+ * `completed` if it isn't NULL.
+ */
+WASM_API_EXTERN own wasm_trap_t* wasm_func_call_batch(
+  const wasm_func_t*, const wasm_val_t args[], wasm_val_t results[],
+  size_t count, size_t *completed);
+
 
 // Global Instances
 
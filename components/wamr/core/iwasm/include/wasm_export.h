@@ -137,6 +137,10 @@ typedef struct wasm_section_t {
     uint32_t section_body_size;
 } wasm_section_t, aot_section_t, *wasm_section_list_t, *aot_section_list_t;
 
+/* Chunked loader */
+struct WASMStreamLoader;
+typedef struct WASMStreamLoader *wasm_stream_loader_t;
+
 /* Execution environment, e.g. stack info */
 struct WASMExecEnv;
 typedef struct WASMExecEnv *wasm_exec_env_t;
@@ -144,6 +148,9 @@ typedef struct WASMExecEnv *wasm_exec_env_t;
 struct WASMSharedHeap;
 typedef struct WASMSharedHeap *wasm_shared_heap_t;
 
+struct WASMChannel;
+typedef struct WASMChannel *wasm_channel_t;
+
 /* Package Type */
 typedef enum {
     Wasm_Module_Bytecode = 0,
@@ -194,6 +201,27 @@ typedef struct mem_alloc_info_t {
     uint32_t highmark_size;
 } mem_alloc_info_t;
 
+/* Usage of the Fast JIT code cache */
+typedef struct fast_jit_code_cache_info_t {
+    uint32_t total_size;
+    /* size of the code and the headers of the blocks */
+    uint32_t used_size;
+    uint32_t free_size;
+    /* size of the largest code that can be allocated without evicting
+       functions or compacting the code cache */
+    uint32_t largest_free_size;
+    /* number of functions whose jitted code is in the code cache */
+    uint32_t function_count;
+    /* number of allocations failed as the code cache is full */
+    uint32_t alloc_failures;
+    /* number of functions evicted as they were called least */
+    uint32_t evicted_function_count;
+    /* number of compactions, 0 unless the compaction is enabled */
+    uint32_t compaction_count;
+    /* total size of the jitted code moved by compaction */
+    uint64_t moved_size;
+} fast_jit_code_cache_info_t;
+
 /* Running mode of runtime and module instance*/
 typedef enum RunningMode {
     Mode_Interp = 1,
@@ -223,6 +251,16 @@ typedef struct RuntimeInitArgs {
 
     /* Fast JIT code cache size */
     uint32_t fast_jit_code_cache_size;
+    /* Fast JIT IR optimization passes to disable, 0 runs all of the ones
+       built in: 0x1 constant folding, 0x2 copy propagation, 0x4 common
+       subexpression elimination, 0x8 dead code elimination (built with
+       WAMR_BUILD_FAST_JIT_OPT_PASSES=1) and 0x10 global register
+       allocation of local variables (built with
+       WAMR_BUILD_FAST_JIT_GLOBAL_REGALLOC=1) */
+    uint32_t fast_jit_disabled_opt_passes;
+    /* Fast JIT call count after which a function is compiled by the
+       background compile threads, 0 uses the default threshold */
+    uint32_t fast_jit_compile_threshold;
 
     /* Default GC heap size */
     uint32_t gc_heap_size;
@@ -262,6 +300,11 @@ typedef struct LoadArgs {
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
     bool no_resolve;
+    /* false by default, used by the wasm loader only when the functions
+       are prepared lazily (WASM_ENABLE_LAZY_FAST_INTERP). If true, the
+       function bodies aren't validated when loading but on their first
+       call, only set it for trusted wasm binaries */
+    bool defer_validation;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -335,9 +378,49 @@ typedef enum {
 } log_level_t;
 
 typedef struct SharedHeapInitArgs {
+    /* Initial size of the shared heap */
     uint32_t size;
+    /* Size the shared heap may grow to, by adding segments when an
+       allocation doesn't fit. With hardware bound check the address
+       range is reserved when the heap is created, otherwise each segment
+       is allocated when the heap grows. 0 or a value not larger than
+       size means the heap doesn't grow */
+    uint32_t max_size;
 } SharedHeapInitArgs;
 
+/* Called after a message is sent to a channel, by the sending thread */
+typedef void (*wasm_channel_notify_callback_t)(wasm_channel_t channel,
+                                               void *user_data);
+
+typedef struct ChannelInitArgs {
+    /* Shared heap the messages are allocated from */
+    wasm_shared_heap_t shared_heap;
+    /* Max number of messages in the channel, rounded up to a power of 2 */
+    uint32_t capacity;
+    /* Callback called after each message sent, so that the embedder can
+       wake up or schedule the receiver, may be NULL. It is fixed for the
+       life of the channel so the senders read it without a lock */
+    wasm_channel_notify_callback_t notify;
+    /* User data passed to the notify callback */
+    void *notify_user_data;
+} ChannelInitArgs;
+
+/* Status of the channel operations, also returned to the wasm app */
+typedef enum {
+    WASM_CHANNEL_OK = 0,
+    /* No message to receive in polling mode */
+    WASM_CHANNEL_EMPTY = 1,
+    /* No room to send in polling mode */
+    WASM_CHANNEL_FULL = 2,
+    WASM_CHANNEL_TIMEOUT = 3,
+    /* The channel is closed, and empty when receiving */
+    WASM_CHANNEL_CLOSED = 4,
+    /* Invalid channel or message buffer */
+    WASM_CHANNEL_INVALID = 5,
+    /* The waiting module instance got an exception, e.g. was terminated */
+    WASM_CHANNEL_INTERRUPTED = 6
+} wasm_channel_status_t;
+
 /**
  * Initialize the WASM runtime environment, and also initialize
  * the memory allocator with system allocator, which calls os_malloc
@@ -429,6 +512,16 @@ wasm_runtime_free(void *ptr);
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_get_mem_alloc_info(mem_alloc_info_t *mem_alloc_info);
 
+/**
+ * Get the usage of the Fast JIT code cache
+ *
+ * @param info the buffer to store the usage
+ *
+ * @return true if success, false if Fast JIT isn't enabled
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_fast_jit_code_cache_info(fast_jit_code_cache_info_t *info);
+
 /**
  * Get the package type of a buffer.
  *
@@ -603,6 +696,70 @@ WASM_RUNTIME_API_EXTERN wasm_module_t
 wasm_runtime_load_from_sections(wasm_section_list_t section_list, bool is_aot,
                                 char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Create a chunked loader, which loads a WASM module from the bytes
+ * pushed with wasm_runtime_stream_load_feed() in chunks of any size, e.g.
+ * while the module is being received or read from flash. The loader keeps
+ * each section in its own buffer and frees them once the module is loaded,
+ * so there is no buffer holding the whole file. The sections are only
+ * decoded and validated by wasm_runtime_stream_load_finish(). Only WASM
+ * bytecode for the fast interpreter can be loaded this way.
+ *
+ * @param args the load arguments, args->name must be kept until the module
+ *        is unloaded, args->wasm_binary_freeable is ignored
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return the chunked loader, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_stream_loader_t
+wasm_runtime_stream_load_create(const LoadArgs *args, char *error_buf,
+                                uint32_t error_buf_size);
+
+/**
+ * Push the next bytes of the WASM file to the chunked loader. The magic
+ * header, the section ids, the section order and the section sizes are
+ * checked as the bytes arrive, so a malformed file fails early, the
+ * section contents are buffered without being decoded.
+ *
+ * @param loader the chunked loader
+ * @param buf the next bytes, they can be reused once the call returns
+ * @param size the number of bytes
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return true if success, false otherwise, the loader must be destroyed
+ *         or finished after a failure
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_stream_load_feed(wasm_stream_loader_t loader, const uint8_t *buf,
+                              uint32_t size, char *error_buf,
+                              uint32_t error_buf_size);
+
+/**
+ * Load the WASM module from the bytes pushed to the chunked loader, which
+ * decodes the sections, validates the functions and prepares the bytecode,
+ * and destroy the loader whether the loading succeeds or not.
+ *
+ * @param loader the chunked loader
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return the WASM module loaded, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_t
+wasm_runtime_stream_load_finish(wasm_stream_loader_t loader, char *error_buf,
+                                uint32_t error_buf_size);
+
+/**
+ * Destroy a chunked loader without loading the module, e.g. when the
+ * transfer is aborted.
+ *
+ * @param loader the chunked loader
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_stream_load_destroy(wasm_stream_loader_t loader);
+
 /**
  * Unload a WASM module.
  *
@@ -683,6 +840,30 @@ wasm_runtime_set_wasi_ns_lookup_pool(wasm_module_t module,
                                      const char *ns_lookup_pool[],
                                      uint32_t ns_lookup_pool_size);
 
+/**
+ * Get the stack sizes needed to call any function of an AOT module, which
+ * `wamrc --emit-stack-usage` computes from the call graph of the module and
+ * records in the AOT file. The sizes don't cover the native functions,
+ * which are expected to fit in WASM_STACK_GUARD_SIZE (see core/config.h),
+ * nor the recursion of a native function calling back into the module.
+ *
+ * @param module the WASM module
+ * @param native_stack_size return the native stack size needed below the
+ *        caller of wasm_runtime_call_wasm(), including WASM_STACK_GUARD_SIZE,
+ *        or 0 if the module isn't compiled with the native stack bounds
+ *        checks, in which case wamrc doesn't know the native stack usage
+ * @param wasm_stack_size return the size of the wasm operand stack of an
+ *        execution environment
+ *
+ * @return true if the sizes are returned, false if the module isn't such an
+ *         AOT module, or its call graph is recursive or can't be resolved,
+ *         in which case a guarded maximum should be used
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_module_stack_usage(const wasm_module_t module,
+                                    uint32_t *native_stack_size,
+                                    uint32_t *wasm_stack_size);
+
 /**
  * Instantiate a WASM module.
  *
@@ -693,7 +874,11 @@ wasm_runtime_set_wasi_ns_lookup_pool(wasm_module_t module,
  *        create the operation stack internally with the stack size specified
  *        here. And API wasm_runtime_create_exec_env() creates the operation
  *        stack with stack size specified by its parameter, the stack size
- *        specified here is ignored.
+ *        specified here is ignored. If it is 0, the stack size needed by
+ *        the call graph of an AOT module compiled with
+ *        `wamrc --emit-stack-usage` is used, see
+ *        wasm_runtime_get_module_stack_usage(), but no less than 2 KB, or
+ *        the default size if it isn't recorded or is 0.
  * @param host_managed_heap_size the default heap size of the module instance,
  *        a heap will be created besides the app memory space. Both wasm app
  *        and native function can allocate memory from the heap.
@@ -864,6 +1049,73 @@ wasm_runtime_create_exec_env(wasm_module_inst_t module_inst,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_destroy_exec_env(wasm_exec_env_t exec_env);
 
+/**
+ * Create a pool of idle execution environments for the instance, so that
+ * the short-lived calls from the host, e.g. event callbacks, can check out
+ * an execution environment and its operand stack instead of creating and
+ * destroying one for each call. Checking out and returning take no locks.
+ *
+ * Note: The calls into one instance must still be serialized, even with
+ * separate execution environments, unless the wasm app is built for
+ * threads and shared memory: use one instance per worker thread to run
+ * calls in parallel.
+ *
+ * @param module_inst the module instance
+ * @param max_idle the max number of idle execution environments kept
+ * @param stack_size the stack size of the execution environments, 0 to
+ *        use the default stack size of the instance
+ * @param bind_thread whether to check out the execution environment the
+ *        current thread returned last first, so that it keeps running on
+ *        the same (cache-warm) stack
+ *
+ * @return true if success, false if the pool has already been created or
+ *         failed to allocate memory
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_create_exec_env_pool(wasm_module_inst_t module_inst,
+                                  uint32_t max_idle, uint32_t stack_size,
+                                  bool bind_thread);
+
+/**
+ * Check out an execution environment of the instance. It is taken from the
+ * pool if there is an idle one, or else created. If the pool hasn't been
+ * created, the execution environment is always created with the default
+ * stack size.
+ *
+ * Note: The execution environment must be returned with
+ * wasm_runtime_return_exec_env, by any thread, before the instance is
+ * deinstantiated.
+ *
+ * @param module_inst the module instance
+ *
+ * @return the execution environment, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_exec_env_t
+wasm_runtime_checkout_exec_env(wasm_module_inst_t module_inst);
+
+/**
+ * Return an execution environment checked out, it is kept in the pool if
+ * the pool isn't full, or else destroyed.
+ *
+ * @param exec_env the execution environment to return
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_return_exec_env(wasm_exec_env_t exec_env);
+
+/**
+ * Destroy the idle execution environments of the pool which weren't needed
+ * since the last trim: the pool keeps as many as the peak number of the
+ * execution environments checked out at once in that period. Call it
+ * periodically, e.g. from the idle task, to give the memory back after a
+ * burst of calls.
+ *
+ * @param module_inst the module instance
+ *
+ * @return the number of execution environments destroyed
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_trim_exec_env_pool(wasm_module_inst_t module_inst);
+
 /**
  * Get the singleton execution environment for the instance.
  *
@@ -1817,6 +2069,177 @@ WASM_RUNTIME_API_EXTERN double
 wasm_runtime_get_wasm_func_exec_time(wasm_module_inst_t inst,
                                      const char *func_name);
 
+/**
+ * Start the sampling profiler, which creates a sampler thread that asks
+ * the attached exec_envs to record their wasm call stacks every
+ * interval_us microseconds. Only the fast interpreter takes samples.
+ * The samples recorded before are discarded.
+ *
+ * @param interval_us the sampling interval in microseconds
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_sampling_profiler_start(uint32_t interval_us);
+
+/**
+ * Stop the sampling profiler, the recorded samples are kept and can
+ * still be dumped.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_sampling_profiler_stop(void);
+
+/**
+ * Add an exec_env to the set sampled by the sampling profiler, the
+ * exec_env is detached automatically when it is destroyed.
+ *
+ * @param exec_env the execution environment to sample
+ *
+ * @return true if success, false if too many exec_envs are attached
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_sampling_profiler_attach(wasm_exec_env_t exec_env);
+
+/**
+ * Remove an exec_env from the set sampled by the sampling profiler
+ *
+ * @param exec_env the execution environment
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_sampling_profiler_detach(wasm_exec_env_t exec_env);
+
+/**
+ * Dump the samples to stdout in the folded stack format, one
+ * "root;...;leaf count" line per distinct call stack. Wasm functions
+ * are named "aot_func#N", where N is the index of the function without
+ * the import functions, so the output can be translated by
+ * test-tools/flame-graph-helper and rendered by flamegraph.pl.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_sampling_profiler_dump(void);
+
+/**
+ * Get the size required to store the folded stacks, including the
+ * space for terminating null byte ('\0')
+ *
+ * @return size required to store the contents, 0 means error
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_sampling_profiler_get_buf_size(void);
+
+/**
+ * Dump the samples to buffer in the folded stack format
+ *
+ * @param buf buffer to store the dumped content
+ * @param len length of the buffer
+ *
+ * @return bytes dumped to the buffer, including the terminating null
+ *         byte ('\0'), 0 means error and data in buf may be invalid
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_sampling_profiler_dump_to_buf(char *buf, uint32_t len);
+
+/* Number of buckets of wasm_metrics_histogram_t */
+#define WASM_METRICS_HISTOGRAM_BUCKETS 24
+
+/* Max length of the symbol name in wasm_native_call_metric_t */
+#define WASM_METRICS_SYMBOL_NAME_LEN 48
+
+/* Latency histogram with power-of-two buckets in microseconds */
+typedef struct wasm_metrics_histogram_t {
+    uint64_t count;
+    uint64_t total_us;
+    uint64_t max_us;
+    /* buckets[0] counts the samples of 0 us, buckets[i] counts the
+       samples in [2^(i-1), 2^i) us, and the last bucket also counts
+       all the longer samples */
+    uint64_t buckets[WASM_METRICS_HISTOGRAM_BUCKETS];
+} wasm_metrics_histogram_t;
+
+/* Kinds of the exceptions counted by the runtime metrics */
+typedef enum wasm_metrics_exception_kind_t {
+    WASM_METRICS_EXCE_UNREACHABLE = 0,
+    WASM_METRICS_EXCE_OUT_OF_MEMORY,
+    WASM_METRICS_EXCE_OUT_OF_BOUNDS_MEMORY_ACCESS,
+    WASM_METRICS_EXCE_INTEGER_OVERFLOW,
+    WASM_METRICS_EXCE_INTEGER_DIVIDE_BY_ZERO,
+    WASM_METRICS_EXCE_INVALID_CONVERSION_TO_INTEGER,
+    /* indirect call type mismatch, invalid function index,
+       undefined or uninitialized element */
+    WASM_METRICS_EXCE_INDIRECT_CALL,
+    /* native, auxiliary or operand stack overflow/underflow */
+    WASM_METRICS_EXCE_STACK_OVERFLOW,
+    WASM_METRICS_EXCE_OUT_OF_BOUNDS_TABLE_ACCESS,
+    WASM_METRICS_EXCE_NULL_REFERENCE,
+    WASM_METRICS_EXCE_OTHER,
+    WASM_METRICS_EXCE_KIND_NUM
+} wasm_metrics_exception_kind_t;
+
+/* Snapshot of the runtime metrics, summed over all threads */
+typedef struct wasm_runtime_metrics_t {
+    uint64_t module_load_count;
+    uint64_t module_load_failures;
+    wasm_metrics_histogram_t module_load_time;
+    uint64_t instantiation_count;
+    uint64_t instantiation_failures;
+    wasm_metrics_histogram_t instantiation_time;
+    /* memory.grow and wasm_runtime_enlarge_memory calls */
+    uint64_t memory_grow_count;
+    uint64_t memory_grow_failures;
+    uint64_t memory_grow_bytes;
+    uint64_t exceptions[WASM_METRICS_EXCE_KIND_NUM];
+    /* native functions called by the interpreter */
+    uint64_t native_call_count;
+    /* garbage collections of the GC heaps */
+    wasm_metrics_histogram_t gc_pause_time;
+    /* high-water mark of the runtime pool allocator, 0 if the runtime
+       isn't initialized with Alloc_With_Pool */
+    uint64_t heap_highmark_size;
+    /* number of the running threads which have recorded metrics */
+    uint32_t thread_count;
+} wasm_runtime_metrics_t;
+
+/* Number of calls to a native function */
+typedef struct wasm_native_call_metric_t {
+    /* "module_name.field_name" of the import, may be truncated */
+    char symbol[WASM_METRICS_SYMBOL_NAME_LEN];
+    uint64_t call_count;
+} wasm_native_call_metric_t;
+
+/**
+ * Get a snapshot of the runtime metrics. The counters are kept per
+ * thread and summed up here, so the snapshot may be slightly behind
+ * the threads which are running.
+ *
+ * @param metrics the buffer to store the snapshot
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_metrics(wasm_runtime_metrics_t *metrics);
+
+/**
+ * Get the number of calls to each native function called by the
+ * interpreter, summed over all threads
+ *
+ * @param buf the buffer to store the metrics, can be NULL
+ * @param buf_count the number of entries of buf
+ *
+ * @return the number of native functions recorded, which can be larger
+ *         than buf_count
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_get_native_call_metrics(wasm_native_call_metric_t *buf,
+                                     uint32_t buf_count);
+
+/**
+ * Reset all the runtime metrics to zero. The reset isn't atomic with
+ * respect to the threads recording metrics at the same time, an event
+ * they record meanwhile may be lost or partly kept.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_reset_metrics(void);
+
 /* wasm thread callback function type */
 typedef void *(*wasm_thread_callback_t)(wasm_exec_env_t, void *);
 /* wasm thread type */
@@ -2000,6 +2423,43 @@ WASM_RUNTIME_API_EXTERN uint32_t
 wasm_runtime_dump_pgo_prof_data_to_buf(wasm_module_inst_t module_inst,
                                        char *buf, uint32_t len);
 
+/**
+ * Get the size required to store the compact dump of the LLVM PGO
+ * counters, which only holds the counters of the functions and a hash
+ * identifying the instrumented AOT file, see
+ * test-tools/pgo-merge/pgo_merge.py to add the dumps up into a profile
+ *
+ * @param module_inst the WASM module instance
+ *
+ * @return size required to store the contents, 0 means error
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_get_pgo_counters_size(wasm_module_inst_t module_inst);
+
+/**
+ * Dump the LLVM PGO counters to buffer in the compact format
+ *
+ * @param module_inst the WASM module instance
+ * @param buf buffer to store the dumped content
+ * @param len length of the buffer
+ *
+ * @return bytes dumped to the buffer, 0 means error and data in buf
+ *         may be invalid
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_dump_pgo_counters_to_buf(wasm_module_inst_t module_inst,
+                                      char *buf, uint32_t len);
+
+/**
+ * Reset the LLVM PGO counters and value profiles to zero, e.g. after
+ * dumping them, so that the next dump only holds the new counts. Note
+ * that the counters are shared by the instances of a module.
+ *
+ * @param module_inst the WASM module instance
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_reset_pgo_counters(wasm_module_inst_t module_inst);
+
 /**
  * Get a custom section by name
  *
@@ -2258,7 +2718,36 @@ WASM_RUNTIME_API_EXTERN wasm_shared_heap_t
 wasm_runtime_create_shared_heap(SharedHeapInitArgs *init_args);
 
 /**
- * Attach a shared heap to a module instance
+ * Chain two shared heaps, so that a module instance the head is attached to
+ * can access both. The heaps of a chain are placed from the top of the wasm
+ * address space downwards in the chain order. None of the heaps can be
+ * attached to a module instance, and body can't be the body of another
+ * chain.
+ *
+ * @param head the shared heap to be the head of the chain
+ * @param body the shared heap, or head of a chain, appended after head
+ * @return head if success, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_shared_heap_t
+wasm_runtime_chain_shared_heaps(wasm_shared_heap_t head,
+                                wasm_shared_heap_t body);
+
+/**
+ * Unchain the shared heaps of a chain, the chain can't be attached to a
+ * module instance.
+ *
+ * @param head the head of the chain
+ * @param entire_chain true to unchain all the heaps, false to only detach
+ *        head from the rest of the chain
+ * @return the head of the rest of the chain, NULL if entire_chain is true
+ *         or if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_shared_heap_t
+wasm_runtime_unchain_shared_heaps(wasm_shared_heap_t head, bool entire_chain);
+
+/**
+ * Attach a shared heap, or the head of a chain of shared heaps, to a module
+ * instance
  *
  * @param module_inst the module instance
  * @param shared_heap the shared heap
@@ -2277,7 +2766,10 @@ WASM_RUNTIME_API_EXTERN void
 wasm_runtime_detach_shared_heap(wasm_module_inst_t module_inst);
 
 /**
- * Allocate memory from a shared heap
+ * Allocate memory from the shared heaps attached to a module instance, in
+ * the chain order. A heap created with a max_size grows when the allocation
+ * doesn't fit in it. Small allocations are served from lock-free lists of
+ * freed blocks.
  *
  * @param module_inst the module instance
  * @param size required memory size
@@ -2286,7 +2778,8 @@ wasm_runtime_detach_shared_heap(wasm_module_inst_t module_inst);
  * @return return the allocated memory address, which re-uses part of the wasm
  * address space and is in the range of [UINT32 - shared_heap_size + 1, UINT32]
  * (when the wasm memory is 32-bit) or [UINT64 - shared_heap_size + 1, UINT64]
- * (when the wasm memory is 64-bit). Note that it is not an absolute address.
+ * (when the wasm memory is 64-bit), shared_heap_size being the total reserved
+ * size of the chain. Note that it is not an absolute address.
  *         Return non-zero if success, zero if failed.
  */
 WASM_RUNTIME_API_EXTERN uint64_t
@@ -2302,6 +2795,128 @@ wasm_runtime_shared_heap_malloc(wasm_module_inst_t module_inst, uint64_t size,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_shared_heap_free(wasm_module_inst_t module_inst, uint64_t ptr);
 
+/**
+ * Create a channel passing the messages allocated from a shared heap
+ * between module instances and host natives without copying them. The
+ * sender of a message transfers its ownership to the receiver, which
+ * frees it or sends it on.
+ *
+ * @param init_args the initialization arguments
+ * @return the channel created, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_channel_t
+wasm_runtime_create_channel(ChannelInitArgs *init_args);
+
+/**
+ * Close a channel, the pending and the following sends fail, the blocked
+ * receivers get WASM_CHANNEL_CLOSED once the channel is empty
+ *
+ * @param channel the channel
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_close_channel(wasm_channel_t channel);
+
+/**
+ * Close and destroy a channel, the messages left in it are freed. The
+ * channel is released when the wasm apps using it return from the
+ * channel calls.
+ *
+ * @param channel the channel
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_channel(wasm_channel_t channel);
+
+/**
+ * Grant a module instance the access to a channel. The wasm app refers to
+ * the channel by the handle returned, which is only valid in the module
+ * instance and its threads; the handles not granted are rejected. The
+ * channel is kept alive until the grant is revoked or the module instance
+ * is deinstantiated.
+ *
+ * @param module_inst the module instance
+ * @param channel the channel
+ * @return the handle, the same one if the channel was already granted,
+ *         0 if failed
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_channel_grant(wasm_module_inst_t module_inst,
+                           wasm_channel_t channel);
+
+/**
+ * Revoke the access of a module instance to the channel of a handle
+ *
+ * @param module_inst the module instance
+ * @param handle the handle returned by wasm_runtime_channel_grant
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_channel_revoke(wasm_module_inst_t module_inst, uint32_t handle);
+
+/**
+ * Send a message allocated from the shared heap of a channel by its
+ * native address
+ *
+ * @param channel the channel
+ * @param buf the native address of the message, returned by the shared
+ *        heap malloc
+ * @param size the size of the message
+ * @param timeout_us 0 to return WASM_CHANNEL_FULL if the channel is full,
+ *        negative to wait until there is room, or the max microseconds
+ *        to wait
+ * @return WASM_CHANNEL_OK if sent, the message then belongs to the
+ *         receiver, otherwise the status of the failure
+ */
+WASM_RUNTIME_API_EXTERN wasm_channel_status_t
+wasm_runtime_channel_send_native(wasm_channel_t channel, void *buf,
+                                 uint64_t size, int64_t timeout_us);
+
+/**
+ * Receive a message from a channel by its native address
+ *
+ * @param channel the channel
+ * @param p_buf return the native address of the message
+ * @param p_size return the size of the message
+ * @param timeout_us 0 to return WASM_CHANNEL_EMPTY if the channel is
+ *        empty, negative to wait for a message, or the max microseconds
+ *        to wait
+ * @return WASM_CHANNEL_OK if a message is received, otherwise the status
+ *         of the failure
+ */
+WASM_RUNTIME_API_EXTERN wasm_channel_status_t
+wasm_runtime_channel_recv_native(wasm_channel_t channel, void **p_buf,
+                                 uint64_t *p_size, int64_t timeout_us);
+
+/**
+ * Send a message allocated from the shared heap of a channel by its
+ * offset in a module instance, the shared heap must be attached to it
+ *
+ * @param module_inst the module instance
+ * @param channel the channel
+ * @param buf the offset of the message in wasm app
+ * @param size the size of the message
+ * @param timeout_us same as wasm_runtime_channel_send_native
+ * @return same as wasm_runtime_channel_send_native
+ */
+WASM_RUNTIME_API_EXTERN wasm_channel_status_t
+wasm_runtime_channel_send(wasm_module_inst_t module_inst,
+                          wasm_channel_t channel, uint64_t buf, uint64_t size,
+                          int64_t timeout_us);
+
+/**
+ * Receive a message from a channel by its offset in a module instance,
+ * the shared heap of the channel must be attached to it
+ *
+ * @param module_inst the module instance
+ * @param channel the channel
+ * @param p_buf return the offset of the message in wasm app
+ * @param p_size return the size of the message
+ * @param timeout_us same as wasm_runtime_channel_recv_native
+ * @return same as wasm_runtime_channel_recv_native
+ */
+WASM_RUNTIME_API_EXTERN wasm_channel_status_t
+wasm_runtime_channel_recv(wasm_module_inst_t module_inst,
+                          wasm_channel_t channel, uint64_t *p_buf,
+                          uint64_t *p_size, int64_t timeout_us);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/**
+ * @file   wasm_typed_func.hpp
+ *
+ * @brief  A header-only C++ layer over wasm_export.h, which binds a WASM
+ *         function to a statically typed callable. The signature is checked
+ *         once when binding, and the arguments are written to a cell array
+ *         whose size is known at compile time, so that a call costs no more
+ *         than calling wasm_runtime_call_wasm() with a hand-written argv.
+ *
+ * For example:
+ *
+ *   wamr::typed_func<int32_t(int32_t, double)> func;
+ *   int32_t result;
+ *
+ *   if (func.bind(module_inst, "filter")
+ *       && func.call(exec_env, &result, 42, 0.5))
+ *       ...
+ *
+ * Multiple results are returned with std::tuple, e.g.
+ * wamr::typed_func<std::tuple<int32_t, int64_t>(float)>.
+ */
+
+#ifndef _WASM_TYPED_FUNC_HPP
+#define _WASM_TYPED_FUNC_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "wasm_export.h"
+
+namespace wamr {
+
+namespace detail {
+
+/* The WASM value type of a C++ type, and the cells it occupies in argv */
+template<typename T>
+struct val_traits;
+
+#define WAMR_DEFINE_VAL_TRAITS(type, val_kind, val_cells) \
+    template<>                                            \
+    struct val_traits<type> {                             \
+        static constexpr wasm_valkind_t kind = val_kind;  \
+        static constexpr uint32_t cells = val_cells;      \
+    };
+
+WAMR_DEFINE_VAL_TRAITS(int32_t, WASM_I32, 1)
+WAMR_DEFINE_VAL_TRAITS(uint32_t, WASM_I32, 1)
+WAMR_DEFINE_VAL_TRAITS(int64_t, WASM_I64, 2)
+WAMR_DEFINE_VAL_TRAITS(uint64_t, WASM_I64, 2)
+WAMR_DEFINE_VAL_TRAITS(float, WASM_F32, 1)
+WAMR_DEFINE_VAL_TRAITS(double, WASM_F64, 2)
+
+#undef WAMR_DEFINE_VAL_TRAITS
+
+template<typename... Ts>
+struct cell_sum;
+
+template<>
+struct cell_sum<> {
+    static constexpr uint32_t value = 0;
+};
+
+template<typename T, typename... Ts>
+struct cell_sum<T, Ts...> {
+    static constexpr uint32_t value =
+        val_traits<T>::cells + cell_sum<Ts...>::value;
+};
+
+/* Write a value to argv, and return the next cell */
+template<typename T>
+inline uint32_t *
+store_val(uint32_t *cell, T val)
+{
+    std::memcpy(cell, &val, sizeof(T));
+    return cell + val_traits<T>::cells;
+}
+
+/* Read a value from argv, and return the next cell */
+template<typename T>
+inline const uint32_t *
+load_val(const uint32_t *cell, T *val)
+{
+    std::memcpy(val, cell, sizeof(T));
+    return cell + val_traits<T>::cells;
+}
+
+/* The results of a function: void, a value or a std::tuple of values */
+template<typename R>
+struct result_traits {
+    static constexpr uint32_t count = 1;
+    static constexpr uint32_t cells = val_traits<R>::cells;
+
+    static void get_kinds(wasm_valkind_t *kinds)
+    {
+        kinds[0] = val_traits<R>::kind;
+    }
+
+    static void load(const uint32_t *argv, R *result)
+    {
+        load_val(argv, result);
+    }
+};
+
+template<>
+struct result_traits<void> {
+    static constexpr uint32_t count = 0;
+    static constexpr uint32_t cells = 0;
+
+    static void get_kinds(wasm_valkind_t *kinds) { (void)kinds; }
+};
+
+template<std::size_t I, typename Tuple>
+struct tuple_loader {
+    static const uint32_t *load(const uint32_t *cell, Tuple *result)
+    {
+        cell = tuple_loader<I - 1, Tuple>::load(cell, result);
+        return load_val(cell, &std::get<I - 1>(*result));
+    }
+
+    static void get_kinds(wasm_valkind_t *kinds)
+    {
+        typedef typename std::tuple_element<I - 1, Tuple>::type T;
+
+        tuple_loader<I - 1, Tuple>::get_kinds(kinds);
+        kinds[I - 1] = val_traits<T>::kind;
+    }
+};
+
+template<typename Tuple>
+struct tuple_loader<0, Tuple> {
+    static const uint32_t *load(const uint32_t *cell, Tuple *result)
+    {
+        (void)result;
+        return cell;
+    }
+
+    static void get_kinds(wasm_valkind_t *kinds) { (void)kinds; }
+};
+
+template<typename... Rs>
+struct result_traits<std::tuple<Rs...>> {
+    typedef std::tuple<Rs...> tuple_type;
+
+    static constexpr uint32_t count = sizeof...(Rs);
+    static constexpr uint32_t cells = cell_sum<Rs...>::value;
+
+    static void get_kinds(wasm_valkind_t *kinds)
+    {
+        tuple_loader<sizeof...(Rs), tuple_type>::get_kinds(kinds);
+    }
+
+    static void load(const uint32_t *argv, tuple_type *result)
+    {
+        tuple_loader<sizeof...(Rs), tuple_type>::load(argv, result);
+    }
+};
+
+} /* end of namespace detail */
+
+template<typename Signature>
+class typed_func;
+
+/**
+ * A WASM function bound to the C++ signature R(Args...), R is void, one of
+ * int32_t, uint32_t, int64_t, uint64_t, float and double, or a std::tuple
+ * of them, and so are Args.
+ *
+ * The object only keeps the function instance, it can be copied and used
+ * by any thread which has an exec_env of the module instance.
+ */
+template<typename R, typename... Args>
+class typed_func<R(Args...)>
+{
+  public:
+    typed_func()
+      : module_inst_(nullptr)
+      , func_(nullptr)
+    {}
+
+    /**
+     * Bind the function instance, fail if its signature doesn't match
+     *
+     * @param module_inst the module instance of the function
+     * @param func the function instance
+     *
+     * @return true if the function is bound, false otherwise
+     */
+    bool bind(wasm_module_inst_t module_inst, wasm_function_inst_t func)
+    {
+        /* one more element, as a zero-length array isn't allowed */
+        wasm_valkind_t kinds[param_count + result_count + 1];
+        wasm_valkind_t expected[param_count + result_count + 1] = {
+            detail::val_traits<Args>::kind...
+        };
+
+        module_inst_ = nullptr;
+        func_ = nullptr;
+
+        if (!module_inst || !func
+            || wasm_func_get_param_count(func, module_inst) != param_count
+            || wasm_func_get_result_count(func, module_inst) != result_count)
+            return false;
+
+        detail::result_traits<R>::get_kinds(expected + param_count);
+        wasm_func_get_param_types(func, module_inst, kinds);
+        wasm_func_get_result_types(func, module_inst, kinds + param_count);
+        if (std::memcmp(kinds, expected, param_count + result_count) != 0)
+            return false;
+
+        module_inst_ = module_inst;
+        func_ = func;
+        return true;
+    }
+
+    /**
+     * Look up an exported function by its name and bind it
+     *
+     * @param module_inst the module instance to look up
+     * @param name the name of the function
+     *
+     * @return true if the function is found and bound, false otherwise
+     */
+    bool bind(wasm_module_inst_t module_inst, const char *name)
+    {
+        return bind(module_inst,
+                    module_inst
+                        ? wasm_runtime_lookup_function(module_inst, name)
+                        : nullptr);
+    }
+
+    bool is_bound() const { return func_ != nullptr; }
+
+    wasm_function_inst_t get_function() const { return func_; }
+
+    /**
+     * Call a function without results
+     *
+     * @return true if success, false otherwise and the exception can be
+     *         got with wasm_runtime_get_exception()
+     */
+    template<typename T = R>
+    typename std::enable_if<std::is_void<T>::value, bool>::type
+    call(wasm_exec_env_t exec_env, Args... args) const
+    {
+        uint32_t argv[argv_cells];
+
+        return invoke(exec_env, argv, args...);
+    }
+
+    /**
+     * Call a function with results
+     *
+     * @param result the results returned
+     *
+     * @return true if success, false otherwise and the exception can be
+     *         got with wasm_runtime_get_exception()
+     */
+    template<typename T = R>
+    typename std::enable_if<!std::is_void<T>::value, bool>::type
+    call(wasm_exec_env_t exec_env, T *result, Args... args) const
+    {
+        uint32_t argv[argv_cells];
+
+        if (!invoke(exec_env, argv, args...))
+            return false;
+
+        detail::result_traits<R>::load(argv, result);
+        return true;
+    }
+
+  private:
+    static constexpr uint32_t param_count = sizeof...(Args);
+    static constexpr uint32_t result_count =
+        detail::result_traits<R>::count;
+    static constexpr uint32_t param_cells =
+        detail::cell_sum<Args...>::value;
+    static constexpr uint32_t result_cells =
+        detail::result_traits<R>::cells;
+    /* argv holds the arguments and then the results */
+    static constexpr uint32_t argv_cells =
+        (param_cells > result_cells ? param_cells : result_cells) + 1;
+
+    bool invoke(wasm_exec_env_t exec_env, uint32_t *argv, Args... args) const
+    {
+        uint32_t *cell = argv;
+        /* write the arguments in order, see the expansion of braced-init
+           lists */
+        int unused[] = { 0, ((cell = detail::store_val(cell, args)), 0)... };
+
+        (void)unused;
+        (void)cell;
+        return func_ && wasm_runtime_call_wasm(exec_env, func_, param_cells,
+                                               argv);
+    }
+
+    wasm_module_inst_t module_inst_;
+    wasm_function_inst_t func_;
+};
+
+} /* end of namespace wamr */
+
+#endif /* end of _WASM_TYPED_FUNC_HPP */
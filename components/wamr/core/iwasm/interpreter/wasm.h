@@ -705,6 +705,19 @@ struct WASMFunction {
 #if WASM_ENABLE_FAST_JIT != 0
     /* The compiled fast jit jitted code block of this function */
     void *fast_jit_jitted_code;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0 && WASM_ENABLE_LAZY_JIT != 0
+    /* Number of calls to the jitted code, halved each time the code
+       cache is reclaimed */
+    uint32 fast_jit_call_count;
+#endif
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    /* Number of calls to the function while it isn't compiled, it is
+       queued to be compiled in background when the number reaches the
+       compile threshold */
+    uint32 fast_jit_interp_call_count;
+    /* Whether the function has been queued to be compiled */
+    bool fast_jit_compile_queued;
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
     /* The compiled llvm jit func ptr of this function */
     void *llvm_jit_func_ptr;
@@ -767,6 +780,20 @@ typedef struct WASMDataSeg {
     bool is_data_cloned;
 } WASMDataSeg;
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* Initial content of the default memory written by the active data
+   segments, shared copy-on-write by the instances of a module */
+typedef struct WASMMemoryImage {
+    /* Sealed file in memory holding the content */
+    os_file_handle file;
+    /* Size of the file aligned to the system page size,
+       0 if the module has no memory image */
+    uint64 size;
+    /* End offset of the last data segment */
+    uint64 data_end;
+} WASMMemoryImage;
+#endif
+
 typedef struct BlockAddr {
     const uint8 *start_addr;
     uint8 *else_addr;
@@ -906,6 +933,9 @@ struct WASMModule {
     WASMExport *exports;
     WASMTableSeg *table_segments;
     WASMDataSeg **data_segments;
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    WASMMemoryImage memory_image;
+#endif
     uint32 start_function;
 
     /* total global variable size */
@@ -1097,6 +1127,24 @@ struct WASMModule {
 
     /* Whether the underlying wasm binary buffer can be freed */
     bool is_binary_freeable;
+
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+    /* Whether the functions are prepared on their first call, the wasm
+       binary buffer is then referred to until the module is unloaded */
+    bool is_lazy_prepare;
+    /* Whether the function bodies are validated when they are prepared
+       instead of when loading */
+    bool defer_validation;
+    /* Lock to prepare the functions lazily */
+    korp_mutex lazy_prepare_lock;
+#endif
+
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_FAST_INTERP_BCE != 0
+    /* The end of the accesses to the default memory with const addresses
+       which are emitted without bounds checks, the memory mustn't be
+       shrunk below it */
+    uint64 unchecked_mem_end;
+#endif
 };
 
 typedef struct BlockType {
@@ -26,6 +26,10 @@
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
 #include "../fast-jit/jit_compiler.h"
+#include "../fast-jit/jit_codecache.h"
+#endif
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+#include "../common/wasm_runtime_metrics.h"
 #endif
 
 typedef int32 CellType_I32;
@@ -53,9 +57,23 @@ typedef float64 CellType_F64;
 #else
 #define is_default_memory true
 #endif
-#define app_addr_in_shared_heap(app_addr, bytes)                             \
-    (shared_heap && is_default_memory && (app_addr) >= shared_heap_start_off \
-     && (app_addr) <= shared_heap_end_off - bytes + 1)
+#if WASM_ENABLE_MEMORY64 != 0
+#define is_shared_heap_memory64 is_memory64
+#else
+#define is_shared_heap_memory64 false
+#endif
+/* Check the heap of the chain accessed last first, and look up the
+   chain when the address range is out of it */
+#define app_addr_in_shared_heap(app_addr, bytes)                          \
+    (shared_heap && is_default_memory                                     \
+     && (app_addr) >= shared_heap_chain_start_off                         \
+     && (((app_addr) >= shared_heap_start_off                             \
+          && (app_addr) <= shared_heap_end_off                            \
+          && (uint64)(bytes) <= shared_heap_end_off - (app_addr) + 1)     \
+         || wasm_runtime_shared_heap_lookup(                              \
+             (WASMModuleInstanceCommon *)module, is_shared_heap_memory64, \
+             (app_addr), (bytes), &shared_heap_start_off,                 \
+             &shared_heap_end_off, &shared_heap_base_addr)))
 
 #define shared_heap_addr_app_to_native(app_addr, native_addr) \
     native_addr = shared_heap_base_addr + ((app_addr)-shared_heap_start_off)
@@ -1284,6 +1302,12 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
         return;
     }
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_record_native_call(func_import->module_name,
+                                            func_import->field_name,
+                                            native_func_pointer);
+#endif
+
     if (func_import->call_conv_wasm_c_api) {
         ret = wasm_runtime_invoke_c_api_native(
             (WASMModuleInstanceCommon *)module_inst, native_func_pointer,
@@ -1352,6 +1376,42 @@ fast_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx,
     wasm_interp_call_func_native(module_inst, exec_env, cur_func, prev_frame);
     return wasm_copy_exception(module_inst, NULL) ? false : true;
 }
+
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+static void
+wasm_interp_call_func_bytecode(WASMModuleInstance *module,
+                               WASMExecEnv *exec_env,
+                               WASMFunctionInstance *cur_func,
+                               WASMInterpFrame *prev_frame);
+
+static void
+fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
+                            WASMExecEnv *exec_env,
+                            WASMFunctionInstance *function,
+                            WASMInterpFrame *frame);
+
+/* Call a function which hasn't been compiled yet from the jitted code,
+   the arguments have been stored into the outs area of prev_frame */
+bool
+fast_jit_call_interp(WASMExecEnv *exec_env, uint32 func_idx,
+                     WASMInterpFrame *prev_frame)
+{
+    WASMModuleInstance *module_inst =
+        (WASMModuleInstance *)exec_env->module_inst;
+    WASMFunctionInstance *cur_func = module_inst->e->functions + func_idx;
+    uint8 *ip = prev_frame->ip;
+
+    /* set ip NULL to make call_func_bytecode return after executing
+       this function */
+    prev_frame->ip = NULL;
+
+    wasm_interp_call_func_bytecode(module_inst, exec_env, cur_func,
+                                   prev_frame);
+
+    prev_frame->ip = ip;
+    return wasm_copy_exception(module_inst, NULL) ? false : true;
+}
+#endif
 #endif
 
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -1646,19 +1706,16 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #endif
 #if WASM_ENABLE_SHARED_HEAP != 0
     WASMSharedHeap *shared_heap = module->e->shared_heap;
-    uint8 *shared_heap_base_addr = shared_heap ? shared_heap->base_addr : NULL;
-#if WASM_ENABLE_MEMORY64 != 0
-    uint64 shared_heap_start_off =
-        shared_heap ? (is_memory64 ? shared_heap->start_off_mem64
-                                   : shared_heap->start_off_mem32)
-                    : 0;
-    uint64 shared_heap_end_off =
-        shared_heap ? (is_memory64 ? UINT64_MAX : UINT32_MAX) : 0;
-#else
-    uint64 shared_heap_start_off =
-        shared_heap ? shared_heap->start_off_mem32 : 0;
-    uint64 shared_heap_end_off = shared_heap ? UINT32_MAX : 0;
-#endif
+    /* Lowest offset of the attached shared heap chain */
+    uint64 shared_heap_chain_start_off =
+        shared_heap ? wasm_runtime_get_shared_heap_chain_start_off(
+            shared_heap, is_shared_heap_memory64)
+                    : UINT64_MAX;
+    /* Accessible range of the heap of the chain accessed last, empty
+       until the first access */
+    uint8 *shared_heap_base_addr = NULL;
+    uint64 shared_heap_start_off = UINT64_MAX;
+    uint64 shared_heap_end_off = 0;
 #endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
 #if WASM_ENABLE_MULTI_MEMORY != 0
     uint32 memidx = 0;
@@ -6763,6 +6820,32 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 goto got_exception;
             }
         }
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+        else if (module->e->running_mode == Mode_Fast_JIT && frame
+#if WASM_ENABLE_TAIL_CALL != 0 || WASM_ENABLE_GC != 0
+                 && !is_return_call
+#endif
+                 && jit_compiler_is_compiled(
+                     module->module,
+                     (uint32)(cur_func - module->e->functions))) {
+            /* The callee has been compiled by the background compile
+               threads, switch to its jitted code */
+            fast_jit_call_func_bytecode(module, exec_env, cur_func,
+                                        prev_frame);
+            prev_frame = frame->prev_frame;
+            cur_func = frame->function;
+            UPDATE_ALL_FROM_FRAME();
+
+#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
+    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_BULK_MEMORY != 0
+            if (memory)
+                linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
+#endif
+            if (wasm_copy_exception(module, NULL))
+                goto got_exception;
+        }
+#endif
         else {
             WASMFunction *cur_wasm_func = cur_func->u.func;
             WASMFuncType *func_type = cur_wasm_func->func_type;
@@ -6801,6 +6884,12 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 goto got_exception;
             }
 
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+            if (module->e->running_mode == Mode_Fast_JIT)
+                jit_compiler_count_call(
+                    module->module, (uint32)(cur_func - module->e->functions));
+#endif
+
             /* Initialize the interpreter context. */
             frame->function = cur_func;
             frame_ip = wasm_get_func_code(cur_func);
@@ -6964,15 +7053,27 @@ fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
     uint32 func_idx = (uint32)(function - module_inst->e->functions);
     uint32 func_idx_non_import = func_idx - module->import_function_count;
     int32 action;
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    JitCodeCacheEntry entry;
+#endif
 
 #if WASM_ENABLE_REF_TYPES != 0
     if (type == VALUE_TYPE_EXTERNREF || type == VALUE_TYPE_FUNCREF)
         type = VALUE_TYPE_I32;
 #endif
 
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    /* Keep the jitted code from being moved or evicted by other threads
+       from now on, including the code compiled below */
+    jit_code_cache_enter(&entry, exec_env);
+#endif
+
 #if WASM_ENABLE_LAZY_JIT != 0
     if (!jit_compiler_compile(module, func_idx)) {
         wasm_set_exception(module_inst, "failed to compile fast jit function");
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+        jit_code_cache_leave(&entry);
+#endif
         return;
     }
 #endif
@@ -6986,6 +7087,9 @@ fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
     action = jit_interp_switch_to_jitted(
         exec_env, &info, func_idx,
         module_inst->fast_jit_func_ptrs[func_idx_non_import]);
+#if WASM_ENABLE_FAST_JIT_CODE_CACHE_EVICTION != 0
+    jit_code_cache_leave(&entry);
+#endif
     bh_assert(action == JIT_INTERP_ACTION_NORMAL
               || (action == JIT_INTERP_ACTION_THROWN
                   && wasm_copy_exception(
@@ -7509,7 +7613,18 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
         }
 #if WASM_ENABLE_FAST_JIT != 0
         else if (running_mode == Mode_Fast_JIT) {
-            fast_jit_call_func_bytecode(module_inst, exec_env, function, frame);
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+            uint32 func_idx = (uint32)(function - module_inst->e->functions);
+            if (!jit_compiler_is_compiled(module_inst->module, func_idx)) {
+                /* Interpret the function until the background compile
+                   threads finish compiling it */
+                wasm_interp_call_func_bytecode(module_inst, exec_env,
+                                               function, frame);
+            }
+            else
+#endif
+                fast_jit_call_func_bytecode(module_inst, exec_env, function,
+                                            frame);
         }
 #endif
 #if WASM_ENABLE_JIT != 0
@@ -20,6 +20,12 @@
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "../common/wasm_shared_memory.h"
 #endif
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+#include "../common/wasm_sampling_profiler.h"
+#endif
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+#include "../common/wasm_runtime_metrics.h"
+#endif
 
 typedef int32 CellType_I32;
 typedef int64 CellType_I64;
@@ -38,9 +44,17 @@ typedef float64 CellType_F64;
 #endif
 
 #if WASM_ENABLE_SHARED_HEAP != 0
-#define app_addr_in_shared_heap(app_addr, bytes)        \
-    (shared_heap && (app_addr) >= shared_heap_start_off \
-     && (app_addr) <= shared_heap_end_off - bytes + 1)
+/* Check the heap of the chain accessed last first, and look up the
+   chain when the address range is out of it */
+#define app_addr_in_shared_heap(app_addr, bytes)                             \
+    (shared_heap && (app_addr) >= shared_heap_chain_start_off                \
+     && (((app_addr) >= shared_heap_start_off                                \
+          && (app_addr) <= shared_heap_end_off                               \
+          && (uint64)(bytes) <= shared_heap_end_off - (app_addr) + 1)        \
+         || wasm_runtime_shared_heap_lookup(                                 \
+             (WASMModuleInstanceCommon *)module, false, (app_addr), (bytes), \
+             &shared_heap_start_off, &shared_heap_end_off,                   \
+             &shared_heap_base_addr)))
 
 #define shared_heap_addr_app_to_native(app_addr, native_addr) \
     native_addr = shared_heap_base_addr + ((app_addr)-shared_heap_start_off)
@@ -95,6 +109,12 @@ typedef float64 CellType_F64;
 #endif /* !defined(OS_ENABLE_HW_BOUND_CHECK) \
           || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 */
 
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+/* The address of an access proven in the linear memory by the loader */
+#define UNCHECKED_MEMORY_ADDR() \
+    (memory->memory_data + (uint64)offset + (uint64)addr)
+#endif
+
 #define CHECK_ATOMIC_MEMORY_ACCESS(align)          \
     do {                                           \
         if (((uintptr_t)maddr & (align - 1)) != 0) \
@@ -1125,6 +1145,38 @@ word_copy(uint32 *dest, uint32 *src, unsigned num)
     }
 }
 
+#if WASM_ENABLE_LAZY_FAST_INTERP == 0
+#define FUNC_CONST_CELL_NUM(function) ((function)->const_cell_num)
+#else
+/* The const cell num of a function is only known once it is prepared,
+   which may happen after the function instance is created */
+#define FUNC_CONST_CELL_NUM(function) \
+    ((function)->is_import_func ? 0 : (function)->u.func->const_cell_num)
+
+/* Prepare the code of a function on its first call */
+static inline bool
+PREPARE_FUNC(WASMModuleInstance *module_inst, WASMFunctionInstance *func)
+{
+    WASMFunctionInstance *callee = func;
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    if (callee->is_import_func && callee->import_func_inst)
+        callee = callee->import_func_inst;
+#endif
+
+    if (callee->is_import_func)
+        return true;
+
+    if (callee->u.func->code_compiled) {
+        /* Pairs with the release fence of the thread which prepared it */
+        os_atomic_thread_fence(os_memory_order_acquire);
+        return true;
+    }
+
+    return wasm_prepare_func(module_inst, func);
+}
+#endif
+
 static inline WASMInterpFrame *
 ALLOC_FRAME(WASMExecEnv *exec_env, uint32 size, WASMInterpFrame *prev_frame)
 {
@@ -1226,6 +1278,12 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
         return;
     }
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_record_native_call(func_import->module_name,
+                                            func_import->field_name,
+                                            native_func_pointer);
+#endif
+
     if (func_import->call_conv_wasm_c_api) {
         ret = wasm_runtime_invoke_c_api_native(
             (WASMModuleInstanceCommon *)module_inst, native_func_pointer,
@@ -1352,9 +1410,24 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
 }
 #endif
 
+#if WASM_ENABLE_SAMPLING_PROFILER != 0
+/* Record the call stack if the sampler thread asked for a sample,
+   the frames are already linked in exec_env so no need to sync ip */
+#define CHECK_SAMPLE_FLAG()                                 \
+    do {                                                    \
+        if (WASM_SUSPEND_FLAGS_GET(exec_env->suspend_flags) \
+            & WASM_SUSPEND_FLAG_SAMPLE) {                   \
+            wasm_sampling_profiler_take_sample(exec_env);   \
+        }                                                   \
+    } while (0)
+#else
+#define CHECK_SAMPLE_FLAG() (void)0
+#endif
+
 #if WASM_ENABLE_THREAD_MGR != 0
 #define CHECK_SUSPEND_FLAGS()                               \
     do {                                                    \
+        CHECK_SAMPLE_FLAG();                                \
         WASM_SUSPEND_FLAGS_LOCK(exec_env->wait_lock);       \
         if (WASM_SUSPEND_FLAGS_GET(exec_env->suspend_flags) \
             & WASM_SUSPEND_FLAG_TERMINATE) {                \
@@ -1365,6 +1438,8 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
         /* TODO: support suspend and breakpoint */          \
         WASM_SUSPEND_FLAGS_UNLOCK(exec_env->wait_lock);     \
     } while (0)
+#elif WASM_ENABLE_SAMPLING_PROFILER != 0
+#define CHECK_SUSPEND_FLAGS() CHECK_SAMPLE_FLAG()
 #endif
 
 #if WASM_ENABLE_OPCODE_COUNTER != 0
@@ -1539,21 +1614,17 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #endif
 #if WASM_ENABLE_SHARED_HEAP != 0
     WASMSharedHeap *shared_heap = module->e ? module->e->shared_heap : NULL;
-    uint8 *shared_heap_base_addr = shared_heap ? shared_heap->base_addr : NULL;
-    /*
-#if WASM_ENABLE_MEMORY64 != 0
-    uint64 shared_heap_start_off =
-        shared_heap ? (is_memory64 ? shared_heap->start_off_mem64
-                                   : shared_heap->start_off_mem32)
-                    : 0;
-    uint64 shared_heap_end_off =
-        shared_heap ? (is_memory64 ? UINT64_MAX : UINT32_MAX) : 0;
-#else
-    */ /* TODO: uncomment the code when memory64 is enabled for fast-interp */
-    uint64 shared_heap_start_off =
-        shared_heap ? shared_heap->start_off_mem32 : 0;
-    uint64 shared_heap_end_off = shared_heap ? UINT32_MAX : 0;
-/* #endif */
+    /* Lowest offset of the attached shared heap chain */
+    /* TODO: pass is_memory64 when memory64 is enabled for fast-interp */
+    uint64 shared_heap_chain_start_off =
+        shared_heap
+            ? wasm_runtime_get_shared_heap_chain_start_off(shared_heap, false)
+            : UINT64_MAX;
+    /* Accessible range of the heap of the chain accessed last, empty
+       until the first access */
+    uint8 *shared_heap_base_addr = NULL;
+    uint64 shared_heap_start_off = UINT64_MAX;
+    uint64 shared_heap_end_off = 0;
 #endif /* end of WASM_ENABLE_SHARED_HEAP != 0 */
 
 #if WASM_ENABLE_LABELS_AS_VALUES != 0
@@ -1611,7 +1682,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             HANDLE_OP(WASM_OP_BR)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
             recover_br_info:
@@ -1621,7 +1692,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             HANDLE_OP(WASM_OP_BR_IF)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 cond = frame_lp[GET_OFFSET()];
@@ -1638,7 +1709,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             {
                 uint32 arity, br_item_size;
 
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 count = read_uint32(frame_ip);
@@ -1726,7 +1797,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_TAIL_CALL != 0
                 GET_OPCODE();
 #endif
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
 
@@ -1987,7 +2058,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_GC != 0
             HANDLE_OP(WASM_OP_CALL_REF)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 func_obj = POP_REF();
@@ -2002,7 +2073,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             }
             HANDLE_OP(WASM_OP_RETURN_CALL_REF)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 func_obj = POP_REF();
@@ -2036,7 +2107,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             }
             HANDLE_OP(WASM_OP_BR_ON_NULL)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 opnd_off = GET_OFFSET();
@@ -2052,7 +2123,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             }
             HANDLE_OP(WASM_OP_BR_ON_NON_NULL)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 opnd_off = GET_OFFSET();
@@ -2653,7 +2724,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         uint8 castflags;
                         uint16 opnd_off_br;
 
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                         CHECK_SUSPEND_FLAGS();
 #endif
                         castflags = *frame_ip++;
@@ -3874,6 +3945,248 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+            /* memory load/store instructions whose bounds checks are
+               proven redundant by the loader */
+            HANDLE_OP(EXT_OP_I32_LOAD_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                frame_lp[addr_ret] = LOAD_I32(maddr);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret, LOAD_I64(maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LOAD8_S_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                frame_lp[addr_ret] = sign_ext_8_32(*(int8 *)maddr);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LOAD8_U_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                frame_lp[addr_ret] = (uint32)(*(uint8 *)(maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LOAD16_S_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                frame_lp[addr_ret] = sign_ext_16_32(LOAD_I16(maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LOAD16_U_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                frame_lp[addr_ret] = (uint32)(LOAD_U16(maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD8_S_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret,
+                                sign_ext_8_64(*(int8 *)maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD8_U_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret, (uint64)(*(uint8 *)maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD16_S_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret,
+                                sign_ext_16_64(LOAD_I16(maddr)));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD16_U_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret, (uint64)(LOAD_U16(maddr)));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD32_S_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret,
+                                sign_ext_32_64(LOAD_I32(maddr)));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_LOAD32_U_UNCHECKED)
+            {
+                uint32 offset, addr;
+                offset = read_uint32(frame_ip);
+                addr = GET_OPERAND(uint32, I32, 0);
+                frame_ip += 2;
+                addr_ret = GET_OFFSET();
+                maddr = UNCHECKED_MEMORY_ADDR();
+                PUT_I64_TO_ADDR(frame_lp + addr_ret, (uint64)(LOAD_U32(maddr)));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_STORE_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint32 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint32, I32, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                STORE_U32(maddr, sval);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_STORE_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint64 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint64, I64, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                STORE_I64(maddr, sval);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_STORE8_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint32 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint32, I32, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                STORE_U8(maddr, (uint8_t)sval);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_STORE16_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint32 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint32, I32, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                STORE_U16(maddr, (uint16)sval);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_STORE8_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint64 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint64, I64, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                *(uint8 *)maddr = (uint8)sval;
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_STORE16_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint64 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint64, I64, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                STORE_U16(maddr, (uint16)sval);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I64_STORE32_UNCHECKED)
+            {
+                uint32 offset, addr;
+                uint64 sval;
+                offset = read_uint32(frame_ip);
+                sval = GET_OPERAND(uint64, I64, 0);
+                addr = GET_OPERAND(uint32, I32, 2);
+                frame_ip += 4;
+                maddr = UNCHECKED_MEMORY_ADDR();
+                STORE_U32(maddr, (uint32)sval);
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_FAST_INTERP_BCE != 0 */
+
             /* memory size and memory grow instructions */
             HANDLE_OP(WASM_OP_MEMORY_SIZE)
             {
@@ -5425,7 +5738,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         if (ret == (uint32)-1)
                             goto got_exception;
 
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                         CHECK_SUSPEND_FLAGS();
 #endif
 
@@ -5449,7 +5762,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                         if (ret == (uint32)-1)
                             goto got_exception;
 
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                         CHECK_SUSPEND_FLAGS();
 #endif
 
@@ -5740,7 +6053,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             HANDLE_OP(WASM_OP_CALL)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 fidx = read_uint32(frame_ip);
@@ -5757,7 +6070,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_TAIL_CALL != 0
             HANDLE_OP(WASM_OP_RETURN_CALL)
             {
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
                 CHECK_SUSPEND_FLAGS();
 #endif
                 fidx = read_uint32(frame_ip);
@@ -5854,6 +6167,11 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         uint32 *lp_base = NULL, *lp = NULL;
         int i;
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+        if (!PREPARE_FUNC(module, cur_func))
+            goto got_exception;
+#endif
+
         if (cur_func->param_cell_num > 0
             && !(lp_base = lp = wasm_runtime_malloc(cur_func->param_cell_num
                                                     * sizeof(uint32)))) {
@@ -5874,7 +6192,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 lp++;
             }
         }
-        frame->lp = frame->operand + cur_func->const_cell_num;
+        frame->lp = frame->operand + FUNC_CONST_CELL_NUM(cur_func);
         if (lp - lp_base > 0) {
             word_copy(frame->lp, lp_base, lp - lp_base);
         }
@@ -5894,17 +6212,23 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         WASMInterpFrame *outs_area = wasm_exec_env_wasm_stack_top(exec_env);
         int i;
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+        if (!PREPARE_FUNC(module, cur_func))
+            goto got_exception;
+#endif
+
 #if WASM_ENABLE_MULTI_MODULE != 0
         if (cur_func->is_import_func) {
-            outs_area->lp = outs_area->operand
-                            + (cur_func->import_func_inst
-                                   ? cur_func->import_func_inst->const_cell_num
-                                   : 0);
+            outs_area->lp =
+                outs_area->operand
+                + (cur_func->import_func_inst
+                       ? FUNC_CONST_CELL_NUM(cur_func->import_func_inst)
+                       : 0);
         }
         else
 #endif
         {
-            outs_area->lp = outs_area->operand + cur_func->const_cell_num;
+            outs_area->lp = outs_area->operand + FUNC_CONST_CELL_NUM(cur_func);
         }
 
         if ((uint8 *)(outs_area->lp + cur_func->param_cell_num)
@@ -6012,7 +6336,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             cell_num_of_local_stack = cur_func->param_cell_num
                                       + cur_func->local_cell_num
                                       + cur_wasm_func->max_stack_cell_num;
-            all_cell_num = cur_func->const_cell_num + cell_num_of_local_stack;
+            all_cell_num =
+                FUNC_CONST_CELL_NUM(cur_func) + cell_num_of_local_stack;
 #if WASM_ENABLE_GC != 0
             /* area of frame_ref */
             all_cell_num += (cell_num_of_local_stack + 3) / 4;
@@ -6075,7 +6400,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
             wasm_exec_env_set_cur_frame(exec_env, (WASMRuntimeFrame *)frame);
         }
-#if WASM_ENABLE_THREAD_MGR != 0
+#if WASM_ENABLE_THREAD_MGR != 0 || WASM_ENABLE_SAMPLING_PROFILER != 0
         CHECK_SUSPEND_FLAGS();
 #endif
         HANDLE_OP_END();
@@ -6209,6 +6534,11 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
     argc = function->param_cell_num;
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+    if (!PREPARE_FUNC(module_inst, function))
+        return;
+#endif
+
 #if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_DISABLE_STACK_HW_BOUND_CHECK == 0
     /*
      * wasm_runtime_detect_native_stack_overflow is done by
@@ -6236,7 +6566,7 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
 #endif
     frame->ret_offset = 0;
 
-    if ((uint8 *)(outs_area->operand + function->const_cell_num + argc)
+    if ((uint8 *)(outs_area->operand + FUNC_CONST_CELL_NUM(function) + argc)
         > exec_env->wasm_stack.top_boundary) {
         wasm_set_exception((WASMModuleInstance *)exec_env->module_inst,
                            "wasm operand stack overflow");
@@ -6244,7 +6574,8 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
 
     if (argc > 0)
-        word_copy(outs_area->operand + function->const_cell_num, argv, argc);
+        word_copy(outs_area->operand + FUNC_CONST_CELL_NUM(function), argv,
+                  argc);
 
     wasm_exec_env_set_cur_frame(exec_env, frame);
 
@@ -155,13 +155,19 @@ check_buf1(const uint8 *buf, const uint8 *buf_end, uint32 length,
 #define read_uint8(p) TEMPLATE_READ_VALUE(uint8, p)
 #define read_uint32(p) TEMPLATE_READ_VALUE(uint32, p)
 
-#define read_leb_int64(p, p_end, res)                                   \
-    do {                                                                \
-        uint64 res64;                                                   \
-        if (!read_leb((uint8 **)&p, p_end, 64, true, &res64, error_buf, \
-                      error_buf_size))                                  \
-            goto fail;                                                  \
-        res = (int64)res64;                                             \
+#define read_leb_int64(p, p_end, res)                                     \
+    do {                                                                  \
+        uint64 res64;                                                     \
+        if (p < p_end && !(*p & 0x80)) {                                  \
+            /* Inline the common single byte case */                      \
+            res = (int64)((*p & 0x40) ? (uint64)*p | ~(uint64)0x7f : *p); \
+            p++;                                                          \
+            break;                                                        \
+        }                                                                 \
+        if (!read_leb((uint8 **)&p, p_end, 64, true, &res64, error_buf,   \
+                      error_buf_size))                                    \
+            goto fail;                                                    \
+        res = (int64)res64;                                               \
     } while (0)
 
 #if WASM_ENABLE_MEMORY64 != 0
@@ -182,19 +188,31 @@ check_buf1(const uint8 *buf, const uint8 *buf_end, uint32 length,
 #define read_leb_uint32(p, p_end, res)                                   \
     do {                                                                 \
         uint64 res64;                                                    \
+        if (p < p_end && !(*p & 0x80)) {                                 \
+            /* Inline the common single byte case */                     \
+            res = *p;                                                    \
+            p++;                                                         \
+            break;                                                       \
+        }                                                                \
         if (!read_leb((uint8 **)&p, p_end, 32, false, &res64, error_buf, \
                       error_buf_size))                                   \
             goto fail;                                                   \
         res = (uint32)res64;                                             \
     } while (0)
 
-#define read_leb_int32(p, p_end, res)                                   \
-    do {                                                                \
-        uint64 res64;                                                   \
-        if (!read_leb((uint8 **)&p, p_end, 32, true, &res64, error_buf, \
-                      error_buf_size))                                  \
-            goto fail;                                                  \
-        res = (int32)res64;                                             \
+#define read_leb_int32(p, p_end, res)                                     \
+    do {                                                                  \
+        uint64 res64;                                                     \
+        if (p < p_end && !(*p & 0x80)) {                                  \
+            /* Inline the common single byte case */                      \
+            res = (int32)((*p & 0x40) ? (uint32)*p | ~(uint32)0x7f : *p); \
+            p++;                                                          \
+            break;                                                        \
+        }                                                                 \
+        if (!read_leb((uint8 **)&p, p_end, 32, true, &res64, error_buf,   \
+                      error_buf_size))                                    \
+            goto fail;                                                    \
+        res = (int32)res64;                                               \
     } while (0)
 
 #if WASM_ENABLE_MULTI_MEMORY != 0
@@ -5438,6 +5456,9 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.enable_ref_types = true;
 #elif WASM_ENABLE_GC != 0
     option.enable_gc = true;
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+    option.enable_gc_write_barrier = true;
+#endif
 #endif
     option.enable_aux_stack_check = true;
 #if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0 \
@@ -5552,7 +5573,9 @@ init_llvm_jit_functions_stage2_callback(void *arg)
 }
 #endif
 
-#if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0                         \
+     && WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE == 0) \
+    || WASM_ENABLE_JIT != 0
 /* The callback function to compile jit functions */
 static void *
 orcjit_thread_callback(void *arg)
@@ -5781,12 +5804,14 @@ compile_jit_functions(WASMModule *module, char *error_buf,
 
     return true;
 }
-#endif /* end of WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0 */
+#endif /* end of (WASM_ENABLE_FAST_JIT != 0                     \
+                 && WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE == 0) \
+                 || WASM_ENABLE_JIT != 0 */
 
 static bool
 wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
-                             uint32 cur_func_idx, char *error_buf,
-                             uint32 error_buf_size);
+                             uint32 cur_func_idx, bool validate_only,
+                             char *error_buf, uint32 error_buf_size);
 
 #if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_LABELS_AS_VALUES != 0
 void **
@@ -6170,10 +6195,21 @@ load_from_sections(WASMModule *module, WASMSection *sections,
 
     for (i = 0; i < module->function_count; i++) {
         WASMFunction *func = module->functions[i];
-        if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+        /* If the function is prepared on its first call, only validate
+           its body here, unless the validation is deferred too */
+        if (!module->defer_validation
+            && !wasm_loader_prepare_bytecode(module, func, i,
+                                             module->is_lazy_prepare,
+                                             error_buf, error_buf_size)) {
+            return false;
+        }
+#else
+        if (!wasm_loader_prepare_bytecode(module, func, i, false, error_buf,
                                           error_buf_size)) {
             return false;
         }
+#endif
 
         if (i == module->function_count - 1
             && func->code + func->code_size != buf_code_end) {
@@ -6183,6 +6219,12 @@ load_from_sections(WASMModule *module, WASMSection *sections,
         }
     }
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+    /* The function bodies which aren't validated yet may grow the memory */
+    if (module->defer_validation)
+        module->possible_memory_grow = true;
+#endif
+
     if (!module->possible_memory_grow) {
 #if WASM_ENABLE_SHRUNK_MEMORY != 0
         if (aux_data_end_global && aux_heap_base_global
@@ -6190,6 +6232,12 @@ load_from_sections(WASMModule *module, WASMSection *sections,
             uint64 init_memory_size;
             uint64 shrunk_memory_size = align_uint64(aux_heap_base, 8);
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_FAST_INTERP_BCE != 0
+            /* Keep the memory accessed without bounds checks */
+            if (shrunk_memory_size < module->unchecked_mem_end)
+                shrunk_memory_size = align_uint64(module->unchecked_mem_end, 8);
+#endif
+
             /* Only resize(shrunk) the memory size if num_bytes_per_page is in
              * valid range of uint32 */
             if (shrunk_memory_size <= UINT32_MAX) {
@@ -6296,7 +6344,9 @@ load_from_sections(WASMModule *module, WASMSection *sections,
 #endif
 #endif
 
-#if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
+#if (WASM_ENABLE_FAST_JIT != 0                         \
+     && WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE == 0) \
+    || WASM_ENABLE_JIT != 0
     /* Create threads to compile the jit functions */
     if (!compile_jit_functions(module, error_buf, error_buf_size)) {
         return false;
@@ -6368,9 +6418,25 @@ create_module(char *name, char *error_buf, uint32 error_buf_size)
     }
 #endif
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+    if (os_mutex_init(&module->lazy_prepare_lock) != 0) {
+        set_error_buf(error_buf, error_buf_size,
+                      "init lazy prepare lock failed");
+        goto fail4;
+    }
+#endif
+
     (void)ret;
     return module;
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+fail4:
+#endif
+#if WASM_ENABLE_DEBUG_INTERP != 0                         \
+    || (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
+        && WASM_ENABLE_LAZY_JIT != 0)
+    os_mutex_destroy(&module->instance_list_lock);
+#endif
 #if WASM_ENABLE_DEBUG_INTERP != 0                    \
     || (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT \
         && WASM_ENABLE_LAZY_JIT != 0)
@@ -6763,6 +6829,14 @@ wasm_loader_load(uint8 *buf, uint32 size,
     module->load_size = size;
 #endif
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+    /* The functions can only be prepared on their first call if their
+       bytecode is kept after loading */
+    module->is_lazy_prepare = !args->wasm_binary_freeable;
+    module->defer_validation =
+        module->is_lazy_prepare && args->defer_validation;
+#endif
+
     if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
               error_buf, error_buf_size)) {
         goto fail;
@@ -6787,6 +6861,96 @@ fail:
     return NULL;
 }
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+WASMModule *
+wasm_loader_load_from_streamed_sections(WASMSection *section_list,
+                                        const LoadArgs *args, char *error_buf,
+                                        uint32 error_buf_size)
+{
+    WASMModule *module = create_module(args->name, error_buf, error_buf_size);
+    if (!module)
+        return NULL;
+
+    module->package_version = WASM_CURRENT_VERSION;
+
+    /* The sections are freed by the chunked loader after loading, load
+       them like a freeable file buffer so that the const strings and the
+       data segments are cloned */
+    if (!load_from_sections(module, section_list, true, true, args->no_resolve,
+                            error_buf, error_buf_size)) {
+        goto fail;
+    }
+
+#if WASM_ENABLE_LIBC_WASI != 0
+    /* Check the WASI application ABI */
+    if (!check_wasi_abi_compatibility(module,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                                      true,
+#endif
+                                      error_buf, error_buf_size)) {
+        goto fail;
+    }
+#endif
+
+    LOG_VERBOSE("Load module from streamed sections success.\n");
+    return module;
+
+fail:
+    wasm_loader_unload(module);
+    return NULL;
+}
+#endif /* end of WASM_ENABLE_STREAM_LOADER != 0 */
+
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+bool
+wasm_loader_prepare_function(WASMModule *module, uint32 func_idx,
+                             char *error_buf, uint32 error_buf_size)
+{
+    WASMFunction *func, func_prepared;
+    bool ret = true;
+
+    bh_assert(func_idx < module->function_count);
+    func = module->functions[func_idx];
+
+    os_mutex_lock(&module->lazy_prepare_lock);
+
+    /* Another thread may have prepared it while we waited for the lock */
+    if (!func->code_compiled) {
+        /* Prepare a copy of the function, the threads calling it check
+           code_compiled only and mustn't see a partially prepared one */
+        bh_memcpy_s(&func_prepared, sizeof(WASMFunction), func,
+                    sizeof(WASMFunction));
+#if WASM_ENABLE_EXCE_HANDLING != 0
+        func_prepared.exception_handler_count = 0;
+#endif
+
+        if (wasm_loader_prepare_bytecode(module, &func_prepared, func_idx,
+                                         false, error_buf, error_buf_size)) {
+            func->consts = func_prepared.consts;
+            func->const_cell_num = func_prepared.const_cell_num;
+            func->max_stack_cell_num = func_prepared.max_stack_cell_num;
+            func->max_block_num = func_prepared.max_block_num;
+            func->code_compiled_size = func_prepared.code_compiled_size;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+            func->exception_handler_count =
+                func_prepared.exception_handler_count;
+#endif
+            /* Publish the code after the fields above */
+            os_atomic_thread_fence(os_memory_order_release);
+            func->code_compiled = func_prepared.code_compiled;
+        }
+        else {
+            if (func_prepared.code_compiled)
+                wasm_runtime_free(func_prepared.code_compiled);
+            ret = false;
+        }
+    }
+
+    os_mutex_unlock(&module->lazy_prepare_lock);
+    return ret;
+}
+#endif /* end of WASM_ENABLE_LAZY_FAST_INTERP != 0 */
+
 void
 wasm_loader_unload(WASMModule *module)
 {
@@ -6802,7 +6966,11 @@ wasm_loader_unload(WASMModule *module)
         os_thread_join(module->llvm_jit_init_thread, NULL);
 #endif
 
-#if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    /* Drop the pending background compile requests of this module and
+       wait for the ones being compiled to finish */
+    jit_compiler_cancel_compile(module);
+#elif WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
     /* Stop Fast/LLVM JIT compilation firstly to avoid accessing
        module internal data after they were freed */
     orcjit_stop_compile_threads(module);
@@ -7001,6 +7169,10 @@ wasm_loader_unload(WASMModule *module)
     os_mutex_destroy(&module->instance_list_lock);
 #endif
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+    os_mutex_destroy(&module->lazy_prepare_lock);
+#endif
+
 #if WASM_ENABLE_LOAD_CUSTOM_SECTION != 0
     wasm_runtime_destroy_custom_sections(module->custom_section_list);
 #endif
@@ -7931,6 +8103,18 @@ typedef struct BranchBlock {
     bool is_stack_polymorphic;
 } BranchBlock;
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_FAST_INTERP_BCE != 0
+/* Max number of the locals whose checked ranges are remembered */
+#define BCE_CHECKED_LOCAL_NUM 8
+
+typedef struct BCECheckedLocal {
+    /* the offset of the local used as the address */
+    int16 local_offset;
+    /* the end of the range above the address known to be in bounds */
+    uint64 checked_end;
+} BCECheckedLocal;
+#endif
+
 typedef struct WASMLoaderContext {
     /* frame ref stack */
     uint8 *frame_ref;
@@ -7989,6 +8173,17 @@ typedef struct WASMLoaderContext {
     uint32 i32_const_max_num;
     uint32 i32_const_num;
 
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+    /* Whether the bounds checks of the default memory can be eliminated */
+    bool bce_enabled;
+    /* The min size of the default memory when running */
+    uint64 bce_min_memory_size;
+    /* The locals used as addresses by the checked accesses of the current
+       basic block, see is_mem_access_check_redundant */
+    BCECheckedLocal bce_checked_locals[BCE_CHECKED_LOCAL_NUM];
+    uint32 bce_checked_local_num;
+#endif
+
     /* processed code */
     uint8 *p_code_compiled;
     uint8 *p_code_compiled_end;
@@ -8998,6 +9193,10 @@ wasm_loader_ctx_reinit(WASMLoaderContext *ctx)
     /* init preserved local offsets */
     ctx->preserved_local_offset = ctx->max_dynamic_offset;
 
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+    ctx->bce_checked_local_num = 0;
+#endif
+
     /* const buf is reserved */
     return true;
 }
@@ -9638,6 +9837,238 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+static void
+bce_init(WASMLoaderContext *ctx, WASMModule *module)
+{
+    uint32 flags = 0, num_bytes_per_page = 0, init_page_count = 0;
+
+    if (module->import_memory_count > 0) {
+        flags = module->import_memories[0].u.memory.mem_type.flags;
+        num_bytes_per_page =
+            module->import_memories[0].u.memory.mem_type.num_bytes_per_page;
+        init_page_count =
+            module->import_memories[0].u.memory.mem_type.init_page_count;
+    }
+    else if (module->memory_count > 0) {
+        flags = module->memories[0].flags;
+        num_bytes_per_page = module->memories[0].num_bytes_per_page;
+        init_page_count = module->memories[0].init_page_count;
+    }
+
+    /* The memory grows but never shrinks, so its initial size is the min
+       size, unless it is shrunk after loading, see unchecked_mem_end */
+    ctx->bce_enabled = !(flags & MEMORY64_FLAG)
+                       && module->import_memory_count + module->memory_count
+                              <= 1;
+    ctx->bce_min_memory_size = (uint64)num_bytes_per_page * init_page_count;
+    ctx->bce_checked_local_num = 0;
+}
+
+/* Forget the checked locals at a join point of the control flow */
+static void
+bce_handle_opcode(WASMLoaderContext *ctx, uint8 opcode)
+{
+    switch (opcode) {
+        case WASM_OP_LOOP:
+        case WASM_OP_ELSE:
+        case WASM_OP_END:
+        case WASM_OP_TRY:
+        case WASM_OP_CATCH:
+        case WASM_OP_CATCH_ALL:
+        case WASM_OP_DELEGATE:
+            ctx->bce_checked_local_num = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+/* Forget the checked ranges of a local which is set */
+static void
+bce_kill_local(WASMLoaderContext *ctx, int16 local_offset)
+{
+    uint32 i;
+
+    for (i = 0; i < ctx->bce_checked_local_num; i++) {
+        if (ctx->bce_checked_locals[i].local_offset == local_offset) {
+            ctx->bce_checked_locals[i] =
+                ctx->bce_checked_locals[--ctx->bce_checked_local_num];
+            return;
+        }
+    }
+}
+
+static uint8
+get_unchecked_mem_opcode(uint8 opcode, uint32 *p_bytes)
+{
+    switch (opcode) {
+        case WASM_OP_I32_LOAD:
+        case WASM_OP_F32_LOAD:
+            *p_bytes = 4;
+            return EXT_OP_I32_LOAD_UNCHECKED;
+        case WASM_OP_I64_LOAD:
+        case WASM_OP_F64_LOAD:
+            *p_bytes = 8;
+            return EXT_OP_I64_LOAD_UNCHECKED;
+        case WASM_OP_I32_LOAD8_S:
+            *p_bytes = 1;
+            return EXT_OP_I32_LOAD8_S_UNCHECKED;
+        case WASM_OP_I32_LOAD8_U:
+            *p_bytes = 1;
+            return EXT_OP_I32_LOAD8_U_UNCHECKED;
+        case WASM_OP_I32_LOAD16_S:
+            *p_bytes = 2;
+            return EXT_OP_I32_LOAD16_S_UNCHECKED;
+        case WASM_OP_I32_LOAD16_U:
+            *p_bytes = 2;
+            return EXT_OP_I32_LOAD16_U_UNCHECKED;
+        case WASM_OP_I64_LOAD8_S:
+            *p_bytes = 1;
+            return EXT_OP_I64_LOAD8_S_UNCHECKED;
+        case WASM_OP_I64_LOAD8_U:
+            *p_bytes = 1;
+            return EXT_OP_I64_LOAD8_U_UNCHECKED;
+        case WASM_OP_I64_LOAD16_S:
+            *p_bytes = 2;
+            return EXT_OP_I64_LOAD16_S_UNCHECKED;
+        case WASM_OP_I64_LOAD16_U:
+            *p_bytes = 2;
+            return EXT_OP_I64_LOAD16_U_UNCHECKED;
+        case WASM_OP_I64_LOAD32_S:
+            *p_bytes = 4;
+            return EXT_OP_I64_LOAD32_S_UNCHECKED;
+        case WASM_OP_I64_LOAD32_U:
+            *p_bytes = 4;
+            return EXT_OP_I64_LOAD32_U_UNCHECKED;
+        case WASM_OP_I32_STORE:
+        case WASM_OP_F32_STORE:
+            *p_bytes = 4;
+            return EXT_OP_I32_STORE_UNCHECKED;
+        case WASM_OP_I64_STORE:
+        case WASM_OP_F64_STORE:
+            *p_bytes = 8;
+            return EXT_OP_I64_STORE_UNCHECKED;
+        case WASM_OP_I32_STORE8:
+            *p_bytes = 1;
+            return EXT_OP_I32_STORE8_UNCHECKED;
+        case WASM_OP_I32_STORE16:
+            *p_bytes = 2;
+            return EXT_OP_I32_STORE16_UNCHECKED;
+        case WASM_OP_I64_STORE8:
+            *p_bytes = 1;
+            return EXT_OP_I64_STORE8_UNCHECKED;
+        case WASM_OP_I64_STORE16:
+            *p_bytes = 2;
+            return EXT_OP_I64_STORE16_UNCHECKED;
+        case WASM_OP_I64_STORE32:
+            *p_bytes = 4;
+            return EXT_OP_I64_STORE32_UNCHECKED;
+        default:
+            bh_assert(0);
+            *p_bytes = 0;
+            return 0;
+    }
+}
+
+/**
+ * Check whether the bounds check of a load/store of the default memory is
+ * redundant, which is true if:
+ *   - the address is a const, and the access ends within the min memory
+ *     size, or
+ *   - the address is a local, and a preceding access of the same basic
+ *     block with the same local has checked the range till the end of this
+ *     access, as the memory never shrinks
+ * Otherwise the checked range of the local is recorded.
+ *
+ * @return the opcode of the load/store without the check if the check is
+ *         redundant, 0 otherwise
+ */
+static uint8
+is_mem_access_check_redundant(WASMLoaderContext *ctx, WASMModule *module,
+                              uint8 opcode, uint64 mem_offset)
+{
+    BranchBlock *cur_block = ctx->frame_csp - 1;
+    BCECheckedLocal *checked_local;
+    uint32 value_cells = 0, bytes, i;
+    uint8 unchecked_opcode;
+    int16 addr_offset;
+    uint64 end;
+
+    if (!ctx->bce_enabled || cur_block->is_stack_polymorphic)
+        return 0;
+
+    switch (opcode) {
+        case WASM_OP_I32_STORE:
+        case WASM_OP_I32_STORE8:
+        case WASM_OP_I32_STORE16:
+        case WASM_OP_F32_STORE:
+            value_cells = 1;
+            break;
+        case WASM_OP_I64_STORE:
+        case WASM_OP_I64_STORE8:
+        case WASM_OP_I64_STORE16:
+        case WASM_OP_I64_STORE32:
+        case WASM_OP_F64_STORE:
+            value_cells = 2;
+            break;
+        default:
+            break;
+    }
+
+    /* the address is under the value to store */
+    if ((uint32)(ctx->frame_offset - ctx->frame_offset_bottom)
+        <= value_cells)
+        return 0;
+    addr_offset = *(ctx->frame_offset - 1 - value_cells);
+
+    unchecked_opcode = get_unchecked_mem_opcode(opcode, &bytes);
+    end = mem_offset + bytes;
+
+    if (addr_offset < 0) {
+        /* The slots of the consts are only known in the second traverse,
+           the i32 consts are placed after the i64 consts */
+        if (!ctx->p_code_compiled
+            || addr_offset < -(int32)ctx->i32_const_num)
+            return 0;
+        end += (uint32)ctx->i32_consts[ctx->i32_const_num + addr_offset];
+        if (end > ctx->bce_min_memory_size)
+            return 0;
+        if (end > module->unchecked_mem_end)
+            module->unchecked_mem_end = end;
+        return unchecked_opcode;
+    }
+
+#if WASM_ENABLE_SHARED_HEAP == 0
+    /* A checked access may be in the shared heap, which isn't addressed
+       like the linear memory, so only the consts are handled then */
+    if (addr_offset < ctx->start_dynamic_offset) {
+        for (i = 0; i < ctx->bce_checked_local_num; i++) {
+            checked_local = &ctx->bce_checked_locals[i];
+            if (checked_local->local_offset == addr_offset) {
+                if (end <= checked_local->checked_end)
+                    return unchecked_opcode;
+                checked_local->checked_end = end;
+                return 0;
+            }
+        }
+
+        /* replace the first one if the list is full */
+        i = ctx->bce_checked_local_num < BCE_CHECKED_LOCAL_NUM
+                ? ctx->bce_checked_local_num++
+                : 0;
+        checked_local = &ctx->bce_checked_locals[i];
+        checked_local->local_offset = addr_offset;
+        checked_local->checked_end = end;
+    }
+#else
+    (void)checked_local;
+    (void)i;
+#endif
+    return 0;
+}
+#endif /* end of WASM_ENABLE_FAST_INTERP_BCE != 0 */
+
 /*
     PUSH(POP)_XXX = push(pop) frame_ref + push(pop) frame_offset
     -- Mostly used for the binary / compare operation
@@ -11045,8 +11476,8 @@ read_leb_quick(uint8 **p_buf, uint32 maxbits, bool sign)
 
 static bool
 wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
-                             uint32 cur_func_idx, char *error_buf,
-                             uint32 error_buf_size)
+                             uint32 cur_func_idx, bool validate_only,
+                             char *error_buf, uint32 error_buf_size)
 {
     uint8 *p = func->code, *p_end = func->code + func->code_size, *p_org;
     uint32 param_count, local_count, global_count;
@@ -11076,6 +11507,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     bool disable_emit, preserve_local = false, if_condition_available = true;
     float32 f32_const;
     float64 f64_const;
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+    uint8 unchecked_opcode;
+#endif
 
     LOG_OP("\nProcessing func | [%d] params | [%d] locals | [%d] return\n",
            func->param_cell_num, func->local_cell_num, func->ret_cell_num);
@@ -11111,6 +11545,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     if (!(loader_ctx = wasm_loader_ctx_init(func, error_buf, error_buf_size))) {
         goto fail;
     }
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_FAST_INTERP_BCE != 0
+    bce_init(loader_ctx, module);
+#endif
 #if WASM_ENABLE_GC != 0
     loader_ctx->module = module;
     loader_ctx->ref_type_set = module->ref_type_set;
@@ -11210,6 +11647,9 @@ re_scan:
         p_org = p;
         disable_emit = false;
         emit_label(opcode);
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+        bce_handle_opcode(loader_ctx, opcode);
+#endif
 #endif
         switch (opcode) {
             case WASM_OP_UNREACHABLE:
@@ -13144,6 +13584,9 @@ re_scan:
                 GET_LOCAL_INDEX_TYPE_AND_OFFSET();
 
 #if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+                bce_kill_local(loader_ctx, (int16)local_offset);
+#endif
                 if (!(preserve_referenced_local(
                         loader_ctx, opcode, local_offset, local_type,
                         &preserve_local, error_buf, error_buf_size)))
@@ -13235,6 +13678,9 @@ re_scan:
                 PUSH_TYPE(local_type);
 
 #if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+                bce_kill_local(loader_ctx, (int16)local_offset);
+#endif
                 if (!(preserve_referenced_local(
                         loader_ctx, opcode, local_offset, local_type,
                         &preserve_local, error_buf, error_buf_size)))
@@ -13500,6 +13946,13 @@ re_scan:
                     goto fail;
                 }
 #if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_FAST_INTERP_BCE != 0
+                if ((unchecked_opcode = is_mem_access_check_redundant(
+                         loader_ctx, module, opcode, mem_offset))) {
+                    skip_label();
+                    emit_label(unchecked_opcode);
+                }
+#endif
                 emit_uint32(loader_ctx, mem_offset);
 #endif
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
@@ -16117,8 +16570,17 @@ re_scan:
     }
 
 #if WASM_ENABLE_FAST_INTERP != 0
-    if (loader_ctx->p_code_compiled == NULL)
+    if (loader_ctx->p_code_compiled == NULL) {
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+        /* The first traverse has validated the function body, the code
+           is generated when the function is prepared on its first call */
+        if (validate_only) {
+            return_value = true;
+            goto fail;
+        }
+#endif
         goto re_scan;
+    }
 
     func->const_cell_num =
         loader_ctx->i64_const_num * 2 + loader_ctx->i32_const_num;
@@ -16161,5 +16623,6 @@ fail:
     (void)p_org;
     (void)mem_offset;
     (void)align;
+    (void)validate_only;
     return return_value;
 }
@@ -43,6 +43,25 @@ WASMModule *
 wasm_loader_load_from_sections(WASMSection *section_list, char *error_buf,
                                uint32 error_buf_size);
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+/**
+ * Load a WASM module from the section list received by the chunked
+ * loader, the sections are loaded like a freeable wasm binary buffer, so
+ * that they can be freed once the module is loaded.
+ *
+ * @param section_list the section list which contains each section data
+ * @param args the load arguments
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return WASM module loaded, NULL if failed
+ */
+WASMModule *
+wasm_loader_load_from_streamed_sections(WASMSection *section_list,
+                                        const LoadArgs *args, char *error_buf,
+                                        uint32 error_buf_size);
+#endif
+
 /**
  * Unload a WASM module.
  *
@@ -51,6 +70,23 @@ wasm_loader_load_from_sections(WASMSection *section_list, char *error_buf,
 void
 wasm_loader_unload(WASMModule *module);
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+/**
+ * Prepare the fast interpreter's code of a function which wasn't prepared
+ * when loading the module, it may be called by several threads at once.
+ *
+ * @param module the module of the function
+ * @param func_idx the index of the function in module->functions
+ * @param error_buf output of the error info
+ * @param error_buf_size the size of the error string
+ *
+ * @return true if the function is prepared, false otherwise
+ */
+bool
+wasm_loader_prepare_function(WASMModule *module, uint32 func_idx,
+                             char *error_buf, uint32 error_buf_size);
+#endif
+
 /**
  * Find address of related else opcode and end opcode of opcode block/loop/if
  * according to the start address of opcode.
@@ -278,6 +278,29 @@ typedef enum WASMOpcode {
     DEBUG_OP_BREAK = 0xdc, /* debug break point */
 #endif
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_FAST_INTERP_BCE != 0
+    /* load/store whose bounds check is proven redundant by the loader */
+    EXT_OP_I32_LOAD_UNCHECKED = 0xdd,
+    EXT_OP_I64_LOAD_UNCHECKED = 0xde,
+    EXT_OP_I32_LOAD8_S_UNCHECKED = 0xdf,
+    EXT_OP_I32_LOAD8_U_UNCHECKED = 0xe0,
+    EXT_OP_I32_LOAD16_S_UNCHECKED = 0xe1,
+    EXT_OP_I32_LOAD16_U_UNCHECKED = 0xe2,
+    EXT_OP_I64_LOAD8_S_UNCHECKED = 0xe3,
+    EXT_OP_I64_LOAD8_U_UNCHECKED = 0xe4,
+    EXT_OP_I64_LOAD16_S_UNCHECKED = 0xe5,
+    EXT_OP_I64_LOAD16_U_UNCHECKED = 0xe6,
+    EXT_OP_I64_LOAD32_S_UNCHECKED = 0xe7,
+    EXT_OP_I64_LOAD32_U_UNCHECKED = 0xe8,
+    EXT_OP_I32_STORE_UNCHECKED = 0xe9,
+    EXT_OP_I64_STORE_UNCHECKED = 0xea,
+    EXT_OP_I32_STORE8_UNCHECKED = 0xeb,
+    EXT_OP_I32_STORE16_UNCHECKED = 0xec,
+    EXT_OP_I64_STORE8_UNCHECKED = 0xed,
+    EXT_OP_I64_STORE16_UNCHECKED = 0xee,
+    EXT_OP_I64_STORE32_UNCHECKED = 0xef,
+#endif
+
     /* Post-MVP extend op prefix */
     WASM_OP_GC_PREFIX = 0xfb,
     WASM_OP_MISC_PREFIX = 0xfc,
@@ -782,6 +805,31 @@ typedef enum WASMAtomicEXTOpcode {
 
 #define SET_GOTO_TABLE_ELEM(opcode) [opcode] = HANDLE_OPCODE(opcode)
 
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_FAST_INTERP_BCE != 0
+#define DEF_UNCHECKED_MEM_OP_HANDLES()                             \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_LOAD_UNCHECKED),     /* 0xdd */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD_UNCHECKED),     /* 0xde */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_LOAD8_S_UNCHECKED),  /* 0xdf */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_LOAD8_U_UNCHECKED),  /* 0xe0 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_LOAD16_S_UNCHECKED), /* 0xe1 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_LOAD16_U_UNCHECKED), /* 0xe2 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD8_S_UNCHECKED),  /* 0xe3 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD8_U_UNCHECKED),  /* 0xe4 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD16_S_UNCHECKED), /* 0xe5 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD16_U_UNCHECKED), /* 0xe6 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD32_S_UNCHECKED), /* 0xe7 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_LOAD32_U_UNCHECKED), /* 0xe8 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_STORE_UNCHECKED),    /* 0xe9 */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_STORE_UNCHECKED),    /* 0xea */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_STORE8_UNCHECKED),   /* 0xeb */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_STORE16_UNCHECKED),  /* 0xec */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_STORE8_UNCHECKED),   /* 0xed */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_STORE16_UNCHECKED),  /* 0xee */ \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I64_STORE32_UNCHECKED),  /* 0xef */
+#else
+#define DEF_UNCHECKED_MEM_OP_HANDLES()
+#endif
+
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_SIMD != 0
 #define SET_GOTO_TABLE_SIMD_PREFIX_ELEM() \
     SET_GOTO_TABLE_ELEM(WASM_OP_SIMD_PREFIX),
@@ -1021,6 +1069,7 @@ typedef enum WASMAtomicEXTOpcode {
         SET_GOTO_TABLE_SIMD_PREFIX_ELEM()            /* 0xfd */ \
         SET_GOTO_TABLE_ELEM(WASM_OP_ATOMIC_PREFIX),  /* 0xfe */ \
         DEF_DEBUG_BREAK_HANDLE()                                \
+        DEF_UNCHECKED_MEM_OP_HANDLES()                          \
     };
 
 #ifdef __cplusplus
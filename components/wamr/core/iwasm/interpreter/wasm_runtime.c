@@ -55,6 +55,94 @@ set_error_buf_v(char *error_buf, uint32 error_buf_size, const char *format, ...)
     }
 }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* Get the offset of an active data segment if it is a constant */
+static bool
+get_data_seg_const_offset(const WASMDataSeg *data_seg, uint64 *p_offset)
+{
+    if (data_seg->base_offset.init_expr_type == INIT_EXPR_TYPE_I32_CONST) {
+        *p_offset = (uint32)data_seg->base_offset.u.i32;
+        return true;
+    }
+#if WASM_ENABLE_MEMORY64 != 0
+    if (data_seg->base_offset.init_expr_type == INIT_EXPR_TYPE_I64_CONST) {
+        *p_offset = (uint64)data_seg->base_offset.u.i64;
+        return true;
+    }
+#endif
+    /* The value of a global may be imported and differ between instances */
+    return false;
+}
+
+/**
+ * Write the active data segments of the default memory into the memory
+ * image of the module, which is mapped into its instances instead of
+ * copying the segments. Without the image, e.g. when an offset isn't a
+ * constant, the instances copy the segments as usual.
+ */
+static void
+memory_image_create(WASMModule *module)
+{
+    WASMDataSeg *data_seg;
+    uint64 base_offset, memory_size, data_end = 0, data_size = 0;
+    uint32 i;
+
+    if (!module || module->import_memory_count > 0 || module->memory_count == 0)
+        return;
+
+    memory_size = (uint64)module->memories[0].num_bytes_per_page
+                  * module->memories[0].init_page_count;
+
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (data_seg->memory_index != 0)
+            continue;
+        if (!get_data_seg_const_offset(data_seg, &base_offset))
+            return;
+        /* Leave the segment that doesn't fit to the instantiation,
+           which reports it */
+        if (base_offset > memory_size
+            || data_seg->data_length > memory_size - base_offset)
+            return;
+        if (base_offset + data_seg->data_length > data_end)
+            data_end = base_offset + data_seg->data_length;
+        data_size += data_seg->data_length;
+    }
+
+    if (data_size < WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+        || !wasm_memory_image_create(&module->memory_image, data_end))
+        return;
+
+    /* Write the segments in order, the later ones overwrite the
+       overlapped bytes of the earlier ones like the instantiation */
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (data_seg->memory_index != 0)
+            continue;
+        get_data_seg_const_offset(data_seg, &base_offset);
+        if (!wasm_memory_image_write(&module->memory_image, base_offset,
+                                     data_seg->data, data_seg->data_length))
+            goto fail;
+    }
+
+    if (!wasm_memory_image_seal(&module->memory_image))
+        goto fail;
+
+    LOG_VERBOSE("Create memory image of %" PRIu64 " bytes", data_end);
+    return;
+fail:
+    wasm_memory_image_destroy(&module->memory_image);
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
+
 WASMModule *
 wasm_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -62,27 +150,85 @@ wasm_load(uint8 *buf, uint32 size,
 #endif
           const LoadArgs *name, char *error_buf, uint32 error_buf_size)
 {
-    return wasm_loader_load(buf, size,
+    WASMModule *module = wasm_loader_load(buf, size,
 #if WASM_ENABLE_MULTI_MODULE != 0
-                            main_module,
+                                          main_module,
+#endif
+                                          name, error_buf, error_buf_size);
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    memory_image_create(module);
 #endif
-                            name, error_buf, error_buf_size);
+    return module;
 }
 
 WASMModule *
 wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                         uint32 error_buf_size)
 {
-    return wasm_loader_load_from_sections(section_list, error_buf,
-                                          error_buf_size);
+    WASMModule *module = wasm_loader_load_from_sections(
+        section_list, error_buf, error_buf_size);
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    memory_image_create(module);
+#endif
+    return module;
+}
+
+#if WASM_ENABLE_STREAM_LOADER != 0
+WASMModule *
+wasm_load_from_streamed_sections(WASMSection *section_list,
+                                 const LoadArgs *args, char *error_buf,
+                                 uint32 error_buf_size)
+{
+    WASMModule *module = wasm_loader_load_from_streamed_sections(
+        section_list, args, error_buf, error_buf_size);
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    memory_image_create(module);
+#endif
+    return module;
 }
+#endif
 
 void
 wasm_unload(WASMModule *module)
 {
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    wasm_memory_image_destroy(&module->memory_image);
+#endif
     wasm_loader_unload(module);
 }
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+bool
+wasm_prepare_func(WASMModuleInstance *module_inst, WASMFunctionInstance *func)
+{
+    WASMModuleInstance *func_module_inst = module_inst;
+    WASMModule *module;
+    char error_buf[128];
+    uint32 func_idx;
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    if (func->is_import_func && func->import_func_inst) {
+        func_module_inst = func->import_module_inst;
+        func = func->import_func_inst;
+    }
+#endif
+
+    if (func->is_import_func)
+        return true;
+
+    module = func_module_inst->module;
+    func_idx = (uint32)(func - func_module_inst->e->functions)
+               - module->import_function_count;
+
+    if (!wasm_loader_prepare_function(module, func_idx, error_buf,
+                                      sizeof(error_buf))) {
+        wasm_set_exception(module_inst, error_buf);
+        return false;
+    }
+    return true;
+}
+#endif
+
 bool
 wasm_resolve_symbols(WASMModule *module)
 {
@@ -460,6 +606,17 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
         memory->memory_data_end = memory->memory_data + memory_data_size;
     }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* Map the initial content of the memory instead of copying the data
+       segments later, unless the app heap is inserted before their end */
+    if (memory_idx == 0 && !parent
+        && (heap_size == 0 || heap_offset >= module->memory_image.data_end)
+        && wasm_memory_image_map(&module->memory_image, memory->memory_data,
+                                 memory_data_size)) {
+        module_inst->e->common.memory_image_mapped = true;
+    }
+#endif
+
     /* Initialize heap */
     if (memory_idx == 0 && heap_size > 0) {
         uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
@@ -853,7 +1010,7 @@ functions_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
 
         function->local_offsets = function->u.func->local_offsets;
 
-#if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_LAZY_FAST_INTERP == 0
         function->const_cell_num = function->u.func->const_cell_num;
 #endif
 
@@ -2810,6 +2967,13 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             goto fail;
         }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+        if (module_inst->e->common.memory_image_mapped
+            && data_seg->memory_index == 0)
+            /* The segment is mapped with the memory image */
+            continue;
+#endif
+
         if (memory_data) {
             bh_memcpy_s(memory_data + base_offset,
                         (uint32)(memory_size - base_offset), data_seg->data,
@@ -2823,6 +2987,8 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
 #else
     module_inst->e->shared_heap_start_off.u32[0] = UINT32_MAX;
 #endif
+    module_inst->e->shared_heap_cur_range =
+        wasm_runtime_get_empty_shared_heap_range();
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -3310,6 +3476,10 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
     if (!module_inst)
         return;
 
+    /* the checked out exec_envs must have been returned */
+    wasm_exec_env_pool_destroy(module_inst->e->common.exec_env_pool);
+    module_inst->e->common.exec_env_pool = NULL;
+
     if (module_inst->exec_env_singleton) {
         /* wasm_exec_env_destroy will call
            wasm_cluster_wait_for_all_except_self to wait for other
@@ -3319,6 +3489,12 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
         wasm_exec_env_destroy(module_inst->exec_env_singleton);
     }
 
+#if WASM_ENABLE_SHARED_HEAP != 0
+    /* Release the shared heap so that it can be chained again */
+    wasm_runtime_detach_shared_heap_internal(
+        (WASMModuleInstanceCommon *)module_inst);
+#endif
+
 #if WASM_ENABLE_DEBUG_INTERP != 0                         \
     || (WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
         && WASM_ENABLE_LAZY_JIT != 0)
@@ -4553,6 +4729,21 @@ fail:
     return ret;
 }
 
+WASMSharedHeapRange *
+llvm_jit_update_last_used_shared_heap(WASMModuleInstance *module_inst,
+                                      uint64 app_offset, uint64 bytes)
+{
+#if WASM_ENABLE_SHARED_HEAP != 0
+    return wasm_runtime_update_last_used_shared_heap(
+        (WASMModuleInstanceCommon *)module_inst, app_offset, bytes);
+#else
+    (void)module_inst;
+    (void)app_offset;
+    (void)bytes;
+    return NULL;
+#endif
+}
+
 #if WASM_ENABLE_BULK_MEMORY != 0
 bool
 llvm_jit_memory_init(WASMModuleInstance *module_inst, uint32 seg_index,
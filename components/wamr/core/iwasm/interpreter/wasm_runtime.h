@@ -92,13 +92,75 @@ typedef union {
     uint32 u32[2];
 } MemBound;
 
+/* Size classes of the small object lists of a shared heap segment,
+   16 bytes to 2 KB, block header included */
+#define SHARED_HEAP_SMALL_CLASS_NUM 8
+
+/*
+ * Offset range of a shared heap segment, which the jit/aot code checks
+ * for the segment accessed last. The module instance refers to it with a
+ * single pointer and it isn't changed while the heap is attached, so the
+ * range and the base address read from it always belong together.
+ */
+typedef struct WASMSharedHeapRange {
+    MemBound start_off;
+    MemBound end_off;
+    /* base_addr - start_off, to simplify the calculation */
+    DefPointer(uint8 *, base_addr_adj);
+} WASMSharedHeapRange;
+
+/* A part of a shared heap, managed by its own allocator */
+typedef struct WASMSharedHeapSegment {
+    struct WASMSharedHeapSegment *next;
+    void *heap_handle;
+    uint8 *base_addr;
+    uint64 size;
+    /* Offset of the segment in the heap */
+    uint64 offset;
+    /* Ranges of the segment for 32-bit and 64-bit memories */
+    WASMSharedHeapRange range_mem32;
+    WASMSharedHeapRange range_mem64;
+    /*
+     * Lock-free lists of the freed small blocks, each one is an offset
+     * in the segment tagged with a modification count in the high 32
+     * bits against ABA
+     */
+    bh_atomic_64_t small_lists[SHARED_HEAP_SMALL_CLASS_NUM];
+} WASMSharedHeapSegment;
+
 typedef struct WASMSharedHeap {
+    /* Next heap in the list of all created shared heaps */
     struct WASMSharedHeap *next;
-    void *heap_handle;
+    /* Next heap of the chain, which is placed below this one */
+    struct WASMSharedHeap *chain_next;
+    /*
+     * The address range of the heap, only the first committed_size bytes
+     * of which are accessible:
+     *   [start_off_memxx, start_off_memxx + size - 1]
+     * With hardware bound check the whole range is reserved at base_addr
+     * and the segments are committed in place, otherwise base_addr is
+     * the first segment and the others are allocated separately.
+     */
     uint8 *base_addr;
     uint64 size;
     uint64 start_off_mem64;
     uint64 start_off_mem32;
+    bh_atomic_64_t committed_size;
+    /*
+     * Segments of the heap in ascending address order, the first one
+     * is created with the heap and the others are committed after it
+     * when the heap grows
+     */
+    WASMSharedHeapSegment *segments;
+    /* Size of the first segment, the minimum size of the others */
+    uint64 segment_size;
+    /* Serializes the growth of the heap */
+    korp_mutex lock;
+    /* Number of module instances the chain headed by the heap is
+       attached to */
+    uint32 attached_count;
+    /* Whether the heap is in a chain but not its head */
+    bool chained;
 } WASMSharedHeap;
 
 struct WASMMemoryInstance {
@@ -215,7 +277,7 @@ struct WASMFunctionInstance {
     uint16 ret_cell_num;
     /* cell num of local variables, 0 for import function */
     uint16 local_cell_num;
-#if WASM_ENABLE_FAST_INTERP != 0
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_LAZY_FAST_INTERP == 0
     /* cell num of consts */
     uint16 const_cell_num;
 #endif
@@ -324,6 +386,13 @@ typedef struct WASMModuleInstanceExtraCommon {
     uint8 *gc_heap_pool;
     /* The gc heap created */
     void *gc_heap_handle;
+#endif
+    /* The idle exec_envs for short-lived calls, NULL if not created */
+    struct WASMExecEnvPool *exec_env_pool;
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* Whether the memory image of the module is mapped into the default
+       memory, the active data segments are already in place then */
+    bool memory_image_mapped;
 #endif
 } WASMModuleInstanceExtraCommon;
 
@@ -366,12 +435,9 @@ typedef struct WASMModuleInstanceExtra {
 #if WASM_ENABLE_SHARED_HEAP != 0
     WASMSharedHeap *shared_heap;
 #if WASM_ENABLE_JIT != 0
-    /*
-     * Adjusted shared heap based addr to simple the calculation
-     * in the aot code. The value is:
-     *   shared_heap->base_addr - shared_heap->start_off
-     */
-    uint8 *shared_heap_base_addr_adj;
+    /* Range of the shared heap segment accessed last */
+    WASMSharedHeapRange *shared_heap_cur_range;
+    /* Lowest offset of the attached shared heap chain */
     MemBound shared_heap_start_off;
 #endif
 #endif
@@ -533,9 +599,29 @@ WASMModule *
 wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                         uint32 error_buf_size);
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+WASMModule *
+wasm_load_from_streamed_sections(WASMSection *section_list,
+                                 const LoadArgs *args, char *error_buf,
+                                 uint32 error_buf_size);
+#endif
+
 void
 wasm_unload(WASMModule *module);
 
+#if WASM_ENABLE_LAZY_FAST_INTERP != 0
+/**
+ * Prepare the code of a function which is called for the first time.
+ *
+ * @param module_inst the module instance calling the function
+ * @param func the function to prepare
+ *
+ * @return true if success, false otherwise and an exception is thrown
+ */
+bool
+wasm_prepare_func(WASMModuleInstance *module_inst, WASMFunctionInstance *func);
+#endif
+
 bool
 wasm_resolve_symbols(WASMModule *module);
 
@@ -779,6 +865,12 @@ fast_jit_call_indirect(WASMExecEnv *exec_env, uint32 tbl_idx, uint32 elem_idx,
 bool
 fast_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx,
                        struct WASMInterpFrame *prev_frame);
+
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+bool
+fast_jit_call_interp(WASMExecEnv *exec_env, uint32 func_idx,
+                     struct WASMInterpFrame *prev_frame);
+#endif
 #endif
 
 #if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0
@@ -790,6 +882,10 @@ bool
 llvm_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx, uint32 argc,
                        uint32 *argv);
 
+WASMSharedHeapRange *
+llvm_jit_update_last_used_shared_heap(WASMModuleInstance *module_inst,
+                                      uint64 app_offset, uint64 bytes);
+
 #if WASM_ENABLE_BULK_MEMORY != 0
 bool
 llvm_jit_memory_init(WASMModuleInstance *module_inst, uint32 seg_index,
@@ -0,0 +1,663 @@
+/*
+ * Copyright (C) 2024 Xiaomi Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "shared_heap_channel.h"
+#include "bh_atomic.h"
+#include "bh_log.h"
+#include "../common/wasm_memory.h"
+#include "../common/wasm_native.h"
+
+#if WASM_ENABLE_MODULE_INST_CONTEXT == 0
+#error "Shared heap channels require WASM_ENABLE_MODULE_INST_CONTEXT"
+#endif
+
+/* Max number of messages of a channel */
+#define CHANNEL_CAPACITY_MAX (1 << 20)
+
+/* Max microseconds a module instance waits before checking whether it
+   got an exception, e.g. was terminated */
+#define CHANNEL_WAIT_SLICE_US 100000
+
+typedef struct ChannelSlot {
+    /*
+     * Sequence number of the slot, as in Dmitry Vyukov's bounded MPMC
+     * queue: pos when the slot is free to send at pos, pos + 1 when it
+     * holds the message sent at pos
+     */
+    bh_atomic_32_t seq;
+    uint8 *buf;
+    uint64 size;
+} ChannelSlot;
+
+typedef struct WASMChannel {
+    struct WASMChannel *next;
+    /* The grants to module instances and the calls of the wasm apps in
+       progress, protected by channel_list_lock */
+    uint32 ref_count;
+    bool destroyed;
+    WASMSharedHeap *heap;
+    uint32 mask;
+    bh_atomic_32_t closed;
+    bh_atomic_32_t send_pos;
+    bh_atomic_32_t recv_pos;
+    /* Number of the threads waiting for room or for a message */
+    bh_atomic_32_t waiter_count;
+    /* Protects the wait and, without atomic operations, the slots */
+    korp_mutex lock;
+    korp_cond cond;
+    /* Set at creation, read by the senders without the lock */
+    wasm_channel_notify_callback_t notify;
+    void *notify_user_data;
+    ChannelSlot slots[1];
+} WASMChannel;
+
+/*
+ * The channels granted to a module instance, kept in its context and
+ * protected by channel_list_lock. The wasm app refers to a channel by its
+ * handle, which is its index in the table plus 1, so it can only reach the
+ * channels the host granted to it.
+ */
+typedef struct ChannelHandleTable {
+    WASMChannel **channels;
+    uint32 capacity;
+} ChannelHandleTable;
+
+static WASMChannel *channel_list = NULL;
+static korp_mutex channel_list_lock;
+static void *channel_handle_table_key = NULL;
+
+#if BH_ATOMIC_32_IS_ATOMIC != 0
+#define LOCK_SLOTS(channel) (void)0
+#define UNLOCK_SLOTS(channel) (void)0
+#else
+#define LOCK_SLOTS(channel) os_mutex_lock(&(channel)->lock)
+#define UNLOCK_SLOTS(channel) os_mutex_unlock(&(channel)->lock)
+#endif
+
+static void
+channel_handle_table_dtor(wasm_module_inst_t module_inst, void *ctx);
+
+bool
+lib_shared_heap_init(void)
+{
+    if (os_mutex_init(&channel_list_lock) != 0) {
+        return false;
+    }
+
+    if (!(channel_handle_table_key =
+              wasm_native_create_context_key(channel_handle_table_dtor))) {
+        os_mutex_destroy(&channel_list_lock);
+        return false;
+    }
+    return true;
+}
+
+static void
+channel_free(WASMChannel *channel)
+{
+    uint32 pos = BH_ATOMIC_32_LOAD(channel->recv_pos);
+    ChannelSlot *slot;
+
+    /* Free the messages nobody received */
+    for (;; pos++) {
+        slot = &channel->slots[pos & channel->mask];
+        if (BH_ATOMIC_32_LOAD(slot->seq) != pos + 1)
+            break;
+        wasm_runtime_shared_heap_free_native(channel->heap, slot->buf);
+    }
+
+    os_cond_destroy(&channel->cond);
+    os_mutex_destroy(&channel->lock);
+    wasm_runtime_free(channel);
+}
+
+void
+lib_shared_heap_destroy(void)
+{
+    WASMChannel *channel = channel_list, *next;
+
+    while (channel) {
+        next = channel->next;
+        channel_free(channel);
+        channel = next;
+    }
+    channel_list = NULL;
+    if (channel_handle_table_key) {
+        wasm_native_destroy_context_key(channel_handle_table_key);
+        channel_handle_table_key = NULL;
+    }
+    os_mutex_destroy(&channel_list_lock);
+}
+
+wasm_channel_t
+wasm_runtime_create_channel(ChannelInitArgs *init_args)
+{
+    WASMChannel *channel;
+    uint32 capacity = 1, i;
+    uint64 total_size;
+
+    if (!init_args || !init_args->shared_heap || init_args->capacity == 0
+        || init_args->capacity > CHANNEL_CAPACITY_MAX) {
+        LOG_WARNING("Invalid channel init args");
+        return NULL;
+    }
+
+    while (capacity < init_args->capacity) {
+        capacity <<= 1;
+    }
+
+    total_size = offsetof(WASMChannel, slots) + sizeof(ChannelSlot) * capacity;
+    if (!(channel = wasm_runtime_malloc((uint32)total_size))) {
+        LOG_WARNING("Allocate memory failed");
+        return NULL;
+    }
+    memset(channel, 0, (uint32)total_size);
+
+    if (os_mutex_init(&channel->lock) != 0) {
+        wasm_runtime_free(channel);
+        return NULL;
+    }
+    if (os_cond_init(&channel->cond) != 0) {
+        os_mutex_destroy(&channel->lock);
+        wasm_runtime_free(channel);
+        return NULL;
+    }
+
+    channel->heap = init_args->shared_heap;
+    channel->notify = init_args->notify;
+    channel->notify_user_data = init_args->notify_user_data;
+    channel->mask = capacity - 1;
+    for (i = 0; i < capacity; i++) {
+        channel->slots[i].seq = i;
+    }
+
+    os_mutex_lock(&channel_list_lock);
+    channel->next = channel_list;
+    channel_list = channel;
+    os_mutex_unlock(&channel_list_lock);
+
+    return channel;
+}
+
+static void
+channel_wake_up(WASMChannel *channel)
+{
+    if (BH_ATOMIC_32_LOAD(channel->waiter_count) > 0) {
+        os_mutex_lock(&channel->lock);
+        os_cond_broadcast(&channel->cond);
+        os_mutex_unlock(&channel->lock);
+    }
+}
+
+void
+wasm_runtime_close_channel(wasm_channel_t channel)
+{
+    BH_ATOMIC_32_STORE(channel->closed, 1);
+    /* Wake up all the waiters whether they were counted or not yet */
+    os_mutex_lock(&channel->lock);
+    os_cond_broadcast(&channel->cond);
+    os_mutex_unlock(&channel->lock);
+}
+
+void
+wasm_runtime_destroy_channel(wasm_channel_t channel)
+{
+    WASMChannel **p_channel;
+    bool to_free;
+
+    wasm_runtime_close_channel(channel);
+
+    os_mutex_lock(&channel_list_lock);
+    for (p_channel = &channel_list; *p_channel;
+         p_channel = &(*p_channel)->next) {
+        if (*p_channel == channel) {
+            *p_channel = channel->next;
+            break;
+        }
+    }
+    channel->destroyed = true;
+    to_free = channel->ref_count == 0;
+    os_mutex_unlock(&channel_list_lock);
+
+    if (to_free) {
+        channel_free(channel);
+    }
+}
+
+/* Drop a reference to a channel, called with channel_list_lock, return
+   whether the channel is to be freed */
+static bool
+channel_unref(WASMChannel *channel)
+{
+    return --channel->ref_count == 0 && channel->destroyed;
+}
+
+static void
+channel_handle_table_dtor(wasm_module_inst_t module_inst, void *ctx)
+{
+    ChannelHandleTable *table = ctx;
+    WASMChannel *channel;
+    uint32 i;
+
+    (void)module_inst;
+
+    if (!table) {
+        return;
+    }
+
+    for (i = 0; i < table->capacity; i++) {
+        if (!(channel = table->channels[i]))
+            continue;
+        os_mutex_lock(&channel_list_lock);
+        if (!channel_unref(channel))
+            channel = NULL;
+        os_mutex_unlock(&channel_list_lock);
+        if (channel)
+            channel_free(channel);
+    }
+
+    if (table->channels) {
+        wasm_runtime_free(table->channels);
+    }
+    wasm_runtime_free(table);
+}
+
+uint32
+wasm_runtime_channel_grant(wasm_module_inst_t module_inst,
+                           wasm_channel_t channel)
+{
+    ChannelHandleTable *table;
+    WASMChannel **channels;
+    uint32 capacity, handle = 0, i;
+
+    os_mutex_lock(&channel_list_lock);
+
+    if (channel->destroyed) {
+        goto unlock;
+    }
+
+    table = wasm_native_get_context((WASMModuleInstanceCommon *)module_inst,
+                                    channel_handle_table_key);
+    if (!table) {
+        if (!(table = wasm_runtime_malloc(sizeof(ChannelHandleTable)))) {
+            goto unlock;
+        }
+        memset(table, 0, sizeof(ChannelHandleTable));
+        wasm_native_set_context_spread((WASMModuleInstanceCommon *)module_inst,
+                                       channel_handle_table_key, table);
+    }
+
+    /* Reuse the handle of a channel already granted, or a free one */
+    for (i = 0; i < table->capacity; i++) {
+        if (table->channels[i] == channel) {
+            handle = i + 1;
+            goto unlock;
+        }
+    }
+    for (i = 0; i < table->capacity; i++) {
+        if (!table->channels[i])
+            break;
+    }
+
+    if (i == table->capacity) {
+        capacity = table->capacity ? table->capacity * 2 : 4;
+        if (!(channels =
+                  wasm_runtime_malloc(sizeof(WASMChannel *) * capacity))) {
+            LOG_WARNING("Allocate memory failed");
+            goto unlock;
+        }
+        memset(channels, 0, sizeof(WASMChannel *) * capacity);
+        if (table->channels) {
+            bh_memcpy_s(channels, sizeof(WASMChannel *) * capacity,
+                        table->channels,
+                        sizeof(WASMChannel *) * table->capacity);
+            wasm_runtime_free(table->channels);
+        }
+        table->channels = channels;
+        table->capacity = capacity;
+    }
+
+    table->channels[i] = channel;
+    channel->ref_count++;
+    handle = i + 1;
+
+unlock:
+    os_mutex_unlock(&channel_list_lock);
+    return handle;
+}
+
+void
+wasm_runtime_channel_revoke(wasm_module_inst_t module_inst, uint32 handle)
+{
+    ChannelHandleTable *table;
+    WASMChannel *channel = NULL;
+
+    os_mutex_lock(&channel_list_lock);
+    table = wasm_native_get_context((WASMModuleInstanceCommon *)module_inst,
+                                    channel_handle_table_key);
+    if (table && handle > 0 && handle <= table->capacity
+        && (channel = table->channels[handle - 1])) {
+        table->channels[handle - 1] = NULL;
+        if (!channel_unref(channel))
+            channel = NULL;
+    }
+    os_mutex_unlock(&channel_list_lock);
+
+    if (channel) {
+        channel_free(channel);
+    }
+}
+
+wasm_channel_t
+shared_heap_channel_acquire(wasm_module_inst_t module_inst, uint32 handle)
+{
+    ChannelHandleTable *table;
+    WASMChannel *channel = NULL;
+
+    os_mutex_lock(&channel_list_lock);
+    table = wasm_native_get_context((WASMModuleInstanceCommon *)module_inst,
+                                    channel_handle_table_key);
+    if (table && handle > 0 && handle <= table->capacity
+        && (channel = table->channels[handle - 1])) {
+        if (channel->destroyed)
+            channel = NULL;
+        else
+            channel->ref_count++;
+    }
+    os_mutex_unlock(&channel_list_lock);
+
+    return channel;
+}
+
+void
+shared_heap_channel_release(wasm_channel_t channel)
+{
+    bool to_free;
+
+    os_mutex_lock(&channel_list_lock);
+    to_free = channel_unref(channel);
+    os_mutex_unlock(&channel_list_lock);
+
+    if (to_free) {
+        channel_free(channel);
+    }
+}
+
+static wasm_channel_status_t
+channel_try_send(WASMChannel *channel, uint8 *buf, uint64 size)
+{
+    ChannelSlot *slot;
+    uint32 pos, seq;
+
+    if (BH_ATOMIC_32_LOAD(channel->closed)) {
+        return WASM_CHANNEL_CLOSED;
+    }
+
+    LOCK_SLOTS(channel);
+    pos = BH_ATOMIC_32_LOAD(channel->send_pos);
+    for (;;) {
+        slot = &channel->slots[pos & channel->mask];
+        seq = BH_ATOMIC_32_LOAD(slot->seq);
+        if (seq == pos) {
+            /* The slot is free, claim it, the module instances and the host
+               may all send from several threads */
+            if (BH_ATOMIC_32_COMPARE_EXCHANGE(channel->send_pos, pos, pos + 1))
+                break;
+            /* pos was reloaded by the failed exchange */
+        }
+        else if ((int32)(seq - pos) < 0) {
+            /* The slot still holds the message sent a round earlier */
+            UNLOCK_SLOTS(channel);
+            return WASM_CHANNEL_FULL;
+        }
+        else {
+            /* Another sender claimed the slot */
+            pos = BH_ATOMIC_32_LOAD(channel->send_pos);
+        }
+    }
+
+    slot->buf = buf;
+    slot->size = size;
+    /* Publish the message */
+    BH_ATOMIC_32_STORE(slot->seq, pos + 1);
+    UNLOCK_SLOTS(channel);
+    return WASM_CHANNEL_OK;
+}
+
+static wasm_channel_status_t
+channel_try_recv(WASMChannel *channel, uint8 **p_buf, uint64 *p_size)
+{
+    ChannelSlot *slot;
+    uint32 pos, seq;
+
+    LOCK_SLOTS(channel);
+    pos = BH_ATOMIC_32_LOAD(channel->recv_pos);
+    for (;;) {
+        slot = &channel->slots[pos & channel->mask];
+        seq = BH_ATOMIC_32_LOAD(slot->seq);
+        if (seq == pos + 1) {
+            /* The slot holds a message, claim it */
+            if (BH_ATOMIC_32_COMPARE_EXCHANGE(channel->recv_pos, pos, pos + 1))
+                break;
+            /* pos was reloaded by the failed exchange */
+        }
+        else if ((int32)(seq - (pos + 1)) < 0) {
+            /* Nothing was sent at pos yet */
+            UNLOCK_SLOTS(channel);
+            return BH_ATOMIC_32_LOAD(channel->closed) ? WASM_CHANNEL_CLOSED
+                                                     : WASM_CHANNEL_EMPTY;
+        }
+        else {
+            /* Another receiver claimed the slot */
+            pos = BH_ATOMIC_32_LOAD(channel->recv_pos);
+        }
+    }
+
+    *p_buf = slot->buf;
+    *p_size = slot->size;
+    /* Free the slot for the message sent a round later */
+    BH_ATOMIC_32_STORE(slot->seq, pos + channel->mask + 1);
+    UNLOCK_SLOTS(channel);
+    return WASM_CHANNEL_OK;
+}
+
+/* Whether a send or a receive may succeed now, called with the lock */
+static bool
+channel_is_ready(WASMChannel *channel, bool for_send)
+{
+    uint32 pos;
+
+    if (BH_ATOMIC_32_LOAD(channel->closed)) {
+        return true;
+    }
+    if (for_send) {
+        pos = BH_ATOMIC_32_LOAD(channel->send_pos);
+        return BH_ATOMIC_32_LOAD(channel->slots[pos & channel->mask].seq)
+               == pos;
+    }
+    pos = BH_ATOMIC_32_LOAD(channel->recv_pos);
+    return BH_ATOMIC_32_LOAD(channel->slots[pos & channel->mask].seq)
+           == pos + 1;
+}
+
+/*
+ * Wait until the channel may be ready for a send or a receive, return
+ * WASM_CHANNEL_OK to retry it
+ */
+static wasm_channel_status_t
+channel_wait(WASMChannel *channel, wasm_module_inst_t module_inst,
+             bool for_send, int64 timeout_us, uint64 deadline)
+{
+    wasm_channel_status_t status = WASM_CHANNEL_OK;
+    uint64 now, wait_us;
+
+    os_mutex_lock(&channel->lock);
+    /* The senders check waiter_count after publishing a message, and the
+       receivers after freeing a slot, so either they see the waiter or
+       the waiter sees the channel ready below */
+    BH_ATOMIC_32_FETCH_ADD(channel->waiter_count, 1);
+
+    while (!channel_is_ready(channel, for_send)) {
+        if (module_inst && wasm_runtime_get_exception(module_inst)) {
+            status = WASM_CHANNEL_INTERRUPTED;
+            break;
+        }
+
+        if (timeout_us < 0) {
+            if (!module_inst) {
+                os_cond_wait(&channel->cond, &channel->lock);
+                continue;
+            }
+            wait_us = CHANNEL_WAIT_SLICE_US;
+        }
+        else {
+            now = os_time_get_boot_us();
+            if (now >= deadline) {
+                status = WASM_CHANNEL_TIMEOUT;
+                break;
+            }
+            wait_us = deadline - now;
+            if (module_inst && wait_us > CHANNEL_WAIT_SLICE_US)
+                wait_us = CHANNEL_WAIT_SLICE_US;
+        }
+        os_cond_reltimedwait(&channel->cond, &channel->lock, wait_us);
+    }
+
+    BH_ATOMIC_32_FETCH_SUB(channel->waiter_count, 1);
+    os_mutex_unlock(&channel->lock);
+    return status;
+}
+
+wasm_channel_status_t
+shared_heap_channel_send(wasm_channel_t channel,
+                         wasm_module_inst_t module_inst, uint8 *buf,
+                         uint64 size, int64 timeout_us)
+{
+    WASMSharedHeap *heap = channel->heap;
+    uint64 deadline = 0;
+    wasm_channel_status_t status;
+
+    /* Only the blocks allocated from the shared heap of the channel can
+       be sent, as their ownership is transferred */
+    if (!wasm_runtime_shared_heap_contains(heap, buf, size)
+        || !wasm_runtime_shared_heap_is_allocated(heap, buf)) {
+        return WASM_CHANNEL_INVALID;
+    }
+
+    if (timeout_us > 0) {
+        deadline = os_time_get_boot_us() + (uint64)timeout_us;
+    }
+
+    while ((status = channel_try_send(channel, buf, size))
+           == WASM_CHANNEL_FULL) {
+        if (timeout_us == 0
+            || (status = channel_wait(channel, module_inst, true, timeout_us,
+                                      deadline))
+                   != WASM_CHANNEL_OK) {
+            return status;
+        }
+    }
+
+    if (status == WASM_CHANNEL_OK) {
+        /* Only takes the lock if a receiver waits */
+        channel_wake_up(channel);
+        if (channel->notify) {
+            channel->notify(channel, channel->notify_user_data);
+        }
+    }
+    return status;
+}
+
+static bool
+is_shared_heap_attached(wasm_module_inst_t module_inst, WASMSharedHeap *heap)
+{
+    WASMSharedHeap *shared_heap;
+
+    for (shared_heap = wasm_runtime_get_shared_heap(module_inst); shared_heap;
+         shared_heap = shared_heap->chain_next) {
+        if (shared_heap == heap)
+            return true;
+    }
+    return false;
+}
+
+wasm_channel_status_t
+shared_heap_channel_recv(wasm_channel_t channel,
+                         wasm_module_inst_t module_inst, uint8 **p_buf,
+                         uint64 *p_size, int64 timeout_us)
+{
+    uint64 deadline = 0;
+    wasm_channel_status_t status;
+
+    /* Check it before taking the message, which the module instance
+       couldn't access otherwise */
+    if (module_inst && !is_shared_heap_attached(module_inst, channel->heap)) {
+        return WASM_CHANNEL_INVALID;
+    }
+
+    if (timeout_us > 0) {
+        deadline = os_time_get_boot_us() + (uint64)timeout_us;
+    }
+
+    while ((status = channel_try_recv(channel, p_buf, p_size))
+           == WASM_CHANNEL_EMPTY) {
+        if (timeout_us == 0
+            || (status = channel_wait(channel, module_inst, false, timeout_us,
+                                      deadline))
+                   != WASM_CHANNEL_OK) {
+            return status;
+        }
+    }
+
+    if (status == WASM_CHANNEL_OK) {
+        channel_wake_up(channel);
+    }
+    return status;
+}
+
+wasm_channel_status_t
+wasm_runtime_channel_send_native(wasm_channel_t channel, void *buf,
+                                 uint64_t size, int64_t timeout_us)
+{
+    return shared_heap_channel_send(channel, NULL, buf, size, timeout_us);
+}
+
+wasm_channel_status_t
+wasm_runtime_channel_recv_native(wasm_channel_t channel, void **p_buf,
+                                 uint64_t *p_size, int64_t timeout_us)
+{
+    return shared_heap_channel_recv(channel, NULL, (uint8 **)p_buf, p_size,
+                                    timeout_us);
+}
+
+wasm_channel_status_t
+wasm_runtime_channel_send(wasm_module_inst_t module_inst,
+                          wasm_channel_t channel, uint64_t buf, uint64_t size,
+                          int64_t timeout_us)
+{
+    uint8 *native_addr = wasm_runtime_addr_app_to_native(module_inst, buf);
+
+    if (!native_addr) {
+        return WASM_CHANNEL_INVALID;
+    }
+    return shared_heap_channel_send(channel, module_inst, native_addr, size,
+                                    timeout_us);
+}
+
+wasm_channel_status_t
+wasm_runtime_channel_recv(wasm_module_inst_t module_inst,
+                          wasm_channel_t channel, uint64_t *p_buf,
+                          uint64_t *p_size, int64_t timeout_us)
+{
+    wasm_channel_status_t status;
+    uint8 *native_addr;
+
+    status = shared_heap_channel_recv(channel, module_inst, &native_addr,
+                                      p_size, timeout_us);
+    if (status == WASM_CHANNEL_OK) {
+        *p_buf = wasm_runtime_addr_native_to_app(module_inst, native_addr);
+    }
+    return status;
+}
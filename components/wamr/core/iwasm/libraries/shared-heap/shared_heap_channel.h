@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024 Xiaomi Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _SHARED_HEAP_CHANNEL_H
+#define _SHARED_HEAP_CHANNEL_H
+
+#include "bh_platform.h"
+#include "wasm_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool
+lib_shared_heap_init(void);
+
+void
+lib_shared_heap_destroy(void);
+
+/* Get the channel granted to a module instance with a handle and keep it
+   alive until it is released, NULL if the handle wasn't granted */
+wasm_channel_t
+shared_heap_channel_acquire(wasm_module_inst_t module_inst, uint32 handle);
+
+void
+shared_heap_channel_release(wasm_channel_t channel);
+
+/*
+ * Send a message by its native address. If module_inst isn't NULL, the
+ * wait is interrupted when the module instance gets an exception.
+ */
+wasm_channel_status_t
+shared_heap_channel_send(wasm_channel_t channel,
+                         wasm_module_inst_t module_inst, uint8 *buf,
+                         uint64 size, int64 timeout_us);
+
+/*
+ * Receive a message by its native address. If module_inst isn't NULL,
+ * the shared heap of the channel must be attached to it, and the wait is
+ * interrupted when the module instance gets an exception.
+ */
+wasm_channel_status_t
+shared_heap_channel_recv(wasm_channel_t channel,
+                         wasm_module_inst_t module_inst, uint8 **p_buf,
+                         uint64 *p_size, int64 timeout_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _SHARED_HEAP_CHANNEL_H */
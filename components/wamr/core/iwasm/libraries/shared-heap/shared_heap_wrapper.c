@@ -8,6 +8,7 @@
 #include "wasm_export.h"
 #include "../interpreter/wasm.h"
 #include "../common/wasm_runtime_common.h"
+#include "shared_heap_channel.h"
 /* clang-format off */
 #define validate_native_addr(addr, size) \
     wasm_runtime_validate_native_addr(module_inst, addr, size)
@@ -39,6 +40,53 @@ shared_heap_free_wrapper(wasm_exec_env_t exec_env, void *ptr)
     module_shared_free(addr_native_to_app(ptr));
 }
 
+static int32
+shared_heap_channel_send_wrapper(wasm_exec_env_t exec_env, uint32 handle,
+                                 void *buf, uint32 size, int64 timeout_us)
+{
+    wasm_module_inst_t module_inst = get_module_inst(exec_env);
+    wasm_channel_t channel;
+    wasm_channel_status_t status;
+
+    /* buf was validated against the attached shared heaps */
+    if (!(channel = shared_heap_channel_acquire(module_inst, handle)))
+        return WASM_CHANNEL_INVALID;
+
+    status = shared_heap_channel_send(channel, module_inst, buf, size,
+                                      timeout_us);
+    shared_heap_channel_release(channel);
+    return status;
+}
+
+static int32
+shared_heap_channel_recv_wrapper(wasm_exec_env_t exec_env, uint32 handle,
+                                 uint32 *p_buf, uint32 *p_size,
+                                 int64 timeout_us)
+{
+    wasm_module_inst_t module_inst = get_module_inst(exec_env);
+    wasm_channel_t channel;
+    wasm_channel_status_t status;
+    uint8 *buf;
+    uint64 size;
+
+    if (!validate_native_addr(p_buf, (uint64)sizeof(uint32))
+        || !validate_native_addr(p_size, (uint64)sizeof(uint32)))
+        return WASM_CHANNEL_INVALID;
+
+    if (!(channel = shared_heap_channel_acquire(module_inst, handle)))
+        return WASM_CHANNEL_INVALID;
+
+    status = shared_heap_channel_recv(channel, module_inst, &buf, &size,
+                                      timeout_us);
+    shared_heap_channel_release(channel);
+
+    if (status == WASM_CHANNEL_OK) {
+        *p_buf = (uint32)addr_native_to_app(buf);
+        *p_size = (uint32)size;
+    }
+    return status;
+}
+
 /* clang-format off */
 #define REG_NATIVE_FUNC(func_name, signature) \
     { #func_name, func_name##_wrapper, signature, NULL }
@@ -47,6 +95,8 @@ shared_heap_free_wrapper(wasm_exec_env_t exec_env, void *ptr)
 static NativeSymbol native_symbols_shared_heap[] = {
     REG_NATIVE_FUNC(shared_heap_malloc, "(i)i"),
     REG_NATIVE_FUNC(shared_heap_free, "(*)"),
+    REG_NATIVE_FUNC(shared_heap_channel_send, "(i*~I)i"),
+    REG_NATIVE_FUNC(shared_heap_channel_recv, "(i**I)i"),
 };
 
 uint32
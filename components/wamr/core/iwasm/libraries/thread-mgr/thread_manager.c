@@ -17,6 +17,10 @@
 #include "debug_engine.h"
 #endif
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+#include "../common/wasm_runtime_metrics.h"
+#endif
+
 typedef struct {
     bh_list_link l;
     void (*destroy_cb)(WASMCluster *);
@@ -693,6 +697,10 @@ thread_manager_start_routine(void *arg)
 
     os_mutex_unlock(&cluster_list_lock);
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_thread_exit();
+#endif
+
     os_thread_exit(ret);
     return ret;
 }
@@ -1089,6 +1097,10 @@ wasm_cluster_exit_thread(WASMExecEnv *exec_env, void *retval)
 
     os_mutex_unlock(&cluster_list_lock);
 
+#if WASM_ENABLE_RUNTIME_METRICS != 0
+    wasm_runtime_metrics_thread_exit();
+#endif
+
     os_thread_exit(retval);
 }
 
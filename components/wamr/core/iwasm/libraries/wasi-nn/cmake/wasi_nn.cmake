@@ -19,6 +19,11 @@ add_compile_definitions(
 #
 # wasi-nn backends
 #
+# - cpu, built into the runtime
+if(WAMR_BUILD_WASI_NN_CPU EQUAL 1)
+  list(APPEND WASI_NN_SOURCES ${WASI_NN_ROOT}/src/wasi_nn_cpu.c)
+endif()
+
 # - tflite
 if(WAMR_BUILD_WASI_NN_TFLITE EQUAL 1)
   find_package(tensorflow_lite REQUIRED)
@@ -87,4 +87,49 @@ get_output(graph_execution_context ctx, uint32_t index,
            tensor_data output_tensor, uint32_t *output_tensor_size)
     __attribute__((import_module("wasi_nn")));
 
+/**
+ * WAMR EXTENSION: PERSISTENT BINDINGS
+ *
+ */
+
+/**
+ * @brief Bind an input of an execution context to a fixed region of the
+ * linear memory. Every following compute() reads the input from there, so
+ * set_input() is no longer needed. Backends that support it read the
+ * region in place.
+ *
+ * @param ctx       Execution context.
+ * @param index     Input tensor index.
+ * @param tensor    Input tensor, its data must stay where it is.
+ * @return wasi_nn_error    Execution status.
+ */
+wasi_nn_error
+bind_input(graph_execution_context ctx, uint32_t index, tensor *tensor)
+    __attribute__((import_module("wasi_nn")));
+
+/**
+ * @brief Bind an output of an execution context to a fixed region of the
+ * linear memory. Every following compute() leaves the output there, as
+ * get_output() would.
+ *
+ * @param ctx                   Execution context.
+ * @param index                 Output tensor index.
+ * @param output_tensor         Buffer receiving the output tensor.
+ * @param output_tensor_size    Size of `output_tensor` in bytes.
+ * @return wasi_nn_error                Execution status.
+ */
+wasi_nn_error
+bind_output(graph_execution_context ctx, uint32_t index,
+            tensor_data output_tensor, uint32_t output_tensor_size)
+    __attribute__((import_module("wasi_nn")));
+
+/**
+ * @brief Drop all the input and output bindings of an execution context.
+ *
+ * @param ctx       Execution context.
+ * @return wasi_nn_error    Execution status.
+ */
+wasi_nn_error
+unbind(graph_execution_context ctx) __attribute__((import_module("wasi_nn")));
+
 #endif
@@ -131,6 +131,8 @@ typedef enum {
     tensorflowlite,
     ggml,
     autodetect,
+    // WAMR extension: the built-in CPU backend, see wasi_nn_cpu.c
+    wamr_cpu,
     unknown_backend,
 } graph_encoding;
 
@@ -155,6 +157,12 @@ typedef wasi_nn_error (*SET_INPUT)(void *, graph_execution_context, uint32_t,
 typedef wasi_nn_error (*COMPUTE)(void *, graph_execution_context);
 typedef wasi_nn_error (*GET_OUTPUT)(void *, graph_execution_context, uint32_t,
                                     tensor_data, uint32_t *);
+/* Optional, a NULL data unbinds. The tensor data stays owned by the caller
+   and must remain valid until it is rebound or unbound */
+typedef wasi_nn_error (*BIND_INPUT)(void *, graph_execution_context, uint32_t,
+                                    tensor *);
+typedef wasi_nn_error (*BIND_OUTPUT)(void *, graph_execution_context,
+                                     uint32_t, tensor_data, uint32_t);
 /* wasi-nn general APIs */
 typedef wasi_nn_error (*BACKEND_INITIALIZE)(void **);
 typedef wasi_nn_error (*BACKEND_DEINITIALIZE)(void *);
@@ -167,6 +175,8 @@ typedef struct {
     SET_INPUT set_input;
     COMPUTE compute;
     GET_OUTPUT get_output;
+    BIND_INPUT bind_input;
+    BIND_OUTPUT bind_output;
     BACKEND_INITIALIZE init;
     BACKEND_DEINITIALIZE deinit;
 } api_function;
@@ -13,6 +13,9 @@
 #include <dlfcn.h>
 
 #include "wasi_nn_private.h"
+#if WASM_ENABLE_WASI_NN_CPU != 0
+#include "wasi_nn_cpu.h"
+#endif
 #include "utils/wasi_nn_app_native.h"
 #include "utils/logger.h"
 
@@ -29,7 +32,7 @@
 struct backends_api_functions {
     void *backend_handle;
     api_function functions;
-} lookup[autodetect + 1] = { 0 };
+} lookup[unknown_backend] = { 0 };
 
 #define call_wasi_nn_func(backend_encoding, func, wasi_error, ...)         \
     do {                                                                   \
@@ -227,8 +230,13 @@ choose_a_backend()
     NN_WARN_PRINTF("%s", dlerror());
 #endif
 
+#if WASM_ENABLE_WASI_NN_CPU != 0
+    NN_INFO_PRINTF("Using built-in cpu backend");
+    return wamr_cpu;
+#else
     NN_WARN_PRINTF("No backend found");
     return unknown_backend;
+#endif
 }
 
 static bool
@@ -300,9 +308,33 @@ register_backend(void *handle, api_function *functions)
     }
     functions->get_output = get_output;
 
+    /* Optional, without them bindings fall back to set_input/get_output */
+    functions->bind_input = (BIND_INPUT)dlsym(handle, "bind_input");
+    functions->bind_output = (BIND_OUTPUT)dlsym(handle, "bind_output");
+
     return true;
 }
 
+#if WASM_ENABLE_WASI_NN_CPU != 0
+/* The built-in backend is linked in, nothing to dlopen() */
+static bool
+register_builtin_backend(api_function *functions)
+{
+    functions->init = wasi_nn_cpu_init_backend;
+    functions->deinit = wasi_nn_cpu_deinit_backend;
+    functions->load = wasi_nn_cpu_load;
+    functions->load_by_name = wasi_nn_cpu_load_by_name;
+    functions->load_by_name_with_config = NULL;
+    functions->init_execution_context = wasi_nn_cpu_init_execution_context;
+    functions->set_input = wasi_nn_cpu_set_input;
+    functions->compute = wasi_nn_cpu_compute;
+    functions->get_output = wasi_nn_cpu_get_output;
+    functions->bind_input = wasi_nn_cpu_bind_input;
+    functions->bind_output = wasi_nn_cpu_bind_output;
+    return true;
+}
+#endif
+
 static bool
 prepare_backend(const char *lib_name, struct backends_api_functions *backend)
 {
@@ -345,7 +377,7 @@ detect_and_load_backend(graph_encoding backend_hint,
                         struct backends_api_functions *backends,
                         graph_encoding *loaded_backend)
 {
-    if (backend_hint > autodetect)
+    if (backend_hint >= unknown_backend)
         return false;
 
     if (backend_hint == autodetect)
@@ -360,6 +392,11 @@ detect_and_load_backend(graph_encoding backend_hint,
     if (lookup[backend_hint].backend_handle)
         return true;
 
+#if WASM_ENABLE_WASI_NN_CPU != 0
+    if (backend_hint == wamr_cpu)
+        return register_builtin_backend(&backends[wamr_cpu].functions);
+#endif
+
     const char *backend_lib_name =
         graph_encoding_to_backend_lib_name(backend_hint);
     if (!backend_lib_name)
@@ -368,6 +405,142 @@ detect_and_load_backend(graph_encoding backend_hint,
     return prepare_backend(backend_lib_name, backends + backend_hint);
 }
 
+/* Bindings utils */
+
+static uint32_t
+tensor_type_size(tensor_type type)
+{
+    switch (type) {
+#if WASM_ENABLE_WASI_EPHEMERAL_NN != 0
+        case fp64:
+        case i64:
+            return 8;
+        case fp16:
+        case bf16:
+            return 2;
+        case u8:
+            return 1;
+#else
+        case fp16:
+            return 2;
+        case up8:
+            return 1;
+#endif
+        default:
+            return 4;
+    }
+}
+
+static WASINNBinding *
+find_binding(WASINNContext *wasi_nn_ctx, graph_execution_context ctx,
+             uint32_t index, bool is_output)
+{
+    for (uint32_t i = 0; i < wasi_nn_ctx->binding_count; i++) {
+        WASINNBinding *binding = wasi_nn_ctx->bindings + i;
+        if (binding->ctx == ctx && binding->index == index
+            && binding->is_output == is_output)
+            return binding;
+    }
+    return NULL;
+}
+
+/* Hand the current location of a binding to the backend, if it can use it */
+static wasi_nn_error
+backend_bind(WASINNContext *wasi_nn_ctx, WASINNBinding *binding,
+             tensor_data data)
+{
+    api_function *functions = &lookup[wasi_nn_ctx->backend].functions;
+    wasi_nn_error res = success;
+
+    if (binding->is_output && functions->bind_output) {
+        call_wasi_nn_func(wasi_nn_ctx->backend, bind_output, res,
+                          wasi_nn_ctx->backend_ctx, binding->ctx,
+                          binding->index, data, binding->data_size);
+    }
+    else if (!binding->is_output && functions->bind_input) {
+        tensor input_tensor = binding->tensor;
+        input_tensor.data = data;
+        call_wasi_nn_func(wasi_nn_ctx->backend, bind_input, res,
+                          wasi_nn_ctx->backend_ctx, binding->ctx,
+                          binding->index, &input_tensor);
+    }
+    return res;
+}
+
+static void
+remove_binding(WASINNContext *wasi_nn_ctx, WASINNBinding *binding)
+{
+    WASINNBinding *last = wasi_nn_ctx->bindings + --wasi_nn_ctx->binding_count;
+
+    backend_bind(wasi_nn_ctx, binding, NULL);
+    if (binding != last) {
+        *binding = *last;
+        /* The copy still points into the last slot */
+        binding->dimensions.buf = binding->dims;
+        binding->tensor.dimensions = &binding->dimensions;
+    }
+}
+
+/*
+ * The only check made per compute(): memory.grow may have moved the linear
+ * memory, in which case the bindings are resolved again from their offsets.
+ * Memory never shrinks, so the regions themselves are still valid.
+ */
+static wasi_nn_error
+refresh_bindings(wasm_module_inst_t instance, WASINNContext *wasi_nn_ctx)
+{
+    wasm_memory_inst_t memory = wasm_runtime_get_default_memory(instance);
+    void *base = memory ? wasm_memory_get_base_address(memory) : NULL;
+    wasi_nn_error res;
+
+    if (base == wasi_nn_ctx->binding_memory_base)
+        return success;
+
+    for (uint32_t i = 0; i < wasi_nn_ctx->binding_count; i++) {
+        WASINNBinding *binding = wasi_nn_ctx->bindings + i;
+
+        binding->tensor.data = (tensor_data)wasm_runtime_addr_app_to_native(
+            instance, binding->data_offset);
+        if (success
+            != (res = backend_bind(wasi_nn_ctx, binding, binding->tensor.data)))
+            return res;
+    }
+
+    wasi_nn_ctx->binding_memory_base = base;
+    return success;
+}
+
+static WASINNBinding *
+add_binding(wasm_module_inst_t instance, WASINNContext *wasi_nn_ctx,
+            graph_execution_context ctx, uint32_t index, bool is_output,
+            tensor_data data)
+{
+    WASINNBinding *binding = find_binding(wasi_nn_ctx, ctx, index, is_output);
+
+    /* Resolve the existing bindings first, the new one is resolved against
+       the current memory */
+    if (success != refresh_bindings(instance, wasi_nn_ctx))
+        return NULL;
+
+    if (!binding) {
+        if (wasi_nn_ctx->binding_count == WASI_NN_MAX_BINDINGS) {
+            NN_ERR_PRINTF("Exceeded max bindings per WASM instance");
+            return NULL;
+        }
+        binding = wasi_nn_ctx->bindings + wasi_nn_ctx->binding_count++;
+    }
+
+    memset(binding, 0, sizeof(WASINNBinding));
+    binding->is_output = is_output;
+    binding->ctx = ctx;
+    binding->index = index;
+    binding->data_offset = wasm_runtime_addr_native_to_app(instance, data);
+    binding->dimensions.buf = binding->dims;
+    binding->tensor.dimensions = &binding->dimensions;
+    binding->tensor.data = data;
+    return binding;
+}
+
 /* WASI-NN implementation */
 
 #if WASM_ENABLE_WASI_EPHEMERAL_NN != 0
@@ -604,6 +777,11 @@ wasi_nn_set_input(wasm_exec_env_t exec_env, graph_execution_context ctx,
                                     &input_tensor_native)))
         return res;
 
+    /* An explicit input replaces the bound one */
+    WASINNBinding *binding = find_binding(wasi_nn_ctx, ctx, index, false);
+    if (binding)
+        remove_binding(wasi_nn_ctx, binding);
+
     call_wasi_nn_func(wasi_nn_ctx->backend, set_input, res,
                       wasi_nn_ctx->backend_ctx, ctx, index,
                       &input_tensor_native);
@@ -630,11 +808,168 @@ wasi_nn_compute(wasm_exec_env_t exec_env, graph_execution_context ctx)
     if (success != (res = is_model_initialized(wasi_nn_ctx)))
         return res;
 
+    api_function *functions = &lookup[wasi_nn_ctx->backend].functions;
+    uint32_t i;
+
+    if (wasi_nn_ctx->binding_count > 0) {
+        if (success != (res = refresh_bindings(instance, wasi_nn_ctx)))
+            return res;
+
+        /* Backends without binding support get the inputs copied */
+        for (i = 0; i < wasi_nn_ctx->binding_count && !functions->bind_input;
+             i++) {
+            WASINNBinding *binding = wasi_nn_ctx->bindings + i;
+            if (binding->ctx != ctx || binding->is_output)
+                continue;
+            call_wasi_nn_func(wasi_nn_ctx->backend, set_input, res,
+                              wasi_nn_ctx->backend_ctx, ctx, binding->index,
+                              &binding->tensor);
+            if (res != success)
+                return res;
+        }
+    }
+
     call_wasi_nn_func(wasi_nn_ctx->backend, compute, res,
                       wasi_nn_ctx->backend_ctx, ctx);
+    if (res != success)
+        return res;
+
+    /* And the outputs copied back */
+    for (i = 0; i < wasi_nn_ctx->binding_count && !functions->bind_output;
+         i++) {
+        WASINNBinding *binding = wasi_nn_ctx->bindings + i;
+        uint32_t output_tensor_size = binding->data_size;
+        if (binding->ctx != ctx || !binding->is_output)
+            continue;
+        call_wasi_nn_func(wasi_nn_ctx->backend, get_output, res,
+                          wasi_nn_ctx->backend_ctx, ctx, binding->index,
+                          binding->tensor.data, &output_tensor_size);
+        if (res != success)
+            return res;
+    }
+    return success;
+}
+
+wasi_nn_error
+wasi_nn_bind_input(wasm_exec_env_t exec_env, graph_execution_context ctx,
+                   uint32_t index, tensor_wasm *input_tensor)
+{
+    NN_DBG_PRINTF("[WASI NN] BIND_INPUT [ctx=%d, index=%d]...", ctx, index);
+
+    wasm_module_inst_t instance = wasm_runtime_get_module_inst(exec_env);
+    if (!instance) {
+        return runtime_error;
+    }
+
+    WASINNContext *wasi_nn_ctx = wasm_runtime_get_wasi_nn_ctx(instance);
+
+    wasi_nn_error res;
+    if (success != (res = is_model_initialized(wasi_nn_ctx)))
+        return res;
+
+    /* Validated and translated once, compute() only reuses the result */
+    tensor input_tensor_native = { 0 };
+    if (success
+        != (res = tensor_app_native(instance, input_tensor,
+                                    &input_tensor_native)))
+        return res;
+
+    tensor_dimensions *dimensions = input_tensor_native.dimensions;
+    if (dimensions->size > WASI_NN_MAX_BINDING_RANK) {
+        NN_ERR_PRINTF("Tensor rank %d is too large to bind", dimensions->size);
+        wasm_runtime_free(dimensions);
+        return invalid_argument;
+    }
+
+    /* Backends may read the region in place, so check all of it */
+    uint64 data_size = tensor_type_size(input_tensor_native.type);
+    for (uint32_t i = 0; i < dimensions->size; i++)
+        data_size *= dimensions->buf[i];
+    if (!wasm_runtime_validate_native_addr(instance, input_tensor_native.data,
+                                           data_size)) {
+        NN_ERR_PRINTF("input_tensor data is invalid");
+        wasm_runtime_free(dimensions);
+        return invalid_argument;
+    }
+
+    WASINNBinding *binding = add_binding(instance, wasi_nn_ctx, ctx, index,
+                                         false, input_tensor_native.data);
+    if (!binding) {
+        wasm_runtime_free(dimensions);
+        return too_large;
+    }
+
+    /* The dimensions live in the linear memory, keep a copy */
+    bh_memcpy_s(binding->dims, sizeof(binding->dims), dimensions->buf,
+                sizeof(uint32_t) * dimensions->size);
+    binding->dimensions.size = dimensions->size;
+    binding->tensor.type = input_tensor_native.type;
+    wasm_runtime_free(dimensions);
+
+    res = backend_bind(wasi_nn_ctx, binding, binding->tensor.data);
+    if (res != success)
+        remove_binding(wasi_nn_ctx, binding);
+    return res;
+}
+
+wasi_nn_error
+wasi_nn_bind_output(wasm_exec_env_t exec_env, graph_execution_context ctx,
+                    uint32_t index, tensor_data output_tensor,
+                    uint32_t output_tensor_len)
+{
+    NN_DBG_PRINTF("[WASI NN] BIND_OUTPUT [ctx=%d, index=%d]...", ctx, index);
+
+    wasm_module_inst_t instance = wasm_runtime_get_module_inst(exec_env);
+    if (!instance) {
+        return runtime_error;
+    }
+
+    WASINNContext *wasi_nn_ctx = wasm_runtime_get_wasi_nn_ctx(instance);
+
+    wasi_nn_error res;
+    if (success != (res = is_model_initialized(wasi_nn_ctx)))
+        return res;
+
+    /* The runtime has checked output_tensor against output_tensor_len */
+    WASINNBinding *binding = add_binding(instance, wasi_nn_ctx, ctx, index,
+                                         true, output_tensor);
+    if (!binding)
+        return too_large;
+    binding->data_size = output_tensor_len;
+
+    if (success != (res = backend_bind(wasi_nn_ctx, binding, output_tensor)))
+        remove_binding(wasi_nn_ctx, binding);
     return res;
 }
 
+wasi_nn_error
+wasi_nn_unbind(wasm_exec_env_t exec_env, graph_execution_context ctx)
+{
+    NN_DBG_PRINTF("[WASI NN] UNBIND [ctx=%d]...", ctx);
+
+    wasm_module_inst_t instance = wasm_runtime_get_module_inst(exec_env);
+    if (!instance) {
+        return runtime_error;
+    }
+
+    WASINNContext *wasi_nn_ctx = wasm_runtime_get_wasi_nn_ctx(instance);
+
+    wasi_nn_error res;
+    if (success != (res = is_model_initialized(wasi_nn_ctx)))
+        return res;
+
+    uint32_t i = 0;
+    while (i < wasi_nn_ctx->binding_count) {
+        WASINNBinding *binding = wasi_nn_ctx->bindings + i;
+        if (binding->ctx == ctx)
+            /* The last binding moves into this slot */
+            remove_binding(wasi_nn_ctx, binding);
+        else
+            i++;
+    }
+    return success;
+}
+
 #if WASM_ENABLE_WASI_EPHEMERAL_NN != 0
 wasi_nn_error
 wasi_nn_get_output(wasm_exec_env_t exec_env, graph_execution_context ctx,
@@ -695,12 +1030,18 @@ static NativeSymbol native_symbols_wasi_nn[] = {
     REG_NATIVE_FUNC(set_input, "(ii*)i"),
     REG_NATIVE_FUNC(compute, "(i)i"),
     REG_NATIVE_FUNC(get_output, "(ii*i*)i"),
+    REG_NATIVE_FUNC(bind_input, "(ii*)i"),
+    REG_NATIVE_FUNC(bind_output, "(ii*~)i"),
+    REG_NATIVE_FUNC(unbind, "(i)i"),
 #else  /* WASM_ENABLE_WASI_EPHEMERAL_NN == 0 */
     REG_NATIVE_FUNC(load, "(*ii*)i"),
     REG_NATIVE_FUNC(init_execution_context, "(i*)i"),
     REG_NATIVE_FUNC(set_input, "(ii*)i"),
     REG_NATIVE_FUNC(compute, "(i)i"),
     REG_NATIVE_FUNC(get_output, "(ii**)i"),
+    REG_NATIVE_FUNC(bind_input, "(ii*)i"),
+    REG_NATIVE_FUNC(bind_output, "(ii*~)i"),
+    REG_NATIVE_FUNC(unbind, "(i)i"),
 #endif /* WASM_ENABLE_WASI_EPHEMERAL_NN != 0 */
 };
 
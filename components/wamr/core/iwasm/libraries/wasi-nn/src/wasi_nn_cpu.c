@@ -0,0 +1,1947 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * A small, dependency-free CPU backend for wasi-nn.
+ *
+ * It runs graphs serialized in the "WNNG" format below, which is meant to
+ * be produced offline by a converter script from a trained model. All
+ * tensors are NHWC and every multi-byte field is little-endian:
+ *
+ *   header      u32 magic ("WNNG"), u32 version (1), u32 tensor_count,
+ *               u32 op_count, u32 input_count, u32 output_count
+ *   inputs      u32 tensor index * input_count
+ *   outputs     u32 tensor index * output_count
+ *   tensors     tensor_count records of
+ *                 u32 type (0: f32, 1: int8, 2: int32), u32 rank (1..4),
+ *                 u32 dims[4] (unused entries 0), f32 scale,
+ *                 i32 zero_point, u32 data_size, u8 data[data_size]
+ *                 padded to a multiple of 4 bytes
+ *               data_size is 0 for activations and equal to the tensor
+ *               byte size for constants (weights and biases)
+ *   ops         op_count records of 11 u32:
+ *                 opcode, fused activation (0: none, 1: relu, 2: relu6),
+ *                 padding (0: valid, 1: same), input, weights, bias,
+ *                 output, stride_h, stride_w, filter_h, filter_w
+ *               unused tensor slots are 0xFFFFFFFF
+ *
+ * Ops run in the order they are stored. Weight layouts follow TFLite:
+ * dense [out, in], conv2d [out_c, kh, kw, in_c], depthwise conv2d
+ * [1, kh, kw, in_c * multiplier]. Quantized graphs use per-tensor int8
+ * activations, symmetric int8 weights (zero point 0) and int32 biases
+ * with scale input_scale * weight_scale, so the arithmetic matches the
+ * TFLite reference kernels.
+ *
+ * The inner loops (dot products and multiply-accumulate rows) use AVX2,
+ * SSE2 or NEON when the compiler targets them, and fall back to portable
+ * C otherwise. Define WASI_NN_CPU_DISABLE_SIMD to force the fallback.
+ */
+
+#include "wasi_nn_cpu.h"
+#include "utils/logger.h"
+
+#include "bh_platform.h"
+#include "wasi_nn_types.h"
+#include "wasm_export.h"
+
+#include <math.h>
+#include <float.h>
+
+#if !defined(WASI_NN_CPU_DISABLE_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CPU_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CPU_SIMD_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CPU_SIMD_NEON 1
+#endif
+#endif /* end of !defined(WASI_NN_CPU_DISABLE_SIMD) */
+
+/* Maximum number of graphs per WASM instance */
+#define MAX_GRAPHS_PER_INST 10
+/* Maximum number of graph execution context per WASM instance*/
+#define MAX_GRAPH_EXEC_CONTEXTS_PER_INST 10
+
+#define WNNG_MAGIC 0x474E4E57 /* "WNNG" */
+#define WNNG_VERSION 1
+#define WNNG_MAX_RANK 4
+/* Upper bound on the elements of a single tensor, keeps sizes in 32 bits */
+#define WNNG_MAX_ELEMS (1U << 26)
+#define WNNG_NO_TENSOR 0xFFFFFFFF
+
+#if WASM_ENABLE_WASI_EPHEMERAL_NN != 0
+#define TENSOR_TYPE_RAW_INT8 u8
+#else
+#define TENSOR_TYPE_RAW_INT8 up8
+#endif
+
+enum { CPU_F32 = 0, CPU_INT8, CPU_INT32 };
+
+enum {
+    OP_DENSE = 0,
+    OP_CONV2D,
+    OP_DEPTHWISE_CONV2D,
+    OP_MAX_POOL2D,
+    OP_AVG_POOL2D,
+    OP_RELU,
+    OP_RELU6,
+    OP_SIGMOID,
+    OP_TANH,
+    OP_SOFTMAX,
+    OP_QUANTIZE,
+    OP_DEQUANTIZE,
+};
+
+enum { ACT_NONE = 0, ACT_RELU, ACT_RELU6 };
+
+enum { PAD_VALID = 0, PAD_SAME };
+
+typedef struct {
+    uint32_t type;
+    uint32_t rank;
+    uint32_t dims[WNNG_MAX_RANK];
+    float scale;
+    int32_t zero_point;
+    uint32_t elems;
+    /* Points into the graph buffer for constants, NULL for activations */
+    const uint8_t *data;
+} CpuTensor;
+
+typedef struct {
+    /* As serialized */
+    uint32_t opcode;
+    uint32_t activation;
+    uint32_t padding;
+    uint32_t input;
+    uint32_t weights;
+    uint32_t bias;
+    uint32_t output;
+    uint32_t stride_h;
+    uint32_t stride_w;
+    uint32_t filter_h;
+    uint32_t filter_w;
+
+    /* Resolved while loading */
+    uint32_t batch;
+    uint32_t in_h, in_w, in_c;
+    uint32_t out_h, out_w, out_c;
+    uint32_t pad_top, pad_left;
+    /* Dense: input features, softmax: row length */
+    uint32_t inner;
+    uint32_t depth_multiplier;
+    float act_min_f, act_max_f;
+    int32_t act_min, act_max;
+    int32_t multiplier;
+    int32_t shift;
+    /* Quantized dense/conv: bias - input_zero_point * sum(weights),
+       quantized depthwise: bias */
+    int32_t *bias_q;
+    /* Quantized elementwise ops */
+    int8_t *lut;
+} CpuOp;
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t tensor_count;
+    uint32_t op_count;
+    uint32_t input_count;
+    uint32_t output_count;
+    uint32_t *inputs;
+    uint32_t *outputs;
+    CpuTensor *tensors;
+    CpuOp *ops;
+    /* Per execution context scratch needed by the largest op */
+    uint32_t scratch_size;
+} CpuGraph;
+
+/* An input or output bound to a region of the caller's memory */
+typedef struct {
+    /* NULL when unbound */
+    tensor_data data;
+    /* The ops use the region itself, nothing is copied */
+    bool in_place;
+    /* Input only, the region holds f32 values of an int8 tensor */
+    bool is_f32;
+} CpuBinding;
+
+typedef struct {
+    bool is_initialized;
+    graph g;
+    /* Where the ops find every tensor: constants alias the graph buffer,
+       tensors bound in place the caller's region, others their buffer */
+    uint8_t **data;
+    /* Buffers owned by the context */
+    uint8_t **buffers;
+    uint8_t *scratch;
+    CpuBinding *inputs;
+    CpuBinding *outputs;
+} CpuExecContext;
+
+typedef struct {
+    uint32_t current_graphs;
+    CpuGraph graphs[MAX_GRAPHS_PER_INST];
+    uint32_t current_exec_ctxs;
+    CpuExecContext exec_ctxs[MAX_GRAPH_EXEC_CONTEXTS_PER_INST];
+    korp_mutex g_lock;
+} CpuContext;
+
+/* Kernels */
+
+static float
+dot_f32(const float *a, const float *b, uint32_t n)
+{
+    uint32_t i = 0;
+    float sum = 0;
+
+#if defined(CPU_SIMD_AVX2)
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m128 s;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i),
+                                                 _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8),
+                                                 _mm256_loadu_ps(b + i + 8)));
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i),
+                                                 _mm256_loadu_ps(b + i)));
+    }
+    acc0 = _mm256_add_ps(acc0, acc1);
+    s = _mm_add_ps(_mm256_castps256_ps128(acc0),
+                   _mm256_extractf128_ps(acc0, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    sum = _mm_cvtss_f32(s);
+#elif defined(CPU_SIMD_SSE2)
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0,
+                          _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(
+            acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+    sum = _mm_cvtss_f32(acc0);
+#elif defined(CPU_SIMD_NEON)
+    float32x4_t acc = vdupq_n_f32(0);
+    float32x2_t t;
+    for (; i + 4 <= n; i += 4)
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    t = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(t, t), 0);
+#endif
+
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+static int32_t
+dot_s8(const int8_t *a, const int8_t *b, uint32_t n)
+{
+    uint32_t i = 0;
+    int32_t sum = 0;
+
+#if defined(CPU_SIMD_AVX2)
+    __m256i acc = _mm256_setzero_si256();
+    __m128i s;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va =
+            _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(a + i)));
+        __m256i vb =
+            _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    s = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                      _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(s);
+#elif defined(CPU_SIMD_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        /* Sign extend to 16 bits by shifting the duplicated bytes */
+        __m128i a_lo = _mm_srai_epi16(_mm_unpacklo_epi8(va, va), 8);
+        __m128i a_hi = _mm_srai_epi16(_mm_unpackhi_epi8(va, va), 8);
+        __m128i b_lo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i b_hi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_lo, b_lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_hi, b_hi));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    sum = _mm_cvtsi128_si32(acc);
+#elif defined(CPU_SIMD_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    int32x2_t t;
+    for (; i + 16 <= n; i += 16) {
+        int8x16_t va = vld1q_s8(a + i);
+        int8x16_t vb = vld1q_s8(b + i);
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(va), vget_low_s8(vb)));
+        acc = vpadalq_s16(acc, vmull_s8(vget_high_s8(va), vget_high_s8(vb)));
+    }
+    t = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    sum = vget_lane_s32(vpadd_s32(t, t), 0);
+#endif
+
+    for (; i < n; i++)
+        sum += (int32_t)a[i] * b[i];
+    return sum;
+}
+
+/* acc[i] += x[i] * w[i] */
+static void
+madd_f32(float *acc, const float *x, const float *w, uint32_t n)
+{
+    uint32_t i = 0;
+
+#if defined(CPU_SIMD_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m256 p =
+            _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(w + i));
+        _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), p));
+    }
+#elif defined(CPU_SIMD_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128 p = _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(w + i));
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), p));
+    }
+#elif defined(CPU_SIMD_NEON)
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(acc + i, vmlaq_f32(vld1q_f32(acc + i), vld1q_f32(x + i),
+                                     vld1q_f32(w + i)));
+    }
+#endif
+
+    for (; i < n; i++)
+        acc[i] += x[i] * w[i];
+}
+
+/*
+ * acc[i] += (x[i] - x_zp) * w[i]. With int8 operands and a zero point in
+ * [-128, 127] every product fits in 16 bits, so the vector paths multiply
+ * in 16 bits and only widen to accumulate.
+ */
+static void
+madd_s8(int32_t *acc, const int8_t *x, const int8_t *w, int32_t x_zp,
+        uint32_t n)
+{
+    uint32_t i = 0;
+
+#if defined(CPU_SIMD_AVX2)
+    __m256i zp = _mm256_set1_epi16((int16_t)x_zp);
+    for (; i + 16 <= n; i += 16) {
+        __m256i vx = _mm256_sub_epi16(
+            _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(x + i))),
+            zp);
+        __m256i vw =
+            _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i *)(w + i)));
+        __m256i p = _mm256_mullo_epi16(vx, vw);
+        __m256i p_lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(p));
+        __m256i p_hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(p, 1));
+        __m256i *a = (__m256i *)(acc + i);
+        _mm256_storeu_si256(a, _mm256_add_epi32(_mm256_loadu_si256(a), p_lo));
+        _mm256_storeu_si256(a + 1,
+                            _mm256_add_epi32(_mm256_loadu_si256(a + 1), p_hi));
+    }
+#elif defined(CPU_SIMD_SSE2)
+    __m128i zp = _mm_set1_epi16((int16_t)x_zp);
+    for (; i + 8 <= n; i += 8) {
+        __m128i vx = _mm_loadl_epi64((const __m128i *)(x + i));
+        __m128i vw = _mm_loadl_epi64((const __m128i *)(w + i));
+        __m128i p;
+        __m128i *a = (__m128i *)(acc + i);
+        vx = _mm_sub_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(vx, vx), 8), zp);
+        vw = _mm_srai_epi16(_mm_unpacklo_epi8(vw, vw), 8);
+        p = _mm_mullo_epi16(vx, vw);
+        _mm_storeu_si128(
+            a, _mm_add_epi32(_mm_loadu_si128(a),
+                             _mm_srai_epi32(_mm_unpacklo_epi16(p, p), 16)));
+        _mm_storeu_si128(
+            a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1),
+                                 _mm_srai_epi32(_mm_unpackhi_epi16(p, p), 16)));
+    }
+#elif defined(CPU_SIMD_NEON)
+    int16x8_t zp = vdupq_n_s16((int16_t)x_zp);
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t vx = vsubq_s16(vmovl_s8(vld1_s8(x + i)), zp);
+        int16x8_t vw = vmovl_s8(vld1_s8(w + i));
+        vst1q_s32(acc + i, vmlal_s16(vld1q_s32(acc + i), vget_low_s16(vx),
+                                     vget_low_s16(vw)));
+        vst1q_s32(acc + i + 4, vmlal_s16(vld1q_s32(acc + i + 4),
+                                         vget_high_s16(vx), vget_high_s16(vw)));
+    }
+#endif
+
+    for (; i < n; i++)
+        acc[i] += ((int32_t)x[i] - x_zp) * w[i];
+}
+
+/* Fixed-point requantization, bit-exact with the TFLite reference */
+
+static void
+quantize_multiplier(double real_multiplier, int32_t *multiplier,
+                    int32_t *shift)
+{
+    int exp = 0;
+    double q;
+    int64_t q_fixed;
+
+    if (real_multiplier == 0) {
+        *multiplier = 0;
+        *shift = 0;
+        return;
+    }
+
+    q = frexp(real_multiplier, &exp);
+    q_fixed = (int64_t)llround(q * (double)(1LL << 31));
+    if (q_fixed == (1LL << 31)) {
+        q_fixed /= 2;
+        exp++;
+    }
+    if (exp < -31) {
+        exp = 0;
+        q_fixed = 0;
+    }
+    *multiplier = (int32_t)q_fixed;
+    *shift = exp;
+}
+
+static int32_t
+saturating_rounding_doubling_high_mul(int32_t a, int32_t b)
+{
+    bool overflow = a == b && a == INT32_MIN;
+    int64_t ab = (int64_t)a * (int64_t)b;
+    int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+    int32_t high = (int32_t)((ab + nudge) / (1LL << 31));
+    return overflow ? INT32_MAX : high;
+}
+
+static int32_t
+rounding_divide_by_pot(int32_t x, int32_t exponent)
+{
+    int32_t mask = (int32_t)((1LL << exponent) - 1);
+    int32_t remainder = x & mask;
+    int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+    return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+static inline int32_t
+multiply_by_quantized_multiplier(int32_t x, int32_t multiplier, int32_t shift)
+{
+    int32_t left_shift = shift > 0 ? shift : 0;
+    int32_t right_shift = shift > 0 ? 0 : -shift;
+    return rounding_divide_by_pot(saturating_rounding_doubling_high_mul(
+                                      (int32_t)((uint32_t)x << left_shift),
+                                      multiplier),
+                                  right_shift);
+}
+
+static inline int8_t
+requantize(int32_t acc, const CpuOp *op, int32_t out_zp)
+{
+    int32_t v = multiply_by_quantized_multiplier(acc, op->multiplier,
+                                                 op->shift)
+                + out_zp;
+    v = v < op->act_min ? op->act_min : v;
+    v = v > op->act_max ? op->act_max : v;
+    return (int8_t)v;
+}
+
+static inline int8_t
+quantize_f32(float f, float scale, int32_t zero_point)
+{
+    float q = roundf(f / scale) + (float)zero_point;
+    /* Written so that NaN ends up at the lower bound */
+    if (!(q >= -128.0f))
+        return -128;
+    if (q > 127.0f)
+        return 127;
+    return (int8_t)q;
+}
+
+static inline float
+dequantize_s8(int8_t v, float scale, int32_t zero_point)
+{
+    return ((int32_t)v - zero_point) * scale;
+}
+
+static inline float
+clamp_f32(float v, float min, float max)
+{
+    v = v < min ? min : v;
+    return v > max ? max : v;
+}
+
+/* Graph parsing */
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+} WNNGReader;
+
+static bool
+read_u32(WNNGReader *reader, uint32_t *value)
+{
+    const uint8_t *p = reader->p;
+
+    if (reader->end - p < 4)
+        return false;
+    *value = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16)
+             | ((uint32_t)p[3] << 24);
+    reader->p += 4;
+    return true;
+}
+
+static bool
+read_u32_array(WNNGReader *reader, uint32_t *values, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (!read_u32(reader, values + i))
+            return false;
+    }
+    return true;
+}
+
+static uint32_t
+tensor_elem_size(uint32_t type)
+{
+    return type == CPU_INT8 ? 1 : 4;
+}
+
+static bool
+is_little_endian(void)
+{
+    union {
+        uint32_t u32;
+        uint8_t u8[4];
+    } probe = { .u32 = 1 };
+    return probe.u8[0] == 1;
+}
+
+static wasi_nn_error
+parse_tensor(WNNGReader *reader, CpuTensor *info)
+{
+    uint32_t scale_bits, zero_point, data_size, i;
+    uint64_t elems = 1;
+
+    if (!read_u32(reader, &info->type) || !read_u32(reader, &info->rank)
+        || !read_u32_array(reader, info->dims, WNNG_MAX_RANK)
+        || !read_u32(reader, &scale_bits) || !read_u32(reader, &zero_point)
+        || !read_u32(reader, &data_size)) {
+        NN_ERR_PRINTF("Truncated tensor record.");
+        return invalid_argument;
+    }
+
+    if (info->type > CPU_INT32 || info->rank == 0
+        || info->rank > WNNG_MAX_RANK) {
+        NN_ERR_PRINTF("Invalid tensor type %u or rank %u.", info->type,
+                      info->rank);
+        return invalid_argument;
+    }
+
+    for (i = 0; i < info->rank; i++) {
+        elems *= info->dims[i];
+        if (info->dims[i] == 0 || elems > WNNG_MAX_ELEMS) {
+            NN_ERR_PRINTF("Invalid tensor shape.");
+            return invalid_argument;
+        }
+    }
+    for (; i < WNNG_MAX_RANK; i++)
+        info->dims[i] = 1;
+    info->elems = (uint32_t)elems;
+
+    memcpy(&info->scale, &scale_bits, sizeof(float));
+    info->zero_point = (int32_t)zero_point;
+    if (info->type == CPU_INT8
+        && (!(info->scale > 0 && info->scale <= FLT_MAX)
+            || info->zero_point < -128 || info->zero_point > 127)) {
+        NN_ERR_PRINTF("Invalid quantization parameters.");
+        return invalid_argument;
+    }
+
+    info->data = NULL;
+    if (data_size != 0) {
+        uint32_t padded = (data_size + 3) & ~3U;
+
+        if (data_size != info->elems * tensor_elem_size(info->type)
+            || padded < data_size
+            || (uint64_t)(reader->end - reader->p) < padded) {
+            NN_ERR_PRINTF("Invalid tensor data size %u.", data_size);
+            return invalid_argument;
+        }
+        /* Records are padded, so f32 and int32 data stay aligned */
+        info->data = reader->p;
+        reader->p += padded;
+    }
+    return success;
+}
+
+/* Output size of a windowed op along one axis, TF semantics */
+static bool
+compute_window(uint32_t padding, uint32_t in, uint32_t filter, uint32_t stride,
+               uint32_t *out, uint32_t *pad_before)
+{
+    uint32_t needed;
+
+    if (stride == 0 || stride > 0xFFFF || filter == 0 || filter > 0xFFFF)
+        return false;
+
+    if (padding == PAD_VALID) {
+        if (in < filter)
+            return false;
+        *out = (in - filter) / stride + 1;
+        *pad_before = 0;
+        return true;
+    }
+
+    *out = (in + stride - 1) / stride;
+    needed = (*out - 1) * stride + filter;
+    *pad_before = needed > in ? (needed - in) / 2 : 0;
+    return true;
+}
+
+static void
+compute_activation_range(CpuOp *op, const CpuTensor *out)
+{
+    op->act_min_f = -FLT_MAX;
+    op->act_max_f = FLT_MAX;
+    if (op->activation == ACT_RELU || op->activation == ACT_RELU6)
+        op->act_min_f = 0;
+    if (op->activation == ACT_RELU6)
+        op->act_max_f = 6;
+
+    op->act_min = -128;
+    op->act_max = 127;
+    if (out->type == CPU_INT8) {
+        if (op->activation != ACT_NONE)
+            op->act_min = quantize_f32(0, out->scale, out->zero_point);
+        if (op->activation == ACT_RELU6)
+            op->act_max = quantize_f32(6, out->scale, out->zero_point);
+    }
+}
+
+static float
+apply_unary(uint32_t opcode, float v)
+{
+    switch (opcode) {
+        case OP_RELU:
+            return v > 0 ? v : 0;
+        case OP_RELU6:
+            return clamp_f32(v, 0, 6);
+        case OP_SIGMOID:
+            return 1.0f / (1.0f + expf(-v));
+        case OP_TANH:
+            return tanhf(v);
+        default:
+            return v;
+    }
+}
+
+/* Checks the tensors of a weighted op and folds the quantized bias */
+static wasi_nn_error
+prepare_weighted_op(CpuGraph *model, CpuOp *op)
+{
+    const CpuTensor *in = model->tensors + op->input;
+    const CpuTensor *w = model->tensors + op->weights;
+    const CpuTensor *out = model->tensors + op->output;
+    const CpuTensor *bias = NULL;
+    uint32_t taps, oc, i;
+
+    if (op->weights >= model->tensor_count || !w->data || w->type != in->type
+        || (in->type != CPU_F32 && in->type != CPU_INT8)) {
+        NN_ERR_PRINTF("Op needs constant f32 or int8 weights.");
+        return invalid_argument;
+    }
+
+    if (op->opcode == OP_DENSE) {
+        if (w->rank != 2 || in->elems % w->dims[1] != 0)
+            return invalid_argument;
+        op->inner = w->dims[1];
+        op->out_c = w->dims[0];
+        op->batch = in->elems / op->inner;
+        if (out->elems != op->batch * op->out_c)
+            return invalid_argument;
+    }
+    else {
+        if (in->rank != 4 || w->rank != 4 || out->rank != 4)
+            return invalid_argument;
+        op->batch = in->dims[0];
+        op->in_h = in->dims[1];
+        op->in_w = in->dims[2];
+        op->in_c = in->dims[3];
+        op->filter_h = w->dims[1];
+        op->filter_w = w->dims[2];
+        op->out_c = w->dims[op->opcode == OP_CONV2D ? 0 : 3];
+        if (op->opcode == OP_CONV2D) {
+            if (w->dims[3] != op->in_c)
+                return invalid_argument;
+        }
+        else {
+            if (w->dims[0] != 1 || op->out_c % op->in_c != 0)
+                return invalid_argument;
+            op->depth_multiplier = op->out_c / op->in_c;
+        }
+        if (!compute_window(op->padding, op->in_h, op->filter_h, op->stride_h,
+                            &op->out_h, &op->pad_top)
+            || !compute_window(op->padding, op->in_w, op->filter_w,
+                               op->stride_w, &op->out_w, &op->pad_left)
+            || out->dims[0] != op->batch || out->dims[1] != op->out_h
+            || out->dims[2] != op->out_w || out->dims[3] != op->out_c)
+            return invalid_argument;
+    }
+
+    if (op->bias != WNNG_NO_TENSOR) {
+        if (op->bias >= model->tensor_count)
+            return invalid_argument;
+        bias = model->tensors + op->bias;
+        if (!bias->data || bias->elems != op->out_c
+            || bias->type != (in->type == CPU_INT8 ? CPU_INT32 : CPU_F32))
+            return invalid_argument;
+    }
+
+    compute_activation_range(op, out);
+    if (in->type == CPU_F32)
+        return success;
+
+    if (w->zero_point != 0) {
+        NN_ERR_PRINTF("Only symmetric int8 weights are supported.");
+        return invalid_argument;
+    }
+    quantize_multiplier((double)in->scale * w->scale / out->scale,
+                        &op->multiplier, &op->shift);
+    if (op->shift > 30) {
+        NN_ERR_PRINTF("Requantization multiplier out of range.");
+        return invalid_argument;
+    }
+
+    op->bias_q = wasm_runtime_malloc(sizeof(int32_t) * op->out_c);
+    if (!op->bias_q)
+        return too_large;
+    for (oc = 0; oc < op->out_c; oc++)
+        op->bias_q[oc] = bias ? ((const int32_t *)bias->data)[oc] : 0;
+
+    if (op->opcode == OP_DEPTHWISE_CONV2D)
+        return success;
+
+    /* Padding taps of conv2d are fed with the input zero point, so the
+       zero point correction applies to every tap */
+    taps = w->elems / op->out_c;
+    for (oc = 0; oc < op->out_c; oc++) {
+        const int8_t *row = (const int8_t *)w->data + (size_t)oc * taps;
+        int32_t sum = 0;
+        for (i = 0; i < taps; i++)
+            sum += row[i];
+        op->bias_q[oc] -= in->zero_point * sum;
+    }
+    return success;
+}
+
+static wasi_nn_error
+prepare_op(CpuGraph *model, CpuOp *op)
+{
+    const CpuTensor *in, *out;
+    uint32_t i;
+
+    if (op->input >= model->tensor_count || op->output >= model->tensor_count
+        || op->input == op->output) {
+        NN_ERR_PRINTF("Invalid op tensors.");
+        return invalid_argument;
+    }
+    in = model->tensors + op->input;
+    out = model->tensors + op->output;
+    if (out->data) {
+        NN_ERR_PRINTF("Op writes to a constant tensor.");
+        return invalid_argument;
+    }
+    if (op->activation > ACT_RELU6 || op->padding > PAD_SAME)
+        return invalid_argument;
+
+    switch (op->opcode) {
+        case OP_DENSE:
+        case OP_CONV2D:
+        case OP_DEPTHWISE_CONV2D:
+            if (out->type != in->type)
+                return invalid_argument;
+            return prepare_weighted_op(model, op);
+
+        case OP_MAX_POOL2D:
+        case OP_AVG_POOL2D:
+            if (in->rank != 4 || out->rank != 4 || out->type != in->type
+                || (in->type != CPU_F32 && in->type != CPU_INT8))
+                return invalid_argument;
+            if (in->type == CPU_INT8
+                && (in->scale != out->scale
+                    || in->zero_point != out->zero_point)) {
+                NN_ERR_PRINTF("Pooling cannot requantize.");
+                return invalid_argument;
+            }
+            op->batch = in->dims[0];
+            op->in_h = in->dims[1];
+            op->in_w = in->dims[2];
+            op->in_c = op->out_c = in->dims[3];
+            if (!compute_window(op->padding, op->in_h, op->filter_h,
+                                op->stride_h, &op->out_h, &op->pad_top)
+                || !compute_window(op->padding, op->in_w, op->filter_w,
+                                   op->stride_w, &op->out_w, &op->pad_left)
+                || out->dims[0] != op->batch || out->dims[1] != op->out_h
+                || out->dims[2] != op->out_w || out->dims[3] != op->out_c)
+                return invalid_argument;
+            compute_activation_range(op, out);
+            return success;
+
+        case OP_RELU:
+        case OP_RELU6:
+        case OP_SIGMOID:
+        case OP_TANH:
+        case OP_SOFTMAX:
+            if (out->elems != in->elems || out->type != in->type
+                || (in->type != CPU_F32 && in->type != CPU_INT8))
+                return invalid_argument;
+            op->inner = in->dims[in->rank - 1];
+            if (in->type == CPU_F32 || op->opcode == OP_SOFTMAX)
+                return success;
+            /* Unary int8 ops go through a 256 entry table */
+            op->lut = wasm_runtime_malloc(256);
+            if (!op->lut)
+                return too_large;
+            for (i = 0; i < 256; i++) {
+                float v = dequantize_s8((int8_t)(i - 128), in->scale,
+                                        in->zero_point);
+                op->lut[i] = quantize_f32(apply_unary(op->opcode, v),
+                                          out->scale, out->zero_point);
+            }
+            return success;
+
+        case OP_QUANTIZE:
+        case OP_DEQUANTIZE:
+            if (out->elems != in->elems
+                || in->type != (op->opcode == OP_QUANTIZE ? CPU_F32 : CPU_INT8)
+                || out->type
+                       != (op->opcode == OP_QUANTIZE ? CPU_INT8 : CPU_F32))
+                return invalid_argument;
+            return success;
+
+        default:
+            NN_ERR_PRINTF("Unsupported opcode %u.", op->opcode);
+            return unsupported_operation;
+    }
+}
+
+static uint32_t
+op_scratch_size(const CpuGraph *model, const CpuOp *op)
+{
+    switch (op->opcode) {
+        case OP_CONV2D:
+            /* One im2col patch */
+            return op->filter_h * op->filter_w * op->in_c
+                   * tensor_elem_size(model->tensors[op->input].type);
+        case OP_DEPTHWISE_CONV2D:
+        case OP_MAX_POOL2D:
+        case OP_AVG_POOL2D:
+            /* One row of accumulators */
+            return op->out_c * 4;
+        case OP_SOFTMAX:
+            return op->inner * 4;
+        default:
+            return 0;
+    }
+}
+
+static void
+destroy_graph(CpuGraph *model)
+{
+    uint32_t i;
+
+    if (model->ops) {
+        for (i = 0; i < model->op_count; i++) {
+            if (model->ops[i].bias_q)
+                wasm_runtime_free(model->ops[i].bias_q);
+            if (model->ops[i].lut)
+                wasm_runtime_free(model->ops[i].lut);
+        }
+        wasm_runtime_free(model->ops);
+    }
+    if (model->tensors)
+        wasm_runtime_free(model->tensors);
+    if (model->inputs)
+        wasm_runtime_free(model->inputs);
+    if (model->outputs)
+        wasm_runtime_free(model->outputs);
+    if (model->buf)
+        wasm_runtime_free(model->buf);
+    memset(model, 0, sizeof(CpuGraph));
+}
+
+/* Takes the ownership of buf, whatever the result */
+static wasi_nn_error
+parse_graph(CpuGraph *model, uint8_t *buf, uint32_t size)
+{
+    WNNGReader reader = { buf, buf + size };
+    uint32_t header[6], i;
+    wasi_nn_error res = invalid_argument;
+
+    memset(model, 0, sizeof(CpuGraph));
+    model->buf = buf;
+
+    if (!is_little_endian()) {
+        NN_ERR_PRINTF("The CPU backend needs a little-endian host.");
+        res = unsupported_operation;
+        goto fail;
+    }
+
+    if (!read_u32_array(&reader, header, 6) || header[0] != WNNG_MAGIC
+        || header[1] != WNNG_VERSION) {
+        NN_ERR_PRINTF("Not a WNNG graph.");
+        goto fail;
+    }
+    model->tensor_count = header[2];
+    model->op_count = header[3];
+    model->input_count = header[4];
+    model->output_count = header[5];
+    /* Every tensor record takes at least 40 bytes and every op 44 */
+    if (model->tensor_count == 0 || model->tensor_count > size / 40
+        || model->op_count > size / 44 || model->input_count == 0
+        || model->input_count > model->tensor_count
+        || model->output_count == 0
+        || model->output_count > model->tensor_count) {
+        NN_ERR_PRINTF("Invalid graph header.");
+        goto fail;
+    }
+
+    model->inputs = wasm_runtime_malloc(sizeof(uint32_t) * model->input_count);
+    model->outputs =
+        wasm_runtime_malloc(sizeof(uint32_t) * model->output_count);
+    model->tensors =
+        wasm_runtime_malloc(sizeof(CpuTensor) * model->tensor_count);
+    model->ops = wasm_runtime_malloc(sizeof(CpuOp) * (model->op_count + 1));
+    if (!model->inputs || !model->outputs || !model->tensors || !model->ops) {
+        NN_ERR_PRINTF("Error when allocating memory for graph.");
+        res = too_large;
+        goto fail;
+    }
+    memset(model->ops, 0, sizeof(CpuOp) * (model->op_count + 1));
+
+    if (!read_u32_array(&reader, model->inputs, model->input_count)
+        || !read_u32_array(&reader, model->outputs, model->output_count))
+        goto fail;
+
+    for (i = 0; i < model->tensor_count; i++) {
+        if (success != (res = parse_tensor(&reader, model->tensors + i)))
+            goto fail;
+    }
+    res = invalid_argument;
+
+    for (i = 0; i < model->input_count; i++) {
+        if (model->inputs[i] >= model->tensor_count
+            || model->tensors[model->inputs[i]].data
+            || model->tensors[model->inputs[i]].type == CPU_INT32) {
+            NN_ERR_PRINTF("Invalid graph input %u.", i);
+            goto fail;
+        }
+    }
+    for (i = 0; i < model->output_count; i++) {
+        if (model->outputs[i] >= model->tensor_count
+            || model->tensors[model->outputs[i]].type == CPU_INT32) {
+            NN_ERR_PRINTF("Invalid graph output %u.", i);
+            goto fail;
+        }
+    }
+
+    for (i = 0; i < model->op_count; i++) {
+        CpuOp *op = model->ops + i;
+        uint32_t scratch;
+
+        if (!read_u32(&reader, &op->opcode)
+            || !read_u32(&reader, &op->activation)
+            || !read_u32(&reader, &op->padding)
+            || !read_u32(&reader, &op->input)
+            || !read_u32(&reader, &op->weights)
+            || !read_u32(&reader, &op->bias)
+            || !read_u32(&reader, &op->output)
+            || !read_u32(&reader, &op->stride_h)
+            || !read_u32(&reader, &op->stride_w)
+            || !read_u32(&reader, &op->filter_h)
+            || !read_u32(&reader, &op->filter_w)) {
+            NN_ERR_PRINTF("Truncated op record.");
+            goto fail;
+        }
+        if (success != (res = prepare_op(model, op))) {
+            NN_ERR_PRINTF("Invalid op %u (opcode %u).", i, op->opcode);
+            goto fail;
+        }
+        res = invalid_argument;
+
+        scratch = op_scratch_size(model, op);
+        if (scratch > model->scratch_size)
+            model->scratch_size = scratch;
+    }
+
+    return success;
+fail:
+    destroy_graph(model);
+    return res;
+}
+
+/* Op execution */
+
+static void
+run_dense(const CpuGraph *model, const CpuOp *op, uint8_t **data)
+{
+    const CpuTensor *out = model->tensors + op->output;
+    uint32_t b, n, k = op->inner;
+
+    if (out->type == CPU_F32) {
+        const float *in = (const float *)data[op->input];
+        const float *w = (const float *)data[op->weights];
+        const float *bias = op->bias != WNNG_NO_TENSOR
+                                ? (const float *)data[op->bias]
+                                : NULL;
+        float *o = (float *)data[op->output];
+
+        for (b = 0; b < op->batch; b++, in += k) {
+            for (n = 0; n < op->out_c; n++) {
+                float v = dot_f32(in, w + (size_t)n * k, k);
+                if (bias)
+                    v += bias[n];
+                *o++ = clamp_f32(v, op->act_min_f, op->act_max_f);
+            }
+        }
+    }
+    else {
+        const int8_t *in = (const int8_t *)data[op->input];
+        const int8_t *w = (const int8_t *)data[op->weights];
+        int8_t *o = (int8_t *)data[op->output];
+
+        for (b = 0; b < op->batch; b++, in += k) {
+            for (n = 0; n < op->out_c; n++) {
+                int32_t acc = dot_s8(in, w + (size_t)n * k, k) + op->bias_q[n];
+                *o++ = requantize(acc, op, out->zero_point);
+            }
+        }
+    }
+}
+
+/*
+ * Gathers the receptive field of one output pixel into a contiguous
+ * [kh, kw, c] patch, which has the layout of one conv2d filter, so that
+ * every output channel becomes a single dot product.
+ */
+static void
+gather_patch(const CpuOp *op, const uint8_t *in, uint32_t elem_size,
+             int32_t iy0, int32_t ix0, uint8_t fill, uint8_t *patch)
+{
+    uint32_t row_bytes = op->in_c * elem_size;
+    uint32_t ky, kx;
+
+    for (ky = 0; ky < op->filter_h; ky++) {
+        int32_t iy = iy0 + (int32_t)ky;
+        uint8_t *p = patch + (size_t)ky * op->filter_w * row_bytes;
+        const uint8_t *in_row;
+
+        if (iy < 0 || iy >= (int32_t)op->in_h) {
+            memset(p, fill, (size_t)op->filter_w * row_bytes);
+            continue;
+        }
+        in_row = in + (size_t)iy * op->in_w * row_bytes;
+        if (ix0 >= 0 && ix0 + op->filter_w <= op->in_w) {
+            /* The whole filter row is inside the input row */
+            memcpy(p, in_row + (size_t)ix0 * row_bytes,
+                   (size_t)op->filter_w * row_bytes);
+            continue;
+        }
+        for (kx = 0; kx < op->filter_w; kx++, p += row_bytes) {
+            int32_t ix = ix0 + (int32_t)kx;
+            if (ix < 0 || ix >= (int32_t)op->in_w)
+                memset(p, fill, row_bytes);
+            else
+                memcpy(p, in_row + (size_t)ix * row_bytes, row_bytes);
+        }
+    }
+}
+
+static void
+run_conv2d(const CpuGraph *model, const CpuOp *op, uint8_t **data,
+           uint8_t *scratch)
+{
+    const CpuTensor *in_t = model->tensors + op->input;
+    const CpuTensor *out_t = model->tensors + op->output;
+    uint32_t elem_size = tensor_elem_size(in_t->type);
+    uint32_t taps = op->filter_h * op->filter_w * op->in_c;
+    size_t in_image = (size_t)op->in_h * op->in_w * op->in_c * elem_size;
+    uint32_t b, oy, ox, oc;
+    uint8_t *out = data[op->output];
+
+    for (b = 0; b < op->batch; b++) {
+        const uint8_t *in = data[op->input] + b * in_image;
+
+        for (oy = 0; oy < op->out_h; oy++) {
+            int32_t iy0 = (int32_t)(oy * op->stride_h) - (int32_t)op->pad_top;
+
+            for (ox = 0; ox < op->out_w; ox++) {
+                int32_t ix0 =
+                    (int32_t)(ox * op->stride_w) - (int32_t)op->pad_left;
+
+                if (in_t->type == CPU_F32) {
+                    const float *w = (const float *)data[op->weights];
+                    const float *bias = op->bias != WNNG_NO_TENSOR
+                                            ? (const float *)data[op->bias]
+                                            : NULL;
+                    float *o = (float *)out;
+
+                    gather_patch(op, in, 4, iy0, ix0, 0, scratch);
+                    for (oc = 0; oc < op->out_c; oc++, w += taps) {
+                        float v = dot_f32((const float *)scratch, w, taps);
+                        if (bias)
+                            v += bias[oc];
+                        o[oc] = clamp_f32(v, op->act_min_f, op->act_max_f);
+                    }
+                    out += op->out_c * 4;
+                }
+                else {
+                    const int8_t *w = (const int8_t *)data[op->weights];
+                    int8_t *o = (int8_t *)out;
+
+                    gather_patch(op, in, 1, iy0, ix0,
+                                 (uint8_t)(int8_t)in_t->zero_point, scratch);
+                    for (oc = 0; oc < op->out_c; oc++, w += taps) {
+                        int32_t acc = dot_s8((const int8_t *)scratch, w, taps)
+                                      + op->bias_q[oc];
+                        o[oc] = requantize(acc, op, out_t->zero_point);
+                    }
+                    out += op->out_c;
+                }
+            }
+        }
+    }
+}
+
+static void
+run_depthwise_conv2d(const CpuGraph *model, const CpuOp *op, uint8_t **data,
+                     uint8_t *scratch)
+{
+    const CpuTensor *in_t = model->tensors + op->input;
+    const CpuTensor *out_t = model->tensors + op->output;
+    bool is_f32 = in_t->type == CPU_F32;
+    uint32_t elem_size = tensor_elem_size(in_t->type);
+    uint32_t m = op->depth_multiplier;
+    size_t in_image = (size_t)op->in_h * op->in_w * op->in_c * elem_size;
+    uint32_t b, oy, ox, ky, kx, c;
+    uint8_t *out = data[op->output];
+
+    for (b = 0; b < op->batch; b++) {
+        const uint8_t *in = data[op->input] + b * in_image;
+
+        for (oy = 0; oy < op->out_h; oy++) {
+            int32_t iy0 = (int32_t)(oy * op->stride_h) - (int32_t)op->pad_top;
+
+            for (ox = 0; ox < op->out_w; ox++) {
+                int32_t ix0 =
+                    (int32_t)(ox * op->stride_w) - (int32_t)op->pad_left;
+
+                /* Start every channel from its bias */
+                if (is_f32) {
+                    float *acc = (float *)scratch;
+                    for (c = 0; c < op->out_c; c++)
+                        acc[c] = op->bias != WNNG_NO_TENSOR
+                                     ? ((const float *)data[op->bias])[c]
+                                     : 0;
+                }
+                else {
+                    memcpy(scratch, op->bias_q, sizeof(int32_t) * op->out_c);
+                }
+
+                /* Padding taps contribute nothing, skip them */
+                for (ky = 0; ky < op->filter_h; ky++) {
+                    int32_t iy = iy0 + (int32_t)ky;
+                    if (iy < 0 || iy >= (int32_t)op->in_h)
+                        continue;
+                    for (kx = 0; kx < op->filter_w; kx++) {
+                        int32_t ix = ix0 + (int32_t)kx;
+                        size_t pixel, tap;
+                        if (ix < 0 || ix >= (int32_t)op->in_w)
+                            continue;
+                        pixel = ((size_t)iy * op->in_w + ix) * op->in_c;
+                        tap = ((size_t)ky * op->filter_w + kx) * op->out_c;
+
+                        if (is_f32) {
+                            const float *x = (const float *)in + pixel;
+                            const float *w =
+                                (const float *)data[op->weights] + tap;
+                            float *acc = (float *)scratch;
+                            if (m == 1) {
+                                madd_f32(acc, x, w, op->out_c);
+                                continue;
+                            }
+                            for (c = 0; c < op->out_c; c++)
+                                acc[c] += x[c / m] * w[c];
+                        }
+                        else {
+                            const int8_t *x = (const int8_t *)in + pixel;
+                            const int8_t *w =
+                                (const int8_t *)data[op->weights] + tap;
+                            int32_t *acc = (int32_t *)scratch;
+                            int32_t zp = in_t->zero_point;
+                            if (m == 1) {
+                                madd_s8(acc, x, w, zp, op->out_c);
+                                continue;
+                            }
+                            for (c = 0; c < op->out_c; c++)
+                                acc[c] += ((int32_t)x[c / m] - zp) * w[c];
+                        }
+                    }
+                }
+
+                if (is_f32) {
+                    const float *acc = (const float *)scratch;
+                    float *o = (float *)out;
+                    for (c = 0; c < op->out_c; c++)
+                        o[c] = clamp_f32(acc[c], op->act_min_f, op->act_max_f);
+                    out += op->out_c * 4;
+                }
+                else {
+                    const int32_t *acc = (const int32_t *)scratch;
+                    int8_t *o = (int8_t *)out;
+                    for (c = 0; c < op->out_c; c++)
+                        o[c] = requantize(acc[c], op, out_t->zero_point);
+                    out += op->out_c;
+                }
+            }
+        }
+    }
+}
+
+static void
+run_pool2d(const CpuGraph *model, const CpuOp *op, uint8_t **data,
+           uint8_t *scratch)
+{
+    bool is_f32 = model->tensors[op->input].type == CPU_F32;
+    bool is_max = op->opcode == OP_MAX_POOL2D;
+    uint32_t elem_size = is_f32 ? 4 : 1;
+    uint32_t channels = op->in_c;
+    size_t in_image = (size_t)op->in_h * op->in_w * channels * elem_size;
+    uint32_t b, oy, ox, ky, kx, c;
+    uint8_t *out = data[op->output];
+
+    for (b = 0; b < op->batch; b++) {
+        const uint8_t *in = data[op->input] + b * in_image;
+
+        for (oy = 0; oy < op->out_h; oy++) {
+            int32_t iy0 = (int32_t)(oy * op->stride_h) - (int32_t)op->pad_top;
+
+            for (ox = 0; ox < op->out_w; ox++) {
+                int32_t ix0 =
+                    (int32_t)(ox * op->stride_w) - (int32_t)op->pad_left;
+                float *acc_f = (float *)scratch;
+                int32_t *acc_i = (int32_t *)scratch;
+                int32_t count = 0;
+
+                for (c = 0; c < channels; c++) {
+                    if (is_f32)
+                        acc_f[c] = is_max ? -FLT_MAX : 0;
+                    else
+                        acc_i[c] = is_max ? -128 : 0;
+                }
+
+                /* Padding is excluded from both max and average */
+                for (ky = 0; ky < op->filter_h; ky++) {
+                    int32_t iy = iy0 + (int32_t)ky;
+                    if (iy < 0 || iy >= (int32_t)op->in_h)
+                        continue;
+                    for (kx = 0; kx < op->filter_w; kx++) {
+                        int32_t ix = ix0 + (int32_t)kx;
+                        size_t pixel;
+                        if (ix < 0 || ix >= (int32_t)op->in_w)
+                            continue;
+                        pixel = ((size_t)iy * op->in_w + ix) * channels;
+                        count++;
+
+                        if (is_f32) {
+                            const float *x = (const float *)in + pixel;
+                            if (is_max) {
+                                for (c = 0; c < channels; c++)
+                                    acc_f[c] =
+                                        x[c] > acc_f[c] ? x[c] : acc_f[c];
+                            }
+                            else {
+                                for (c = 0; c < channels; c++)
+                                    acc_f[c] += x[c];
+                            }
+                        }
+                        else {
+                            const int8_t *x = (const int8_t *)in + pixel;
+                            if (is_max) {
+                                for (c = 0; c < channels; c++)
+                                    acc_i[c] =
+                                        x[c] > acc_i[c] ? x[c] : acc_i[c];
+                            }
+                            else {
+                                for (c = 0; c < channels; c++)
+                                    acc_i[c] += x[c];
+                            }
+                        }
+                    }
+                }
+
+                for (c = 0; c < channels; c++) {
+                    if (is_f32) {
+                        float v = acc_f[c];
+                        if (!is_max)
+                            v = count ? v / (float)count : 0;
+                        ((float *)out)[c] =
+                            clamp_f32(v, op->act_min_f, op->act_max_f);
+                    }
+                    else {
+                        int32_t v = acc_i[c];
+                        if (!is_max && count) {
+                            /* Round half away from zero */
+                            v = v > 0 ? (v + count / 2) / count
+                                      : (v - count / 2) / count;
+                        }
+                        v = v < op->act_min ? op->act_min : v;
+                        v = v > op->act_max ? op->act_max : v;
+                        ((int8_t *)out)[c] = (int8_t)v;
+                    }
+                }
+                out += channels * elem_size;
+            }
+        }
+    }
+}
+
+static void
+softmax_row(float *row, uint32_t n)
+{
+    float max = row[0], sum = 0;
+    uint32_t i;
+
+    for (i = 1; i < n; i++)
+        max = row[i] > max ? row[i] : max;
+    for (i = 0; i < n; i++) {
+        row[i] = expf(row[i] - max);
+        sum += row[i];
+    }
+    for (i = 0; i < n; i++)
+        row[i] /= sum;
+}
+
+static void
+run_elementwise(const CpuGraph *model, const CpuOp *op, uint8_t **data,
+                uint8_t *scratch)
+{
+    const CpuTensor *in_t = model->tensors + op->input;
+    const CpuTensor *out_t = model->tensors + op->output;
+    uint32_t n = in_t->elems, i, j;
+    const float *in_f = (const float *)data[op->input];
+    const int8_t *in_q = (const int8_t *)data[op->input];
+    float *out_f = (float *)data[op->output];
+    int8_t *out_q = (int8_t *)data[op->output];
+
+    switch (op->opcode) {
+        case OP_QUANTIZE:
+            for (i = 0; i < n; i++)
+                out_q[i] =
+                    quantize_f32(in_f[i], out_t->scale, out_t->zero_point);
+            return;
+
+        case OP_DEQUANTIZE:
+            for (i = 0; i < n; i++)
+                out_f[i] =
+                    dequantize_s8(in_q[i], in_t->scale, in_t->zero_point);
+            return;
+
+        case OP_SOFTMAX:
+            for (i = 0; i < n; i += op->inner) {
+                if (in_t->type == CPU_F32) {
+                    memcpy(out_f + i, in_f + i, sizeof(float) * op->inner);
+                    softmax_row(out_f + i, op->inner);
+                    continue;
+                }
+                /* Quantized softmax runs in float on a dequantized row */
+                for (j = 0; j < op->inner; j++)
+                    ((float *)scratch)[j] = dequantize_s8(
+                        in_q[i + j], in_t->scale, in_t->zero_point);
+                softmax_row((float *)scratch, op->inner);
+                for (j = 0; j < op->inner; j++)
+                    out_q[i + j] =
+                        quantize_f32(((float *)scratch)[j], out_t->scale,
+                                     out_t->zero_point);
+            }
+            return;
+
+        default:
+            if (in_t->type == CPU_INT8) {
+                for (i = 0; i < n; i++)
+                    out_q[i] = op->lut[(int32_t)in_q[i] + 128];
+                return;
+            }
+            if (op->opcode == OP_RELU || op->opcode == OP_RELU6) {
+                float max = op->opcode == OP_RELU6 ? 6 : FLT_MAX;
+                for (i = 0; i < n; i++)
+                    out_f[i] = clamp_f32(in_f[i], 0, max);
+                return;
+            }
+            for (i = 0; i < n; i++)
+                out_f[i] = apply_unary(op->opcode, in_f[i]);
+            return;
+    }
+}
+
+/* Utils */
+
+static wasi_nn_error
+initialize_g(CpuContext *cpu_ctx, graph *g)
+{
+    os_mutex_lock(&cpu_ctx->g_lock);
+    if (cpu_ctx->current_graphs == MAX_GRAPHS_PER_INST) {
+        os_mutex_unlock(&cpu_ctx->g_lock);
+        NN_ERR_PRINTF("Excedded max graphs per WASM instance");
+        return runtime_error;
+    }
+    *g = cpu_ctx->current_graphs++;
+    os_mutex_unlock(&cpu_ctx->g_lock);
+    return success;
+}
+
+static wasi_nn_error
+initialize_graph_ctx(CpuContext *cpu_ctx, graph_execution_context *ctx)
+{
+    os_mutex_lock(&cpu_ctx->g_lock);
+    if (cpu_ctx->current_exec_ctxs == MAX_GRAPH_EXEC_CONTEXTS_PER_INST) {
+        os_mutex_unlock(&cpu_ctx->g_lock);
+        NN_ERR_PRINTF("Excedded max graph execution context per WASM instance");
+        return runtime_error;
+    }
+    *ctx = cpu_ctx->current_exec_ctxs++;
+    os_mutex_unlock(&cpu_ctx->g_lock);
+    return success;
+}
+
+static wasi_nn_error
+is_valid_graph(CpuContext *cpu_ctx, graph g)
+{
+    if (g >= MAX_GRAPHS_PER_INST) {
+        NN_ERR_PRINTF("Invalid graph: %d >= %d.", g, MAX_GRAPHS_PER_INST);
+        return runtime_error;
+    }
+    if (cpu_ctx->graphs[g].buf == NULL) {
+        NN_ERR_PRINTF("Context (graph) non-initialized.");
+        return runtime_error;
+    }
+    return success;
+}
+
+static wasi_nn_error
+is_valid_graph_execution_context(CpuContext *cpu_ctx,
+                                 graph_execution_context ctx)
+{
+    if (ctx >= MAX_GRAPH_EXEC_CONTEXTS_PER_INST) {
+        NN_ERR_PRINTF("Invalid graph execution context: %d >= %d", ctx,
+                      MAX_GRAPH_EXEC_CONTEXTS_PER_INST);
+        return runtime_error;
+    }
+    if (!cpu_ctx->exec_ctxs[ctx].is_initialized) {
+        NN_ERR_PRINTF("Context (execution context) non-initialized.");
+        return runtime_error;
+    }
+    return success;
+}
+
+static void
+destroy_exec_context(CpuContext *cpu_ctx, CpuExecContext *exec_ctx)
+{
+    CpuGraph *model = cpu_ctx->graphs + exec_ctx->g;
+    uint32_t i;
+
+    if (exec_ctx->buffers) {
+        for (i = 0; i < model->tensor_count; i++) {
+            if (exec_ctx->buffers[i])
+                wasm_runtime_free(exec_ctx->buffers[i]);
+        }
+        wasm_runtime_free(exec_ctx->buffers);
+    }
+    if (exec_ctx->data)
+        wasm_runtime_free(exec_ctx->data);
+    if (exec_ctx->scratch)
+        wasm_runtime_free(exec_ctx->scratch);
+    if (exec_ctx->inputs)
+        wasm_runtime_free(exec_ctx->inputs);
+    if (exec_ctx->outputs)
+        wasm_runtime_free(exec_ctx->outputs);
+    memset(exec_ctx, 0, sizeof(CpuExecContext));
+}
+
+/* WASI-NN (cpu) implementation */
+
+wasi_nn_error
+wasi_nn_cpu_load(void *ctx, graph_builder_array *builder,
+                 graph_encoding encoding, execution_target target, graph *g)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    uint8_t *buf;
+    uint32_t size;
+    wasi_nn_error res;
+
+    if (builder->size != 1) {
+        NN_ERR_PRINTF("Unexpected builder format.");
+        return invalid_argument;
+    }
+
+    if (encoding != wamr_cpu && encoding != autodetect) {
+        NN_ERR_PRINTF("Encoding is not wamr_cpu.");
+        return invalid_argument;
+    }
+
+    if (target != cpu) {
+        NN_ERR_PRINTF("Only CPU target is supported.");
+        return invalid_argument;
+    }
+
+    size = builder->buf[0].size;
+    if (size == 0) {
+        NN_ERR_PRINTF("Empty graph.");
+        return invalid_argument;
+    }
+
+    if (success != (res = initialize_g(cpu_ctx, g)))
+        return res;
+
+    /* Keep a copy, the constant tensors point into it */
+    buf = wasm_runtime_malloc(size);
+    if (buf == NULL) {
+        NN_ERR_PRINTF("Error when allocating memory for graph.");
+        return too_large;
+    }
+    bh_memcpy_s(buf, size, builder->buf[0].buf, size);
+
+    return parse_graph(cpu_ctx->graphs + *g, buf, size);
+}
+
+wasi_nn_error
+wasi_nn_cpu_load_by_name(void *ctx, const char *filename,
+                         uint32_t filename_len, graph *g)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    FILE *file;
+    long file_size;
+    uint8_t *buf = NULL;
+    wasi_nn_error res;
+
+    if (success != (res = initialize_g(cpu_ctx, g)))
+        return res;
+
+    file = fopen(filename, "rb");
+    if (!file) {
+        NN_ERR_PRINTF("Cannot open %s.", filename);
+        return not_found;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0 || (file_size = ftell(file)) <= 0
+        || file_size > UINT32_MAX || fseek(file, 0, SEEK_SET) != 0) {
+        NN_ERR_PRINTF("Cannot get the size of %s.", filename);
+        fclose(file);
+        return invalid_argument;
+    }
+
+    buf = wasm_runtime_malloc((uint32_t)file_size);
+    if (!buf) {
+        NN_ERR_PRINTF("Error when allocating memory for graph.");
+        fclose(file);
+        return too_large;
+    }
+
+    if (fread(buf, 1, (size_t)file_size, file) != (size_t)file_size) {
+        NN_ERR_PRINTF("Error when reading %s.", filename);
+        wasm_runtime_free(buf);
+        fclose(file);
+        return runtime_error;
+    }
+    fclose(file);
+
+    return parse_graph(cpu_ctx->graphs + *g, buf, (uint32_t)file_size);
+}
+
+wasi_nn_error
+wasi_nn_cpu_init_execution_context(void *ctx, graph g,
+                                   graph_execution_context *exec_ctx)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    CpuGraph *model;
+    CpuExecContext *context;
+    uint32_t i, size;
+    wasi_nn_error res;
+
+    if (success != (res = is_valid_graph(cpu_ctx, g)))
+        return res;
+
+    if (success != (res = initialize_graph_ctx(cpu_ctx, exec_ctx)))
+        return res;
+
+    model = cpu_ctx->graphs + g;
+    context = cpu_ctx->exec_ctxs + *exec_ctx;
+    context->g = g;
+
+    size = sizeof(uint8_t *) * model->tensor_count;
+    if (!(context->data = wasm_runtime_malloc(size))
+        || !(context->buffers = wasm_runtime_malloc(size)))
+        goto fail;
+    memset(context->data, 0, size);
+    memset(context->buffers, 0, size);
+
+    for (i = 0; i < model->tensor_count; i++) {
+        const CpuTensor *info = model->tensors + i;
+
+        if (info->data) {
+            context->data[i] = (uint8_t *)info->data;
+            continue;
+        }
+        size = info->elems * tensor_elem_size(info->type);
+        if (!(context->buffers[i] = wasm_runtime_malloc(size)))
+            goto fail;
+        /* Tensors nobody writes read as zero instead of garbage */
+        memset(context->buffers[i], 0, size);
+        context->data[i] = context->buffers[i];
+    }
+
+    if (model->scratch_size
+        && !(context->scratch = wasm_runtime_malloc(model->scratch_size)))
+        goto fail;
+
+    size = sizeof(CpuBinding) * model->input_count;
+    if (!(context->inputs = wasm_runtime_malloc(size)))
+        goto fail;
+    memset(context->inputs, 0, size);
+    size = sizeof(CpuBinding) * model->output_count;
+    if (!(context->outputs = wasm_runtime_malloc(size)))
+        goto fail;
+    memset(context->outputs, 0, size);
+
+    context->is_initialized = true;
+    return success;
+fail:
+    NN_ERR_PRINTF("Error when allocating memory for execution context.");
+    destroy_exec_context(cpu_ctx, context);
+    return too_large;
+}
+
+/* Checks a tensor given for an input, tells whether it holds f32 values */
+static wasi_nn_error
+check_input_tensor(const CpuTensor *model_tensor, const tensor *input_tensor,
+                   bool *is_f32)
+{
+    uint32_t input_tensor_size = 1, i;
+
+    for (i = 0; i < input_tensor->dimensions->size; i++)
+        input_tensor_size *= input_tensor->dimensions->buf[i];
+    if (input_tensor_size != model_tensor->elems) {
+        NN_ERR_PRINTF("Input tensor shape from the model is different than the "
+                      "one provided");
+        return invalid_argument;
+    }
+
+    /* int8 tensors also take values already quantized with the parameters
+       of the model */
+    if (input_tensor->type == fp32)
+        *is_f32 = true;
+    else if (input_tensor->type == TENSOR_TYPE_RAW_INT8
+             && model_tensor->type == CPU_INT8)
+        *is_f32 = false;
+    else {
+        NN_ERR_PRINTF("Unsupported input tensor type %d.", input_tensor->type);
+        return invalid_argument;
+    }
+    return success;
+}
+
+static void
+write_input(const CpuTensor *info, uint8_t *dst, const uint8_t *src,
+            bool is_f32)
+{
+    uint32_t i;
+
+    if (is_f32 && info->type == CPU_INT8) {
+        for (i = 0; i < info->elems; i++)
+            ((int8_t *)dst)[i] = quantize_f32(((const float *)src)[i],
+                                              info->scale,
+                                              info->zero_point);
+        return;
+    }
+    bh_memcpy_s(dst, info->elems * tensor_elem_size(info->type), src,
+                info->elems * tensor_elem_size(info->type));
+}
+
+/* Outputs are always handed back as f32, like the tflite backend */
+static void
+read_output(const CpuTensor *info, float *dst, const uint8_t *src)
+{
+    uint32_t i;
+
+    if (info->type == CPU_F32) {
+        bh_memcpy_s(dst, info->elems * sizeof(float), src,
+                    info->elems * sizeof(float));
+        return;
+    }
+    for (i = 0; i < info->elems; i++)
+        dst[i] = dequantize_s8(((const int8_t *)src)[i], info->scale,
+                               info->zero_point);
+}
+
+wasi_nn_error
+wasi_nn_cpu_set_input(void *ctx, graph_execution_context exec_ctx,
+                      uint32_t index, tensor *input_tensor)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    CpuExecContext *context;
+    CpuGraph *model;
+    bool is_f32;
+    wasi_nn_error res;
+
+    if (success != (res = is_valid_graph_execution_context(cpu_ctx, exec_ctx)))
+        return res;
+
+    context = cpu_ctx->exec_ctxs + exec_ctx;
+    model = cpu_ctx->graphs + context->g;
+    if (index >= model->input_count) {
+        NN_ERR_PRINTF("Index %d is invalid.", index);
+        return runtime_error;
+    }
+
+    if (success
+        != (res = check_input_tensor(model->tensors + model->inputs[index],
+                                     input_tensor, &is_f32)))
+        return res;
+
+    write_input(model->tensors + model->inputs[index],
+                context->data[model->inputs[index]], input_tensor->data,
+                is_f32);
+    return success;
+}
+
+wasi_nn_error
+wasi_nn_cpu_compute(void *ctx, graph_execution_context exec_ctx)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    CpuExecContext *context;
+    const CpuGraph *model;
+    uint32_t i;
+    wasi_nn_error res;
+
+    if (success != (res = is_valid_graph_execution_context(cpu_ctx, exec_ctx)))
+        return res;
+
+    context = cpu_ctx->exec_ctxs + exec_ctx;
+    model = cpu_ctx->graphs + context->g;
+
+    /* Bound inputs that cannot be used in place */
+    for (i = 0; i < model->input_count; i++) {
+        const CpuBinding *binding = context->inputs + i;
+        uint32_t t = model->inputs[i];
+        if (binding->data && !binding->in_place)
+            write_input(model->tensors + t, context->data[t], binding->data,
+                        binding->is_f32);
+    }
+
+    for (i = 0; i < model->op_count; i++) {
+        const CpuOp *op = model->ops + i;
+
+        switch (op->opcode) {
+            case OP_DENSE:
+                run_dense(model, op, context->data);
+                break;
+            case OP_CONV2D:
+                run_conv2d(model, op, context->data, context->scratch);
+                break;
+            case OP_DEPTHWISE_CONV2D:
+                run_depthwise_conv2d(model, op, context->data,
+                                     context->scratch);
+                break;
+            case OP_MAX_POOL2D:
+            case OP_AVG_POOL2D:
+                run_pool2d(model, op, context->data, context->scratch);
+                break;
+            default:
+                run_elementwise(model, op, context->data, context->scratch);
+                break;
+        }
+    }
+
+    for (i = 0; i < model->output_count; i++) {
+        const CpuBinding *binding = context->outputs + i;
+        uint32_t t = model->outputs[i];
+        if (binding->data && !binding->in_place)
+            read_output(model->tensors + t, (float *)binding->data,
+                        context->data[t]);
+    }
+    return success;
+}
+
+wasi_nn_error
+wasi_nn_cpu_get_output(void *ctx, graph_execution_context exec_ctx,
+                       uint32_t index, tensor_data output_tensor,
+                       uint32_t *output_tensor_size)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    CpuExecContext *context;
+    const CpuGraph *model;
+    const CpuTensor *info;
+    wasi_nn_error res;
+
+    if (success != (res = is_valid_graph_execution_context(cpu_ctx, exec_ctx)))
+        return res;
+
+    context = cpu_ctx->exec_ctxs + exec_ctx;
+    model = cpu_ctx->graphs + context->g;
+    if (index >= model->output_count) {
+        NN_ERR_PRINTF("Index %d is invalid.", index);
+        return runtime_error;
+    }
+    info = model->tensors + model->outputs[index];
+
+    if (*output_tensor_size < info->elems) {
+        NN_ERR_PRINTF("Insufficient memory to copy tensor %d", index);
+        return too_large;
+    }
+
+    read_output(info, (float *)output_tensor,
+                context->data[model->outputs[index]]);
+    *output_tensor_size = info->elems;
+    return success;
+}
+
+/*
+ * Points the tensor at the caller's region when the layouts match, so that
+ * compute() reads or writes it directly. The scalar kernels access f32
+ * data through float pointers, hence the alignment requirement.
+ */
+static void
+bind_tensor(CpuExecContext *context, const CpuTensor *info, uint32_t t,
+            CpuBinding *binding, tensor_data data, bool same_layout)
+{
+    bool aligned = info->type == CPU_INT8 || ((uintptr_t)data & 3) == 0;
+
+    binding->data = data;
+    binding->in_place = data && same_layout && aligned;
+    context->data[t] = binding->in_place ? data : context->buffers[t];
+}
+
+wasi_nn_error
+wasi_nn_cpu_bind_input(void *ctx, graph_execution_context exec_ctx,
+                       uint32_t index, tensor *input_tensor)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    CpuExecContext *context;
+    CpuGraph *model;
+    const CpuTensor *info;
+    bool is_f32 = false;
+    wasi_nn_error res;
+
+    if (success != (res = is_valid_graph_execution_context(cpu_ctx, exec_ctx)))
+        return res;
+
+    context = cpu_ctx->exec_ctxs + exec_ctx;
+    model = cpu_ctx->graphs + context->g;
+    if (index >= model->input_count) {
+        NN_ERR_PRINTF("Index %d is invalid.", index);
+        return runtime_error;
+    }
+    info = model->tensors + model->inputs[index];
+
+    if (input_tensor->data
+        && success
+               != (res = check_input_tensor(info, input_tensor, &is_f32)))
+        return res;
+
+    context->inputs[index].is_f32 = is_f32;
+    bind_tensor(context, info, model->inputs[index], context->inputs + index,
+                input_tensor->data, is_f32 == (info->type == CPU_F32));
+    return success;
+}
+
+wasi_nn_error
+wasi_nn_cpu_bind_output(void *ctx, graph_execution_context exec_ctx,
+                        uint32_t index, tensor_data output_tensor,
+                        uint32_t output_tensor_size)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    CpuExecContext *context;
+    CpuGraph *model;
+    const CpuTensor *info;
+    wasi_nn_error res;
+
+    if (success != (res = is_valid_graph_execution_context(cpu_ctx, exec_ctx)))
+        return res;
+
+    context = cpu_ctx->exec_ctxs + exec_ctx;
+    model = cpu_ctx->graphs + context->g;
+    if (index >= model->output_count) {
+        NN_ERR_PRINTF("Index %d is invalid.", index);
+        return runtime_error;
+    }
+    info = model->tensors + model->outputs[index];
+
+    /* Size in bytes, outputs are f32 */
+    if (output_tensor
+        && output_tensor_size / sizeof(float) < info->elems) {
+        NN_ERR_PRINTF("Insufficient memory to bind tensor %d", index);
+        return too_large;
+    }
+
+    bind_tensor(context, info, model->outputs[index],
+                context->outputs + index, output_tensor,
+                info->type == CPU_F32);
+    return success;
+}
+
+wasi_nn_error
+wasi_nn_cpu_init_backend(void **ctx)
+{
+    CpuContext *cpu_ctx = wasm_runtime_malloc(sizeof(CpuContext));
+
+    if (cpu_ctx == NULL) {
+        NN_ERR_PRINTF("Error when allocating memory for cpu backend.");
+        return runtime_error;
+    }
+    memset(cpu_ctx, 0, sizeof(CpuContext));
+
+    if (os_mutex_init(&cpu_ctx->g_lock) != 0) {
+        NN_ERR_PRINTF("Error while initializing the lock");
+        wasm_runtime_free(cpu_ctx);
+        return runtime_error;
+    }
+
+    *ctx = (void *)cpu_ctx;
+    return success;
+}
+
+wasi_nn_error
+wasi_nn_cpu_deinit_backend(void *ctx)
+{
+    CpuContext *cpu_ctx = (CpuContext *)ctx;
+    uint32_t i;
+
+    if (!cpu_ctx)
+        return invalid_argument;
+
+    /* Execution contexts refer to their graph, release them first */
+    for (i = 0; i < MAX_GRAPH_EXEC_CONTEXTS_PER_INST; i++) {
+        if (cpu_ctx->exec_ctxs[i].is_initialized)
+            destroy_exec_context(cpu_ctx, cpu_ctx->exec_ctxs + i);
+    }
+    for (i = 0; i < MAX_GRAPHS_PER_INST; i++)
+        destroy_graph(cpu_ctx->graphs + i);
+
+    os_mutex_destroy(&cpu_ctx->g_lock);
+    wasm_runtime_free(cpu_ctx);
+    return success;
+}
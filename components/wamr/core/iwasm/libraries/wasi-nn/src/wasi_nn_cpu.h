@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef WASI_NN_CPU_H
+#define WASI_NN_CPU_H
+
+#include "wasi_nn_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Built-in CPU backend. Unlike the other backends it is compiled into the
+ * runtime itself and registered without dlopen(), so the entries are
+ * prefixed to stay out of the way of the shared library symbols.
+ *
+ * The graph format it consumes is described in wasi_nn_cpu.c and in the
+ * wasi-nn README.
+ */
+
+wasi_nn_error
+wasi_nn_cpu_load(void *ctx, graph_builder_array *builder,
+                 graph_encoding encoding, execution_target target, graph *g);
+
+wasi_nn_error
+wasi_nn_cpu_load_by_name(void *ctx, const char *filename,
+                         uint32_t filename_len, graph *g);
+
+wasi_nn_error
+wasi_nn_cpu_init_execution_context(void *ctx, graph g,
+                                   graph_execution_context *exec_ctx);
+
+wasi_nn_error
+wasi_nn_cpu_set_input(void *ctx, graph_execution_context exec_ctx,
+                      uint32_t index, tensor *input_tensor);
+
+wasi_nn_error
+wasi_nn_cpu_compute(void *ctx, graph_execution_context exec_ctx);
+
+wasi_nn_error
+wasi_nn_cpu_get_output(void *ctx, graph_execution_context exec_ctx,
+                       uint32_t index, tensor_data output_tensor,
+                       uint32_t *output_tensor_size);
+
+wasi_nn_error
+wasi_nn_cpu_bind_input(void *ctx, graph_execution_context exec_ctx,
+                       uint32_t index, tensor *input_tensor);
+
+wasi_nn_error
+wasi_nn_cpu_bind_output(void *ctx, graph_execution_context exec_ctx,
+                        uint32_t index, tensor_data output_tensor,
+                        uint32_t output_tensor_size);
+
+wasi_nn_error
+wasi_nn_cpu_init_backend(void **ctx);
+
+wasi_nn_error
+wasi_nn_cpu_deinit_backend(void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WASI_NN_CPU_H */
@@ -9,10 +9,34 @@
 #include "wasi_nn_types.h"
 #include "wasm_export.h"
 
+/* Maximum number of input/output bindings per WASM instance */
+#define WASI_NN_MAX_BINDINGS 16
+/* Maximum rank of a bound input tensor */
+#define WASI_NN_MAX_BINDING_RANK 8
+
+/* An input or output bound once to a fixed region of the linear memory */
+typedef struct {
+    bool is_output;
+    graph_execution_context ctx;
+    uint32_t index;
+    /* Kept as an offset so that the region can be found again after the
+       linear memory moved */
+    uint64_t data_offset;
+    /* Output buffer size in bytes */
+    uint32_t data_size;
+    uint32_t dims[WASI_NN_MAX_BINDING_RANK];
+    tensor_dimensions dimensions;
+    tensor tensor;
+} WASINNBinding;
+
 typedef struct {
     bool is_model_loaded;
     graph_encoding backend;
     void *backend_ctx;
+    uint32_t binding_count;
+    WASINNBinding bindings[WASI_NN_MAX_BINDINGS];
+    /* Linear memory base the bindings were resolved against */
+    void *binding_memory_base;
 } WASINNContext;
 
 #endif
@@ -230,6 +230,14 @@ unlink_hmu(gc_heap_t *heap, hmu_t *hmu)
     return true;
 }
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+bool
+gci_unlink_hmu(gc_heap_t *heap, hmu_t *hmu)
+{
+    return unlink_hmu(heap, hmu);
+}
+#endif
+
 static void
 hmu_set_free_size(hmu_t *hmu)
 {
@@ -481,33 +489,139 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
 }
 
 #if WASM_ENABLE_GC != 0
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+/* Add a GC pause which began at @start to the statistics of the heap */
+static void
+record_gc_pause(gc_heap_t *heap, uint64 start)
+{
+    uint64 time = os_time_get_boot_us() - start;
+    uint32 i;
+
+    heap->total_gc_time += time;
+    if (time > heap->max_gc_time) {
+        heap->max_gc_time = time;
+    }
+    heap->total_gc_count += 1;
+
+    /* bucket i counts the pauses in [2^(i-1), 2^i) us */
+    for (i = 0; i < GC_PAUSE_HISTOGRAM_SIZE - 1 && (time >> i) > 0; i++)
+        ;
+    heap->gc_pause_histogram[i]++;
+}
+#endif
+
+/**
+ * Do GC on given heap
+ *
+ * @param heap should not be NULL and should be a valid heap
+ * @param finish whether to finish the collection cycle if the heap is
+ *        collected incrementally, otherwise only one slice is done
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
 static int
-do_gc_heap(gc_heap_t *heap)
+do_gc_heap(gc_heap_t *heap, bool finish)
 {
     int ret = GC_SUCCESS;
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
-    uint64 start = 0, end = 0, time = 0;
-
-    start = os_time_get_boot_microsecond();
+    uint64 start = os_time_get_boot_us();
 #endif
     if (heap->is_reclaim_enabled) {
         UNLOCK_HEAP(heap);
-        ret = gci_gc_heap(heap);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+        if (heap->is_incremental)
+            ret = gci_gc_heap_slice(heap, finish);
+        else
+#endif
+            ret = gci_gc_heap(heap);
         LOCK_HEAP(heap);
     }
 #if WASM_ENABLE_GC_PERF_PROFILING != 0
-    end = os_time_get_boot_microsecond();
-    time = end - start;
-    heap->total_gc_time += time;
-    if (time > heap->max_gc_time) {
-        heap->max_gc_time = time;
+    record_gc_pause(heap, start);
+#endif
+    (void)finish;
+    return ret;
+}
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/**
+ * Do a minor collection of the heap, the young objects are promoted
+ * without being collected if the heap can't be reclaimed
+ *
+ * @param heap should not be NULL and should be a valid heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+do_gc_nursery(gc_heap_t *heap)
+{
+    int ret = GC_SUCCESS;
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    uint64 start = os_time_get_boot_us();
+#endif
+    if (heap->is_reclaim_enabled) {
+        UNLOCK_HEAP(heap);
+        ret = gci_gc_nursery(heap);
+        LOCK_HEAP(heap);
     }
-    heap->total_gc_count += 1;
+    /* promote the young objects if the collection isn't done */
+    gci_retire_nursery(heap);
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    record_gc_pause(heap, start);
 #endif
     return ret;
 }
 #endif
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/**
+ * Find a proper HMU with given size from a heap which is collected
+ * incrementally: a cycle is begun when the free size drops below the
+ * threshold, and one slice of it is done every
+ * GC_INCREMENTAL_SLICE_ALLOC_SIZE bytes allocated, the cycle is only
+ * finished at once if the allocation fails.
+ *
+ * @return hmu allocated if success, which will be aligned to 8 bytes,
+ *         NULL otherwise
+ */
+static hmu_t *
+alloc_hmu_incremental(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *ret = NULL;
+
+    if (heap->gc_phase != GC_PHASE_IDLE) {
+        heap->slice_alloc_size += size;
+        if (heap->slice_alloc_size >= GC_INCREMENTAL_SLICE_ALLOC_SIZE) {
+            heap->slice_alloc_size = 0;
+            if (GC_SUCCESS != do_gc_heap(heap, false))
+                return NULL;
+        }
+    }
+    else if (heap->total_free_size < heap->gc_threshold) {
+        heap->slice_alloc_size = 0;
+        if (GC_SUCCESS != do_gc_heap(heap, false))
+            return NULL;
+    }
+
+    if ((ret = alloc_hmu(heap, size)))
+        return ret;
+
+    /* out of memory: finish the cycle in progress, and do a whole new
+       cycle if the garbage found by it isn't enough */
+    if (heap->gc_phase != GC_PHASE_IDLE) {
+        if (GC_SUCCESS != do_gc_heap(heap, true))
+            return NULL;
+        if ((ret = alloc_hmu(heap, size)))
+            return ret;
+    }
+
+    if (GC_SUCCESS != do_gc_heap(heap, true))
+        return NULL;
+    return alloc_hmu(heap, size);
+}
+#endif
+#endif
+
 /**
  * Find a proper HMU with given size
  *
@@ -531,11 +645,15 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 
 #if WASM_ENABLE_GC != 0
 #if GC_IN_EVERY_ALLOCATION != 0
-    if (GC_SUCCESS != do_gc_heap(heap))
+    if (GC_SUCCESS != do_gc_heap(heap, true))
         return NULL;
 #else
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (heap->is_incremental)
+        return alloc_hmu_incremental(heap, size);
+#endif
     if (heap->total_free_size < heap->gc_threshold) {
-        if (GC_SUCCESS != do_gc_heap(heap))
+        if (GC_SUCCESS != do_gc_heap(heap, true))
             return NULL;
     }
     else {
@@ -543,7 +661,7 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
         if ((ret = alloc_hmu(heap, size))) {
             return ret;
         }
-        if (GC_SUCCESS != do_gc_heap(heap))
+        if (GC_SUCCESS != do_gc_heap(heap, true))
             return NULL;
     }
 #endif
@@ -552,6 +670,134 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
     return alloc_hmu(heap, size);
 }
 
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/**
+ * Create a new nursery from a free chunk of the heap, its size is
+ * GC_NURSERY_SIZE at most, and it is halved until the chunk is found.
+ *
+ * @param heap should not be NULL and should be a valid heap without
+ *        nursery
+ *
+ * @return true if success, false otherwise
+ */
+static bool
+create_nursery(gc_heap_t *heap)
+{
+    gc_size_t size = GC_NURSERY_SIZE;
+    hmu_t *hmu = NULL;
+    bool pinuse;
+
+    bh_assert(!heap->nursery_start);
+
+    /* leave the heap to the full collection if it is nearly full */
+    if (heap->total_free_size < heap->gc_threshold)
+        return false;
+
+    if (size > heap->current_size / 8)
+        size = heap->current_size / 8;
+
+    for (size &= ~(gc_size_t)7; size >= GC_NURSERY_MIN_SIZE;
+         size = (size / 2) & ~(gc_size_t)7) {
+        if ((hmu = alloc_hmu(heap, size)))
+            break;
+    }
+    if (!hmu)
+        return false;
+
+    /* the free part of the nursery is a HMU_FM block, which isn't
+       merged by gc_free_vo and gc_realloc_vo */
+    size = hmu_get_size(hmu);
+    pinuse = hmu_get_pinuse(hmu) ? true : false;
+    hmu->header = 0;
+    hmu_set_ut(hmu, HMU_FM);
+    hmu_set_size(hmu, size);
+    if (pinuse)
+        hmu_mark_pinuse(hmu);
+
+    heap->nursery_start = heap->nursery_free = (gc_uint8 *)hmu;
+    heap->nursery_end = (gc_uint8 *)hmu + size;
+
+    if (!heap->is_nursery_registered)
+        gci_add_nursery_heap(heap);
+    return true;
+}
+
+/**
+ * Allocate a HMU of given size by bumping the free pointer of the nursery
+ *
+ * @return hmu allocated if success, NULL if the nursery is full
+ */
+static hmu_t *
+bump_alloc_hmu(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *hmu = (hmu_t *)heap->nursery_free, *rest;
+    gc_size_t left;
+
+    if (!heap->nursery_start)
+        return NULL;
+
+    left = (gc_size_t)(heap->nursery_end - heap->nursery_free);
+    if (left < size)
+        return NULL;
+
+    if (left - size < GC_SMALLEST_SIZE) {
+        size = left;
+    }
+    else {
+        rest = (hmu_t *)((gc_uint8 *)hmu + size);
+        rest->header = 0;
+        hmu_set_ut(rest, HMU_FM);
+        hmu_set_size(rest, left - size);
+        hmu_mark_pinuse(rest);
+    }
+
+    hmu_set_size(hmu, size);
+    heap->nursery_free += size;
+    return hmu;
+}
+
+/**
+ * Find a proper HMU with given size in the nursery: a minor collection
+ * is done when the nursery is full, and the objects are allocated in
+ * the old space if no nursery can be created.
+ *
+ * @return hmu allocated if success, which will be aligned to 8 bytes,
+ *         NULL otherwise
+ */
+static hmu_t *
+alloc_hmu_nursery(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *ret;
+
+    if (size < GC_SMALLEST_SIZE)
+        size = GC_SMALLEST_SIZE;
+
+    if ((ret = bump_alloc_hmu(heap, size)))
+        return ret;
+
+    if (heap->nursery_start) {
+        /* the nursery is full, the old objects which weren't remembered
+           may refer to the young objects if the remembered set
+           overflowed, only a full collection can find them */
+        if (heap->is_remset_overflowed) {
+            if (GC_SUCCESS != do_gc_heap(heap, true))
+                return NULL;
+            /* the heap may not be reclaimed */
+            gci_retire_nursery(heap);
+        }
+        else {
+            if (GC_SUCCESS != do_gc_nursery(heap))
+                return NULL;
+        }
+    }
+
+    if (create_nursery(heap) && (ret = bump_alloc_hmu(heap, size)))
+        return ret;
+
+    return alloc_hmu_ex(heap, size);
+}
+#endif
+
 #if BH_ENABLE_GC_VERIFY == 0
 gc_object_t
 gc_alloc_vo(void *vheap, gc_size_t size)
@@ -669,6 +915,9 @@ gc_realloc_vo_internal(void *vheap, void *ptr, gc_size_t size, const char *file,
                     return NULL;
                 }
                 hmu_set_size(hmu_old, tot_size);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+                gc_adjust_sweep_cursor(heap, hmu_old, tot_size);
+#endif
                 memset((char *)hmu_old + tot_size_old, 0,
                        tot_size - tot_size_old);
 #if BH_ENABLE_GC_VERIFY != 0
@@ -781,7 +1030,12 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
 
     LOCK_HEAP(heap);
 
-    hmu = alloc_hmu_ex(heap, tot_size);
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    if (heap->is_generational && tot_size <= GC_NURSERY_SIZE / 4)
+        hmu = alloc_hmu_nursery(heap, tot_size);
+    else
+#endif
+        hmu = alloc_hmu_ex(heap, tot_size);
     if (!hmu)
         goto finish;
 
@@ -802,6 +1056,10 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
     hmu_mark_wo(hmu);
 #else
     hmu_unmark_wo(hmu);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (gc_is_alloc_black(heap, hmu))
+        hmu_mark_wo(hmu);
+#endif
 #endif
 
 #if BH_ENABLE_GC_VERIFY != 0
@@ -813,6 +1071,17 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
         /* clear buffer appended by GC_ALIGN_8() */
         memset((uint8 *)ret + size, 0, tot_size - tot_size_unaligned);
 
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    hmu_unmark_wo_remembered(hmu);
+    if (gc_is_young(heap, hmu))
+        /* the stores into young objects needn't be recorded */
+        hmu_mark_wo_remembered(hmu);
+    else if (heap->nursery_start)
+        /* the fields of the object may be initialized with young
+           objects without the write barrier */
+        gci_remember_object(heap, ret);
+#endif
+
 finish:
     UNLOCK_HEAP(heap);
     return ret;
@@ -918,6 +1187,9 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
                 ret = GC_ERROR;
                 goto out;
             }
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+            gc_adjust_sweep_cursor(heap, hmu, size);
+#endif
 
             if (hmu_is_in_heap(next, base_addr, end_addr)) {
                 hmu_unmark_pinuse(next);
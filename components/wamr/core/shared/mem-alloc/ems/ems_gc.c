@@ -5,6 +5,9 @@
 
 #include "ems_gc.h"
 #include "ems_gc_internal.h"
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+#include "bh_atomic.h"
+#endif
 
 #define GB (1 << 30UL)
 
@@ -30,32 +33,88 @@ typedef struct mark_node_struct {
 /**
  * Alloc a mark node from the native heap
  *
+ * @param heap the heap which is being marked
+ *
  * @return a valid mark node if success, NULL otherwise
  */
 static mark_node_t *
-alloc_mark_node(void)
+alloc_mark_node(gc_heap_t *heap)
 {
-    mark_node_t *ret = (mark_node_t *)BH_MALLOC(sizeof(mark_node_t));
+    mark_node_t *ret = NULL;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* reuse the nodes freed by the previous slices of the cycle */
+    if ((ret = (mark_node_t *)heap->free_mark_nodes))
+        heap->free_mark_nodes = ret->next;
+#endif
 
-    if (!ret) {
+    if (!ret && !(ret = (mark_node_t *)BH_MALLOC(sizeof(mark_node_t)))) {
         LOG_ERROR("alloc a new mark node failed");
         return NULL;
     }
     ret->cnt = sizeof(ret->set) / sizeof(ret->set[0]);
     ret->idx = 0;
     ret->next = NULL;
+    (void)heap;
     return ret;
 }
 
 /* Free a mark node to the native heap
  *
+ * @param heap the heap which is being marked
  * @param node the mark node to free, should not be NULL
  */
 static void
-free_mark_node(mark_node_t *node)
+free_mark_node(gc_heap_t *heap, mark_node_t *node)
 {
     bh_assert(node);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (heap->is_incremental) {
+        /* keep it for the next slices, it is freed when the
+           cycle ends */
+        node->next = (mark_node_t *)heap->free_mark_nodes;
+        heap->free_mark_nodes = node;
+        return;
+    }
+#endif
     BH_FREE((gc_object_t)node);
+    (void)heap;
+}
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* Free the mark nodes kept for the slices of the cycle */
+static void
+release_mark_nodes(gc_heap_t *heap)
+{
+    mark_node_t *node = (mark_node_t *)heap->free_mark_nodes, *next;
+
+    while (node) {
+        next = node->next;
+        BH_FREE((gc_object_t)node);
+        node = next;
+    }
+    heap->free_mark_nodes = NULL;
+}
+#endif
+
+/**
+ * Invoke the finalizer registered for a dead wo if there is one
+ *
+ * @param heap the heap which is being swept
+ * @param hmu the hmu of the dead wo
+ */
+static void
+call_wo_finalizer(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_object_t obj = hmu_to_obj(hmu);
+
+    if (gct_vm_get_extra_info_flag(obj)) {
+        extra_info_node_t *node =
+            gc_search_extra_info_node((gc_handle_t)heap, obj, NULL);
+        bh_assert(node);
+        node->finalizer(node->obj, node->data);
+        gc_unset_finalizer((gc_handle_t)heap, obj);
+    }
 }
 
 /**
@@ -101,14 +160,7 @@ sweep_instance_heap(gc_heap_t *heap)
 
             if (ut == HMU_WO) {
                 /* Invoke registered finalizer */
-                gc_object_t cur_obj = hmu_to_obj(cur);
-                if (gct_vm_get_extra_info_flag(cur_obj)) {
-                    extra_info_node_t *node = gc_search_extra_info_node(
-                        (gc_handle_t)heap, cur_obj, NULL);
-                    bh_assert(node);
-                    node->finalizer(node->obj, node->data);
-                    gc_unset_finalizer((gc_handle_t)heap, cur_obj);
-                }
+                call_wo_finalizer(heap, cur);
             }
         }
         else {
@@ -172,12 +224,17 @@ add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
               && (gc_uint8 *)hmu < heap->base_addr + heap->current_size);
     bh_assert(hmu_get_ut(hmu) == HMU_WO);
 
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    if (heap->is_minor_gc && !gc_is_young(heap, hmu))
+        return GC_SUCCESS; /* old objects are live in minor collection */
+#endif
+
     if (hmu_is_wo_marked(hmu))
         return GC_SUCCESS; /* already marked*/
 
     mark_node = (mark_node_t *)heap->root_set;
     if (!mark_node || mark_node->idx == mark_node->cnt) {
-        new_node = alloc_mark_node();
+        new_node = alloc_mark_node(heap);
         if (!new_node) {
             LOG_ERROR("can not add obj to mark node because of mark node "
                       "allocation failed");
@@ -250,7 +307,7 @@ rollback_mark(gc_heap_t *heap)
     mark_node = (mark_node_t *)heap->root_set;
     while (mark_node) {
         next_mark_node = mark_node->next;
-        free_mark_node(mark_node);
+        free_mark_node(heap, mark_node);
         mark_node = next_mark_node;
     }
 
@@ -275,6 +332,106 @@ rollback_mark(gc_heap_t *heap)
     bh_assert(cur == end);
 }
 
+/**
+ * Add the objects referenced by a marked wo to the to-expand list
+ *
+ * @param heap the heap which is being marked
+ * @param obj the wo to expand
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+mark_wo_refs(gc_heap_t *heap, gc_object_t obj)
+{
+    bool is_compact_mode = false;
+    gc_object_t ref = NULL;
+    gc_uint32 ref_num = 0, ref_start_offset = 0, size, offset, j;
+    gc_uint16 *ref_list = NULL;
+
+    size = hmu_get_size(obj_to_hmu(obj));
+
+    if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode, &ref_num,
+                                         &ref_list, &ref_start_offset)) {
+        LOG_ERROR("mark process failed because failed "
+                  "vm_get_wasm_object_ref_list");
+        return GC_ERROR;
+    }
+
+    if (ref_num >= 2U * GB) {
+        LOG_ERROR("Invalid ref_num returned");
+        return GC_ERROR;
+    }
+
+    for (j = 0; j < ref_num; j++) {
+        if (is_compact_mode)
+            offset = ref_start_offset + j * sizeof(void *);
+        else
+            offset = ref_list[j];
+        bh_assert(offset + sizeof(void *) < size);
+
+        ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
+        if (ref == NULL_REF || ((uintptr_t)ref & 1))
+            continue; /* null object or i31 object */
+        if (add_wo_to_expand(heap, ref) == GC_ERROR) {
+            LOG_ERROR("mark process failed");
+            return GC_ERROR;
+        }
+    }
+
+    (void)size;
+    return GC_SUCCESS;
+}
+
+/**
+ * Expand the to-expand list until all objects reachable from it are
+ * marked, the marking is rolled back if it fails
+ *
+ * @param heap the heap which is being marked
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+mark_to_expand_list(gc_heap_t *heap)
+{
+    mark_node_t *mark_node = NULL;
+    int idx = 0;
+
+    /* the algorithm we use to mark all objects */
+    /* 1. mark rootset and organize them into a mark_node list (last marked
+     * roots at list header, i.e. stack top) */
+    /* 2. in every iteration, we use the top node to expand*/
+    /* 3. execute step 2 till no expanding */
+    /* this is a BFS & DFS mixed algorithm, but more like DFS */
+    mark_node = (mark_node_t *)heap->root_set;
+    while (mark_node) {
+        heap->root_set = mark_node->next;
+
+        /* note that mark_node->idx may change in each loop */
+        for (idx = 0; idx < (int)mark_node->idx; idx++) {
+            if (mark_wo_refs(heap, mark_node->set[idx]) != GC_SUCCESS)
+                break;
+        }
+        if (idx < (int)mark_node->idx)
+            break; /* not yet done */
+
+        /* obj's in mark_node are all expanded */
+        free_mark_node(heap, mark_node);
+        mark_node = heap->root_set;
+    }
+
+    if (mark_node) {
+        LOG_ERROR("mark process is not successfully finished");
+
+        free_mark_node(heap, mark_node);
+        /* roll back is required */
+        rollback_mark(heap);
+
+        return GC_ERROR;
+    }
+
+    return GC_SUCCESS;
+}
+
 /**
  * Reclaim GC instance heap
  *
@@ -285,13 +442,13 @@ rollback_mark(gc_heap_t *heap)
 static int
 reclaim_instance_heap(gc_heap_t *heap)
 {
+    bool ret;
+#if BH_ENABLE_GC_VERIFY != 0
     mark_node_t *mark_node = NULL;
-    int idx = 0, j = 0;
-    bool ret, is_compact_mode = false;
-    gc_object_t obj = NULL, ref = NULL;
+    int idx = 0;
+    gc_object_t obj = NULL;
     hmu_t *hmu = NULL;
-    gc_uint32 ref_num = 0, ref_start_offset = 0, size = 0, offset = 0;
-    gc_uint16 *ref_list = NULL;
+#endif
 
     bh_assert(gci_is_heap_valid(heap));
 
@@ -345,109 +502,404 @@ reclaim_instance_heap(gc_heap_t *heap)
         return GC_ERROR;
     }
 
-    /* the algorithm we use to mark all objects */
-    /* 1. mark rootset and organize them into a mark_node list (last marked
-     * roots at list header, i.e. stack top) */
-    /* 2. in every iteration, we use the top node to expand*/
-    /* 3. execute step 2 till no expanding */
-    /* this is a BFS & DFS mixed algorithm, but more like DFS */
-    mark_node = (mark_node_t *)heap->root_set;
-    while (mark_node) {
-        heap->root_set = mark_node->next;
+    if (mark_to_expand_list(heap) != GC_SUCCESS)
+        return GC_ERROR;
 
-        /* note that mark_node->idx may change in each loop */
-        for (idx = 0; idx < (int)mark_node->idx; idx++) {
-            obj = mark_node->set[idx];
-            hmu = obj_to_hmu(obj);
-            size = hmu_get_size(hmu);
+    /* now sweep */
+    sweep_instance_heap(heap);
 
-            if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode,
-                                                 &ref_num, &ref_list,
-                                                 &ref_start_offset)) {
-                LOG_ERROR("mark process failed because failed "
-                          "vm_get_wasm_object_ref_list");
-                break;
-            }
+    return GC_SUCCESS;
+}
 
-            if (ref_num >= 2U * GB) {
-                LOG_ERROR("Invalid ref_num returned");
-                break;
-            }
+/**
+ * Do GC on given heap
+ *
+ * @param the heap to do GC, should be a valid heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gci_gc_heap(void *h)
+{
+    int ret = GC_ERROR;
+    gc_heap_t *heap = (gc_heap_t *)h;
 
-            if (is_compact_mode) {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_start_offset + j * sizeof(void *);
-                    bh_assert(offset + sizeof(void *) < size);
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("add_wo_to_expand failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
-            }
-            else {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_list[j];
-                    bh_assert(offset + sizeof(void *) < size);
-
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("mark process failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
-            }
+    bh_assert(gci_is_heap_valid(heap));
+
+    LOG_VERBOSE("#reclaim instance heap %p", heap);
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_prepare(NULL);
+
+    gct_vm_mutex_lock(&heap->lock);
+    heap->is_doing_reclaim = 1;
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    /* the full collection treats the young objects as old ones */
+    gci_retire_nursery(heap);
+#endif
+
+    ret = reclaim_instance_heap(heap);
+
+    heap->is_doing_reclaim = 0;
+    gct_vm_mutex_unlock(&heap->lock);
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_finished(NULL);
+
+    LOG_VERBOSE("#reclaim instance heap %p done", heap);
+
+#if BH_ENABLE_GC_VERIFY != 0
+    gci_verify_heap(heap);
+#endif
+
+#if GC_STAT_SHOW != 0
+    gc_show_stat(heap);
+    gc_show_fragment(heap);
+#endif
+
+    return ret;
+}
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* The heaps in marking phase, the write barrier searches the heap of
+   an object in them */
+static korp_mutex marking_heaps_lock;
+static gc_heap_t *marking_heaps;
+static bh_atomic_32_t marking_heap_count;
+
+static void
+add_marking_heap(gc_heap_t *heap)
+{
+    os_mutex_lock(&marking_heaps_lock);
+    heap->next_marking_heap = marking_heaps;
+    marking_heaps = heap;
+    BH_ATOMIC_32_FETCH_ADD(marking_heap_count, 1);
+    os_mutex_unlock(&marking_heaps_lock);
+}
+
+static void
+remove_marking_heap(gc_heap_t *heap)
+{
+    gc_heap_t **p_heap;
+
+    os_mutex_lock(&marking_heaps_lock);
+    for (p_heap = &marking_heaps; *p_heap;
+         p_heap = &(*p_heap)->next_marking_heap) {
+        if (*p_heap == heap) {
+            *p_heap = heap->next_marking_heap;
+            BH_ATOMIC_32_FETCH_SUB(marking_heap_count, 1);
+            break;
         }
-        if (idx < (int)mark_node->idx)
-            break; /* not yet done */
+    }
+    heap->next_marking_heap = NULL;
+    os_mutex_unlock(&marking_heaps_lock);
+}
 
-        /* obj's in mark_node are all expanded */
-        free_mark_node(mark_node);
-        mark_node = heap->root_set;
+int
+gc_incremental_init(void)
+{
+    if (os_mutex_init(&marking_heaps_lock) != BHT_OK) {
+        LOG_ERROR("[GC_ERROR]failed to init marking heaps lock\n");
+        return GC_ERROR;
     }
+    marking_heaps = NULL;
+    return GC_SUCCESS;
+}
 
-    if (mark_node) {
-        LOG_ERROR("mark process is not successfully finished");
+void
+gc_incremental_destroy(void)
+{
+    bh_assert(!marking_heaps);
+    os_mutex_destroy(&marking_heaps_lock);
+}
 
-        free_mark_node(mark_node);
-        /* roll back is required */
-        rollback_mark(heap);
+void
+gc_write_barrier(gc_object_t obj)
+{
+    gc_heap_t *heap;
+    hmu_t *hmu;
+
+    if (BH_ATOMIC_32_LOAD(marking_heap_count) == 0)
+        return;
+
+    hmu = obj_to_hmu(obj);
+
+    os_mutex_lock(&marking_heaps_lock);
+    for (heap = marking_heaps; heap; heap = heap->next_marking_heap) {
+        if ((gc_uint8 *)hmu >= heap->base_addr
+            && (gc_uint8 *)hmu < heap->base_addr + heap->current_size)
+            break;
+    }
+    os_mutex_unlock(&marking_heaps_lock);
+
+    if (!heap)
+        return;
+
+    /* shade the object gray, so that the objects reachable from it
+       when the marking began are still marked */
+    gct_vm_mutex_lock(&heap->lock);
+    if (heap->gc_phase == GC_PHASE_MARKING && hmu_get_ut(hmu) == HMU_WO
+        && !hmu_is_wo_marked(hmu)
+        && add_wo_to_expand(heap, obj) != GC_SUCCESS)
+        /* the cycle is rolled back by the next slice */
+        heap->is_fast_marking_failed = 1;
+    gct_vm_mutex_unlock(&heap->lock);
+}
+
+/**
+ * Stop the marking of the cycle in progress and unmark all objects
+ *
+ * @param heap the heap in marking phase
+ */
+static void
+abort_marking(gc_heap_t *heap)
+{
+    LOG_ERROR("all marked wos will be unmarked to keep heap consistency");
+
+    remove_marking_heap(heap);
+    rollback_mark(heap);
+    release_mark_nodes(heap);
+    heap->is_fast_marking_failed = 0;
+    heap->gc_phase = GC_PHASE_IDLE;
+}
+
+/**
+ * Begin a collection cycle: mark the rootset and turn on the write
+ * barrier, the objects reachable from the rootset are marked by the
+ * next slices.
+ *
+ * @param heap the heap to collect, there is no cycle in progress
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+begin_marking(gc_heap_t *heap)
+{
+    bool ret;
+
+    bh_assert(heap->gc_phase == GC_PHASE_IDLE);
+
+    heap->root_set = NULL;
+
+#if WASM_ENABLE_THREAD_MGR == 0
+    if (!heap->exec_env)
+        return GC_SUCCESS;
+    ret = gct_vm_begin_rootset_enumeration(heap->exec_env, heap);
+#else
+    if (!heap->cluster)
+        return GC_SUCCESS;
+    ret = gct_vm_begin_rootset_enumeration(heap->cluster, heap);
+#endif
 
+    if (!ret || heap->is_fast_marking_failed) {
+        LOG_ERROR("enumerate rootset failed");
+        LOG_ERROR("all marked wos will be unmarked to keep heap consistency");
+        rollback_mark(heap);
+        release_mark_nodes(heap);
+        heap->is_fast_marking_failed = 0;
         return GC_ERROR;
     }
 
-    /* now sweep */
-    sweep_instance_heap(heap);
+    heap->gc_phase = GC_PHASE_MARKING;
+    add_marking_heap(heap);
+    return GC_SUCCESS;
+}
 
-    (void)size;
+/**
+ * Expand at most @budget objects of the to-expand list, the sweeping
+ * begins once the list is empty.
+ *
+ * @param heap the heap in marking phase
+ * @param budget the max number of objects to expand
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+mark_slice(gc_heap_t *heap, gc_uint32 budget)
+{
+    mark_node_t *mark_node;
+    gc_object_t obj;
+
+    bh_assert(heap->gc_phase == GC_PHASE_MARKING);
+
+    while ((mark_node = (mark_node_t *)heap->root_set)) {
+        if (heap->is_fast_marking_failed)
+            break;
 
+        if (mark_node->idx == 0) {
+            heap->root_set = mark_node->next;
+            free_mark_node(heap, mark_node);
+            continue;
+        }
+
+        if (budget-- == 0)
+            return GC_SUCCESS;
+
+        /* pop the object before expanding it, its references are
+           pushed to the same node */
+        obj = mark_node->set[--mark_node->idx];
+        if (mark_wo_refs(heap, obj) != GC_SUCCESS) {
+            heap->is_fast_marking_failed = 1;
+            break;
+        }
+    }
+
+    if (heap->is_fast_marking_failed) {
+        LOG_ERROR("mark process is not successfully finished");
+        abort_marking(heap);
+        return GC_ERROR;
+    }
+
+    /* all reachable objects are marked, turn off the write barrier */
+    remove_marking_heap(heap);
+    heap->gc_phase = GC_PHASE_SWEEPING;
+    heap->sweep_cursor = (hmu_t *)heap->base_addr;
     return GC_SUCCESS;
 }
 
 /**
- * Do GC on given heap
+ * Add the free area [hmu, next) swept by a slice to KFC
  *
- * @param the heap to do GC, should be a valid heap
+ * @param heap the heap in sweeping phase
+ * @param hmu the first block of the free area
+ * @param next the block after the free area
+ * @param is_linked whether the area is a single free chunk which is
+ *        still linked in KFC
+ *
+ * @return true if success, false otherwise
+ */
+static bool
+add_swept_fc(gc_heap_t *heap, hmu_t *hmu, hmu_t *next, bool is_linked)
+{
+    if (!is_linked) {
+        if (!gci_add_fc(heap, hmu,
+                        (gc_size_t)((gc_uint8 *)next - (gc_uint8 *)hmu)))
+            return false;
+        hmu_mark_pinuse(hmu);
+    }
+
+    if ((gc_uint8 *)next < heap->base_addr + heap->current_size)
+        hmu_unmark_pinuse(next);
+    return true;
+}
+
+/**
+ * Sweep at most @budget blocks from the sweep cursor. Unlike
+ * sweep_instance_heap, KFC isn't rebuilt but updated in place, so that
+ * objects can still be allocated between the slices.
+ *
+ * @param heap the heap in sweeping phase
+ * @param budget the max number of blocks to sweep
  *
  * @return GC_SUCCESS if success, GC_ERROR otherwise
  */
+static int
+sweep_slice(gc_heap_t *heap, gc_uint32 budget)
+{
+    hmu_t *cur = heap->sweep_cursor, *last = NULL, *prev;
+    hmu_t *end = (hmu_t *)(heap->base_addr + heap->current_size);
+    hmu_type_t ut;
+    gc_size_t size, tot_freed = 0;
+    /* whether last is a single free chunk still linked in KFC */
+    bool last_linked = false;
+
+    bh_assert(heap->gc_phase == GC_PHASE_SWEEPING);
+
+    /* merge with the free chunk added before the cursor by the
+       previous slice */
+    if (cur < end && (gc_uint8 *)cur > heap->base_addr
+        && !hmu_get_pinuse(cur)) {
+        prev = (hmu_t *)((gc_uint8 *)cur - *((gc_uint32 *)cur - 1));
+        if ((gc_uint8 *)prev >= heap->base_addr && prev < cur
+            && hmu_get_ut(prev) == HMU_FC
+            && (hmu_t *)((gc_uint8 *)prev + hmu_get_size(prev)) == cur) {
+            last = prev;
+            last_linked = true;
+        }
+    }
+
+    while (cur < end && budget-- > 0) {
+        ut = hmu_get_ut(cur);
+        size = hmu_get_size(cur);
+        bh_assert(size > 0);
+
+        if (ut == HMU_FC || ut == HMU_FM
+            || (ut == HMU_VO && hmu_is_vo_freed(cur))
+            || (ut == HMU_WO && !hmu_is_wo_marked(cur))) {
+            if (ut == HMU_WO)
+                call_wo_finalizer(heap, cur);
+            if (ut != HMU_FC)
+                tot_freed += size;
+
+            if (!last) {
+                last = cur;
+                last_linked = ut == HMU_FC ? true : false;
+            }
+            else {
+                /* merge current block with the previous free area, the
+                   free chunks merged are removed from KFC */
+                if (last_linked && !gci_unlink_hmu(heap, last))
+                    return GC_ERROR;
+                if (ut == HMU_FC && !gci_unlink_hmu(heap, cur))
+                    return GC_ERROR;
+                last_linked = false;
+            }
+        }
+        else {
+            /* current block is still live */
+            if (last && !add_swept_fc(heap, last, cur, last_linked))
+                return GC_ERROR;
+            last = NULL;
+
+            if (ut == HMU_WO)
+                hmu_unmark_wo(cur);
+        }
+
+        cur = (hmu_t *)((char *)cur + size);
+    }
+
+    if (last && !add_swept_fc(heap, last, cur, last_linked))
+        return GC_ERROR;
+
+    heap->total_free_size += tot_freed;
+    heap->sweep_cursor = cur;
+
+    if (cur < end)
+        return GC_SUCCESS;
+
+    bh_assert(cur == end);
+
+    /* the cycle is done */
+    heap->gc_phase = GC_PHASE_IDLE;
+    heap->sweep_cursor = NULL;
+    release_mark_nodes(heap);
+
+#if GC_STAT_DATA != 0
+    heap->total_gc_count++;
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
+#endif
+    gc_update_threshold(heap);
+    return GC_SUCCESS;
+}
+
 int
-gci_gc_heap(void *h)
+gci_gc_heap_slice(void *h, bool finish)
 {
-    int ret = GC_ERROR;
+    int ret = GC_SUCCESS;
     gc_heap_t *heap = (gc_heap_t *)h;
+    gc_uint32 mark_budget = GC_INCREMENTAL_MARK_SLICE;
+    gc_uint32 sweep_budget = GC_INCREMENTAL_SWEEP_SLICE;
 
     bh_assert(gci_is_heap_valid(heap));
 
-    LOG_VERBOSE("#reclaim instance heap %p", heap);
+    LOG_VERBOSE("#reclaim instance heap %p incrementally", heap);
+
+    if (finish)
+        mark_budget = sweep_budget = UINT32_MAX;
 
     /* TODO: get exec_env of current thread when GC multi-threading
        is enabled, and pass it to runtime */
@@ -456,7 +908,20 @@ gci_gc_heap(void *h)
     gct_vm_mutex_lock(&heap->lock);
     heap->is_doing_reclaim = 1;
 
-    ret = reclaim_instance_heap(heap);
+    /* do one phase of the cycle, or all of them if it is to finish */
+    do {
+        if (heap->gc_phase == GC_PHASE_IDLE) {
+            ret = begin_marking(heap);
+            if (heap->gc_phase == GC_PHASE_IDLE)
+                /* failed or there is no rootset to mark */
+                break;
+        }
+        else if (heap->gc_phase == GC_PHASE_MARKING)
+            ret = mark_slice(heap, mark_budget);
+        else
+            ret = sweep_slice(heap, sweep_budget);
+    } while (finish && ret == GC_SUCCESS
+             && heap->gc_phase != GC_PHASE_IDLE);
 
     heap->is_doing_reclaim = 0;
     gct_vm_mutex_unlock(&heap->lock);
@@ -465,20 +930,445 @@ gci_gc_heap(void *h)
        is enabled, and pass it to runtime */
     gct_vm_gc_finished(NULL);
 
-    LOG_VERBOSE("#reclaim instance heap %p done", heap);
+    LOG_VERBOSE("#reclaim instance heap %p incrementally done", heap);
 
 #if BH_ENABLE_GC_VERIFY != 0
     gci_verify_heap(heap);
 #endif
 
 #if GC_STAT_SHOW != 0
-    gc_show_stat(heap);
-    gc_show_fragment(heap);
+    if (heap->gc_phase == GC_PHASE_IDLE) {
+        gc_show_stat(heap);
+        gc_show_fragment(heap);
+    }
 #endif
 
     return ret;
 }
 
+void
+gci_migrate_gc_cycle(gc_heap_t *heap, intptr_t offset)
+{
+    mark_node_t *mark_node = (mark_node_t *)heap->root_set;
+    uint32 i;
+
+    if (heap->sweep_cursor)
+        heap->sweep_cursor =
+            (hmu_t *)((gc_uint8 *)heap->sweep_cursor + offset);
+
+    for (; mark_node; mark_node = mark_node->next) {
+        for (i = 0; i < mark_node->idx; i++)
+            mark_node->set[i] =
+                (gc_object_t)((gc_uint8 *)mark_node->set[i] + offset);
+    }
+}
+
+void
+gci_destroy_gc_cycle(gc_heap_t *heap)
+{
+    mark_node_t *mark_node = (mark_node_t *)heap->root_set, *next;
+
+    if (heap->gc_phase == GC_PHASE_MARKING)
+        remove_marking_heap(heap);
+
+    while (mark_node) {
+        next = mark_node->next;
+        BH_FREE((gc_object_t)mark_node);
+        mark_node = next;
+    }
+    heap->root_set = NULL;
+    release_mark_nodes(heap);
+    heap->gc_phase = GC_PHASE_IDLE;
+}
+#endif /* end of WASM_ENABLE_GC_INCREMENTAL != 0 */
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/* The heaps with nursery, the write barrier searches the heap of an
+   object in them */
+static korp_mutex nursery_heaps_lock;
+static gc_heap_t *nursery_heaps;
+
+void
+gci_add_nursery_heap(gc_heap_t *heap)
+{
+    os_mutex_lock(&nursery_heaps_lock);
+    heap->next_nursery_heap = nursery_heaps;
+    nursery_heaps = heap;
+    heap->is_nursery_registered = 1;
+    os_mutex_unlock(&nursery_heaps_lock);
+}
+
+static void
+remove_nursery_heap(gc_heap_t *heap)
+{
+    gc_heap_t **p_heap;
+
+    os_mutex_lock(&nursery_heaps_lock);
+    for (p_heap = &nursery_heaps; *p_heap;
+         p_heap = &(*p_heap)->next_nursery_heap) {
+        if (*p_heap == heap) {
+            *p_heap = heap->next_nursery_heap;
+            break;
+        }
+    }
+    heap->next_nursery_heap = NULL;
+    heap->is_nursery_registered = 0;
+    os_mutex_unlock(&nursery_heaps_lock);
+}
+
+int
+gc_generational_init(void)
+{
+    if (os_mutex_init(&nursery_heaps_lock) != BHT_OK) {
+        LOG_ERROR("[GC_ERROR]failed to init nursery heaps lock\n");
+        return GC_ERROR;
+    }
+    nursery_heaps = NULL;
+    return GC_SUCCESS;
+}
+
+void
+gc_generational_destroy(void)
+{
+    bh_assert(!nursery_heaps);
+    os_mutex_destroy(&nursery_heaps_lock);
+}
+
+void
+gci_remember_object(gc_heap_t *heap, gc_object_t obj)
+{
+    hmu_t *hmu = obj_to_hmu(obj);
+    gc_object_t *remembered_set;
+    gc_uint32 capacity;
+
+    if (hmu_is_wo_remembered(hmu))
+        return;
+
+    if (heap->remembered_count == heap->remembered_capacity) {
+        capacity = heap->remembered_capacity > 0
+                       ? heap->remembered_capacity * 2
+                       : GC_REMEMBERED_SET_INIT_SIZE;
+        if (capacity <= heap->remembered_capacity
+            || !(remembered_set = (gc_object_t *)BH_MALLOC(
+                     (gc_size_t)(sizeof(gc_object_t) * capacity)))) {
+            /* the object isn't remembered, so the next collection must
+               be a full one */
+            heap->is_remset_overflowed = 1;
+            return;
+        }
+        if (heap->remembered_set) {
+            bh_memcpy_s(remembered_set, sizeof(gc_object_t) * capacity,
+                        heap->remembered_set,
+                        sizeof(gc_object_t) * heap->remembered_count);
+            BH_FREE(heap->remembered_set);
+        }
+        heap->remembered_set = remembered_set;
+        heap->remembered_capacity = capacity;
+    }
+
+    heap->remembered_set[heap->remembered_count++] = obj;
+    hmu_mark_wo_remembered(hmu);
+}
+
+void
+gc_generational_write_barrier(gc_object_t obj, gc_object_t value)
+{
+    gc_heap_t *heap;
+    hmu_t *hmu = obj_to_hmu(obj);
+
+    /* only the stores of young objects into old objects which aren't
+       remembered yet need to be recorded */
+    if (!hmu_is_wo_remembered(obj_to_hmu(value)) || hmu_is_wo_remembered(hmu))
+        return;
+
+    os_mutex_lock(&nursery_heaps_lock);
+    for (heap = nursery_heaps; heap; heap = heap->next_nursery_heap) {
+        if ((gc_uint8 *)hmu >= heap->base_addr
+            && (gc_uint8 *)hmu < heap->base_addr + heap->current_size)
+            break;
+    }
+    os_mutex_unlock(&nursery_heaps_lock);
+
+    if (!heap)
+        return;
+
+    gct_vm_mutex_lock(&heap->lock);
+    if (hmu_get_ut(hmu) == HMU_WO && !gc_is_young(heap, hmu))
+        gci_remember_object(heap, obj);
+    gct_vm_mutex_unlock(&heap->lock);
+}
+
+/* Forget the remembered objects, e.g. after they are scanned */
+static void
+clear_remembered_set(gc_heap_t *heap)
+{
+    gc_uint32 i;
+
+    for (i = 0; i < heap->remembered_count; i++)
+        hmu_unmark_wo_remembered(obj_to_hmu(heap->remembered_set[i]));
+    heap->remembered_count = 0;
+    heap->is_remset_overflowed = 0;
+}
+
+/**
+ * Add the free area [hmu, next) of the nursery to KFC, it is merged with
+ * the free chunks around it
+ *
+ * @param heap the heap whose nursery is collected
+ * @param hmu the first block of the free area
+ * @param next the block after the free area
+ *
+ * @return true if success, false otherwise
+ */
+static bool
+add_nursery_fc(gc_heap_t *heap, hmu_t *hmu, hmu_t *next)
+{
+    gc_uint8 *base_addr = heap->base_addr;
+    gc_uint8 *end_addr = base_addr + heap->current_size;
+    hmu_t *prev;
+
+    if (!hmu_get_pinuse(hmu) && (gc_uint8 *)hmu > base_addr) {
+        prev = (hmu_t *)((gc_uint8 *)hmu - *((gc_uint32 *)hmu - 1));
+        if ((gc_uint8 *)prev >= base_addr && prev < hmu
+            && hmu_get_ut(prev) == HMU_FC
+            && (hmu_t *)((gc_uint8 *)prev + hmu_get_size(prev)) == hmu) {
+            if (!gci_unlink_hmu(heap, prev))
+                return false;
+            hmu = prev;
+        }
+    }
+
+    if ((gc_uint8 *)next < end_addr && hmu_get_ut(next) == HMU_FC) {
+        if (!gci_unlink_hmu(heap, next))
+            return false;
+        next = (hmu_t *)((gc_uint8 *)next + hmu_get_size(next));
+    }
+
+    hmu_unmark_wo_remembered(hmu);
+    if (!gci_add_fc(heap, hmu, (gc_size_t)((gc_uint8 *)next - (gc_uint8 *)hmu)))
+        return false;
+
+    if ((gc_uint8 *)next < end_addr)
+        hmu_unmark_pinuse(next);
+    return true;
+}
+
+/**
+ * Promote the young objects to the old space in place: the marked ones
+ * survive, the others are freed together with the rest of the nursery.
+ *
+ * @param heap the heap whose nursery is collected, the survivors are
+ *        marked
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+promote_nursery(gc_heap_t *heap)
+{
+    hmu_t *cur = (hmu_t *)heap->nursery_start, *last = NULL;
+    hmu_t *end = (hmu_t *)heap->nursery_free;
+    gc_size_t tot_freed = 0;
+    int ret = GC_SUCCESS;
+
+    while (cur < end) {
+        bh_assert(hmu_get_ut(cur) == HMU_WO);
+
+        if (hmu_is_wo_marked(cur)) {
+            /* the object survives */
+            if (last && !add_nursery_fc(heap, last, cur))
+                ret = GC_ERROR;
+            last = NULL;
+
+            hmu_unmark_wo(cur);
+            hmu_unmark_wo_remembered(cur);
+        }
+        else {
+            call_wo_finalizer(heap, cur);
+            tot_freed += hmu_get_size(cur);
+            if (!last)
+                last = cur;
+        }
+
+        cur = (hmu_t *)((gc_uint8 *)cur + hmu_get_size(cur));
+    }
+
+    bh_assert(cur == end);
+
+    /* the rest of the nursery is free too */
+    if (heap->nursery_free < heap->nursery_end) {
+        tot_freed += (gc_size_t)(heap->nursery_end - heap->nursery_free);
+        if (!last)
+            last = end;
+    }
+    if (last && !add_nursery_fc(heap, last, (hmu_t *)heap->nursery_end))
+        ret = GC_ERROR;
+
+    heap->total_free_size += tot_freed;
+    heap->nursery_start = heap->nursery_free = heap->nursery_end = NULL;
+    return ret;
+}
+
+void
+gci_retire_nursery(gc_heap_t *heap)
+{
+    hmu_t *cur = (hmu_t *)heap->nursery_start;
+    hmu_t *end = (hmu_t *)heap->nursery_free;
+
+    clear_remembered_set(heap);
+
+    if (!heap->nursery_start)
+        return;
+
+    /* all young objects become old ones */
+    while (cur < end) {
+        bh_assert(hmu_get_ut(cur) == HMU_WO);
+        hmu_unmark_wo_remembered(cur);
+        cur = (hmu_t *)((gc_uint8 *)cur + hmu_get_size(cur));
+    }
+
+    if (heap->nursery_free < heap->nursery_end) {
+        heap->total_free_size +=
+            (gc_size_t)(heap->nursery_end - heap->nursery_free);
+        if (!add_nursery_fc(heap, end, (hmu_t *)heap->nursery_end))
+            LOG_ERROR("add the rest of the nursery to KFC failed");
+    }
+
+    heap->nursery_start = heap->nursery_free = heap->nursery_end = NULL;
+}
+
+/**
+ * Mark the young objects reachable from the rootset and the remembered
+ * set, and promote the marked ones
+ *
+ * @param heap the heap to collect, it has a nursery
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+reclaim_nursery(gc_heap_t *heap)
+{
+    gc_uint32 i;
+    bool ret;
+
+    heap->root_set = NULL;
+
+#if WASM_ENABLE_THREAD_MGR == 0
+    if (!heap->exec_env) {
+        gci_retire_nursery(heap);
+        return GC_SUCCESS;
+    }
+    ret = gct_vm_begin_rootset_enumeration(heap->exec_env, heap);
+#else
+    if (!heap->cluster) {
+        gci_retire_nursery(heap);
+        return GC_SUCCESS;
+    }
+    ret = gct_vm_begin_rootset_enumeration(heap->cluster, heap);
+#endif
+
+    if (!ret || heap->is_fast_marking_failed) {
+        LOG_ERROR("enumerate rootset failed");
+        LOG_ERROR("all marked wos will be unmarked to keep heap consistency");
+        rollback_mark(heap);
+        heap->is_fast_marking_failed = 0;
+        return GC_ERROR;
+    }
+
+    /* the old objects which may refer to young objects are roots too */
+    for (i = 0; i < heap->remembered_count; i++) {
+        if (mark_wo_refs(heap, heap->remembered_set[i]) != GC_SUCCESS) {
+            LOG_ERROR("all marked wos will be unmarked to keep heap "
+                      "consistency");
+            rollback_mark(heap);
+            return GC_ERROR;
+        }
+    }
+
+    if (mark_to_expand_list(heap) != GC_SUCCESS)
+        return GC_ERROR;
+
+    clear_remembered_set(heap);
+    return promote_nursery(heap);
+}
+
+int
+gci_gc_nursery(void *h)
+{
+    int ret = GC_ERROR;
+    gc_heap_t *heap = (gc_heap_t *)h;
+
+    bh_assert(gci_is_heap_valid(heap));
+
+    LOG_VERBOSE("#reclaim nursery of instance heap %p", heap);
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_prepare(NULL);
+
+    gct_vm_mutex_lock(&heap->lock);
+    heap->is_doing_reclaim = 1;
+    heap->is_minor_gc = 1;
+
+    if (heap->nursery_start)
+        ret = reclaim_nursery(heap);
+    else
+        ret = GC_SUCCESS;
+
+    heap->is_minor_gc = 0;
+    heap->is_doing_reclaim = 0;
+
+#if GC_STAT_DATA != 0
+    heap->total_gc_count++;
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
+#endif
+    gc_update_threshold(heap);
+    gct_vm_mutex_unlock(&heap->lock);
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_finished(NULL);
+
+    LOG_VERBOSE("#reclaim nursery of instance heap %p done", heap);
+
+#if BH_ENABLE_GC_VERIFY != 0
+    gci_verify_heap(heap);
+#endif
+
+    return ret;
+}
+
+void
+gci_migrate_nursery(gc_heap_t *heap, intptr_t offset)
+{
+    gc_uint32 i;
+
+    if (heap->nursery_start) {
+        heap->nursery_start += offset;
+        heap->nursery_free += offset;
+        heap->nursery_end += offset;
+    }
+
+    for (i = 0; i < heap->remembered_count; i++)
+        heap->remembered_set[i] =
+            (gc_object_t)((gc_uint8 *)heap->remembered_set[i] + offset);
+}
+
+void
+gci_destroy_nursery(gc_heap_t *heap)
+{
+    gci_retire_nursery(heap);
+
+    if (heap->is_nursery_registered)
+        remove_nursery_heap(heap);
+
+    if (heap->remembered_set)
+        BH_FREE(heap->remembered_set);
+    heap->remembered_set = NULL;
+    heap->remembered_count = heap->remembered_capacity = 0;
+}
+#endif /* end of WASM_ENABLE_GC_GENERATIONAL != 0 */
+
 int
 gc_is_dead_object(void *obj)
 {
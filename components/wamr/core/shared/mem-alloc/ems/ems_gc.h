@@ -35,6 +35,49 @@ extern "C" {
 #define GC_MANUALLY 0
 #endif
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* Max number of objects expanded by one marking slice */
+#ifndef GC_INCREMENTAL_MARK_SLICE
+#define GC_INCREMENTAL_MARK_SLICE 256
+#endif
+
+/* Max number of blocks visited by one sweeping slice */
+#ifndef GC_INCREMENTAL_SWEEP_SLICE
+#define GC_INCREMENTAL_SWEEP_SLICE 1024
+#endif
+
+/* Bytes allocated between two slices of a collection cycle */
+#ifndef GC_INCREMENTAL_SLICE_ALLOC_SIZE
+#define GC_INCREMENTAL_SLICE_ALLOC_SIZE (4 * BH_KB)
+#endif
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/* Size of the nursery, it is at most 1/8 of the heap, and the objects
+   larger than 1/4 of it are allocated in the old space directly */
+#ifndef GC_NURSERY_SIZE
+#define GC_NURSERY_SIZE (16 * BH_KB)
+#endif
+
+/* The nursery isn't created if there is no free block of this size */
+#ifndef GC_NURSERY_MIN_SIZE
+#define GC_NURSERY_MIN_SIZE (1 * BH_KB)
+#endif
+
+/* Initial capacity of the remembered set */
+#ifndef GC_REMEMBERED_SET_INIT_SIZE
+#define GC_REMEMBERED_SET_INIT_SIZE 64
+#endif
+#endif
+
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+/* Number of buckets of the GC pause histogram, bucket i counts the
+   pauses in [2^(i-1), 2^i) microseconds */
+#ifndef GC_PAUSE_HISTOGRAM_SIZE
+#define GC_PAUSE_HISTOGRAM_SIZE 24
+#endif
+#endif
+
 #define GC_HEAD_PADDING 4
 
 #ifndef NULL_REF
@@ -260,6 +303,104 @@ gc_add_root(void *heap, gc_object_t obj);
 int
 gci_gc_heap(void *heap);
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/**
+ * Do one slice of the incremental collection of a gc heap, a new cycle
+ * is started if there is no cycle in progress.
+ *
+ * @param heap the heap to collect
+ * @param finish whether to run the cycle to its end
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gci_gc_heap_slice(void *heap, bool finish);
+
+/**
+ * Enable or disable the incremental collection of a gc heap, it should
+ * be called before any object is allocated from the heap.
+ *
+ * @param handle the heap
+ * @param enable whether to collect the heap incrementally
+ */
+void
+gc_set_incremental(gc_handle_t handle, bool enable);
+
+/**
+ * Init the global data of the incremental collection
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_incremental_init(void);
+
+/**
+ * Destroy the global data of the incremental collection
+ */
+void
+gc_incremental_destroy(void);
+
+/**
+ * The write barrier of the incremental marking, it must be called with
+ * the old value of an object reference field before the field of a heap
+ * object is overwritten, so that the objects reachable when the marking
+ * began are all marked.
+ *
+ * @param obj the old value of the field, it can be an object of any heap
+ */
+void
+gc_write_barrier(gc_object_t obj);
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/**
+ * Do a minor collection of a gc heap: the young objects unreachable
+ * from the rootset and the remembered set are freed, and the others
+ * are promoted to the old space.
+ *
+ * @param heap the heap to collect
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gci_gc_nursery(void *heap);
+
+/**
+ * Enable or disable the nursery of a gc heap, the young objects are
+ * promoted when it is disabled.
+ *
+ * @param handle the heap
+ * @param enable whether to allocate the objects in the nursery
+ */
+void
+gc_set_generational(gc_handle_t handle, bool enable);
+
+/**
+ * Init the global data of the generational collection
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_generational_init(void);
+
+/**
+ * Destroy the global data of the generational collection
+ */
+void
+gc_generational_destroy(void);
+
+/**
+ * The write barrier of the generational collection, it must be called
+ * when an object reference is stored into a field of a heap object, so
+ * that the old objects referring to young objects are remembered.
+ *
+ * @param obj the object whose field is written
+ * @param value the object reference stored into the field
+ */
+void
+gc_generational_write_barrier(gc_object_t obj, gc_object_t value);
+#endif
+
 extra_info_node_t *
 gc_search_extra_info_node(gc_handle_t handle, gc_object_t obj,
                           gc_size_t *p_index);
@@ -143,6 +143,16 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #define hmu_unmark_wo(hmu) CLRBIT((hmu)->header, HMU_WO_MB_OFFSET)
 #define hmu_is_wo_marked(hmu) GETBIT((hmu)->header, HMU_WO_MB_OFFSET)
 
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/* Remembered bit of wo, it is set if the write barrier needn't record the
+   stores into the wo, i.e. the wo is young or it is in the remembered set */
+#define HMU_WO_RB_OFFSET 27
+
+#define hmu_mark_wo_remembered(hmu) SETBIT((hmu)->header, HMU_WO_RB_OFFSET)
+#define hmu_unmark_wo_remembered(hmu) CLRBIT((hmu)->header, HMU_WO_RB_OFFSET)
+#define hmu_is_wo_remembered(hmu) GETBIT((hmu)->header, HMU_WO_RB_OFFSET)
+#endif
+
 /**
  * The hmu size is divisible by 8, its lowest 3 bits are 0, so we only
  * store its higher bits of bit [29..3], and bit [2..0] are not stored.
@@ -296,6 +306,29 @@ typedef struct gc_heap_struct {
 
     /* Whether the heap can do reclaim */
     unsigned is_reclaim_enabled : 1;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* whether the heap is collected incrementally */
+    unsigned is_incremental : 1;
+
+    /* phase of the collection cycle, see gc_phase_t */
+    unsigned gc_phase : 2;
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    /* whether the objects are allocated in the nursery */
+    unsigned is_generational : 1;
+
+    /* whether a minor collection is being done */
+    unsigned is_minor_gc : 1;
+
+    /* whether the remembered set failed to grow, the next collection
+       must be a full one since some old objects weren't remembered */
+    unsigned is_remset_overflowed : 1;
+
+    /* whether the heap is on the list of the heaps with nursery */
+    unsigned is_nursery_registered : 1;
+#endif
 #endif
 
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
@@ -324,6 +357,32 @@ typedef struct gc_heap_struct {
     extra_info_node_t **extra_info_nodes;
     gc_size_t extra_info_node_cnt;
     gc_size_t extra_info_node_capacity;
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* the blocks before the cursor have been swept in this cycle */
+    hmu_t *sweep_cursor;
+    /* bytes allocated since the last slice */
+    gc_size_t slice_alloc_size;
+    /* mark nodes kept for the next slices of the cycle */
+    void *free_mark_nodes;
+    /* next heap on the list of the heaps being marked */
+    struct gc_heap_struct *next_marking_heap;
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    /* the young objects are in [nursery_start, nursery_free), and
+       [nursery_free, nursery_end) is a HMU_FM block if it isn't empty */
+    gc_uint8 *nursery_start;
+    gc_uint8 *nursery_free;
+    gc_uint8 *nursery_end;
+    /* the old objects which may refer to young objects */
+    gc_object_t *remembered_set;
+    gc_uint32 remembered_count;
+    gc_uint32 remembered_capacity;
+    /* next heap on the list of the heaps with nursery */
+    struct gc_heap_struct *next_nursery_heap;
+#endif
+#if WASM_ENABLE_GC_PERF_PROFILING != 0
+    gc_uint32 gc_pause_histogram[GC_PAUSE_HISTOGRAM_SIZE];
+#endif
 #endif
 #if GC_STAT_DATA != 0
     gc_uint64 total_size_allocated;
@@ -335,6 +394,102 @@ typedef struct gc_heap_struct {
 
 #define GC_DEFAULT_THRESHOLD_FACTOR 300
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+typedef enum gc_phase_enum {
+    GC_PHASE_IDLE = 0,
+    /* the gray objects are being expanded, the write barrier is on */
+    GC_PHASE_MARKING,
+    /* the blocks from sweep_cursor to the heap end are being swept */
+    GC_PHASE_SWEEPING
+} gc_phase_t;
+
+/**
+ * Whether a new wo must be marked: the objects allocated while marking
+ * are black, and so are the ones allocated ahead of the sweep cursor,
+ * or the sweeper would take them as garbage.
+ */
+static inline bool
+gc_is_alloc_black(gc_heap_t *heap, hmu_t *hmu)
+{
+    return heap->gc_phase == GC_PHASE_MARKING
+           || (heap->gc_phase == GC_PHASE_SWEEPING
+               && hmu >= heap->sweep_cursor);
+}
+
+/**
+ * Called after the block at @hmu is enlarged to @size bytes by merging
+ * its neighbours, move the sweep cursor back to the block if it pointed
+ * to one of the merged blocks.
+ */
+static inline void
+gc_adjust_sweep_cursor(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
+{
+    if (heap->gc_phase == GC_PHASE_SWEEPING && heap->sweep_cursor > hmu
+        && (gc_uint8 *)heap->sweep_cursor < (gc_uint8 *)hmu + size)
+        heap->sweep_cursor = hmu;
+}
+
+/**
+ * Adjust the pointers kept by the collection cycle in progress after
+ * the heap is migrated by @offset bytes.
+ */
+void
+gci_migrate_gc_cycle(gc_heap_t *heap, intptr_t offset);
+
+/**
+ * Stop the collection cycle in progress before the heap is destroyed.
+ */
+void
+gci_destroy_gc_cycle(gc_heap_t *heap);
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+/* Whether the hmu is a young object in the nursery */
+static inline bool
+gc_is_young(gc_heap_t *heap, hmu_t *hmu)
+{
+    return (gc_uint8 *)hmu >= heap->nursery_start
+           && (gc_uint8 *)hmu < heap->nursery_free;
+}
+
+/**
+ * Add the heap to the list searched by the write barrier, it is called
+ * when the first nursery of the heap is created.
+ */
+void
+gci_add_nursery_heap(gc_heap_t *heap);
+
+/**
+ * Add an old wo to the remembered set, e.g. a wo allocated in the old
+ * space directly, since its fields may be initialized without the write
+ * barrier.
+ */
+void
+gci_remember_object(gc_heap_t *heap, gc_object_t obj);
+
+/**
+ * Promote all the young objects without collecting them, return the
+ * rest of the nursery to KFC and clear the remembered set. It is done
+ * before a full collection, which doesn't care about the generations.
+ */
+void
+gci_retire_nursery(gc_heap_t *heap);
+
+/**
+ * Adjust the pointers to the nursery and the remembered set after the
+ * heap is migrated by @offset bytes.
+ */
+void
+gci_migrate_nursery(gc_heap_t *heap, intptr_t offset);
+
+/**
+ * Retire the nursery, release the remembered set and remove the heap
+ * from the list of the heaps with nursery before the heap is destroyed.
+ */
+void
+gci_destroy_nursery(gc_heap_t *heap);
+#endif
+
 static inline void
 gc_update_threshold(gc_heap_t *heap)
 {
@@ -362,6 +517,14 @@ gc_update_threshold(gc_heap_t *heap)
 bool
 gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size);
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_GENERATIONAL != 0
+/**
+ * Remove a free chunk from KFC
+ */
+bool
+gci_unlink_hmu(gc_heap_t *heap, hmu_t *hmu);
+#endif
+
 int
 gci_is_heap_valid(gc_heap_t *heap);
 
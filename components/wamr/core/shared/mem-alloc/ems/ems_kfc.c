@@ -30,6 +30,12 @@ gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
 #if WASM_ENABLE_GC != 0
     heap->gc_threshold_factor = GC_DEFAULT_THRESHOLD_FACTOR;
     gc_update_threshold(heap);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    heap->is_incremental = 1;
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    heap->is_generational = 1;
+#endif
 #endif
 
     root = heap->kfc_tree_root = (hmu_tree_node_t *)heap->kfc_tree_root_buf;
@@ -137,6 +143,13 @@ gc_destroy_with_pool(gc_handle_t handle)
 #if WASM_ENABLE_GC != 0
     gc_size_t i = 0;
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    gci_destroy_gc_cycle(heap);
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    gci_destroy_nursery(heap);
+#endif
+
     if (heap->extra_info_node_cnt > 0) {
         for (i = 0; i < heap->extra_info_node_cnt; i++) {
             extra_info_node_t *node = heap->extra_info_nodes[i];
@@ -197,6 +210,31 @@ gc_enable_gc_reclaim(gc_handle_t handle, void *cluster)
     heap->cluster = cluster;
 }
 #endif
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+void
+gc_set_incremental(gc_handle_t handle, bool enable)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    bh_assert(heap->gc_phase == GC_PHASE_IDLE);
+    heap->is_incremental = enable ? 1 : 0;
+}
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+void
+gc_set_generational(gc_handle_t handle, bool enable)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    os_mutex_lock(&heap->lock);
+    if (!enable)
+        gci_retire_nursery(heap);
+    heap->is_generational = enable ? 1 : 0;
+    os_mutex_unlock(&heap->lock);
+}
+#endif
 #endif
 
 uint32
@@ -305,6 +343,13 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     bh_assert(cur == end);
 #endif
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    gci_migrate_gc_cycle(heap, offset);
+#endif
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+    gci_migrate_nursery(heap, offset);
+#endif
+
     return 0;
 }
 
@@ -513,11 +558,24 @@ void
 gc_dump_perf_profiling(gc_handle_t *handle)
 {
     gc_heap_t *gc_heap_handle = (void *)handle;
+    uint32 i;
+
     if (gc_heap_handle) {
         os_printf("\nGC performance summary\n");
         os_printf("    Total GC time (ms): %u\n",
                   gc_heap_handle->total_gc_time);
         os_printf("    Max GC time (ms): %u\n", gc_heap_handle->max_gc_time);
+        os_printf("    GC pauses (us):\n");
+        for (i = 0; i < GC_PAUSE_HISTOGRAM_SIZE; i++) {
+            if (!gc_heap_handle->gc_pause_histogram[i])
+                continue;
+            if (i == GC_PAUSE_HISTOGRAM_SIZE - 1)
+                os_printf("      [%u, ...): %u\n", 1u << (i - 1),
+                          gc_heap_handle->gc_pause_histogram[i]);
+            else
+                os_printf("      [%u, %u): %u\n", i ? 1u << (i - 1) : 0,
+                          1u << i, gc_heap_handle->gc_pause_histogram[i]);
+        }
     }
     else {
         os_printf("Failed to dump GC performance\n");
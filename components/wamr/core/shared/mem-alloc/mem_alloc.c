@@ -136,6 +136,59 @@ mem_allocator_dump_perf_profiling(mem_allocator_t allocator)
 }
 #endif
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+bool
+mem_allocator_gc_incremental_init(void)
+{
+    return gc_incremental_init() == GC_SUCCESS ? true : false;
+}
+
+void
+mem_allocator_gc_incremental_destroy(void)
+{
+    gc_incremental_destroy();
+}
+
+void
+mem_allocator_set_gc_incremental(mem_allocator_t allocator, bool enable)
+{
+    gc_set_incremental((gc_handle_t)allocator, enable);
+}
+
+void
+mem_allocator_write_barrier(WASMObjectRef obj)
+{
+    gc_write_barrier((gc_object_t)obj);
+}
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+bool
+mem_allocator_gc_generational_init(void)
+{
+    return gc_generational_init() == GC_SUCCESS ? true : false;
+}
+
+void
+mem_allocator_gc_generational_destroy(void)
+{
+    gc_generational_destroy();
+}
+
+void
+mem_allocator_set_gc_generational(mem_allocator_t allocator, bool enable)
+{
+    gc_set_generational((gc_handle_t)allocator, enable);
+}
+
+void
+mem_allocator_generational_write_barrier(WASMObjectRef obj,
+                                         WASMObjectRef value)
+{
+    gc_generational_write_barrier((gc_object_t)obj, (gc_object_t)value);
+}
+#endif
+
 #endif
 
 #else /* else of DEFAULT_MEM_ALLOCATOR */
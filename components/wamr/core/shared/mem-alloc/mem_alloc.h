@@ -84,6 +84,35 @@ mem_allocator_unset_gc_finalizer(mem_allocator_t allocator, void *obj);
 void
 mem_allocator_dump_perf_profiling(mem_allocator_t allocator);
 #endif
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+bool
+mem_allocator_gc_incremental_init(void);
+
+void
+mem_allocator_gc_incremental_destroy(void);
+
+void
+mem_allocator_set_gc_incremental(mem_allocator_t allocator, bool enable);
+
+void
+mem_allocator_write_barrier(WASMObjectRef obj);
+#endif
+
+#if WASM_ENABLE_GC_GENERATIONAL != 0
+bool
+mem_allocator_gc_generational_init(void);
+
+void
+mem_allocator_gc_generational_destroy(void);
+
+void
+mem_allocator_set_gc_generational(mem_allocator_t allocator, bool enable);
+
+void
+mem_allocator_generational_write_barrier(WASMObjectRef obj,
+                                         WASMObjectRef value);
+#endif
 #endif /* end of WASM_ENABLE_GC != 0 */
 
 bool
@@ -298,3 +298,117 @@ os_icache_flush(void *start, size_t len)
     (void)len;
 #endif
 }
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+#if defined(__linux__) && defined(MFD_ALLOW_SEALING) && defined(F_ADD_SEALS)
+int
+os_mem_file_create(const char *name, uint64 size, os_file_handle *p_file)
+{
+    int fd;
+
+    if (size > (uint64)INT64_MAX)
+        return -1;
+
+    fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+        return -1;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    *p_file = fd;
+    return 0;
+}
+
+int
+os_mem_file_write(os_file_handle file, uint64 offset, const void *data,
+                  uint32 length)
+{
+    const uint8 *p = (const uint8 *)data;
+    ssize_t ret;
+
+    while (length > 0) {
+        ret = pwrite(file, p, length, (off_t)offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return -1;
+        p += ret;
+        offset += (uint64)ret;
+        length -= (uint32)ret;
+    }
+    return 0;
+}
+
+int
+os_mem_file_seal(os_file_handle file)
+{
+    if (fcntl(file, F_ADD_SEALS,
+              F_SEAL_SEAL | F_SEAL_WRITE | F_SEAL_GROW | F_SEAL_SHRINK)
+        != 0)
+        return -1;
+    return 0;
+}
+
+void
+os_mem_file_close(os_file_handle file)
+{
+    close(file);
+}
+
+int
+os_mem_file_map_private(os_file_handle file, void *addr, size_t size)
+{
+    void *ret = mmap(addr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_FIXED, file, 0);
+
+    return ret == addr ? 0 : -1;
+}
+#else  /* else of defined(__linux__) && defined(MFD_ALLOW_SEALING) ... */
+/* No file in memory can be mapped here, the instances copy the data
+   segments instead of mapping the memory image */
+int
+os_mem_file_create(const char *name, uint64 size, os_file_handle *p_file)
+{
+    (void)name;
+    (void)size;
+    (void)p_file;
+    return -1;
+}
+
+int
+os_mem_file_write(os_file_handle file, uint64 offset, const void *data,
+                  uint32 length)
+{
+    (void)file;
+    (void)offset;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+int
+os_mem_file_seal(os_file_handle file)
+{
+    (void)file;
+    return -1;
+}
+
+void
+os_mem_file_close(os_file_handle file)
+{
+    (void)file;
+}
+
+int
+os_mem_file_map_private(os_file_handle file, void *addr, size_t size)
+{
+    (void)file;
+    (void)addr;
+    (void)size;
+    return -1;
+}
+#endif /* end of defined(__linux__) && defined(MFD_ALLOW_SEALING) ... */
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
@@ -141,3 +141,49 @@ os_get_dbus_mirror(void *ibus)
     }
 }
 #endif
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* No file in memory can be mapped here, the instances copy the data
+   segments instead of mapping the memory image */
+int
+os_mem_file_create(const char *name, uint64 size, os_file_handle *p_file)
+{
+    (void)name;
+    (void)size;
+    (void)p_file;
+    return -1;
+}
+
+int
+os_mem_file_write(os_file_handle file, uint64 offset, const void *data,
+                  uint32 length)
+{
+    (void)file;
+    (void)offset;
+    (void)data;
+    (void)length;
+    return -1;
+}
+
+int
+os_mem_file_seal(os_file_handle file)
+{
+    (void)file;
+    return -1;
+}
+
+void
+os_mem_file_close(os_file_handle file)
+{
+    (void)file;
+}
+
+int
+os_mem_file_map_private(os_file_handle file, void *addr, size_t size)
+{
+    (void)file;
+    (void)addr;
+    (void)size;
+    return -1;
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
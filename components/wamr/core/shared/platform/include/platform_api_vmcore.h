@@ -170,6 +170,57 @@ void *
 os_get_dbus_mirror(void *ibus);
 #endif
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/**
+ * Create an anonymous file in memory, which reads as zero until written,
+ * to be mapped by os_mem_file_map_private. Platforms that can't map such
+ * a file just return -1.
+ *
+ * @param name the name of the file, only for debugging
+ * @param size the size of the file, a multiple of the page size
+ * @param p_file [OUTPUT] the handle of the file created
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_file_create(const char *name, uint64 size, os_file_handle *p_file);
+
+/**
+ * Write the data to the file at the given offset
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_file_write(os_file_handle file, uint64 offset, const void *data,
+                  uint32 length);
+
+/**
+ * Forbid any further change of the content or the size of the file
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_file_seal(os_file_handle file);
+
+/**
+ * Close the file, the mappings of it stay valid
+ */
+void
+os_mem_file_close(os_file_handle file);
+
+/**
+ * Replace the pages at addr with a private mapping of the start of the
+ * file, the pages are copied on write
+ *
+ * @param addr the page aligned address to map the file at
+ * @param size the size to map, not greater than the size of the file
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_file_map_private(os_file_handle file, void *addr, size_t size);
+#endif
+
 /**
  * Flush cpu data cache, in some CPUs, after applying relocation to the
  * AOT code, the code may haven't been written back to the cpu data cache,
@@ -137,6 +137,10 @@ typedef uint16 bh_atomic_16_t;
     __atomic_fetch_add(&(v), (val), __ATOMIC_SEQ_CST)
 #define BH_ATOMIC_64_FETCH_SUB(v, val) \
     __atomic_fetch_sub(&(v), (val), __ATOMIC_SEQ_CST)
+/* Store desired if v equals expected, otherwise load v into expected */
+#define BH_ATOMIC_64_COMPARE_EXCHANGE(v, expected, desired)          \
+    __atomic_compare_exchange_n(&(v), &(expected), (desired), false, \
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 
 #else /* else of BH_ATOMIC_64_IS_ATOMIC != 0 */
 
@@ -146,6 +150,8 @@ typedef uint16 bh_atomic_16_t;
 #define BH_ATOMIC_64_FETCH_AND(v, val) nonatomic_64_fetch_and(&(v), val)
 #define BH_ATOMIC_64_FETCH_ADD(v, val) nonatomic_64_fetch_add(&(v), val)
 #define BH_ATOMIC_64_FETCH_SUB(v, val) nonatomic_64_fetch_sub(&(v), val)
+#define BH_ATOMIC_64_COMPARE_EXCHANGE(v, expected, desired) \
+    nonatomic_64_compare_exchange(&(v), &(expected), desired)
 
 static inline uint64
 nonatomic_64_fetch_or(bh_atomic_64_t *p, uint64 val)
@@ -178,6 +184,18 @@ nonatomic_64_fetch_sub(bh_atomic_64_t *p, uint64 val)
     *p -= val;
     return old;
 }
+
+static inline bool
+nonatomic_64_compare_exchange(bh_atomic_64_t *p, uint64 *expected,
+                              uint64 desired)
+{
+    if (*p == *expected) {
+        *p = desired;
+        return true;
+    }
+    *expected = *p;
+    return false;
+}
 #endif
 
 #if BH_ATOMIC_32_IS_ATOMIC != 0
@@ -192,6 +210,10 @@ nonatomic_64_fetch_sub(bh_atomic_64_t *p, uint64 val)
     __atomic_fetch_add(&(v), (val), __ATOMIC_SEQ_CST)
 #define BH_ATOMIC_32_FETCH_SUB(v, val) \
     __atomic_fetch_sub(&(v), (val), __ATOMIC_SEQ_CST)
+/* Store desired if v equals expected, otherwise load v into expected */
+#define BH_ATOMIC_32_COMPARE_EXCHANGE(v, expected, desired)          \
+    __atomic_compare_exchange_n(&(v), &(expected), (desired), false, \
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 
 #else /* else of BH_ATOMIC_32_IS_ATOMIC != 0 */
 
@@ -201,6 +223,8 @@ nonatomic_64_fetch_sub(bh_atomic_64_t *p, uint64 val)
 #define BH_ATOMIC_32_FETCH_AND(v, val) nonatomic_32_fetch_and(&(v), val)
 #define BH_ATOMIC_32_FETCH_ADD(v, val) nonatomic_32_fetch_add(&(v), val)
 #define BH_ATOMIC_32_FETCH_SUB(v, val) nonatomic_32_fetch_sub(&(v), val)
+#define BH_ATOMIC_32_COMPARE_EXCHANGE(v, expected, desired) \
+    nonatomic_32_compare_exchange(&(v), &(expected), desired)
 
 static inline uint32
 nonatomic_32_fetch_or(bh_atomic_32_t *p, uint32 val)
@@ -234,6 +258,18 @@ nonatomic_32_fetch_sub(bh_atomic_32_t *p, uint32 val)
     return old;
 }
 
+static inline bool
+nonatomic_32_compare_exchange(bh_atomic_32_t *p, uint32 *expected,
+                              uint32 desired)
+{
+    if (*p == *expected) {
+        *p = desired;
+        return true;
+    }
+    *expected = *p;
+    return false;
+}
+
 #endif
 
 #if BH_ATOMIC_16_IS_ATOMIC != 0
@@ -5,50 +5,38 @@
 
 #include "bh_leb128.h"
 
-bh_leb_read_status_t
-bh_leb_read(const uint8 *buf, const uint8 *buf_end, uint32 maxbits, bool sign,
-            uint64 *p_result, size_t *p_offset)
-{
-    uint64 result = 0;
-    uint32 shift = 0;
-    uint32 offset = 0, bcnt = 0;
-    uint64 byte;
-
-    while (true) {
-        /* uN or SN must not exceed ceil(N/7) bytes */
-        if (bcnt + 1 > (maxbits + 6) / 7) {
-            return BH_LEB_READ_TOO_LONG;
-        }
-
-        if ((uintptr_t)buf + offset + 1 < (uintptr_t)buf
-            || (uintptr_t)buf + offset + 1 > (uintptr_t)buf_end) {
-            return BH_LEB_READ_UNEXPECTED_END;
-        }
-        byte = buf[offset];
-        offset += 1;
-        result |= ((byte & 0x7f) << shift);
-        shift += 7;
-        bcnt += 1;
-        if ((byte & 0x80) == 0) {
-            break;
-        }
-    }
+/*
+ * Decode a value of up to 8 bytes with one unaligned load and a bit scan
+ * of the continuation bits when the buffer has 8 bytes left, only on the
+ * targets where such a load is cheap.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__)) \
+    && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define BH_LEB_READ_WORD_AT_A_TIME 1
+#else
+#define BH_LEB_READ_WORD_AT_A_TIME 0
+#endif
 
+/* Check the last byte read and sign extend the result */
+static inline bh_leb_read_status_t
+leb_read_end(uint32 maxbits, bool sign, uint64 result, uint32 shift,
+             uint8 byte, uint32 offset, uint64 *p_result, size_t *p_offset)
+{
     if (!sign && maxbits == 32 && shift >= maxbits) {
         /* The top bits set represent values > 32 bits */
-        if (((uint8)byte) & 0xf0)
+        if (byte & 0xf0)
             return BH_LEB_READ_OVERFLOW;
     }
     else if (sign && maxbits == 32) {
         if (shift < maxbits) {
             /* Sign extend, second-highest bit is the sign bit */
-            if ((uint8)byte & 0x40)
+            if (byte & 0x40)
                 result |= (~((uint64)0)) << shift;
         }
         else {
             /* The top bits should be a sign-extension of the sign bit */
-            bool sign_bit_set = ((uint8)byte) & 0x8;
-            int top_bits = ((uint8)byte) & 0xf0;
+            bool sign_bit_set = byte & 0x8;
+            int top_bits = byte & 0xf0;
             if ((sign_bit_set && top_bits != 0x70)
                 || (!sign_bit_set && top_bits != 0))
                 return BH_LEB_READ_OVERFLOW;
@@ -57,13 +45,13 @@ bh_leb_read(const uint8 *buf, const uint8 *buf_end, uint32 maxbits, bool sign,
     else if (sign && maxbits == 64) {
         if (shift < maxbits) {
             /* Sign extend, second-highest bit is the sign bit */
-            if ((uint8)byte & 0x40)
+            if (byte & 0x40)
                 result |= (~((uint64)0)) << shift;
         }
         else {
             /* The top bits should be a sign-extension of the sign bit */
-            bool sign_bit_set = ((uint8)byte) & 0x1;
-            int top_bits = ((uint8)byte) & 0xfe;
+            bool sign_bit_set = byte & 0x1;
+            int top_bits = byte & 0xfe;
 
             if ((sign_bit_set && top_bits != 0x7e)
                 || (!sign_bit_set && top_bits != 0))
@@ -74,4 +62,80 @@ bh_leb_read(const uint8 *buf, const uint8 *buf_end, uint32 maxbits, bool sign,
     *p_offset = offset;
     *p_result = result;
     return BH_LEB_READ_SUCCESS;
-}
\ No newline at end of file
+}
+
+bh_leb_read_status_t
+bh_leb_read(const uint8 *buf, const uint8 *buf_end, uint32 maxbits, bool sign,
+            uint64 *p_result, size_t *p_offset)
+{
+    uint64 result = 0;
+    uint32 shift = 0;
+    uint32 offset = 0, bcnt = 0;
+    uint64 byte;
+
+    /* Most of the values are encoded in a single byte */
+    if (buf < buf_end && !(buf[0] & 0x80)) {
+        return leb_read_end(maxbits, sign, buf[0], 7, buf[0], 1, p_result,
+                            p_offset);
+    }
+
+#if BH_LEB_READ_WORD_AT_A_TIME != 0
+    if (buf < buf_end && buf_end - buf >= 8) {
+        uint64 word, stop_bits;
+        uint32 nbytes;
+
+        memcpy(&word, buf, sizeof(uint64));
+        /* The continuation bit of the last byte is clear */
+        stop_bits = ~word & 0x8080808080808080ULL;
+        if (stop_bits) {
+            nbytes = ((uint32)__builtin_ctzll(stop_bits) + 1) >> 3;
+            /* uN or SN must not exceed ceil(N/7) bytes */
+            if (nbytes > (maxbits + 6) / 7) {
+                return BH_LEB_READ_TOO_LONG;
+            }
+            byte = (uint8)(word >> ((nbytes - 1) * 8));
+
+            /* Keep the bytes of the value and pack their 7-bit groups:
+               pairs of bytes into 14 bits, pairs of those into 28 bits
+               and the two halves into 56 bits */
+            word &= (stop_bits ^ (stop_bits - 1)) & 0x7f7f7f7f7f7f7f7fULL;
+            word = (word & 0x007f007f007f007fULL)
+                   | ((word & 0x7f007f007f007f00ULL) >> 1);
+            word = (word & 0x00003fff00003fffULL)
+                   | ((word & 0x3fff00003fff0000ULL) >> 2);
+            word = (word & 0x000000000fffffffULL)
+                   | ((word & 0x0fffffff00000000ULL) >> 4);
+
+            return leb_read_end(maxbits, sign, word, nbytes * 7, (uint8)byte,
+                                nbytes, p_result, p_offset);
+        }
+        if ((maxbits + 6) / 7 <= 8) {
+            return BH_LEB_READ_TOO_LONG;
+        }
+        /* A value of more than 8 bytes, decode it byte by byte */
+    }
+#endif
+
+    while (true) {
+        /* uN or SN must not exceed ceil(N/7) bytes */
+        if (bcnt + 1 > (maxbits + 6) / 7) {
+            return BH_LEB_READ_TOO_LONG;
+        }
+
+        if ((uintptr_t)buf + offset + 1 < (uintptr_t)buf
+            || (uintptr_t)buf + offset + 1 > (uintptr_t)buf_end) {
+            return BH_LEB_READ_UNEXPECTED_END;
+        }
+        byte = buf[offset];
+        offset += 1;
+        result |= ((byte & 0x7f) << shift);
+        shift += 7;
+        bcnt += 1;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+
+    return leb_read_end(maxbits, sign, result, shift, (uint8)byte, offset,
+                        p_result, p_offset);
+}
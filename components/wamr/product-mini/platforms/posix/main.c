@@ -56,6 +56,14 @@ print_help(void)
 #if WASM_ENABLE_FAST_JIT != 0
     printf("  --jit-codecache-size=n   Set fast jit maximum code cache size in bytes,\n");
     printf("                           default is %u KB\n", FAST_JIT_DEFAULT_CODE_CACHE_SIZE / 1024);
+    printf("  --jit-disable-opt=flags  Disable fast jit IR optimization passes, flags is\n");
+    printf("                           a combination of 0x1 (constant folding), 0x2 (copy\n");
+    printf("                           propagation), 0x4 (CSE), 0x8 (dead code elimination)\n");
+    printf("                           and 0x10 (global register allocation of locals)\n");
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    printf("  --jit-compile-threshold=n Set the call count after which a function is\n");
+    printf("                           compiled in background, default is %u\n", FAST_JIT_DEFAULT_COMPILE_THRESHOLD);
+#endif
 #endif
 #if WASM_ENABLE_GC != 0
     printf("  --gc-heap-size=n         Set maximum gc heap size in bytes,\n");
@@ -443,6 +451,55 @@ module_destroyer_callback(uint8 *buffer, uint32 size)
 }
 #endif /* WASM_ENABLE_MULTI_MODULE */
 
+#if WASM_ENABLE_AOT != 0 && WASM_MEM_DUAL_BUS_MIRROR == 0
+/**
+ * Map an XIP file into memory instead of reading it: the loader executes
+ * its text in place, so the file isn't copied and the clean pages are
+ * shared by all the processes running it. The mapping is private and
+ * writable so that the text relocations an XIP file may still carry are
+ * applied to copy-on-write pages.
+ *
+ * @return the mapped file, NULL if it isn't an XIP file or can't be mapped
+ */
+static uint8 *
+map_xip_file(const char *filename, uint32 *p_size)
+{
+    struct stat stat_buf;
+    uint8 *addr;
+    int map_flags = MAP_PRIVATE;
+    int fd;
+
+#if (defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)) \
+    && defined(MAP_32BIT)
+    /* keep the text within reach of the data sections, see os_mmap */
+    map_flags |= MAP_32BIT;
+#endif
+
+    if ((fd = open(filename, O_RDONLY)) < 0)
+        return NULL;
+
+    if (fstat(fd, &stat_buf) != 0 || stat_buf.st_size <= 0
+        || (uint64)stat_buf.st_size >= UINT32_MAX) {
+        close(fd);
+        return NULL;
+    }
+
+    addr = mmap(NULL, (size_t)stat_buf.st_size,
+                PROT_READ | PROT_WRITE | PROT_EXEC, map_flags, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return NULL;
+
+    if (!wasm_runtime_is_xip_file(addr, (uint32)stat_buf.st_size)) {
+        munmap(addr, (size_t)stat_buf.st_size);
+        return NULL;
+    }
+
+    *p_size = (uint32)stat_buf.st_size;
+    return addr;
+}
+#endif
+
 #if WASM_ENABLE_GLOBAL_HEAP_POOL != 0
 static char global_heap_buf[WASM_GLOBAL_HEAP_SIZE] = { 0 };
 #else
@@ -576,6 +633,10 @@ main(int argc, char *argv[])
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
     uint32 jit_code_cache_size = FAST_JIT_DEFAULT_CODE_CACHE_SIZE;
+    uint32 jit_disabled_opt_passes = 0;
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    uint32 jit_compile_threshold = FAST_JIT_DEFAULT_COMPILE_THRESHOLD;
+#endif
 #endif
 #if WASM_ENABLE_GC != 0
     uint32 gc_heap_size = GC_HEAP_SIZE_DEFAULT;
@@ -686,6 +747,18 @@ main(int argc, char *argv[])
                 return print_help();
             jit_code_cache_size = atoi(argv[0] + 21);
         }
+        else if (!strncmp(argv[0], "--jit-disable-opt=", 18)) {
+            if (argv[0][18] == '\0')
+                return print_help();
+            jit_disabled_opt_passes = (uint32)strtoul(argv[0] + 18, NULL, 0);
+        }
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+        else if (!strncmp(argv[0], "--jit-compile-threshold=", 24)) {
+            if (argv[0][24] == '\0')
+                return print_help();
+            jit_compile_threshold = atoi(argv[0] + 24);
+        }
+#endif
 #endif
 #if WASM_ENABLE_GC != 0
         else if (!strncmp(argv[0], "--gc-heap-size=", 15)) {
@@ -849,6 +922,10 @@ main(int argc, char *argv[])
 
 #if WASM_ENABLE_FAST_JIT != 0
     init_args.fast_jit_code_cache_size = jit_code_cache_size;
+    init_args.fast_jit_disabled_opt_passes = jit_disabled_opt_passes;
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+    init_args.fast_jit_compile_threshold = jit_compile_threshold;
+#endif
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -886,13 +963,21 @@ main(int argc, char *argv[])
         native_lib_list, native_lib_count, native_lib_loaded_list);
 #endif
 
+#if WASM_ENABLE_AOT != 0 && WASM_MEM_DUAL_BUS_MIRROR == 0
+    wasm_file_buf = map_xip_file(wasm_file, &wasm_file_size);
+    is_xip_file = wasm_file_buf != NULL;
+#endif
+
     /* load WASM byte buffer from WASM bin file */
-    if (!(wasm_file_buf =
-              (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
+    if (!wasm_file_buf
+        && !(wasm_file_buf = (uint8 *)bh_read_file_to_buffer(
+                 wasm_file, &wasm_file_size)))
         goto fail1;
 
 #if WASM_ENABLE_AOT != 0
-    if (wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
+    /* the XIP file couldn't be mapped, copy it to executable memory */
+    if (!is_xip_file
+        && wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
         uint8 *wasm_file_mapped;
         uint8 *daddr;
         int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2026 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+"""
+It is used to merge the PGO profiles collected on many devices running the
+same PGO instrumented AOT file (`wamrc --enable-llvm-pgo`) into one profile
+for `wamrc --use-prof-file`.
+
+Devices export either the raw profile (`wasm_runtime_dump_pgo_prof_data_to_buf`)
+or the compact counters (`wasm_runtime_dump_pgo_counters_to_buf`), which only
+hold the counters and a hash of the function layout. The counters of all the
+inputs are added up into one raw profile, which needs at least one raw profile
+of the same AOT file as template for the function records and names, and then
+merged by `llvm-profdata` into the profile.
+
+The inputs can be:
+
+- raw profiles and compact counters dumped to files
+- images of a flash partition the records were appended to, each record being
+  a header (magic "WPGR", kind, size) followed by the dump, at 4-byte aligned
+  offsets
+- serial console logs holding records as hex lines between `WAMR-PGO-BEGIN`
+  and `WAMR-PGO-END`
+
+Usage:
+
+```
+$ parttool.py read_partition --partition-name=storage --output=dev1.bin
+$ idf.py monitor | tee dev2.log
+$ python pgo_merge.py -o app.profdata dev1.bin dev2.log
+$ wamrc --use-prof-file=app.profdata -o app.aot app.wasm
+```
+
+Value profiles (indirect call targets and memory operation sizes) are only
+taken from the template, the compact counters don't hold them.
+"""
+
+import argparse
+from pathlib import Path
+import re
+import shutil
+import struct
+import subprocess
+import sys
+from typing import List, Optional, Tuple
+
+PROFRAW_MAGIC = 0xFF6C70726F667281
+PROFRAW_VERSION = 8
+# magic, version, binary_ids_size, num_prof_data,
+# padding_bytes_before_counters, num_prof_counters,
+# padding_bytes_after_counters, names_size, counters_delta, names_delta,
+# value_kind_last
+PROFRAW_HEADER = struct.Struct("<11Q")
+# func_md5, func_hash, offset_counters, func_ptr, values, num_counters,
+# num_value_sites[2]
+PROFRAW_DATA = struct.Struct("<5QI2H")
+
+COUNTERS_MAGIC = b"WPGC"
+COUNTERS_VERSION = 1
+# magic, version, num_prof_data, num_prof_counters, layout_hash
+COUNTERS_HEADER = struct.Struct("<4sIIIQ")
+
+RECORD_MAGIC = b"WPGR"
+RECORD_RAW_PROFILE = 0
+RECORD_COUNTERS = 1
+# magic, kind, size
+RECORD_HEADER = struct.Struct("<4sII")
+
+UINT64_MAX = (1 << 64) - 1
+
+
+class RawProfile:
+    """a raw profile of LLVM version 8, as dumped by WAMR"""
+
+    def __init__(self, data: bytes, origin: str):
+        if len(data) < PROFRAW_HEADER.size:
+            raise ValueError(f"{origin}: truncated raw profile")
+
+        header = PROFRAW_HEADER.unpack_from(data)
+        if header[0] != PROFRAW_MAGIC or header[1] & 0xFF != PROFRAW_VERSION:
+            raise ValueError(f"{origin}: not a raw profile of version 8")
+
+        num_prof_data, padding_before, num_prof_counters = header[3:6]
+        self.data = data
+        self.origin = origin
+        self.counters_offset = (
+            PROFRAW_HEADER.size
+            + header[2]
+            + num_prof_data * PROFRAW_DATA.size
+            + padding_before
+        )
+        self.num_counters = num_prof_counters
+        if self.counters_offset + num_prof_counters * 8 > len(data):
+            raise ValueError(f"{origin}: truncated raw profile")
+
+        # the same hash as get_pgo_counters_size() in aot_runtime.c
+        layout_hash = 0xCBF29CE484222325
+        offset = PROFRAW_HEADER.size + header[2]
+        for _ in range(num_prof_data):
+            record = PROFRAW_DATA.unpack_from(data, offset)
+            layout_hash = fnv1a(layout_hash, struct.pack("<QQI", record[0],
+                                                         record[1], record[5]))
+            offset += PROFRAW_DATA.size
+        self.num_prof_data = num_prof_data
+        self.layout_hash = layout_hash
+
+    def counters(self) -> List[int]:
+        return list(
+            struct.unpack_from(
+                f"<{self.num_counters}Q", self.data, self.counters_offset
+            )
+        )
+
+    def with_counters(self, counters: List[int]) -> bytes:
+        data = bytearray(self.data)
+        struct.pack_into(
+            f"<{self.num_counters}Q", data, self.counters_offset, *counters
+        )
+        return bytes(data)
+
+
+class Counters:
+    """a compact dump of the counters"""
+
+    def __init__(self, data: bytes, origin: str):
+        if len(data) < COUNTERS_HEADER.size:
+            raise ValueError(f"{origin}: truncated counters")
+
+        magic, version, num_prof_data, num_counters, layout_hash = (
+            COUNTERS_HEADER.unpack_from(data)
+        )
+        if magic != COUNTERS_MAGIC or version != COUNTERS_VERSION:
+            raise ValueError(f"{origin}: not a counters dump of version 1")
+
+        self.origin = origin
+        self.num_prof_data = num_prof_data
+        self.num_counters = num_counters
+        self.layout_hash = layout_hash
+        self.values = []
+        offset = COUNTERS_HEADER.size
+        for _ in range(num_counters):
+            value, offset = read_uleb128(data, offset, origin)
+            self.values.append(value)
+
+    def counters(self) -> List[int]:
+        return self.values
+
+
+def fnv1a(hash: int, data: bytes) -> int:
+    for byte in data:
+        hash = ((hash ^ byte) * 0x100000001B3) & UINT64_MAX
+    return hash
+
+
+def read_uleb128(data: bytes, offset: int, origin: str) -> Tuple[int, int]:
+    value = shift = 0
+    while True:
+        if offset >= len(data):
+            raise ValueError(f"{origin}: truncated counters")
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, offset
+
+
+def parse_record(kind: int, data: bytes, origin: str):
+    if kind == RECORD_RAW_PROFILE:
+        return RawProfile(data, origin)
+    if kind == RECORD_COUNTERS:
+        return Counters(data, origin)
+    raise ValueError(f"{origin}: unknown record kind {kind}")
+
+
+def parse_records(data: bytes, origin: str) -> list:
+    """walk the records appended to a partition image"""
+    profiles = []
+    offset = 0
+    while offset + RECORD_HEADER.size <= len(data):
+        magic, kind, size = RECORD_HEADER.unpack_from(data, offset)
+        if magic == b"\xff\xff\xff\xff":
+            break
+        if magic != RECORD_MAGIC:
+            raise ValueError(f"{origin}: no record at offset {offset:#x}")
+
+        start = offset + RECORD_HEADER.size
+        profiles.append(
+            parse_record(kind, data[start : start + size],
+                         f"{origin}@{offset:#x}")
+        )
+        offset = start + ((size + 3) & ~3)
+    return profiles
+
+
+def parse_serial_log(text: str, origin: str) -> list:
+    """extract the records printed between WAMR-PGO-BEGIN and WAMR-PGO-END"""
+    profiles = []
+    for index, block in enumerate(
+        re.findall(r"WAMR-PGO-BEGIN(.*?)WAMR-PGO-END", text, re.S)
+    ):
+        # tolerate the prefixes and colors added by the serial monitor
+        hex_data = "".join(
+            line.strip()
+            for line in block.splitlines()
+            if re.fullmatch(r"[0-9a-f]+", line.strip())
+        )
+        profiles += parse_records(bytes.fromhex(hex_data),
+                                  f"{origin}#{index}")
+    return profiles
+
+
+def parse_input(path: Path) -> list:
+    data = path.read_bytes()
+    if data[:8] == struct.pack("<Q", PROFRAW_MAGIC):
+        return [RawProfile(data, str(path))]
+    if data[:4] == COUNTERS_MAGIC:
+        return [Counters(data, str(path))]
+    if data[:4] in (RECORD_MAGIC, b"\xff\xff\xff\xff"):
+        return parse_records(data, str(path))
+    return parse_serial_log(data.decode("utf-8", "replace"), str(path))
+
+
+def merge(template: RawProfile, profiles: list) -> Tuple[List[int], int]:
+    merged = [0] * template.num_counters
+    num_merged = 0
+    for profile in profiles:
+        if (
+            profile.layout_hash != template.layout_hash
+            or profile.num_counters != template.num_counters
+        ):
+            print(
+                f"skip {profile.origin}: dumped from another AOT file",
+                file=sys.stderr,
+            )
+            continue
+
+        for i, value in enumerate(profile.counters()):
+            merged[i] = min(merged[i] + value, UINT64_MAX)
+        num_merged += 1
+    return merged, num_merged
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="merge the PGO profiles of WAMR collected on devices"
+    )
+    parser.add_argument(
+        "inputs", nargs="+", type=Path,
+        help="raw profiles, counters, partition images or serial logs",
+    )
+    parser.add_argument(
+        "-o", "--output", type=Path, default=Path("merged.profdata"),
+        help="the profile for `wamrc --use-prof-file`",
+    )
+    parser.add_argument(
+        "--template", type=Path,
+        help="the raw profile providing function records and names, "
+        "defaults to the first raw profile of the inputs",
+    )
+    parser.add_argument(
+        "--raw-output", type=Path,
+        help="also keep the merged raw profile",
+    )
+    parser.add_argument(
+        "--llvm-profdata", default="llvm-profdata",
+        help="path of llvm-profdata",
+    )
+    args = parser.parse_args()
+
+    profiles = []
+    for path in args.inputs:
+        profiles += parse_input(path)
+
+    template: Optional[RawProfile] = None
+    if args.template:
+        template = RawProfile(args.template.read_bytes(), str(args.template))
+    else:
+        template = next(
+            (p for p in profiles if isinstance(p, RawProfile)), None
+        )
+    if not template:
+        print("no raw profile found to use as template", file=sys.stderr)
+        return 1
+
+    counters, num_merged = merge(template, profiles)
+    print(f"merged {num_merged} of {len(profiles)} profiles")
+    if num_merged == 0:
+        return 1
+
+    raw_output = args.raw_output or args.output.with_suffix(".profraw")
+    raw_output.write_bytes(template.with_counters(counters))
+
+    llvm_profdata = shutil.which(args.llvm_profdata)
+    if not llvm_profdata:
+        print(
+            f"{args.llvm_profdata} not found, run `llvm-profdata merge "
+            f"-output={args.output} {raw_output}`",
+            file=sys.stderr,
+        )
+        return 1
+
+    subprocess.check_call(
+        [llvm_profdata, "merge", f"-output={args.output}", str(raw_output)]
+    )
+    if not args.raw_output:
+        raw_output.unlink()
+    print(f"written {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Host equivalent of main/wasm_runner.c: loads a wasm file no larger than
+ * the flash partition, runs its main() with the same runtime settings as
+ * the firmware and reports the timings and memory usage as JSON.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+#ifndef MAX_WASM_FILE_SIZE
+#define MAX_WASM_FILE_SIZE (64 * 1024)
+#endif
+
+/* Same as the wasm_runtime_instantiate() call of main/wasm_runner.c */
+#define APP_STACK_SIZE (64 * 1024)
+#define APP_HEAP_SIZE (128 * 1024)
+
+/* Each allocation is prefixed with its size, keep the payload aligned */
+#define ALLOC_HEADER_SIZE 16
+
+static uint64 heap_used = 0;
+static uint64 heap_peak = 0;
+
+static void *
+counting_malloc(unsigned int size)
+{
+    uint8 *p = malloc((size_t)size + ALLOC_HEADER_SIZE);
+
+    if (!p)
+        return NULL;
+
+    *(uint32 *)p = size;
+    heap_used += size;
+    if (heap_used > heap_peak)
+        heap_peak = heap_used;
+    return p + ALLOC_HEADER_SIZE;
+}
+
+static void
+counting_free(void *ptr)
+{
+    uint8 *p;
+
+    if (!ptr)
+        return;
+
+    p = (uint8 *)ptr - ALLOC_HEADER_SIZE;
+    heap_used -= *(uint32 *)p;
+    free(p);
+}
+
+static void *
+counting_realloc(void *ptr, unsigned int size)
+{
+    uint8 *p, *p_new;
+    uint32 old_size;
+
+    if (!ptr)
+        return counting_malloc(size);
+
+    p = (uint8 *)ptr - ALLOC_HEADER_SIZE;
+    old_size = *(uint32 *)p;
+    if (!(p_new = realloc(p, (size_t)size + ALLOC_HEADER_SIZE)))
+        return NULL;
+
+    *(uint32 *)p_new = size;
+    heap_used = heap_used - old_size + size;
+    if (heap_used > heap_peak)
+        heap_peak = heap_used;
+    return p_new + ALLOC_HEADER_SIZE;
+}
+
+/* Host stubs of the natives registered by main/function_registry.c */
+static void
+gpio_set_level_wrapper(wasm_exec_env_t exec_env, int32 pin, int32 level)
+{
+    (void)exec_env;
+    (void)pin;
+    (void)level;
+}
+
+static void
+sleep_ms_wrapper(wasm_exec_env_t exec_env, int32 milliseconds)
+{
+    /* don't sleep, the time would be counted as run time */
+    (void)exec_env;
+    (void)milliseconds;
+}
+
+static void
+print_debug_wrapper(wasm_exec_env_t exec_env, const char *message)
+{
+    (void)exec_env;
+    fprintf(stderr, "WASM debug: %s\n", message);
+}
+
+/* clang-format off */
+static NativeSymbol native_symbols[] = {
+    { "gpio_set_level", gpio_set_level_wrapper, "(ii)", NULL },
+    { "sleep_ms", sleep_ms_wrapper, "(i)", NULL },
+    { "print_debug", print_debug_wrapper, "($)", NULL },
+};
+/* clang-format on */
+
+static int
+print_help(void)
+{
+    printf("Usage: bench_runner [options] wasm_file [args...]\n");
+    printf("options:\n");
+    printf("  --name=<name>        Benchmark name in the report, default is "
+           "the file name\n");
+    printf("  --iterations=<n>     Iterations run by main(), used to compute "
+           "the throughput\n");
+    printf("  --repeat=<n>         Load, instantiate and run n times and "
+           "report the best\n");
+    printf("  --output=<file>      Write the JSON report to the file instead "
+           "of stdout\n");
+    return 1;
+}
+
+static void
+print_json_string(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            fprintf(file, "\\%c", *str);
+        else if ((uint8)*str < 0x20)
+            fprintf(file, "\\u%04x", *str);
+        else
+            fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *name = NULL, *wasm_file, *output = NULL;
+    const char *exception = NULL;
+    char error_buf[128] = { 0 };
+    uint8 *wasm_file_buf = NULL, *wasm_buf = NULL;
+    uint32 wasm_file_size, repeat = 1, i;
+    uint64 iterations = 0, start_us;
+    uint64 load_us = UINT64_MAX, instantiate_us = UINT64_MAX;
+    uint64 run_us = UINT64_MAX, cur_us, linear_memory_size = 0;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_memory_inst_t memory;
+    RuntimeInitArgs init_args;
+    FILE *file = stdout;
+    int ret = 1;
+
+    for (argc--, argv++; argc > 0 && argv[0][0] == '-'; argc--, argv++) {
+        if (!strncmp(argv[0], "--name=", 7))
+            name = argv[0] + 7;
+        else if (!strncmp(argv[0], "--iterations=", 13))
+            iterations = strtoull(argv[0] + 13, NULL, 10);
+        else if (!strncmp(argv[0], "--repeat=", 9))
+            repeat = (uint32)atoi(argv[0] + 9);
+        else if (!strncmp(argv[0], "--output=", 9))
+            output = argv[0] + 9;
+        else
+            return print_help();
+    }
+
+    if (argc < 1 || repeat == 0)
+        return print_help();
+
+    wasm_file = argv[0];
+    if (!name)
+        name = wasm_file;
+
+    /* Same runtime settings as main/wasm_runner.c, but the allocator
+       counts the bytes allocated by the runtime */
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_Allocator;
+    init_args.mem_alloc_option.allocator.malloc_func = counting_malloc;
+    init_args.mem_alloc_option.allocator.realloc_func = counting_realloc;
+    init_args.mem_alloc_option.allocator.free_func = counting_free;
+
+    if (!wasm_runtime_full_init(&init_args)) {
+        snprintf(error_buf, sizeof(error_buf), "init runtime failed");
+        goto report;
+    }
+
+    wasm_runtime_register_natives("env", native_symbols,
+                                  sizeof(native_symbols)
+                                      / sizeof(NativeSymbol));
+
+    if (!(wasm_file_buf =
+              (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size))) {
+        snprintf(error_buf, sizeof(error_buf), "read wasm file failed");
+        goto fail1;
+    }
+
+    if (wasm_file_size > MAX_WASM_FILE_SIZE) {
+        snprintf(error_buf, sizeof(error_buf),
+                 "wasm file size %u exceeds the partition limit %u",
+                 wasm_file_size, (uint32)MAX_WASM_FILE_SIZE);
+        goto fail2;
+    }
+
+    for (i = 0; i < repeat; i++) {
+        /* the loader may modify the buffer, load from a fresh copy */
+        if (!(wasm_buf = wasm_runtime_malloc(wasm_file_size))) {
+            snprintf(error_buf, sizeof(error_buf), "allocate memory failed");
+            goto fail2;
+        }
+        bh_memcpy_s(wasm_buf, wasm_file_size, wasm_file_buf, wasm_file_size);
+
+        start_us = os_time_get_boot_us();
+        if (!(module = wasm_runtime_load(wasm_buf, wasm_file_size, error_buf,
+                                         sizeof(error_buf))))
+            goto fail3;
+        cur_us = os_time_get_boot_us() - start_us;
+        load_us = cur_us < load_us ? cur_us : load_us;
+
+#if WASM_ENABLE_LIBC_WASI != 0
+        wasm_runtime_set_wasi_args(module, NULL, 0, NULL, 0, NULL, 0,
+                                   (char **)argv, argc);
+#endif
+
+        start_us = os_time_get_boot_us();
+        if (!(module_inst =
+                  wasm_runtime_instantiate(module, APP_STACK_SIZE,
+                                           APP_HEAP_SIZE, error_buf,
+                                           sizeof(error_buf))))
+            goto fail3;
+        cur_us = os_time_get_boot_us() - start_us;
+        instantiate_us = cur_us < instantiate_us ? cur_us : instantiate_us;
+
+        start_us = os_time_get_boot_us();
+        wasm_application_execute_main(module_inst, argc - 1, argv + 1);
+        cur_us = os_time_get_boot_us() - start_us;
+        run_us = cur_us < run_us ? cur_us : run_us;
+
+        if ((exception = wasm_runtime_get_exception(module_inst))) {
+            snprintf(error_buf, sizeof(error_buf), "%s", exception);
+            goto fail4;
+        }
+
+        if ((memory = wasm_runtime_get_default_memory(module_inst)))
+            linear_memory_size =
+                (uint64)wasm_memory_get_cur_page_count(memory)
+                * wasm_memory_get_bytes_per_page(memory);
+
+        wasm_runtime_deinstantiate(module_inst);
+        module_inst = NULL;
+        wasm_runtime_unload(module);
+        module = NULL;
+        wasm_runtime_free(wasm_buf);
+        wasm_buf = NULL;
+    }
+
+    ret = 0;
+
+fail4:
+    if (module_inst)
+        wasm_runtime_deinstantiate(module_inst);
+fail3:
+    if (module)
+        wasm_runtime_unload(module);
+    if (wasm_buf)
+        wasm_runtime_free(wasm_buf);
+fail2:
+    wasm_runtime_free(wasm_file_buf);
+fail1:
+    wasm_runtime_destroy();
+
+report:
+    if (output && !(file = fopen(output, "w"))) {
+        fprintf(stderr, "open %s failed\n", output);
+        return 1;
+    }
+
+    fprintf(file, "{\"name\": ");
+    print_json_string(file, name);
+    fprintf(file, ", \"success\": %s", ret == 0 ? "true" : "false");
+    if (ret != 0) {
+        fprintf(file, ", \"error\": ");
+        print_json_string(file, error_buf);
+    }
+    else {
+        fprintf(file,
+                ", \"file_size\": %" PRIu32 ", \"load_us\": %" PRIu64
+                ", \"instantiate_us\": %" PRIu64 ", \"run_us\": %" PRIu64,
+                wasm_file_size, load_us, instantiate_us, run_us);
+        if (iterations > 0)
+            fprintf(file,
+                    ", \"iterations\": %" PRIu64
+                    ", \"iterations_per_sec\": %.2f",
+                    iterations,
+                    run_us ? (double)iterations * 1000000 / run_us : 0.0);
+    }
+    fprintf(file,
+            ", \"peak_heap_bytes\": %" PRIu64
+            ", \"linear_memory_bytes\": %" PRIu64 "}\n",
+            heap_peak, linear_memory_size);
+
+    if (file != stdout)
+        fclose(file);
+    return ret;
+}
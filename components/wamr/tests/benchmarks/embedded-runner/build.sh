@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Copyright (C) 2026 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Build the benchmarks into out/, each <name>.wasm comes with a
+# <name>.iterations file read by run.sh to compute the throughput
+
+WASI_SDK_PATH=${WASI_SDK_PATH:-/opt/wasi-sdk}
+CC="${WASI_SDK_PATH}/bin/clang"
+
+KERNEL_ITERATIONS=${KERNEL_ITERATIONS:-200}
+COREMARK_ITERATIONS=${COREMARK_ITERATIONS:-2000}
+
+set -e
+
+cd $(dirname "$0")
+mkdir -p out
+
+# Same flags as application/build.sh, which builds the firmware's app
+KERNEL_FLAGS="-O3 -z stack-size=4096 -Wl,--initial-memory=65536 \
+    -Wl,--export=main -Wl,--export=__main_argc_argv \
+    -Wl,--export=__data_end -Wl,--export=__heap_base \
+    -Wl,--strip-all,--no-entry -Wl,--allow-undefined -nostdlib"
+
+for src in kernels/*.c; do
+    name=$(basename ${src} .c)
+    echo "===> compile ${src} to out/${name}.wasm"
+    ${CC} ${KERNEL_FLAGS} -DITERATIONS=${KERNEL_ITERATIONS} \
+        -o out/${name}.wasm ${src}
+    echo ${KERNEL_ITERATIONS} > out/${name}.iterations
+done
+
+if [ ! -d coremark ]; then
+    git clone https://github.com/eembc/coremark.git
+fi
+
+echo "===> compile coremark to out/coremark.wasm"
+cd coremark
+${CC} -O3 -Iposix -I. -DFLAGS_STR=\""-O3 -DPERFORMANCE_RUN=1"\" \
+    -Wl,--export=main -Wl,--strip-all \
+    -DITERATIONS=${COREMARK_ITERATIONS} -DSEED_METHOD=SEED_VOLATILE \
+    -DPERFORMANCE_RUN=1 -Wl,--allow-undefined \
+    core_list_join.c core_main.c core_matrix.c core_state.c \
+    core_util.c posix/core_portme.c \
+    -o ../out/coremark.wasm
+cd ..
+echo ${COREMARK_ITERATIONS} > out/coremark.iterations
+
+# dhrystone calibrates the number of runs by itself, read its output
+# for the Dhrystones per second
+echo "===> compile dhrystone to out/dhrystone.wasm"
+${CC} -O3 -Wl,--strip-all \
+    -o out/dhrystone.wasm ../dhrystone/src/dhry_1.c ../dhrystone/src/dhry_2.c \
+    -I ../dhrystone/include
+echo 0 > out/dhrystone.iterations
+
+echo "Done"
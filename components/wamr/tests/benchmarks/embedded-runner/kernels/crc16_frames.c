@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/* Pack sensor readings into frames and protect them with CRC-16/CCITT,
+   as done before sending them over a serial link */
+
+#include "kernel_common.h"
+
+#define READINGS_PER_FRAME 32
+#define FRAME_SIZE (4 + READINGS_PER_FRAME * 2 + 2)
+
+static uint8_t frame[FRAME_SIZE];
+
+static uint16_t
+crc16_ccitt(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xffff;
+    uint32_t i;
+    int bit;
+
+    for (i = 0; i < len; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                                 : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+int
+main(int argc, char *argv[])
+{
+    uint32_t checksum = 0, seq;
+    uint16_t crc;
+    int32_t reading;
+    int i;
+
+    (void)argc;
+    (void)argv;
+
+    for (seq = 0; seq < ITERATIONS * 8; seq++) {
+        frame[0] = 0xa5;
+        frame[1] = (uint8_t)seq;
+        frame[2] = (uint8_t)(seq >> 8);
+        frame[3] = READINGS_PER_FRAME;
+        for (i = 0; i < READINGS_PER_FRAME; i++) {
+            reading = next_sample();
+            frame[4 + i * 2] = (uint8_t)reading;
+            frame[5 + i * 2] = (uint8_t)(reading >> 8);
+        }
+        crc = crc16_ccitt(frame, FRAME_SIZE - 2);
+        frame[FRAME_SIZE - 2] = (uint8_t)crc;
+        frame[FRAME_SIZE - 1] = (uint8_t)(crc >> 8);
+        checksum = checksum * 31 + crc;
+    }
+
+    print_checksum("crc16_frames", checksum);
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/* 16-tap Q15 fixed-point low pass FIR filter over a block of samples */
+
+#include "kernel_common.h"
+
+#define TAPS 16
+#define BLOCK_SIZE 256
+
+static const int16_t coeffs[TAPS] = {
+    -120, -310, -380, 0,    1250, 3280, 5380, 6650,
+    6650, 5380, 3280, 1250, 0,    -380, -310, -120,
+};
+
+static int32_t input[BLOCK_SIZE + TAPS - 1];
+static int32_t output[BLOCK_SIZE];
+
+int
+main(int argc, char *argv[])
+{
+    uint32_t checksum = 0;
+    int32_t acc;
+    int i, j, n;
+
+    (void)argc;
+    (void)argv;
+
+    for (n = 0; n < ITERATIONS; n++) {
+        /* keep the tail of the previous block as the filter history */
+        for (i = 0; i < TAPS - 1; i++)
+            input[i] = input[BLOCK_SIZE + i];
+        for (i = TAPS - 1; i < BLOCK_SIZE + TAPS - 1; i++)
+            input[i] = next_sample();
+
+        for (i = 0; i < BLOCK_SIZE; i++) {
+            acc = 0;
+            for (j = 0; j < TAPS; j++)
+                acc += input[i + j] * coeffs[j];
+            output[i] = acc >> 15;
+        }
+
+        for (i = 0; i < BLOCK_SIZE; i++)
+            checksum = checksum * 31 + (uint32_t)output[i];
+    }
+
+    print_checksum("fir_filter", checksum);
+    return 0;
+}
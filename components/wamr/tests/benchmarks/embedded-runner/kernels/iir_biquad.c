@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/* Cascade of floating point biquad sections (direct form II transposed),
+   the targets without an FPU run it with soft float */
+
+#include "kernel_common.h"
+
+#define SECTIONS 4
+#define BLOCK_SIZE 256
+
+typedef struct Biquad {
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+} Biquad;
+
+static Biquad sections[SECTIONS] = {
+    { 0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f, 0, 0 },
+    { 0.0675f, 0.1349f, 0.0675f, -1.1430f, 0.4128f, 0, 0 },
+    { 1.0000f, -2.0000f, 1.0000f, -1.9112f, 0.9150f, 0, 0 },
+    { 1.0000f, -2.0000f, 1.0000f, -1.9112f, 0.9150f, 0, 0 },
+};
+
+int
+main(int argc, char *argv[])
+{
+    uint32_t checksum = 0;
+    float x, y;
+    Biquad *s;
+    int i, k, n;
+
+    (void)argc;
+    (void)argv;
+
+    for (n = 0; n < ITERATIONS; n++) {
+        for (i = 0; i < BLOCK_SIZE; i++) {
+            x = (float)next_sample() * (1.0f / 2048);
+            for (k = 0; k < SECTIONS; k++) {
+                s = sections + k;
+                y = s->b0 * x + s->z1;
+                s->z1 = s->b1 * x - s->a1 * y + s->z2;
+                s->z2 = s->b2 * x - s->a2 * y;
+                x = y;
+            }
+            checksum = checksum * 31 + (uint32_t)(int32_t)(x * 32768);
+        }
+    }
+
+    print_checksum("iir_biquad", checksum);
+    return 0;
+}
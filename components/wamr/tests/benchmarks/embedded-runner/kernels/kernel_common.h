@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _KERNEL_COMMON_H
+#define _KERNEL_COMMON_H
+
+/* The kernels are built with -nostdlib like application/my_program.c,
+   so they only use the natives registered by main/function_registry.c */
+
+#include <stdint.h>
+
+#ifndef ITERATIONS
+#define ITERATIONS 1000
+#endif
+
+__attribute__((import_module("env"), import_name("print_debug"))) void
+print_debug(const char *message);
+
+/* Synthetic sensor samples, a deterministic LCG so that the results can
+   be compared between runs */
+static uint32_t sample_seed = 12345;
+
+static inline int32_t
+next_sample(void)
+{
+    sample_seed = sample_seed * 1103515245u + 12345u;
+    /* 12-bit ADC reading centered on zero */
+    return (int32_t)((sample_seed >> 16) & 0xfff) - 2048;
+}
+
+/* Print the checksum so that the compiler can't drop the computation */
+static inline void
+print_checksum(const char *name, uint32_t checksum)
+{
+    static const char hex[] = "0123456789abcdef";
+    char buf[64];
+    int i = 0, j;
+
+    while (name[i] && i < 48) {
+        buf[i] = name[i];
+        i++;
+    }
+    buf[i++] = ':';
+    buf[i++] = ' ';
+    for (j = 7; j >= 0; j--)
+        buf[i++] = hex[(checksum >> (j * 4)) & 0xf];
+    buf[i] = '\0';
+    print_debug(buf);
+}
+
+#endif /* end of _KERNEL_COMMON_H */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/* Windowed mean, variance, min and max of the readings with a ring
+   buffer, plus a simple threshold crossing detector */
+
+#include "kernel_common.h"
+
+#define WINDOW 64
+#define SAMPLES_PER_ITERATION 256
+
+static int32_t window[WINDOW];
+
+int
+main(int argc, char *argv[])
+{
+    uint32_t checksum = 0, pos = 0, crossings = 0;
+    int64_t sum = 0, sum_sq = 0, variance;
+    int32_t sample, old, mean, min, max;
+    int i, k, n;
+
+    (void)argc;
+    (void)argv;
+
+    for (n = 0; n < ITERATIONS; n++) {
+        for (i = 0; i < SAMPLES_PER_ITERATION; i++) {
+            sample = next_sample();
+            old = window[pos];
+            window[pos] = sample;
+            pos = (pos + 1) % WINDOW;
+
+            sum += sample - old;
+            sum_sq += (int64_t)sample * sample - (int64_t)old * old;
+            mean = (int32_t)(sum / WINDOW);
+            variance = sum_sq / WINDOW - (int64_t)mean * mean;
+
+            if ((old < 1024) != (sample < 1024))
+                crossings++;
+
+            if (pos == 0) {
+                min = max = window[0];
+                for (k = 1; k < WINDOW; k++) {
+                    if (window[k] < min)
+                        min = window[k];
+                    if (window[k] > max)
+                        max = window[k];
+                }
+                checksum = checksum * 31 + (uint32_t)(max - min);
+            }
+            checksum = checksum * 31 + (uint32_t)mean + (uint32_t)variance;
+        }
+    }
+
+    print_checksum("moving_stats", checksum + crossings);
+    return 0;
+}
@@ -0,0 +1,23 @@
+# Copyright (C) 2026 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Cross build the runner for riscv32 linux and run it with qemu-riscv32,
+# override the toolchain prefix with -DRISCV32_TOOLCHAIN_PREFIX=...
+
+set (CMAKE_SYSTEM_NAME Linux)
+set (CMAKE_SYSTEM_PROCESSOR riscv32)
+
+if (NOT DEFINED RISCV32_TOOLCHAIN_PREFIX)
+  set (RISCV32_TOOLCHAIN_PREFIX riscv32-unknown-linux-gnu-)
+endif ()
+
+set (CMAKE_C_COMPILER ${RISCV32_TOOLCHAIN_PREFIX}gcc)
+set (CMAKE_CXX_COMPILER ${RISCV32_TOOLCHAIN_PREFIX}g++)
+set (CMAKE_ASM_COMPILER ${RISCV32_TOOLCHAIN_PREFIX}gcc)
+
+# Link statically so that qemu-riscv32 doesn't need a sysroot
+set (CMAKE_EXE_LINKER_FLAGS_INIT "-static")
+
+set (CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set (CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set (CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
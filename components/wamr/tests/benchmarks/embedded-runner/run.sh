@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Copyright (C) 2026 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Run the benchmarks built by build.sh with bench_runner and collect the
+# reports into one JSON file:
+#   ./run.sh [--runner <bench_runner>] [--qemu <qemu-riscv32>]
+#            [--repeat <n>] [--output <results.json>]
+
+RUNNER=build/bench_runner
+QEMU=
+REPEAT=3
+OUTPUT=results.json
+
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --runner) RUNNER=$2; shift 2 ;;
+        --qemu) QEMU=$2; shift 2 ;;
+        --repeat) REPEAT=$2; shift 2 ;;
+        --output) OUTPUT=$2; shift 2 ;;
+        *) echo "unknown option $1"; exit 1 ;;
+    esac
+done
+
+cd $(dirname "$0")
+
+if [ ! -d out ]; then
+    echo "out/ not found, run build.sh first"
+    exit 1
+fi
+
+REPORT=$(mktemp)
+trap "rm -f ${REPORT}" EXIT
+
+echo "{" > ${OUTPUT}
+echo "  \"runner\": \"${QEMU:+${QEMU} }${RUNNER}\"," >> ${OUTPUT}
+echo "  \"git_commit\": \"$(git rev-parse --short HEAD 2>/dev/null)\"," >> ${OUTPUT}
+echo "  \"results\": [" >> ${OUTPUT}
+
+first=1
+for wasm in out/*.wasm; do
+    name=$(basename ${wasm} .wasm)
+    iterations=$(cat out/${name}.iterations 2>/dev/null || echo 0)
+
+    echo "============> run ${name}"
+    ${QEMU} ${RUNNER} --name=${name} --iterations=${iterations} \
+        --repeat=${REPEAT} --output=${REPORT} ${wasm}
+    if [ ! -s ${REPORT} ]; then
+        echo "{\"name\": \"${name}\", \"success\": false, \"error\": \"runner crashed\"}" > ${REPORT}
+    fi
+
+    [ ${first} -eq 1 ] || echo "    ," >> ${OUTPUT}
+    first=0
+    echo -n "    " >> ${OUTPUT}
+    cat ${REPORT} >> ${OUTPUT}
+    : > ${REPORT}
+done
+
+echo "  ]" >> ${OUTPUT}
+echo "}" >> ${OUTPUT}
+
+echo "Results written to ${OUTPUT}"
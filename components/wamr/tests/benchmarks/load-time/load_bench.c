@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/*
+ * Loads wasm files repeatedly and reports the time of wasm_runtime_load()
+ * as JSON, one line per file, to track the cost of decoding and preparing
+ * the bytecode of large modules.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+static int
+print_help(void)
+{
+    printf("Usage: load_bench [options] wasm_file...\n");
+    printf("options:\n");
+    printf("  --repeat=<n>         Load each file n times, default is 10\n");
+    printf("  --output=<file>      Write the JSON report to the file instead "
+           "of stdout\n");
+    return 1;
+}
+
+static int
+cmp_uint64(const void *a, const void *b)
+{
+    uint64 x = *(const uint64 *)a, y = *(const uint64 *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void
+print_json_string(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            fprintf(file, "\\%c", *str);
+        else if ((uint8)*str < 0x20)
+            fprintf(file, "\\u%04x", *str);
+        else
+            fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+/* Load a file repeat times, return the sorted load times in load_us */
+static bool
+bench_load(const char *wasm_file, uint32 repeat, uint64 *load_us,
+           uint32 *p_file_size, char *error_buf, uint32 error_buf_size)
+{
+    uint8 *wasm_file_buf, *wasm_buf;
+    uint32 wasm_file_size, i;
+    uint64 start_us;
+    wasm_module_t module;
+
+    if (!(wasm_file_buf =
+              (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size))) {
+        snprintf(error_buf, error_buf_size, "read wasm file failed");
+        return false;
+    }
+
+    for (i = 0; i < repeat; i++) {
+        /* the loader may modify the buffer, load from a fresh copy */
+        if (!(wasm_buf = wasm_runtime_malloc(wasm_file_size))) {
+            snprintf(error_buf, error_buf_size, "allocate memory failed");
+            wasm_runtime_free(wasm_file_buf);
+            return false;
+        }
+        bh_memcpy_s(wasm_buf, wasm_file_size, wasm_file_buf, wasm_file_size);
+
+        start_us = os_time_get_boot_us();
+        module =
+            wasm_runtime_load(wasm_buf, wasm_file_size, error_buf,
+                              error_buf_size);
+        load_us[i] = os_time_get_boot_us() - start_us;
+
+        if (!module) {
+            wasm_runtime_free(wasm_buf);
+            wasm_runtime_free(wasm_file_buf);
+            return false;
+        }
+        wasm_runtime_unload(module);
+        wasm_runtime_free(wasm_buf);
+    }
+
+    wasm_runtime_free(wasm_file_buf);
+    qsort(load_us, repeat, sizeof(uint64), cmp_uint64);
+    *p_file_size = wasm_file_size;
+    return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *output = NULL;
+    char error_buf[128];
+    uint32 repeat = 10, file_size = 0;
+    uint64 *load_us;
+    RuntimeInitArgs init_args;
+    FILE *file = stdout;
+    int ret = 0;
+
+    for (argc--, argv++; argc > 0 && argv[0][0] == '-'; argc--, argv++) {
+        if (!strncmp(argv[0], "--repeat=", 9))
+            repeat = (uint32)atoi(argv[0] + 9);
+        else if (!strncmp(argv[0], "--output=", 9))
+            output = argv[0] + 9;
+        else
+            return print_help();
+    }
+
+    if (argc < 1 || repeat == 0)
+        return print_help();
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    if (!wasm_runtime_full_init(&init_args)) {
+        fprintf(stderr, "init runtime failed\n");
+        return 1;
+    }
+
+    if (!(load_us = wasm_runtime_malloc((uint32)sizeof(uint64) * repeat))) {
+        fprintf(stderr, "allocate memory failed\n");
+        wasm_runtime_destroy();
+        return 1;
+    }
+
+    if (output && !(file = fopen(output, "w"))) {
+        fprintf(stderr, "open %s failed\n", output);
+        wasm_runtime_free(load_us);
+        wasm_runtime_destroy();
+        return 1;
+    }
+
+    for (; argc > 0; argc--, argv++) {
+        error_buf[0] = '\0';
+        fprintf(file, "{\"name\": ");
+        print_json_string(file, argv[0]);
+        if (!bench_load(argv[0], repeat, load_us, &file_size, error_buf,
+                        sizeof(error_buf))) {
+            fprintf(file, ", \"success\": false, \"error\": ");
+            print_json_string(file, error_buf);
+            fprintf(file, "}\n");
+            ret = 1;
+            continue;
+        }
+
+        fprintf(file,
+                ", \"success\": true, \"file_size\": %" PRIu32
+                ", \"best_load_us\": %" PRIu64
+                ", \"median_load_us\": %" PRIu64 ", \"mb_per_sec\": %.2f}\n",
+                file_size, load_us[0], load_us[repeat / 2],
+                load_us[0] ? (double)file_size / load_us[0] : 0.0);
+    }
+
+    if (file != stdout)
+        fclose(file);
+    wasm_runtime_free(load_us);
+    wasm_runtime_destroy();
+    return ret;
+}
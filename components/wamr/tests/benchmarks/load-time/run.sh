@@ -0,0 +1,63 @@
+#!/bin/bash
+
+# Copyright (C) 2026 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# Measure the load time of the modules built by samples/workload, and of
+# any other wasm files given, and collect the reports into one JSON file:
+#   ./run.sh [--runner <load_bench>] [--workload <workload build dir>]
+#            [--repeat <n>] [--output <results.json>] [wasm_file...]
+
+RUNNER=build/load_bench
+WORKLOAD=../../../samples/workload/build
+REPEAT=10
+OUTPUT=results.json
+
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --runner) RUNNER=$2; shift 2 ;;
+        --workload) WORKLOAD=$2; shift 2 ;;
+        --repeat) REPEAT=$2; shift 2 ;;
+        --output) OUTPUT=$2; shift 2 ;;
+        -*) echo "unknown option $1"; exit 1 ;;
+        *) break ;;
+    esac
+done
+
+# Resolve the files given before changing the directory
+RUNNER=$(realpath ${RUNNER})
+OUTPUT=$(realpath -m ${OUTPUT})
+FILES=()
+for wasm in "$@"; do
+    FILES+=("$(realpath ${wasm})")
+done
+
+cd $(dirname "$0")
+
+if [ -d ${WORKLOAD} ]; then
+    # The optimized modules, e.g. bwa.wasm, codecbench.wasm, testavx.wasm
+    while IFS= read -r wasm; do
+        FILES+=("$(realpath ${wasm})")
+    done < <(find ${WORKLOAD} -maxdepth 2 -name "*.wasm" | sort)
+fi
+
+if [ ${#FILES[@]} -eq 0 ]; then
+    echo "no wasm file found, build samples/workload first or pass the files"
+    exit 1
+fi
+
+REPORT=$(mktemp)
+trap "rm -f ${REPORT}" EXIT
+
+${RUNNER} --repeat=${REPEAT} --output=${REPORT} "${FILES[@]}"
+
+echo "{" > ${OUTPUT}
+echo "  \"runner\": \"${RUNNER}\"," >> ${OUTPUT}
+echo "  \"git_commit\": \"$(git rev-parse --short HEAD 2>/dev/null)\"," >> ${OUTPUT}
+echo "  \"results\": [" >> ${OUTPUT}
+sed -e 's/^/    /' -e '$!s/$/,/' ${REPORT} >> ${OUTPUT}
+echo "  ]" >> ${OUTPUT}
+echo "}" >> ${OUTPUT}
+
+cat ${REPORT}
+echo "Results written to ${OUTPUT}"
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "wasm_runtime_common.h"
+
+#define PGO_COUNTERS_MAGIC 0x43475057 /* "WPGC" */
+#define PGO_COUNTERS_HEADER_SIZE 24
+
+/* The functions of pgo.wasm */
+#define FUNC_NUM 3
+
+/* The compact dump decoded, see aot_dump_pgo_counters_to_buf */
+struct PGOCounters {
+    uint32 magic;
+    uint32 version;
+    uint32 num_prof_data;
+    uint32 num_prof_counters;
+    uint64 layout_hash;
+    std::vector<uint64> counters;
+};
+
+class aot_pgo_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        inst = wasm_runtime_get_module_inst(env.get());
+        ASSERT_EQ(inst->module_type, Wasm_Module_AoT);
+    }
+
+    void run(DummyExecEnv &exec_env, uint32 n)
+    {
+        uint32 argv[1] = { n };
+
+        ASSERT_TRUE(exec_env.execute("run", 1, argv))
+            << exec_env.get_exception();
+    }
+
+    static void dump(wasm_module_inst_t module_inst, PGOCounters *result)
+    {
+        uint32 size = wasm_runtime_get_pgo_counters_size(module_inst);
+        std::vector<uint8> buf(size);
+        uint64 counter;
+        uint32 offset, shift;
+
+        ASSERT_GT(size, (uint32)PGO_COUNTERS_HEADER_SIZE);
+        ASSERT_EQ(wasm_runtime_dump_pgo_counters_to_buf(
+                      module_inst, (char *)buf.data(), size),
+                  size);
+
+        memcpy(&result->magic, buf.data(), 4);
+        memcpy(&result->version, buf.data() + 4, 4);
+        memcpy(&result->num_prof_data, buf.data() + 8, 4);
+        memcpy(&result->num_prof_counters, buf.data() + 12, 4);
+        memcpy(&result->layout_hash, buf.data() + 16, 8);
+
+        result->counters.clear();
+        for (offset = PGO_COUNTERS_HEADER_SIZE; offset < size;) {
+            counter = 0;
+            shift = 0;
+            do {
+                counter |= (uint64)(buf[offset] & 0x7F) << shift;
+                shift += 7;
+            } while (buf[offset++] & 0x80 && offset < size);
+            result->counters.push_back(counter);
+        }
+    }
+
+    static bool has_counter(const PGOCounters &dumped, uint64 value)
+    {
+        return std::find(dumped.counters.begin(), dumped.counters.end(),
+                         value)
+               != dumped.counters.end();
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    DummyExecEnv env{ "pgo.aot" };
+    wasm_module_inst_t inst = NULL;
+};
+
+TEST_F(aot_pgo_test, counters_dumped_compactly)
+{
+    PGOCounters before, after;
+
+    dump(inst, &before);
+    EXPECT_EQ(before.magic, (uint32)PGO_COUNTERS_MAGIC);
+    EXPECT_EQ(before.version, 1u);
+    EXPECT_EQ(before.num_prof_data, (uint32)FUNC_NUM);
+    EXPECT_EQ(before.counters.size(), before.num_prof_counters);
+    /* A zero counter takes a single byte */
+    EXPECT_EQ(wasm_runtime_get_pgo_counters_size(inst),
+              PGO_COUNTERS_HEADER_SIZE + before.num_prof_counters);
+    for (uint64 counter : before.counters)
+        EXPECT_EQ(counter, 0u);
+
+    /* $a is called 100 times and $b 200 times, the counts above 127
+       take several bytes */
+    run(env, 300);
+    dump(inst, &after);
+    EXPECT_EQ(after.layout_hash, before.layout_hash);
+    EXPECT_EQ(after.counters.size(), before.counters.size());
+    EXPECT_TRUE(has_counter(after, 100));
+    EXPECT_TRUE(has_counter(after, 200));
+    EXPECT_GT(wasm_runtime_get_pgo_counters_size(inst),
+              PGO_COUNTERS_HEADER_SIZE + after.num_prof_counters);
+
+    /* Too small a buffer */
+    std::vector<char> buf(wasm_runtime_get_pgo_counters_size(inst) - 1);
+    EXPECT_EQ(wasm_runtime_dump_pgo_counters_to_buf(inst, buf.data(),
+                                                    buf.size()),
+              0u);
+}
+
+TEST_F(aot_pgo_test, counters_accumulated_and_reset)
+{
+    DummyExecEnv other{ "pgo.aot" };
+    PGOCounters dumped, other_dumped;
+
+    run(env, 300);
+    run(env, 300);
+    dump(inst, &dumped);
+    EXPECT_TRUE(has_counter(dumped, 200));
+    EXPECT_TRUE(has_counter(dumped, 400));
+
+    /* Reset after a dump, the next one only holds the new counts */
+    wasm_runtime_reset_pgo_counters(inst);
+    dump(inst, &dumped);
+    for (uint64 counter : dumped.counters)
+        EXPECT_EQ(counter, 0u);
+
+    run(env, 30);
+    dump(inst, &dumped);
+    EXPECT_TRUE(has_counter(dumped, 10));
+    EXPECT_TRUE(has_counter(dumped, 20));
+
+    /* Another module loaded from the same file has the same layout and
+       counters of its own */
+    dump(wasm_runtime_get_module_inst(other.get()), &other_dumped);
+    EXPECT_EQ(other_dumped.layout_hash, dumped.layout_hash);
+    EXPECT_EQ(other_dumped.num_prof_counters, dumped.num_prof_counters);
+    for (uint64 counter : other_dumped.counters)
+        EXPECT_EQ(counter, 0u);
+}
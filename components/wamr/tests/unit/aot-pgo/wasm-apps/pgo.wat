@@ -0,0 +1,30 @@
+(module
+  ;; run(n) calls $a for the multiples of 3 below n and $b for the others
+
+  (global $acc (mut i32) (i32.const 0))
+
+  (func $a
+    global.get $acc i32.const 1 i32.add global.set $acc
+  )
+
+  (func $b
+    global.get $acc i32.const 2 i32.add global.set $acc
+  )
+
+  (func (export "run") (param $n i32) (result i32) (local $k i32)
+    block $done
+      loop $loop
+        local.get $k local.get $n i32.ge_u br_if $done
+        local.get $k i32.const 3 i32.rem_u i32.eqz
+        if
+          call $a
+        else
+          call $b
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    global.get $acc
+  )
+)
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aot_runtime.h"
+
+/* Alignment of the text holding the pre-linked read-only data */
+#define AOT_TEXT_RODATA_ALIGN 64
+
+class aot_xip_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        struct stat stat_buf;
+        int fd;
+
+        ASSERT_GE(fd = open("xip.aot", O_RDONLY), 0);
+        ASSERT_EQ(fstat(fd, &stat_buf), 0);
+        size = (uint32)stat_buf.st_size;
+        /* Read-only, the loader mustn't patch the text in place */
+        buf = (uint8 *)mmap(NULL, size, PROT_READ | PROT_EXEC, MAP_PRIVATE,
+                            fd, 0);
+        close(fd);
+        ASSERT_NE(buf, MAP_FAILED);
+    }
+
+    virtual void TearDown()
+    {
+        if (buf != MAP_FAILED)
+            munmap(buf, size);
+    }
+
+    wasm_module_t load()
+    {
+        LoadArgs args;
+
+        memset(&args, 0, sizeof(LoadArgs));
+        args.name = (char *)"xip.aot";
+        args.wasm_binary_freeable = false;
+        return wasm_runtime_load_ex(buf, size, &args, error_buf,
+                                    sizeof(error_buf));
+    }
+
+    /* Checks the functions of xip.wasm in a new instance of the module */
+    void check_run(wasm_module_t module)
+    {
+        wasm_module_inst_t inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        wasm_val_t args[2], result;
+
+        inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                        sizeof(error_buf));
+        ASSERT_TRUE(inst != NULL) << error_buf;
+        exec_env = wasm_runtime_create_exec_env(inst, 8192);
+        ASSERT_TRUE(exec_env != NULL);
+
+        /* |3.5| - (-2.0) */
+        args[0].kind = args[1].kind = WASM_F64;
+        args[0].of.f64 = 3.5;
+        args[1].of.f64 = -2.0;
+        func = wasm_runtime_lookup_function(inst, "sign_diff");
+        ASSERT_TRUE(func != NULL);
+        EXPECT_TRUE(wasm_runtime_call_wasm_a(exec_env, func, 1, &result, 2,
+                                             args))
+            << wasm_runtime_get_exception(inst);
+        EXPECT_EQ(result.of.f64, 5.5);
+
+        args[0].kind = WASM_I32;
+        args[0].of.i32 = 3;
+        func = wasm_runtime_lookup_function(inst, "pick");
+        ASSERT_TRUE(func != NULL);
+        EXPECT_TRUE(
+            wasm_runtime_call_wasm_a(exec_env, func, 1, &result, 1, args))
+            << wasm_runtime_get_exception(inst);
+        EXPECT_EQ(result.of.i32, 41);
+
+        wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(inst);
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    uint8 *buf = (uint8 *)MAP_FAILED;
+    uint32 size = 0;
+    char error_buf[128];
+};
+
+TEST_F(aot_xip_test, text_executed_in_place)
+{
+    wasm_module_t module;
+    uint8 *code;
+
+    ASSERT_TRUE(wasm_runtime_is_xip_file(buf, size));
+    ASSERT_TRUE((module = load()) != NULL) << error_buf;
+
+    /* The text isn't copied, and is aligned in the file for the read-only
+       data appended to it */
+    code = (uint8 *)((AOTModule *)module)->code;
+    EXPECT_TRUE(code >= buf && code < buf + size);
+    EXPECT_EQ((uintptr_t)(code - buf) % AOT_TEXT_RODATA_ALIGN, 0u);
+
+    check_run(module);
+    wasm_runtime_unload(module);
+}
+
+TEST_F(aot_xip_test, mapping_shared_by_modules)
+{
+    wasm_module_t module1, module2;
+
+    ASSERT_TRUE((module1 = load()) != NULL) << error_buf;
+    ASSERT_TRUE((module2 = load()) != NULL) << error_buf;
+    EXPECT_EQ(((AOTModule *)module1)->code, ((AOTModule *)module2)->code);
+
+    check_run(module1);
+    /* The text stays in place once the other module is unloaded */
+    wasm_runtime_unload(module1);
+    check_run(module2);
+    wasm_runtime_unload(module2);
+}
@@ -0,0 +1,25 @@
+(module
+  ;; In XIP mode, the floating point constants are loaded from a table, but
+  ;; the sign masks of the functions below are still in a constant pool of
+  ;; the AOT code, which wamrc pre-links into the text of the XIP file
+
+  (func $magnitude (param $x f64) (param $y f64) (result f64)
+    local.get $x local.get $y f64.copysign f64.abs
+  )
+
+  (func (export "sign_diff") (param $x f64) (param $y f64) (result f64)
+    local.get $x local.get $y call $magnitude local.get $y f64.neg f64.add
+  )
+
+  (func (export "pick") (param $i i32) (result i32)
+    block $d block $c4 block $c3 block $c2 block $c1 block $c0
+      local.get $i
+      br_table $c0 $c1 $c2 $c3 $c4 $d
+    end i32.const 11 return
+    end i32.const 23 return
+    end i32.const 37 return
+    end i32.const 41 return
+    end i32.const 59 return
+    end i32.const -1
+  )
+)
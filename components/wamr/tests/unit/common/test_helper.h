@@ -19,11 +19,8 @@ class WAMRRuntimeRAII
     char global_heap_buf[Size];
     RuntimeInitArgs init_args;
 
-  public:
-    WAMRRuntimeRAII()
+    void init()
     {
-        memset(&init_args, 0, sizeof(RuntimeInitArgs));
-
         init_args.mem_alloc_type = Alloc_With_Pool;
         init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
         init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
@@ -31,6 +28,20 @@ class WAMRRuntimeRAII
         wasm_runtime_full_init(&init_args);
     }
 
+  public:
+    WAMRRuntimeRAII()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init();
+    }
+
+    /* The options of args other than the memory allocator are used */
+    WAMRRuntimeRAII(const RuntimeInitArgs &args)
+    {
+        init_args = args;
+        init();
+    }
+
     ~WAMRRuntimeRAII() { wasm_runtime_destroy(); }
 };
 
@@ -45,7 +56,16 @@ class WAMRModule
         module_ = wasm_runtime_load(buffer, size, NULL, 0);
     }
 
-    ~WAMRModule() { wasm_runtime_unload(module_); }
+    /* Takes the module loaded otherwise, e.g. from a stream */
+    explicit WAMRModule(wasm_module_t module)
+      : module_(module)
+    {}
+
+    ~WAMRModule()
+    {
+        if (module_)
+            wasm_runtime_unload(module_);
+    }
 
     wasm_module_t get() const { return module_; }
 };
@@ -110,13 +130,16 @@ static uint8_t dummy_wasm_buffer[] = {
 class DummyExecEnv
 {
   private:
-    std::shared_ptr<WAMRExecEnv> dummy_exec_env_;
-    std::shared_ptr<WAMRInstance> inst_;
-    std::shared_ptr<WAMRModule> mod_;
+    /* Declared in the order they are created to be destroyed in the
+       reverse order, a loaded module may refer to the buffer until it is
+       unloaded, and an instance to its module */
     std::vector<uint8_t> my_wasm_buffer;
+    std::shared_ptr<WAMRModule> mod_;
+    std::shared_ptr<WAMRInstance> inst_;
+    std::shared_ptr<WAMRExecEnv> dummy_exec_env_;
 
   private:
-    void construct(uint8_t *buf, uint32_t len)
+    void construct(uint8_t *buf, uint32_t len, uint32_t heap_size = 8192)
     {
         std::vector<uint8_t> buffer(buf, buf + len);
         my_wasm_buffer = buffer;
@@ -124,7 +147,7 @@ class DummyExecEnv
         mod_ = std::make_shared<WAMRModule>(my_wasm_buffer.data(),
                                             my_wasm_buffer.size());
         EXPECT_NE(mod_.get(), nullptr);
-        inst_ = std::make_shared<WAMRInstance>(*mod_);
+        inst_ = std::make_shared<WAMRInstance>(*mod_, 8192, heap_size);
         EXPECT_NE(inst_.get(), nullptr);
         dummy_exec_env_ = std::make_shared<WAMRExecEnv>(*inst_);
         EXPECT_NE(dummy_exec_env_.get(), nullptr);
@@ -135,13 +158,13 @@ class DummyExecEnv
 
     DummyExecEnv(uint8_t *buf, uint32_t len) { construct(buf, len); }
 
-    DummyExecEnv(std::string filename)
+    DummyExecEnv(std::string filename, uint32_t heap_size = 8192)
     {
         std::ifstream wasm_file(filename, std::ios::binary);
         std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(wasm_file),
                                     {});
 
-        construct(buffer.data(), buffer.size());
+        construct(buffer.data(), buffer.size(), heap_size);
     }
 
     ~DummyExecEnv() {}
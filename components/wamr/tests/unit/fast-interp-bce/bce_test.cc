@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_runtime.h"
+
+#define PAGE_SIZE 65536
+
+/* The bounds checks eliminated by the fast interpreter loader must not let
+   an out of bounds access through, the tests run without the hardware
+   bound check so that every access relies on the software check, and
+   without app heap so that the memory ends where the module declares it */
+class bce_test : public testing::Test
+{
+  protected:
+    /* Check that the call traps with an out of bounds access, and clear
+       the exception for the next calls */
+    static void expect_oob(DummyExecEnv &env, const char *name, uint32_t argc,
+                           uint32_t argv[])
+    {
+        const char *exception;
+
+        EXPECT_FALSE(env.execute(name, argc, argv)) << name;
+        exception = env.get_exception();
+        EXPECT_TRUE(exception
+                    && strstr(exception, "out of bounds memory access"))
+            << name << ": " << (exception ? exception : "no exception");
+        env.clear_exception();
+    }
+
+    static void write_memory(DummyExecEnv &env, uint32_t offset,
+                             const void *data, uint32_t size)
+    {
+        uint8_t *base = (uint8_t *)env.app_to_native(offset);
+
+        ASSERT_TRUE(base != NULL);
+        memcpy(base, data, size);
+    }
+
+    static WASMModule *get_module(DummyExecEnv &env)
+    {
+        return (WASMModule *)wasm_runtime_get_module(
+            wasm_runtime_get_module_inst(env.get()));
+    }
+
+    WAMRRuntimeRAII<> runtime;
+};
+
+TEST_F(bce_test, set_local_is_checked_again)
+{
+    uint32_t value = 0x11223344;
+
+    DummyExecEnv env("bce.wasm", 0);
+    write_memory(env, 100, &value, sizeof(value));
+
+    {
+        uint32_t argv[2] = { 0, 100 };
+        ASSERT_TRUE(env.execute("after_set", 2, argv));
+        EXPECT_EQ(argv[0], value);
+    }
+    {
+        uint32_t argv[2] = { 0, PAGE_SIZE - 2 };
+        expect_oob(env, "after_set", 2, argv);
+    }
+    {
+        uint32_t argv[2] = { 0, 100 };
+        ASSERT_TRUE(env.execute("after_tee", 2, argv));
+        EXPECT_EQ(argv[0], value);
+    }
+    {
+        uint32_t argv[2] = { 0, PAGE_SIZE };
+        expect_oob(env, "after_tee", 2, argv);
+    }
+
+    /* The old value of the local, which is checked, is used */
+    {
+        uint32_t argv[2] = { 100, PAGE_SIZE };
+        ASSERT_TRUE(env.execute("before_set", 2, argv));
+        EXPECT_EQ(argv[0], value);
+    }
+}
+
+TEST_F(bce_test, checked_local_is_forgotten_at_join_points)
+{
+    DummyExecEnv env("bce.wasm", 0);
+
+    /* Checked before the loop, set in the body, the next iteration
+       accesses out of bounds */
+    {
+        uint32_t argv[3] = { 0, 8, 3 };
+        ASSERT_TRUE(env.execute("in_loop", 3, argv));
+    }
+    {
+        uint32_t argv[3] = { 0, PAGE_SIZE - 3, 2 };
+        expect_oob(env, "in_loop", 3, argv);
+    }
+
+    /* Checked in the then arm, accessed in the else arm */
+    {
+        uint32_t argv[2] = { 0, 0 };
+        ASSERT_TRUE(env.execute("in_else", 2, argv));
+    }
+    {
+        uint32_t argv[2] = { PAGE_SIZE, 0 };
+        expect_oob(env, "in_else", 2, argv);
+    }
+    {
+        uint32_t argv[2] = { PAGE_SIZE, 1 };
+        expect_oob(env, "in_else", 2, argv);
+    }
+
+    /* Checked in the arm not taken, accessed after it */
+    {
+        uint32_t argv[2] = { PAGE_SIZE - 1, 0 };
+        expect_oob(env, "after_if", 2, argv);
+    }
+
+    /* Checked in the try and catch blocks skipped, accessed after them */
+    {
+        uint32_t argv[1] = { 4 };
+        ASSERT_TRUE(env.execute("after_try", 1, argv));
+    }
+    {
+        uint32_t argv[1] = { PAGE_SIZE };
+        expect_oob(env, "after_try", 1, argv);
+    }
+}
+
+TEST_F(bce_test, const_address_around_memory_end)
+{
+    uint32_t value = 0xaabbccdd;
+    uint32_t argv[2] = { 0 };
+
+    DummyExecEnv env("bce.wasm", 0);
+
+    /* The highest const access without bounds check ends at the end of
+       the memory, the ones beyond it keep their checks */
+    EXPECT_EQ(get_module(env)->unchecked_mem_end, (uint64)PAGE_SIZE);
+
+    write_memory(env, PAGE_SIZE - 4, &value, sizeof(value));
+    ASSERT_TRUE(env.execute("load_const_last", 0, argv));
+    EXPECT_EQ(argv[0], value);
+    ASSERT_TRUE(env.execute("load8_const_last", 0, argv));
+    EXPECT_EQ(argv[0], 0xaau);
+
+    /* At unchecked_mem_end and one byte past it */
+    expect_oob(env, "load8_const_at_end", 0, argv);
+    expect_oob(env, "load8_const_past_end", 0, argv);
+
+    /* Accesses starting before the end and ending after it */
+    expect_oob(env, "load_const_cross_end", 0, argv);
+    expect_oob(env, "load_const_offset_cross_end", 0, argv);
+    argv[0] = 0x12345678;
+    argv[1] = 0x9abcdef0;
+    expect_oob(env, "store_const_cross_end", 2, argv);
+}
+
+TEST_F(bce_test, memory_not_shrunk_below_unchecked_access)
+{
+    wasm_memory_inst_t memory;
+    uint64 memory_data_size;
+    uint32_t argv[1];
+
+    DummyExecEnv env("bce_shrunk.wasm", 0);
+
+    /* The 4 bytes at 40000 are accessed with a const address, the memory
+       is shrunk to the aligned end of them rather than to __heap_base */
+    EXPECT_EQ(get_module(env)->unchecked_mem_end, 40004u);
+    memory = wasm_runtime_get_default_memory(
+        wasm_runtime_get_module_inst(env.get()));
+    ASSERT_TRUE(memory != NULL);
+    EXPECT_EQ(wasm_memory_get_cur_page_count(memory)
+                  * wasm_memory_get_bytes_per_page(memory),
+              40008u);
+
+    argv[0] = 0x01020304;
+    ASSERT_TRUE(env.execute("store_const", 1, argv));
+    ASSERT_TRUE(env.execute("load_const", 0, argv));
+    EXPECT_EQ(argv[0], 0x01020304u);
+
+    argv[0] = 40000;
+    ASSERT_TRUE(env.execute("load8", 1, argv));
+    EXPECT_EQ(argv[0], 0x04u);
+    argv[0] = 40007;
+    ASSERT_TRUE(env.execute("load8", 1, argv));
+    EXPECT_EQ(argv[0], 0u);
+
+    /* The linear memory allocated is rounded up to the system page size,
+       the access right after it traps */
+    memory_data_size =
+        ((WASMModuleInstance *)wasm_runtime_get_module_inst(env.get()))
+            ->memories[0]
+            ->memory_data_size;
+    ASSERT_GE(memory_data_size, 40008u);
+    ASSERT_LT(memory_data_size, (uint64)PAGE_SIZE);
+    argv[0] = (uint32_t)memory_data_size - 1;
+    ASSERT_TRUE(env.execute("load8", 1, argv));
+    argv[0] = (uint32_t)memory_data_size;
+    expect_oob(env, "load8", 1, argv);
+}
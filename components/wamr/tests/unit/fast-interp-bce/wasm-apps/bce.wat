@@ -0,0 +1,105 @@
+(module
+  ;; Accesses whose bounds checks may be eliminated by the fast interpreter
+  ;; loader, and the out of bounds ones among them which must still trap.
+  ;; The memory has 1 page, the highest const access ends at 65536.
+
+  (memory (export "memory") 1)
+  (tag $e)
+
+  ;; A checked local is set to another address
+  (func (export "after_set") (param $a i32) (param $b i32) (result i32)
+    local.get $a i32.load drop
+    local.get $b local.set $a
+    local.get $a i32.load
+  )
+
+  (func (export "after_tee") (param $a i32) (param $b i32) (result i32)
+    local.get $a i32.load drop
+    local.get $b local.tee $a drop
+    local.get $a i32.load
+  )
+
+  ;; The address is the value of the local before it is set
+  (func (export "before_set") (param $a i32) (param $b i32) (result i32)
+    local.get $a i32.load drop
+    local.get $a
+    local.get $b local.set $a
+    i32.load
+  )
+
+  ;; The local is checked before the loop, and set at the end of the body
+  (func (export "in_loop") (param $a i32) (param $b i32) (param $n i32) (result i32)
+    local.get $a i32.load drop
+    loop $loop
+      local.get $a i32.load drop
+      local.get $b local.set $a
+      local.get $n i32.const 1 i32.sub local.tee $n
+      br_if $loop
+    end
+    i32.const 0
+  )
+
+  ;; The local is only checked in the other arm
+  (func (export "in_else") (param $a i32) (param $c i32) (result i32)
+    local.get $c
+    if (result i32)
+      local.get $a i32.load
+    else
+      local.get $a i32.load
+    end
+  )
+
+  ;; The local is only checked in the arm not taken
+  (func (export "after_if") (param $a i32) (param $c i32) (result i32)
+    local.get $c
+    if
+      local.get $a i32.load drop
+    end
+    local.get $a i32.load
+  )
+
+  ;; The fast interpreter doesn't run try/catch, so the try block is only
+  ;; loaded and skipped, the local is never checked when running
+  (func (export "after_try") (param $a i32) (result i32)
+    block $skip
+      i32.const 1 br_if $skip
+      try
+        local.get $a i32.load drop
+      catch $e
+        local.get $a i32.load drop
+      catch_all
+        local.get $a i32.load drop
+      end
+    end
+    local.get $a i32.load
+  )
+
+  ;; Const addresses around the end of the memory
+  (func (export "load_const_last") (result i32)
+    i32.const 65532 i32.load
+  )
+
+  (func (export "load8_const_last") (result i32)
+    i32.const 65535 i32.load8_u
+  )
+
+  (func (export "load8_const_at_end") (result i32)
+    i32.const 65536 i32.load8_u
+  )
+
+  (func (export "load8_const_past_end") (result i32)
+    i32.const 65537 i32.load8_u
+  )
+
+  (func (export "load_const_cross_end") (result i32)
+    i32.const 65533 i32.load
+  )
+
+  (func (export "load_const_offset_cross_end") (result i32)
+    i32.const 65532 i32.load offset=1
+  )
+
+  (func (export "store_const_cross_end") (param $v i64)
+    i32.const 65529 local.get $v i64.store
+  )
+)
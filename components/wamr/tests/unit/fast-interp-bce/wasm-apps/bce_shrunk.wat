@@ -0,0 +1,23 @@
+(module
+  ;; The memory is shrunk to __heap_base at load time as nothing grows it,
+  ;; but not below the end of the const access without bounds check
+
+  (memory (export "memory") 2)
+  (global $sp (mut i32) (i32.const 1024))
+  (global $data_end i32 (i32.const 1024))
+  (global $heap_base i32 (i32.const 1024))
+  (export "__data_end" (global $data_end))
+  (export "__heap_base" (global $heap_base))
+
+  (func (export "store_const") (param $v i32)
+    i32.const 40000 local.get $v i32.store
+  )
+
+  (func (export "load_const") (result i32)
+    i32.const 40000 i32.load
+  )
+
+  (func (export "load8") (param $a i32) (result i32)
+    local.get $a i32.load8_u
+  )
+)
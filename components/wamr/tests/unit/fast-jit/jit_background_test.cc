@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "jit_compiler.h"
+
+#if WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0
+
+#define THREAD_NUM 4
+
+static uint32_t
+fib_expected(uint32_t n)
+{
+    return n < 2 ? n : fib_expected(n - 1) + fib_expected(n - 2);
+}
+
+static uint32_t
+sum_expected(uint32_t n)
+{
+    uint32_t acc = 0, k;
+
+    for (k = 0; k < n; k++)
+        acc += fib_expected(k % 16) * (k + 1);
+    return acc;
+}
+
+/* Call the functions of wasm-apps/background.wat while they are compiled
+   by the background threads of the JIT compiler */
+class jit_background_test : public testing::Test
+{
+  protected:
+    static RuntimeInitArgs fast_jit_args(uint32_t compile_threshold)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.running_mode = Mode_Fast_JIT;
+        init_args.fast_jit_compile_threshold = compile_threshold;
+        return init_args;
+    }
+
+    bool is_compiled(uint32_t func_idx)
+    {
+        return jit_compiler_is_compiled((WASMModule *)module, func_idx);
+    }
+
+    bool all_compiled()
+    {
+        WASMModule *wasm_module = (WASMModule *)module;
+        uint32_t i;
+
+        for (i = 0; i < wasm_module->function_count; i++)
+            if (!is_compiled(wasm_module->import_function_count + i))
+                return false;
+        return true;
+    }
+
+    /* Wait until the background threads compile all the functions */
+    bool wait_all_compiled()
+    {
+        uint32_t i;
+
+        for (i = 0; i < 10000 && !all_compiled(); i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return all_compiled();
+    }
+
+    static uint32_t call(wasm_exec_env_t exec_env, const char *name,
+                         uint32_t arg, bool *ok)
+    {
+        wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+        wasm_function_inst_t func;
+        uint32_t argv[1] = { arg };
+
+        if (!(func = wasm_runtime_lookup_function(module_inst, name))
+            || !wasm_runtime_call_wasm(exec_env, func, 1, argv)) {
+            *ok = false;
+            return 0;
+        }
+        return argv[0];
+    }
+
+    wasm_module_t module = NULL;
+};
+
+TEST_F(jit_background_test, interpret_until_compiled_in_background)
+{
+    WAMRRuntimeRAII<> runtime(fast_jit_args(5));
+    DummyExecEnv env("background.wasm");
+    bool ok = true;
+    uint32_t i;
+
+    module = wasm_runtime_get_module(wasm_runtime_get_module_inst(env.get()));
+
+    /* Nothing is compiled at load time, sum is called fewer times than
+       the threshold and stays interpreted */
+    EXPECT_FALSE(all_compiled());
+    for (i = 0; i < 4; i++)
+        EXPECT_EQ(call(env.get(), "sum", i, &ok), sum_expected(i));
+    EXPECT_FALSE(is_compiled(1));
+
+    /* fib is called recursively, it reaches the threshold in one call */
+    EXPECT_EQ(call(env.get(), "fib", 10, &ok), fib_expected(10));
+    EXPECT_EQ(call(env.get(), "sum", 40, &ok), sum_expected(40));
+    ASSERT_TRUE(wait_all_compiled());
+
+    /* And the jitted code gives the same results */
+    for (i = 0; i < 20; i++) {
+        EXPECT_EQ(call(env.get(), "fib", i, &ok), fib_expected(i));
+        EXPECT_EQ(call(env.get(), "sum", i * 7, &ok), sum_expected(i * 7));
+    }
+    EXPECT_TRUE(ok) << env.get_exception();
+}
+
+TEST_F(jit_background_test, call_while_tier_up_is_racing)
+{
+    /* A low threshold, so that the functions are compiled while the
+       threads keep calling them */
+    WAMRRuntimeRAII<> runtime(fast_jit_args(2));
+    std::ifstream wasm_file("background.wasm", std::ios::binary);
+    std::vector<uint8_t> wasm_buf(std::istreambuf_iterator<char>(wasm_file),
+                                  {});
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t> mismatches(0), failures(0);
+    uint32_t i;
+
+    /* The instances of one module are called from the threads */
+    WAMRModule wamr_module(wasm_buf.data(), wasm_buf.size());
+    ASSERT_TRUE((module = wamr_module.get()) != NULL);
+    std::vector<std::unique_ptr<WAMRInstance>> insts;
+    for (i = 0; i < THREAD_NUM; i++) {
+        insts.emplace_back(new WAMRInstance(wamr_module));
+        ASSERT_TRUE(insts[i]->get() != NULL);
+    }
+
+    for (i = 0; i < THREAD_NUM; i++) {
+        threads.emplace_back([&, i]() {
+            uint32_t j, n;
+            bool ok = true;
+
+            if (!wasm_runtime_init_thread_env()) {
+                failures++;
+                return;
+            }
+
+            {
+                WAMRExecEnv exec_env(*insts[i], 16384);
+
+                for (j = 0; j < 200 && exec_env.get(); j++) {
+                    n = (i + j) % 16;
+                    if (call(exec_env.get(), "fib", n, &ok)
+                        != fib_expected(n))
+                        mismatches++;
+                    if (call(exec_env.get(), "sum", n * 3, &ok)
+                        != sum_expected(n * 3))
+                        mismatches++;
+                }
+                if (!exec_env.get() || !ok)
+                    failures++;
+            }
+
+            wasm_runtime_destroy_thread_env();
+        });
+    }
+
+    for (i = 0; i < THREAD_NUM; i++)
+        threads[i].join();
+
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_EQ(mismatches.load(), 0u);
+    EXPECT_TRUE(wait_all_compiled());
+}
+
+TEST_F(jit_background_test, unload_with_queued_functions)
+{
+    WAMRRuntimeRAII<> runtime(fast_jit_args(1));
+    bool ok = true;
+    uint32_t round;
+
+    /* Unloading drops the requests still queued and waits for the
+       functions being compiled */
+    for (round = 0; round < 20; round++) {
+        DummyExecEnv env("background.wasm");
+
+        EXPECT_EQ(call(env.get(), "sum", 20, &ok), sum_expected(20));
+        EXPECT_TRUE(ok) << env.get_exception();
+    }
+}
+
+#endif /* end of WASM_ENABLE_FAST_JIT_BACKGROUND_COMPILE != 0 */
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+/* The functions exported by wasm-apps/code_cache.wat */
+#define FUNC_NUM 16
+
+static uint32_t
+h(uint32_t a, uint32_t b)
+{
+    return a * b + 7;
+}
+
+static uint32_t
+f_expected(uint32_t i, uint32_t x)
+{
+    uint32_t K = i + 1, acc = K, k;
+
+    for (k = 0; k < x; k++) {
+        switch (k % 10 % 4) {
+            case 0:
+                acc += h(k, K);
+                break;
+            case 1:
+                acc ^= k << 3;
+                break;
+            case 2:
+                acc *= 3;
+                break;
+            default:
+                acc -= K;
+                break;
+        }
+    }
+    return acc;
+}
+
+class jit_codecache_test : public testing::Test
+{
+  protected:
+    static RuntimeInitArgs fast_jit_args(uint32_t code_cache_size)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.running_mode = Mode_Fast_JIT;
+        init_args.fast_jit_code_cache_size = code_cache_size;
+        return init_args;
+    }
+
+    static uint32_t call_f(DummyExecEnv &env, uint32_t i, uint32_t x)
+    {
+        uint32_t argv[1] = { x };
+        char name[16];
+
+        snprintf(name, sizeof(name), "f%u", i);
+        EXPECT_TRUE(env.execute(name, 1, argv))
+            << name << ": " << env.get_exception();
+        return argv[0];
+    }
+
+    static fast_jit_code_cache_info_t get_info()
+    {
+        fast_jit_code_cache_info_t info;
+
+        EXPECT_TRUE(wasm_runtime_get_fast_jit_code_cache_info(&info));
+        return info;
+    }
+};
+
+TEST_F(jit_codecache_test, evict_and_compact_then_call_moved_functions)
+{
+    fast_jit_code_cache_info_t info0, info1, info;
+    uint32_t func_size, i, j, round;
+
+    /* Measure the size of the jitted code in a large enough code cache,
+       the code cache holds the glue code before the module is loaded */
+    {
+        WAMRRuntimeRAII<> runtime(fast_jit_args(4 * 1024 * 1024));
+
+        info0 = get_info();
+        DummyExecEnv env("code_cache.wasm");
+        for (i = 0; i < FUNC_NUM; i++)
+            ASSERT_EQ(call_f(env, i, 30), f_expected(i, 30));
+        info1 = get_info();
+        ASSERT_EQ(info1.evicted_function_count, 0u);
+        ASSERT_EQ(info1.compaction_count, 0u);
+        /* The functions and the helper they call */
+        ASSERT_EQ(info1.function_count, (uint32_t)FUNC_NUM + 1);
+        func_size = (info1.used_size - info0.used_size) / (FUNC_NUM + 1);
+    }
+
+    /* Only about half of the functions fit, the even ones are called more
+       often, so mostly the odd ones are evicted, and the even ones after
+       them are moved to merge the free space */
+    WAMRRuntimeRAII<> runtime(
+        fast_jit_args(info0.used_size + func_size * (FUNC_NUM / 2 + 1)));
+    DummyExecEnv env("code_cache.wasm");
+
+    for (round = 0; round < 4; round++) {
+        for (i = 0; i < FUNC_NUM; i++) {
+            for (j = 0; j < (i % 2 == 0 ? 8u : 1u); j++)
+                ASSERT_EQ(call_f(env, i, 20 + j), f_expected(i, 20 + j));
+        }
+    }
+
+    info = get_info();
+    EXPECT_GT(info.evicted_function_count, 0u);
+    EXPECT_GT(info.compaction_count, 0u);
+    EXPECT_GT(info.moved_size, 0u);
+    EXPECT_LE(info.used_size, info.total_size);
+
+    /* The moved functions, and the evicted ones compiled again, still
+       return the right results */
+    for (round = 0; round < 2; round++) {
+        for (i = 0; i < FUNC_NUM; i++)
+            ASSERT_EQ(call_f(env, i, 37), f_expected(i, 37));
+    }
+    for (i = FUNC_NUM; i-- > 0;)
+        ASSERT_EQ(call_f(env, i, 41), f_expected(i, 41));
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "jit_compiler.h"
+#include "jit_ir.h"
+
+/* Run the optimization passes of jit_optimize.c on hand-built IR and check
+   the instructions they leave, the runtime enables all the passes */
+class jit_optimize_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        cc = (JitCompContext *)jit_calloc(sizeof(*cc));
+        ASSERT_TRUE(cc != NULL);
+        ASSERT_TRUE(jit_cc_init(cc, 64) != NULL);
+        cc->cur_basic_block = jit_cc_entry_basic_block(cc);
+    }
+
+    virtual void TearDown()
+    {
+        if (cc)
+            jit_cc_delete(cc);
+    }
+
+    JitReg load(int32 offset)
+    {
+        JitReg reg = jit_cc_new_reg_I32(cc);
+
+        GEN_INSN(LDI32, reg, cc->fp_reg, NEW_CONST(I32, offset));
+        return reg;
+    }
+
+    std::vector<JitInsn *> insns_of(JitBasicBlock *block)
+    {
+        std::vector<JitInsn *> insns;
+        JitInsn *insn;
+
+        JIT_FOREACH_INSN(block, insn)
+        insns.push_back(insn);
+        return insns;
+    }
+
+    bool is_const_I32(JitReg reg, int32 val)
+    {
+        return jit_reg_is_const(reg) && jit_reg_kind(reg) == JIT_REG_KIND_I32
+               && jit_cc_get_const_I32(cc, reg) == val;
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    JitCompContext *cc = NULL;
+};
+
+TEST_F(jit_optimize_test, const_fold_folds_and_propagates_constants)
+{
+    JitReg r0, r1, r2, r3, r4;
+    std::vector<JitInsn *> insns;
+
+    r0 = load(16);
+    r1 = jit_cc_new_reg_I32(cc);
+    r2 = jit_cc_new_reg_I32(cc);
+    r3 = jit_cc_new_reg_I32(cc);
+    r4 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MOV, r1, NEW_CONST(I32, 6));
+    GEN_INSN(MUL, r2, r1, NEW_CONST(I32, 7));
+    GEN_INSN(ADD, r3, r0, r2);
+    GEN_INSN(MUL, r4, r3, NEW_CONST(I32, 1));
+    GEN_INSN(STI32, r4, cc->fp_reg, NEW_CONST(I32, 20));
+
+    ASSERT_TRUE(jit_pass_const_fold(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 6u);
+    /* MUL r2, 6, 7 is folded */
+    EXPECT_EQ(insns[2]->opcode, JIT_OP_MOV);
+    EXPECT_EQ(*jit_insn_opnd(insns[2], 0), r2);
+    EXPECT_TRUE(is_const_I32(*jit_insn_opnd(insns[2], 1), 42));
+    /* The folded value is propagated into the ADD */
+    EXPECT_EQ(insns[3]->opcode, JIT_OP_ADD);
+    EXPECT_EQ(*jit_insn_opnd(insns[3], 1), r0);
+    EXPECT_TRUE(is_const_I32(*jit_insn_opnd(insns[3], 2), 42));
+    /* x * 1 is simplified to a copy */
+    EXPECT_EQ(insns[4]->opcode, JIT_OP_MOV);
+    EXPECT_EQ(*jit_insn_opnd(insns[4], 0), r4);
+    EXPECT_EQ(*jit_insn_opnd(insns[4], 1), r3);
+    /* The store doesn't accept a constant value, it is left as is */
+    EXPECT_EQ(insns[5]->opcode, JIT_OP_STI32);
+    EXPECT_EQ(*jit_insn_opnd(insns[5], 0), r4);
+}
+
+TEST_F(jit_optimize_test, copy_prop_stops_at_redefined_source)
+{
+    JitReg r0, r1, r2, r3;
+    std::vector<JitInsn *> insns;
+
+    r0 = load(16);
+    r1 = jit_cc_new_reg_I32(cc);
+    r2 = jit_cc_new_reg_I32(cc);
+    r3 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MOV, r1, r0);
+    GEN_INSN(ADD, r2, r1, r1);
+    /* Re-define the source of the copy */
+    GEN_INSN(LDI32, r0, cc->fp_reg, NEW_CONST(I32, 24));
+    GEN_INSN(ADD, r3, r1, r2);
+
+    ASSERT_TRUE(jit_pass_copy_prop(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 5u);
+    EXPECT_EQ(*jit_insn_opnd(insns[2], 1), r0);
+    EXPECT_EQ(*jit_insn_opnd(insns[2], 2), r0);
+    /* r1 no longer holds the value of r0 */
+    EXPECT_EQ(*jit_insn_opnd(insns[4], 1), r1);
+    EXPECT_EQ(*jit_insn_opnd(insns[4], 2), r2);
+}
+
+TEST_F(jit_optimize_test, cse_reuses_loads_and_expressions)
+{
+    JitReg r0, r1, r2, r3, r4;
+    std::vector<JitInsn *> insns;
+
+    r0 = load(16);
+    r1 = jit_cc_new_reg_I32(cc);
+    r3 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(ADD, r1, r0, NEW_CONST(I32, 4));
+    r2 = load(16);
+    /* The same expression through the reloaded value */
+    GEN_INSN(ADD, r3, r2, NEW_CONST(I32, 4));
+    GEN_INSN(STI32, r3, cc->fp_reg, NEW_CONST(I32, 20));
+    /* The store may change the loaded value */
+    r4 = load(16);
+    GEN_INSN(STI32, r4, cc->fp_reg, NEW_CONST(I32, 24));
+
+    ASSERT_TRUE(jit_pass_cse(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 7u);
+    EXPECT_EQ(insns[2]->opcode, JIT_OP_MOV);
+    EXPECT_EQ(*jit_insn_opnd(insns[2], 0), r2);
+    EXPECT_EQ(*jit_insn_opnd(insns[2], 1), r0);
+    EXPECT_EQ(insns[3]->opcode, JIT_OP_MOV);
+    EXPECT_EQ(*jit_insn_opnd(insns[3], 0), r3);
+    EXPECT_EQ(*jit_insn_opnd(insns[3], 1), r1);
+    EXPECT_EQ(insns[5]->opcode, JIT_OP_LDI32);
+    EXPECT_EQ(*jit_insn_opnd(insns[5], 0), r4);
+}
+
+TEST_F(jit_optimize_test, cse_not_across_call)
+{
+    JitReg r0, r1, r2, r3;
+    JitInsn *call;
+    std::vector<JitInsn *> insns;
+
+    r0 = load(16);
+    r1 = load(20);
+    r2 = jit_cc_new_reg_I32(cc);
+    r3 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MUL, r2, r0, r1);
+    GEN_INSN(STI32, r2, cc->fp_reg, NEW_CONST(I32, 24));
+    call = GEN_INSN(CALLNATIVE, 0, NEW_CONST(PTR, (uintptr_t)abort), 0);
+    ASSERT_TRUE(call != NULL);
+    GEN_INSN(MUL, r3, r0, r1);
+    GEN_INSN(STI32, r3, cc->fp_reg, NEW_CONST(I32, 28));
+
+    ASSERT_TRUE(jit_pass_cse(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 7u);
+    EXPECT_EQ(insns[4], call);
+    /* Re-computed rather than kept alive across the call */
+    EXPECT_EQ(insns[5]->opcode, JIT_OP_MUL);
+    EXPECT_EQ(*jit_insn_opnd(insns[5], 0), r3);
+}
+
+TEST_F(jit_optimize_test, cse_removes_duplicate_check)
+{
+    JitBasicBlock *exce_block;
+    JitReg r0, r1, exce_label;
+    std::vector<JitInsn *> insns;
+
+    exce_block = jit_cc_new_basic_block(cc, 0);
+    ASSERT_TRUE(exce_block != NULL);
+    exce_label = jit_basic_block_label(exce_block);
+
+    r0 = load(16);
+    r1 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(CMP, cc->cmp_reg, r0, NEW_CONST(I32, 100));
+    GEN_INSN(BGTU, cc->cmp_reg, exce_label, 0);
+    /* The same check again is removed */
+    GEN_INSN(CMP, cc->cmp_reg, r0, NEW_CONST(I32, 100));
+    GEN_INSN(BGTU, cc->cmp_reg, exce_label, 0);
+    GEN_INSN(STI32, r0, cc->fp_reg, NEW_CONST(I32, 20));
+    /* And a third one is kept since its flags are also read by SELECT */
+    GEN_INSN(CMP, cc->cmp_reg, r0, NEW_CONST(I32, 100));
+    GEN_INSN(BGTU, cc->cmp_reg, exce_label, 0);
+    GEN_INSN(SELECTEQ, r1, cc->cmp_reg, r0, NEW_CONST(I32, 1));
+    GEN_INSN(STI32, r1, cc->fp_reg, NEW_CONST(I32, 24));
+
+    ASSERT_TRUE(jit_pass_cse(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 8u);
+    EXPECT_EQ(insns[1]->opcode, JIT_OP_CMP);
+    EXPECT_EQ(insns[2]->opcode, JIT_OP_BGTU);
+    EXPECT_EQ(insns[3]->opcode, JIT_OP_STI32);
+    EXPECT_EQ(insns[4]->opcode, JIT_OP_CMP);
+    EXPECT_EQ(insns[5]->opcode, JIT_OP_BGTU);
+    EXPECT_EQ(insns[6]->opcode, JIT_OP_SELECTEQ);
+}
+
+TEST_F(jit_optimize_test, dce_removes_unused_pure_insns)
+{
+    JitReg r0, r1, r2, r3;
+    std::vector<JitInsn *> insns;
+
+    r0 = load(16);
+    r1 = jit_cc_new_reg_I32(cc);
+    r2 = jit_cc_new_reg_I32(cc);
+    r3 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(ADD, r1, r0, NEW_CONST(I32, 1));
+    /* Only used by the unused MUL below */
+    GEN_INSN(MUL, r2, r1, NEW_CONST(I32, 3));
+    GEN_INSN(ADD, r3, r0, NEW_CONST(I32, 2));
+    GEN_INSN(STI32, r3, cc->fp_reg, NEW_CONST(I32, 20));
+    /* An unused load may trap, it is kept */
+    load(1024);
+
+    ASSERT_TRUE(jit_pass_dce(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 4u);
+    EXPECT_EQ(insns[0]->opcode, JIT_OP_LDI32);
+    EXPECT_EQ(insns[1]->opcode, JIT_OP_ADD);
+    EXPECT_EQ(*jit_insn_opnd(insns[1], 0), r3);
+    EXPECT_EQ(insns[2]->opcode, JIT_OP_STI32);
+    EXPECT_EQ(insns[3]->opcode, JIT_OP_LDI32);
+}
+
+TEST_F(jit_optimize_test, no_propagation_across_blocks)
+{
+    JitBasicBlock *block;
+    JitReg r0, r1, r2, r3, r4;
+    std::vector<JitInsn *> insns;
+
+    block = jit_cc_new_basic_block(cc, 0);
+    ASSERT_TRUE(block != NULL);
+
+    r0 = load(16);
+    r1 = jit_cc_new_reg_I32(cc);
+    r2 = jit_cc_new_reg_I32(cc);
+    r3 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MOV, r1, NEW_CONST(I32, 5));
+    GEN_INSN(MOV, r2, r0);
+    GEN_INSN(JMP, jit_basic_block_label(block));
+
+    cc->cur_basic_block = block;
+    GEN_INSN(ADD, r3, r1, r2);
+    r4 = load(16);
+    GEN_INSN(STI32, r3, cc->fp_reg, NEW_CONST(I32, 20));
+    GEN_INSN(STI32, r4, cc->fp_reg, NEW_CONST(I32, 24));
+
+    ASSERT_TRUE(jit_pass_const_fold(cc));
+    ASSERT_TRUE(jit_pass_copy_prop(cc));
+    ASSERT_TRUE(jit_pass_cse(cc));
+    ASSERT_TRUE(jit_pass_dce(cc));
+
+    /* The copies are still used by the other block */
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 4u);
+    EXPECT_EQ(insns[1]->opcode, JIT_OP_MOV);
+    EXPECT_EQ(insns[2]->opcode, JIT_OP_MOV);
+
+    insns = insns_of(block);
+    ASSERT_EQ(insns.size(), 4u);
+    EXPECT_EQ(insns[0]->opcode, JIT_OP_ADD);
+    EXPECT_EQ(*jit_insn_opnd(insns[0], 1), r1);
+    EXPECT_EQ(*jit_insn_opnd(insns[0], 2), r2);
+    EXPECT_EQ(insns[1]->opcode, JIT_OP_LDI32);
+    EXPECT_EQ(*jit_insn_opnd(insns[1], 0), r4);
+}
+
+TEST_F(jit_optimize_test, disabled_pass_leaves_ir_unchanged)
+{
+    JitReg r0, r1;
+    std::vector<JitInsn *> insns;
+
+    r0 = jit_cc_new_reg_I32(cc);
+    r1 = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MOV, r0, NEW_CONST(I32, 6));
+    GEN_INSN(ADD, r1, r0, NEW_CONST(I32, 1));
+    GEN_INSN(STI32, r1, cc->fp_reg, NEW_CONST(I32, 20));
+
+    jit_compiler_get_jit_globals()->disabled_opt_passes =
+        JIT_OPT_PASS_CONST_FOLD;
+    ASSERT_TRUE(jit_pass_const_fold(cc));
+
+    insns = insns_of(jit_cc_entry_basic_block(cc));
+    ASSERT_EQ(insns.size(), 3u);
+    EXPECT_EQ(insns[1]->opcode, JIT_OP_ADD);
+    EXPECT_EQ(*jit_insn_opnd(insns[1], 1), r0);
+}
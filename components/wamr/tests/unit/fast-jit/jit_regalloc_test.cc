@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "jit_compiler.h"
+
+/* Run wasm-apps/regalloc.wat with Fast JIT and with the interpreter, with
+   and without the global register allocation of local variables */
+class jit_regalloc_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        ASSERT_TRUE(wasm_runtime_set_default_running_mode(Mode_Fast_JIT));
+    }
+
+    /* Call the function with an i32 argument, returning the cells of the
+       result, the second one is 0 for an i32 result */
+    static uint64_t call(DummyExecEnv &env, const char *name, uint32_t arg)
+    {
+        uint32_t argv[2] = { arg, 0 };
+        uint64_t result;
+
+        EXPECT_TRUE(env.execute(name, 1, argv))
+            << name << ": " << env.get_exception();
+        memcpy(&result, argv, sizeof(result));
+        return result;
+    }
+
+    /* The passes are disabled before the module is loaded and compiled */
+    void check_same_results(uint32_t disabled_opt_passes)
+    {
+        static const char *names[] = { "pressure", "fpressure" };
+        static const uint32_t args[] = { 0, 1, 4, 5, 37, 100 };
+        uint32_t i, j, x;
+
+        jit_compiler_get_jit_globals()->disabled_opt_passes =
+            disabled_opt_passes;
+
+        DummyExecEnv jit_env("regalloc.wasm");
+        DummyExecEnv interp_env("regalloc.wasm");
+
+        ASSERT_EQ(wasm_runtime_get_running_mode(
+                      wasm_runtime_get_module_inst(jit_env.get())),
+                  Mode_Fast_JIT);
+        ASSERT_TRUE(wasm_runtime_set_running_mode(
+            wasm_runtime_get_module_inst(interp_env.get()), Mode_Interp));
+
+        for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+            for (j = 0; j < sizeof(args) / sizeof(args[0]); j++)
+                EXPECT_EQ(call(jit_env, names[i], args[j]),
+                          call(interp_env, names[i], args[j]))
+                    << names[i] << "(" << args[j] << ")";
+        }
+
+        for (x = 0; x < 300; x += 7)
+            EXPECT_EQ((uint32_t)call(jit_env, "blocks", x),
+                      (uint32_t)call(interp_env, "blocks", x))
+                << "blocks(" << x << ")";
+    }
+
+    WAMRRuntimeRAII<> runtime;
+};
+
+TEST_F(jit_regalloc_test, global_regalloc_matches_interpreter)
+{
+    check_same_results(0);
+}
+
+TEST_F(jit_regalloc_test, local_regalloc_matches_interpreter)
+{
+    check_same_results(JIT_OPT_PASS_GLOBAL_REGALLOC);
+}
+
+TEST_F(jit_regalloc_test, no_opt_passes_matches_interpreter)
+{
+    check_same_results(JIT_OPT_PASS_CONST_FOLD | JIT_OPT_PASS_COPY_PROP
+                       | JIT_OPT_PASS_CSE | JIT_OPT_PASS_DCE
+                       | JIT_OPT_PASS_GLOBAL_REGALLOC);
+}
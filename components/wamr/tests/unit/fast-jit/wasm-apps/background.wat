@@ -0,0 +1,29 @@
+(module
+  ;; fib(n) calls itself, sum(n) calls fib:
+  ;;   sum(n) = for (k = 0; k < n; k++) acc += fib(k % 16) * (k + 1)
+
+  (func $fib (export "fib") (param $n i32) (result i32)
+    local.get $n i32.const 2 i32.lt_u
+    if (result i32)
+      local.get $n
+    else
+      local.get $n i32.const 1 i32.sub call $fib
+      local.get $n i32.const 2 i32.sub call $fib
+      i32.add
+    end
+  )
+
+  (func (export "sum") (param $n i32) (result i32) (local $k i32) (local $acc i32)
+    block $done
+      loop $loop
+        local.get $k local.get $n i32.ge_u br_if $done
+        local.get $k i32.const 16 i32.rem_u call $fib
+        local.get $k i32.const 1 i32.add i32.mul
+        local.get $acc i32.add local.set $acc
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+)
@@ -0,0 +1,510 @@
+(module
+  ;; Functions of the same size which call a helper and dispatch through a
+  ;; br_table of 10 targets, so that their jitted code holds the absolute
+  ;; addresses of the jump table and of the return points of the calls.
+  ;; f<i>(x), with K = i + 1:
+  ;;   acc = K
+  ;;   for (k = 0; k < x; k++)
+  ;;     switch (k % 10 % 4): acc += h(k, K); acc ^= k << 3; acc *= 3; acc -= K
+  ;;   return acc
+
+  (func $h (param i32 i32) (result i32)
+    local.get 0 local.get 1 i32.mul i32.const 7 i32.add
+  )
+
+  (func (export "f0") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 1 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 1 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 1 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f1") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 2 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 2 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 2 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f2") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 3 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 3 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 3 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f3") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 4 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 4 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 4 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f4") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 5 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 5 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 5 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f5") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 6 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 6 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 6 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f6") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 7 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 7 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 7 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f7") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 8 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 8 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 8 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f8") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 9 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 9 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 9 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f9") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 10 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 10 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 10 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f10") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 11 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 11 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 11 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f11") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 12 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 12 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 12 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f12") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 13 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 13 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 13 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f13") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 14 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 14 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 14 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f14") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 15 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 15 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 15 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "f15") (param $x i32) (result i32) (local $k i32) (local $acc i32)
+    i32.const 16 local.set $acc
+    block $done
+      loop $loop
+        local.get $k local.get $x i32.ge_u br_if $done
+        block $next
+          block $c3
+            block $c2
+              block $c1
+                block $c0
+                  local.get $k i32.const 10 i32.rem_u
+                  br_table $c0 $c1 $c2 $c3 $c0 $c1 $c2 $c3 $c0 $c1 $c3
+                end
+                local.get $acc local.get $k i32.const 16 call $h i32.add local.set $acc
+                br $next
+              end
+              local.get $acc local.get $k i32.const 3 i32.shl i32.xor local.set $acc
+              br $next
+            end
+            local.get $acc i32.const 3 i32.mul local.set $acc
+            br $next
+          end
+          local.get $acc i32.const 16 i32.sub local.set $acc
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+)
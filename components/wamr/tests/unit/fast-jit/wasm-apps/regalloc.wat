@@ -0,0 +1,130 @@
+(module
+  ;; Functions for the register allocator, their results are compared with
+  ;; the interpreter.
+  ;;   pressure(n): more i32/i64 locals live through a loop than there are
+  ;;     hard registers, with a wasm call every 4 iterations and a native
+  ;;     call (f64.sqrt) every 4 iterations clobbering them
+  ;;   fpressure(n): the same with f64 locals and a native call (f64.floor)
+  ;;   blocks(x): a few locals live across if/else, br_table, a nested loop
+  ;;     and branches out of the middle of blocks
+
+  (func $mix (param i32 i32) (result i32)
+    local.get 0 i32.const 5 i32.rotl local.get 1 i32.xor
+  )
+
+  (func (export "pressure") (param $n i32) (result i64) (local $k i32) (local $r i64)
+    (local $a0 i32) (local $a1 i32) (local $a2 i32) (local $a3 i32) (local $a4 i32) (local $a5 i32) (local $a6 i32) (local $a7 i32) (local $a8 i32) (local $a9 i32) (local $a10 i32) (local $a11 i32) (local $b0 i64) (local $b1 i64) (local $b2 i64) (local $b3 i64)
+    i32.const 1 local.set $a0 i32.const 18 local.set $a1 i32.const 35 local.set $a2 i32.const 52 local.set $a3 i32.const 69 local.set $a4 i32.const 86 local.set $a5 i32.const 103 local.set $a6 i32.const 120 local.set $a7 i32.const 137 local.set $a8 i32.const 154 local.set $a9 i32.const 171 local.set $a10 i32.const 188 local.set $a11
+    i64.const 7 local.set $b0 i64.const 1000010 local.set $b1 i64.const 2000013 local.set $b2 i64.const 3000016 local.set $b3
+    block $done
+      loop $loop
+        local.get $k local.get $n i32.ge_u br_if $done
+        local.get $a0 local.get $a1 i32.add i32.const 1 i32.mul local.get $k i32.xor local.set $a0
+        local.get $a1 local.get $a2 i32.add i32.const 3 i32.mul local.get $k i32.xor local.set $a1
+        local.get $a2 local.get $a3 i32.add i32.const 5 i32.mul local.get $k i32.xor local.set $a2
+        local.get $a3 local.get $a4 i32.add i32.const 7 i32.mul local.get $k i32.xor local.set $a3
+        local.get $a4 local.get $a5 i32.add i32.const 9 i32.mul local.get $k i32.xor local.set $a4
+        local.get $a5 local.get $a6 i32.add i32.const 11 i32.mul local.get $k i32.xor local.set $a5
+        local.get $a6 local.get $a7 i32.add i32.const 13 i32.mul local.get $k i32.xor local.set $a6
+        local.get $a7 local.get $a8 i32.add i32.const 15 i32.mul local.get $k i32.xor local.set $a7
+        local.get $a8 local.get $a9 i32.add i32.const 17 i32.mul local.get $k i32.xor local.set $a8
+        local.get $a9 local.get $a10 i32.add i32.const 19 i32.mul local.get $k i32.xor local.set $a9
+        local.get $a10 local.get $a11 i32.add i32.const 21 i32.mul local.get $k i32.xor local.set $a10
+        local.get $a11 local.get $a0 i32.add i32.const 23 i32.mul local.get $k i32.xor local.set $a11
+        local.get $b0 i64.const 1 i64.rotl local.get $a0 i64.extend_i32_u i64.add local.set $b0
+        local.get $b1 i64.const 2 i64.rotl local.get $a3 i64.extend_i32_u i64.add local.set $b1
+        local.get $b2 i64.const 3 i64.rotl local.get $a6 i64.extend_i32_u i64.add local.set $b2
+        local.get $b3 i64.const 4 i64.rotl local.get $a9 i64.extend_i32_u i64.add local.set $b3
+        block $no_call
+          local.get $k i32.const 3 i32.and br_if $no_call
+          local.get $a0 local.get $a5 call $mix local.set $a0
+        end
+        block $no_native_call
+          local.get $k i32.const 3 i32.and i32.const 2 i32.ne br_if $no_native_call
+          local.get $a2 f64.convert_i32_u f64.sqrt i32.trunc_f64_u local.get $a7 i32.add local.set $a7
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $r i64.const 31 i64.mul local.get $a0 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a1 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a2 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a3 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a4 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a5 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a6 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a7 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a8 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a9 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a10 i64.extend_i32_u i64.add local.set $r local.get $r i64.const 31 i64.mul local.get $a11 i64.extend_i32_u i64.add local.set $r
+    local.get $r local.get $b0 i64.xor local.set $r local.get $r local.get $b1 i64.xor local.set $r local.get $r local.get $b2 i64.xor local.set $r local.get $r local.get $b3 i64.xor local.set $r
+    local.get $r
+  )
+
+  (func (export "fpressure") (param $n i32) (result f64) (local $k i32) (local $r f64)
+    (local $c0 f64) (local $c1 f64) (local $c2 f64) (local $c3 f64) (local $c4 f64) (local $c5 f64) (local $c6 f64) (local $c7 f64) (local $c8 f64) (local $c9 f64)
+    f64.const 1.25 local.set $c0 f64.const 2.25 local.set $c1 f64.const 3.25 local.set $c2 f64.const 4.25 local.set $c3 f64.const 5.25 local.set $c4 f64.const 6.25 local.set $c5 f64.const 7.25 local.set $c6 f64.const 8.25 local.set $c7 f64.const 9.25 local.set $c8 f64.const 10.25 local.set $c9
+    block $done
+      loop $loop
+        local.get $k local.get $n i32.ge_u br_if $done
+        local.get $c0 f64.const 0.5 f64.mul local.get $c1 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c0
+        local.get $c1 f64.const 0.5 f64.mul local.get $c2 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c1
+        local.get $c2 f64.const 0.5 f64.mul local.get $c3 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c2
+        local.get $c3 f64.const 0.5 f64.mul local.get $c4 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c3
+        local.get $c4 f64.const 0.5 f64.mul local.get $c5 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c4
+        local.get $c5 f64.const 0.5 f64.mul local.get $c6 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c5
+        local.get $c6 f64.const 0.5 f64.mul local.get $c7 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c6
+        local.get $c7 f64.const 0.5 f64.mul local.get $c8 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c7
+        local.get $c8 f64.const 0.5 f64.mul local.get $c9 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c8
+        local.get $c9 f64.const 0.5 f64.mul local.get $c0 f64.add local.get $k f64.convert_i32_u f64.sub local.set $c9
+        local.get $c4 f64.floor local.set $c4
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $r f64.const 3 f64.mul local.get $c0 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c1 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c2 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c3 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c4 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c5 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c6 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c7 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c8 f64.add local.set $r local.get $r f64.const 3 f64.mul local.get $c9 f64.add local.set $r
+    local.get $r
+  )
+
+  (func (export "blocks") (param $x i32) (result i32)
+    (local $s i32) (local $t i32) (local $u i32) (local $k i32) (local $j i32)
+    local.get $x local.set $s
+    local.get $x i32.const 3 i32.mul local.set $t
+    block $done
+      loop $loop
+        local.get $k i32.const 40 i32.ge_u br_if $done
+        local.get $k i32.const 1 i32.and
+        if
+          local.get $s local.get $t i32.add local.set $s
+        else
+          local.get $t local.get $s i32.const 1 i32.shl i32.xor local.set $t
+        end
+        block $next
+          block $c2
+            block $c1
+              block $c0
+                local.get $k i32.const 3 i32.rem_u
+                br_table $c0 $c1 $c2
+              end
+              local.get $u local.get $s i32.add local.set $u
+              br $next
+            end
+            local.get $u local.get $t i32.sub local.set $u
+            ;; leave the block in the middle, s is left unchanged
+            local.get $u i32.const 256 i32.and br_if $next
+            local.get $s i32.const 1 i32.add local.set $s
+            br $next
+          end
+          i32.const 0 local.set $j
+          block $inner_done
+            loop $inner
+              local.get $j local.get $k i32.const 5 i32.rem_u i32.ge_u br_if $inner_done
+              local.get $u i32.const 3 i32.mul local.get $j i32.add local.set $u
+              local.get $j i32.const 1 i32.add local.set $j
+              br $inner
+            end
+          end
+        end
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $s local.get $t i32.gt_u
+    if (result i32)
+      local.get $s local.get $u i32.xor
+    else
+      local.get $t local.get $u i32.add
+    end
+  )
+)
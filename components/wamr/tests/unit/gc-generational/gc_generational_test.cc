@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include "wasm_runtime_common.h"
+#include "ems/ems_gc.h"
+
+#define NODE_NUM 200
+#define CHURN_ITERS 2000
+#define GC_HEAP_SIZE (256 * 1024)
+
+/*
+ * gc_mutator.wasm keeps a linked list of NODE_NUM nodes holding
+ * 0 .. NODE_NUM - 1 in a global, and replaces its nodes with new copies
+ * while the heap is being collected. A young node the collector misses
+ * is freed and reused by the garbage the app allocates, which breaks
+ * the list.
+ */
+class WasmGCGenerationalTest : public testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+
+        init_args.mem_alloc_type = Alloc_With_Pool;
+        init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
+        init_args.mem_alloc_option.pool.heap_size = sizeof(global_heap_buf);
+        init_args.gc_heap_size = GC_HEAP_SIZE;
+
+        ASSERT_EQ(wasm_runtime_full_init(&init_args), true);
+
+        env = new DummyExecEnv("gc_mutator.wasm");
+        heap = wasm_runtime_get_gc_heap_handle(
+            wasm_runtime_get_module_inst(env->get()));
+        ASSERT_TRUE(heap != NULL);
+    }
+
+    void TearDown()
+    {
+        delete env;
+        wasm_runtime_destroy();
+    }
+
+    void call(const char *name, uint32 arg0 = 0, uint32 arg1 = 0)
+    {
+        uint32 argv[2] = { arg0, arg1 };
+
+        ASSERT_TRUE(env->execute(name, 2, argv)) << env->get_exception();
+    }
+
+    void check_list()
+    {
+        uint32 argv[1];
+
+        ASSERT_TRUE(env->execute("count", 0, argv)) << env->get_exception();
+        EXPECT_EQ(argv[0], (uint32)NODE_NUM);
+        ASSERT_TRUE(env->execute("sum", 0, argv)) << env->get_exception();
+        EXPECT_EQ(argv[0], (uint32)NODE_NUM * (NODE_NUM - 1) / 2);
+    }
+
+    uint32 gc_count()
+    {
+        uint32 stats[GC_STAT_MAX];
+
+        gc_heap_stats(heap, stats, GC_STAT_MAX);
+        return stats[GC_STAT_COUNT];
+    }
+
+    RuntimeInitArgs init_args;
+    char global_heap_buf[1024 * 1024];
+    DummyExecEnv *env = NULL;
+    void *heap = NULL;
+};
+
+TEST_F(WasmGCGenerationalTest, Test_remembered_set_keeps_young_nodes)
+{
+    uint32 count, k;
+
+    call("build", NODE_NUM);
+
+    /* Promote the whole list */
+    ASSERT_EQ(gci_gc_nursery(heap), GC_SUCCESS);
+    count = gc_count();
+
+    /* Replace old nodes with young copies, which are only referred to by
+       their old predecessors */
+    for (k = 1; k < NODE_NUM; k += 10) {
+        call("replace", k);
+    }
+
+    /* Only the remembered set keeps the young copies */
+    ASSERT_EQ(gci_gc_nursery(heap), GC_SUCCESS);
+    EXPECT_GT(gc_count(), count);
+
+    /* Reuse the memory freed by the minor collection, then check the
+       list */
+    call("churn", 16, NODE_NUM);
+    check_list();
+}
+
+TEST_F(WasmGCGenerationalTest, Test_minor_collections_while_mutating)
+{
+    uint32 count;
+
+    call("build", NODE_NUM);
+    count = gc_count();
+
+    /* The allocations of the app fill the nursery in the middle of its
+       moves and replacements */
+    call("churn", CHURN_ITERS, NODE_NUM);
+    EXPECT_GT(gc_count(), count);
+    check_list();
+}
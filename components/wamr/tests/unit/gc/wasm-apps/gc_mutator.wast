@@ -0,0 +1,115 @@
+(module
+  (type $node (struct (field $next (mut (ref null $node)))
+                      (field $val (mut i32))))
+
+  (global $head (mut (ref null $node)) (ref.null $node))
+
+  ;; head = a list of n nodes holding 0 .. n - 1
+  (func (export "build") (param $n i32)
+    (global.set $head (ref.null $node))
+    (block $done
+      (loop $next
+        (br_if $done (i32.eqz (local.get $n)))
+        (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+        (global.set $head
+          (struct.new $node (global.get $head) (local.get $n)))
+        (br $next)))
+  )
+
+  ;; the node at position k
+  (func $walk (param $k i32) (result (ref null $node))
+    (local $cur (ref null $node))
+    (local.set $cur (global.get $head))
+    (block $done
+      (loop $next
+        (br_if $done (i32.eqz (local.get $k)))
+        (local.set $cur (struct.get $node $next (local.get $cur)))
+        (local.set $k (i32.sub (local.get $k) (i32.const 1)))
+        (br $next)))
+    (local.get $cur)
+  )
+
+  ;; unlink the node at position k (k > 0) and push it to the front, the
+  ;; deletion from its predecessor must not hide it from the marking
+  (func $move_to_front (export "move_to_front") (param $k i32)
+    (local $prev (ref null $node))
+    (local $cur (ref null $node))
+    (local.set $cur
+      (struct.get $node $next
+        (local.tee $prev (call $walk (i32.sub (local.get $k) (i32.const 1))))))
+    (struct.set $node $next (local.get $prev)
+      (struct.get $node $next (local.get $cur)))
+    (struct.set $node $next (local.get $cur) (global.get $head))
+    (global.set $head (local.get $cur))
+  )
+
+  ;; replace the node at position k (k > 0) with a new copy, which is
+  ;; only referred to by its (maybe old) predecessor
+  (func $replace (export "replace") (param $k i32)
+    (local $prev (ref null $node))
+    (local $cur (ref null $node))
+    (local.set $cur
+      (struct.get $node $next
+        (local.tee $prev (call $walk (i32.sub (local.get $k) (i32.const 1))))))
+    (struct.set $node $next (local.get $prev)
+      (struct.new $node (struct.get $node $next (local.get $cur))
+                        (struct.get $node $val (local.get $cur))))
+  )
+
+  ;; allocate n unreachable nodes holding -1
+  (func $garbage (param $n i32)
+    (block $done
+      (loop $next
+        (br_if $done (i32.eqz (local.get $n)))
+        (drop (struct.new $node (ref.null $node) (i32.const -1)))
+        (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+        (br $next)))
+  )
+
+  ;; mutate the list of n nodes while allocating enough garbage to run
+  ;; the collector
+  (func (export "churn") (param $iters i32) (param $n i32)
+    (local $i i32)
+    (block $done
+      (loop $next
+        (br_if $done (i32.ge_u (local.get $i) (local.get $iters)))
+        (call $move_to_front
+          (i32.add (i32.const 1)
+            (i32.rem_u (i32.mul (local.get $i) (i32.const 7))
+                       (i32.sub (local.get $n) (i32.const 1)))))
+        (call $replace
+          (i32.add (i32.const 1)
+            (i32.rem_u (i32.mul (local.get $i) (i32.const 13))
+                       (i32.sub (local.get $n) (i32.const 1)))))
+        (call $garbage (i32.const 8))
+        (local.set $i (i32.add (local.get $i) (i32.const 1)))
+        (br $next)))
+  )
+
+  (func (export "count") (result i32)
+    (local $cur (ref null $node))
+    (local $count i32)
+    (local.set $cur (global.get $head))
+    (block $done
+      (loop $next
+        (br_if $done (ref.is_null (local.get $cur)))
+        (local.set $count (i32.add (local.get $count) (i32.const 1)))
+        (local.set $cur (struct.get $node $next (local.get $cur)))
+        (br $next)))
+    (local.get $count)
+  )
+
+  (func (export "sum") (result i32)
+    (local $cur (ref null $node))
+    (local $sum i32)
+    (local.set $cur (global.get $head))
+    (block $done
+      (loop $next
+        (br_if $done (ref.is_null (local.get $cur)))
+        (local.set $sum
+          (i32.add (local.get $sum) (struct.get $node $val (local.get $cur))))
+        (local.set $cur (struct.get $node $next (local.get $cur)))
+        (br $next)))
+    (local.get $sum)
+  )
+)
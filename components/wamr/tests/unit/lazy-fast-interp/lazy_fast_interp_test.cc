@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "wasm_runtime_common.h"
+#include "wasm.h"
+
+#define THREAD_NUM 4
+
+/* Indexes of the functions of lazy.wasm */
+#define FUNC_ADD 0
+#define FUNC_MUL 1
+#define FUNC_SUM 2
+
+class lazy_fast_interp_test : public testing::Test
+{
+  protected:
+    virtual void TearDown()
+    {
+        if (module)
+            wasm_runtime_unload(module);
+    }
+
+    /* The buffer is kept in wasm_buf, the functions are prepared from it */
+    wasm_module_t load(const char *filename, bool defer_validation,
+                       bool binary_freeable = false)
+    {
+        std::ifstream wasm_file(filename, std::ios::binary);
+        LoadArgs args;
+
+        wasm_buf.assign(std::istreambuf_iterator<char>(wasm_file), {});
+        EXPECT_FALSE(wasm_buf.empty()) << filename;
+
+        memset(&args, 0, sizeof(LoadArgs));
+        args.name = (char *)filename;
+        args.wasm_binary_freeable = binary_freeable;
+        args.defer_validation = defer_validation;
+        module = wasm_runtime_load_ex(wasm_buf.data(), wasm_buf.size(), &args,
+                                      error_buf, sizeof(error_buf));
+        return module;
+    }
+
+    bool is_prepared(uint32 func_idx)
+    {
+        return ((WASMModule *)module)->functions[func_idx]->code_compiled
+               != NULL;
+    }
+
+    /* Calls the function in a new instance of the module */
+    static bool call(wasm_module_t module, const char *name, uint32 argc,
+                     uint32 argv[], std::string *exception = NULL)
+    {
+        wasm_module_inst_t inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        char error_buf[128];
+        bool ret = false;
+
+        inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                        sizeof(error_buf));
+        EXPECT_TRUE(inst != NULL) << error_buf;
+        if (!inst)
+            return false;
+
+        exec_env = wasm_runtime_create_exec_env(inst, 8192);
+        func = wasm_runtime_lookup_function(inst, name);
+        if (exec_env && func) {
+            ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+            if (!ret && exception)
+                *exception = wasm_runtime_get_exception(inst);
+        }
+
+        if (exec_env)
+            wasm_runtime_destroy_exec_env(exec_env);
+        wasm_runtime_deinstantiate(inst);
+        return ret;
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    std::vector<uint8_t> wasm_buf;
+    wasm_module_t module = NULL;
+    char error_buf[128];
+};
+
+TEST_F(lazy_fast_interp_test, functions_prepared_on_first_call)
+{
+    uint32 argv[2] = { 5 };
+
+    ASSERT_TRUE(load("lazy.wasm", false) != NULL) << error_buf;
+    EXPECT_FALSE(is_prepared(FUNC_ADD));
+    EXPECT_FALSE(is_prepared(FUNC_MUL));
+    EXPECT_FALSE(is_prepared(FUNC_SUM));
+
+    /* sum prepares add, which it calls, and leaves mul alone */
+    ASSERT_TRUE(call(module, "sum", 1, argv));
+    EXPECT_EQ(argv[0], 25u);
+    EXPECT_TRUE(is_prepared(FUNC_ADD));
+    EXPECT_FALSE(is_prepared(FUNC_MUL));
+    EXPECT_TRUE(is_prepared(FUNC_SUM));
+
+    argv[0] = 6;
+    argv[1] = 7;
+    ASSERT_TRUE(call(module, "mul", 2, argv));
+    EXPECT_EQ(argv[0], 42u);
+    EXPECT_TRUE(is_prepared(FUNC_MUL));
+}
+
+TEST_F(lazy_fast_interp_test, freeable_binary_prepared_when_loading)
+{
+    ASSERT_TRUE(load("lazy.wasm", false, true) != NULL) << error_buf;
+    EXPECT_TRUE(is_prepared(FUNC_ADD));
+    EXPECT_TRUE(is_prepared(FUNC_MUL));
+    EXPECT_TRUE(is_prepared(FUNC_SUM));
+}
+
+TEST_F(lazy_fast_interp_test, validation_deferred_to_first_call)
+{
+    uint32 argv[1] = { 1 };
+    std::string exception;
+
+    /* The bodies are still validated when loading by default */
+    EXPECT_TRUE(load("invalid_body.wasm", false) == NULL);
+
+    ASSERT_TRUE(load("invalid_body.wasm", true) != NULL) << error_buf;
+    ASSERT_TRUE(call(module, "good", 1, argv));
+    EXPECT_EQ(argv[0], 2u);
+
+    EXPECT_FALSE(call(module, "bad", 1, argv, &exception));
+    EXPECT_FALSE(exception.empty());
+    /* bad is function 1 */
+    EXPECT_FALSE(is_prepared(1));
+
+    /* The other functions keep working */
+    argv[0] = 2;
+    ASSERT_TRUE(call(module, "good", 1, argv));
+    EXPECT_EQ(argv[0], 3u);
+}
+
+TEST_F(lazy_fast_interp_test, concurrent_first_calls)
+{
+    std::vector<std::thread> threads;
+    std::atomic<uint32> ready(0), done(0);
+    uint32 i;
+
+    ASSERT_TRUE(load("lazy.wasm", false) != NULL) << error_buf;
+
+    for (i = 0; i < THREAD_NUM; i++) {
+        threads.emplace_back([&]() {
+            uint32 argv[1] = { 100 };
+
+            ASSERT_TRUE(wasm_runtime_init_thread_env());
+            /* Call sum from every thread at once */
+            ready++;
+            while (ready < THREAD_NUM)
+                std::this_thread::yield();
+
+            /* sum(n) adds the odd numbers below 2n */
+            if (call(module, "sum", 1, argv) && argv[0] == 10000)
+                done++;
+            wasm_runtime_destroy_thread_env();
+        });
+    }
+    for (std::thread &t : threads)
+        t.join();
+
+    EXPECT_EQ(done, (uint32)THREAD_NUM);
+    EXPECT_TRUE(is_prepared(FUNC_ADD));
+    EXPECT_TRUE(is_prepared(FUNC_SUM));
+}
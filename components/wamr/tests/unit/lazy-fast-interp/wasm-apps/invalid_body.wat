@@ -0,0 +1,12 @@
+(module
+  ;; bad pops two operands with a single one on the stack, so the module
+  ;; only loads when the validation is deferred
+
+  (func (export "good") (param $a i32) (result i32)
+    local.get $a i32.const 1 i32.add
+  )
+
+  (func (export "bad") (param $a i32) (result i32)
+    local.get $a i32.add
+  )
+)
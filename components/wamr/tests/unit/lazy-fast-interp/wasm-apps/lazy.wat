@@ -0,0 +1,25 @@
+(module
+  ;; sum(n) = add(0, 1) + add(1, 2) + ... + add(n - 1, n), mul is never
+  ;; called by sum
+
+  (func $add (export "add") (param $a i32) (param $b i32) (result i32)
+    local.get $a local.get $b i32.add
+  )
+
+  (func (export "mul") (param $a i32) (param $b i32) (result i32)
+    local.get $a local.get $b i32.mul
+  )
+
+  (func (export "sum") (param $n i32) (result i32) (local $k i32) (local $acc i32)
+    block $done
+      loop $loop
+        local.get $k local.get $n i32.ge_u br_if $done
+        local.get $k local.get $k i32.const 1 i32.add call $add
+        local.get $acc i32.add local.set $acc
+        local.get $k i32.const 1 i32.add local.set $k
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+)
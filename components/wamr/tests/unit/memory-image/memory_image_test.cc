@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include "wasm_runtime.h"
+
+#define PAGE0_DATA_OFFSET 1024
+#define PAGE1_DATA_OFFSET 70000
+/* Value of __heap_base of wasm-apps/image.wat */
+#define HEAP_BASE 4096
+/* Value of spectest.global_i32 */
+#define GLOBAL_DATA_OFFSET 666
+
+class memory_image_test : public testing::Test
+{
+  protected:
+    /* The buffer is kept, the module may refer to it */
+    void load_module(const char *file_name)
+    {
+        std::ifstream wasm_file(file_name, std::ios::binary);
+
+        wasm_buf.assign(std::istreambuf_iterator<char>(wasm_file), {});
+        ASSERT_FALSE(wasm_buf.empty()) << file_name;
+        module.reset(new WAMRModule(wasm_buf.data(), wasm_buf.size()));
+        ASSERT_TRUE(module->get() != NULL) << file_name;
+    }
+
+    /* The instances are destroyed with the test */
+    wasm_module_inst_t instantiate(uint32 heap_size = 0)
+    {
+        insts.emplace_back(new WAMRInstance(*module, 8192, heap_size));
+        EXPECT_TRUE(insts.back()->get() != NULL);
+        return insts.back()->get();
+    }
+
+    static bool is_image_mapped(wasm_module_inst_t module_inst)
+    {
+        return ((WASMModuleInstance *)module_inst)
+            ->e->common.memory_image_mapped;
+    }
+
+    static std::string read_string(wasm_module_inst_t module_inst,
+                                   uint32 offset, uint32 size)
+    {
+        const char *data = (const char *)wasm_runtime_addr_app_to_native(
+            module_inst, offset);
+
+        return data ? std::string(data, size) : std::string();
+    }
+
+    static bool call(wasm_module_inst_t module_inst, const char *name,
+                     uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func;
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_TRUE(func != NULL) << name;
+        if (!func
+            || !(exec_env = wasm_runtime_create_exec_env(module_inst, 8192)))
+            return false;
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    static uint32 load8(wasm_module_inst_t module_inst, uint32 offset)
+    {
+        uint32 argv[1] = { offset };
+
+        EXPECT_TRUE(call(module_inst, "load8", 1, argv))
+            << wasm_runtime_get_exception(module_inst);
+        return argv[0];
+    }
+
+    WASMModule *wasm_module() const { return (WASMModule *)module->get(); }
+
+    WAMRRuntimeRAII<> runtime;
+    std::vector<uint8_t> wasm_buf;
+    std::unique_ptr<WAMRModule> module;
+    std::vector<std::unique_ptr<WAMRInstance>> insts;
+};
+
+TEST_F(memory_image_test, instances_share_image_copy_on_write)
+{
+    const std::string page0 = "Copy-ON-write memory image, page 0";
+    const std::string page1 = "Copy-on-write memory image, page 1";
+    wasm_module_inst_t inst_a, inst_b, inst_c;
+    uint32 argv[2];
+
+    load_module("image.wasm");
+    EXPECT_GT(wasm_module()->memory_image.size, 0u);
+    EXPECT_EQ(wasm_module()->memory_image.data_end,
+              (uint64)PAGE1_DATA_OFFSET + page1.size());
+
+    ASSERT_TRUE((inst_a = instantiate()) != NULL);
+    ASSERT_TRUE((inst_b = instantiate()) != NULL);
+    EXPECT_TRUE(is_image_mapped(inst_a));
+    EXPECT_TRUE(is_image_mapped(inst_b));
+
+    /* The later segment overwrites a part of the earlier one */
+    EXPECT_EQ(read_string(inst_a, PAGE0_DATA_OFFSET, page0.size()), page0);
+    EXPECT_EQ(read_string(inst_a, PAGE1_DATA_OFFSET, page1.size()), page1);
+    EXPECT_EQ(load8(inst_a, PAGE0_DATA_OFFSET - 1), 0u);
+    EXPECT_EQ(load8(inst_a, PAGE1_DATA_OFFSET + page1.size()), 0u);
+
+    /* Written by A, in the data pages and in a zeroed one */
+    argv[0] = PAGE0_DATA_OFFSET;
+    argv[1] = 'c';
+    ASSERT_TRUE(call(inst_a, "store8", 2, argv));
+    argv[0] = 100;
+    argv[1] = 0xAB;
+    ASSERT_TRUE(call(inst_a, "store8", 2, argv));
+    memcpy(wasm_runtime_addr_app_to_native(inst_a, PAGE1_DATA_OFFSET), "X", 1);
+
+    EXPECT_EQ(load8(inst_a, PAGE0_DATA_OFFSET), (uint32)'c');
+    EXPECT_EQ(load8(inst_a, 100), 0xABu);
+    EXPECT_EQ(load8(inst_a, PAGE1_DATA_OFFSET), (uint32)'X');
+
+    /* B and an instance created afterwards still see the image */
+    ASSERT_TRUE((inst_c = instantiate()) != NULL);
+    EXPECT_TRUE(is_image_mapped(inst_c));
+    for (wasm_module_inst_t inst : { inst_b, inst_c }) {
+        EXPECT_EQ(read_string(inst, PAGE0_DATA_OFFSET, page0.size()), page0);
+        EXPECT_EQ(read_string(inst, PAGE1_DATA_OFFSET, page1.size()), page1);
+        EXPECT_EQ(load8(inst, 100), 0u);
+    }
+
+    /* And B's writes don't reach A */
+    argv[0] = PAGE1_DATA_OFFSET + 1;
+    argv[1] = 'Y';
+    ASSERT_TRUE(call(inst_b, "store8", 2, argv));
+    EXPECT_EQ(load8(inst_a, PAGE1_DATA_OFFSET + 1), (uint32)'o');
+
+    /* The memory keeps its content when it grows */
+    argv[0] = 1;
+    ASSERT_TRUE(call(inst_a, "grow", 1, argv));
+    EXPECT_EQ(argv[0], 2u);
+    EXPECT_EQ(load8(inst_a, PAGE0_DATA_OFFSET), (uint32)'c');
+    EXPECT_EQ(load8(inst_a, 100), 0xABu);
+    EXPECT_EQ(read_string(inst_a, PAGE1_DATA_OFFSET, page1.size()),
+              "X" + page1.substr(1));
+    EXPECT_EQ(load8(inst_a, 2 * 65536 + 100), 0u);
+    EXPECT_EQ(read_string(inst_b, PAGE0_DATA_OFFSET, page0.size()), page0);
+}
+
+TEST_F(memory_image_test, heap_before_data_end_skips_image)
+{
+    const std::string page0 = "Copy-ON-write memory image, page 0";
+    const std::string page1 = "Copy-on-write memory image, page 1";
+    wasm_module_inst_t module_inst;
+    uint64 app_offset;
+    void *native_addr = NULL;
+
+    load_module("image.wasm");
+    EXPECT_GT(wasm_module()->memory_image.size, 0u);
+
+    /* The app heap is inserted at __heap_base, before the end of the data,
+       so the segments are copied instead of mapping the image over it */
+    ASSERT_TRUE((module_inst = instantiate(8192)) != NULL);
+    EXPECT_FALSE(is_image_mapped(module_inst));
+    EXPECT_EQ(read_string(module_inst, PAGE0_DATA_OFFSET, page0.size()),
+              page0);
+
+    app_offset = wasm_runtime_module_malloc(module_inst, 256, &native_addr);
+    ASSERT_NE(app_offset, 0u);
+    EXPECT_GE(app_offset, (uint64)HEAP_BASE);
+    EXPECT_LT(app_offset, (uint64)HEAP_BASE + 8192);
+    memset(native_addr, 0xCD, 256);
+    wasm_runtime_module_free(module_inst, app_offset);
+
+    /* Nor the segment after the heap */
+    EXPECT_EQ(read_string(module_inst, PAGE1_DATA_OFFSET, page1.size()),
+              page1);
+
+    /* The instances without app heap still map it */
+    ASSERT_TRUE((module_inst = instantiate()) != NULL);
+    EXPECT_TRUE(is_image_mapped(module_inst));
+}
+
+TEST_F(memory_image_test, non_constant_offset_skips_image)
+{
+    const std::string page0 = "Copy-on-write memory image, page 0";
+    const std::string global_data = "Copied, the offset is an imported global";
+    wasm_module_inst_t module_insts[2];
+    uint32 i;
+
+    /* The offset of a segment is only known at instantiation */
+    load_module("image_global.wasm");
+    EXPECT_EQ(wasm_module()->memory_image.size, 0u);
+
+    /* The instances copy all the segments */
+    for (i = 0; i < 2; i++) {
+        wasm_module_inst_t inst;
+
+        ASSERT_TRUE((inst = module_insts[i] = instantiate()) != NULL);
+        EXPECT_FALSE(is_image_mapped(inst));
+        EXPECT_EQ(read_string(inst, PAGE0_DATA_OFFSET, page0.size()), page0);
+        EXPECT_EQ(read_string(inst, GLOBAL_DATA_OFFSET, global_data.size()),
+                  global_data);
+    }
+
+    memcpy(wasm_runtime_addr_app_to_native(module_insts[0],
+                                           GLOBAL_DATA_OFFSET),
+           "c", 1);
+    EXPECT_EQ(load8(module_insts[0], GLOBAL_DATA_OFFSET), (uint32)'c');
+    EXPECT_EQ(load8(module_insts[1], GLOBAL_DATA_OFFSET), (uint32)'C');
+}
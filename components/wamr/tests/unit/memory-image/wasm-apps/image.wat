@@ -0,0 +1,30 @@
+;; Data segments in the first two pages of the memory, the third one
+;; overwrites a part of the first one. An app heap is inserted at
+;; __heap_base, between the segments.
+
+(module
+  (memory (export "memory") 2)
+  (global $data_end i32 (i32.const 2048))
+  (global $heap_base i32 (i32.const 4096))
+  (export "__data_end" (global $data_end))
+  (export "__heap_base" (global $heap_base))
+  (data (i32.const 1024) "Copy-on-write memory image, page 0")
+  (data (i32.const 70000) "Copy-on-write memory image, page 1")
+  (data (i32.const 1029) "ON")
+
+  (func $load8 (export "load8") (param $addr i32) (result i32)
+    local.get $addr
+    i32.load8_u
+  )
+
+  (func $store8 (export "store8") (param $addr i32) (param $value i32)
+    local.get $addr
+    local.get $value
+    i32.store8
+  )
+
+  (func $grow (export "grow") (param $pages i32) (result i32)
+    local.get $pages
+    memory.grow
+  )
+)
@@ -0,0 +1,14 @@
+;; The offset of the second data segment is the value of an imported
+;; global, spectest.global_i32 of libc-builtin, which is 666
+
+(module
+  (import "spectest" "global_i32" (global $base i32))
+  (memory (export "memory") 2)
+  (data (i32.const 1024) "Copy-on-write memory image, page 0")
+  (data (global.get $base) "Copied, the offset is an imported global")
+
+  (func $load8 (export "load8") (param $addr i32) (result i32)
+    local.get $addr
+    i32.load8_u
+  )
+)
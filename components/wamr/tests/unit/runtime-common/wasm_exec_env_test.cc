@@ -6,6 +6,11 @@
 #include "test_helper.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
 #include "wasm_exec_env.h"
 
 class wasm_exec_env_test_suite : public testing::Test
@@ -43,3 +48,224 @@ TEST_F(wasm_exec_env_test_suite, wasm_exec_env_pop_jmpbuf)
     exec_env.jmpbuf_stack_top = nullptr;
     EXPECT_EQ(nullptr, wasm_exec_env_pop_jmpbuf(&exec_env));
 }
+
+class wasm_exec_env_pool_test_suite : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        buffer.assign(dummy_wasm_buffer,
+                      dummy_wasm_buffer + sizeof(dummy_wasm_buffer));
+        module = std::make_shared<WAMRModule>(buffer.data(), buffer.size());
+        ASSERT_NE(nullptr, module->get());
+        instance = std::make_shared<WAMRInstance>(*module);
+        ASSERT_NE(nullptr, instance->get());
+    }
+
+    virtual void TearDown()
+    {
+        instance.reset();
+        module.reset();
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    std::vector<uint8_t> buffer;
+    std::shared_ptr<WAMRModule> module;
+    std::shared_ptr<WAMRInstance> instance;
+};
+
+TEST_F(wasm_exec_env_pool_test_suite, checkout_without_pool)
+{
+    wasm_exec_env_t exec_env1, exec_env2;
+
+    /* Created and destroyed each time */
+    exec_env1 = wasm_runtime_checkout_exec_env(instance->get());
+    ASSERT_NE(nullptr, exec_env1);
+    exec_env2 = wasm_runtime_checkout_exec_env(instance->get());
+    ASSERT_NE(nullptr, exec_env2);
+    EXPECT_NE(exec_env1, exec_env2);
+    EXPECT_EQ(instance->get(), wasm_runtime_get_module_inst(exec_env1));
+
+    wasm_runtime_return_exec_env(exec_env1);
+    wasm_runtime_return_exec_env(exec_env2);
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(instance->get()));
+}
+
+TEST_F(wasm_exec_env_pool_test_suite, create_pool)
+{
+    EXPECT_FALSE(wasm_runtime_create_exec_env_pool(instance->get(), 0, 0,
+                                                   false));
+    EXPECT_TRUE(wasm_runtime_create_exec_env_pool(instance->get(), 2, 0,
+                                                  false));
+    EXPECT_FALSE(wasm_runtime_create_exec_env_pool(instance->get(), 2, 0,
+                                                   false));
+}
+
+TEST_F(wasm_exec_env_pool_test_suite, checkout_and_return)
+{
+    wasm_exec_env_t exec_env1, exec_env2, exec_env3;
+
+    ASSERT_TRUE(wasm_runtime_create_exec_env_pool(instance->get(), 2, 0,
+                                                  false));
+
+    /* A returned exec_env is checked out again */
+    exec_env1 = wasm_runtime_checkout_exec_env(instance->get());
+    ASSERT_NE(nullptr, exec_env1);
+    wasm_runtime_set_user_data(exec_env1, (void *)&exec_env1);
+    wasm_runtime_return_exec_env(exec_env1);
+    EXPECT_EQ(exec_env1, wasm_runtime_checkout_exec_env(instance->get()));
+    /* its user data is kept */
+    EXPECT_EQ((void *)&exec_env1, wasm_runtime_get_user_data(exec_env1));
+
+    /* Another one is created while it is checked out */
+    exec_env2 = wasm_runtime_checkout_exec_env(instance->get());
+    ASSERT_NE(nullptr, exec_env2);
+    EXPECT_NE(exec_env1, exec_env2);
+    exec_env3 = wasm_runtime_checkout_exec_env(instance->get());
+    ASSERT_NE(nullptr, exec_env3);
+    EXPECT_NE(exec_env1, exec_env3);
+    EXPECT_NE(exec_env2, exec_env3);
+    EXPECT_EQ(instance->get(), wasm_runtime_get_module_inst(exec_env3));
+
+    /* The pool keeps 2 of them, the third one is destroyed */
+    wasm_runtime_return_exec_env(exec_env1);
+    wasm_runtime_return_exec_env(exec_env2);
+    wasm_runtime_return_exec_env(exec_env3);
+
+    exec_env3 = wasm_runtime_checkout_exec_env(instance->get());
+    EXPECT_TRUE(exec_env3 == exec_env1 || exec_env3 == exec_env2);
+    wasm_runtime_return_exec_env(exec_env3);
+}
+
+TEST_F(wasm_exec_env_pool_test_suite, trim)
+{
+    wasm_exec_env_t exec_envs[4];
+    uint32_t i;
+
+    ASSERT_TRUE(wasm_runtime_create_exec_env_pool(instance->get(), 4, 0,
+                                                  false));
+
+    for (i = 0; i < 4; i++) {
+        exec_envs[i] = wasm_runtime_checkout_exec_env(instance->get());
+        ASSERT_NE(nullptr, exec_envs[i]);
+    }
+    for (i = 0; i < 4; i++)
+        wasm_runtime_return_exec_env(exec_envs[i]);
+
+    /* All the idle exec_envs were in use at the peak, and none of them
+       since then */
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(instance->get()));
+    EXPECT_EQ(4u, wasm_runtime_trim_exec_env_pool(instance->get()));
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(instance->get()));
+
+    /* One checked out at once */
+    for (i = 0; i < 3; i++) {
+        exec_envs[0] = wasm_runtime_checkout_exec_env(instance->get());
+        ASSERT_NE(nullptr, exec_envs[0]);
+        wasm_runtime_return_exec_env(exec_envs[0]);
+    }
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(instance->get()));
+
+    /* Two in use at the peak, one of them still checked out */
+    exec_envs[1] = wasm_runtime_checkout_exec_env(instance->get());
+    exec_envs[2] = wasm_runtime_checkout_exec_env(instance->get());
+    wasm_runtime_return_exec_env(exec_envs[2]);
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(instance->get()));
+    EXPECT_EQ(1u, wasm_runtime_trim_exec_env_pool(instance->get()));
+    wasm_runtime_return_exec_env(exec_envs[1]);
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(instance->get()));
+    EXPECT_EQ(1u, wasm_runtime_trim_exec_env_pool(instance->get()));
+}
+
+TEST_F(wasm_exec_env_pool_test_suite, bind_thread)
+{
+    wasm_exec_env_t other_exec_env, exec_env;
+    bool bind_thread;
+
+    for (bind_thread = false;; bind_thread = true) {
+        wasm_module_inst_t module_inst = instance->get();
+
+        ASSERT_TRUE(wasm_runtime_create_exec_env_pool(module_inst, 4, 0,
+                                                      bind_thread));
+        other_exec_env = wasm_runtime_checkout_exec_env(module_inst);
+        exec_env = wasm_runtime_checkout_exec_env(module_inst);
+        ASSERT_NE(nullptr, other_exec_env);
+        ASSERT_NE(nullptr, exec_env);
+
+        /* Another thread returns an exec_env into the first slot, and this
+           thread returns the other one into the second slot */
+        std::thread([&]() {
+            wasm_runtime_return_exec_env(other_exec_env);
+        }).join();
+        wasm_runtime_return_exec_env(exec_env);
+
+        /* Bound to the exec_env it returned last rather than the first
+           idle one */
+        EXPECT_EQ(bind_thread ? exec_env : other_exec_env,
+                  wasm_runtime_checkout_exec_env(module_inst));
+        wasm_runtime_return_exec_env(bind_thread ? exec_env
+                                                 : other_exec_env);
+
+        if (bind_thread)
+            break;
+
+        /* A new instance for the pool bound to threads */
+        instance = std::make_shared<WAMRInstance>(*module);
+        ASSERT_NE(nullptr, instance->get());
+    }
+}
+
+TEST_F(wasm_exec_env_pool_test_suite, multithreaded_checkout)
+{
+    wasm_module_inst_t module_inst = instance->get();
+    std::vector<std::thread> threads;
+    std::set<wasm_exec_env_t> in_use;
+    std::mutex in_use_lock;
+    std::atomic<uint32_t> errors(0);
+    uint32_t i, freed;
+
+    ASSERT_TRUE(wasm_runtime_create_exec_env_pool(module_inst, 4, 0, true));
+
+    for (i = 0; i < 8; i++) {
+        threads.emplace_back([&]() {
+            wasm_exec_env_t exec_env;
+            uint32_t j;
+
+            for (j = 0; j < 1000; j++) {
+                if (!(exec_env = wasm_runtime_checkout_exec_env(module_inst))) {
+                    errors++;
+                    continue;
+                }
+                if (wasm_runtime_get_module_inst(exec_env) != module_inst)
+                    errors++;
+
+                /* Never checked out by two threads at once */
+                {
+                    std::lock_guard<std::mutex> guard(in_use_lock);
+                    if (!in_use.insert(exec_env).second)
+                        errors++;
+                }
+                std::this_thread::yield();
+                {
+                    std::lock_guard<std::mutex> guard(in_use_lock);
+                    in_use.erase(exec_env);
+                }
+
+                wasm_runtime_return_exec_env(exec_env);
+            }
+        });
+    }
+
+    for (i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    EXPECT_EQ(0u, errors.load());
+
+    /* The pool keeps at most 4 idle exec_envs, they are freed by the
+       second trim */
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(module_inst));
+    freed = wasm_runtime_trim_exec_env_pool(module_inst);
+    EXPECT_GE(freed, 1u);
+    EXPECT_LE(freed, 4u);
+    EXPECT_EQ(0u, wasm_runtime_trim_exec_env_pool(module_inst));
+}
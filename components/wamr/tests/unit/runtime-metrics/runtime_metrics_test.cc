@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "wasm_runtime_common.h"
+
+#define THREAD_NUM 4
+#define LOAD_NUM 200
+
+class runtime_metrics_test : public testing::Test
+{
+  protected:
+    virtual void SetUp() { wasm_runtime_reset_metrics(); }
+
+    /* Load and unload the dummy module in the current thread */
+    static void load_modules(uint32 count)
+    {
+        std::vector<uint8_t> wasm_buf;
+        wasm_module_t module;
+        char error_buf[128];
+        uint32 i;
+
+        for (i = 0; i < count; i++) {
+            /* The loader may modify the buffer */
+            wasm_buf.assign(dummy_wasm_buffer,
+                            dummy_wasm_buffer + sizeof(dummy_wasm_buffer));
+            module = wasm_runtime_load(wasm_buf.data(), wasm_buf.size(),
+                                       error_buf, sizeof(error_buf));
+            ASSERT_TRUE(module != NULL) << error_buf;
+            wasm_runtime_unload(module);
+        }
+    }
+
+    /* Run load_modules in a thread with its own thread env */
+    static void load_modules_in_thread(uint32 count)
+    {
+        ASSERT_TRUE(wasm_runtime_init_thread_env());
+        load_modules(count);
+        wasm_runtime_destroy_thread_env();
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+};
+
+TEST_F(runtime_metrics_test, exited_threads_counters_kept_and_reused)
+{
+    wasm_runtime_metrics_t metrics;
+    mem_alloc_info_t alloc_info;
+    uint32 free_size = 0, i;
+
+    for (i = 0; i < THREAD_NUM * 4; i++) {
+        std::thread(load_modules_in_thread, 1).join();
+
+        ASSERT_TRUE(wasm_runtime_get_metrics(&metrics));
+        EXPECT_EQ(metrics.module_load_count, i + 1);
+        EXPECT_EQ(metrics.module_load_time.count, i + 1);
+        /* The exited thread no longer counts */
+        EXPECT_EQ(metrics.thread_count, 0u);
+
+        /* The next threads record into the block of the first one */
+        ASSERT_TRUE(wasm_runtime_get_mem_alloc_info(&alloc_info));
+        if (i == 0)
+            free_size = alloc_info.total_free_size;
+        else
+            EXPECT_EQ(alloc_info.total_free_size, free_size);
+    }
+}
+
+TEST_F(runtime_metrics_test, snapshots_consistent_while_recording)
+{
+    std::vector<std::thread> threads;
+    std::atomic<bool> running(true);
+    wasm_runtime_metrics_t metrics;
+    uint64 last_count = 0;
+    uint32 i;
+
+    for (i = 0; i < THREAD_NUM; i++) {
+        threads.emplace_back(load_modules_in_thread, LOAD_NUM);
+    }
+
+    /* Each per-thread block is copied as a whole, so a load is never
+       seen counted without its latency or the other way round */
+    std::thread reader([&]() {
+        wasm_runtime_metrics_t snapshot;
+
+        while (running.load()) {
+            ASSERT_TRUE(wasm_runtime_get_metrics(&snapshot));
+            ASSERT_EQ(snapshot.module_load_count,
+                      snapshot.module_load_time.count);
+            ASSERT_GE(snapshot.module_load_count, last_count);
+            last_count = snapshot.module_load_count;
+        }
+    });
+
+    for (i = 0; i < THREAD_NUM; i++) {
+        threads[i].join();
+    }
+    running.store(false);
+    reader.join();
+
+    ASSERT_TRUE(wasm_runtime_get_metrics(&metrics));
+    EXPECT_EQ(metrics.module_load_count, (uint64)THREAD_NUM * LOAD_NUM);
+    EXPECT_EQ(metrics.module_load_time.count, (uint64)THREAD_NUM * LOAD_NUM);
+    EXPECT_EQ(metrics.module_load_failures, 0u);
+}
+
+TEST_F(runtime_metrics_test, reset_clears_counters)
+{
+    wasm_runtime_metrics_t metrics;
+
+    load_modules(3);
+    ASSERT_TRUE(wasm_runtime_get_metrics(&metrics));
+    EXPECT_EQ(metrics.module_load_count, 3u);
+    EXPECT_EQ(metrics.thread_count, 1u);
+
+    wasm_runtime_reset_metrics();
+    ASSERT_TRUE(wasm_runtime_get_metrics(&metrics));
+    EXPECT_EQ(metrics.module_load_count, 0u);
+    EXPECT_EQ(metrics.module_load_time.count, 0u);
+}
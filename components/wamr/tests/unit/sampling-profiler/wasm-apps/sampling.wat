@@ -0,0 +1,29 @@
+(module
+  ;; run(n) calls spin(1000) n times, so that the samples are taken
+  ;; either in run or in spin called by run
+
+  (func $spin (param $n i32) (result i32) (local $acc i32)
+    block $done
+      loop $loop
+        local.get $n i32.eqz br_if $done
+        local.get $acc local.get $n i32.xor local.set $acc
+        local.get $n i32.const 1 i32.sub local.set $n
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+
+  (func (export "run") (param $n i32) (result i32) (local $acc i32)
+    block $done
+      loop $loop
+        local.get $n i32.eqz br_if $done
+        i32.const 1000 call $spin
+        local.get $acc i32.add local.set $acc
+        local.get $n i32.const 1 i32.sub local.set $n
+        br $loop
+      end
+    end
+    local.get $acc
+  )
+)
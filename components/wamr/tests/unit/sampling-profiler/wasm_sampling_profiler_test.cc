@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "wasm_runtime_common.h"
+
+/* run is the first defined function after spin */
+#define STACK_RUN "aot_func#1"
+#define STACK_RUN_SPIN "aot_func#1;aot_func#0"
+
+class wasm_sampling_profiler_test : public testing::Test
+{
+  protected:
+    virtual void TearDown() { wasm_runtime_sampling_profiler_stop(); }
+
+    void run(uint32 n)
+    {
+        uint32 argv[1] = { n };
+
+        ASSERT_TRUE(env.execute("run", 1, argv)) << env.get_exception();
+    }
+
+    /* Dumps the folded stacks and returns the total count of samples */
+    uint32 dump(std::vector<std::string> &stacks)
+    {
+        uint32 size = wasm_runtime_sampling_profiler_get_buf_size();
+        std::vector<char> buf(size);
+        std::string line;
+        uint32 total = 0;
+
+        EXPECT_GT(size, 0u);
+        EXPECT_EQ(wasm_runtime_sampling_profiler_dump_to_buf(buf.data(), size),
+                  size);
+
+        std::istringstream lines(buf.data());
+        stacks.clear();
+        while (std::getline(lines, line)) {
+            size_t space = line.rfind(' ');
+
+            EXPECT_NE(space, std::string::npos) << line;
+            stacks.push_back(line.substr(0, space));
+            total += (uint32)std::stoul(line.substr(space + 1));
+        }
+        return total;
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    DummyExecEnv env{ "sampling.wasm" };
+};
+
+TEST_F(wasm_sampling_profiler_test, samples_wasm_call_stacks)
+{
+    std::vector<std::string> stacks;
+    bool spin_sampled = false;
+
+    ASSERT_TRUE(wasm_runtime_sampling_profiler_attach(env.get()));
+    ASSERT_TRUE(wasm_runtime_sampling_profiler_start(100));
+    /* Already running */
+    EXPECT_FALSE(wasm_runtime_sampling_profiler_start(100));
+
+    while (dump(stacks) < 16)
+        run(1000);
+    wasm_runtime_sampling_profiler_stop();
+
+    for (const std::string &stack : stacks) {
+        EXPECT_TRUE(stack == STACK_RUN || stack == STACK_RUN_SPIN) << stack;
+        if (stack == STACK_RUN_SPIN)
+            spin_sampled = true;
+    }
+    EXPECT_TRUE(spin_sampled);
+
+    /* A zero interval is rejected */
+    EXPECT_FALSE(wasm_runtime_sampling_profiler_start(0));
+}
+
+TEST_F(wasm_sampling_profiler_test, full_ring_keeps_latest_samples)
+{
+    std::vector<std::string> stacks;
+    uint32 total = 0, last;
+
+    ASSERT_TRUE(wasm_runtime_sampling_profiler_attach(env.get()));
+    ASSERT_TRUE(wasm_runtime_sampling_profiler_start(50));
+
+    /* Once the ring is full, it is replayed as a whole */
+    while (total < WASM_SAMPLING_PROFILER_RING_SIZE) {
+        run(1000);
+        last = total;
+        total = dump(stacks);
+        ASSERT_GE(total, last);
+        ASSERT_LE(total, (uint32)WASM_SAMPLING_PROFILER_RING_SIZE);
+    }
+    run(1000);
+    EXPECT_EQ(dump(stacks), (uint32)WASM_SAMPLING_PROFILER_RING_SIZE);
+}
+
+TEST_F(wasm_sampling_profiler_test, detached_exec_env_not_sampled)
+{
+    std::vector<std::string> stacks;
+    uint32 total;
+
+    ASSERT_TRUE(wasm_runtime_sampling_profiler_attach(env.get()));
+    ASSERT_TRUE(wasm_runtime_sampling_profiler_start(100));
+    while (dump(stacks) == 0)
+        run(1000);
+
+    wasm_runtime_sampling_profiler_detach(env.get());
+    total = dump(stacks);
+    run(10000);
+    EXPECT_EQ(dump(stacks), total);
+
+    /* The samples are kept once the profiler is stopped */
+    wasm_runtime_sampling_profiler_stop();
+    EXPECT_EQ(dump(stacks), total);
+}
@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2024 Xiaomi Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+#include "bh_read_file.h"
+#include "wasm_runtime_common.h"
+
+#define CHANNEL_CAPACITY 4
+#define MESSAGE_NUM 1000
+/* Long enough never to expire unless the channel is broken, which then
+   fails the test rather than hanging it */
+#define WAIT_TIMEOUT_US 10000000
+
+/* A producer and a consumer instance of wasm-apps/channel.c, which pass
+   messages allocated from the shared heap through a channel */
+class shared_heap_channel_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        SharedHeapInitArgs heap_args;
+        ChannelInitArgs channel_args;
+
+        memset(&heap_args, 0, sizeof(heap_args));
+        heap_args.size = 64 * 1024;
+        shared_heap = wasm_runtime_create_shared_heap(&heap_args);
+        ASSERT_TRUE(shared_heap != NULL);
+
+        memset(&channel_args, 0, sizeof(channel_args));
+        channel_args.shared_heap = shared_heap;
+        channel_args.capacity = CHANNEL_CAPACITY;
+        channel = wasm_runtime_create_channel(&channel_args);
+        ASSERT_TRUE(channel != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        uint32 i;
+
+        for (i = 0; i < 2; i++) {
+            if (module_insts[i]) {
+                wasm_runtime_detach_shared_heap(module_insts[i]);
+                wasm_runtime_deinstantiate(module_insts[i]);
+            }
+        }
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            wasm_runtime_free(wasm_file_buf);
+        if (channel)
+            wasm_runtime_destroy_channel(channel);
+    }
+
+    /* Instantiate the module twice, attach the shared heap to both
+       instances and grant them the channel */
+    void load_instances(const char *file_name)
+    {
+        uint32 i;
+
+        wasm_file_buf =
+            (uint8 *)bh_read_file_to_buffer(file_name, &wasm_file_size);
+        ASSERT_TRUE(wasm_file_buf != NULL) << file_name;
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_TRUE(module != NULL) << error_buf;
+
+        for (i = 0; i < 2; i++) {
+            module_insts[i] = wasm_runtime_instantiate(
+                module, 16 * 1024, 0, error_buf, sizeof(error_buf));
+            ASSERT_TRUE(module_insts[i] != NULL) << error_buf;
+            ASSERT_TRUE(
+                wasm_runtime_attach_shared_heap(module_insts[i], shared_heap));
+            channel_handles[i] =
+                wasm_runtime_channel_grant(module_insts[i], channel);
+            ASSERT_NE(channel_handles[i], 0u);
+        }
+    }
+
+    static bool call(wasm_module_inst_t module_inst, const char *name,
+                     uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func;
+        wasm_exec_env_t exec_env;
+        bool ret;
+
+        if (!(func = wasm_runtime_lookup_function(module_inst, name))
+            || !(exec_env =
+                     wasm_runtime_create_exec_env(module_inst, 16 * 1024)))
+            return false;
+        ret = wasm_runtime_call_wasm(exec_env, func, argc, argv);
+        wasm_runtime_destroy_exec_env(exec_env);
+        return ret;
+    }
+
+    void pass_message_by_address(const char *file_name);
+    void reject_channels_not_granted(const char *file_name);
+    void pipeline_in_polling_mode(const char *file_name);
+    void pipeline_with_waits(const char *file_name);
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    WASMSharedHeap *shared_heap = NULL;
+    wasm_channel_t channel = NULL;
+    /* Handles of the channel granted to the two instances */
+    uint32 channel_handles[2] = { 0, 0 };
+    uint8 *wasm_file_buf = NULL;
+    uint32 wasm_file_size = 0;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_insts[2] = { NULL, NULL };
+    char error_buf[128];
+};
+
+void
+shared_heap_channel_test::pass_message_by_address(const char *file_name)
+{
+    wasm_module_inst_t producer, consumer;
+    uint32 argv[2];
+    uint32 msg_offset;
+    int32 *msg;
+
+    load_instances(file_name);
+    producer = module_insts[0];
+    consumer = module_insts[1];
+
+    argv[0] = channel_handles[0];
+    argv[1] = 0x12345678;
+    ASSERT_TRUE(call(producer, "send_one", 2, argv))
+        << wasm_runtime_get_exception(producer);
+    msg_offset = argv[0];
+    ASSERT_NE(msg_offset, 0u);
+
+    /* The consumer gets the block the producer wrote, not a copy */
+    argv[0] = channel_handles[1];
+    ASSERT_TRUE(call(consumer, "recv_one", 1, argv))
+        << wasm_runtime_get_exception(consumer);
+    EXPECT_EQ(argv[0], msg_offset);
+    msg = (int32 *)wasm_runtime_addr_app_to_native(consumer, msg_offset);
+    ASSERT_TRUE(msg != NULL);
+    EXPECT_EQ(msg, wasm_runtime_addr_app_to_native(producer, msg_offset));
+    EXPECT_EQ(*msg, 0x12345678);
+    wasm_runtime_shared_heap_free(consumer, msg_offset);
+
+    /* Nothing left */
+    argv[0] = channel_handles[1];
+    ASSERT_TRUE(call(consumer, "recv_one", 1, argv));
+    EXPECT_EQ(argv[0], 0u);
+
+    /* A handle which wasn't granted */
+    argv[0] = channel_handles[0] + 1;
+    argv[1] = 1;
+    ASSERT_TRUE(call(producer, "send_one", 2, argv));
+    EXPECT_EQ(argv[0], 0u);
+}
+
+void
+shared_heap_channel_test::reject_channels_not_granted(const char *file_name)
+{
+    wasm_module_inst_t producer, consumer;
+    ChannelInitArgs channel_args;
+    wasm_channel_t private_channel;
+    uint32 argv[2], handle;
+
+    load_instances(file_name);
+    producer = module_insts[0];
+    consumer = module_insts[1];
+
+    /* Granting a channel again returns the same handle */
+    EXPECT_EQ(wasm_runtime_channel_grant(producer, channel),
+              channel_handles[0]);
+
+    /* A channel granted to the producer only */
+    memset(&channel_args, 0, sizeof(channel_args));
+    channel_args.shared_heap = shared_heap;
+    channel_args.capacity = CHANNEL_CAPACITY;
+    private_channel = wasm_runtime_create_channel(&channel_args);
+    ASSERT_TRUE(private_channel != NULL);
+    handle = wasm_runtime_channel_grant(producer, private_channel);
+    ASSERT_NE(handle, 0u);
+    ASSERT_NE(handle, channel_handles[0]);
+
+    argv[0] = handle;
+    argv[1] = 1;
+    ASSERT_TRUE(call(producer, "send_one", 2, argv));
+    EXPECT_NE(argv[0], 0u);
+
+    /* The consumer can't reach it with the producer's handle */
+    argv[0] = handle;
+    ASSERT_TRUE(call(consumer, "recv_one", 1, argv));
+    EXPECT_EQ(argv[0], 0u);
+
+    /* Nor can the producer once the grant is revoked */
+    wasm_runtime_channel_revoke(producer, handle);
+    argv[0] = handle;
+    argv[1] = 2;
+    ASSERT_TRUE(call(producer, "send_one", 2, argv));
+    EXPECT_EQ(argv[0], 0u);
+
+    /* The message left in it is freed with it */
+    wasm_runtime_destroy_channel(private_channel);
+
+    /* A destroyed channel isn't reachable any more while still granted */
+    wasm_runtime_destroy_channel(channel);
+    argv[0] = channel_handles[0];
+    argv[1] = 3;
+    ASSERT_TRUE(call(producer, "send_one", 2, argv));
+    EXPECT_EQ(argv[0], 0u);
+    channel = NULL;
+}
+
+void
+shared_heap_channel_test::pipeline_in_polling_mode(const char *file_name)
+{
+    uint32 argv[4];
+    uint32 i;
+
+    load_instances(file_name);
+
+    /* Fill the channel, the send after it fails in polling mode */
+    argv[0] = channel_handles[0];
+    argv[1] = 100;
+    argv[2] = CHANNEL_CAPACITY;
+    argv[3] = 0;
+    ASSERT_TRUE(call(module_insts[0], "produce", 4, argv))
+        << wasm_runtime_get_exception(module_insts[0]);
+    EXPECT_EQ(argv[0], 0u);
+
+    argv[0] = channel_handles[0];
+    argv[1] = 200;
+    argv[2] = 1;
+    argv[3] = 0;
+    ASSERT_TRUE(call(module_insts[0], "produce", 4, argv));
+    EXPECT_EQ(argv[0], (uint32)WASM_CHANNEL_FULL);
+
+    /* The messages are received in order and freed by the consumer */
+    argv[0] = channel_handles[1];
+    argv[1] = CHANNEL_CAPACITY;
+    argv[2] = 0;
+    ASSERT_TRUE(call(module_insts[1], "consume", 3, argv))
+        << wasm_runtime_get_exception(module_insts[1]);
+    EXPECT_EQ(argv[0], 100u + 101 + 102 + 103);
+
+    argv[0] = channel_handles[1];
+    argv[1] = 1;
+    argv[2] = 0;
+    ASSERT_TRUE(call(module_insts[1], "consume", 3, argv));
+    EXPECT_EQ((int32)argv[0], -WASM_CHANNEL_EMPTY);
+
+    /* The freed blocks are reused, so the heap doesn't run out */
+    for (i = 0; i < MESSAGE_NUM / CHANNEL_CAPACITY; i++) {
+        argv[0] = channel_handles[0];
+        argv[1] = i;
+        argv[2] = CHANNEL_CAPACITY;
+        argv[3] = 0;
+        ASSERT_TRUE(call(module_insts[0], "produce", 4, argv));
+        ASSERT_EQ(argv[0], 0u) << i;
+
+        argv[0] = channel_handles[1];
+        argv[1] = CHANNEL_CAPACITY;
+        argv[2] = 0;
+        ASSERT_TRUE(call(module_insts[1], "consume", 3, argv));
+        ASSERT_EQ(argv[0], i * CHANNEL_CAPACITY + 6) << i;
+    }
+
+    /* Closed and empty */
+    wasm_runtime_close_channel(channel);
+    argv[0] = channel_handles[1];
+    argv[1] = 1;
+    argv[2] = 0;
+    ASSERT_TRUE(call(module_insts[1], "consume", 3, argv));
+    EXPECT_EQ((int32)argv[0], -WASM_CHANNEL_CLOSED);
+}
+
+void
+shared_heap_channel_test::pipeline_with_waits(const char *file_name)
+{
+    uint32 producer_argv[4], consumer_argv[3];
+    bool producer_ret = false, consumer_ret = false;
+
+    load_instances(file_name);
+
+    /* Far more messages than the capacity, so that the producer and the
+       consumer wait for each other */
+    std::thread consumer([&]() {
+        if (!wasm_runtime_init_thread_env())
+            return;
+        consumer_argv[0] = channel_handles[1];
+        consumer_argv[1] = MESSAGE_NUM;
+        consumer_argv[2] = WAIT_TIMEOUT_US;
+        consumer_ret = call(module_insts[1], "consume", 3, consumer_argv);
+        wasm_runtime_destroy_thread_env();
+    });
+    std::thread producer([&]() {
+        if (!wasm_runtime_init_thread_env())
+            return;
+        producer_argv[0] = channel_handles[0];
+        producer_argv[1] = 1;
+        producer_argv[2] = MESSAGE_NUM;
+        producer_argv[3] = WAIT_TIMEOUT_US;
+        producer_ret = call(module_insts[0], "produce", 4, producer_argv);
+        wasm_runtime_destroy_thread_env();
+    });
+    producer.join();
+    consumer.join();
+
+    ASSERT_TRUE(producer_ret) << wasm_runtime_get_exception(module_insts[0]);
+    ASSERT_TRUE(consumer_ret) << wasm_runtime_get_exception(module_insts[1]);
+    EXPECT_EQ(producer_argv[0], 0u);
+    EXPECT_EQ(consumer_argv[0], MESSAGE_NUM * (MESSAGE_NUM + 1) / 2);
+}
+
+TEST_F(shared_heap_channel_test, pass_message_by_address_wasm)
+{
+    pass_message_by_address("channel.wasm");
+}
+
+TEST_F(shared_heap_channel_test, pass_message_by_address_aot)
+{
+    pass_message_by_address("channel.aot");
+}
+
+TEST_F(shared_heap_channel_test, reject_channels_not_granted_wasm)
+{
+    reject_channels_not_granted("channel.wasm");
+}
+
+TEST_F(shared_heap_channel_test, reject_channels_not_granted_aot)
+{
+    reject_channels_not_granted("channel.aot");
+}
+
+TEST_F(shared_heap_channel_test, pipeline_in_polling_mode_wasm)
+{
+    pipeline_in_polling_mode("channel.wasm");
+}
+
+TEST_F(shared_heap_channel_test, pipeline_in_polling_mode_aot)
+{
+    pipeline_in_polling_mode("channel.aot");
+}
+
+TEST_F(shared_heap_channel_test, pipeline_with_waits_wasm)
+{
+    pipeline_with_waits("channel.wasm");
+}
+
+TEST_F(shared_heap_channel_test, pipeline_with_waits_aot)
+{
+    pipeline_with_waits("channel.aot");
+}
+
+static void
+count_notifications(wasm_channel_t channel, void *user_data)
+{
+    (void)channel;
+    ((std::atomic<uint32> *)user_data)->fetch_add(1);
+}
+
+TEST_F(shared_heap_channel_test, notify_each_message_sent)
+{
+    std::atomic<uint32> notified(0);
+    ChannelInitArgs channel_args;
+    wasm_channel_t notifying_channel;
+    std::thread senders[2];
+    uint64 offset, size;
+    uint32 i, received = 0;
+
+    load_instances("channel.wasm");
+
+    memset(&channel_args, 0, sizeof(channel_args));
+    channel_args.shared_heap = shared_heap;
+    channel_args.capacity = MESSAGE_NUM;
+    channel_args.notify = count_notifications;
+    channel_args.notify_user_data = &notified;
+    notifying_channel = wasm_runtime_create_channel(&channel_args);
+    ASSERT_TRUE(notifying_channel != NULL);
+
+    /* The senders read the callback without taking the channel lock */
+    for (i = 0; i < 2; i++) {
+        senders[i] = std::thread([&, i]() {
+            uint32 j;
+            uint64 msg;
+
+            for (j = 0; j < MESSAGE_NUM / 2; j++) {
+                msg = wasm_runtime_shared_heap_malloc(module_insts[i], 16,
+                                                      NULL);
+                ASSERT_NE(msg, 0u);
+                ASSERT_EQ(wasm_runtime_channel_send(module_insts[i],
+                                                    notifying_channel, msg,
+                                                    16, 0),
+                          WASM_CHANNEL_OK);
+            }
+        });
+    }
+    for (i = 0; i < 2; i++) {
+        senders[i].join();
+    }
+    EXPECT_EQ(notified.load(), (uint32)MESSAGE_NUM / 2 * 2);
+
+    /* A failed send isn't notified */
+    EXPECT_EQ(wasm_runtime_channel_send(module_insts[0], notifying_channel, 0,
+                                        16, 0),
+              WASM_CHANNEL_INVALID);
+    EXPECT_EQ(notified.load(), (uint32)MESSAGE_NUM / 2 * 2);
+
+    while (wasm_runtime_channel_recv(module_insts[1], notifying_channel,
+                                     &offset, &size, 0)
+           == WASM_CHANNEL_OK) {
+        wasm_runtime_shared_heap_free(module_insts[1], offset);
+        received++;
+    }
+    EXPECT_EQ(received, (uint32)MESSAGE_NUM / 2 * 2);
+
+    wasm_runtime_destroy_channel(notifying_channel);
+}
@@ -6,8 +6,15 @@
 #include "test_helper.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
 #include "bh_read_file.h"
 #include "wasm_runtime_common.h"
+#include "wasm_memory.h"
+#include "wasm_runtime.h"
 
 class shared_heap_test : public testing::Test
 {
@@ -135,6 +142,7 @@ TEST_F(shared_heap_test, test_shared_heap_basic)
     WASMSharedHeap *shared_heap = nullptr;
     uint32 argv[1] = { 0 };
 
+    memset(&args, 0, sizeof(args));
     args.size = 1024;
     shared_heap = wasm_runtime_create_shared_heap(&args);
 
@@ -159,6 +167,7 @@ TEST_F(shared_heap_test, test_shared_heap_malloc_fail)
     WASMSharedHeap *shared_heap = nullptr;
     uint32 argv[1] = { 0 };
 
+    memset(&args, 0, sizeof(args));
     args.size = 1024;
     shared_heap = wasm_runtime_create_shared_heap(&args);
 
@@ -223,6 +232,7 @@ TEST_F(shared_heap_test, test_addr_conv)
         return;
     }
 
+    memset(&args, 0, sizeof(args));
     args.size = 1024;
     shared_heap = wasm_runtime_create_shared_heap(&args);
     if (!shared_heap) {
@@ -238,3 +248,267 @@ TEST_F(shared_heap_test, test_addr_conv)
     test_shared_heap(shared_heap, "test_addr_conv.aot", "test", 1, argv);
     EXPECT_EQ(1, argv[0]);
 }
+
+/* Attach a new shared heap to an instance of the dummy module, the blocks
+   are allocated and freed from the host side */
+class shared_heap_alloc_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        /* The loader may modify the buffer */
+        memcpy(wasm_buf, dummy_wasm_buffer, sizeof(dummy_wasm_buffer));
+        module = wasm_runtime_load(wasm_buf, sizeof(wasm_buf), error_buf,
+                                   sizeof(error_buf));
+        ASSERT_TRUE(module != NULL) << error_buf;
+        module_inst = wasm_runtime_instantiate(module, 8192, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_TRUE(module_inst != NULL) << error_buf;
+    }
+
+    virtual void TearDown()
+    {
+        if (module_inst) {
+            wasm_runtime_detach_shared_heap(module_inst);
+            wasm_runtime_deinstantiate(module_inst);
+        }
+        if (module)
+            wasm_runtime_unload(module);
+    }
+
+    void attach_shared_heap(uint32 size, uint32 max_size)
+    {
+        SharedHeapInitArgs args;
+
+        memset(&args, 0, sizeof(args));
+        args.size = size;
+        args.max_size = max_size;
+        shared_heap = wasm_runtime_create_shared_heap(&args);
+        ASSERT_TRUE(shared_heap != NULL);
+        ASSERT_TRUE(wasm_runtime_attach_shared_heap(module_inst, shared_heap));
+    }
+
+    uint64 shared_heap_malloc(uint64 size, uint8 **p_native_addr = NULL)
+    {
+        void *native_addr = NULL;
+        uint64 offset;
+
+        offset =
+            wasm_runtime_shared_heap_malloc(module_inst, size, &native_addr);
+        if (p_native_addr)
+            *p_native_addr = (uint8 *)native_addr;
+        return offset;
+    }
+
+    uint32 segment_count()
+    {
+        WASMSharedHeapSegment *segment;
+        uint32 count = 0;
+
+        for (segment = shared_heap->segments; segment; segment = segment->next)
+            count++;
+        return count;
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    uint8 wasm_buf[sizeof(dummy_wasm_buffer)];
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    WASMSharedHeap *shared_heap = NULL;
+    char error_buf[128];
+};
+
+TEST_F(shared_heap_alloc_test, grow_across_segments)
+{
+    const uint32 segment_size = 64 * 1024, block_size = 48 * 1024;
+    uint64 offsets[5] = { 0 };
+    uint8 *native_addrs[5] = { NULL };
+    uint32 i, j;
+
+    attach_shared_heap(segment_size, segment_size * 4);
+
+    /* The whole range is reserved at the top of the address space, only
+       the first segment is committed */
+    EXPECT_EQ(shared_heap->size, (uint64)segment_size * 4);
+    EXPECT_EQ(shared_heap->start_off_mem32,
+              (uint64)UINT32_MAX - segment_size * 4 + 1);
+    EXPECT_EQ(BH_ATOMIC_64_LOAD(shared_heap->committed_size),
+              (uint64)segment_size);
+    EXPECT_EQ(segment_count(), 1u);
+
+    /* Each block only fits in a new segment */
+    for (i = 0; i < 4; i++) {
+        offsets[i] = shared_heap_malloc(block_size, &native_addrs[i]);
+        ASSERT_NE(offsets[i], 0u) << i;
+        EXPECT_EQ(segment_count(), i + 1);
+        EXPECT_GE(offsets[i], shared_heap->start_off_mem32);
+        EXPECT_LE(offsets[i] + block_size - 1, (uint64)UINT32_MAX);
+        memset(native_addrs[i], 0x10 + i, block_size);
+    }
+    EXPECT_EQ(BH_ATOMIC_64_LOAD(shared_heap->committed_size),
+              shared_heap->size);
+
+    /* The heap can't grow beyond max_size */
+    EXPECT_EQ(shared_heap_malloc(block_size), 0u);
+    EXPECT_EQ(segment_count(), 4u);
+
+    /* The blocks didn't move while the heap grew */
+    for (i = 0; i < 4; i++) {
+        EXPECT_EQ(wasm_runtime_addr_app_to_native(module_inst, offsets[i]),
+                  native_addrs[i]);
+        EXPECT_TRUE(wasm_runtime_validate_app_addr(module_inst, offsets[i],
+                                                   block_size));
+        for (j = 0; j < block_size; j++) {
+            if (native_addrs[i][j] != 0x10 + i) {
+                ADD_FAILURE() << "block " << i << " changed at " << j;
+                break;
+            }
+        }
+    }
+
+    /* The space freed in a segment is allocated again */
+    wasm_runtime_shared_heap_free(module_inst, offsets[2]);
+    EXPECT_EQ(shared_heap_malloc(block_size), offsets[2]);
+}
+
+TEST_F(shared_heap_alloc_test, grow_for_large_block)
+{
+    const uint32 segment_size = 64 * 1024;
+    uint8 *native_addr = NULL;
+    uint64 offset;
+
+    attach_shared_heap(segment_size, segment_size * 4);
+
+    /* A block larger than the initial size gets a larger segment */
+    offset = shared_heap_malloc(segment_size * 2, &native_addr);
+    ASSERT_NE(offset, 0u);
+    EXPECT_EQ(segment_count(), 2u);
+    EXPECT_GT(shared_heap->segments->next->size, (uint64)segment_size * 2);
+    EXPECT_TRUE(wasm_runtime_validate_app_addr(module_inst, offset,
+                                               segment_size * 2));
+    memset(native_addr, 0xAB, segment_size * 2);
+
+    /* Not larger than the rest of the reserved range */
+    EXPECT_EQ(shared_heap_malloc(segment_size * 2), 0u);
+}
+
+TEST_F(shared_heap_alloc_test, small_blocks_freed_and_reused)
+{
+    std::set<uint64> offsets, offsets_reused;
+    uint64 offset, offset2;
+    uint32 i;
+
+    attach_shared_heap(64 * 1024, 0);
+
+    /* A freed small block is the next one of its size class */
+    offset = shared_heap_malloc(24);
+    ASSERT_NE(offset, 0u);
+    wasm_runtime_shared_heap_free(module_inst, offset);
+    EXPECT_EQ(shared_heap_malloc(20), offset);
+
+    /* Not the one of another size class */
+    offset2 = shared_heap_malloc(100);
+    ASSERT_NE(offset2, 0u);
+    wasm_runtime_shared_heap_free(module_inst, offset2);
+    EXPECT_NE(shared_heap_malloc(24), offset2);
+    EXPECT_EQ(shared_heap_malloc(100), offset2);
+
+    /* More blocks than a slab holds, none of them overlaps another */
+    for (i = 0; i < 200; i++) {
+        offset = shared_heap_malloc(24);
+        ASSERT_NE(offset, 0u) << i;
+        EXPECT_TRUE(offsets.insert(offset).second) << i;
+        memset(wasm_runtime_addr_app_to_native(module_inst, offset), 0xCD,
+               24);
+    }
+    for (auto it = offsets.begin(); std::next(it) != offsets.end(); it++)
+        EXPECT_GE(*std::next(it) - *it, 24u + 8u);
+
+    /* Freed and allocated again, the same blocks are reused */
+    for (auto off : offsets)
+        wasm_runtime_shared_heap_free(module_inst, off);
+    for (i = 0; i < 200; i++)
+        offsets_reused.insert(shared_heap_malloc(24));
+    EXPECT_EQ(offsets_reused, offsets);
+    EXPECT_EQ(segment_count(), 1u);
+}
+
+TEST_F(shared_heap_alloc_test, double_free_rejected)
+{
+    uint8 *native_addr = NULL, *large_addr = NULL;
+    uint64 offset, large_offset;
+
+    attach_shared_heap(64 * 1024, 0);
+
+    offset = shared_heap_malloc(24, &native_addr);
+    ASSERT_NE(offset, 0u);
+    EXPECT_TRUE(
+        wasm_runtime_shared_heap_is_allocated(shared_heap, native_addr));
+
+    /* An address inside the block isn't freed */
+    EXPECT_FALSE(
+        wasm_runtime_shared_heap_free_native(shared_heap, native_addr + 8));
+    EXPECT_TRUE(
+        wasm_runtime_shared_heap_is_allocated(shared_heap, native_addr));
+
+    EXPECT_TRUE(
+        wasm_runtime_shared_heap_free_native(shared_heap, native_addr));
+    EXPECT_FALSE(
+        wasm_runtime_shared_heap_is_allocated(shared_heap, native_addr));
+    EXPECT_FALSE(
+        wasm_runtime_shared_heap_free_native(shared_heap, native_addr));
+
+    /* Nor freed again through its app offset, it was pushed to its free
+       list once so it is handed out once */
+    wasm_runtime_shared_heap_free(module_inst, offset);
+    EXPECT_EQ(shared_heap_malloc(24), offset);
+    EXPECT_NE(shared_heap_malloc(24), offset);
+
+    /* Same for a large block */
+    large_offset = shared_heap_malloc(4096, &large_addr);
+    ASSERT_NE(large_offset, 0u);
+    EXPECT_TRUE(wasm_runtime_shared_heap_free_native(shared_heap, large_addr));
+    EXPECT_FALSE(
+        wasm_runtime_shared_heap_free_native(shared_heap, large_addr));
+    EXPECT_FALSE(
+        wasm_runtime_shared_heap_is_allocated(shared_heap, large_addr));
+}
+
+TEST_F(shared_heap_alloc_test, concurrent_double_free_rejected)
+{
+    const int thread_num = 4;
+    uint32 sizes[] = { 24, 4096 };
+    uint8 *native_addr;
+    int i, j, k;
+
+    attach_shared_heap(64 * 1024, 0);
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < 100; j++) {
+            std::atomic<int> freed(0), started(0);
+            std::vector<std::thread> threads;
+
+            native_addr = NULL;
+            ASSERT_NE(shared_heap_malloc(sizes[i], &native_addr), 0u);
+
+            /* Only one of the threads freeing the block succeeds */
+            for (k = 0; k < thread_num; k++) {
+                threads.emplace_back([&]() {
+                    started++;
+                    while (started < thread_num)
+                        ;
+                    if (wasm_runtime_shared_heap_free_native(shared_heap,
+                                                             native_addr))
+                        freed++;
+                });
+            }
+            for (auto &thread : threads)
+                thread.join();
+            EXPECT_EQ(freed, 1);
+        }
+    }
+
+    /* The small block was pushed to its free list once, so two
+       allocations get different blocks */
+    EXPECT_NE(shared_heap_malloc(24), shared_heap_malloc(24));
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 Xiaomi Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdio.h>
+
+extern void *
+shared_heap_malloc(int size);
+extern void
+shared_heap_free(void *offset);
+extern int
+shared_heap_channel_send(unsigned int handle, void *buf, unsigned int size,
+                         long long timeout_us);
+extern int
+shared_heap_channel_recv(unsigned int handle, void **p_buf,
+                         unsigned int *p_size, long long timeout_us);
+
+/* Send count messages holding seed + i, return 0 if all of them are sent,
+   otherwise the status of the send failed or -1 */
+int
+produce(unsigned int handle, int seed, int count, int timeout_us)
+{
+    int *msg;
+    int i, status;
+
+    for (i = 0; i < count; i++) {
+        msg = (int *)shared_heap_malloc(2 * sizeof(int));
+        if (msg == NULL) {
+            return -1;
+        }
+        msg[0] = seed + i;
+        msg[1] = ~(seed + i);
+        status =
+            shared_heap_channel_send(handle, msg, 2 * sizeof(int), timeout_us);
+        if (status != 0) {
+            shared_heap_free(msg);
+            return status;
+        }
+    }
+    return 0;
+}
+
+/* Receive count messages and free them, return the sum of the values
+   they hold, the status of the receive failed negated or -100 if a
+   message is corrupted */
+int
+consume(unsigned int handle, int count, int timeout_us)
+{
+    int *msg;
+    unsigned int size;
+    int i, status, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        status =
+            shared_heap_channel_recv(handle, (void **)&msg, &size, timeout_us);
+        if (status != 0) {
+            return -status;
+        }
+        if (size != 2 * sizeof(int) || msg[1] != ~msg[0]) {
+            return -100;
+        }
+        sum += msg[0];
+        shared_heap_free(msg);
+    }
+    return sum;
+}
+
+/* Send a message holding value, return its address or 0 */
+int
+send_one(unsigned int handle, int value)
+{
+    int *msg = (int *)shared_heap_malloc(sizeof(int));
+
+    if (msg == NULL) {
+        return 0;
+    }
+    *msg = value;
+    if (shared_heap_channel_send(handle, msg, sizeof(int), 0) != 0) {
+        shared_heap_free(msg);
+        return 0;
+    }
+    return (int)msg;
+}
+
+/* Receive a message without freeing it, return its address or 0 */
+int
+recv_one(unsigned int handle)
+{
+    int *msg;
+    unsigned int size;
+
+    if (shared_heap_channel_recv(handle, (void **)&msg, &size, 0) != 0) {
+        return 0;
+    }
+    return (int)msg;
+}
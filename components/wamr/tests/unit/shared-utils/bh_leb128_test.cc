@@ -24,6 +24,24 @@ run_read_leb_test(std::vector<uint8_t> data,
         ASSERT_EQ(data.size(), offset);
         ASSERT_EQ(expected_value, (T)value);
     }
+
+    if (expected_status == BH_LEB_READ_UNEXPECTED_END) {
+        return;
+    }
+
+    /* Decode it again from a longer buffer, which may be read a word at
+       a time, the bytes following the value mustn't change the result */
+    std::vector<uint8_t> padded = data;
+    padded.insert(padded.end(), 16, 0xff);
+    offset = 0;
+    status =
+        bh_leb_read(padded.data(), padded.data() + padded.size(),
+                    sizeof(T) * 8, std::is_signed<T>::value, &value, &offset);
+    ASSERT_EQ(expected_status, status);
+    if (status == BH_LEB_READ_SUCCESS) {
+        ASSERT_EQ(data.size(), offset);
+        ASSERT_EQ(expected_value, (T)value);
+    }
 }
 
 TEST(bh_leb128_test_suite, read_leb_u32)
@@ -59,4 +77,40 @@ TEST(bh_leb128_test_suite, read_leb_i64)
     run_read_leb_test<int64>({ 255, 255, 255, 255, 255, 255, 255, 255, 255, 0 },
                              BH_LEB_READ_SUCCESS,
                              INT64_MAX); // max value
-}
\ No newline at end of file
+}
+
+TEST(bh_leb128_test_suite, read_leb_i32)
+{
+    run_read_leb_test<int32>({ 0x7f }, BH_LEB_READ_SUCCESS, -1);
+    run_read_leb_test<int32>({ 0x3f }, BH_LEB_READ_SUCCESS, 63);
+    run_read_leb_test<int32>({ 0xc0, 0xbb, 0x78 }, BH_LEB_READ_SUCCESS,
+                             -123456); // arbitrary value
+    run_read_leb_test<int32>({ 0x80, 0x80, 0x80, 0x80, 0x78 },
+                             BH_LEB_READ_SUCCESS,
+                             INT32_MIN); // min value
+    run_read_leb_test<int32>({ 0xff, 0xff, 0xff, 0xff, 0x07 },
+                             BH_LEB_READ_SUCCESS,
+                             INT32_MAX); // max value
+    run_read_leb_test<int32>({ 0xff, 0xff, 0xff, 0xff, 0x4f },
+                             BH_LEB_READ_OVERFLOW, 0);
+    run_read_leb_test<int32>({ 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 },
+                             BH_LEB_READ_TOO_LONG, 0);
+}
+
+TEST(bh_leb128_test_suite, read_leb_long_i64)
+{
+    run_read_leb_test<int64>({ 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+                               0x7f },
+                             BH_LEB_READ_SUCCESS,
+                             -1); // 8 bytes, the most decoded at once
+    run_read_leb_test<int64>({ 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+                               0x80, 0x01 },
+                             BH_LEB_READ_SUCCESS,
+                             (int64)1 << 56); // 9 bytes
+    run_read_leb_test<int64>(
+        { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02 },
+        BH_LEB_READ_OVERFLOW, 0);
+    run_read_leb_test<int64>(
+        { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00 },
+        BH_LEB_READ_TOO_LONG, 0);
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "wasm.h"
+
+/* Functions of wasm-apps/stream.wat */
+static const char *func_names[] = { "init", "add",      "mul",
+                                    "apply", "checksum", "bump" };
+
+#define DATA_SIZE 300
+
+static void
+append_leb(std::vector<uint8_t> &buf, uint32_t value)
+{
+    do {
+        uint8_t byte = value & 0x7F;
+
+        value >>= 7;
+        buf.push_back(value ? byte | 0x80 : byte);
+    } while (value);
+}
+
+static void
+append_str(std::vector<uint8_t> &buf, const std::string &str)
+{
+    append_leb(buf, (uint32_t)str.size());
+    buf.insert(buf.end(), str.begin(), str.end());
+}
+
+static std::vector<uint8_t>
+custom_section(const std::string &name, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> body, section;
+
+    append_str(body, name);
+    body.insert(body.end(), payload.begin(), payload.end());
+
+    section.push_back(0);
+    append_leb(section, (uint32_t)body.size());
+    section.insert(section.end(), body.begin(), body.end());
+    return section;
+}
+
+/* Load wasm-apps/stream.wat from a buffer and from a stream, with custom
+   sections added after the header and after the last section */
+class stream_loader_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        std::ifstream file("stream.wasm", std::ios::binary);
+        std::vector<uint8_t> wasm((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+        std::vector<uint8_t> extra(200, 0x5A), names, function_names;
+        std::vector<uint8_t> section;
+        uint32_t i;
+
+        ASSERT_GT(wasm.size(), 8u);
+
+        /* A custom section which is dropped, its size has two bytes */
+        binary.assign(wasm.begin(), wasm.begin() + 8);
+        section = custom_section("extra", extra);
+        binary.insert(binary.end(), section.begin(), section.end());
+        binary.insert(binary.end(), wasm.begin() + 8, wasm.end());
+
+        /* The name section, which is kept */
+        append_leb(function_names, sizeof(func_names) / sizeof(func_names[0]));
+        for (i = 0; i < sizeof(func_names) / sizeof(func_names[0]); i++) {
+            append_leb(function_names, i);
+            append_str(function_names, func_names[i]);
+        }
+        names.push_back(1);
+        append_leb(names, (uint32_t)function_names.size());
+        names.insert(names.end(), function_names.begin(),
+                     function_names.end());
+        section = custom_section("name", names);
+        binary.insert(binary.end(), section.begin(), section.end());
+    }
+
+    wasm_module_t load_stream(uint32_t chunk_size)
+    {
+        LoadArgs args = { 0 };
+        wasm_stream_loader_t loader;
+        std::vector<uint8_t> chunk;
+        uint32_t offset, size;
+
+        args.name = (char *)"stream";
+        loader =
+            wasm_runtime_stream_load_create(&args, error_buf, sizeof(error_buf));
+        EXPECT_TRUE(loader != NULL) << error_buf;
+        if (!loader)
+            return NULL;
+
+        /* The same buffer is reused for each chunk */
+        for (offset = 0; offset < binary.size(); offset += size) {
+            size = std::min(chunk_size, (uint32_t)binary.size() - offset);
+            chunk.assign(binary.begin() + offset,
+                         binary.begin() + offset + size);
+            if (!wasm_runtime_stream_load_feed(loader, chunk.data(), size,
+                                               error_buf, sizeof(error_buf))) {
+                ADD_FAILURE() << "feed " << offset << ": " << error_buf;
+                wasm_runtime_stream_load_destroy(loader);
+                return NULL;
+            }
+            memset(chunk.data(), 0xFF, size);
+        }
+
+        return wasm_runtime_stream_load_finish(loader, error_buf,
+                                               sizeof(error_buf));
+    }
+
+    /* Feed the binary in 1-byte chunks until the loader fails, return the
+       offset of the byte which failed, or the size if none failed */
+    uint32_t feed_until_failure(const std::vector<uint8_t> &buf)
+    {
+        LoadArgs args = { 0 };
+        wasm_stream_loader_t loader;
+        uint32_t offset;
+
+        args.name = (char *)"stream";
+        loader =
+            wasm_runtime_stream_load_create(&args, error_buf, sizeof(error_buf));
+        EXPECT_TRUE(loader != NULL) << error_buf;
+        if (!loader)
+            return 0;
+
+        for (offset = 0; offset < buf.size(); offset++) {
+            if (!wasm_runtime_stream_load_feed(loader, &buf[offset], 1,
+                                               error_buf, sizeof(error_buf)))
+                break;
+        }
+        wasm_runtime_stream_load_destroy(loader);
+        return offset;
+    }
+
+    static uint32_t call(wasm_exec_env_t exec_env, const char *name,
+                         uint32_t argc, uint32_t argv[])
+    {
+        wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+        wasm_function_inst_t func;
+
+        func = wasm_runtime_lookup_function(module_inst, name);
+        EXPECT_TRUE(func != NULL) << name;
+        if (!func)
+            return 0;
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, argc, argv))
+            << name << ": " << wasm_runtime_get_exception(module_inst);
+        return argv[0];
+    }
+
+    /* Check that the module loaded from the stream is the same as the one
+       loaded from the whole buffer, and runs the same */
+    void check_same_module(WAMRModule &streamed, DummyExecEnv &whole)
+    {
+        WASMModule *s = (WASMModule *)streamed.get();
+        WASMModule *w = (WASMModule *)wasm_runtime_get_module(
+            wasm_runtime_get_module_inst(whole.get()));
+        WAMRInstance streamed_inst(streamed);
+        WAMRExecEnv streamed_exec_env(streamed_inst);
+        wasm_exec_env_t exec_envs[2] = { streamed_exec_env.get(),
+                                         whole.get() };
+        uint32_t results[2][6], i, j;
+
+        EXPECT_EQ(s->type_count, w->type_count);
+        EXPECT_EQ(s->function_count, w->function_count);
+        EXPECT_EQ(s->table_count, w->table_count);
+        EXPECT_EQ(s->memory_count, w->memory_count);
+        EXPECT_EQ(s->global_count, w->global_count);
+        EXPECT_EQ(s->export_count, w->export_count);
+        EXPECT_EQ(s->table_seg_count, w->table_seg_count);
+        EXPECT_EQ(s->data_seg_count, w->data_seg_count);
+        EXPECT_EQ(s->start_function, w->start_function);
+        ASSERT_EQ(s->function_count,
+                  sizeof(func_names) / sizeof(func_names[0]));
+        for (i = 0; i < s->function_count; i++) {
+            EXPECT_EQ(s->functions[i]->code_size, w->functions[i]->code_size);
+#if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
+            ASSERT_TRUE(s->functions[i]->field_name != NULL);
+            EXPECT_STREQ(s->functions[i]->field_name, func_names[i]);
+#endif
+        }
+        ASSERT_EQ(s->data_seg_count, 1u);
+        ASSERT_EQ(s->data_segments[0]->data_length, (uint32_t)DATA_SIZE);
+        EXPECT_EQ(0, memcmp(s->data_segments[0]->data,
+                            w->data_segments[0]->data, DATA_SIZE));
+
+        ASSERT_TRUE(streamed_exec_env.get() != NULL);
+
+        for (i = 0; i < 2; i++) {
+            uint32_t argv[3];
+
+            argv[0] = 0;
+            argv[1] = 6;
+            argv[2] = 7;
+            results[i][0] = call(exec_envs[i], "apply", 3, argv);
+            argv[0] = 1;
+            argv[1] = 6;
+            argv[2] = 7;
+            results[i][1] = call(exec_envs[i], "apply", 3, argv);
+            argv[0] = DATA_SIZE;
+            results[i][2] = call(exec_envs[i], "checksum", 1, argv);
+            argv[0] = DATA_SIZE / 3;
+            results[i][3] = call(exec_envs[i], "checksum", 1, argv);
+            /* the start function has run */
+            results[i][4] = call(exec_envs[i], "bump", 0, argv);
+            results[i][5] = call(exec_envs[i], "bump", 0, argv);
+        }
+
+        EXPECT_EQ(results[0][0], 13u);
+        EXPECT_EQ(results[0][1], 42u);
+        EXPECT_EQ(results[0][4], 8u);
+        EXPECT_EQ(results[0][5], 9u);
+        for (j = 0; j < 6; j++)
+            EXPECT_EQ(results[0][j], results[1][j]) << j;
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    std::vector<uint8_t> binary;
+    char error_buf[128];
+};
+
+TEST_F(stream_loader_test, one_byte_chunks_equal_whole_buffer)
+{
+    DummyExecEnv whole(binary.data(), (uint32_t)binary.size());
+    WAMRModule streamed(load_stream(1));
+
+    ASSERT_TRUE(streamed.get() != NULL) << error_buf;
+    check_same_module(streamed, whole);
+}
+
+TEST_F(stream_loader_test, any_chunk_size_equals_whole_buffer)
+{
+    static const uint32_t chunk_sizes[] = { 2, 3, 7, 64, 255, 100000 };
+    uint32_t i;
+
+    /* A new instance of the whole module each time, since bump changes a
+       global */
+    for (i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+        DummyExecEnv whole(binary.data(), (uint32_t)binary.size());
+        WAMRModule streamed(load_stream(chunk_sizes[i]));
+
+        ASSERT_TRUE(streamed.get() != NULL)
+            << chunk_sizes[i] << ": " << error_buf;
+        check_same_module(streamed, whole);
+    }
+}
+
+TEST_F(stream_loader_test, malformed_stream_fails_early)
+{
+    std::vector<uint8_t> buf;
+    uint32_t offset;
+
+    /* The header is checked once its 8 bytes arrive */
+    buf = binary;
+    buf[1] = 'b';
+    EXPECT_EQ(feed_until_failure(buf), 7u);
+    EXPECT_TRUE(strstr(error_buf, "magic header not detected")) << error_buf;
+
+    buf = binary;
+    buf[4] = 2;
+    EXPECT_EQ(feed_until_failure(buf), 7u);
+    EXPECT_TRUE(strstr(error_buf, "unknown binary version")) << error_buf;
+
+    /* The section after the custom section, whose id, size, name and
+       payload take 1 + 2 + 6 + 200 bytes, has an invalid id */
+    buf = binary;
+    offset = 8 + 1 + 2 + 6 + 200;
+    ASSERT_EQ(buf[offset], 1);
+    buf[offset] = 0x20;
+    EXPECT_EQ(feed_until_failure(buf), offset);
+    EXPECT_TRUE(strstr(error_buf, "invalid section id")) << error_buf;
+
+    /* The type section again, out of order */
+    buf[offset] = 1;
+    buf.push_back(1);
+    buf.push_back(0);
+    EXPECT_EQ(feed_until_failure(buf), (uint32_t)binary.size());
+    EXPECT_TRUE(strstr(error_buf, "unexpected content after last section"))
+        << error_buf;
+}
+
+TEST_F(stream_loader_test, truncated_stream_fails_at_finish)
+{
+    LoadArgs args = { 0 };
+    wasm_stream_loader_t loader;
+
+    args.name = (char *)"stream";
+    loader =
+        wasm_runtime_stream_load_create(&args, error_buf, sizeof(error_buf));
+    ASSERT_TRUE(loader != NULL) << error_buf;
+    ASSERT_TRUE(wasm_runtime_stream_load_feed(loader, binary.data(),
+                                              (uint32_t)binary.size() - 1,
+                                              error_buf, sizeof(error_buf)))
+        << error_buf;
+    EXPECT_TRUE(wasm_runtime_stream_load_finish(loader, error_buf,
+                                                sizeof(error_buf))
+                == NULL);
+    EXPECT_TRUE(strstr(error_buf, "unexpected end")) << error_buf;
+}
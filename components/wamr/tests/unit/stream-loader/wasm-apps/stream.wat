@@ -0,0 +1,76 @@
+;; A module with most kinds of sections, its data section is large enough
+;; to have a multi-byte size. The test adds the custom sections.
+
+(module
+  (type $binop (func (param i32 i32) (result i32)))
+  (table 2 funcref)
+  (memory 1)
+  (global $counter (mut i32) (i32.const 0))
+  (global $base i32 (i32.const 7))
+  (export "counter" (global $counter))
+  (start $init)
+  (elem (i32.const 0) $add $mul)
+
+  (func $init
+    global.get $base
+    global.set $counter
+  )
+
+  (func $add (param $a i32) (param $b i32) (result i32)
+    local.get $a
+    local.get $b
+    i32.add
+  )
+
+  (func $mul (param $a i32) (param $b i32) (result i32)
+    local.get $a
+    local.get $b
+    i32.mul
+  )
+
+  (func $apply (export "apply") (param $op i32) (param $a i32) (param $b i32)
+    (result i32)
+    local.get $a
+    local.get $b
+    local.get $op
+    call_indirect (type $binop)
+  )
+
+  ;; Sum of the bytes of the data segment weighted by their index
+  (func $checksum (export "checksum") (param $n i32) (result i32)
+    (local $i i32) (local $sum i32)
+    block $done
+      loop $next
+        local.get $i
+        local.get $n
+        i32.ge_u
+        br_if $done
+        local.get $i
+        i32.load8_u offset=16
+        local.get $i
+        i32.const 1
+        i32.add
+        i32.mul
+        local.get $sum
+        i32.add
+        local.set $sum
+        local.get $i
+        i32.const 1
+        i32.add
+        local.set $i
+        br $next
+      end
+    end
+    local.get $sum
+  )
+
+  (func $bump (export "bump") (result i32)
+    global.get $counter
+    i32.const 1
+    i32.add
+    global.set $counter
+    global.get $counter
+  )
+
+  (data (i32.const 16) " '.5<CJQX_fmt!(/6=DKRY`gnu')07>ELSZahov#*18?FMT[bipw$+29@GNU/cjqx%,3:AHOV]dkry&-4;BIPW^els '.5<CJQX_fmt!(/6=DKRY`gnu')07>ELSZahov#*18?FMT[bipw$+29@GNU/cjqx%,3:AHOV]dkry&-4;BIPW^els '.5<CJQX_fmt!(/6=DKRY`gnu')07>ELSZahov#*18?FMT[bipw$+29@GNU/cjqx%,3:AHOV]dkry&-4;BIPW^els '.5<CJQX_fmt!(/6=DKRY`gnu')07")
+)
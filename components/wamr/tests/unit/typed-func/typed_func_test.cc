@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <tuple>
+
+#include "wasm_typed_func.hpp"
+
+class typed_func_test : public testing::Test
+{
+  protected:
+    wasm_module_inst_t inst() const
+    {
+        return wasm_runtime_get_module_inst(env.get());
+    }
+
+    WAMRRuntimeRAII<> runtime;
+    DummyExecEnv env{ "typed_func.wasm" };
+};
+
+TEST_F(typed_func_test, calls_with_scalar_values)
+{
+    wamr::typed_func<int32_t(int32_t, int32_t)> add;
+    wamr::typed_func<uint32_t(uint32_t, uint32_t)> add_u;
+    wamr::typed_func<double(int32_t, int64_t, float, double)> mix;
+    int32_t sum;
+    uint32_t sum_u;
+    double total;
+
+    ASSERT_TRUE(add.bind(inst(), "add"));
+    ASSERT_TRUE(add.call(env.get(), &sum, 40, 2)) << env.get_exception();
+    EXPECT_EQ(sum, 42);
+    ASSERT_TRUE(add.call(env.get(), &sum, -5, 3));
+    EXPECT_EQ(sum, -2);
+
+    /* Unsigned types map to the same value types */
+    ASSERT_TRUE(add_u.bind(inst(), "add"));
+    ASSERT_TRUE(add_u.call(env.get(), &sum_u, 0xFFFFFFFF, 2));
+    EXPECT_EQ(sum_u, 1u);
+
+    /* The i64 and f64 arguments take two cells each */
+    ASSERT_TRUE(mix.bind(inst(), "mix"));
+    ASSERT_TRUE(mix.call(env.get(), &total, 1, (int64_t)1 << 40, 0.5f, 0.25))
+        << env.get_exception();
+    EXPECT_DOUBLE_EQ(total, 1 + (double)((int64_t)1 << 40) + 0.75);
+}
+
+TEST_F(typed_func_test, calls_with_multiple_or_no_results)
+{
+    wamr::typed_func<std::tuple<int64_t, int32_t>(int64_t, int64_t)> divmod;
+    wamr::typed_func<void(int32_t)> store;
+    wamr::typed_func<int32_t()> load;
+    std::tuple<int64_t, int32_t> qr;
+    int32_t value;
+
+    ASSERT_TRUE(divmod.bind(inst(), "divmod"));
+    ASSERT_TRUE(divmod.call(env.get(), &qr, -((int64_t)1 << 33) - 5, 4))
+        << env.get_exception();
+    EXPECT_EQ(std::get<0>(qr), -((int64_t)1 << 31) - 1);
+    EXPECT_EQ(std::get<1>(qr), -1);
+
+    ASSERT_TRUE(store.bind(inst(), "store"));
+    ASSERT_TRUE(load.bind(inst(), "load"));
+    ASSERT_TRUE(store.call(env.get(), 1234)) << env.get_exception();
+    ASSERT_TRUE(load.call(env.get(), &value)) << env.get_exception();
+    EXPECT_EQ(value, 1234);
+}
+
+TEST_F(typed_func_test, signature_mismatch_not_bound)
+{
+    wamr::typed_func<int32_t(int32_t, int64_t)> wrong_param;
+    wamr::typed_func<int32_t(int32_t)> wrong_param_count;
+    wamr::typed_func<int64_t(int32_t, int32_t)> wrong_result;
+    wamr::typed_func<void(int32_t, int32_t)> wrong_result_count;
+    wamr::typed_func<std::tuple<int64_t, int64_t>(int64_t, int64_t)>
+        wrong_tuple;
+    wamr::typed_func<int32_t(int32_t, int32_t)> add;
+    int32_t sum;
+
+    EXPECT_FALSE(wrong_param.bind(inst(), "add"));
+    EXPECT_FALSE(wrong_param_count.bind(inst(), "add"));
+    EXPECT_FALSE(wrong_result.bind(inst(), "add"));
+    EXPECT_FALSE(wrong_result_count.bind(inst(), "add"));
+    EXPECT_FALSE(wrong_tuple.bind(inst(), "divmod"));
+    EXPECT_FALSE(add.bind(inst(), "no_such_func"));
+    EXPECT_FALSE(add.bind(NULL, "add"));
+
+    /* An unbound function isn't called */
+    EXPECT_FALSE(add.is_bound());
+    EXPECT_FALSE(add.call(env.get(), &sum, 1, 2));
+
+    /* A failed bind drops the function bound before */
+    ASSERT_TRUE(add.bind(inst(), "add"));
+    EXPECT_FALSE(add.bind(inst(), "divmod"));
+    EXPECT_FALSE(add.is_bound());
+}
+
+TEST_F(typed_func_test, trap_reported_as_exception)
+{
+    wamr::typed_func<void()> trap;
+
+    ASSERT_TRUE(trap.bind(inst(), "trap"));
+    EXPECT_FALSE(trap.call(env.get()));
+    EXPECT_NE(std::string(env.get_exception()).find("unreachable"),
+              std::string::npos);
+}
@@ -0,0 +1,33 @@
+(module
+  (global $last (mut i32) (i32.const 0))
+
+  (func (export "add") (param $a i32) (param $b i32) (result i32)
+    local.get $a local.get $b i32.add
+  )
+
+  ;; a + b + c + d, with each argument in a different value type
+  (func (export "mix") (param $a i32) (param $b i64) (param $c f32) (param $d f64)
+        (result f64)
+    local.get $a f64.convert_i32_s
+    local.get $b f64.convert_i64_s f64.add
+    local.get $c f64.promote_f32 f64.add
+    local.get $d f64.add
+  )
+
+  (func (export "divmod") (param $a i64) (param $b i64) (result i64 i32)
+    local.get $a local.get $b i64.div_s
+    local.get $a local.get $b i64.rem_s i32.wrap_i64
+  )
+
+  (func (export "store") (param $v i32)
+    local.get $v global.set $last
+  )
+
+  (func (export "load") (result i32)
+    global.get $last
+  )
+
+  (func (export "trap")
+    unreachable
+  )
+)
@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "test_helper.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "bh_platform.h"
+#include "wasi_nn_cpu.h"
+
+#if WASM_ENABLE_WASI_EPHEMERAL_NN != 0
+#define TENSOR_TYPE_RAW_INT8 u8
+#define TENSOR_TYPE_INT32 i32
+#else
+#define TENSOR_TYPE_RAW_INT8 up8
+#define TENSOR_TYPE_INT32 ip32
+#endif
+
+#define WNNG_MAGIC 0x474E4E57
+#define NO_TENSOR 0xFFFFFFFF
+
+enum { CPU_F32 = 0, CPU_INT8, CPU_INT32 };
+enum { OP_DENSE = 0, OP_CONV2D, OP_MAX_POOL2D = 3 };
+enum { ACT_NONE = 0, ACT_RELU };
+
+/* A tensor record of the WNNG format, see wasi_nn_cpu.c */
+struct WNNGTensor {
+    uint32 type;
+    std::vector<uint32> dims;
+    float scale;
+    int32 zero_point;
+    std::vector<uint8> data;
+};
+
+template<typename T>
+static std::vector<uint8>
+to_bytes(const std::vector<T> &values)
+{
+    const uint8 *p = (const uint8 *)values.data();
+    return std::vector<uint8>(p, p + values.size() * sizeof(T));
+}
+
+static void
+put_u32(std::vector<uint8> &buf, uint32 value)
+{
+    for (uint32 i = 0; i < 4; i++)
+        buf.push_back((uint8)(value >> (i * 8)));
+}
+
+static std::vector<uint8>
+build_graph(const std::vector<WNNGTensor> &tensors,
+            const std::vector<std::vector<uint32>> &ops,
+            const std::vector<uint32> &inputs,
+            const std::vector<uint32> &outputs)
+{
+    std::vector<uint8> buf;
+    uint32 scale_bits, i;
+
+    put_u32(buf, WNNG_MAGIC);
+    put_u32(buf, 1);
+    put_u32(buf, (uint32)tensors.size());
+    put_u32(buf, (uint32)ops.size());
+    put_u32(buf, (uint32)inputs.size());
+    put_u32(buf, (uint32)outputs.size());
+    for (uint32 t : inputs)
+        put_u32(buf, t);
+    for (uint32 t : outputs)
+        put_u32(buf, t);
+
+    for (const WNNGTensor &t : tensors) {
+        put_u32(buf, t.type);
+        put_u32(buf, (uint32)t.dims.size());
+        for (i = 0; i < 4; i++)
+            put_u32(buf, i < t.dims.size() ? t.dims[i] : 0);
+        memcpy(&scale_bits, &t.scale, sizeof(float));
+        put_u32(buf, scale_bits);
+        put_u32(buf, (uint32)t.zero_point);
+        put_u32(buf, (uint32)t.data.size());
+        buf.insert(buf.end(), t.data.begin(), t.data.end());
+        while (buf.size() % 4)
+            buf.push_back(0);
+    }
+
+    for (const std::vector<uint32> &op : ops) {
+        EXPECT_EQ(op.size(), 11u);
+        for (uint32 v : op)
+            put_u32(buf, v);
+    }
+    return buf;
+}
+
+/*
+ * y = x * W^T + b with x = [2, -1], W = [[1, 0.5], [-0.5, 1]] and
+ * b = [0.5, -0.25], so y = [2, -2.25]. The values are exact in f32 and
+ * with the scales of the quantized graph.
+ */
+static std::vector<uint8>
+dense_f32_graph()
+{
+    return build_graph(
+        {
+            { CPU_F32, { 1, 2 }, 0, 0, {} },
+            { CPU_F32, { 2, 2 }, 0, 0, to_bytes<float>({ 1, 0.5, -0.5, 1 }) },
+            { CPU_F32, { 2 }, 0, 0, to_bytes<float>({ 0.5, -0.25 }) },
+            { CPU_F32, { 1, 2 }, 0, 0, {} },
+        },
+        { { OP_DENSE, ACT_NONE, 0, 0, 1, 2, 3, 0, 0, 0, 0 } }, { 0 }, { 3 });
+}
+
+/* The same dense op with int8 activations and weights: the input scale is
+   0.5, the weight scale 0.5, so the int32 bias scale is 0.25 */
+static std::vector<uint8>
+dense_int8_graph()
+{
+    return build_graph(
+        {
+            { CPU_INT8, { 1, 2 }, 0.5, 0, {} },
+            { CPU_INT8, { 2, 2 }, 0.5, 0, to_bytes<int8>({ 2, 1, -1, 2 }) },
+            { CPU_INT32, { 2 }, 0.25, 0, to_bytes<int32>({ 2, -1 }) },
+            { CPU_INT8, { 1, 2 }, 0.25, 0, {} },
+        },
+        { { OP_DENSE, ACT_NONE, 0, 0, 1, 2, 3, 0, 0, 0, 0 } }, { 0 }, { 3 });
+}
+
+/* A 2x2 conv2d with relu over a 3x3 image, then a 2x2 max pool */
+static std::vector<uint8>
+conv_pool_f32_graph()
+{
+    return build_graph(
+        {
+            { CPU_F32, { 1, 3, 3, 1 }, 0, 0, {} },
+            { CPU_F32, { 1, 2, 2, 1 }, 0, 0, to_bytes<float>({ 1, 1, 1, 1 }) },
+            { CPU_F32, { 1 }, 0, 0, to_bytes<float>({ -20 }) },
+            { CPU_F32, { 1, 2, 2, 1 }, 0, 0, {} },
+            { CPU_F32, { 1, 1, 1, 1 }, 0, 0, {} },
+        },
+        { { OP_CONV2D, ACT_RELU, 0, 0, 1, 2, 3, 1, 1, 0, 0 },
+          { OP_MAX_POOL2D, ACT_NONE, 0, 3, NO_TENSOR, NO_TENSOR, 4, 1, 1, 2,
+            2 } },
+        { 0 }, { 4 });
+}
+
+class wasi_nn_cpu_test : public testing::Test
+{
+  protected:
+    virtual void SetUp()
+    {
+        ASSERT_EQ(wasi_nn_cpu_init_backend(&ctx), success);
+    }
+
+    virtual void TearDown()
+    {
+        ASSERT_EQ(wasi_nn_cpu_deinit_backend(ctx), success);
+    }
+
+    wasi_nn_error load(std::vector<uint8> buf, graph *g,
+                       graph_encoding encoding = wamr_cpu,
+                       execution_target target = cpu)
+    {
+        graph_builder builder = { buf.data(), (uint32)buf.size() };
+        graph_builder_array builder_array = { &builder, 1 };
+
+        return wasi_nn_cpu_load(ctx, &builder_array, encoding, target, g);
+    }
+
+    /* Loads the graph and creates an execution context for it */
+    void prepare(const std::vector<uint8> &buf, graph_execution_context *exec)
+    {
+        graph g;
+
+        ASSERT_EQ(load(buf, &g), success);
+        ASSERT_EQ(wasi_nn_cpu_init_execution_context(ctx, g, exec), success);
+    }
+
+    wasi_nn_error set_input(graph_execution_context exec, void *data,
+                            std::vector<uint32> dims, tensor_type type)
+    {
+        tensor_dimensions dimensions = { dims.data(), (uint32)dims.size() };
+        tensor input = { &dimensions, type, (tensor_data)data };
+
+        return wasi_nn_cpu_set_input(ctx, exec, 0, &input);
+    }
+
+    wasi_nn_error get_output(graph_execution_context exec, float *output,
+                             uint32 *size)
+    {
+        return wasi_nn_cpu_get_output(ctx, exec, 0, (tensor_data)output,
+                                      size);
+    }
+
+    WAMRRuntimeRAII<512 * 1024> runtime;
+    void *ctx = NULL;
+};
+
+TEST_F(wasi_nn_cpu_test, dense_f32_round_trip)
+{
+    graph_encoding encodings[] = { wamr_cpu, autodetect };
+
+    for (graph_encoding encoding : encodings) {
+        graph g;
+        graph_execution_context exec;
+        float input[2] = { 2, -1 }, output[2] = { 0 };
+        uint32 size = 2;
+
+        ASSERT_EQ(load(dense_f32_graph(), &g, encoding), success);
+        ASSERT_EQ(wasi_nn_cpu_init_execution_context(ctx, g, &exec), success);
+        ASSERT_EQ(set_input(exec, input, { 1, 2 }, fp32), success);
+        ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+        ASSERT_EQ(get_output(exec, output, &size), success);
+        EXPECT_EQ(size, 2u);
+        EXPECT_FLOAT_EQ(output[0], 2.0f);
+        EXPECT_FLOAT_EQ(output[1], -2.25f);
+    }
+}
+
+TEST_F(wasi_nn_cpu_test, dense_int8_round_trip)
+{
+    graph_execution_context exec;
+    float input[2] = { 2, -1 }, output[2] = { 0 };
+    int8 input_q[2] = { 4, -2 };
+    uint32 size = 2;
+
+    prepare(dense_int8_graph(), &exec);
+
+    /* f32 values quantized by the backend, outputs come back as f32 */
+    ASSERT_EQ(set_input(exec, input, { 1, 2 }, fp32), success);
+    ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+    ASSERT_EQ(get_output(exec, output, &size), success);
+    EXPECT_FLOAT_EQ(output[0], 2.0f);
+    EXPECT_FLOAT_EQ(output[1], -2.25f);
+
+    /* Values already quantized with the parameters of the graph */
+    memset(output, 0, sizeof(output));
+    ASSERT_EQ(set_input(exec, input_q, { 1, 2 }, TENSOR_TYPE_RAW_INT8),
+              success);
+    ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+    ASSERT_EQ(get_output(exec, output, &size), success);
+    EXPECT_FLOAT_EQ(output[0], 2.0f);
+    EXPECT_FLOAT_EQ(output[1], -2.25f);
+}
+
+TEST_F(wasi_nn_cpu_test, conv2d_pool_round_trip)
+{
+    graph_execution_context exec;
+    float input[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 }, output[1] = { 0 };
+    uint32 size = 1;
+
+    prepare(conv_pool_f32_graph(), &exec);
+
+    /* The conv2d gives [12, 16, 24, 28] - 20, relu keeps [0, 0, 4, 8] */
+    ASSERT_EQ(set_input(exec, input, { 1, 3, 3, 1 }, fp32), success);
+    ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+    ASSERT_EQ(get_output(exec, output, &size), success);
+    EXPECT_EQ(size, 1u);
+    EXPECT_FLOAT_EQ(output[0], 8.0f);
+}
+
+TEST_F(wasi_nn_cpu_test, bound_tensors_used_by_each_compute)
+{
+    graph_execution_context exec;
+    float input[2] = { 2, -1 }, output[2] = { 0 };
+    uint32 dims_buf[2] = { 1, 2 };
+    tensor_dimensions dims = { dims_buf, 2 };
+    tensor bound = { &dims, fp32, (tensor_data)input };
+
+    prepare(dense_f32_graph(), &exec);
+    ASSERT_EQ(wasi_nn_cpu_bind_input(ctx, exec, 0, &bound), success);
+    ASSERT_EQ(wasi_nn_cpu_bind_output(ctx, exec, 0, (tensor_data)output,
+                                      sizeof(output)),
+              success);
+
+    ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+    EXPECT_FLOAT_EQ(output[0], 2.0f);
+    EXPECT_FLOAT_EQ(output[1], -2.25f);
+
+    /* No set_input() or get_output() between the inferences */
+    input[0] = 0;
+    input[1] = 2;
+    ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+    EXPECT_FLOAT_EQ(output[0], 1.5f);
+    EXPECT_FLOAT_EQ(output[1], 1.75f);
+}
+
+TEST_F(wasi_nn_cpu_test, bad_graphs_rejected)
+{
+    std::vector<uint8> buf;
+    graph g;
+
+    buf = dense_f32_graph();
+    buf[0] ^= 0xFF;
+    EXPECT_EQ(load(buf, &g), invalid_argument);
+
+    /* Cut in the middle of the weights */
+    buf = dense_f32_graph();
+    buf.resize(100);
+    EXPECT_EQ(load(buf, &g), invalid_argument);
+
+    /* An int8 tensor needs a positive scale */
+    buf = build_graph({ { CPU_INT8, { 1, 2 }, 0, 0, {} },
+                        { CPU_INT8, { 1, 2 }, 0.5, 0, {} } },
+                      { { 5, ACT_NONE, 0, 0, NO_TENSOR, NO_TENSOR, 1, 0, 0, 0,
+                          0 } },
+                      { 0 }, { 1 });
+    EXPECT_EQ(load(buf, &g), invalid_argument);
+
+    /* Dense weights that do not match the input */
+    buf = build_graph(
+        { { CPU_F32, { 1, 3 }, 0, 0, {} },
+          { CPU_F32, { 2, 2 }, 0, 0, to_bytes<float>({ 1, 0.5, -0.5, 1 }) },
+          { CPU_F32, { 1, 2 }, 0, 0, {} } },
+        { { OP_DENSE, ACT_NONE, 0, 0, 1, NO_TENSOR, 2, 0, 0, 0, 0 } }, { 0 },
+        { 2 });
+    EXPECT_EQ(load(buf, &g), invalid_argument);
+
+    EXPECT_EQ(load(dense_f32_graph(), &g, tensorflowlite), invalid_argument);
+    EXPECT_EQ(load(dense_f32_graph(), &g, wamr_cpu, gpu), invalid_argument);
+
+    /* Nothing was loaded at index 0 by the calls above */
+    EXPECT_EQ(load(std::vector<uint8>(), &g), invalid_argument);
+    graph_execution_context exec;
+    EXPECT_EQ(wasi_nn_cpu_init_execution_context(ctx, 0, &exec),
+              runtime_error);
+}
+
+TEST_F(wasi_nn_cpu_test, bad_tensors_rejected)
+{
+    graph_execution_context exec;
+    float input[4] = { 0 }, output[2] = { 0 };
+    int8 input_q[2] = { 0 };
+    int32 input_i32[2] = { 0 };
+    uint32 dims_buf[2] = { 1, 2 }, size = 1;
+    tensor_dimensions dims = { dims_buf, 2 };
+    tensor bound = { &dims, fp32, (tensor_data)input };
+
+    prepare(dense_f32_graph(), &exec);
+
+    /* Shape, element type and index */
+    EXPECT_EQ(set_input(exec, input, { 1, 3 }, fp32), invalid_argument);
+    EXPECT_EQ(set_input(exec, input, { 2, 2 }, fp32), invalid_argument);
+    EXPECT_EQ(set_input(exec, input_i32, { 1, 2 }, TENSOR_TYPE_INT32),
+              invalid_argument);
+    /* Quantized values only make sense for an int8 input */
+    EXPECT_EQ(set_input(exec, input_q, { 1, 2 }, TENSOR_TYPE_RAW_INT8),
+              invalid_argument);
+    EXPECT_EQ(wasi_nn_cpu_set_input(ctx, exec, 1, &bound), runtime_error);
+    EXPECT_EQ(wasi_nn_cpu_bind_input(ctx, exec, 1, &bound), runtime_error);
+
+    /* Output buffers too small for the tensor */
+    ASSERT_EQ(set_input(exec, input, { 1, 2 }, fp32), success);
+    ASSERT_EQ(wasi_nn_cpu_compute(ctx, exec), success);
+    EXPECT_EQ(get_output(exec, output, &size), too_large);
+    size = 2;
+    EXPECT_EQ(wasi_nn_cpu_get_output(ctx, exec, 1, (tensor_data)output,
+                                     &size),
+              runtime_error);
+    EXPECT_EQ(wasi_nn_cpu_bind_output(ctx, exec, 0, (tensor_data)output,
+                                      sizeof(float)),
+              too_large);
+
+    /* Execution contexts that were never created */
+    EXPECT_EQ(wasi_nn_cpu_compute(ctx, exec + 1), runtime_error);
+    EXPECT_EQ(wasi_nn_cpu_compute(ctx, 1000), runtime_error);
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bh_platform.h"
+#include "wasm_c_api.h"
+#include "wasm_c_api_internal.h"
+
+/* Exports of wasm-apps/func_call.wat */
+#define FUNC_REVERSE 0
+#define FUNC_DIV 1
+
+/* Params of reverse, (i32 i64 f32 f64) x 6 */
+#define REVERSE_ARITY 24
+
+class FuncCallTests : public ::testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        std::ifstream file("func_call.wasm", std::ios::binary);
+        std::vector<char> buf((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+        wasm_extern_vec_t imports = WASM_EMPTY_VEC;
+        wasm_byte_vec_t binary = { 0 };
+
+        engine = wasm_engine_new();
+        ASSERT_NE(nullptr, engine);
+        store = wasm_store_new(engine);
+        ASSERT_NE(nullptr, store);
+
+        ASSERT_FALSE(buf.empty());
+        wasm_byte_vec_new(&binary, buf.size(), buf.data());
+        module = wasm_module_new(store, &binary);
+        wasm_byte_vec_delete(&binary);
+        ASSERT_NE(nullptr, module);
+
+        instance = wasm_instance_new(store, module, &imports, NULL);
+        ASSERT_NE(nullptr, instance);
+        wasm_instance_exports(instance, &exports);
+        ASSERT_EQ(2, exports.size);
+        reverse = wasm_extern_as_func(exports.data[FUNC_REVERSE]);
+        div = wasm_extern_as_func(exports.data[FUNC_DIV]);
+        ASSERT_NE(nullptr, reverse);
+        ASSERT_NE(nullptr, div);
+    }
+
+    void TearDown()
+    {
+        wasm_extern_vec_delete(&exports);
+        if (instance)
+            wasm_instance_delete(instance);
+        wasm_store_delete(store);
+        wasm_engine_delete(engine);
+    }
+
+    /* The args of the n-th call of reverse */
+    static void reverse_args(uint32_t n, wasm_val_t args[REVERSE_ARITY])
+    {
+        uint32_t i;
+
+        for (i = 0; i < REVERSE_ARITY; i += 4) {
+            args[i] = WASM_I32_VAL((int32_t)(n * 100 + i));
+            args[i + 1] = WASM_I64_VAL((int64_t)(n * 100 + i + 1) << 33);
+            args[i + 2] = WASM_F32_VAL((float)(n * 100 + i + 2) + 0.5f);
+            args[i + 3] = WASM_F64_VAL((double)(n * 100 + i + 3) + 0.25);
+        }
+    }
+
+    static void check_reversed(const wasm_val_t args[REVERSE_ARITY],
+                               const wasm_val_t results[REVERSE_ARITY])
+    {
+        uint32_t i;
+
+        for (i = 0; i < REVERSE_ARITY; i++) {
+            const wasm_val_t *arg = &args[REVERSE_ARITY - 1 - i];
+            const wasm_val_t *result = &results[i];
+
+            ASSERT_EQ(arg->kind, result->kind) << i;
+            switch (arg->kind) {
+                case WASM_I32:
+                    EXPECT_EQ(arg->of.i32, result->of.i32) << i;
+                    break;
+                case WASM_I64:
+                    EXPECT_EQ(arg->of.i64, result->of.i64) << i;
+                    break;
+                case WASM_F32:
+                    EXPECT_EQ(arg->of.f32, result->of.f32) << i;
+                    break;
+                case WASM_F64:
+                    EXPECT_EQ(arg->of.f64, result->of.f64) << i;
+                    break;
+                default:
+                    FAIL() << i;
+            }
+        }
+    }
+
+    static std::string trap_message(wasm_trap_t *trap)
+    {
+        wasm_message_t message = { 0 };
+        std::string str;
+
+        wasm_trap_message(trap, &message);
+        if (message.data)
+            str.assign(message.data, strnlen(message.data, message.size));
+        wasm_byte_vec_delete(&message);
+        return str;
+    }
+
+    wasm_engine_t *engine = nullptr;
+    wasm_store_t *store = nullptr;
+    wasm_module_t *module = nullptr;
+    wasm_instance_t *instance = nullptr;
+    wasm_extern_vec_t exports = { 0 };
+    wasm_func_t *reverse = nullptr;
+    wasm_func_t *div = nullptr;
+};
+
+TEST_F(FuncCallTests, layout_over_argv_buffer)
+{
+    wasm_val_t args[REVERSE_ARITY], results[REVERSE_ARITY];
+    wasm_val_vec_t args_vec = WASM_ARRAY_VEC(args);
+    wasm_val_vec_t results_vec = WASM_ARRAY_VEC(results);
+    uint32_t n;
+
+    /* 36 cells, the argv is allocated with the layout */
+    ASSERT_NE(nullptr, reverse->layout);
+    EXPECT_EQ(36u, reverse->layout->param_cell_num);
+    EXPECT_EQ(36u, reverse->layout->result_cell_num);
+    EXPECT_GT(reverse->layout->param_cell_num, WASM_FUNC_ARGV_BUF_SIZE);
+    EXPECT_NE(nullptr, reverse->layout->argv);
+
+    /* Fits the buffer on the stack */
+    ASSERT_NE(nullptr, div->layout);
+    EXPECT_EQ(2u, div->layout->param_cell_num);
+    EXPECT_EQ(1u, div->layout->result_cell_num);
+    EXPECT_EQ(nullptr, div->layout->argv);
+
+    /* The allocated argv is reused by the calls */
+    for (n = 0; n < 3; n++) {
+        reverse_args(n, args);
+        memset(results, 0, sizeof(results));
+        ASSERT_EQ(nullptr, wasm_func_call(reverse, &args_vec, &results_vec));
+        check_reversed(args, results);
+    }
+}
+
+TEST_F(FuncCallTests, call_batch)
+{
+    wasm_val_t args[3 * REVERSE_ARITY], results[3 * REVERSE_ARITY];
+    size_t completed = 0;
+    uint32_t n;
+
+    for (n = 0; n < 3; n++)
+        reverse_args(n, args + n * REVERSE_ARITY);
+    memset(results, 0, sizeof(results));
+
+    ASSERT_EQ(nullptr,
+              wasm_func_call_batch(reverse, args, results, 3, &completed));
+    EXPECT_EQ(3u, completed);
+    for (n = 0; n < 3; n++)
+        check_reversed(args + n * REVERSE_ARITY, results + n * REVERSE_ARITY);
+
+    /* Nothing to call */
+    completed = 1;
+    EXPECT_EQ(nullptr,
+              wasm_func_call_batch(reverse, args, results, 0, &completed));
+    EXPECT_EQ(0u, completed);
+}
+
+TEST_F(FuncCallTests, call_batch_propagates_trap)
+{
+    wasm_val_t args[5 * 2], results[5];
+    wasm_val_t div_args[2] = { WASM_I32_VAL(9), WASM_I32_VAL(3) };
+    wasm_val_t div_results[1] = { WASM_INIT_VAL };
+    wasm_val_vec_t div_args_vec = WASM_ARRAY_VEC(div_args);
+    wasm_val_vec_t div_results_vec = WASM_ARRAY_VEC(div_results);
+    wasm_trap_t *trap;
+    size_t completed = 0;
+    uint32_t i;
+
+    for (i = 0; i < 5; i++) {
+        args[i * 2] = WASM_I32_VAL((int32_t)(i + 1) * 10);
+        /* the third call divides by zero */
+        args[i * 2 + 1] = WASM_I32_VAL(i == 2 ? 0 : (int32_t)i + 1);
+        results[i] = WASM_I32_VAL(-1);
+    }
+
+    trap = wasm_func_call_batch(div, args, results, 5, &completed);
+    ASSERT_NE(nullptr, trap);
+    EXPECT_NE(std::string::npos,
+              trap_message(trap).find("integer divide by zero"))
+        << trap_message(trap);
+    wasm_trap_delete(trap);
+
+    /* The calls before the trap returned, the ones after it are skipped */
+    EXPECT_EQ(2u, completed);
+    EXPECT_EQ(10, results[0].of.i32);
+    EXPECT_EQ(10, results[1].of.i32);
+    EXPECT_EQ(-1, results[3].of.i32);
+    EXPECT_EQ(-1, results[4].of.i32);
+
+    /* Without completed */
+    trap = wasm_func_call_batch(div, args, results, 5, NULL);
+    ASSERT_NE(nullptr, trap);
+    wasm_trap_delete(trap);
+
+    /* The exception doesn't stick to the next calls */
+    ASSERT_EQ(nullptr,
+              wasm_func_call_batch(div, args, results, 2, &completed));
+    EXPECT_EQ(2u, completed);
+    ASSERT_EQ(nullptr, wasm_func_call(div, &div_args_vec, &div_results_vec));
+    EXPECT_EQ(3, div_results[0].of.i32);
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "bh_platform.h"
+#include "wasm_c_api.h"
+#include "wasm_c_api_internal.h"
+
+#if WASM_ENABLE_WASM_CACHE != 0
+
+/* Offset of the byte of the data segment of wasm-apps/module_cache.wat
+   which is changed to get a near-identical binary */
+#define MARKER_OFFSET 512
+
+class ModuleCacheTests : public ::testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        std::ifstream file("module_cache.wasm", std::ios::binary);
+        std::vector<char> buf((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+
+        engine = wasm_engine_new();
+        ASSERT_NE(nullptr, engine);
+        store = wasm_store_new(engine);
+        ASSERT_NE(nullptr, store);
+
+        ASSERT_FALSE(buf.empty());
+        wasm_byte_vec_new(&binary, buf.size(), buf.data());
+        wasm_byte_vec_copy(&near_binary, &binary);
+
+        /* Change a byte which is neither in the head nor in the tail hashed
+           for the key of the cache, so that only the digests differ */
+        char *marker = (char *)memchr(near_binary.data, 'M', near_binary.size);
+        ASSERT_NE(nullptr, marker);
+        ASSERT_GT(marker - near_binary.data, 256);
+        ASSERT_GT(near_binary.data + near_binary.size - marker, 256);
+        *marker = 'N';
+    }
+
+    void TearDown()
+    {
+        wasm_byte_vec_delete(&near_binary);
+        wasm_byte_vec_delete(&binary);
+        wasm_store_delete(store);
+        wasm_engine_delete(engine);
+    }
+
+    /* Instantiate the module and read the byte of its data segment at
+       MARKER_OFFSET */
+    int32_t get_marker(wasm_module_t *module)
+    {
+        wasm_extern_vec_t imports = WASM_EMPTY_VEC;
+        wasm_extern_vec_t exports = { 0 };
+        wasm_val_t args[1] = { WASM_I32_VAL(MARKER_OFFSET) };
+        wasm_val_t results[1] = { WASM_INIT_VAL };
+        wasm_val_vec_t args_vec = WASM_ARRAY_VEC(args);
+        wasm_val_vec_t results_vec = WASM_ARRAY_VEC(results);
+        wasm_instance_t *instance;
+        wasm_trap_t *trap;
+
+        instance = wasm_instance_new(store, module, &imports, NULL);
+        EXPECT_NE(nullptr, instance);
+        if (!instance)
+            return -1;
+
+        wasm_instance_exports(instance, &exports);
+        EXPECT_EQ(1, exports.size);
+        trap = wasm_func_call(wasm_extern_as_func(exports.data[0]), &args_vec,
+                              &results_vec);
+        EXPECT_EQ(nullptr, trap);
+        if (trap)
+            wasm_trap_delete(trap);
+
+        wasm_extern_vec_delete(&exports);
+        wasm_instance_delete(instance);
+        return results[0].of.i32;
+    }
+
+    wasm_engine_t *engine = nullptr;
+    wasm_store_t *store = nullptr;
+    wasm_byte_vec_t binary = { 0 };
+    wasm_byte_vec_t near_binary = { 0 };
+};
+
+TEST_F(ModuleCacheTests, hit_returns_same_module)
+{
+    wasm_module_t *module1 = wasm_module_new(store, &binary);
+    ASSERT_NE(nullptr, module1);
+
+    wasm_module_t *module2 = wasm_module_new(store, &binary);
+    EXPECT_EQ(module1, module2);
+
+    /* The modules are shared by the stores of the engine */
+    wasm_store_t *store2 = wasm_store_new(engine);
+    ASSERT_NE(nullptr, store2);
+    wasm_module_t *module3 = wasm_module_new(store2, &binary);
+    EXPECT_EQ(module1, module3);
+    wasm_store_delete(store2);
+
+    /* Still referred by the first store */
+    EXPECT_EQ('M', get_marker(module1));
+}
+
+TEST_F(ModuleCacheTests, near_identical_binary_misses)
+{
+    wasm_module_t *module = wasm_module_new(store, &binary);
+    ASSERT_NE(nullptr, module);
+
+    /* Same size and quick hash, different digest */
+    wasm_module_t *near_module = wasm_module_new(store, &near_binary);
+    ASSERT_NE(nullptr, near_module);
+    EXPECT_NE(module, near_module);
+
+    EXPECT_EQ('M', get_marker(module));
+    EXPECT_EQ('N', get_marker(near_module));
+
+    /* Both modules are chained under the same key */
+    EXPECT_EQ(module, wasm_module_new(store, &binary));
+    EXPECT_EQ(near_module, wasm_module_new(store, &near_binary));
+
+    /* The last byte of the binary is in the tail hashed for the key */
+    near_binary.data[near_binary.size - 1] = ',';
+    wasm_module_t *tail_module = wasm_module_new(store, &near_binary);
+    ASSERT_NE(nullptr, tail_module);
+    EXPECT_NE(module, tail_module);
+    EXPECT_NE(near_module, tail_module);
+}
+
+TEST_F(ModuleCacheTests, released_module_leaves_the_chain)
+{
+    wasm_store_t *store2 = wasm_store_new(engine);
+    ASSERT_NE(nullptr, store2);
+
+    wasm_module_t *module = wasm_module_new(store2, &binary);
+    wasm_module_t *near_module = wasm_module_new(store, &near_binary);
+    ASSERT_NE(nullptr, module);
+    ASSERT_NE(nullptr, near_module);
+
+    /* The module at the head of the chain is released with its store,
+       the other one is still found */
+    wasm_store_delete(store2);
+    EXPECT_EQ(near_module, wasm_module_new(store, &near_binary));
+
+    /* And the released one is loaded again */
+    module = wasm_module_new(store, &binary);
+    ASSERT_NE(nullptr, module);
+    EXPECT_NE(near_module, module);
+    EXPECT_EQ(module, wasm_module_new(store, &binary));
+    EXPECT_EQ('M', get_marker(module));
+    EXPECT_EQ('N', get_marker(near_module));
+}
+
+#endif /* end of WASM_ENABLE_WASM_CACHE != 0 */
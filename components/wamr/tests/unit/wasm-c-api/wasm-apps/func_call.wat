@@ -0,0 +1,40 @@
+;; Functions whose params and results don't fit the argv buffer of 32
+;; cells on the stack of wasm_func_call, and a function which traps
+
+(module
+  ;; (i32 i64 f32 f64) x 6 = 36 cells, returns the params reversed
+  (func (export "reverse")
+    (param i32 i64 f32 f64 i32 i64 f32 f64 i32 i64 f32 f64 i32 i64 f32 f64 i32 i64 f32 f64 i32 i64 f32 f64)
+    (result f64 f32 i64 i32 f64 f32 i64 i32 f64 f32 i64 i32 f64 f32 i64 i32 f64 f32 i64 i32 f64 f32 i64 i32)
+    local.get 23
+    local.get 22
+    local.get 21
+    local.get 20
+    local.get 19
+    local.get 18
+    local.get 17
+    local.get 16
+    local.get 15
+    local.get 14
+    local.get 13
+    local.get 12
+    local.get 11
+    local.get 10
+    local.get 9
+    local.get 8
+    local.get 7
+    local.get 6
+    local.get 5
+    local.get 4
+    local.get 3
+    local.get 2
+    local.get 1
+    local.get 0
+  )
+
+  (func (export "div") (param $a i32) (param $b i32) (result i32)
+    local.get $a
+    local.get $b
+    i32.div_s
+  )
+)
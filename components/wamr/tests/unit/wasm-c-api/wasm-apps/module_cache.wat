@@ -0,0 +1,28 @@
+;; A module whose binary is over 512 bytes, so that the module cache
+;; digests it when only a byte in the middle of the data differs
+
+(module
+  (memory 1)
+  (data (i32.const 0)
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "M..............................................................."
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................"
+        "................................................................")
+
+  (func (export "get") (param $addr i32) (result i32)
+    local.get $addr
+    i32.load8_u
+  )
+)
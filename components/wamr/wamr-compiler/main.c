@@ -145,6 +145,10 @@ print_help()
     printf("                              if the option is set, the status is same as the option value\n");
     printf("  --stack-usage=<file>      Generate a stack-usage file.\n");
     printf("                              Similarly to `clang -fstack-usage`.\n");
+    printf("  --emit-stack-usage        Record the stack usage of each function and the max stack usage\n");
+    printf("                              of the call graph in the AOT file, which the runtime uses to\n");
+    printf("                              size the stacks. The native stack usage is only recorded with\n");
+    printf("                              the native stack bounds checks or the stack estimation\n");
     printf("  --format=<format>         Specifies the format of the output file\n");
     printf("                            The format supported:\n");
     printf("                              aot (default)  AoT file\n");
@@ -173,6 +177,8 @@ print_help()
     printf("  --xip                     A shorthand of --enable-indirect-mode --disable-llvm-intrinsics\n");
     printf("  --enable-indirect-mode    Enable call function through symbol table but not direct call\n");
     printf("  --enable-gc               Enable GC (Garbage Collection) feature\n");
+    printf("  --enable-gc-write-barrier Call the write barrier of the incremental or generational GC, so that\n");
+    printf("                              the GC heap can be collected incrementally or generationally\n");
     printf("  --disable-llvm-intrinsics Disable the LLVM built-in intrinsics\n");
     printf("  --enable-builtin-intrinsics=<flags>\n");
     printf("                            Enable the specified built-in intrinsics, it will override the default\n");
@@ -483,6 +489,9 @@ main(int argc, char *argv[])
         else if (!strncmp(argv[0], "--stack-usage=", 14)) {
             option.stack_usage_file = argv[0] + 14;
         }
+        else if (!strcmp(argv[0], "--emit-stack-usage")) {
+            option.emit_stack_usage = true;
+        }
         else if (!strncmp(argv[0], "--format=", 9)) {
             if (argv[0][9] == '\0')
                 PRINT_HELP_AND_EXIT();
@@ -562,6 +571,9 @@ main(int argc, char *argv[])
             option.aux_stack_frame_type = AOT_STACK_FRAME_TYPE_STANDARD;
             option.enable_gc = true;
         }
+        else if (!strcmp(argv[0], "--enable-gc-write-barrier")) {
+            option.enable_gc_write_barrier = true;
+        }
         else if (!strcmp(argv[0], "--disable-llvm-intrinsics")) {
             option.disable_llvm_intrinsics = true;
         }
@@ -713,6 +725,11 @@ main(int argc, char *argv[])
         option.enable_ref_types = false;
     }
 
+    if (option.enable_gc_write_barrier && !option.enable_gc) {
+        LOG_WARNING("GC write barrier is ignored since GC isn't enabled");
+        option.enable_gc_write_barrier = false;
+    }
+
     if (!use_dummy_wasm) {
         wasm_file_name = argv[0];
 
@@ -13,6 +13,67 @@
 #define MAX_WASM_FILE_SIZE (64 * 1024)  
 #define LOG_TAG "wamr"
 
+// stack of the thread loading the module, which doesn't run wasm code
+#define WASM_LOADER_STACK_SIZE (4096)
+// stack of the thread running the app when the module doesn't record a
+// bounded stack usage (bytecode, or AOT with recursion), guarded by the
+// runtime's native stack checks; also the lower bound, as the app thread
+// instantiates the module before running it
+#define WASM_APP_STACK_SIZE_MAX (4096)
+// stack used by the app thread itself besides the wasm calls (logging etc.)
+#define WASM_APP_STACK_RESERVE (2048)
+#define WASM_APP_WASM_STACK_SIZE (64 * 1024)
+#define WASM_APP_HEAP_SIZE (128 * 1024)
+
+typedef struct {
+    wasm_module_t module;
+    uint32_t wasm_stack_size;
+    wasm_module_inst_t module_inst;
+    char error_buf[128];
+} wasm_app_t;
+
+#ifdef CONFIG_WAMR_ENABLE_SAMPLING_PROFILER
+#define SAMPLING_INTERVAL_US (1000)
+#endif
+
+#ifdef CONFIG_WAMR_ENABLE_STATIC_PGO
+#define PGO_STORAGE_PARTITION_NAME "storage"
+#define PGO_RECORD_MAGIC (0x52475057) // "WPGR"
+#define PGO_RECORD_RAW_PROFILE (0)
+#define PGO_RECORD_COUNTERS (1)
+#define PGO_HEX_BYTES_PER_LINE (32)
+
+// header of the exported profiles, both on the serial console (as hex
+// lines between WAMR-PGO-BEGIN and WAMR-PGO-END) and in the storage
+// partition, where records are appended at 4-byte aligned offsets
+typedef struct {
+    uint32_t magic;
+    uint32_t kind;
+    uint32_t size;
+} pgo_record_header_t;
+#endif
+
+
+static bool run_in_thread(void *(*func)(void *), void *arg, size_t stack_size) {
+    pthread_t t;
+    pthread_attr_t tattr;
+    int res;
+
+    pthread_attr_init(&tattr);
+    pthread_attr_setdetachstate(&tattr, PTHREAD_CREATE_JOINABLE);
+    pthread_attr_setstacksize(&tattr, stack_size);
+
+    res = pthread_create(&t, &tattr, func, arg);
+    pthread_attr_destroy(&tattr);
+    if (res != 0) {
+        ESP_LOGE(LOG_TAG, "failed to create thread with %zu bytes stack", stack_size);
+        return false;
+    }
+
+    res = pthread_join(t, NULL);
+    assert(res == 0);
+    return true;
+}
 
 static void *app_instance_main(wasm_module_inst_t module_inst) {
     const char *exception;
@@ -67,9 +128,10 @@ uint8_t *load_wasm_from_flash(size_t *wasm_file_buf_size) {
     *wasm_file_buf_size = actual_size;  // set detected size
     ESP_LOGI(LOG_TAG, "detected WASM file size %zu bytes", *wasm_file_buf_size);
 
-    // Validate WASM magic header
+    // Validate WASM or AOT magic header
     if (!(wasm_data[0] == 0x00 && wasm_data[1] == 0x61 &&
-          wasm_data[2] == 0x73 && wasm_data[3] == 0x6D)) {
+          ((wasm_data[2] == 0x73 && wasm_data[3] == 0x6D) ||    // "\0asm"
+           (wasm_data[2] == 0x6F && wasm_data[3] == 0x74)))) {  // "\0aot"
         ESP_LOGE(LOG_TAG, "invalid WASM header");
         free(wasm_data);
         return NULL;
@@ -81,6 +143,146 @@ uint8_t *load_wasm_from_flash(size_t *wasm_file_buf_size) {
 
 
 
+#ifdef CONFIG_WAMR_ENABLE_STATIC_PGO
+#ifdef CONFIG_WASM_RUNNER_PGO_EXPORT_STORAGE
+// returns the offset after the last record, or -1 if the partition holds
+// something else
+static int32_t find_pgo_storage_end(const esp_partition_t *part) {
+    pgo_record_header_t header;
+    uint32_t offset = 0;
+
+    while (offset + sizeof(header) <= part->size) {
+        if (esp_partition_read(part, offset, &header, sizeof(header)) != ESP_OK) {
+            return -1;
+        }
+        if (header.magic == 0xFFFFFFFF) {
+            return (int32_t)offset;
+        }
+        if (header.magic != PGO_RECORD_MAGIC) {
+            return -1;
+        }
+        offset += sizeof(header) + ((header.size + 3) & ~3U);
+    }
+    return (int32_t)part->size;
+}
+#else
+static void print_pgo_hex(const void *data, uint32_t size, uint32_t *column) {
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for (uint32_t i = 0; i < size; i++) {
+        printf("%02x", bytes[i]);
+        if (++*column == PGO_HEX_BYTES_PER_LINE) {
+            printf("\n");
+            *column = 0;
+        }
+    }
+}
+#endif
+
+// exports the profile of a PGO instrumented AOT file, see pgo_merge.py of
+// WAMR's test-tools to merge the exports of many devices on the host
+static void export_pgo_profile(wasm_module_inst_t module_inst) {
+    pgo_record_header_t header = { .magic = PGO_RECORD_MAGIC };
+    bool full_profile = false;
+    char *buf;
+
+#ifdef CONFIG_WASM_RUNNER_PGO_FULL_PROFILE
+    full_profile = true;
+#endif
+
+#ifdef CONFIG_WASM_RUNNER_PGO_EXPORT_STORAGE
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PGO_STORAGE_PARTITION_NAME);
+    int32_t offset;
+
+    if (!part || (offset = find_pgo_storage_end(part)) < 0) {
+        ESP_LOGE(LOG_TAG, "no storage partition holding PGO records, erase it first");
+        return;
+    }
+    // the raw profile is only needed once
+    full_profile = full_profile && offset == 0;
+#endif
+
+    header.kind = full_profile ? PGO_RECORD_RAW_PROFILE : PGO_RECORD_COUNTERS;
+    header.size = full_profile ? wasm_runtime_get_pgo_prof_data_size(module_inst)
+                               : wasm_runtime_get_pgo_counters_size(module_inst);
+    if (header.size == 0) {
+        // not an instrumented AOT file
+        return;
+    }
+
+    if (!(buf = malloc(header.size))) {
+        ESP_LOGE(LOG_TAG, "failed to allocate %" PRIu32 " bytes for the PGO profile",
+                 header.size);
+        return;
+    }
+
+    header.size = full_profile
+        ? wasm_runtime_dump_pgo_prof_data_to_buf(module_inst, buf, header.size)
+        : wasm_runtime_dump_pgo_counters_to_buf(module_inst, buf, header.size);
+    if (header.size == 0) {
+        ESP_LOGE(LOG_TAG, "failed to dump the PGO profile");
+        free(buf);
+        return;
+    }
+
+#ifdef CONFIG_WASM_RUNNER_PGO_EXPORT_STORAGE
+    if ((uint32_t)offset + sizeof(header) + header.size > part->size) {
+        ESP_LOGW(LOG_TAG, "storage partition is full, collect the PGO records");
+    }
+    else if (esp_partition_write(part, offset, &header, sizeof(header)) != ESP_OK
+             || esp_partition_write(part, offset + sizeof(header), buf, header.size)
+                    != ESP_OK) {
+        ESP_LOGE(LOG_TAG, "failed to write the PGO record");
+    }
+    else {
+        ESP_LOGI(LOG_TAG, "PGO %s written to storage at 0x%" PRIx32 ", %" PRIu32 " bytes",
+                 full_profile ? "raw profile" : "counters", (uint32_t)offset, header.size);
+    }
+#else
+    uint32_t column = 0;
+
+    printf("WAMR-PGO-BEGIN\n");
+    print_pgo_hex(&header, sizeof(header), &column);
+    print_pgo_hex(buf, header.size, &column);
+    if (column > 0) {
+        printf("\n");
+    }
+    printf("WAMR-PGO-END\n");
+#endif
+
+    free(buf);
+}
+#endif
+
+// instantiates the module and runs main() on a stack sized for the module
+static void *app_thread_main(void *arg) {
+    wasm_app_t *app = (wasm_app_t *)arg;
+    void *ret;
+
+    ESP_LOGI(LOG_TAG, "instantiating WASM runtime...");
+    if (!(app->module_inst = wasm_runtime_instantiate(app->module, app->wasm_stack_size,
+                                                      WASM_APP_HEAP_SIZE, app->error_buf,
+                                                      sizeof(app->error_buf)))) {
+        ESP_LOGE(LOG_TAG, "Error while instantiating: %s", app->error_buf);
+        return NULL;
+    }
+
+#ifdef CONFIG_WAMR_ENABLE_SAMPLING_PROFILER
+    // sample the exec_env which wasm_application_execute_main() runs on
+    if (!wasm_runtime_sampling_profiler_attach(
+            wasm_runtime_get_exec_env_singleton(app->module_inst))
+        || !wasm_runtime_sampling_profiler_start(SAMPLING_INTERVAL_US)) {
+        ESP_LOGW(LOG_TAG, "failed to start sampling profiler");
+    }
+#endif
+
+    ESP_LOGI(LOG_TAG, "executing WASM main()");
+    ret = app_instance_main(app->module_inst);
+    assert(!ret);
+    return NULL;
+}
+
 void *iwasm_main(void *arg) {
     (void)arg;
 
@@ -93,9 +295,7 @@ void *iwasm_main(void *arg) {
     }
 
     wasm_module_t wasm_module = NULL;
-    wasm_module_inst_t wasm_module_inst = NULL;
     char error_buf[128] = {0};
-    void *ret;
     RuntimeInitArgs init_args;
 
     memset(&init_args, 0, sizeof(RuntimeInitArgs));
@@ -137,18 +337,52 @@ void *iwasm_main(void *arg) {
 
 
 
-    ESP_LOGI(LOG_TAG, "instantiating WASM runtime...");
-    if (!(wasm_module_inst = wasm_runtime_instantiate(wasm_module, 64 * 1024, 128 * 1024, error_buf, sizeof(error_buf)))) {
-        ESP_LOGE(LOG_TAG, "Error while instantiating: %s", error_buf);
+    wasm_app_t app = { .module = wasm_module, .wasm_stack_size = WASM_APP_WASM_STACK_SIZE };
+    size_t app_stack_size = WASM_APP_STACK_SIZE_MAX;
+    uint32_t native_stack_size = 0, wasm_stack_size = 0;
+
+    // size the stacks from the stack usage recorded by `wamrc --emit-stack-usage`
+    if (wasm_runtime_get_module_stack_usage(wasm_module, &native_stack_size, &wasm_stack_size)) {
+        ESP_LOGI(LOG_TAG, "stack usage: native %" PRIu32 " bytes, wasm %" PRIu32 " bytes",
+                 native_stack_size, wasm_stack_size);
+        if (wasm_stack_size > 0) {
+            app.wasm_stack_size = wasm_stack_size;
+        }
+        if (native_stack_size + WASM_APP_STACK_RESERVE > app_stack_size) {
+            app_stack_size = native_stack_size + WASM_APP_STACK_RESERVE;
+        }
+    }
+
+    ESP_LOGI(LOG_TAG, "running WASM app with %zu bytes stack", app_stack_size);
+    if (!run_in_thread(app_thread_main, &app, app_stack_size) || !app.module_inst) {
         goto cleanup;
     }
 
-    ESP_LOGI(LOG_TAG, "executing WASM main()");
-    ret = app_instance_main(wasm_module_inst);
-    assert(!ret);
+#ifdef CONFIG_WAMR_ENABLE_SAMPLING_PROFILER
+    wasm_runtime_sampling_profiler_stop();
+    ESP_LOGI(LOG_TAG, "sampled call stacks (folded)");
+    wasm_runtime_sampling_profiler_dump();
+#endif
+
+#ifdef CONFIG_WAMR_ENABLE_RUNTIME_METRICS
+    wasm_runtime_metrics_t metrics;
+    if (wasm_runtime_get_metrics(&metrics)) {
+        ESP_LOGI(LOG_TAG, "load: %" PRIu64 " us, instantiate: %" PRIu64 " us",
+                 metrics.module_load_time.total_us,
+                 metrics.instantiation_time.total_us);
+        ESP_LOGI(LOG_TAG, "memory grows: %" PRIu64 " (%" PRIu64 " bytes), "
+                 "native calls: %" PRIu64 ", heap highmark: %" PRIu64 " bytes",
+                 metrics.memory_grow_count, metrics.memory_grow_bytes,
+                 metrics.native_call_count, metrics.heap_highmark_size);
+    }
+#endif
+
+#ifdef CONFIG_WAMR_ENABLE_STATIC_PGO
+    export_pgo_profile(app.module_inst);
+#endif
 
     ESP_LOGI(LOG_TAG, "deinstantiating WASM runtime");
-    wasm_runtime_deinstantiate(wasm_module_inst);
+    wasm_runtime_deinstantiate(app.module_inst);
 
 cleanup:
     if (wasm_module) {
@@ -164,19 +398,10 @@ cleanup:
 }
 
 void run_wasm_app() {
-    pthread_t t;
-    int res;
-
-    pthread_attr_t tattr;
-    pthread_attr_init(&tattr);
-    pthread_attr_setdetachstate(&tattr, PTHREAD_CREATE_JOINABLE);
-    pthread_attr_setstacksize(&tattr, 4096);
-
-    res = pthread_create(&t, &tattr, iwasm_main, NULL);
-    assert(res == 0);
-
-    res = pthread_join(t, NULL);
-    assert(res == 0);
+    // the app itself runs on a second thread whose stack is sized from the module
+    bool res = run_in_thread(iwasm_main, NULL, WASM_LOADER_STACK_SIZE);
+    assert(res);
+    (void)res;
 
     ESP_LOGI(LOG_TAG, "WASM execution finished");
 }
\ No newline at end of file